@@ -29,6 +29,9 @@ GTEST_DEX_DIRECTORIES := \
   AllFields \
   ExceptionHandle \
   GetMethodSignature \
+  IncrementalCompilation \
+  IncrementalCompilationModified \
+  IncrementalCompilationNewString \
   Instrumentation \
   Interfaces \
   Main \
@@ -66,9 +69,11 @@ $(ART_TEST_TARGET_GTEST_MainStripped_DEX): $(ART_TEST_TARGET_GTEST_Main_DEX)
 
 # Dex file dependencies for each gtest.
 ART_GTEST_class_linker_test_DEX_DEPS := Interfaces MultiDex MyClass Nested Statics StaticsFromCode
+ART_GTEST_compilation_cache_test_DEX_DEPS := StaticLeafMethods
 ART_GTEST_compiler_driver_test_DEX_DEPS := AbstractMethod StaticLeafMethods
 ART_GTEST_dex_file_test_DEX_DEPS := GetMethodSignature Main Nested
 ART_GTEST_exception_test_DEX_DEPS := ExceptionHandle
+ART_GTEST_incremental_compilation_test_DEX_DEPS := IncrementalCompilation IncrementalCompilationModified IncrementalCompilationNewString
 ART_GTEST_instrumentation_test_DEX_DEPS := Instrumentation
 ART_GTEST_jni_compiler_test_DEX_DEPS := MyClassNatives
 ART_GTEST_jni_internal_test_DEX_DEPS := AllFields StaticLeafMethods
@@ -159,9 +164,11 @@ RUNTIME_GTEST_COMMON_SRC_FILES := \
   runtime/entrypoints/quick/quick_trampoline_entrypoints_test.cc \
   runtime/entrypoints_order_test.cc \
   runtime/exception_test.cc \
+  runtime/gc/accounting/atomic_stack_test.cc \
   runtime/gc/accounting/card_table_test.cc \
   runtime/gc/accounting/mod_union_table_test.cc \
   runtime/gc/accounting/space_bitmap_test.cc \
+  runtime/gc/gcprofiler_test.cc \
   runtime/gc/heap_test.cc \
   runtime/gc/reference_queue_test.cc \
   runtime/gc/space/dlmalloc_space_base_test.cc \
@@ -214,7 +221,9 @@ COMPILER_GTEST_COMMON_SRC_FILES := \
   compiler/dex/quick/quick_cfi_test.cc \
   compiler/dex/type_inference_test.cc \
   compiler/dwarf/dwarf_test.cc \
+  compiler/driver/compilation_cache_test.cc \
   compiler/driver/compiler_driver_test.cc \
+  compiler/driver/incremental_compilation_test.cc \
   compiler/elf_writer_test.cc \
   compiler/image_test.cc \
   compiler/jni/jni_cfi_test.cc \
@@ -247,6 +256,7 @@ COMPILER_GTEST_COMMON_SRC_FILES := \
   compiler/optimizing/suspend_check_test.cc \
   compiler/output_stream_test.cc \
   compiler/utils/arena_allocator_test.cc \
+  compiler/utils/code_stream_test.cc \
   compiler/utils/dedupe_set_test.cc \
   compiler/utils/swap_space_test.cc \
   compiler/utils/test_dex_file_builder_test.cc \
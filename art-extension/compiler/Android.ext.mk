@@ -19,23 +19,34 @@ ifeq ($(findstring graph_x86,$(LIBART_COMPILER_SRC_FILES)),)
   VENDOR_EXTENSIONS_FOLDER := optimizing/extensions
 
   COMPILER_EXTENSION_SRC_FILES := \
+    $(VENDOR_EXTENSIONS_FOLDER)/infrastructure/array_access_guards.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/infrastructure/cloning.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/infrastructure/ext_alias.cc \
+    $(VENDOR_EXTENSIONS_FOLDER)/infrastructure/ext_escape.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/infrastructure/ext_utility.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/infrastructure/graph_x86.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/infrastructure/perf_analysis.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/infrastructure/loop_information.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/infrastructure/loop_unrolling.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/infrastructure/pass_framework.cc \
+    $(VENDOR_EXTENSIONS_FOLDER)/passes/allocation_sinking.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/passes/constant_calculation_sinking.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/passes/constant_folding_x86.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/passes/find_ivs.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/passes/form_bottom_loops.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/passes/generate_selects.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/passes/gvn_after_fbl.cc \
+    $(VENDOR_EXTENSIONS_FOLDER)/passes/load_store_elimination.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/passes/loadhoist_storesink.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/passes/loop_formation.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/passes/loop_full_unrolling.cc \
+    $(VENDOR_EXTENSIONS_FOLDER)/passes/loop_fusion.cc \
+    $(VENDOR_EXTENSIONS_FOLDER)/passes/loop_interchange.cc \
+    $(VENDOR_EXTENSIONS_FOLDER)/passes/loop_partial_unrolling.cc \
+    $(VENDOR_EXTENSIONS_FOLDER)/passes/loop_strength_reduction.cc \
+    $(VENDOR_EXTENSIONS_FOLDER)/passes/loop_unswitching.cc \
+    $(VENDOR_EXTENSIONS_FOLDER)/passes/loop_vectorization.cc \
+    $(VENDOR_EXTENSIONS_FOLDER)/passes/loop_versioning.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/passes/non_temporal_move.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/passes/peeling.cc \
     $(VENDOR_EXTENSIONS_FOLDER)/passes/pure_invokes_analysis.cc \
@@ -81,9 +81,12 @@ LIBART_COMPILER_SRC_FILES := \
 	dex/verification_results.cc \
 	dex/vreg_analysis.cc \
 	dex/quick_compiler_callbacks.cc \
+	driver/compilation_cache.cc \
 	driver/compiler_driver.cc \
 	driver/compiler_options.cc \
 	driver/dex_compilation_unit.cc \
+	driver/dex_content_hash.cc \
+	driver/incremental_compilation.cc \
 	driver/system_load_metric.cc \
 	linker/relative_patcher.cc \
 	linker/arm/relative_patcher_arm_base.cc \
@@ -155,6 +158,7 @@ LIBART_COMPILER_SRC_FILES := \
 	utils/x86/managed_register_x86.cc \
 	utils/x86_64/assembler_x86_64.cc \
 	utils/x86_64/managed_register_x86_64.cc \
+	utils/code_stream.cc \
 	utils/swap_space.cc \
 	buffered_output_stream.cc \
 	compiler.cc \
@@ -16,13 +16,15 @@
 
 #include "compiled_method.h"
 #include "driver/compiler_driver.h"
+#include "utils/code_stream.h"
 
 namespace art {
 
 CompiledCode::CompiledCode(CompilerDriver* compiler_driver, InstructionSet instruction_set,
                            const ArrayRef<const uint8_t>& quick_code, bool owns_code_array)
     : compiler_driver_(compiler_driver), instruction_set_(instruction_set),
-      owns_code_array_(owns_code_array), quick_code_(nullptr) {
+      owns_code_array_(owns_code_array), quick_code_(nullptr),
+      streamed_code_offset_(0u), streamed_code_size_(0u) {
   SetCode(&quick_code);
 }
 
@@ -34,6 +36,11 @@ void CompiledCode::SetCode(const ArrayRef<const uint8_t>* quick_code) {
       CHECK(quick_code_ == nullptr);
       quick_code_ = new SwapVector<uint8_t>(quick_code->begin(), quick_code->end(),
                                             compiler_driver_->GetSwapSpaceAllocator());
+    } else if (compiler_driver_->GetCodeStream() != nullptr) {
+      // The code stream deduplicates the code as well.
+      CHECK(quick_code_ == nullptr);
+      streamed_code_offset_ = compiler_driver_->GetCodeStream()->Append(*quick_code);
+      streamed_code_size_ = quick_code->size();
     } else {
       quick_code_ = compiler_driver_->DeduplicateCode(*quick_code);
     }
@@ -46,7 +53,19 @@ CompiledCode::~CompiledCode() {
   }
 }
 
+size_t CompiledCode::GetQuickCodeSize() const {
+  if (IsCodeStreamed()) {
+    return streamed_code_size_;
+  }
+  return (quick_code_ != nullptr) ? quick_code_->size() : 0u;
+}
+
 bool CompiledCode::operator==(const CompiledCode& rhs) const {
+  if (IsCodeStreamed() || rhs.IsCodeStreamed()) {
+    // Identical code is at the same offset of the stream.
+    return streamed_code_offset_ == rhs.streamed_code_offset_ &&
+        streamed_code_size_ == rhs.streamed_code_size_;
+  }
   if (quick_code_ != nullptr) {
     if (rhs.quick_code_ == nullptr) {
       return false;
@@ -43,10 +43,22 @@ class CompiledCode {
     return instruction_set_;
   }
 
+  // Returns null if the code was appended to the code stream of the compiler driver.
   const SwapVector<uint8_t>* GetQuickCode() const {
     return quick_code_;
   }
 
+  bool IsCodeStreamed() const {
+    return streamed_code_size_ != 0u;
+  }
+
+  // The offset of the code in the code stream of the compiler driver.
+  uint32_t GetStreamedCodeOffset() const {
+    return streamed_code_offset_;
+  }
+
+  size_t GetQuickCodeSize() const;
+
   void SetCode(const ArrayRef<const uint8_t>* quick_code);
 
   bool operator==(const CompiledCode& rhs) const;
@@ -82,6 +94,10 @@ class CompiledCode {
   // Used to store the PIC code for Quick.
   SwapVector<uint8_t>* quick_code_;
 
+  // Where the code is in the code stream, if it was not kept in memory.
+  uint32_t streamed_code_offset_;
+  uint32_t streamed_code_size_;
+
   // There are offsets from the oatdata symbol to where the offset to
   // the compiled method will be found. These are computed by the
   // OatWriter and then used by the ElfWriter to add relocations so
@@ -41,6 +41,13 @@ static constexpr bool kIntrinsicIsStatic[] = {
     true,   // kIntrinsicFloatCvt
     true,   // kIntrinsicReverseBits
     true,   // kIntrinsicReverseBytes
+    true,   // kIntrinsicBitCount
+    true,   // kIntrinsicNumberOfLeadingZeros
+    true,   // kIntrinsicNumberOfTrailingZeros
+    true,   // kIntrinsicRotateRight
+    true,   // kIntrinsicRotateLeft
+    true,   // kIntrinsicHighestOneBit
+    true,   // kIntrinsicSignum
     true,   // kIntrinsicAbsInt
     true,   // kIntrinsicAbsLong
     true,   // kIntrinsicAbsFloat
@@ -78,6 +85,8 @@ static constexpr bool kIntrinsicIsStatic[] = {
     false,  // kIntrinsicGetCharsNoCheck
     false,  // kIntrinsicIsEmptyOrLength
     false,  // kIntrinsicIndexOf
+    false,  // kIntrinsicEquals
+    false,  // kIntrinsicHashCode
     true,   // kIntrinsicNewStringFromBytes
     true,   // kIntrinsicNewStringFromChars
     true,   // kIntrinsicNewStringFromString
@@ -88,6 +97,9 @@ static constexpr bool kIntrinsicIsStatic[] = {
     false,  // kIntrinsicUnsafeGet
     false,  // kIntrinsicUnsafePut
     true,   // kIntrinsicSystemArrayCopyCharArray
+    true,   // kIntrinsicSystemArrayCopy
+    true,   // kIntrinsicArraysEquals
+    true,   // kIntrinsicArraysFill
 };
 static_assert(arraysize(kIntrinsicIsStatic) == kInlineOpNop,
               "arraysize of kIntrinsicIsStatic unexpected");
@@ -95,6 +107,15 @@ static_assert(kIntrinsicIsStatic[kIntrinsicDoubleCvt], "DoubleCvt must be static
 static_assert(kIntrinsicIsStatic[kIntrinsicFloatCvt], "FloatCvt must be static");
 static_assert(kIntrinsicIsStatic[kIntrinsicReverseBits], "ReverseBits must be static");
 static_assert(kIntrinsicIsStatic[kIntrinsicReverseBytes], "ReverseBytes must be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicBitCount], "BitCount must be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicNumberOfLeadingZeros],
+              "NumberOfLeadingZeros must be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicNumberOfTrailingZeros],
+              "NumberOfTrailingZeros must be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicRotateRight], "RotateRight must be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicRotateLeft], "RotateLeft must be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicHighestOneBit], "HighestOneBit must be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicSignum], "Signum must be static");
 static_assert(kIntrinsicIsStatic[kIntrinsicAbsInt], "AbsInt must be static");
 static_assert(kIntrinsicIsStatic[kIntrinsicAbsLong], "AbsLong must be static");
 static_assert(kIntrinsicIsStatic[kIntrinsicAbsFloat], "AbsFloat must be static");
@@ -132,6 +153,8 @@ static_assert(!kIntrinsicIsStatic[kIntrinsicCompareTo], "CompareTo must not be s
 static_assert(!kIntrinsicIsStatic[kIntrinsicGetCharsNoCheck], "GetCharsNoCheck must not be static");
 static_assert(!kIntrinsicIsStatic[kIntrinsicIsEmptyOrLength], "IsEmptyOrLength must not be static");
 static_assert(!kIntrinsicIsStatic[kIntrinsicIndexOf], "IndexOf must not be static");
+static_assert(!kIntrinsicIsStatic[kIntrinsicEquals], "Equals must not be static");
+static_assert(!kIntrinsicIsStatic[kIntrinsicHashCode], "HashCode must not be static");
 static_assert(kIntrinsicIsStatic[kIntrinsicNewStringFromBytes],
               "NewStringFromBytes must be static");
 static_assert(kIntrinsicIsStatic[kIntrinsicNewStringFromChars],
@@ -146,6 +169,9 @@ static_assert(!kIntrinsicIsStatic[kIntrinsicUnsafeGet], "UnsafeGet_must_not_be_s
 static_assert(!kIntrinsicIsStatic[kIntrinsicUnsafePut], "UnsafePut must not be static");
 static_assert(kIntrinsicIsStatic[kIntrinsicSystemArrayCopyCharArray],
               "SystemArrayCopyCharArray must be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicSystemArrayCopy], "SystemArrayCopy must be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicArraysEquals], "ArraysEquals must be static");
+static_assert(kIntrinsicIsStatic[kIntrinsicArraysFill], "ArraysFill must be static");
 
 MIR* AllocReplacementMIR(MIRGraph* mir_graph, MIR* invoke) {
   MIR* insn = mir_graph->NewMIR();
@@ -206,11 +232,19 @@ const char* const DexFileMethodInliner::kClassCacheNames[] = {
     "Llibcore/io/Memory;",     // kClassCacheLibcoreIoMemory
     "Lsun/misc/Unsafe;",       // kClassCacheSunMiscUnsafe
     "Ljava/lang/System;",      // kClassCacheJavaLangSystem
+    "Ljava/util/Arrays;",      // kClassCacheJavaUtilArrays
 };
 
 const char* const DexFileMethodInliner::kNameCacheNames[] = {
     "reverse",               // kNameCacheReverse
     "reverseBytes",          // kNameCacheReverseBytes
+    "bitCount",              // kNameCacheBitCount
+    "numberOfLeadingZeros",  // kNameCacheNumberOfLeadingZeros
+    "numberOfTrailingZeros", // kNameCacheNumberOfTrailingZeros
+    "rotateRight",           // kNameCacheRotateRight
+    "rotateLeft",            // kNameCacheRotateLeft
+    "highestOneBit",         // kNameCacheHighestOneBit
+    "signum",                // kNameCacheSignum
     "doubleToRawLongBits",   // kNameCacheDoubleToRawLongBits
     "longBitsToDouble",      // kNameCacheLongBitsToDouble
     "floatToRawIntBits",     // kNameCacheFloatToRawIntBits
@@ -247,6 +281,8 @@ const char* const DexFileMethodInliner::kNameCacheNames[] = {
     "isEmpty",               // kNameCacheIsEmpty
     "indexOf",               // kNameCacheIndexOf
     "length",                // kNameCacheLength
+    "equals",                // kNameCacheEquals
+    "hashCode",              // kNameCacheHashCode
     "<init>",                // kNameCacheInit
     "newStringFromBytes",    // kNameCacheNewStringFromBytes
     "newStringFromChars",    // kNameCacheNewStringFromChars
@@ -279,6 +315,7 @@ const char* const DexFileMethodInliner::kNameCacheNames[] = {
     "putObjectVolatile",     // kNameCachePutObjectVolatile
     "putOrderedObject",      // kNameCachePutOrderedObject
     "arraycopy",             // kNameCacheArrayCopy
+    "fill",                  // kNameCacheFill
 };
 
 const DexFileMethodInliner::ProtoDef DexFileMethodInliner::kProtoCacheDefs[] = {
@@ -316,6 +353,8 @@ const DexFileMethodInliner::ProtoDef DexFileMethodInliner::kProtoCacheDefs[] = {
     { kClassCacheInt, 0, { } },
     // kProtoCache_Object
     { kClassCacheJavaLangObject, 0, { } },
+    // kProtoCacheObject_Z
+    { kClassCacheBoolean, 1, { kClassCacheJavaLangObject } },
     // kProtoCache_Thread
     { kClassCacheJavaLangThread, 0, { } },
     // kProtoCacheJ_B
@@ -328,6 +367,8 @@ const DexFileMethodInliner::ProtoDef DexFileMethodInliner::kProtoCacheDefs[] = {
     { kClassCacheVoid, 2, { kClassCacheLong, kClassCacheByte } },
     // kProtoCacheJI_V
     { kClassCacheVoid, 2, { kClassCacheLong, kClassCacheInt } },
+    // kProtoCacheJI_J
+    { kClassCacheLong, 2, { kClassCacheLong, kClassCacheInt } },
     // kProtoCacheJJ_J
     { kClassCacheLong, 2, { kClassCacheLong, kClassCacheLong } },
     // kProtoCacheJJ_V
@@ -359,6 +400,20 @@ const DexFileMethodInliner::ProtoDef DexFileMethodInliner::kProtoCacheDefs[] = {
     // kProtoCacheCharArrayICharArrayII_V
     { kClassCacheVoid, 5, {kClassCacheJavaLangCharArray, kClassCacheInt,
         kClassCacheJavaLangCharArray, kClassCacheInt, kClassCacheInt} },
+    // kProtoCacheByteArrayIByteArrayII_V
+    { kClassCacheVoid, 5, { kClassCacheJavaLangByteArray, kClassCacheInt,
+        kClassCacheJavaLangByteArray, kClassCacheInt, kClassCacheInt } },
+    // kProtoCacheIntArrayIIntArrayII_V
+    { kClassCacheVoid, 5, { kClassCacheJavaLangIntArray, kClassCacheInt,
+        kClassCacheJavaLangIntArray, kClassCacheInt, kClassCacheInt } },
+    // kProtoCacheByteArrayByteArray_Z
+    { kClassCacheBoolean, 2, { kClassCacheJavaLangByteArray, kClassCacheJavaLangByteArray } },
+    // kProtoCacheCharArrayCharArray_Z
+    { kClassCacheBoolean, 2, { kClassCacheJavaLangCharArray, kClassCacheJavaLangCharArray } },
+    // kProtoCacheIntArrayIntArray_Z
+    { kClassCacheBoolean, 2, { kClassCacheJavaLangIntArray, kClassCacheJavaLangIntArray } },
+    // kProtoCacheIntArrayI_V
+    { kClassCacheVoid, 2, { kClassCacheJavaLangIntArray, kClassCacheInt } },
     // kProtoCacheIICharArrayI_V
     { kClassCacheVoid, 4, { kClassCacheInt, kClassCacheInt, kClassCacheJavaLangCharArray,
         kClassCacheInt } },
@@ -421,6 +476,20 @@ const DexFileMethodInliner::IntrinsicDef DexFileMethodInliner::kIntrinsicMethods
     INTRINSIC(JavaLangShort, ReverseBytes, S_S, kIntrinsicReverseBytes, kSignedHalf),
     INTRINSIC(JavaLangInteger, Reverse, I_I, kIntrinsicReverseBits, k32),
     INTRINSIC(JavaLangLong, Reverse, J_J, kIntrinsicReverseBits, k64),
+    INTRINSIC(JavaLangInteger, BitCount, I_I, kIntrinsicBitCount, k32),
+    INTRINSIC(JavaLangLong, BitCount, J_I, kIntrinsicBitCount, k64),
+    INTRINSIC(JavaLangInteger, NumberOfLeadingZeros, I_I, kIntrinsicNumberOfLeadingZeros, k32),
+    INTRINSIC(JavaLangLong, NumberOfLeadingZeros, J_I, kIntrinsicNumberOfLeadingZeros, k64),
+    INTRINSIC(JavaLangInteger, NumberOfTrailingZeros, I_I, kIntrinsicNumberOfTrailingZeros, k32),
+    INTRINSIC(JavaLangLong, NumberOfTrailingZeros, J_I, kIntrinsicNumberOfTrailingZeros, k64),
+    INTRINSIC(JavaLangInteger, RotateRight, II_I, kIntrinsicRotateRight, k32),
+    INTRINSIC(JavaLangLong, RotateRight, JI_J, kIntrinsicRotateRight, k64),
+    INTRINSIC(JavaLangInteger, RotateLeft, II_I, kIntrinsicRotateLeft, k32),
+    INTRINSIC(JavaLangLong, RotateLeft, JI_J, kIntrinsicRotateLeft, k64),
+    INTRINSIC(JavaLangInteger, HighestOneBit, I_I, kIntrinsicHighestOneBit, k32),
+    INTRINSIC(JavaLangLong, HighestOneBit, J_J, kIntrinsicHighestOneBit, k64),
+    INTRINSIC(JavaLangInteger, Signum, I_I, kIntrinsicSignum, k32),
+    INTRINSIC(JavaLangLong, Signum, J_I, kIntrinsicSignum, k64),
 
     INTRINSIC(JavaLangMath,       Abs, I_I, kIntrinsicAbsInt, 0),
     INTRINSIC(JavaLangStrictMath, Abs, I_I, kIntrinsicAbsInt, 0),
@@ -487,6 +556,8 @@ const DexFileMethodInliner::IntrinsicDef DexFileMethodInliner::kIntrinsicMethods
     INTRINSIC(JavaLangString, IndexOf, II_I, kIntrinsicIndexOf, kIntrinsicFlagNone),
     INTRINSIC(JavaLangString, IndexOf, I_I, kIntrinsicIndexOf, kIntrinsicFlagBase0),
     INTRINSIC(JavaLangString, Length, _I, kIntrinsicIsEmptyOrLength, kIntrinsicFlagLength),
+    INTRINSIC(JavaLangString, Equals, Object_Z, kIntrinsicEquals, 0),
+    INTRINSIC(JavaLangString, HashCode, _I, kIntrinsicHashCode, 0),
 
     INTRINSIC(JavaLangThread, CurrentThread, _Thread, kIntrinsicCurrentThread, 0),
 
@@ -525,6 +596,14 @@ const DexFileMethodInliner::IntrinsicDef DexFileMethodInliner::kIntrinsicMethods
 
     INTRINSIC(JavaLangSystem, ArrayCopy, CharArrayICharArrayII_V , kIntrinsicSystemArrayCopyCharArray,
               0),
+    INTRINSIC(JavaLangSystem, ArrayCopy, ByteArrayIByteArrayII_V, kIntrinsicSystemArrayCopy,
+              kSignedByte),
+    INTRINSIC(JavaLangSystem, ArrayCopy, IntArrayIIntArrayII_V, kIntrinsicSystemArrayCopy, k32),
+
+    INTRINSIC(JavaUtilArrays, Equals, ByteArrayByteArray_Z, kIntrinsicArraysEquals, kSignedByte),
+    INTRINSIC(JavaUtilArrays, Equals, CharArrayCharArray_Z, kIntrinsicArraysEquals, kUnsignedHalf),
+    INTRINSIC(JavaUtilArrays, Equals, IntArrayIntArray_Z, kIntrinsicArraysEquals, k32),
+    INTRINSIC(JavaUtilArrays, Fill, IntArrayI_V, kIntrinsicArraysFill, k32),
 
 #undef INTRINSIC
 
@@ -618,6 +697,15 @@ bool DexFileMethodInliner::GenIntrinsic(Mir2Lir* backend, CallInfo* info) {
       return backend->GenInlinedReverseBytes(info, static_cast<OpSize>(intrinsic.d.data));
     case kIntrinsicReverseBits:
       return backend->GenInlinedReverseBits(info, static_cast<OpSize>(intrinsic.d.data));
+    case kIntrinsicBitCount:
+    case kIntrinsicNumberOfLeadingZeros:
+    case kIntrinsicNumberOfTrailingZeros:
+    case kIntrinsicRotateRight:
+    case kIntrinsicRotateLeft:
+    case kIntrinsicHighestOneBit:
+    case kIntrinsicSignum:
+      // Not implemented in Quick.
+      return false;
     case kIntrinsicAbsInt:
       return backend->GenInlinedAbsInt(info);
     case kIntrinsicAbsLong:
@@ -704,6 +792,13 @@ bool DexFileMethodInliner::GenIntrinsic(Mir2Lir* backend, CallInfo* info) {
                                           intrinsic.d.data & kIntrinsicFlagIsOrdered);
     case kIntrinsicSystemArrayCopyCharArray:
       return backend->GenInlinedArrayCopyCharArray(info);
+    case kIntrinsicEquals:
+    case kIntrinsicHashCode:
+    case kIntrinsicSystemArrayCopy:
+    case kIntrinsicArraysEquals:
+    case kIntrinsicArraysFill:
+      // Not implemented in Quick.
+      return false;
     default:
       LOG(FATAL) << "Unexpected intrinsic opcode: " << intrinsic.opcode;
       return false;  // avoid warning "control reaches end of non-void function"
@@ -146,6 +146,7 @@ class DexFileMethodInliner {
       kClassCacheLibcoreIoMemory,
       kClassCacheSunMiscUnsafe,
       kClassCacheJavaLangSystem,
+      kClassCacheJavaUtilArrays,
       kClassCacheLast
     };
 
@@ -158,6 +159,13 @@ class DexFileMethodInliner {
       kNameCacheFirst = 0,
       kNameCacheReverse =  kNameCacheFirst,
       kNameCacheReverseBytes,
+      kNameCacheBitCount,
+      kNameCacheNumberOfLeadingZeros,
+      kNameCacheNumberOfTrailingZeros,
+      kNameCacheRotateRight,
+      kNameCacheRotateLeft,
+      kNameCacheHighestOneBit,
+      kNameCacheSignum,
       kNameCacheDoubleToRawLongBits,
       kNameCacheLongBitsToDouble,
       kNameCacheFloatToRawIntBits,
@@ -194,6 +202,8 @@ class DexFileMethodInliner {
       kNameCacheIsEmpty,
       kNameCacheIndexOf,
       kNameCacheLength,
+      kNameCacheEquals,
+      kNameCacheHashCode,
       kNameCacheInit,
       kNameCacheNewStringFromBytes,
       kNameCacheNewStringFromChars,
@@ -226,6 +236,7 @@ class DexFileMethodInliner {
       kNameCachePutObjectVolatile,
       kNameCachePutOrderedObject,
       kNameCacheArrayCopy,
+      kNameCacheFill,
       kNameCacheLast
     };
 
@@ -253,12 +264,14 @@ class DexFileMethodInliner {
       kProtoCache_Z,
       kProtoCache_I,
       kProtoCache_Object,
+      kProtoCacheObject_Z,
       kProtoCache_Thread,
       kProtoCacheJ_B,
       kProtoCacheJ_I,
       kProtoCacheJ_S,
       kProtoCacheJB_V,
       kProtoCacheJI_V,
+      kProtoCacheJI_J,
       kProtoCacheJJ_J,
       kProtoCacheJJ_V,
       kProtoCacheJS_V,
@@ -272,6 +285,12 @@ class DexFileMethodInliner {
       kProtoCacheObjectJ_Object,
       kProtoCacheObjectJObject_V,
       kProtoCacheCharArrayICharArrayII_V,
+      kProtoCacheByteArrayIByteArrayII_V,
+      kProtoCacheIntArrayIIntArrayII_V,
+      kProtoCacheByteArrayByteArray_Z,
+      kProtoCacheCharArrayCharArray_Z,
+      kProtoCacheIntArrayIntArray_Z,
+      kProtoCacheIntArrayI_V,
       kProtoCacheIICharArrayI_V,
       kProtoCacheByteArrayIII_String,
       kProtoCacheIICharArray_String,
@@ -0,0 +1,406 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "compilation_cache.h"
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <sstream>
+
+#include "base/logging.h"
+#include "base/scoped_flock.h"
+#include "base/stringprintf.h"
+#include "base/unix_file/fd_file.h"
+#include "compiled_method.h"
+#include "dex_file-inl.h"
+#include "driver/compiler_driver.h"
+#include "driver/dex_content_hash.h"
+#include "mem_map.h"
+#include "oat.h"
+#include "thread.h"
+#include "utils.h"
+#include "utils/array_ref.h"
+#include "utils/code_stream.h"
+
+namespace art {
+
+// Bounds the walk up the super classes, in case of a circular hierarchy.
+static constexpr size_t kMaxHierarchyDepth = 256u;
+
+struct CompilationCache::FileHeader {
+  static constexpr uint8_t kMagic[] = { 'a', 'c', 'c', '\n' };
+  static constexpr uint8_t kVersion[] = { '0', '0', '1', '\0' };
+
+  uint8_t magic[4];
+  uint8_t version[4];
+
+  bool IsValid() const {
+    return memcmp(magic, kMagic, sizeof(kMagic)) == 0 &&
+           memcmp(version, kVersion, sizeof(kVersion)) == 0;
+  }
+};
+
+constexpr uint8_t CompilationCache::FileHeader::kMagic[];
+constexpr uint8_t CompilationCache::FileHeader::kVersion[];
+
+// A record is this header followed by the code, mapping table, vmap table, GC map and CFI of a
+// method. Records are 8-byte aligned.
+struct CompilationCache::RecordHeader {
+  static constexpr size_t kAlignment = 8u;
+
+  uint32_t size;
+  uint32_t instruction_set;
+  uint64_t hash;
+  uint64_t second_hash;
+  uint32_t frame_size_in_bytes;
+  uint32_t core_spill_mask;
+  uint32_t fp_spill_mask;
+  uint32_t code_size;
+  uint32_t mapping_table_size;
+  uint32_t vmap_table_size;
+  uint32_t gc_map_size;
+  uint32_t cfi_info_size;
+
+  const uint8_t* GetData() const {
+    return reinterpret_cast<const uint8_t*>(this + 1);
+  }
+
+  size_t GetDataSize() const {
+    return static_cast<size_t>(code_size) + mapping_table_size + vmap_table_size + gc_map_size +
+        cfi_info_size;
+  }
+};
+
+static void AppendVector(const SwapVector<uint8_t>* data, std::vector<uint8_t>* out) {
+  if (data != nullptr) {
+    out->insert(out->end(), data->begin(), data->end());
+  }
+}
+
+static uint32_t SizeOf(const SwapVector<uint8_t>* data) {
+  return (data == nullptr) ? 0u : dchecked_integral_cast<uint32_t>(data->size());
+}
+
+CompilationCache::CompilationCache(const std::string& filename,
+                                   InstructionSet instruction_set,
+                                   const std::vector<const DexFile*>& dex_files,
+                                   size_t inline_depth_limit,
+                                   uint64_t context_hash)
+    : filename_(filename),
+      instruction_set_(instruction_set),
+      dex_files_(dex_files),
+      inline_depth_limit_(inline_depth_limit),
+      context_hash_(context_hash),
+      lock_("compilation cache lock"),
+      number_of_new_records_(0u),
+      hits_(0u),
+      misses_(0u) {
+  for (const DexFile* dex_file : dex_files_) {
+    DexContentHasher hasher;
+    HashConstantPools(*dex_file, &hasher);
+    constant_pools_hashes_.Put(dex_file, hasher.GetHash());
+  }
+}
+
+CompilationCache::~CompilationCache() {}
+
+CompilationCache* CompilationCache::Open(const std::string& filename,
+                                         const std::string& context,
+                                         InstructionSet instruction_set,
+                                         const std::vector<const DexFile*>& dex_files,
+                                         size_t inline_depth_limit,
+                                         std::string* error_msg) {
+  // The code layout and the stack maps change with the oat version.
+  DexContentHasher context_hasher;
+  context_hasher.Update(OatHeader::kOatVersion, sizeof(OatHeader::kOatVersion));
+  context_hasher.UpdateString(context.c_str());
+  std::unique_ptr<CompilationCache> cache(new CompilationCache(
+      filename, instruction_set, dex_files, inline_depth_limit, context_hasher.GetHash()));
+
+  ScopedFlock flock;
+  if (!flock.Init(filename.c_str(), error_msg)) {
+    return nullptr;
+  }
+  File* file = flock.GetFile();
+  int64_t length = file->GetLength();
+  FileHeader header;
+  if (length < static_cast<int64_t>(sizeof(FileHeader)) ||
+      !file->PreadFully(&header, sizeof(header), 0) ||
+      !header.IsValid()) {
+    // A new file, or one written by another version of the cache: start over.
+    memcpy(header.magic, FileHeader::kMagic, sizeof(FileHeader::kMagic));
+    memcpy(header.version, FileHeader::kVersion, sizeof(FileHeader::kVersion));
+    if (file->SetLength(0) != 0 || !file->WriteFully(&header, sizeof(header))) {
+      *error_msg = StringPrintf("Failed to initialize compilation cache '%s'", filename.c_str());
+      return nullptr;
+    }
+    length = sizeof(header);
+  }
+  if (length > static_cast<int64_t>(sizeof(FileHeader))) {
+    cache->map_.reset(MemMap::MapFile(static_cast<size_t>(length), PROT_READ, MAP_PRIVATE,
+                                      file->Fd(), 0, filename.c_str(), error_msg));
+    if (cache->map_ == nullptr) {
+      return nullptr;
+    }
+    cache->IndexRecords();
+  }
+  return cache.release();
+}
+
+void CompilationCache::IndexRecords() {
+  const uint8_t* begin = map_->Begin();
+  size_t size = map_->Size();
+  size_t offset = RoundUp(sizeof(FileHeader), RecordHeader::kAlignment);
+  while (offset + sizeof(RecordHeader) <= size) {
+    const RecordHeader* record = reinterpret_cast<const RecordHeader*>(begin + offset);
+    // Stop at a truncated record, left by a dex2oat which did not finish writing.
+    if (record->size < sizeof(RecordHeader) + record->GetDataSize() ||
+        record->size > size - offset ||
+        !IsAligned<RecordHeader::kAlignment>(record->size)) {
+      LOG(WARNING) << "Ignoring the end of compilation cache " << filename_ << " from offset "
+                   << offset;
+      break;
+    }
+    if (record->instruction_set == static_cast<uint32_t>(instruction_set_)) {
+      records_.emplace(record->hash, record);
+    }
+    offset += record->size;
+  }
+}
+
+void CompilationCache::HashClassHierarchy(const DexFile& dex_file,
+                                          const DexFile::ClassDef& class_def,
+                                          DexContentHasher* hasher) const {
+  const DexFile* current_dex_file = &dex_file;
+  const DexFile::ClassDef* current = &class_def;
+  for (size_t i = 0; current != nullptr && i != kMaxHierarchyDepth; ++i) {
+    hasher->Update(constant_pools_hashes_.Get(current_dex_file));
+    HashClassContent(*current_dex_file, *current, hasher);
+    const DexFile::TypeList* interfaces = current_dex_file->GetInterfacesList(*current);
+    if (interfaces != nullptr) {
+      for (uint32_t j = 0; j < interfaces->Size(); ++j) {
+        const DexFile* interface_dex_file;
+        const DexFile::ClassDef* interface = FindClassDefOfType(
+            dex_files_, *current_dex_file, interfaces->GetTypeItem(j).type_idx_,
+            &interface_dex_file);
+        if (interface != nullptr) {
+          HashClassContent(*interface_dex_file, *interface, hasher);
+        }
+      }
+    }
+    if (current->superclass_idx_ == DexFile::kDexNoIndex16) {
+      break;
+    }
+    current = FindClassDefOfType(dex_files_, *current_dex_file, current->superclass_idx_,
+                                 &current_dex_file);
+  }
+}
+
+uint64_t CompilationCache::GetDependencyHash(const DexFile& dex_file,
+                                             const DexFile::ClassDef& class_def,
+                                             size_t depth) {
+  Thread* self = Thread::Current();
+  auto key = std::make_pair(&class_def, depth);
+  {
+    MutexLock mu(self, lock_);
+    auto it = dependency_hashes_.find(key);
+    if (it != dependency_hashes_.end()) {
+      return it->second;
+    }
+  }
+  DexContentHasher hasher;
+  HashClassHierarchy(dex_file, class_def, &hasher);
+  if (depth != 0u) {
+    std::vector<uint16_t> type_indexes;
+    CollectReferencedTypes(dex_file, class_def, &type_indexes);
+    for (uint16_t type_idx : type_indexes) {
+      const DexFile* referenced_dex_file;
+      const DexFile::ClassDef* referenced_class_def =
+          FindClassDefOfType(dex_files_, dex_file, type_idx, &referenced_dex_file);
+      if (referenced_class_def != nullptr && referenced_class_def != &class_def) {
+        hasher.Update(GetDependencyHash(*referenced_dex_file, *referenced_class_def, depth - 1u));
+      }
+    }
+  }
+  // Threads racing to compute the same hash get the same result.
+  MutexLock mu(self, lock_);
+  dependency_hashes_[key] = hasher.GetHash();
+  return hasher.GetHash();
+}
+
+CompilationCache::Key CompilationCache::ComputeKey(const DexFile& dex_file,
+                                                   uint16_t class_def_idx,
+                                                   uint32_t method_idx,
+                                                   uint32_t access_flags,
+                                                   InvokeType invoke_type,
+                                                   const DexFile::CodeItem& code_item) {
+  DexContentHasher hasher;
+  hasher.Update(context_hash_);
+  hasher.Update(constant_pools_hashes_.Get(&dex_file));
+  hasher.Update(method_idx);
+  hasher.Update(access_flags);
+  hasher.Update(static_cast<uint32_t>(invoke_type));
+  HashCodeItem(code_item, &hasher);
+  const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_idx);
+  HashClassHierarchy(dex_file, class_def, &hasher);
+  // The classes the code references may be inlined, together with the classes they reference.
+  std::vector<uint16_t> type_indexes;
+  CollectCodeItemReferencedTypes(dex_file, code_item, &type_indexes);
+  for (uint16_t type_idx : type_indexes) {
+    const DexFile* referenced_dex_file;
+    const DexFile::ClassDef* referenced_class_def =
+        FindClassDefOfType(dex_files_, dex_file, type_idx, &referenced_dex_file);
+    if (referenced_class_def != nullptr) {
+      hasher.Update(GetDependencyHash(*referenced_dex_file, *referenced_class_def,
+                                      inline_depth_limit_));
+    }
+  }
+  return Key { hasher.GetHash(), hasher.GetSecondHash() };
+}
+
+CompiledMethod* CompilationCache::Lookup(CompilerDriver* driver, const Key& key) {
+  auto it = records_.find(key.hash);
+  if (it == records_.end() || it->second->second_hash != key.second_hash) {
+    misses_.FetchAndAddSequentiallyConsistent(1u);
+    return nullptr;
+  }
+  hits_.FetchAndAddSequentiallyConsistent(1u);
+  const RecordHeader* record = it->second;
+  const uint8_t* data = record->GetData();
+  ArrayRef<const uint8_t> code(data, record->code_size);
+  data += record->code_size;
+  ArrayRef<const uint8_t> mapping_table(data, record->mapping_table_size);
+  data += record->mapping_table_size;
+  ArrayRef<const uint8_t> vmap_table(data, record->vmap_table_size);
+  data += record->vmap_table_size;
+  ArrayRef<const uint8_t> gc_map(data, record->gc_map_size);
+  data += record->gc_map_size;
+  ArrayRef<const uint8_t> cfi_info(data, record->cfi_info_size);
+  DefaultSrcMap src_mapping_table;
+  return CompiledMethod::SwapAllocCompiledMethod(driver,
+                                                 instruction_set_,
+                                                 code,
+                                                 record->frame_size_in_bytes,
+                                                 record->core_spill_mask,
+                                                 record->fp_spill_mask,
+                                                 &src_mapping_table,
+                                                 mapping_table,
+                                                 vmap_table,
+                                                 gc_map,
+                                                 cfi_info,
+                                                 ArrayRef<const LinkerPatch>());
+}
+
+void CompilationCache::Insert(const CompilerDriver* driver,
+                              const Key& key,
+                              const CompiledMethod& compiled_method) {
+  // Patches refer to the dex file and oat file being compiled.
+  if (!compiled_method.GetPatches().empty() || !compiled_method.GetSrcMappingTable().empty()) {
+    return;
+  }
+  std::vector<uint8_t> code;
+  if (compiled_method.IsCodeStreamed()) {
+    if (!driver->GetCodeStream()->Read(compiled_method.GetStreamedCodeOffset(),
+                                       compiled_method.GetQuickCodeSize(),
+                                       &code)) {
+      PLOG(WARNING) << "Failed to read the code of a method to cache";
+      return;
+    }
+  } else {
+    const SwapVector<uint8_t>* quick_code = compiled_method.GetQuickCode();
+    DCHECK(quick_code != nullptr);
+    code.assign(quick_code->begin(), quick_code->end());
+  }
+  RecordHeader record;
+  record.instruction_set = static_cast<uint32_t>(compiled_method.GetInstructionSet());
+  record.hash = key.hash;
+  record.second_hash = key.second_hash;
+  record.frame_size_in_bytes = compiled_method.GetFrameSizeInBytes();
+  record.core_spill_mask = compiled_method.GetCoreSpillMask();
+  record.fp_spill_mask = compiled_method.GetFpSpillMask();
+  record.code_size = dchecked_integral_cast<uint32_t>(code.size());
+  record.mapping_table_size = SizeOf(compiled_method.GetMappingTable());
+  record.vmap_table_size = SizeOf(compiled_method.GetVmapTable());
+  record.gc_map_size = SizeOf(compiled_method.GetGcMap());
+  record.cfi_info_size = SizeOf(compiled_method.GetCFIInfo());
+  record.size = dchecked_integral_cast<uint32_t>(
+      RoundUp(sizeof(RecordHeader) + record.GetDataSize(), RecordHeader::kAlignment));
+
+  MutexLock mu(Thread::Current(), lock_);
+  size_t offset = new_records_.size();
+  const uint8_t* record_bytes = reinterpret_cast<const uint8_t*>(&record);
+  new_records_.insert(new_records_.end(), record_bytes, record_bytes + sizeof(record));
+  new_records_.insert(new_records_.end(), code.begin(), code.end());
+  AppendVector(compiled_method.GetMappingTable(), &new_records_);
+  AppendVector(compiled_method.GetVmapTable(), &new_records_);
+  AppendVector(compiled_method.GetGcMap(), &new_records_);
+  AppendVector(compiled_method.GetCFIInfo(), &new_records_);
+  new_records_.resize(offset + record.size, 0u);
+  ++number_of_new_records_;
+}
+
+bool CompilationCache::Write(std::string* error_msg) {
+  MutexLock mu(Thread::Current(), lock_);
+  if (new_records_.empty()) {
+    return true;
+  }
+  ScopedFlock flock;
+  if (!flock.Init(filename_.c_str(), error_msg)) {
+    return false;
+  }
+  File* file = flock.GetFile();
+  // Another dex2oat may have appended records, or reset the file, since it was opened.
+  int64_t length = file->GetLength();
+  FileHeader header;
+  if (length < static_cast<int64_t>(sizeof(FileHeader)) ||
+      !file->PreadFully(&header, sizeof(header), 0) ||
+      !header.IsValid()) {
+    *error_msg = StringPrintf("Compilation cache '%s' was reset", filename_.c_str());
+    return false;
+  }
+  off_t end = RoundUp(static_cast<off_t>(length), RecordHeader::kAlignment);
+  if (lseek(file->Fd(), end, SEEK_SET) != end ||
+      !file->WriteFully(new_records_.data(), new_records_.size()) ||
+      file->Flush() != 0) {
+    *error_msg = StringPrintf("Failed to write compilation cache '%s': %s", filename_.c_str(),
+                              strerror(errno));
+    return false;
+  }
+  return true;
+}
+
+std::string CompilationCache::DumpStats() const {
+  size_t hits = hits_.LoadRelaxed();
+  size_t misses = misses_.LoadRelaxed();
+  size_t number_of_new_records;
+  {
+    MutexLock mu(Thread::Current(), lock_);
+    number_of_new_records = number_of_new_records_;
+  }
+  std::ostringstream oss;
+  oss << "hits=" << hits << " misses=" << misses;
+  if (hits + misses != 0u) {
+    oss << " (" << (hits * 100u / (hits + misses)) << "% hit rate)";
+  }
+  oss << " cached methods=" << records_.size() << " new methods=" << number_of_new_records;
+  if (map_ != nullptr) {
+    oss << " file size=" << PrettySize(map_->Size());
+  }
+  return oss.str();
+}
+
+}  // namespace art
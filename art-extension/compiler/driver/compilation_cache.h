@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_DRIVER_COMPILATION_CACHE_H_
+#define ART_COMPILER_DRIVER_COMPILATION_CACHE_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "arch/instruction_set.h"
+#include "atomic.h"
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "dex_file.h"
+#include "invoke_type.h"
+#include "safe_map.h"
+
+namespace art {
+
+class CompiledMethod;
+class CompilerDriver;
+class DexContentHasher;
+class MemMap;
+
+// An on-disk cache of compiled methods shared by all the dex2oat invocations using the same
+// file, so that code identical in several dex files is compiled only once.
+//
+// A method is looked up by a hash of everything its code depends on: the compilation context
+// (options, instruction set features and boot image), the constant pools of its dex file which
+// give their meaning to the indexes embedded in the code, its code item, and the content of the
+// classes it references, followed through the classes they reference up to the inlining depth.
+//
+// The file is a header followed by records appended under an exclusive file lock. It is mapped
+// when the cache is opened; methods compiled afterwards are appended by Write().
+class CompilationCache {
+ public:
+  struct Key {
+    uint64_t hash;
+    uint64_t second_hash;
+  };
+
+  // Opens the cache file `filename`, creating it if needed. Returns null and sets `error_msg`
+  // on failure.
+  static CompilationCache* Open(const std::string& filename,
+                                const std::string& context,
+                                InstructionSet instruction_set,
+                                const std::vector<const DexFile*>& dex_files,
+                                size_t inline_depth_limit,
+                                std::string* error_msg);
+
+  ~CompilationCache();
+
+  // `dex_file` must be one of the dex files the cache was opened with.
+  Key ComputeKey(const DexFile& dex_file,
+                 uint16_t class_def_idx,
+                 uint32_t method_idx,
+                 uint32_t access_flags,
+                 InvokeType invoke_type,
+                 const DexFile::CodeItem& code_item)
+      LOCKS_EXCLUDED(lock_);
+
+  // Returns a copy of the cached code of the method with `key`, or null on a cache miss.
+  CompiledMethod* Lookup(CompilerDriver* driver, const Key& key);
+
+  // Records a newly compiled method, to be added to the file by Write(). Methods with linker
+  // patches or a source mapping table are not cached.
+  void Insert(const CompilerDriver* driver, const Key& key, const CompiledMethod& compiled_method)
+      LOCKS_EXCLUDED(lock_);
+
+  // Appends the methods inserted since the cache was opened to the file.
+  bool Write(std::string* error_msg) LOCKS_EXCLUDED(lock_);
+
+  std::string DumpStats() const;
+
+ private:
+  struct FileHeader;
+  struct RecordHeader;
+
+  CompilationCache(const std::string& filename,
+                   InstructionSet instruction_set,
+                   const std::vector<const DexFile*>& dex_files,
+                   size_t inline_depth_limit,
+                   uint64_t context_hash);
+
+  // Indexes the valid records of the mapped file.
+  void IndexRecords();
+
+  // Hashes the content of the class and of its super types.
+  void HashClassHierarchy(const DexFile& dex_file,
+                          const DexFile::ClassDef& class_def,
+                          DexContentHasher* hasher) const;
+
+  // Returns the hash of the content of a class and of the classes it references, up to `depth`
+  // references away.
+  uint64_t GetDependencyHash(const DexFile& dex_file,
+                             const DexFile::ClassDef& class_def,
+                             size_t depth)
+      LOCKS_EXCLUDED(lock_);
+
+  const std::string filename_;
+  const InstructionSet instruction_set_;
+  const std::vector<const DexFile*> dex_files_;
+  const size_t inline_depth_limit_;
+  const uint64_t context_hash_;
+
+  // Hash of the constant pools of each of `dex_files_`.
+  SafeMap<const DexFile*, uint64_t> constant_pools_hashes_;
+
+  std::unique_ptr<MemMap> map_;
+  // The records of `map_` by the first hash of their key.
+  std::unordered_map<uint64_t, const RecordHeader*> records_;
+
+  mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::map<std::pair<const DexFile::ClassDef*, size_t>, uint64_t> dependency_hashes_
+      GUARDED_BY(lock_);
+  // The records to append to the file.
+  std::vector<uint8_t> new_records_ GUARDED_BY(lock_);
+  size_t number_of_new_records_ GUARDED_BY(lock_);
+
+  Atomic<size_t> hits_;
+  Atomic<size_t> misses_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompilationCache);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_DRIVER_COMPILATION_CACHE_H_
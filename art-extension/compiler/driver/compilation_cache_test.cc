@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "driver/compilation_cache.h"
+
+#include <memory>
+#include <vector>
+
+#include "common_compiler_test.h"
+#include "compiled_method.h"
+#include "dex_file-inl.h"
+#include "driver/compiler_driver.h"
+#include "driver/compiler_options.h"
+#include "scoped_thread_state_change.h"
+
+namespace art {
+
+class CompilationCacheTest : public CommonCompilerTest {
+ protected:
+  void SetUp() OVERRIDE {
+    CommonCompilerTest::SetUp();
+    jobject class_loader;
+    {
+      ScopedObjectAccess soa(Thread::Current());
+      class_loader = LoadDex("StaticLeafMethods");
+    }
+    ASSERT_NE(class_loader, nullptr);
+    dex_files_ = GetDexFiles(class_loader);
+    ASSERT_FALSE(dex_files_.empty());
+  }
+
+  CompilationCache* OpenCache(const std::string& context) {
+    std::string error_msg;
+    CompilationCache* cache = CompilationCache::Open(cache_file_.GetFilename(),
+                                                     context,
+                                                     compiler_driver_->GetInstructionSet(),
+                                                     dex_files_,
+                                                     CompilerOptions::kDefaultInlineDepthLimit,
+                                                     &error_msg);
+    EXPECT_NE(cache, nullptr) << error_msg;
+    return cache;
+  }
+
+  // Computes the key of the first method with code of the first class.
+  CompilationCache::Key ComputeKey(CompilationCache* cache) {
+    const DexFile& dex_file = *dex_files_[0];
+    const DexFile::ClassDef& class_def = dex_file.GetClassDef(0);
+    ClassDataItemIterator it(dex_file, dex_file.GetClassData(class_def));
+    while (it.HasNextStaticField() || it.HasNextInstanceField()) {
+      it.Next();
+    }
+    while (it.GetMethodCodeItem() == nullptr) {
+      it.Next();
+    }
+    return cache->ComputeKey(dex_file, 0u, it.GetMemberIndex(), it.GetMethodAccessFlags(),
+                             it.GetMethodInvokeType(class_def), *it.GetMethodCodeItem());
+  }
+
+  ScratchFile cache_file_;
+  std::vector<const DexFile*> dex_files_;
+};
+
+TEST_F(CompilationCacheTest, HitAfterWrite) {
+  const std::vector<uint8_t> code = { 1u, 2u, 3u, 4u };
+  const std::vector<uint8_t> vmap_table = { 5u, 6u };
+  {
+    std::unique_ptr<CompilationCache> cache(OpenCache("context"));
+    CompilationCache::Key key = ComputeKey(cache.get());
+    CompilationCache::Key same_key = ComputeKey(cache.get());
+    EXPECT_EQ(key.hash, same_key.hash);
+    EXPECT_EQ(key.second_hash, same_key.second_hash);
+    EXPECT_EQ(cache->Lookup(compiler_driver_.get(), key), nullptr);
+
+    DefaultSrcMap src_mapping_table;
+    CompiledMethod* compiled_method = CompiledMethod::SwapAllocCompiledMethod(
+        compiler_driver_.get(),
+        compiler_driver_->GetInstructionSet(),
+        ArrayRef<const uint8_t>(code),
+        64u,
+        0x1u,
+        0x2u,
+        &src_mapping_table,
+        ArrayRef<const uint8_t>(),
+        ArrayRef<const uint8_t>(vmap_table),
+        ArrayRef<const uint8_t>(),
+        ArrayRef<const uint8_t>(),
+        ArrayRef<const LinkerPatch>());
+    cache->Insert(compiler_driver_.get(), key, *compiled_method);
+    CompiledMethod::ReleaseSwapAllocatedCompiledMethod(compiler_driver_.get(), compiled_method);
+    std::string error_msg;
+    ASSERT_TRUE(cache->Write(&error_msg)) << error_msg;
+  }
+
+  std::unique_ptr<CompilationCache> cache(OpenCache("context"));
+  CompiledMethod* compiled_method =
+      cache->Lookup(compiler_driver_.get(), ComputeKey(cache.get()));
+  ASSERT_NE(compiled_method, nullptr);
+  EXPECT_EQ(code, std::vector<uint8_t>(compiled_method->GetQuickCode()->begin(),
+                                       compiled_method->GetQuickCode()->end()));
+  EXPECT_EQ(vmap_table, std::vector<uint8_t>(compiled_method->GetVmapTable()->begin(),
+                                             compiled_method->GetVmapTable()->end()));
+  EXPECT_EQ(64u, compiled_method->GetFrameSizeInBytes());
+  EXPECT_EQ(0x1u, compiled_method->GetCoreSpillMask());
+  EXPECT_EQ(0x2u, compiled_method->GetFpSpillMask());
+  CompiledMethod::ReleaseSwapAllocatedCompiledMethod(compiler_driver_.get(), compiled_method);
+
+  // The same method compiled in another context is not found.
+  std::unique_ptr<CompilationCache> other_cache(OpenCache("other context"));
+  EXPECT_EQ(other_cache->Lookup(compiler_driver_.get(), ComputeKey(other_cache.get())), nullptr);
+}
+
+}  // namespace art
@@ -22,6 +22,7 @@
 #define ATRACE_TAG ATRACE_TAG_DALVIK
 #include <utils/Trace.h>
 
+#include <algorithm>
 #include <unordered_set>
 #include <vector>
 #include <unistd.h>
@@ -46,7 +47,9 @@
 #include "dex/verified_method.h"
 #include "dex/quick/dex_file_method_inliner.h"
 #include "dex/quick/dex_file_to_method_inliner_map.h"
+#include "driver/compilation_cache.h"
 #include "driver/compiler_options.h"
+#include "driver/incremental_compilation.h"
 #include "elf_writer_quick.h"
 #include "jni_internal.h"
 #include "object_lock.h"
@@ -70,6 +73,7 @@
 #include "thread_pool.h"
 #include "trampolines/trampoline_compiler.h"
 #include "transaction.h"
+#include "utils/code_stream.h"
 #include "utils/dex_cache_arrays_layout-inl.h"
 #include "utils/swap_space.h"
 #include "verifier/method_verifier.h"
@@ -374,6 +378,7 @@ CompilerDriver::CompilerDriver(const CompilerOptions* compiler_options,
       compiled_methods_lock_("compiled method lock"),
       compiled_methods_(MethodTable::key_compare()),
       non_relative_linker_patch_count_(0u),
+      linker_patch_count_(0u),
       image_(image),
       image_classes_(image_classes),
       classes_to_compile_(compiled_classes),
@@ -1597,6 +1602,34 @@ bool CompilerDriver::IsSafeCast(const DexCompilationUnit* mUnit, uint32_t dex_pc
   return result;
 }
 
+// A method to compile. CompileDexFile hands out methods rather than classes to the compiler
+// threads, so that a class with many or large methods does not keep a single thread busy
+// while the others are idle.
+struct MethodCompilationItem {
+  const DexFile::CodeItem* code_item;
+  uint32_t access_flags;
+  InvokeType invoke_type;
+  uint16_t class_def_index;
+  uint32_t method_idx;
+  DexToDexCompilationLevel dex_to_dex_compilation_level;
+  bool compilation_enabled;
+
+  size_t GetCodeSize() const {
+    return code_item == nullptr ? 0u : code_item->insns_size_in_code_units_;
+  }
+};
+
+// The methods of the dex file being compiled: first collected per class, in parallel,
+// then flattened into a single list of work items.
+struct DexFileCompilationPlan {
+  explicit DexFileCompilationPlan(size_t number_of_class_defs)
+      : methods_of_class(number_of_class_defs) {}
+
+  // Indexed by class def index, only written by the thread preparing the class.
+  std::vector<std::vector<MethodCompilationItem>> methods_of_class;
+  std::vector<MethodCompilationItem> methods;
+};
+
 class ParallelCompilationManager {
  public:
   typedef void Callback(const ParallelCompilationManager* manager, size_t index);
@@ -1617,7 +1650,9 @@ class ParallelCompilationManager {
       thread_pool_(thread_pool),
       metric_(metric),
       monitor_task_(nullptr),
-      active_tasks_count_(0) {}
+      active_tasks_count_(0),
+      first_task_finish_ns_(0),
+      plan_(nullptr) {}
 
   ClassLinker* GetClassLinker() const {
     CHECK(class_linker_ != nullptr);
@@ -1646,6 +1681,21 @@ class ParallelCompilationManager {
     return metric_;
   }
 
+  DexFileCompilationPlan* GetPlan() const {
+    CHECK(plan_ != nullptr);
+    return plan_;
+  }
+
+  void SetPlan(DexFileCompilationPlan* plan) {
+    plan_ = plan;
+  }
+
+  // Time at which the first working task ran out of work during the last ForAll. The time
+  // from there to the end of ForAll is the tail of the parallel phase.
+  uint64_t GetFirstTaskFinishNs() const {
+    return first_task_finish_ns_.LoadRelaxed();
+  }
+
   void ForAll(size_t begin, size_t end, Callback callback, size_t work_units) {
     Thread* self = Thread::Current();
     self->AssertNoPendingException();
@@ -1656,6 +1706,7 @@ class ParallelCompilationManager {
     // If metric can't be initialized or it is null then don't start a monitoring thread.
     index_.StoreRelaxed(begin);
     active_tasks_count_.StoreRelaxed(0);
+    first_task_finish_ns_.StoreRelaxed(0);
     if (metric_ != nullptr && metric_->Initialize()) {
       monitor_task_.reset(new MonitoringTask(this, metric_->GetUpdateIntervalMs()));
     } else {
@@ -1836,6 +1887,7 @@ class ParallelCompilationManager {
   }
 
   void OnWorkingTaskFinish(Thread* self) {
+    first_task_finish_ns_.CompareExchangeStrongSequentiallyConsistent(0, NanoTime());
     if (monitor_task_.get() != nullptr) {
         monitor_task_->Stop(self);
     }
@@ -1859,6 +1911,9 @@ class ParallelCompilationManager {
   std::unique_ptr<MonitoringTask> monitor_task_;
   // Number of working tasks which are not in sleep state.
   Atomic<size_t> active_tasks_count_;
+  Atomic<uint64_t> first_task_finish_ns_;
+  // Work items of CompileDexFile.
+  DexFileCompilationPlan* plan_;
 
   DISALLOW_COPY_AND_ASSIGN(ParallelCompilationManager);
 };
@@ -2322,8 +2377,8 @@ void CompilerDriver::Compile(jobject class_loader, const std::vector<const DexFi
   VLOG(compiler) << "Compile: " << GetMemoryUsageString(false);
 }
 
-void CompilerDriver::CompileClass(const ParallelCompilationManager* manager,
-                                  size_t class_def_index) {
+void CompilerDriver::PrepareClassForCompilation(const ParallelCompilationManager* manager,
+                                                size_t class_def_index) {
   ATRACE_CALL();
   const DexFile& dex_file = *manager->GetDexFile();
   const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
@@ -2381,10 +2436,21 @@ void CompilerDriver::CompileClass(const ParallelCompilationManager* manager,
   bool compilation_enabled = driver->IsClassToCompile(
       dex_file.StringByTypeIdx(class_def.class_idx_));
 
-  // Compile direct methods
+  std::vector<MethodCompilationItem>& methods =
+      manager->GetPlan()->methods_of_class[class_def_index];
+  methods.reserve(it.NumDirectMethods() + it.NumVirtualMethods());
+
+  // The code of a class which did not change since the previous compilation is copied from it
+  // rather than compiled again. Methods are found there by their position in the class data.
+  bool reuse_code = compilation_enabled && driver->incremental_compilation_ != nullptr &&
+      driver->incremental_compilation_->IsClassReusable(dex_file, class_def_index);
+  size_t next_class_def_method_index = 0u;
+
+  // Collect direct methods
   int64_t previous_direct_method_idx = -1;
   while (it.HasNextDirectMethod()) {
     uint32_t method_idx = it.GetMemberIndex();
+    size_t class_def_method_index = next_class_def_method_index++;
     if (method_idx == previous_direct_method_idx) {
       // smali can create dex files with two encoded_methods sharing the same method_idx
       // http://code.google.com/p/smali/issues/detail?id=119
@@ -2392,16 +2458,20 @@ void CompilerDriver::CompileClass(const ParallelCompilationManager* manager,
       continue;
     }
     previous_direct_method_idx = method_idx;
-    driver->CompileMethod(self, it.GetMethodCodeItem(), it.GetMethodAccessFlags(),
-                          it.GetMethodInvokeType(class_def), class_def_index,
-                          method_idx, jclass_loader, dex_file, dex_to_dex_compilation_level,
-                          compilation_enabled);
+    if (!reuse_code ||
+        !driver->ReuseCompiledMethod(self, dex_file, class_def_index, class_def_method_index,
+                                     method_idx, it.GetMethodAccessFlags())) {
+      methods.push_back({ it.GetMethodCodeItem(), it.GetMethodAccessFlags(),
+                          it.GetMethodInvokeType(class_def), static_cast<uint16_t>(class_def_index),
+                          method_idx, dex_to_dex_compilation_level, compilation_enabled });
+    }
     it.Next();
   }
-  // Compile virtual methods
+  // Collect virtual methods
   int64_t previous_virtual_method_idx = -1;
   while (it.HasNextVirtualMethod()) {
     uint32_t method_idx = it.GetMemberIndex();
+    size_t class_def_method_index = next_class_def_method_index++;
     if (method_idx == previous_virtual_method_idx) {
       // smali can create dex files with two encoded_methods sharing the same method_idx
       // http://code.google.com/p/smali/issues/detail?id=119
@@ -2409,22 +2479,95 @@ void CompilerDriver::CompileClass(const ParallelCompilationManager* manager,
       continue;
     }
     previous_virtual_method_idx = method_idx;
-    driver->CompileMethod(self, it.GetMethodCodeItem(), it.GetMethodAccessFlags(),
-                          it.GetMethodInvokeType(class_def), class_def_index,
-                          method_idx, jclass_loader, dex_file, dex_to_dex_compilation_level,
-                          compilation_enabled);
+    if (!reuse_code ||
+        !driver->ReuseCompiledMethod(self, dex_file, class_def_index, class_def_method_index,
+                                     method_idx, it.GetMethodAccessFlags())) {
+      methods.push_back({ it.GetMethodCodeItem(), it.GetMethodAccessFlags(),
+                          it.GetMethodInvokeType(class_def), static_cast<uint16_t>(class_def_index),
+                          method_idx, dex_to_dex_compilation_level, compilation_enabled });
+    }
     it.Next();
   }
   DCHECK(!it.HasNext());
 }
 
+bool CompilerDriver::ReuseCompiledMethod(Thread* self, const DexFile& dex_file,
+                                         uint16_t class_def_idx, size_t class_def_method_index,
+                                         uint32_t method_idx, uint32_t access_flags) {
+  // Native methods are cheap to compile; only reuse what CompileMethod would compile.
+  MethodReference method_ref(&dex_file, method_idx);
+  if ((access_flags & (kAccNative | kAccAbstract)) != 0 ||
+      !verification_results_->IsCandidateForCompilation(method_ref, access_flags) ||
+      verification_results_->GetVerifiedMethod(method_ref) == nullptr ||
+      !IsMethodToCompile(method_ref)) {
+    return false;
+  }
+  CompiledMethod* compiled_method = incremental_compilation_->ReuseMethod(
+      this, dex_file, class_def_idx, class_def_method_index);
+  if (compiled_method == nullptr) {
+    return false;
+  }
+  DCHECK(compiled_method->GetPatches().empty());
+  DCHECK(GetCompiledMethod(method_ref) == nullptr) << PrettyMethod(method_idx, dex_file);
+  {
+    MutexLock mu(self, compiled_methods_lock_);
+    compiled_methods_.Put(method_ref, compiled_method);
+  }
+  if (compiler_kind_ != Compiler::kOptimizing) {
+    verification_results_->RemoveVerifiedMethod(method_ref);
+  }
+  return true;
+}
+
+void CompilerDriver::CompileMethodItem(const ParallelCompilationManager* manager,
+                                       size_t index) {
+  ATRACE_CALL();
+  const MethodCompilationItem& item = manager->GetPlan()->methods[index];
+  manager->GetCompiler()->CompileMethod(Thread::Current(), item.code_item, item.access_flags,
+                                        item.invoke_type, item.class_def_index, item.method_idx,
+                                        manager->GetClassLoader(), *manager->GetDexFile(),
+                                        item.dex_to_dex_compilation_level,
+                                        item.compilation_enabled);
+}
+
 void CompilerDriver::CompileDexFile(jobject class_loader, const DexFile& dex_file,
                                     const std::vector<const DexFile*>& dex_files,
                                     ThreadPool* thread_pool, TimingLogger* timings) {
   TimingLogger::ScopedTiming t("Compile Dex File", timings);
   ParallelCompilationManager context(Runtime::Current()->GetClassLinker(), class_loader, this,
                                      &dex_file, dex_files, thread_pool, system_load_metric_.get());
-  context.ForAll(0, dex_file.NumClassDefs(), CompilerDriver::CompileClass, thread_count_);
+  DexFileCompilationPlan plan(dex_file.NumClassDefs());
+  context.SetPlan(&plan);
+  {
+    TimingLogger::ScopedTiming t2("Collect Methods", timings);
+    context.ForAll(0, dex_file.NumClassDefs(), CompilerDriver::PrepareClassForCompilation,
+                   thread_count_);
+    size_t number_of_methods = 0;
+    for (const std::vector<MethodCompilationItem>& methods : plan.methods_of_class) {
+      number_of_methods += methods.size();
+    }
+    plan.methods.reserve(number_of_methods);
+    for (std::vector<MethodCompilationItem>& methods : plan.methods_of_class) {
+      plan.methods.insert(plan.methods.end(), methods.begin(), methods.end());
+      std::vector<MethodCompilationItem>().swap(methods);
+    }
+    // Hand out the largest methods first: the last methods to be picked are then the
+    // cheapest ones, which keeps the compiler threads finishing close to each other.
+    std::stable_sort(plan.methods.begin(), plan.methods.end(),
+                     [](const MethodCompilationItem& a, const MethodCompilationItem& b) {
+                       return a.GetCodeSize() > b.GetCodeSize();
+                     });
+  }
+  context.ForAll(0, plan.methods.size(), CompilerDriver::CompileMethodItem, thread_count_);
+
+  // Record the time between the first and the last compiler thread running out of methods.
+  uint64_t first_task_finish_ns = context.GetFirstTaskFinishNs();
+  if (first_task_finish_ns != 0) {
+    timings->StartTimingAt("Compile Dex File Tail", first_task_finish_ns);
+    timings->EndTiming();
+    VLOG(compiler) << "Compile Dex File tail for " << dex_file.GetLocation() << ": "
+                   << PrettyDuration(NanoTime() - first_task_finish_ns);
+  }
 }
 
 // Does the runtime for the InstructionSet provide an implementation returned by
@@ -2480,9 +2623,20 @@ void CompilerDriver::CompileMethod(Thread* self, const DexFile::CodeItem* code_i
                    // Is eligable for compilation by methods-to-compile filter.
                    IsMethodToCompile(method_ref);
     if (compile) {
-      // NOTE: if compiler declines to compile this method, it will return null.
-      compiled_method = compiler_->Compile(code_item, access_flags, invoke_type, class_def_idx,
-                                           method_idx, class_loader, dex_file);
+      CompilationCache::Key cache_key = { 0u, 0u };
+      if (compilation_cache_ != nullptr) {
+        cache_key = compilation_cache_->ComputeKey(dex_file, class_def_idx, method_idx,
+                                                   access_flags, invoke_type, *code_item);
+        compiled_method = compilation_cache_->Lookup(this, cache_key);
+      }
+      if (compiled_method == nullptr) {
+        // NOTE: if compiler declines to compile this method, it will return null.
+        compiled_method = compiler_->Compile(code_item, access_flags, invoke_type, class_def_idx,
+                                             method_idx, class_loader, dex_file);
+        if (compiled_method != nullptr && compilation_cache_ != nullptr) {
+          compilation_cache_->Insert(this, cache_key, *compiled_method);
+        }
+      }
     }
     if (compiled_method == nullptr && dex_to_dex_compilation_level != kDontDexToDexCompile) {
       // TODO: add a command-line option to disable DEX-to-DEX compilation ?
@@ -2519,6 +2673,7 @@ void CompilerDriver::CompileMethod(Thread* self, const DexFile::CodeItem* code_i
       MutexLock mu(self, compiled_methods_lock_);
       compiled_methods_.Put(method_ref, compiled_method);
       non_relative_linker_patch_count_ += non_relative_linker_patch_count;
+      linker_patch_count_ += compiled_method->GetPatches().size();
     }
     DCHECK(GetCompiledMethod(method_ref) != nullptr) << PrettyMethod(method_idx, dex_file);
   }
@@ -2627,6 +2782,23 @@ size_t CompilerDriver::GetNonRelativeLinkerPatchCount() const {
   return non_relative_linker_patch_count_;
 }
 
+size_t CompilerDriver::GetLinkerPatchCount() const {
+  MutexLock mu(Thread::Current(), compiled_methods_lock_);
+  return linker_patch_count_;
+}
+
+void CompilerDriver::SetIncrementalCompilation(IncrementalCompilation* incremental_compilation) {
+  incremental_compilation_.reset(incremental_compilation);
+}
+
+void CompilerDriver::SetCompilationCache(CompilationCache* compilation_cache) {
+  compilation_cache_.reset(compilation_cache);
+}
+
+void CompilerDriver::SetCodeStream(CodeStream* code_stream) {
+  code_stream_.reset(code_stream);
+}
+
 void CompilerDriver::AddRequiresConstructorBarrier(Thread* self, const DexFile* dex_file,
                                                    uint16_t class_def_index) {
   WriterMutexLock mu(self, freezing_constructor_lock_);
@@ -2685,6 +2857,25 @@ bool CompilerDriver::SkipCompilation(const std::string& method_name) {
   return !compile;
 }
 
+CompilerDriver::ProfileHotness CompilerDriver::GetProfileHotness(const std::string& method_name) {
+  if (!profile_present_) {
+    return kProfileHotnessUnknown;
+  }
+  ProfileFile::ProfileData data;
+  if (!profile_file_.GetProfileData(&data, method_name)) {
+    // Not sampled at all.
+    return kProfileHotnessCold;
+  }
+
+  // Compare against the start of the topK percentage bucket, as SkipCompilation does.
+  double bucket_start = data.GetTopKUsedPercentage() - data.GetUsedPercent();
+  double threshold = compiler_options_->GetTopKProfileThreshold();
+  if (bucket_start > threshold) {
+    return kProfileHotnessCold;
+  }
+  return (bucket_start <= threshold / 2) ? kProfileHotnessHot : kProfileHotnessWarm;
+}
+
 std::string CompilerDriver::GetMemoryUsageString(bool extended) const {
   std::ostringstream oss;
   Runtime* const runtime = Runtime::Current();
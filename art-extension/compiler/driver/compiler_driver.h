@@ -57,12 +57,15 @@ namespace verifier {
 class MethodVerifier;
 }  // namespace verifier
 
+class CodeStream;
+class CompilationCache;
 class CompiledClass;
 class CompiledMethod;
 class CompilerOptions;
 class DexCompilationUnit;
 class DexFileToMethodInlinerMap;
 struct InlineIGetIPutData;
+class IncrementalCompilation;
 class InstructionSetFeatures;
 class OatWriter;
 class ParallelCompilationManager;
@@ -189,6 +192,8 @@ class CompilerDriver {
       LOCKS_EXCLUDED(compiled_methods_lock_);
   size_t GetNonRelativeLinkerPatchCount() const
       LOCKS_EXCLUDED(compiled_methods_lock_);
+  size_t GetLinkerPatchCount() const
+      LOCKS_EXCLUDED(compiled_methods_lock_);
 
   // Remove and delete a compiled method.
   void RemoveCompiledMethod(const MethodReference& method_ref);
@@ -445,6 +450,24 @@ class CompilerDriver {
     return dedupe_enabled_;
   }
 
+  // Reuse the code of a previous compilation for the classes that did not change since.
+  void SetIncrementalCompilation(IncrementalCompilation* incremental_compilation);
+
+  // Look up the methods to compile in an on-disk cache of compiled methods, and add to it
+  // the methods which had to be compiled.
+  void SetCompilationCache(CompilationCache* compilation_cache);
+
+  CompilationCache* GetCompilationCache() const {
+    return compilation_cache_.get();
+  }
+
+  // Append the code of the compiled methods to a file rather than keeping it in memory.
+  void SetCodeStream(CodeStream* code_stream);
+
+  CodeStream* GetCodeStream() const {
+    return code_stream_.get();
+  }
+
   // Checks if class specified by type_idx is one of the image_classes_
   bool IsImageClass(const char* descriptor) const;
 
@@ -473,6 +496,17 @@ class CompilerDriver {
   // Should the compiler run on this method given profile information?
   bool SkipCompilation(const std::string& method_name);
 
+  // Hotness of a method according to the profile information.
+  enum ProfileHotness {
+    kProfileHotnessUnknown,  // No profile is present.
+    kProfileHotnessCold,     // Not part of the leading top K% samples.
+    kProfileHotnessWarm,     // Part of the leading top K% samples.
+    kProfileHotnessHot,      // Part of the leading top K/2% samples.
+  };
+
+  // How hot is this method given profile information?
+  ProfileHotness GetProfileHotness(const std::string& method_name);
+
   // Get memory usage during compilation.
   std::string GetMemoryUsageString(bool extended) const;
 
@@ -613,7 +647,16 @@ class CompilerDriver {
                      bool compilation_enabled)
       LOCKS_EXCLUDED(compiled_methods_lock_);
 
-  static void CompileClass(const ParallelCompilationManager* context, size_t class_def_index)
+  static void PrepareClassForCompilation(const ParallelCompilationManager* context,
+                                         size_t class_def_index)
+      LOCKS_EXCLUDED(Locks::mutator_lock_);
+  // Copies the code of a method of an unchanged class from the previous compilation.
+  // Returns false if the method has to be compiled.
+  bool ReuseCompiledMethod(Thread* self, const DexFile& dex_file, uint16_t class_def_idx,
+                           size_t class_def_method_index, uint32_t method_idx,
+                           uint32_t access_flags)
+      LOCKS_EXCLUDED(compiled_methods_lock_);
+  static void CompileMethodItem(const ParallelCompilationManager* context, size_t index)
       LOCKS_EXCLUDED(Locks::mutator_lock_);
 
   // Swap pool and allocator used for native allocations. May be file-backed. Needs to be first
@@ -650,6 +693,8 @@ class CompilerDriver {
   // Number of non-relative patches in all compiled methods. These patches need space
   // in the .oat_patches ELF section if requested in the compiler options.
   size_t non_relative_linker_patch_count_ GUARDED_BY(compiled_methods_lock_);
+  // Number of patches, relative or not, in all compiled methods.
+  size_t linker_patch_count_ GUARDED_BY(compiled_methods_lock_);
 
   const bool image_;
 
@@ -674,6 +719,12 @@ class CompilerDriver {
   size_t monitor_thread_count_;
   std::unique_ptr<SystemLoadMetric> system_load_metric_;
 
+  std::unique_ptr<IncrementalCompilation> incremental_compilation_;
+
+  std::unique_ptr<CompilationCache> compilation_cache_;
+
+  std::unique_ptr<CodeStream> code_stream_;
+
   class AOTCompilationStats;
   std::unique_ptr<AOTCompilationStats> stats_;
 
@@ -775,18 +826,18 @@ class CompilerDriver {
     }
   };
 
-  DedupeSet<ArrayRef<const uint8_t>,
-            SwapVector<uint8_t>, size_t, DedupeHashFunc<const uint8_t>, 4> dedupe_code_;
-  DedupeSet<ArrayRef<SrcMapElem>,
-            SwapSrcMap, size_t, DedupeHashFunc<SrcMapElem>, 4> dedupe_src_mapping_table_;
-  DedupeSet<ArrayRef<const uint8_t>,
-            SwapVector<uint8_t>, size_t, DedupeHashFunc<const uint8_t>, 4> dedupe_mapping_table_;
-  DedupeSet<ArrayRef<const uint8_t>,
-            SwapVector<uint8_t>, size_t, DedupeHashFunc<const uint8_t>, 4> dedupe_vmap_table_;
-  DedupeSet<ArrayRef<const uint8_t>,
-            SwapVector<uint8_t>, size_t, DedupeHashFunc<const uint8_t>, 4> dedupe_gc_map_;
-  DedupeSet<ArrayRef<const uint8_t>,
-            SwapVector<uint8_t>, size_t, DedupeHashFunc<const uint8_t>, 4> dedupe_cfi_info_;
+  ConcurrentDedupeSet<ArrayRef<const uint8_t>, SwapVector<uint8_t>, size_t,
+                      DedupeHashFunc<const uint8_t>, 4> dedupe_code_;
+  ConcurrentDedupeSet<ArrayRef<SrcMapElem>, SwapSrcMap, size_t,
+                      DedupeHashFunc<SrcMapElem>, 4> dedupe_src_mapping_table_;
+  ConcurrentDedupeSet<ArrayRef<const uint8_t>, SwapVector<uint8_t>, size_t,
+                      DedupeHashFunc<const uint8_t>, 4> dedupe_mapping_table_;
+  ConcurrentDedupeSet<ArrayRef<const uint8_t>, SwapVector<uint8_t>, size_t,
+                      DedupeHashFunc<const uint8_t>, 4> dedupe_vmap_table_;
+  ConcurrentDedupeSet<ArrayRef<const uint8_t>, SwapVector<uint8_t>, size_t,
+                      DedupeHashFunc<const uint8_t>, 4> dedupe_gc_map_;
+  ConcurrentDedupeSet<ArrayRef<const uint8_t>, SwapVector<uint8_t>, size_t,
+                      DedupeHashFunc<const uint8_t>, 4> dedupe_cfi_info_;
 
   DISALLOW_COPY_AND_ASSIGN(CompilerDriver);
 };
@@ -47,6 +47,9 @@ CompilerOptions::CompilerOptions()
       verbose_methods_(nullptr),
       pass_manager_options_(new PassManagerOptions),
       abort_on_hard_verifier_failure_(false),
+      register_allocation_(kDefaultRegisterAllocation),
+      optimization_tiers_(kDefaultOptimizationTiers),
+      optimization_time_budget_ms_(kDefaultOptimizationTimeBudgetMs),
       init_failure_output_(nullptr) {
 }
 
@@ -103,6 +106,9 @@ CompilerOptions::CompilerOptions(CompilerFilter compiler_filter,
     verbose_methods_(verbose_methods),
     pass_manager_options_(pass_manager_options),
     abort_on_hard_verifier_failure_(abort_on_hard_verifier_failure),
+    register_allocation_(kDefaultRegisterAllocation),
+    optimization_tiers_(kDefaultOptimizationTiers),
+    optimization_time_budget_ms_(kDefaultOptimizationTimeBudgetMs),
     init_failure_output_(init_failure_output) {
 }
 
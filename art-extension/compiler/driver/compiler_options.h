@@ -44,6 +44,13 @@ class CompilerOptions {
     kTime,                // Compile methods, but minimize compilation time.
   };
 
+  // Register allocator used for the methods compiled with the optimizing compiler.
+  enum RegisterAllocation {
+    kRegisterAllocationLinearScan,    // Linear scan for every method.
+    kRegisterAllocationLoopAware,     // Loop aware linear scan for every method.
+    kRegisterAllocationLoopAwareHot,  // Loop aware linear scan for the hot methods of the profile.
+  };
+
   // Guide heuristics to determine whether to compile method if profile data not available.
   static const CompilerFilter kDefaultCompilerFilter = kSpeed;
   static const size_t kDefaultHugeMethodThreshold = 10000;
@@ -56,6 +63,9 @@ class CompilerOptions {
   static const bool kDefaultIncludePatchInformation = false;
   static const size_t kDefaultInlineDepthLimit = 3;
   static const size_t kDefaultInlineMaxCodeUnits = 76;
+  static const RegisterAllocation kDefaultRegisterAllocation = kRegisterAllocationLoopAwareHot;
+  static const bool kDefaultOptimizationTiers = true;
+  static const size_t kDefaultOptimizationTimeBudgetMs = 0;  // No budget.
 
   // Default inlining settings when the space filter is used.
   static constexpr size_t kSpaceFilterInlineDepthLimit = 5;
@@ -230,6 +240,30 @@ class CompilerOptions {
     return pass_manager_options_.get();
   }
 
+  RegisterAllocation GetRegisterAllocation() const {
+    return register_allocation_;
+  }
+
+  void SetRegisterAllocation(RegisterAllocation register_allocation) {
+    register_allocation_ = register_allocation;
+  }
+
+  bool GetOptimizationTiers() const {
+    return optimization_tiers_;
+  }
+
+  void SetOptimizationTiers(bool optimization_tiers) {
+    optimization_tiers_ = optimization_tiers;
+  }
+
+  size_t GetOptimizationTimeBudgetMs() const {
+    return optimization_time_budget_ms_;
+  }
+
+  void SetOptimizationTimeBudgetMs(size_t optimization_time_budget_ms) {
+    optimization_time_budget_ms_ = optimization_time_budget_ms;
+  }
+
   bool AbortOnHardVerifierFailure() const {
     return abort_on_hard_verifier_failure_;
   }
@@ -266,6 +300,17 @@ class CompilerOptions {
   // failure.
   const bool abort_on_hard_verifier_failure_;
 
+  // The register allocator used by the optimizing compiler.
+  RegisterAllocation register_allocation_;
+
+  // Whether the optimizing compiler selects the passes run for a method from its size, its
+  // loops and the profile, rather than running all of them.
+  bool optimization_tiers_;
+
+  // Time after which the optimizing compiler stops running the optional passes of a method,
+  // 0 for no limit.
+  size_t optimization_time_budget_ms_;
+
   // Log initialization of initialization failures to this stream if not null.
   std::ostream* const init_failure_output_;
 
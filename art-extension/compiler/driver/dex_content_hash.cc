@@ -0,0 +1,248 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "dex_content_hash.h"
+
+#include "dex_file-inl.h"
+#include "dex_instruction-inl.h"
+#include "leb128.h"
+#include "utf.h"
+
+namespace art {
+
+static bool IsAtMethod(const ClassDataItemIterator& it) {
+  return it.HasNextDirectMethod() || it.HasNextVirtualMethod();
+}
+
+// Returns the end of the encoded catch handlers of a code item with try items.
+static const uint8_t* GetCatchHandlersEnd(const DexFile::CodeItem& code_item) {
+  const uint8_t* handlers_ptr = DexFile::GetCatchHandlerData(code_item, 0);
+  uint32_t handlers_size = DecodeUnsignedLeb128(&handlers_ptr);
+  for (uint32_t i = 0; i < handlers_size; ++i) {
+    CatchHandlerIterator iterator(handlers_ptr);
+    for (; iterator.HasNext(); iterator.Next()) {
+    }
+    handlers_ptr = iterator.EndDataPointer();
+  }
+  return handlers_ptr;
+}
+
+void HashCodeItem(const DexFile::CodeItem& code_item, DexContentHasher* hasher) {
+  hasher->Update(code_item.registers_size_);
+  hasher->Update(code_item.ins_size_);
+  hasher->Update(code_item.outs_size_);
+  hasher->Update(code_item.tries_size_);
+  hasher->Update(code_item.insns_size_in_code_units_);
+  hasher->Update(code_item.insns_, code_item.insns_size_in_code_units_ * sizeof(uint16_t));
+  if (code_item.tries_size_ != 0) {
+    const uint8_t* tries = reinterpret_cast<const uint8_t*>(DexFile::GetTryItems(code_item, 0));
+    hasher->Update(tries, GetCatchHandlersEnd(code_item) - tries);
+  }
+}
+
+void HashClassContent(const DexFile& dex_file,
+                      const DexFile::ClassDef& class_def,
+                      DexContentHasher* hasher) {
+  hasher->Update(class_def.class_idx_);
+  hasher->Update(class_def.access_flags_);
+  hasher->Update(class_def.superclass_idx_);
+  const DexFile::TypeList* interfaces = dex_file.GetInterfacesList(class_def);
+  if (interfaces != nullptr) {
+    for (uint32_t i = 0; i < interfaces->Size(); ++i) {
+      hasher->Update(interfaces->GetTypeItem(i).type_idx_);
+    }
+  }
+  const uint8_t* class_data = dex_file.GetClassData(class_def);
+  if (class_data == nullptr) {
+    return;
+  }
+  for (ClassDataItemIterator it(dex_file, class_data); it.HasNext(); it.Next()) {
+    hasher->Update(it.GetMemberIndex());
+    hasher->Update(it.GetRawMemberAccessFlags());
+    const DexFile::CodeItem* code_item = IsAtMethod(it) ? it.GetMethodCodeItem() : nullptr;
+    if (code_item != nullptr) {
+      HashCodeItem(*code_item, hasher);
+    }
+  }
+}
+
+static void HashTypeList(const DexFile::TypeList* type_list, DexContentHasher* hasher) {
+  uint32_t size = (type_list == nullptr) ? 0u : type_list->Size();
+  hasher->Update(size);
+  for (uint32_t i = 0; i < size; ++i) {
+    hasher->Update(type_list->GetTypeItem(i).type_idx_);
+  }
+}
+
+void HashConstantPools(const DexFile& dex_file, DexContentHasher* hasher) {
+  hasher->Update(dex_file.NumStringIds());
+  for (uint32_t i = 0; i < dex_file.NumStringIds(); ++i) {
+    hasher->UpdateString(dex_file.StringDataByIdx(i));
+  }
+  hasher->Update(dex_file.NumTypeIds());
+  for (uint32_t i = 0; i < dex_file.NumTypeIds(); ++i) {
+    hasher->Update(dex_file.GetTypeId(i).descriptor_idx_);
+  }
+  hasher->Update(dex_file.NumProtoIds());
+  for (uint32_t i = 0; i < dex_file.NumProtoIds(); ++i) {
+    const DexFile::ProtoId& proto_id = dex_file.GetProtoId(i);
+    hasher->Update(proto_id.shorty_idx_);
+    hasher->Update(proto_id.return_type_idx_);
+    HashTypeList(dex_file.GetProtoParameters(proto_id), hasher);
+  }
+  // Field and method ids only hold indexes: hash them as a whole.
+  hasher->Update(dex_file.NumFieldIds());
+  if (dex_file.NumFieldIds() != 0u) {
+    hasher->Update(&dex_file.GetFieldId(0), dex_file.NumFieldIds() * sizeof(DexFile::FieldId));
+  }
+  hasher->Update(dex_file.NumMethodIds());
+  if (dex_file.NumMethodIds() != 0u) {
+    hasher->Update(&dex_file.GetMethodId(0), dex_file.NumMethodIds() * sizeof(DexFile::MethodId));
+  }
+}
+
+static void AddProtoTypes(const DexFile& dex_file,
+                          uint32_t proto_idx,
+                          std::vector<uint16_t>* type_indexes) {
+  const DexFile::ProtoId& proto_id = dex_file.GetProtoId(proto_idx);
+  type_indexes->push_back(proto_id.return_type_idx_);
+  const DexFile::TypeList* parameters = dex_file.GetProtoParameters(proto_id);
+  if (parameters != nullptr) {
+    for (uint32_t i = 0; i < parameters->Size(); ++i) {
+      type_indexes->push_back(parameters->GetTypeItem(i).type_idx_);
+    }
+  }
+}
+
+static void AddFieldTypes(const DexFile& dex_file,
+                          uint32_t field_idx,
+                          std::vector<uint16_t>* type_indexes) {
+  const DexFile::FieldId& field_id = dex_file.GetFieldId(field_idx);
+  type_indexes->push_back(field_id.class_idx_);
+  type_indexes->push_back(field_id.type_idx_);
+}
+
+static void AddMethodTypes(const DexFile& dex_file,
+                           uint32_t method_idx,
+                           std::vector<uint16_t>* type_indexes) {
+  const DexFile::MethodId& method_id = dex_file.GetMethodId(method_idx);
+  type_indexes->push_back(method_id.class_idx_);
+  AddProtoTypes(dex_file, method_id.proto_idx_, type_indexes);
+}
+
+static void AddInstructionArgumentTypes(const DexFile& dex_file,
+                                        int verify_type,
+                                        uint32_t index,
+                                        std::vector<uint16_t>* type_indexes) {
+  switch (verify_type) {
+    case Instruction::kVerifyRegBField:
+    case Instruction::kVerifyRegCField:
+      AddFieldTypes(dex_file, index, type_indexes);
+      break;
+    case Instruction::kVerifyRegBMethod:
+      AddMethodTypes(dex_file, index, type_indexes);
+      break;
+    case Instruction::kVerifyRegBNewInstance:
+    case Instruction::kVerifyRegBType:
+    case Instruction::kVerifyRegCNewArray:
+    case Instruction::kVerifyRegCType:
+      type_indexes->push_back(index);
+      break;
+    default:
+      break;
+  }
+}
+
+void CollectCodeItemReferencedTypes(const DexFile& dex_file,
+                                    const DexFile::CodeItem& code_item,
+                                    std::vector<uint16_t>* type_indexes) {
+  for (uint32_t dex_pc = 0; dex_pc < code_item.insns_size_in_code_units_;) {
+    const Instruction* inst = Instruction::At(code_item.insns_ + dex_pc);
+    AddInstructionArgumentTypes(dex_file, inst->GetVerifyTypeArgumentB(),
+                                inst->HasVRegB() ? inst->VRegB() : 0u, type_indexes);
+    AddInstructionArgumentTypes(dex_file, inst->GetVerifyTypeArgumentC(),
+                                inst->HasVRegC() ? inst->VRegC() : 0u, type_indexes);
+    dex_pc += inst->SizeInCodeUnits();
+  }
+  if (code_item.tries_size_ != 0) {
+    const uint8_t* handlers_ptr = DexFile::GetCatchHandlerData(code_item, 0);
+    uint32_t handlers_size = DecodeUnsignedLeb128(&handlers_ptr);
+    for (uint32_t i = 0; i < handlers_size; ++i) {
+      CatchHandlerIterator iterator(handlers_ptr);
+      for (; iterator.HasNext(); iterator.Next()) {
+        if (iterator.GetHandlerTypeIndex() != DexFile::kDexNoIndex16) {
+          type_indexes->push_back(iterator.GetHandlerTypeIndex());
+        }
+      }
+      handlers_ptr = iterator.EndDataPointer();
+    }
+  }
+}
+
+void CollectReferencedTypes(const DexFile& dex_file,
+                            const DexFile::ClassDef& class_def,
+                            std::vector<uint16_t>* type_indexes) {
+  if (class_def.superclass_idx_ != DexFile::kDexNoIndex16) {
+    type_indexes->push_back(class_def.superclass_idx_);
+  }
+  const DexFile::TypeList* interfaces = dex_file.GetInterfacesList(class_def);
+  if (interfaces != nullptr) {
+    for (uint32_t i = 0; i < interfaces->Size(); ++i) {
+      type_indexes->push_back(interfaces->GetTypeItem(i).type_idx_);
+    }
+  }
+  const uint8_t* class_data = dex_file.GetClassData(class_def);
+  if (class_data == nullptr) {
+    return;
+  }
+  for (ClassDataItemIterator it(dex_file, class_data); it.HasNext(); it.Next()) {
+    if (!IsAtMethod(it)) {
+      AddFieldTypes(dex_file, it.GetMemberIndex(), type_indexes);
+      continue;
+    }
+    AddMethodTypes(dex_file, it.GetMemberIndex(), type_indexes);
+    const DexFile::CodeItem* code_item = it.GetMethodCodeItem();
+    if (code_item != nullptr) {
+      CollectCodeItemReferencedTypes(dex_file, *code_item, type_indexes);
+    }
+  }
+}
+
+const DexFile::ClassDef* FindClassDefOfType(const std::vector<const DexFile*>& dex_files,
+                                            const DexFile& dex_file,
+                                            uint16_t type_idx,
+                                            const DexFile** class_def_dex_file) {
+  const DexFile::ClassDef* class_def = dex_file.FindClassDef(type_idx);
+  if (class_def != nullptr) {
+    *class_def_dex_file = &dex_file;
+    return class_def;
+  }
+  const char* descriptor = dex_file.StringByTypeIdx(type_idx);
+  while (*descriptor == '[') {
+    ++descriptor;
+  }
+  size_t hash = ComputeModifiedUtf8Hash(descriptor);
+  for (const DexFile* other_dex_file : dex_files) {
+    class_def = other_dex_file->FindClassDef(descriptor, hash);
+    if (class_def != nullptr) {
+      *class_def_dex_file = other_dex_file;
+      return class_def;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace art
@@ -0,0 +1,106 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_DRIVER_DEX_CONTENT_HASH_H_
+#define ART_COMPILER_DRIVER_DEX_CONTENT_HASH_H_
+
+#include <cstring>
+#include <vector>
+
+#include "dex_file.h"
+
+namespace art {
+
+// Hashes the parts of dex files which compiled code depends on, to find out whether code
+// compiled earlier can be reused. Two independent 64-bit hashes are computed: a FNV-1a hash,
+// and a multiplicative one which callers needing a lower collision rate can combine with it.
+class DexContentHasher {
+ public:
+  DexContentHasher() : hash_(kOffsetBasis), second_hash_(kSecondOffsetBasis) {}
+
+  void Update(const void* data, size_t size) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+      hash_ = (hash_ ^ bytes[i]) * kPrime;
+      second_hash_ = ((second_hash_ << 5) | (second_hash_ >> 59)) ^ bytes[i];
+      second_hash_ *= kSecondMultiplier;
+    }
+  }
+
+  template <typename T>
+  void Update(T value) {
+    Update(&value, sizeof(value));
+  }
+
+  // Hashes the terminating null character too, so that consecutive strings cannot be confused.
+  void UpdateString(const char* str) {
+    Update(str, strlen(str) + 1u);
+  }
+
+  uint64_t GetHash() const {
+    return hash_;
+  }
+
+  uint64_t GetSecondHash() const {
+    return second_hash_;
+  }
+
+ private:
+  static constexpr uint64_t kOffsetBasis = UINT64_C(0xcbf29ce484222325);
+  static constexpr uint64_t kPrime = UINT64_C(0x100000001b3);
+  static constexpr uint64_t kSecondOffsetBasis = UINT64_C(0x84222325cbf29ce4);
+  static constexpr uint64_t kSecondMultiplier = UINT64_C(0x9e3779b97f4a7c15);
+
+  uint64_t hash_;
+  uint64_t second_hash_;
+};
+
+// Hashes what the code of a method depends on in its code item: the bytecode, the registers
+// and the exception handlers, but not the debug info.
+void HashCodeItem(const DexFile::CodeItem& code_item, DexContentHasher* hasher);
+
+// Hashes what the code of a class depends on in its dex file. The file offsets are left out as
+// they change whenever anything before them in the dex file changes.
+void HashClassContent(const DexFile& dex_file,
+                      const DexFile::ClassDef& class_def,
+                      DexContentHasher* hasher);
+
+// Hashes the string, type, proto, field and method ids of a dex file, which give their meaning
+// to the indexes embedded in compiled code.
+void HashConstantPools(const DexFile& dex_file, DexContentHasher* hasher);
+
+// Collects the types the code of a method may depend on: the types, fields and methods
+// it references and the types of its exception handlers.
+void CollectCodeItemReferencedTypes(const DexFile& dex_file,
+                                    const DexFile::CodeItem& code_item,
+                                    std::vector<uint16_t>* type_indexes);
+
+// Collects the types the code of a class may depend on: its super types, the types of its
+// members, and the types, fields and methods its code references.
+void CollectReferencedTypes(const DexFile& dex_file,
+                            const DexFile::ClassDef& class_def,
+                            std::vector<uint16_t>* type_indexes);
+
+// Finds the class def of the element type of `type_idx` of `dex_file` in `dex_files`, first
+// looking in `dex_file` itself. Returns null if the class is not defined there.
+const DexFile::ClassDef* FindClassDefOfType(const std::vector<const DexFile*>& dex_files,
+                                            const DexFile& dex_file,
+                                            uint16_t type_idx,
+                                            const DexFile** class_def_dex_file);
+
+}  // namespace art
+
+#endif  // ART_COMPILER_DRIVER_DEX_CONTENT_HASH_H_
@@ -0,0 +1,331 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "incremental_compilation.h"
+
+#include <cstring>
+
+#include "arch/instruction_set_features.h"
+#include "art_method.h"
+#include "base/logging.h"
+#include "compiled_method.h"
+#include "dex_file-inl.h"
+#include "driver/dex_content_hash.h"
+#include "oat.h"
+#include "oat_file.h"
+#include "stack_map.h"
+#include "utf.h"
+#include "utils/array_ref.h"
+
+namespace art {
+
+static uint64_t ComputeClassContentHash(const DexFile& dex_file,
+                                        const DexFile::ClassDef& class_def) {
+  DexContentHasher hasher;
+  HashClassContent(dex_file, class_def, &hasher);
+  return hasher.GetHash();
+}
+
+static bool HaveSameTypeLists(const DexFile::TypeList* a, const DexFile::TypeList* b) {
+  uint32_t a_size = (a == nullptr) ? 0u : a->Size();
+  uint32_t b_size = (b == nullptr) ? 0u : b->Size();
+  if (a_size != b_size) {
+    return false;
+  }
+  for (uint32_t i = 0; i < a_size; ++i) {
+    if (a->GetTypeItem(i).type_idx_ != b->GetTypeItem(i).type_idx_) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Compiled code embeds string, type, field and method indexes: it can only be reused if
+// all of them still designate the same entities.
+static bool HaveSameConstantPools(const DexFile& previous, const DexFile& current) {
+  if (previous.NumStringIds() != current.NumStringIds() ||
+      previous.NumTypeIds() != current.NumTypeIds() ||
+      previous.NumProtoIds() != current.NumProtoIds() ||
+      previous.NumFieldIds() != current.NumFieldIds() ||
+      previous.NumMethodIds() != current.NumMethodIds()) {
+    return false;
+  }
+  for (uint32_t i = 0; i < current.NumStringIds(); ++i) {
+    uint32_t previous_length;
+    uint32_t current_length;
+    const char* previous_data = previous.StringDataAndUtf16LengthByIdx(i, &previous_length);
+    const char* current_data = current.StringDataAndUtf16LengthByIdx(i, &current_length);
+    if (previous_length != current_length || strcmp(previous_data, current_data) != 0) {
+      return false;
+    }
+  }
+  for (uint32_t i = 0; i < current.NumTypeIds(); ++i) {
+    if (previous.GetTypeId(i).descriptor_idx_ != current.GetTypeId(i).descriptor_idx_) {
+      return false;
+    }
+  }
+  for (uint32_t i = 0; i < current.NumProtoIds(); ++i) {
+    const DexFile::ProtoId& previous_proto = previous.GetProtoId(i);
+    const DexFile::ProtoId& current_proto = current.GetProtoId(i);
+    if (previous_proto.shorty_idx_ != current_proto.shorty_idx_ ||
+        previous_proto.return_type_idx_ != current_proto.return_type_idx_ ||
+        !HaveSameTypeLists(previous.GetProtoParameters(previous_proto),
+                           current.GetProtoParameters(current_proto))) {
+      return false;
+    }
+  }
+  // Field and method ids only hold indexes: compare them as a whole.
+  if (current.NumFieldIds() != 0u &&
+      memcmp(&previous.GetFieldId(0), &current.GetFieldId(0),
+             current.NumFieldIds() * sizeof(DexFile::FieldId)) != 0) {
+    return false;
+  }
+  if (current.NumMethodIds() != 0u &&
+      memcmp(&previous.GetMethodId(0), &current.GetMethodId(0),
+             current.NumMethodIds() * sizeof(DexFile::MethodId)) != 0) {
+    return false;
+  }
+  return true;
+}
+
+
+IncrementalCompilation::IncrementalCompilation(OatFile* oat_file, InstructionSet instruction_set)
+    : oat_file_(oat_file),
+      instruction_set_(instruction_set),
+      number_of_classes_(0u),
+      number_of_reusable_classes_(0u) {}
+
+IncrementalCompilation::~IncrementalCompilation() {}
+
+IncrementalCompilation* IncrementalCompilation::Create(
+    const std::string& oat_filename,
+    const std::string& fingerprint,
+    InstructionSet instruction_set,
+    const InstructionSetFeatures* instruction_set_features,
+    uint32_t image_file_location_oat_checksum,
+    uintptr_t image_file_location_oat_data_begin,
+    int32_t image_patch_delta,
+    const std::string& class_path,
+    const std::vector<const DexFile*>& dex_files,
+    std::string* error_msg) {
+  std::unique_ptr<OatFile> oat_file(OatFile::Open(oat_filename, oat_filename, nullptr, nullptr,
+                                                  false, nullptr, error_msg));
+  if (oat_file == nullptr) {
+    return nullptr;
+  }
+  const OatHeader& header = oat_file->GetOatHeader();
+  const char* previous_fingerprint =
+      header.GetStoreValueByKey(OatHeader::kIncrementalFingerprintKey);
+  if (previous_fingerprint == nullptr) {
+    *error_msg = oat_filename + " has linker patches or was compiled by an older dex2oat";
+    return nullptr;
+  }
+  if (fingerprint != previous_fingerprint) {
+    *error_msg = oat_filename + " was compiled with different options: " + previous_fingerprint;
+    return nullptr;
+  }
+  if (header.GetInstructionSet() != instruction_set ||
+      header.GetInstructionSetFeaturesBitmap() != instruction_set_features->AsBitmap()) {
+    *error_msg = oat_filename + " was compiled for a different instruction set";
+    return nullptr;
+  }
+  if (header.GetImageFileLocationOatChecksum() != image_file_location_oat_checksum ||
+      header.GetImageFileLocationOatDataBegin() != image_file_location_oat_data_begin ||
+      header.GetImagePatchDelta() != image_patch_delta) {
+    *error_msg = oat_filename + " was compiled against a different boot image";
+    return nullptr;
+  }
+  const char* previous_class_path = header.GetStoreValueByKey(OatHeader::kClassPathKey);
+  if (class_path != (previous_class_path == nullptr ? "" : previous_class_path)) {
+    *error_msg = oat_filename + " was compiled with a different class path";
+    return nullptr;
+  }
+
+  std::unique_ptr<IncrementalCompilation> incremental_compilation(
+      new IncrementalCompilation(oat_file.release(), instruction_set));
+  incremental_compilation->ComputeReusableClasses(dex_files);
+  if (incremental_compilation->GetNumberOfReusableClasses() == 0u) {
+    *error_msg = "No class can be reused from " + oat_filename;
+    return nullptr;
+  }
+  return incremental_compilation.release();
+}
+
+void IncrementalCompilation::ComputeReusableClasses(const std::vector<const DexFile*>& dex_files) {
+  // Classes of all the dex files are numbered consecutively, in the order of `dex_files`.
+  std::vector<size_t> first_class_numbers;
+  first_class_numbers.reserve(dex_files.size());
+  for (const DexFile* dex_file : dex_files) {
+    first_class_numbers.push_back(number_of_classes_);
+    number_of_classes_ += dex_file->NumClassDefs();
+  }
+
+  // Find the unchanged classes.
+  std::vector<bool> changed(number_of_classes_, true);
+  for (size_t i = 0; i != dex_files.size(); ++i) {
+    const DexFile& dex_file = *dex_files[i];
+    DexFileReuse reuse;
+    reuse.previous_oat_dex_file =
+        oat_file_->GetOatDexFile(dex_file.GetLocation().c_str(), nullptr, false);
+    reuse.previous_dex_file = nullptr;
+    reuse.reusable_classes.resize(dex_file.NumClassDefs(), false);
+    reuse.previous_class_def_indexes.resize(dex_file.NumClassDefs(), DexFile::kDexNoIndex16);
+    if (reuse.previous_oat_dex_file != nullptr) {
+      std::string error_msg;
+      std::unique_ptr<const DexFile> previous_dex_file =
+          reuse.previous_oat_dex_file->OpenDexFile(&error_msg);
+      if (previous_dex_file == nullptr) {
+        LOG(WARNING) << "Cannot reuse the code of " << dex_file.GetLocation() << ": " << error_msg;
+      } else if (!HaveSameConstantPools(*previous_dex_file, dex_file)) {
+        VLOG(compiler) << "Cannot reuse the code of " << dex_file.GetLocation()
+                       << ": its constant pools changed";
+      } else {
+        reuse.previous_dex_file = previous_dex_file.get();
+        previous_dex_files_.push_back(std::move(previous_dex_file));
+      }
+    }
+    if (reuse.previous_dex_file != nullptr) {
+      const DexFile& previous_dex_file = *reuse.previous_dex_file;
+      for (size_t class_def_index = 0; class_def_index != dex_file.NumClassDefs();
+           ++class_def_index) {
+        const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
+        // The type ids are the same, so is the type index of the class.
+        const DexFile::ClassDef* previous_class_def =
+            previous_dex_file.FindClassDef(class_def.class_idx_);
+        if (previous_class_def != nullptr &&
+            ComputeClassContentHash(previous_dex_file, *previous_class_def) ==
+                ComputeClassContentHash(dex_file, class_def)) {
+          changed[first_class_numbers[i] + class_def_index] = false;
+          reuse.previous_class_def_indexes[class_def_index] =
+              previous_dex_file.GetIndexForClassDef(*previous_class_def);
+        }
+      }
+    }
+    dex_files_.Put(&dex_file, reuse);
+  }
+
+  // Find the classes referenced by each class, to be able to go from a class to the classes
+  // which reference it. Types are looked up by descriptor in the other dex files.
+  std::vector<std::vector<size_t>> referencing_classes(number_of_classes_);
+  std::vector<uint16_t> type_indexes;
+  for (size_t i = 0; i != dex_files.size(); ++i) {
+    const DexFile& dex_file = *dex_files[i];
+    std::vector<size_t> class_number_of_type(dex_file.NumTypeIds(), number_of_classes_);
+    for (size_t type_idx = 0; type_idx != dex_file.NumTypeIds(); ++type_idx) {
+      const char* descriptor = dex_file.StringByTypeIdx(type_idx);
+      while (*descriptor == '[') {
+        ++descriptor;
+      }
+      size_t hash = ComputeModifiedUtf8Hash(descriptor);
+      for (size_t j = 0; j != dex_files.size(); ++j) {
+        const DexFile::ClassDef* class_def = dex_files[j]->FindClassDef(descriptor, hash);
+        if (class_def != nullptr) {
+          class_number_of_type[type_idx] =
+              first_class_numbers[j] + dex_files[j]->GetIndexForClassDef(*class_def);
+          break;
+        }
+      }
+    }
+    for (size_t class_def_index = 0; class_def_index != dex_file.NumClassDefs();
+         ++class_def_index) {
+      size_t class_number = first_class_numbers[i] + class_def_index;
+      type_indexes.clear();
+      CollectReferencedTypes(dex_file, dex_file.GetClassDef(class_def_index), &type_indexes);
+      for (uint16_t type_idx : type_indexes) {
+        size_t referenced_class_number = class_number_of_type[type_idx];
+        if (referenced_class_number != number_of_classes_ &&
+            referenced_class_number != class_number) {
+          referencing_classes[referenced_class_number].push_back(class_number);
+        }
+      }
+    }
+  }
+
+  // Propagate the changes to the classes depending on the changed classes.
+  std::vector<size_t> worklist;
+  for (size_t class_number = 0; class_number != number_of_classes_; ++class_number) {
+    if (changed[class_number]) {
+      worklist.push_back(class_number);
+    }
+  }
+  while (!worklist.empty()) {
+    size_t class_number = worklist.back();
+    worklist.pop_back();
+    for (size_t referencing_class_number : referencing_classes[class_number]) {
+      if (!changed[referencing_class_number]) {
+        changed[referencing_class_number] = true;
+        worklist.push_back(referencing_class_number);
+      }
+    }
+  }
+
+  for (size_t i = 0; i != dex_files.size(); ++i) {
+    DexFileReuse& reuse = dex_files_.find(dex_files[i])->second;
+    for (size_t class_def_index = 0; class_def_index != dex_files[i]->NumClassDefs();
+         ++class_def_index) {
+      if (!changed[first_class_numbers[i] + class_def_index]) {
+        reuse.reusable_classes[class_def_index] = true;
+        ++number_of_reusable_classes_;
+      }
+    }
+  }
+  VLOG(compiler) << "Reusing the code of " << number_of_reusable_classes_ << " out of "
+                 << number_of_classes_ << " classes from " << oat_file_->GetLocation();
+}
+
+bool IncrementalCompilation::IsClassReusable(const DexFile& dex_file,
+                                             uint16_t class_def_index) const {
+  auto it = dex_files_.find(&dex_file);
+  return it != dex_files_.end() && it->second.reusable_classes[class_def_index];
+}
+
+CompiledMethod* IncrementalCompilation::ReuseMethod(CompilerDriver* driver,
+                                                    const DexFile& dex_file,
+                                                    uint16_t class_def_index,
+                                                    size_t class_def_method_index) const {
+  DCHECK(IsClassReusable(dex_file, class_def_index));
+  const DexFileReuse& reuse = dex_files_.find(&dex_file)->second;
+  const OatFile::OatClass oat_class =
+      reuse.previous_oat_dex_file->GetOatClass(reuse.previous_class_def_indexes[class_def_index]);
+  const OatFile::OatMethod oat_method = oat_class.GetOatMethod(class_def_method_index);
+  // Only the optimizing compiler output is reused: its stack maps are the whole of the vmap
+  // table and there is no mapping table nor GC map to copy.
+  if (oat_method.GetCodeOffset() == 0u ||
+      oat_method.GetVmapTable() == nullptr ||
+      oat_method.GetMappingTable() != nullptr ||
+      oat_method.GetGcMap() != nullptr) {
+    return nullptr;
+  }
+  const uint8_t* code = reinterpret_cast<const uint8_t*>(
+      ArtMethod::EntryPointToCodePointer(oat_method.GetQuickCode()));
+  CodeInfo code_info(oat_method.GetVmapTable());
+  DefaultSrcMap src_mapping_table;
+  return CompiledMethod::SwapAllocCompiledMethod(
+      driver,
+      instruction_set_,
+      ArrayRef<const uint8_t>(code, oat_method.GetQuickCodeSize()),
+      oat_method.GetFrameSizeInBytes(),
+      oat_method.GetCoreSpillMask(),
+      oat_method.GetFpSpillMask(),
+      &src_mapping_table,
+      ArrayRef<const uint8_t>(),  // mapping_table.
+      ArrayRef<const uint8_t>(oat_method.GetVmapTable(), code_info.GetOverallSize()),
+      ArrayRef<const uint8_t>(),  // native_gc_map.
+      ArrayRef<const uint8_t>(),  // cfi_info.
+      ArrayRef<const LinkerPatch>());
+}
+
+}  // namespace art
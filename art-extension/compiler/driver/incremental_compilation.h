@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_DRIVER_INCREMENTAL_COMPILATION_H_
+#define ART_COMPILER_DRIVER_INCREMENTAL_COMPILATION_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "arch/instruction_set.h"
+#include "base/macros.h"
+#include "safe_map.h"
+
+namespace art {
+
+class CompiledMethod;
+class CompilerDriver;
+class DexFile;
+class InstructionSetFeatures;
+class OatDexFile;
+class OatFile;
+
+// Reuses the code of the oat file produced by a previous compilation of the same dex files.
+//
+// The code of a method only depends on the dex file indexes it embeds, on its own class and
+// on the classes it references (fields layout, inlined methods, ...). A class is therefore
+// reusable when its content is unchanged since the previous compilation, the constant pools
+// (string, type, proto, field and method ids) of its dex file are identical, and none of the
+// classes it references, directly or not, changed. The previous code is only trusted if it was
+// compiled with the same options, against the same boot image and without any linker patch,
+// which is recorded in the oat header under OatHeader::kIncrementalFingerprintKey.
+class IncrementalCompilation {
+ public:
+  // Opens the oat file `oat_filename` and computes the classes of `dex_files` whose code can be
+  // copied from it. Returns null and sets `error_msg` if none of its code can be reused.
+  static IncrementalCompilation* Create(const std::string& oat_filename,
+                                        const std::string& fingerprint,
+                                        InstructionSet instruction_set,
+                                        const InstructionSetFeatures* instruction_set_features,
+                                        uint32_t image_file_location_oat_checksum,
+                                        uintptr_t image_file_location_oat_data_begin,
+                                        int32_t image_patch_delta,
+                                        const std::string& class_path,
+                                        const std::vector<const DexFile*>& dex_files,
+                                        std::string* error_msg);
+
+  ~IncrementalCompilation();
+
+  bool IsClassReusable(const DexFile& dex_file, uint16_t class_def_index) const;
+
+  // Returns a copy of the code the previous oat file has for the method at position
+  // `class_def_method_index` in the class data of a reusable class, or null if it has none
+  // or the code was not produced by the optimizing compiler.
+  CompiledMethod* ReuseMethod(CompilerDriver* driver,
+                              const DexFile& dex_file,
+                              uint16_t class_def_index,
+                              size_t class_def_method_index) const;
+
+  size_t GetNumberOfClasses() const {
+    return number_of_classes_;
+  }
+
+  size_t GetNumberOfReusableClasses() const {
+    return number_of_reusable_classes_;
+  }
+
+ private:
+  // What is known of the previous compilation of one of the dex files being compiled.
+  struct DexFileReuse {
+    const OatDexFile* previous_oat_dex_file;
+    const DexFile* previous_dex_file;
+    // Indexed by class def index in the current dex file.
+    std::vector<bool> reusable_classes;
+    std::vector<uint16_t> previous_class_def_indexes;
+  };
+
+  IncrementalCompilation(OatFile* oat_file, InstructionSet instruction_set);
+
+  // Computes the classes of `dex_files` which are unchanged, then removes from them the classes
+  // depending on a changed class.
+  void ComputeReusableClasses(const std::vector<const DexFile*>& dex_files);
+
+  const std::unique_ptr<OatFile> oat_file_;
+  const InstructionSet instruction_set_;
+  std::vector<std::unique_ptr<const DexFile>> previous_dex_files_;
+  SafeMap<const DexFile*, DexFileReuse> dex_files_;
+  size_t number_of_classes_;
+  size_t number_of_reusable_classes_;
+
+  DISALLOW_COPY_AND_ASSIGN(IncrementalCompilation);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_DRIVER_INCREMENTAL_COMPILATION_H_
@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "driver/incremental_compilation.h"
+
+#include <memory>
+#include <vector>
+
+#include "arch/instruction_set_features.h"
+#include "base/timing_logger.h"
+#include "common_compiler_test.h"
+#include "compiled_method.h"
+#include "compiler.h"
+#include "dex_file-inl.h"
+#include "driver/compiler_driver.h"
+#include "method_reference.h"
+#include "oat.h"
+#include "oat_writer.h"
+#include "safe_map.h"
+#include "scoped_thread_state_change.h"
+#include "utils.h"
+
+namespace art {
+
+static const char kFingerprint[] = "fingerprint";
+static constexpr uint32_t kImageChecksum = 42U;
+static constexpr uintptr_t kImageDataBegin = 4096U;
+static constexpr int32_t kImagePatchDelta = 0;
+
+class IncrementalCompilationTest : public CommonCompilerTest {
+ protected:
+  // Compiles IncrementalCompilation with the optimizing compiler, the only one whose code is
+  // reused, and writes the oat file the next compilations reuse.
+  void SetUp() OVERRIDE {
+    CommonCompilerTest::SetUp();
+    {
+      ScopedObjectAccess soa(Thread::Current());
+      class_loader_ = LoadDex("IncrementalCompilation");
+    }
+    ASSERT_NE(class_loader_, nullptr);
+    dex_files_ = GetDexFiles(class_loader_);
+    ASSERT_EQ(1u, dex_files_.size());
+    ResetCompilerDriver();
+    CompileAll();
+    // Reused code is copied as is: it must not need to be patched.
+    ASSERT_EQ(0u, compiler_driver_->GetLinkerPatchCount());
+
+    const DexFile& dex_file = *dex_files_[0];
+    for (size_t class_def_index = 0; class_def_index != dex_file.NumClassDefs();
+         ++class_def_index) {
+      const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
+      ClassDataItemIterator it(dex_file, dex_file.GetClassData(class_def));
+      while (it.HasNextStaticField() || it.HasNextInstanceField()) {
+        it.Next();
+      }
+      for (; it.HasNext(); it.Next()) {
+        const CompiledMethod* compiled_method =
+            compiler_driver_->GetCompiledMethod(MethodReference(&dex_file, it.GetMemberIndex()));
+        if (compiled_method != nullptr) {
+          compiled_code_.Put(it.GetMemberIndex(),
+                             std::vector<uint8_t>(compiled_method->GetQuickCode()->begin(),
+                                                  compiled_method->GetQuickCode()->end()));
+        }
+      }
+    }
+    ASSERT_FALSE(compiled_code_.empty());
+
+    TimingLogger timings("IncrementalCompilationTest::SetUp", false, false);
+    SafeMap<std::string, std::string> key_value_store;
+    key_value_store.Put(OatHeader::kIncrementalFingerprintKey, kFingerprint);
+    OatWriter oat_writer(dex_files_,
+                         kImageChecksum,
+                         kImageDataBegin,
+                         kImagePatchDelta,
+                         compiler_driver_.get(),
+                         nullptr,
+                         &timings,
+                         &key_value_store);
+    ASSERT_TRUE(compiler_driver_->WriteElf(GetTestAndroidRoot(),
+                                           !kIsTargetBuild,
+                                           dex_files_,
+                                           &oat_writer,
+                                           oat_file_.GetFile()));
+  }
+
+  void ResetCompilerDriver() {
+    compiler_driver_.reset(new CompilerDriver(compiler_options_.get(),
+                                              verification_results_.get(),
+                                              method_inliner_map_.get(),
+                                              Compiler::kOptimizing, kRuntimeISA,
+                                              instruction_set_features_.get(),
+                                              false, nullptr, nullptr, nullptr,
+                                              2, true, true, "", timer_.get(), -1, ""));
+    compiler_driver_->SetSupportBootImageFixup(false);
+  }
+
+  void CompileAll() LOCKS_EXCLUDED(Locks::mutator_lock_) {
+    TimingLogger timings("IncrementalCompilationTest::CompileAll", false, false);
+    compiler_driver_->CompileAll(class_loader_, dex_files_, &timings);
+  }
+
+  IncrementalCompilation* Create(const char* fingerprint,
+                                 uint32_t image_checksum,
+                                 const std::string& class_path,
+                                 const std::vector<const DexFile*>& dex_files) {
+    error_msg_.clear();
+    return IncrementalCompilation::Create(oat_file_.GetFilename(),
+                                          fingerprint,
+                                          kRuntimeISA,
+                                          instruction_set_features_.get(),
+                                          image_checksum,
+                                          kImageDataBegin,
+                                          kImagePatchDelta,
+                                          class_path,
+                                          dex_files,
+                                          &error_msg_);
+  }
+
+  // Opens another version of IncrementalCompilation at the location of the compiled one, as
+  // if it had been rebuilt in place.
+  std::unique_ptr<const DexFile> OpenNewVersion(const char* name) {
+    std::string filename = GetTestDexFileName(name);
+    std::string error_msg;
+    std::vector<std::unique_ptr<const DexFile>> dex_files;
+    bool success = DexFile::Open(filename.c_str(), dex_files_[0]->GetLocation().c_str(),
+                                 &error_msg, &dex_files);
+    CHECK(success) << "Failed to open '" << filename << "': " << error_msg;
+    CHECK_EQ(1u, dex_files.size());
+    return std::move(dex_files[0]);
+  }
+
+  static uint16_t FindClassDefIndex(const DexFile& dex_file, const char* descriptor) {
+    const DexFile::ClassDef* class_def =
+        dex_file.FindClassDef(descriptor, ComputeModifiedUtf8Hash(descriptor));
+    CHECK(class_def != nullptr) << descriptor;
+    return dex_file.GetIndexForClassDef(*class_def);
+  }
+
+  // Checks that the previous code of every method of the class is found, and only that code.
+  void CheckReusedCode(IncrementalCompilation* incremental_compilation,
+                       const DexFile& dex_file,
+                       uint16_t class_def_index) {
+    const DexFile::ClassDef& class_def = dex_file.GetClassDef(class_def_index);
+    ClassDataItemIterator it(dex_file, dex_file.GetClassData(class_def));
+    while (it.HasNextStaticField() || it.HasNextInstanceField()) {
+      it.Next();
+    }
+    for (size_t class_def_method_index = 0u; it.HasNext(); ++class_def_method_index, it.Next()) {
+      CompiledMethod* reused_method = incremental_compilation->ReuseMethod(
+          compiler_driver_.get(), dex_file, class_def_index, class_def_method_index);
+      auto code = compiled_code_.find(it.GetMemberIndex());
+      if (code == compiled_code_.end()) {
+        EXPECT_EQ(reused_method, nullptr) << PrettyMethod(it.GetMemberIndex(), dex_file);
+        continue;
+      }
+      ASSERT_NE(reused_method, nullptr) << PrettyMethod(it.GetMemberIndex(), dex_file);
+      EXPECT_EQ(code->second, std::vector<uint8_t>(reused_method->GetQuickCode()->begin(),
+                                                   reused_method->GetQuickCode()->end()))
+          << PrettyMethod(it.GetMemberIndex(), dex_file);
+      EXPECT_TRUE(reused_method->GetPatches().empty());
+      CompiledMethod::ReleaseSwapAllocatedCompiledMethod(compiler_driver_.get(), reused_method);
+    }
+  }
+
+  ScratchFile oat_file_;
+  jobject class_loader_;
+  std::vector<const DexFile*> dex_files_;
+  // The code of the first compilation, by method index.
+  SafeMap<uint32_t, std::vector<uint8_t>> compiled_code_;
+  std::string error_msg_;
+};
+
+TEST_F(IncrementalCompilationTest, ReusesUnchangedClasses) {
+  std::unique_ptr<IncrementalCompilation> incremental_compilation(
+      Create(kFingerprint, kImageChecksum, "", dex_files_));
+  ASSERT_NE(incremental_compilation, nullptr) << error_msg_;
+  const DexFile& dex_file = *dex_files_[0];
+  EXPECT_EQ(dex_file.NumClassDefs(), incremental_compilation->GetNumberOfClasses());
+  EXPECT_EQ(dex_file.NumClassDefs(), incremental_compilation->GetNumberOfReusableClasses());
+  for (size_t class_def_index = 0; class_def_index != dex_file.NumClassDefs();
+       ++class_def_index) {
+    EXPECT_TRUE(incremental_compilation->IsClassReusable(dex_file, class_def_index));
+    CheckReusedCode(incremental_compilation.get(), dex_file, class_def_index);
+  }
+
+  // Compiling again takes the code of every method from the previous oat file.
+  ResetCompilerDriver();
+  compiler_driver_->SetIncrementalCompilation(incremental_compilation.release());
+  CompileAll();
+  for (const auto& code : compiled_code_) {
+    const CompiledMethod* compiled_method =
+        compiler_driver_->GetCompiledMethod(MethodReference(&dex_file, code.first));
+    ASSERT_NE(compiled_method, nullptr) << PrettyMethod(code.first, dex_file);
+    EXPECT_EQ(code.second, std::vector<uint8_t>(compiled_method->GetQuickCode()->begin(),
+                                                compiled_method->GetQuickCode()->end()))
+        << PrettyMethod(code.first, dex_file);
+  }
+}
+
+TEST_F(IncrementalCompilationTest, RecompilesChangedClassAndDependents) {
+  // Only the value returned by Changed.get() differs: the constant pools are the same.
+  std::unique_ptr<const DexFile> modified_dex_file(
+      OpenNewVersion("IncrementalCompilationModified"));
+  const DexFile& dex_file = *modified_dex_file;
+  std::unique_ptr<IncrementalCompilation> incremental_compilation(
+      Create(kFingerprint, kImageChecksum, "", { &dex_file }));
+  ASSERT_NE(incremental_compilation, nullptr) << error_msg_;
+  EXPECT_EQ(4u, incremental_compilation->GetNumberOfClasses());
+  EXPECT_EQ(1u, incremental_compilation->GetNumberOfReusableClasses());
+
+  uint16_t unchanged = FindClassDefIndex(dex_file, "LUnchanged;");
+  EXPECT_TRUE(incremental_compilation->IsClassReusable(dex_file, unchanged));
+  CheckReusedCode(incremental_compilation.get(), dex_file, unchanged);
+  EXPECT_FALSE(incremental_compilation->IsClassReusable(
+      dex_file, FindClassDefIndex(dex_file, "LChanged;")));
+  // DependsOnChanged references Changed, and DependsOnDependent references DependsOnChanged.
+  EXPECT_FALSE(incremental_compilation->IsClassReusable(
+      dex_file, FindClassDefIndex(dex_file, "LDependsOnChanged;")));
+  EXPECT_FALSE(incremental_compilation->IsClassReusable(
+      dex_file, FindClassDefIndex(dex_file, "LDependsOnDependent;")));
+}
+
+TEST_F(IncrementalCompilationTest, ChangedConstantPoolDisablesReuse) {
+  // Changed.get() uses a new string, which shifts the indexes embedded in the code of all
+  // the classes of the dex file.
+  std::unique_ptr<const DexFile> modified_dex_file(
+      OpenNewVersion("IncrementalCompilationNewString"));
+  std::unique_ptr<IncrementalCompilation> incremental_compilation(
+      Create(kFingerprint, kImageChecksum, "", { modified_dex_file.get() }));
+  EXPECT_EQ(incremental_compilation, nullptr);
+  EXPECT_FALSE(error_msg_.empty());
+}
+
+TEST_F(IncrementalCompilationTest, ChangedFingerprintDisablesReuse) {
+  std::unique_ptr<IncrementalCompilation> incremental_compilation(
+      Create("other fingerprint", kImageChecksum, "", dex_files_));
+  EXPECT_EQ(incremental_compilation, nullptr);
+  EXPECT_FALSE(error_msg_.empty());
+}
+
+TEST_F(IncrementalCompilationTest, ChangedBootImageDisablesReuse) {
+  std::unique_ptr<IncrementalCompilation> incremental_compilation(
+      Create(kFingerprint, kImageChecksum + 1u, "", dex_files_));
+  EXPECT_EQ(incremental_compilation, nullptr);
+  EXPECT_FALSE(error_msg_.empty());
+}
+
+TEST_F(IncrementalCompilationTest, ChangedClassPathDisablesReuse) {
+  std::unique_ptr<IncrementalCompilation> incremental_compilation(
+      Create(kFingerprint, kImageChecksum, "other.jar*1234", dex_files_));
+  EXPECT_EQ(incremental_compilation, nullptr);
+  EXPECT_FALSE(error_msg_.empty());
+}
+
+}  // namespace art
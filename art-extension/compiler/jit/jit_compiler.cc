@@ -91,6 +91,9 @@ JitCompiler::JitCompiler() : total_time_(0) {
       nullptr,
       false));
   const InstructionSet instruction_set = kRuntimeISA;
+  // The optimizing backend uses the receiver types recorded by the interpreter to inline
+  // the monomorphic virtual calls.
+  Compiler::Kind compiler_kind = Compiler::kQuick;
   for (const StringPiece option : Runtime::Current()->GetCompilerOptions()) {
     VLOG(compiler) << "JIT compiler option " << option;
     std::string error_msg;
@@ -117,6 +120,16 @@ JitCompiler::JitCompiler() : total_time_(0) {
       if (instruction_set_features_ == nullptr) {
         LOG(WARNING) << "Error parsing " << option << " message=" << error_msg;
       }
+    } else if (option.starts_with("--compiler-backend=")) {
+      StringPiece backend_str = option.substr(strlen("--compiler-backend=")).data();
+      VLOG(compiler) << "JIT compiler backend " << backend_str;
+      if (backend_str == "Quick") {
+        compiler_kind = Compiler::kQuick;
+      } else if (backend_str == "Optimizing") {
+        compiler_kind = Compiler::kOptimizing;
+      } else {
+        LOG(WARNING) << "Unknown compiler backend " << option;
+      }
     }
   }
   if (instruction_set_features_ == nullptr) {
@@ -130,7 +143,7 @@ JitCompiler::JitCompiler() : total_time_(0) {
                                               CompilerCallbacks::CallbackMode::kCompileApp));
   compiler_driver_.reset(new CompilerDriver(
       compiler_options_.get(), verification_results_.get(), method_inliner_map_.get(),
-      Compiler::kQuick, instruction_set, instruction_set_features_.get(), false,
+      compiler_kind, instruction_set, instruction_set_features_.get(), false,
       nullptr, nullptr, nullptr, 1, false, true,
       std::string(), cumulative_logger_.get(), -1, std::string()));
   // Disable dedupe so we can remove compiled methods.
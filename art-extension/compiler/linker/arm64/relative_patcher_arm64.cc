@@ -72,10 +72,12 @@ uint32_t Arm64RelativePatcher::ReserveSpace(uint32_t offset,
 
   // Now that we have the actual offset where the code will be placed, locate the ADRP insns
   // that actually require the thunk.
+  // The code must be in memory, dex2oat does not stream it to a file when the thunks are needed.
+  CHECK(compiled_method->GetQuickCode() != nullptr) << PrettyMethod(method_ref.dex_method_index,
+                                                                    *method_ref.dex_file);
   uint32_t quick_code_offset = compiled_method->AlignCode(offset) + sizeof(OatQuickMethodHeader);
   ArrayRef<const uint8_t> code(*compiled_method->GetQuickCode());
   uint32_t thunk_offset = compiled_method->AlignCode(quick_code_offset + code.size());
-  DCHECK(compiled_method != nullptr);
   for (const LinkerPatch& patch : compiled_method->GetPatches()) {
     if (patch.Type() == kLinkerPatchDexCacheArray &&
         patch.LiteralOffset() == patch.PcInsnOffset()) {  // ADRP patch
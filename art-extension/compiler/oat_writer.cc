@@ -43,6 +43,7 @@
 #include "safe_map.h"
 #include "scoped_thread_state_change.h"
 #include "handle_scope-inl.h"
+#include "utils/code_stream.h"
 #include "verifier/method_verifier.h"
 
 namespace art {
@@ -373,9 +374,7 @@ class OatWriter::InitCodeMethodVisitor : public OatDexMethodVisitor {
       // Derived from CompiledMethod.
       uint32_t quick_code_offset = 0;
 
-      const SwapVector<uint8_t>* quick_code = compiled_method->GetQuickCode();
-      CHECK(quick_code != nullptr);
-      uint32_t code_size = quick_code->size() * sizeof(uint8_t);
+      uint32_t code_size = compiled_method->GetQuickCodeSize() * sizeof(uint8_t);
       CHECK_NE(code_size, 0U);
       uint32_t thumb_offset = compiled_method->CodeDelta();
 
@@ -504,6 +503,10 @@ class OatWriter::InitCodeMethodVisitor : public OatDexMethodVisitor {
       if (lhs->GetQuickCode() != rhs->GetQuickCode()) {
         return lhs->GetQuickCode() < rhs->GetQuickCode();
       }
+      // Streamed code is deduplicated by the code stream, so the offsets are compared instead.
+      if (lhs->GetStreamedCodeOffset() != rhs->GetStreamedCodeOffset()) {
+        return lhs->GetStreamedCodeOffset() < rhs->GetStreamedCodeOffset();
+      }
       // If the code is the same, all other fields are likely to be the same as well.
       if (UNLIKELY(lhs->GetMappingTable() != rhs->GetMappingTable())) {
         return lhs->GetMappingTable() < rhs->GetMappingTable();
@@ -688,12 +691,10 @@ class OatWriter::WriteCodeMethodVisitor : public OatDexMethodVisitor {
       size_t file_offset = file_offset_;
       OutputStream* out = out_;
 
-      const SwapVector<uint8_t>* quick_code = compiled_method->GetQuickCode();
-      if (quick_code != nullptr) {
+      uint32_t code_size = compiled_method->GetQuickCodeSize() * sizeof(uint8_t);
+      if (code_size != 0u) {
         // Need a wrapper if we create a copy for patching.
-        ArrayRef<const uint8_t> wrapped(*quick_code);
-        uint32_t code_size = quick_code->size() * sizeof(uint8_t);
-        CHECK_NE(code_size, 0U);
+        ArrayRef<const uint8_t> wrapped;
 
         // Deduplicate code arrays.
         const OatMethodOffsets& method_offsets = oat_class->method_offsets_[method_offsets_index_];
@@ -729,9 +730,22 @@ class OatWriter::WriteCodeMethodVisitor : public OatDexMethodVisitor {
           offset_ += sizeof(method_header);
           DCHECK_OFFSET_();
 
-          if (!compiled_method->GetPatches().empty()) {
-            patched_code_.assign(quick_code->begin(), quick_code->end());
+          if (compiled_method->IsCodeStreamed()) {
+            // Read the code back from the stream it was appended to when it was compiled.
+            if (!writer_->compiler_driver_->GetCodeStream()->Read(
+                    compiled_method->GetStreamedCodeOffset(), code_size, &patched_code_)) {
+              ReportReadFailure("streamed method code", it);
+              return false;
+            }
             wrapped = ArrayRef<const uint8_t>(patched_code_);
+          } else {
+            wrapped = ArrayRef<const uint8_t>(*compiled_method->GetQuickCode());
+          }
+          if (!compiled_method->GetPatches().empty()) {
+            if (!compiled_method->IsCodeStreamed()) {
+              patched_code_.assign(wrapped.begin(), wrapped.end());
+              wrapped = ArrayRef<const uint8_t>(patched_code_);
+            }
             for (const LinkerPatch& patch : compiled_method->GetPatches()) {
               if (patch.Type() == kLinkerPatchCallRelative) {
                 // NOTE: Relative calls across oat files are not supported.
@@ -788,6 +802,11 @@ class OatWriter::WriteCodeMethodVisitor : public OatDexMethodVisitor {
         << PrettyMethod(it.GetMemberIndex(), *dex_file_) << " to " << out_->GetLocation();
   }
 
+  void ReportReadFailure(const char* what, const ClassDataItemIterator& it) {
+    PLOG(ERROR) << "Failed to read " << what << " for "
+        << PrettyMethod(it.GetMemberIndex(), *dex_file_);
+  }
+
   ArtMethod* GetTargetMethod(const LinkerPatch& patch)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
     MethodReference ref = patch.TargetMethod();
@@ -240,6 +240,10 @@ class HGraphBuilder : public ValueObject {
   // Returns whether `type_index` points to the outer-most compiling method's class.
   bool IsOutermostCompilingClass(uint16_t type_index) const;
 
+  // Returns whether instances of `type_index` may be finalizable. Unresolved
+  // types are conservatively considered finalizable.
+  bool IsFinalizableType(uint16_t type_index) const;
+
   HInvokeStaticOrDirect::DispatchInfo ComputeDispatchInfo(bool is_string_init,
                                                           int32_t string_init_offset,
                                                           MethodReference target_method,
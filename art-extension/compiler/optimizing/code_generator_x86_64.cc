@@ -19,6 +19,7 @@
 
 #include "code_generator_x86_64.h"
 
+#include "arch/x86_64/instruction_set_features_x86_64.h"
 #include "art_method.h"
 #include "code_generator_utils.h"
 #include "compiled_method.h"
@@ -982,6 +983,195 @@ void InstructionCodeGeneratorX86_64::VisitX86SelectValue(HX86SelectValue* instr)
   __ cmov(opposite_cond, out, value_rhs, instr->GetType() == Primitive::kPrimLong);
 }
 
+static ScaleFactor PackedScaleFactor(Primitive::Type packed_type) {
+  switch (Primitive::ComponentSize(packed_type)) {
+    case 1:
+      return TIMES_1;
+    case 2:
+      return TIMES_2;
+    case 4:
+      return TIMES_4;
+    default:
+      LOG(FATAL) << "Unexpected packed type " << packed_type;
+      UNREACHABLE();
+  }
+}
+
+void LocationsBuilderX86_64::VisitX86PackedArrayGet(HX86PackedArrayGet* instruction) {
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kNoCall);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresFpuRegister());
+}
+
+void InstructionCodeGeneratorX86_64::VisitX86PackedArrayGet(HX86PackedArrayGet* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  CpuRegister obj = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister index = locations->InAt(1).AsRegister<CpuRegister>();
+  XmmRegister out = locations->Out().AsFpuRegister<XmmRegister>();
+  Primitive::Type packed_type = instruction->GetPackedType();
+  uint32_t data_offset =
+      mirror::Array::DataOffset(Primitive::ComponentSize(packed_type)).Uint32Value();
+  Address address(obj, index, PackedScaleFactor(packed_type), data_offset);
+
+  // The vectorizer gives no alignment guarantee, so use unaligned moves.
+  if (packed_type == Primitive::kPrimFloat) {
+    __ movups(out, address);
+  } else {
+    __ movdqu(out, address);
+  }
+}
+
+void LocationsBuilderX86_64::VisitX86PackedArraySet(HX86PackedArraySet* instruction) {
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kNoCall);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->SetInAt(2, Location::RequiresFpuRegister());
+}
+
+void InstructionCodeGeneratorX86_64::VisitX86PackedArraySet(HX86PackedArraySet* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  CpuRegister obj = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister index = locations->InAt(1).AsRegister<CpuRegister>();
+  XmmRegister value = locations->InAt(2).AsFpuRegister<XmmRegister>();
+  Primitive::Type packed_type = instruction->GetPackedType();
+  uint32_t data_offset =
+      mirror::Array::DataOffset(Primitive::ComponentSize(packed_type)).Uint32Value();
+  Address address(obj, index, PackedScaleFactor(packed_type), data_offset);
+
+  if (packed_type == Primitive::kPrimFloat) {
+    __ movups(address, value);
+  } else {
+    __ movdqu(address, value);
+  }
+}
+
+void LocationsBuilderX86_64::VisitX86PackedBinaryOperation(HX86PackedBinaryOperation* instruction) {
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kNoCall);
+  locations->SetInAt(0, Location::RequiresFpuRegister());
+  locations->SetInAt(1, Location::RequiresFpuRegister());
+  locations->SetOut(Location::SameAsFirstInput());
+}
+
+void InstructionCodeGeneratorX86_64::VisitX86PackedBinaryOperation(
+    HX86PackedBinaryOperation* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister dst = locations->InAt(0).AsFpuRegister<XmmRegister>();
+  XmmRegister src = locations->InAt(1).AsFpuRegister<XmmRegister>();
+  DCHECK_EQ(dst.AsFloatRegister(),
+            locations->Out().AsFpuRegister<XmmRegister>().AsFloatRegister());
+  Primitive::Type packed_type = instruction->GetPackedType();
+
+  switch (instruction->GetOperationKind()) {
+    case HX86PackedBinaryOperation::kAdd:
+      switch (packed_type) {
+        case Primitive::kPrimByte:
+          __ paddb(dst, src);
+          break;
+        case Primitive::kPrimShort:
+        case Primitive::kPrimChar:
+          __ paddw(dst, src);
+          break;
+        case Primitive::kPrimInt:
+          __ paddd(dst, src);
+          break;
+        case Primitive::kPrimFloat:
+          __ addps(dst, src);
+          break;
+        default:
+          LOG(FATAL) << "Unexpected packed add type " << packed_type;
+      }
+      break;
+    case HX86PackedBinaryOperation::kSub:
+      switch (packed_type) {
+        case Primitive::kPrimByte:
+          __ psubb(dst, src);
+          break;
+        case Primitive::kPrimShort:
+        case Primitive::kPrimChar:
+          __ psubw(dst, src);
+          break;
+        case Primitive::kPrimInt:
+          __ psubd(dst, src);
+          break;
+        case Primitive::kPrimFloat:
+          __ subps(dst, src);
+          break;
+        default:
+          LOG(FATAL) << "Unexpected packed sub type " << packed_type;
+      }
+      break;
+    case HX86PackedBinaryOperation::kMul:
+      switch (packed_type) {
+        case Primitive::kPrimShort:
+        case Primitive::kPrimChar:
+          __ pmullw(dst, src);
+          break;
+        case Primitive::kPrimInt:
+          DCHECK(codegen_->GetInstructionSetFeatures().HasSSE4_1());
+          __ pmulld(dst, src);
+          break;
+        case Primitive::kPrimFloat:
+          __ mulps(dst, src);
+          break;
+        default:
+          LOG(FATAL) << "Unexpected packed mul type " << packed_type;
+      }
+      break;
+    case HX86PackedBinaryOperation::kAnd:
+      __ pand(dst, src);
+      break;
+    case HX86PackedBinaryOperation::kOr:
+      __ por(dst, src);
+      break;
+    case HX86PackedBinaryOperation::kXor:
+      __ pxor(dst, src);
+      break;
+  }
+}
+
+void LocationsBuilderX86_64::VisitX86PackedReplicate(HX86PackedReplicate* instruction) {
+  LocationSummary* locations =
+      new (GetGraph()->GetArena()) LocationSummary(instruction, LocationSummary::kNoCall);
+  if (instruction->GetPackedType() == Primitive::kPrimFloat) {
+    locations->SetInAt(0, Location::RequiresFpuRegister());
+  } else {
+    locations->SetInAt(0, Location::RequiresRegister());
+  }
+  locations->SetOut(Location::RequiresFpuRegister());
+}
+
+void InstructionCodeGeneratorX86_64::VisitX86PackedReplicate(HX86PackedReplicate* instruction) {
+  LocationSummary* locations = instruction->GetLocations();
+  XmmRegister out = locations->Out().AsFpuRegister<XmmRegister>();
+  Primitive::Type packed_type = instruction->GetPackedType();
+
+  if (packed_type == Primitive::kPrimFloat) {
+    __ pshufd(out, locations->InAt(0).AsFpuRegister<XmmRegister>(), Immediate(0));
+    return;
+  }
+
+  // Widen the low element until it fills a doubleword, then broadcast the doubleword.
+  __ movd(out, locations->InAt(0).AsRegister<CpuRegister>(), false);
+  switch (packed_type) {
+    case Primitive::kPrimByte:
+      __ punpcklbw(out, out);
+      FALLTHROUGH_INTENDED;
+    case Primitive::kPrimShort:
+    case Primitive::kPrimChar:
+      __ punpcklwd(out, out);
+      FALLTHROUGH_INTENDED;
+    case Primitive::kPrimInt:
+      __ pshufd(out, out, Immediate(0));
+      break;
+    default:
+      LOG(FATAL) << "Unexpected packed replicate type " << packed_type;
+  }
+}
+
 void LocationsBuilderX86_64::VisitSwitch(HSwitch* switch_instr) {
   LocationSummary* locations =
       new (GetGraph()->GetArena()) LocationSummary(switch_instr, LocationSummary::kNoCall);
@@ -0,0 +1,399 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include "array_access_guards.h"
+#include "ext_utility.h"
+#include "graph_x86.h"
+#include "induction_variable.h"
+#include "optimization_x86.h"
+
+namespace art {
+
+/**
+ * @brief Get the array of an access, without its null check.
+ * @param array The array input of the access.
+ * @return The checked value, or the array itself if it is not checked.
+ */
+static HInstruction* GetArray(HInstruction* array) {
+  return array->IsNullCheck() ? array->InputAt(0) : array;
+}
+
+HArrayAccessGuards::HArrayAccessGuards(HGraph_X86* graph, HOptimization_X86* optim)
+    : graph_(graph),
+      optim_(optim),
+      parent_(nullptr),
+      dex_pc_(kNoDexPc),
+      current_(nullptr),
+      merge_(nullptr),
+      environment_(nullptr),
+      loop_header_(nullptr) {
+}
+
+bool HArrayAccessGuards::AddLoop(HLoopInformation_X86* loop) {
+  const HLoopBoundInformation& bound_info = loop->GetBoundInformation();
+  HInductionVariable* biv = bound_info.loop_biv_;
+  if (biv == nullptr ||
+      !bound_info.is_simple_count_up_ ||
+      bound_info.comparison_condition_ != kCondLT ||
+      !biv->IsInteger() ||
+      !biv->IsIncrementOne()) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim_, "Loop #" << loop->GetHeader()->GetBlockId()
+      << " does not count up by one");
+    return false;
+  }
+
+  HBasicBlock* header = loop->GetHeader();
+  HPhi* phi = biv->GetPhiInsn();
+  HInstruction* start = loop->PhiInput(phi, false);
+  if (phi->GetBlock() != header ||
+      phi->GetType() != Primitive::kPrimInt ||
+      !start->IsIntConstant() ||
+      start->AsIntConstant()->GetValue() < 0 ||
+      loop->GetBackEdges().Size() != 1u ||
+      loop->GetExitBlock() == nullptr) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim_, "Loop #" << header->GetBlockId()
+      << " does not start from a non negative constant");
+    return false;
+  }
+
+  // The header must only test the IV against the bound.
+  HInstruction* branch = header->GetLastInstruction();
+  HInstruction* condition = branch->IsIf() ? branch->InputAt(0) : nullptr;
+  HInstruction* end = bound_info.loop_bound_;
+  if (condition == nullptr ||
+      condition->GetBlock() != header ||
+      !condition->HasOnlyOneNonEnvironmentUse() ||
+      !((condition->InputAt(0) == phi && condition->InputAt(1) == end) ||
+        (condition->InputAt(0) == end && condition->InputAt(1) == phi)) ||
+      (header->GetSuccessors().Get(0) != loop->GetExitBlock() &&
+       header->GetSuccessors().Get(1) != loop->GetExitBlock())) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim_, "Loop #" << header->GetBlockId()
+      << " is not top tested");
+    return false;
+  }
+  for (HInstructionIterator it(header->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (!instruction->IsSuspendCheck() && instruction != condition && instruction != branch) {
+      PRINT_PASS_OSTREAM_MESSAGE(optim_, "Loop #" << header->GetBlockId()
+        << " has a header computing " << instruction->DebugName());
+      return false;
+    }
+  }
+
+  loops_.push_back(loop);
+  if (end == nullptr || end->GetType() != Primitive::kPrimInt || !IsDefinedBeforeLoops(end)) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim_, "Loop #" << header->GetBlockId()
+      << " has a bound defined in the loops");
+    loops_.pop_back();
+    return false;
+  }
+
+  IVRange range;
+  range.start = start->AsIntConstant()->GetValue();
+  range.end = end;
+  ivs_[phi] = range;
+  return true;
+}
+
+bool HArrayAccessGuards::IsDefinedBeforeLoops(HInstruction* instruction) const {
+  for (HLoopInformation_X86* loop : loops_) {
+    if (loop->Contains(*instruction->GetBlock())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+HPhi* HArrayAccessGuards::GetIndex(HInstruction* index) const {
+  if (index->IsBoundsCheck()) {
+    index = index->InputAt(0);
+  }
+  if (!index->IsPhi() || ivs_.find(index->AsPhi()) == ivs_.end()) {
+    return nullptr;
+  }
+  return index->AsPhi();
+}
+
+bool HArrayAccessGuards::IsRowLoad(HInstruction* instruction) const {
+  return instruction->IsArrayGet() &&
+         instruction->GetType() == Primitive::kPrimNot &&
+         IsDefinedBeforeLoops(GetArray(instruction->InputAt(0))) &&
+         GetIndex(instruction->InputAt(1)) != nullptr;
+}
+
+HPhi* HArrayAccessGuards::GetElementIndex(HInstruction* access) const {
+  DCHECK(access->IsArrayGet() || access->IsArraySet());
+  return GetIndex(access->InputAt(1));
+}
+
+HPhi* HArrayAccessGuards::GetRowIndex(HInstruction* access) const {
+  DCHECK(access->IsArrayGet() || access->IsArraySet());
+  HInstruction* array = GetArray(access->InputAt(0));
+  if (!IsRowLoad(array)) {
+    return nullptr;
+  }
+  return GetIndex(array->InputAt(1));
+}
+
+void HArrayAccessGuards::AddNonNull(HInstruction* value) {
+  if (std::find(non_null_.begin(), non_null_.end(), value) == non_null_.end()) {
+    non_null_.push_back(value);
+  }
+}
+
+void HArrayAccessGuards::AddLength(HInstruction* array, HPhi* index) {
+  AddNonNull(array);
+  std::pair<HInstruction*, HPhi*> length(array, index);
+  if (std::find(lengths_.begin(), lengths_.end(), length) == lengths_.end()) {
+    lengths_.push_back(length);
+  }
+}
+
+HArrayAccessGuards::RowGuard* HArrayAccessGuards::AddRows(HInstruction* row_load) {
+  DCHECK(IsRowLoad(row_load));
+  HInstruction* array = GetArray(row_load->InputAt(0));
+  HPhi* row_index = GetIndex(row_load->InputAt(1));
+
+  // Loading the rows in the guards requires the array to be long enough.
+  AddLength(array, row_index);
+  for (RowGuard& rows : rows_) {
+    if (rows.array == array && rows.row_index == row_index) {
+      return &rows;
+    }
+  }
+
+  RowGuard rows;
+  rows.array = array;
+  rows.row_index = row_index;
+  rows_.push_back(rows);
+  return &rows_.back();
+}
+
+bool HArrayAccessGuards::AddInstruction(HInstruction* instruction) {
+  if (instruction->IsGoto() || instruction->IsIf()) {
+    return true;
+  }
+
+  if (instruction->IsNullCheck()) {
+    HInstruction* value = instruction->InputAt(0);
+    if (IsDefinedBeforeLoops(value)) {
+      AddNonNull(value);
+      return true;
+    }
+    if (IsRowLoad(value)) {
+      AddRows(value);
+      return true;
+    }
+    return false;
+  }
+
+  if (instruction->IsBoundsCheck()) {
+    HPhi* index = GetIndex(instruction->InputAt(0));
+    HInstruction* length = instruction->InputAt(1);
+    if (index == nullptr || !length->IsArrayLength()) {
+      return false;
+    }
+    HInstruction* array = GetArray(length->InputAt(0));
+    if (IsDefinedBeforeLoops(array)) {
+      AddLength(array, index);
+      return true;
+    }
+    if (IsRowLoad(array)) {
+      RowGuard* rows = AddRows(array);
+      if (std::find(rows->element_indices.begin(), rows->element_indices.end(), index) ==
+          rows->element_indices.end()) {
+        rows->element_indices.push_back(index);
+      }
+      return true;
+    }
+    return false;
+  }
+
+  if (instruction->IsArraySet()) {
+    // Storing a reference requires a type check, which may throw.
+    if (instruction->AsArraySet()->GetComponentType() == Primitive::kPrimNot) {
+      return false;
+    }
+    accesses_.push_back(instruction);
+    return true;
+  }
+
+  if (instruction->IsArrayGet()) {
+    if (instruction->GetType() != Primitive::kPrimNot) {
+      accesses_.push_back(instruction);
+    }
+    return true;
+  }
+
+  if (instruction->IsInstanceFieldGet()) {
+    return !instruction->AsInstanceFieldGet()->IsVolatile();
+  }
+
+  if (instruction->IsStaticFieldGet()) {
+    return !instruction->AsStaticFieldGet()->IsVolatile();
+  }
+
+  // Any other instruction must neither throw nor write.
+  return !instruction->IsControlFlow() &&
+         !instruction->CanThrow() &&
+         !instruction->NeedsEnvironment() &&
+         !instruction->HasSideEffects();
+}
+
+HBasicBlock* HArrayAccessGuards::CreateBlock() {
+  HBasicBlock* block = graph_->CreateNewBasicBlock(dex_pc_);
+  if (parent_ != nullptr) {
+    parent_->AddToAll(block);
+  }
+  return block;
+}
+
+void HArrayAccessGuards::AddFailureTest(HInstruction* condition) {
+  ArenaAllocator* arena = graph_->GetArena();
+  HInstruction* last = current_->GetLastInstruction();
+  DCHECK(last->IsGoto());
+  current_->RemoveInstruction(last);
+  current_->AddInstruction(condition);
+  current_->AddInstruction(new (arena) HIf(condition));
+
+  // Each failure has its own block, so that the merge block is not reached
+  // through critical edges.
+  HBasicBlock* failure = CreateBlock();
+  failure->AddInstruction(new (arena) HGoto());
+  HBasicBlock* next = CreateBlock();
+  next->AddInstruction(new (arena) HGoto());
+  current_->ReplaceSuccessor(merge_, failure);
+  current_->AddSuccessor(next);
+  failure->AddSuccessor(merge_);
+  next->AddSuccessor(merge_);
+
+  failures_.push_back(failure);
+  current_ = next;
+}
+
+void HArrayAccessGuards::AddRowsLoop(const RowGuard& rows) {
+  ArenaAllocator* arena = graph_->GetArena();
+  const IVRange& range = ivs_.find(rows.row_index)->second;
+
+  // The header counts the rows up to the end of the IV indexing them.
+  HBasicBlock* header = graph_->CreateNewBasicBlock(dex_pc_);
+  for (HLoopInformation_X86* loop = parent_; loop != nullptr; loop = loop->GetParent()) {
+    static_cast<HLoopInformation*>(loop)->Add(header);
+  }
+  current_->ReplaceSuccessor(merge_, header);
+  HPhi* row_index = new (arena) HPhi(arena, kNoRegNumber, 0, Primitive::kPrimInt);
+  header->AddPhi(row_index);
+  HSuspendCheck* suspend_check = new (arena) HSuspendCheck(dex_pc_);
+  header->AddInstruction(suspend_check);
+  suspend_check->CopyEnvironmentFromWithLoopPhiAdjustment(environment_, loop_header_);
+  HInstruction* done = new (arena) HGreaterThanOrEqual(row_index, range.end);
+  header->AddInstruction(done);
+  header->AddInstruction(new (arena) HIf(done));
+
+  HBasicBlock* exit = CreateBlock();
+  exit->AddInstruction(new (arena) HGoto());
+  exit->AddSuccessor(merge_);
+  HBasicBlock* body = CreateBlock();
+  header->AddSuccessor(exit);
+  header->AddSuccessor(body);
+
+  // The loads of the rows cannot throw: the array has been checked before the loop.
+  HInstruction* row = new (arena) HArrayGet(rows.array, row_index, Primitive::kPrimNot);
+  body->AddInstruction(row);
+  body->AddInstruction(new (arena) HGoto());
+  body->AddSuccessor(merge_);
+  current_ = body;
+  AddFailureTest(new (arena) HEqual(row, graph_->GetNullConstant()));
+  if (!rows.element_indices.empty()) {
+    HInstruction* length = new (arena) HArrayLength(row);
+    current_->InsertInstructionBefore(length, current_->GetLastInstruction());
+    for (HPhi* element_index : rows.element_indices) {
+      const IVRange& element_range = ivs_.find(element_index)->second;
+      AddFailureTest(new (arena) HLessThan(length, element_range.end));
+    }
+  }
+
+  // The last test falls through to the back edge.
+  HInstruction* next_index =
+      new (arena) HAdd(Primitive::kPrimInt, row_index, graph_->GetIntConstant(1));
+  current_->InsertInstructionBefore(next_index, current_->GetLastInstruction());
+  current_->ReplaceSuccessor(merge_, header);
+  header->AddBackEdge(current_);
+  header->GetLoopInformation()->SetSuspendCheck(suspend_check);
+  row_index->AddInput(graph_->GetIntConstant(range.start));
+  row_index->AddInput(next_index);
+
+  headers_.push_back(header);
+  current_ = exit;
+}
+
+void HArrayAccessGuards::InsertGuards(HLoopInformation_X86* loop) {
+  DCHECK(NeedsGuards());
+  ArenaAllocator* arena = graph_->GetArena();
+  HBasicBlock* header = loop->GetHeader();
+  HBasicBlock* pre_header = loop->GetPreHeader();
+  HSuspendCheck* suspend_check = loop->GetSuspendCheck();
+  DCHECK(suspend_check != nullptr);
+  parent_ = loop->GetParent();
+  dex_pc_ = suspend_check->GetDexPc();
+  environment_ = suspend_check->GetEnvironment();
+  loop_header_ = header;
+
+  // The guards are evaluated between the pre-header and the header. Their failures
+  // branch to the merge block, which becomes the pre-header of the loop.
+  merge_ = CreateBlock();
+  merge_->InsertBetween(pre_header, header);
+  merge_->AddInstruction(new (arena) HGoto());
+  current_ = pre_header;
+
+  for (HInstruction* value : non_null_) {
+    AddFailureTest(new (arena) HEqual(value, graph_->GetNullConstant()));
+  }
+  for (const std::pair<HInstruction*, HPhi*>& length : lengths_) {
+    HInstruction* array_length = new (arena) HArrayLength(length.first);
+    current_->InsertInstructionBefore(array_length, current_->GetLastInstruction());
+    const IVRange& range = ivs_.find(length.second)->second;
+    AddFailureTest(new (arena) HLessThan(array_length, range.end));
+  }
+  for (const RowGuard& rows : rows_) {
+    AddRowsLoop(rows);
+  }
+
+  // Deoptimize if one of the guards failed. The environment is the one of the
+  // loop entry, as none of its iterations has run.
+  HPhi* failed = new (arena) HPhi(arena, kNoRegNumber, 0, Primitive::kPrimInt);
+  for (size_t idx = 0u; idx != merge_->GetPredecessors().Size(); idx++) {
+    HBasicBlock* predecessor = merge_->GetPredecessors().Get(idx);
+    bool is_failure =
+        std::find(failures_.begin(), failures_.end(), predecessor) != failures_.end();
+    failed->AddInput(graph_->GetIntConstant(is_failure ? 1 : 0));
+  }
+  merge_->AddPhi(failed);
+  HDeoptimize* deoptimize = new (arena) HDeoptimize(failed, dex_pc_);
+  merge_->InsertInstructionBefore(deoptimize, merge_->GetLastInstruction());
+  deoptimize->CopyEnvironmentFromWithLoopPhiAdjustment(environment_, header);
+
+  graph_->RebuildDomination();
+  for (HBasicBlock* row_header : headers_) {
+    bool is_natural = row_header->GetLoopInformation()->Populate();
+    DCHECK(is_natural);
+    UNUSED(is_natural);
+  }
+}
+
+}  // namespace art
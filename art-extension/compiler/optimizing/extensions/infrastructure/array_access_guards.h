@@ -0,0 +1,209 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_OPT_INFRASTRUCTURE_ARRAY_ACCESS_GUARDS_H_
+#define ART_OPT_INFRASTRUCTURE_ARRAY_ACCESS_GUARDS_H_
+
+#include <map>
+#include <vector>
+
+#include "nodes.h"
+
+namespace art {
+
+// Forward declarations.
+class HGraph_X86;
+class HLoopInformation_X86;
+class HOptimization_X86;
+
+/**
+ * @brief Collects the array accesses of loops that are about to be reordered, and
+ * proves that they cannot throw.
+ * @details Changing the order of the iterations of loops also changes the order of
+ * the exceptions they throw, while Java requires them to be precise. The loops must
+ * count up by one from a non negative constant to a bound defined before them, and
+ * the only instructions they may throw from are the null and bounds checks of:
+ * - a[iv], where a is defined before the loops.
+ * - a[iv1][iv2], where a is an array of arrays defined before the loops.
+ * - the accesses to the fields of an object defined before the loops.
+ * Guards evaluated before the loops check that none of these checks fails, and
+ * deoptimize otherwise: the interpreter then runs the loops in their original order.
+ * Proving that the rows of an array of arrays are not null and long enough takes a
+ * small loop over the rows, which is part of the guards.
+ */
+class HArrayAccessGuards {
+ public:
+  HArrayAccessGuards(HGraph_X86* graph, HOptimization_X86* optim);
+
+  /**
+   * @brief Add a loop whose instructions are checked, along with its basic IV.
+   * @details The loop must be top tested with a header only made of its phis, its
+   * suspend check and its exit test.
+   * @param loop The loop to add.
+   * @return false if the loop does not count up by one from a non negative constant
+   * to a loop invariant bound.
+   */
+  bool AddLoop(HLoopInformation_X86* loop);
+
+  /**
+   * @brief Check an instruction of the loops, and record the guards it needs.
+   * @param instruction The instruction to check.
+   * @return false if the instruction may throw an exception that cannot be guarded,
+   * or writes anything else than a primitive array element.
+   */
+  bool AddInstruction(HInstruction* instruction);
+
+  /**
+   * @brief Do some of the instructions need guards?
+   * @return true if InsertGuards must be called before reordering the loops.
+   */
+  bool NeedsGuards() const {
+    return !non_null_.empty() || !lengths_.empty() || !rows_.empty();
+  }
+
+  /**
+   * @brief Insert the guards in front of a loop, and deoptimize when they fail.
+   * @details The environment of the deoptimization is the one of the suspend check
+   * of the loop, which must exist. The loop hierarchy must be rebuilt by the caller
+   * afterwards, as the guards contain loops.
+   * @param loop The loop in front of which the guards are evaluated.
+   */
+  void InsertGuards(HLoopInformation_X86* loop);
+
+  /**
+   * @brief Get the primitive array elements read or written by the instructions.
+   * @return The array gets and sets added so far.
+   */
+  const std::vector<HInstruction*>& GetAccesses() const {
+    return accesses_;
+  }
+
+  /**
+   * @brief Get the basic IV indexing the element of an access.
+   * @param access An array get or set.
+   * @return The phi of the IV, or nullptr if the index is not the phi of an added loop.
+   */
+  HPhi* GetElementIndex(HInstruction* access) const;
+
+  /**
+   * @brief Get the basic IV indexing the row of an access to an array of arrays.
+   * @param access An array get or set.
+   * @return The phi of the IV, or nullptr if the access is not of the form a[iv1][iv2].
+   */
+  HPhi* GetRowIndex(HInstruction* access) const;
+
+  /**
+   * @brief Is an instruction defined before the added loops?
+   * @param instruction The instruction to check.
+   * @return true if no added loop contains the instruction.
+   */
+  bool IsDefinedBeforeLoops(HInstruction* instruction) const;
+
+ private:
+  // The values of a basic IV: it counts up by one from start, while it is less than end.
+  struct IVRange {
+    int32_t start;
+    HInstruction* end;
+  };
+
+  // The rows of an array of arrays indexed by a basic IV, which must not be null and
+  // must be at least as long as the end of the IVs indexing their elements.
+  struct RowGuard {
+    HInstruction* array;
+    HPhi* row_index;
+    std::vector<HPhi*> element_indices;
+  };
+
+  /**
+   * @brief Get the basic IV an index is made of.
+   * @param index The index, possibly checked by a bounds check.
+   * @return The phi of the IV, or nullptr if the index is not the phi of an added loop.
+   */
+  HPhi* GetIndex(HInstruction* index) const;
+
+  /**
+   * @brief Is the instruction the load of a row of an array of arrays, a[iv]?
+   * @param instruction The instruction to check.
+   * @return true if the array is defined before the loops and indexed by a basic IV.
+   */
+  bool IsRowLoad(HInstruction* instruction) const;
+
+  /**
+   * @brief Record that a value must not be null.
+   * @param value The value defined before the loops.
+   */
+  void AddNonNull(HInstruction* value);
+
+  /**
+   * @brief Record that an array must be long enough for an IV to index it.
+   * @param array The array defined before the loops.
+   * @param index The phi of the IV.
+   */
+  void AddLength(HInstruction* array, HPhi* index);
+
+  /**
+   * @brief Record that the rows of an array of arrays must not be null.
+   * @param row_load The load of a row, as accepted by IsRowLoad.
+   * @return The guard of the rows.
+   */
+  RowGuard* AddRows(HInstruction* row_load);
+
+  /**
+   * @brief Create a block for the guards.
+   * @return The block, which is part of the loops containing the guards.
+   */
+  HBasicBlock* CreateBlock();
+
+  /**
+   * @brief Branch to a failure block when a condition holds.
+   * @details The condition is evaluated at the end of the current block, whose
+   * goto to the merge block is replaced by the branch. Evaluation then continues
+   * in a new current block.
+   * @param condition The condition, which is not in the graph yet.
+   */
+  void AddFailureTest(HInstruction* condition);
+
+  /**
+   * @brief Add the loop checking the rows of an array of arrays.
+   * @param rows The rows to check.
+   */
+  void AddRowsLoop(const RowGuard& rows);
+
+  HGraph_X86* graph_;
+  HOptimization_X86* optim_;
+  std::vector<HLoopInformation_X86*> loops_;
+  std::map<HPhi*, IVRange> ivs_;
+  std::vector<HInstruction*> accesses_;
+
+  // The guards, in the order they are evaluated.
+  std::vector<HInstruction*> non_null_;
+  std::vector<std::pair<HInstruction*, HPhi*>> lengths_;
+  std::vector<RowGuard> rows_;
+
+  // The state of InsertGuards.
+  HLoopInformation_X86* parent_;
+  uint32_t dex_pc_;
+  HBasicBlock* current_;
+  HBasicBlock* merge_;
+  std::vector<HBasicBlock*> failures_;
+  std::vector<HBasicBlock*> headers_;
+  HEnvironment* environment_;
+  HBasicBlock* loop_header_;
+};
+
+}  // namespace art
+
+#endif  // ART_OPT_INFRASTRUCTURE_ARRAY_ACCESS_GUARDS_H_
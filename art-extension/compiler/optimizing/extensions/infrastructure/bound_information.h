@@ -23,6 +23,7 @@ namespace art {
 // Forward declarations.
 class HConstant;
 class HInductionVariable;
+class HInstruction;
 
 /**
  * @brief This structure is used to keep bound information.
@@ -30,13 +31,14 @@ class HInductionVariable;
  * @details This is not guaranteed to be filled completely.
  * - loop_biv may be null.
  * - constant_bound is only valid if is_bound_constant is true.
+ * - loop_bound is the constant or loop invariant compared against the BIV.
  * - comparison_condition is only valid if is_simple_count_up or is_simple_count_down are true.
  * - num_iterations, biv_start_value, and biv_end_value are only valid if knowIterations is true.
  */
 struct HLoopBoundInformation {
   HLoopBoundInformation() :
     loop_biv_(nullptr), is_bound_constant_(false), constant_bound_(nullptr),
-    is_simple_count_up_(false), is_simple_count_down_(false),
+    loop_bound_(nullptr), is_simple_count_up_(false), is_simple_count_down_(false),
     comparison_condition_(0), num_iterations_(-1), biv_start_value_(0),
     biv_end_value_(0) {
     }
@@ -58,6 +60,13 @@ struct HLoopBoundInformation {
    */
   HConstant* constant_bound_;
 
+  /**
+   * @brief The instruction the BIV is compared against to exit the loop.
+   * @details It is either constant_bound or an instruction defined outside of the loop.
+   * In the latter case, the number of iterations is only known at runtime.
+   */
+  HInstruction* loop_bound_;
+
   /**
    * @brief Whether the loop is a simple count up loop.
    * @details The IV must increment in positive manner, the loop condition must use BIV
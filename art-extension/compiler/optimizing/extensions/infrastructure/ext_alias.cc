@@ -344,6 +344,10 @@ AliasCheck::AliasKind AliasCheck::Alias(HArrayGet* x_get, HInstruction* y) {
     case HInstruction::kArrayGet:
     case HInstruction::kArraySet:
       return Array_alias(x_get, y);
+    case HInstruction::kX86PackedArrayGet:
+    case HInstruction::kX86PackedArraySet:
+      // A packed access covers several elements.
+      return kMayAlias;
     case HInstruction::kInstanceFieldGet:
       return y->AsInstanceFieldGet()->IsVolatile() ? kMayAlias : kNoAlias;
     case HInstruction::kInstanceFieldSet:
@@ -371,6 +375,10 @@ AliasCheck::AliasKind AliasCheck::Alias(HArraySet* x_set, HInstruction* y) {
     case HInstruction::kArrayGet:
     case HInstruction::kArraySet:
       return Array_alias(x_set, y);
+    case HInstruction::kX86PackedArrayGet:
+    case HInstruction::kX86PackedArraySet:
+      // A packed access covers several elements.
+      return kMayAlias;
     case HInstruction::kInstanceFieldGet:
       return y->AsInstanceFieldGet()->IsVolatile() ? kMayAlias : kNoAlias;
     case HInstruction::kInstanceFieldSet:
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "ext_escape.h"
+
+namespace art {
+
+bool IsNonEscapingAllocation(HInstruction* insn) {
+  if (!insn->IsNewInstance() || insn->AsNewInstance()->IsFinalizable()) {
+    return false;
+  }
+
+  for (HUseIterator<HInstruction*> it(insn->GetUses()); !it.Done(); it.Advance()) {
+    HInstruction* user = it.Current()->GetUser();
+    if (user->IsInstanceFieldGet()) {
+      if (user->AsInstanceFieldGet()->IsVolatile()) {
+        return false;
+      }
+    } else if (user->IsInstanceFieldSet()) {
+      // Storing the object itself makes it escape.
+      if (user->AsInstanceFieldSet()->IsVolatile() || it.Current()->GetIndex() != 0) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool IsInitializingStore(HInstruction* allocation, HInstruction* insn) {
+  return insn->IsInstanceFieldSet() &&
+         insn->GetBlock() == allocation->GetBlock() &&
+         insn->InputAt(0) == allocation &&
+         insn->InputAt(1) != allocation &&
+         !insn->AsInstanceFieldSet()->IsVolatile();
+}
+
+HBasicBlock* FindEscapeBlock(HInstruction* allocation) {
+  HGraph* graph = allocation->GetBlock()->GetGraph();
+  HBasicBlock* escape_block = nullptr;
+
+  for (HUseIterator<HInstruction*> it(allocation->GetUses()); !it.Done(); it.Advance()) {
+    HInstruction* user = it.Current()->GetUser();
+    if (IsInitializingStore(allocation, user)) {
+      continue;
+    }
+
+    HBasicBlock* use_block = user->GetBlock();
+    if (user->IsPhi()) {
+      use_block = use_block->GetPredecessors().Get(it.Current()->GetIndex());
+    }
+
+    escape_block = (escape_block == nullptr)
+        ? use_block
+        : graph->FindCommonDominator(escape_block, use_block);
+  }
+
+  return escape_block;
+}
+
+}  // namespace art
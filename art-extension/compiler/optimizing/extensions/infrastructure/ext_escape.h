@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef COMPILER_OPTIMIZING_EXTENSIONS_INFRASTRUCTURE_EXT_ESCAPE_H
+#define COMPILER_OPTIMIZING_EXTENSIONS_INFRASTRUCTURE_EXT_ESCAPE_H
+
+#include "nodes.h"
+
+namespace art {
+
+  /**
+   * @brief Does the allocation stay in the method?
+   * @details The object is only used as the base of non volatile instance field
+   * accesses: it is never stored, compared, returned or passed to another method.
+   * This is run after the inliner, so that the calls to the inlined constructors
+   * no longer make the allocations escape. The objects of finalizable classes
+   * always escape, since their finalizer can look at them.
+   * The environment uses are not taken into account.
+   * @param insn The instruction to check.
+   * @return true if insn is an allocation that does not escape.
+   */
+  bool IsNonEscapingAllocation(HInstruction* insn);
+
+  /**
+   * @brief Is the instruction a store initializing a field of an allocation?
+   * @details The store is in the block of the allocation, and stores another value
+   * than the allocation to one of its non volatile fields.
+   * @param allocation The allocation.
+   * @param insn The user of the allocation to check.
+   * @return true if insn initializes a field of allocation.
+   */
+  bool IsInitializingStore(HInstruction* allocation, HInstruction* insn);
+
+  /**
+   * @brief Find the block where an allocation starts to be needed.
+   * @details This is the nearest common dominator of the blocks of the uses of the
+   * allocation that are not initializing stores. A phi uses the allocation at the
+   * end of the corresponding predecessor.
+   * @param allocation The allocation.
+   * @return The block, or nullptr if the allocation only has initializing stores.
+   */
+  HBasicBlock* FindEscapeBlock(HInstruction* allocation);
+
+}  // namespace art
+
+#endif  // COMPILER_OPTIMIZING_EXTENSIONS_INFRASTRUCTURE_EXT_ESCAPE_H
@@ -221,16 +221,18 @@ bool HLoopInformation_X86::ComputeBoundInformation() {
 
   bound_info_.loop_biv_ = iv_info;
 
-  // We have the IV, the other must be a constant.
-  HInstruction* cst = is_iv_second_use ? first_element : second_element;
-  HConstant* constant = cst->AsConstant();
-
-  if (constant == nullptr) {
+  // We have the IV, the other must be a constant or a loop invariant.
+  HInstruction* bound = is_iv_second_use ? first_element : second_element;
+  HConstant* constant = bound->AsConstant();
+
+  if (constant != nullptr) {
+    bound_info_.constant_bound_ = constant;
+    bound_info_.is_bound_constant_ = true;
+  } else if (Contains(*bound->GetBlock())) {
     return false;
   }
 
-  bound_info_.constant_bound_ = constant;
-  bound_info_.is_bound_constant_ = true;
+  bound_info_.loop_bound_ = bound;
 
   // If the IV is the second use, flip the opcode so we treat it as if it is first.
   if (is_iv_second_use) {
@@ -253,6 +255,11 @@ bool HLoopInformation_X86::ComputeBoundInformation() {
     bound_info_.comparison_condition_ = comparison_condition;
   }
 
+  // With an invariant bound, the number of iterations is only known at runtime.
+  if (!bound_info_.is_bound_constant_) {
+    return true;
+  }
+
   // If this is a simple count up loop and we know the upper bound, see if we can determine
   // the number of iterations.
   HPhi* phi = bound_info_.loop_biv_->GetPhiInsn();
@@ -1254,6 +1261,272 @@ bool HLoopInformation_X86::PeelHelperHead() {
   return true;
 }
 
+bool HLoopInformation_X86::IsVersionable(HOptimization_X86* optim) const {
+  if (!IsInner()) {
+    // The copy would contain the inner loops, whose loop information would
+    // need to be duplicated as well. Reject until this is needed.
+    PRINT_PASS_OSTREAM_MESSAGE(optim, "Versioning failed because the loop is not an inner loop.");
+    return false;
+  }
+
+  if (HasCatchHandler()) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim, "Versioning failed because the loop has a catch handler.");
+    return false;
+  }
+
+  if (test_suspend_ != nullptr || suspend_ != nullptr) {
+    // The split suspend check is tracked in the loop information and would not
+    // be known by the copy.
+    PRINT_PASS_OSTREAM_MESSAGE(optim,
+      "Versioning failed because the loop has a split suspend check.");
+    return false;
+  }
+
+  // Like for peeling, the values live after the loop are merged for a single exit.
+  // That exit must only be reached from the loop, so that the merge phis have one
+  // input per version.
+  HBasicBlock* exit_block = GetExitBlock();
+  if (exit_block == nullptr || exit_block->GetPredecessors().Size() != 1u) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim,
+      "Versioning failed because the loop does not have a single exit edge.");
+    return false;
+  }
+
+  // Walk through loop to check for any instructions that cannot be cloned.
+  HGraph_X86* graph = GRAPH_TO_GRAPH_X86(this->graph_);
+  constexpr bool enable_cloning = false;
+  HInstructionCloner cloner(graph, nullptr, enable_cloning);
+  for (HBlocksInLoopIterator it_loop(*this); !it_loop.Done(); it_loop.Advance()) {
+    cloner.VisitBasicBlock(it_loop.Current());
+
+    if (!cloner.AllOkay()) {
+      PRINT_PASS_OSTREAM_MESSAGE(optim,
+        "Versioning failed because found instruction which cannot be cloned: " <<
+            cloner.GetDebugNameForFailedClone());
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Used to insert a versioning guard, along with those of its inputs
+ * that are not in the graph yet.
+ * @param guard The instruction to insert.
+ * @param block The block that receives the instructions.
+ */
+static void InsertVersioningGuard(HInstruction* guard, HBasicBlock* block) {
+  for (size_t input_idx = 0u; input_idx != guard->InputCount(); input_idx++) {
+    HInstruction* input = guard->InputAt(input_idx);
+    if (input->GetBlock() == nullptr) {
+      InsertVersioningGuard(input, block);
+    }
+  }
+  block->AddInstruction(guard);
+}
+
+HLoopInformation_X86* HLoopInformation_X86::Version(const GrowableArray<HInstruction*>& guards) {
+  DCHECK_NE(guards.Size(), 0u);
+  SafeMap<HBasicBlock*, HBasicBlock*> old_to_new_bbs;
+  SafeMap<HBasicBlock*, HBasicBlock*> new_to_old_bbs;
+  SafeMap<HEnvironment*, HInstruction*> env_to_instr;
+  std::set<HBasicBlock*> loop_exits;
+
+  HGraph_X86* graph = GRAPH_TO_GRAPH_X86(this->graph_);
+  ArenaAllocator* arena = graph->GetArena();
+  HBasicBlock* header = GetHeader();
+  HBasicBlock* preheader = GetPreHeader();
+  HBasicBlock* exit_block = GetExitBlock();
+  HLoopInformation_X86* outer_loop_info = GetParent();
+  uint32_t dex_pc = header->GetDexPc();
+  DCHECK(exit_block != nullptr);
+  loop_exits.insert(exit_block);
+
+  // Make a copy of each block.
+  for (HBlocksInLoopReversePostOrderIterator it_loop(*this);
+       !it_loop.Done();
+       it_loop.Advance()) {
+    HBasicBlock* original = it_loop.Current();
+    HBasicBlock* copy = graph->CreateNewBasicBlock(original->GetDexPc());
+    DCHECK(copy != nullptr);
+    old_to_new_bbs.Put(original, copy);
+    new_to_old_bbs.Put(copy, original);
+  }
+  HBasicBlock* copy_header = old_to_new_bbs.Get(header);
+
+  // Each version gets its own pre-header. The one of the original loop takes
+  // the place of the old pre-header among the predecessors of the header.
+  HBasicBlock* orig_entry = graph->CreateNewBasicBlock(dex_pc);
+  orig_entry->InsertBetween(preheader, header);
+  orig_entry->AddInstruction(new (arena) HGoto());
+  HBasicBlock* copy_entry = graph->CreateNewBasicBlock(dex_pc);
+  copy_entry->AddInstruction(new (arena) HGoto());
+  copy_entry->AddSuccessor(copy_header);
+  new_to_old_bbs.Put(copy_entry, orig_entry);
+
+  GrowableArray<HBasicBlock*> new_blocks(arena, 2u * guards.Size() + 2u);
+  new_blocks.Add(orig_entry);
+  new_blocks.Add(copy_entry);
+
+  // Chain the guards: each of them falls through to the next one, and the last
+  // one to the original loop. A failed guard branches to the copy.
+  HInstruction* preheader_goto = preheader->GetLastInstruction();
+  DCHECK(preheader_goto->IsGoto());
+  preheader->RemoveInstruction(preheader_goto);
+  HBasicBlock* guard_block = preheader;
+  for (size_t idx = 0u; idx != guards.Size(); idx++) {
+    if (idx != 0u) {
+      HBasicBlock* next_block = graph->CreateNewBasicBlock(dex_pc);
+      next_block->InsertBetween(guard_block, orig_entry);
+      new_blocks.Add(next_block);
+      guard_block = next_block;
+    }
+
+    HInstruction* guard = guards.Get(idx);
+    if (guard->GetBlock() == nullptr) {
+      InsertVersioningGuard(guard, guard_block);
+    }
+    guard_block->AddInstruction(new (arena) HIf(guard));
+
+    // The copy has a single pre-header, so several guards need
+    // their own block to reach it without a critical edge.
+    HBasicBlock* fail_block = copy_entry;
+    if (guards.Size() > 1u) {
+      fail_block = graph->CreateNewBasicBlock(dex_pc);
+      fail_block->AddInstruction(new (arena) HGoto());
+      fail_block->AddSuccessor(copy_entry);
+      new_blocks.Add(fail_block);
+    }
+    guard_block->AddSuccessor(fail_block);
+  }
+
+  if (outer_loop_info != nullptr) {
+    for (size_t idx = 0u; idx != new_blocks.Size(); idx++) {
+      outer_loop_info->AddToAll(new_blocks.Get(idx));
+    }
+  }
+
+  // Link the copied blocks the same way as the original ones.
+  HBasicBlock* exiting_block = nullptr;
+  for (HBlocksInLoopIterator it_loop(*this); !it_loop.Done(); it_loop.Advance()) {
+    HBasicBlock* original = it_loop.Current();
+    HBasicBlock* copy = old_to_new_bbs.Get(original);
+    for (size_t idx = 0; idx < original->GetSuccessors().Size(); ++idx) {
+      HBasicBlock* orig_successor = original->GetSuccessors().Get(idx);
+      if (old_to_new_bbs.count(orig_successor) == 0) {
+        DCHECK_EQ(orig_successor, exit_block);
+        copy->AddSuccessor(orig_successor);
+        exiting_block = original;
+      } else {
+        copy->AddSuccessor(old_to_new_bbs.Get(orig_successor));
+      }
+    }
+
+    // The copy header gets its own loop information below.
+    if (outer_loop_info != nullptr && original != header) {
+      outer_loop_info->AddToAll(copy);
+    }
+  }
+
+  // We are creating two critical edges, so split them here. The exit block
+  // now has the original loop as first predecessor and the copy as second one.
+  DCHECK(exiting_block != nullptr);
+  graph->SplitCriticalEdgeAndUpdateLoopInformation(old_to_new_bbs.Get(exiting_block), exit_block);
+  graph->SplitCriticalEdgeAndUpdateLoopInformation(exiting_block, exit_block);
+
+  // Since the environment does not have mapping back to the instruction
+  // that contains it, we get that mapping now.
+  graph->FillEnvironmentToInstruction(&env_to_instr);
+
+  // Copy the instructions without adding them to any block yet.
+  HInstructionCloner cloner(graph, &env_to_instr);
+  for (HBlocksInLoopReversePostOrderIterator it_loop(*this);
+       !it_loop.Done();
+       it_loop.Advance()) {
+    cloner.VisitBasicBlock(it_loop.Current());
+  }
+  DCHECK(cloner.AllOkay());
+
+  // Now that instructions are copied, we must add them to their appropriate blocks.
+  for (HBlocksInLoopReversePostOrderIterator it_loop(*this);
+       !it_loop.Done();
+       it_loop.Advance()) {
+    HBasicBlock* original = it_loop.Current();
+    HBasicBlock* copy = old_to_new_bbs.Get(original);
+    for (HInstructionIterator it(original->GetPhis()); !it.Done(); it.Advance()) {
+      HInstruction* clone = cloner.GetClone(it.Current());
+      DCHECK(clone != nullptr && clone->IsPhi() && clone->GetBlock() == nullptr);
+      copy->AddPhi(clone->AsPhi());
+    }
+    for (HInstructionIterator it(original->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* clone = cloner.GetClone(it.Current());
+      if (clone != nullptr && clone->GetBlock() == nullptr) {
+        copy->AddInstruction(clone);
+      }
+    }
+  }
+
+  // The phi clones were created before the definitions coming through the back
+  // edges had been cloned. Also, the predecessors of a copy are not necessarily
+  // in the same order as those of the original block. Rebuild their inputs.
+  for (HBlocksInLoopIterator it_loop(*this); !it_loop.Done(); it_loop.Advance()) {
+    HBasicBlock* original = it_loop.Current();
+    HBasicBlock* copy = old_to_new_bbs.Get(original);
+    for (HInstructionIterator it(original->GetPhis()); !it.Done(); it.Advance()) {
+      HPhi* phi = it.Current()->AsPhi();
+      HPhi* phi_clone = cloner.GetClone(phi)->AsPhi();
+      for (size_t idx = 0u; idx != copy->GetPredecessors().Size(); idx++) {
+        HBasicBlock* orig_predecessor = new_to_old_bbs.Get(copy->GetPredecessors().Get(idx));
+        HInstruction* input = phi->InputAt(original->GetPredecessorIndexOf(orig_predecessor));
+        HInstruction* input_clone = cloner.GetClone(input);
+        phi_clone->ReplaceInput(input_clone != nullptr ? input_clone : input, idx);
+      }
+    }
+  }
+
+  // Now add appropriate phi nodes after loop.
+  for (HBlocksInLoopReversePostOrderIterator it_loop(*this);
+       !it_loop.Done();
+       it_loop.Advance()) {
+    HBasicBlock* original = it_loop.Current();
+    for (HInstructionIterator it(original->GetPhis()); !it.Done(); it.Advance()) {
+      HInstruction* orig = it.Current();
+      AddExitPhisAfterPeel(graph, this, loop_exits, env_to_instr, orig, cloner.GetClone(orig));
+    }
+    for (HInstructionIterator it(original->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* orig = it.Current();
+      HInstruction* clone = cloner.GetClone(orig);
+      if (clone != nullptr) {
+        AddExitPhisAfterPeel(graph, this, loop_exits, env_to_instr, orig, clone);
+      }
+    }
+  }
+
+  // Finally, create the loop information of the copy.
+  for (size_t idx = 0u; idx != GetBackEdges().Size(); idx++) {
+    copy_header->AddBackEdge(old_to_new_bbs.Get(GetBackEdges().Get(idx)));
+  }
+  for (HLoopInformation_X86* current = outer_loop_info;
+       current != nullptr;
+       current = current->GetParent()) {
+    static_cast<HLoopInformation*>(current)->Add(copy_header);
+  }
+
+  graph->RebuildDomination();
+
+  HLoopInformation_X86* copy_loop = LOOPINFO_TO_LOOPINFO_X86(copy_header->GetLoopInformation());
+  bool is_natural = copy_loop->Populate();
+  DCHECK(is_natural);
+  UNUSED(is_natural);
+  HSuspendCheck* suspend_check = GetSuspendCheck();
+  if (suspend_check != nullptr) {
+    copy_loop->SetSuspendCheck(cloner.GetClone(suspend_check)->AsSuspendCheck());
+  }
+
+  return copy_loop;
+}
+
 bool HLoopInformation_X86::HasInvokes() const {
   for (HBlocksInLoopIterator it_loop(*this); !it_loop.Done(); it_loop.Advance()) {
     HBasicBlock* loop_block = it_loop.Current();
@@ -1414,6 +1687,43 @@ uint64_t HLoopInformation_X86::CountInstructionsInBody(bool skip_suspend_checks)
   return nb_instructions;
 }
 
+HInstruction* HLoopInformation_X86::BuildReducedBound(int32_t distance) {
+  DCHECK_GT(distance, 0);
+  HInstruction* bound = bound_info_.loop_bound_;
+  DCHECK(bound != nullptr);
+  DCHECK_EQ(bound->GetType(), Primitive::kPrimInt);
+
+  HBasicBlock* pre_header = GetPreHeader();
+  HInstruction* cursor = pre_header->GetLastInstruction();
+  const int32_t min_value = std::numeric_limits<int32_t>::min();
+  const int32_t min_bound = min_value + distance;
+
+  if (bound->IsIntConstant()) {
+    // Fold the bound: the overflow guard is not needed.
+    int32_t value = bound->AsIntConstant()->GetValue();
+    return graph_->GetIntConstant(value < min_bound ? min_value : value - distance);
+  }
+
+  ArenaAllocator* arena = graph_->GetArena();
+  HInstruction* reduced_bound =
+      new (arena) HSub(Primitive::kPrimInt, bound, graph_->GetIntConstant(distance));
+  pre_header->InsertInstructionBefore(reduced_bound, cursor);
+
+  // An array length is never negative, so it cannot wrap around.
+  if (bound->IsArrayLength()) {
+    return reduced_bound;
+  }
+
+  // bound >= MIN + distance ? bound - distance : MIN.
+  HInstruction* select = new (arena) HX86SelectValue(kCondGE,
+                                                     reduced_bound,
+                                                     graph_->GetIntConstant(min_value),
+                                                     bound,
+                                                     graph_->GetIntConstant(min_bound));
+  pre_header->InsertInstructionBefore(select, cursor);
+  return select;
+}
+
 HInstruction* HLoopInformation_X86::PhiInput(HPhi* phi, bool inside_of_loop) {
   DCHECK(phi != nullptr);
   DCHECK_EQ(phi->InputCount(), 2u);
@@ -421,6 +421,28 @@ class HLoopInformation_X86 : public HLoopInformation {
     return !peeled_blocks_.IsEmpty();
   }
 
+  /**
+   * @brief Used to check if loop can be versioned.
+   * @param optim Useful during development of using the interface to understand
+   * why versioning failed.
+   * @return Returns true if loop versioning will surely succeed and false otherwise.
+   */
+  bool IsVersionable(HOptimization_X86* optim) const;
+
+  /**
+   * @brief Duplicates the loop and selects one of the two versions at runtime.
+   * @details Each guard is evaluated in its own block in front of the loop, in order.
+   * The original loop runs when all guards hold, and the copy runs as soon as one
+   * of them fails. A guard and its inputs are either defined before the loop or not
+   * yet in the graph, in which case they are inserted along with the guard. Values
+   * defined in the loop and used after it are merged by phis in the exit block.
+   * The loop hierarchy must be rebuilt by the caller afterwards.
+   * @param guards The boolean conditions selecting the original loop.
+   * @return The loop information of the copy.
+   * @details This method should be called when caller knows the loop is versionable.
+   */
+  HLoopInformation_X86* Version(const GrowableArray<HInstruction*>& guards);
+
   /**
    * @brief Used to check if loop has a catch handler block.
    * @return Returns true if loop has catch block.
@@ -490,6 +512,17 @@ class HLoopInformation_X86 : public HLoopInformation {
    */
   uint64_t CountInstructionsInBody(bool skip_suspend_checks = true) const;
 
+  /**
+   * @brief Insert in the pre-header the computation of the loop bound minus a distance.
+   * @details Transformations running several iterations at once stay in their loop
+   * while iv + distance < bound, that is iv < bound - distance. The result saturates
+   * to the minimum int value, so the subtraction cannot wrap around.
+   * The loop must have a pre-header and an int loop bound.
+   * @param distance The positive distance to remove from the bound.
+   * @return the instruction holding the reduced bound.
+   */
+  HInstruction* BuildReducedBound(int32_t distance);
+
   /**
    * @return The graph attached to the loop information instance.
    */
@@ -14,9 +14,12 @@
  * limitations under the License.
  */
 
+#include <vector>
+
 #include "cloning.h"
 #include "ext_utility.h"
 #include "graph_x86.h"
+#include "induction_variable.h"
 #include "loop_unrolling.h"
 #include "optimization_x86.h"
 
@@ -488,4 +491,235 @@ bool HLoopUnrolling::Gate(uint64_t max_unrolled_instructions) const {
 
   return true;
 }
+
+bool HLoopUnrolling::PartialUnroll(uint64_t unrolling_factor) {
+  HBasicBlock* header = loop_->GetHeader();
+  HBasicBlock* body = loop_->GetBackEdges().Get(0);
+  HBasicBlock* pre_header = loop_->GetPreHeader();
+  ArenaAllocator* arena = graph_->GetArena();
+  uint32_t dex_pc = header->GetDexPc();
+  HInductionVariable* biv = loop_->GetBoundInformation().loop_biv_;
+
+  // The unrolled loop runs while iv + (unrolling_factor - 1) * increment < bound.
+  int32_t distance = static_cast<int32_t>((unrolling_factor - 1) * biv->GetIncrement());
+  HInstruction* unrolled_bound = loop_->BuildReducedBound(distance);
+
+  // The new control flow is: pre_header -> unrolled_header -> unrolled_exit -> header,
+  // with the unrolled_body going back to the unrolled_header.
+  HBasicBlock* unrolled_header = graph_->CreateNewBasicBlock(dex_pc);
+  HBasicBlock* unrolled_body = graph_->CreateNewBasicBlock(dex_pc);
+  HBasicBlock* unrolled_exit = graph_->CreateNewBasicBlock(dex_pc);
+  unrolled_exit->InsertBetween(pre_header, header);
+  unrolled_header->InsertBetween(pre_header, unrolled_exit);
+  unrolled_header->AddSuccessor(unrolled_body);
+  unrolled_body->AddSuccessor(unrolled_header);
+  unrolled_exit->AddInstruction(new (arena) HGoto());
+
+  // Each loop header phi has a counterpart in the unrolled loop, starting from the same value.
+  std::vector<std::pair<HPhi*, HPhi*>> phis;
+  for (HInstructionIterator it(header->GetPhis()); !it.Done(); it.Advance()) {
+    HPhi* phi = it.Current()->AsPhi();
+    HPhi* unrolled_phi = new (arena) HPhi(arena, phi->GetRegNumber(), 0, phi->GetType());
+    unrolled_header->AddPhi(unrolled_phi);
+    unrolled_phi->AddInput(loop_->PhiInput(phi, false));
+    cloner_.AddOrUpdateCloneManually(phi, unrolled_phi);
+    phis.push_back(std::make_pair(phi, unrolled_phi));
+  }
+
+  // Copy the suspend check so that the unrolled loop can still be interrupted.
+  HSuspendCheck* unrolled_suspend_check = nullptr;
+  for (HInstructionIterator it(header->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* insn = it.Current();
+    if (insn->IsSuspendCheck()) {
+      insn->Accept(&cloner_);
+      unrolled_suspend_check = cloner_.GetClone(insn)->AsSuspendCheck();
+      unrolled_header->AddInstruction(unrolled_suspend_check);
+    }
+  }
+
+  HInstruction* condition =
+      new (arena) HGreaterThanOrEqual(cloner_.GetClone(biv->GetPhiInsn()), unrolled_bound);
+  unrolled_header->AddInstruction(condition);
+  unrolled_header->AddInstruction(new (arena) HIf(condition));
+
+  // Copy the body, each copy using the values computed by the previous one.
+  for (uint64_t i = 0; i < unrolling_factor; i++) {
+    if (i != 0 && !UpdateLoopPhiNodesMap()) {
+      PRINT_PASS_OSTREAM_MESSAGE(optim_, "Could not update phi nodes map.");
+      return false;
+    }
+
+    for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* insn = it.Current();
+      if (insn->IsGoto()) {
+        continue;
+      }
+      insn->Accept(&cloner_);
+      HInstruction* to_add = cloner_.GetClone(insn);
+      if (to_add != nullptr && to_add->GetBlock() == nullptr) {
+        // We do it only if it is a clone not if it already exists.
+        unrolled_body->AddInstruction(to_add);
+      }
+    }
+  }
+  DCHECK(cloner_.AllOkay()) << "Could not copy the loop body successfully.";
+  unrolled_body->AddInstruction(new (arena) HGoto());
+
+  for (auto& phi_pair : phis) {
+    HPhi* phi = phi_pair.first;
+    HPhi* unrolled_phi = phi_pair.second;
+    HInstruction* in_loop_input = loop_->PhiInput(phi, true);
+    HInstruction* last_clone = cloner_.GetClone(in_loop_input);
+    unrolled_phi->AddInput(last_clone != nullptr ? last_clone : in_loop_input);
+
+    // The original loop is now the remainder loop: it starts where the unrolled loop ended.
+    phi->ReplaceInput(unrolled_phi, 0);
+  }
+
+  // Register the new blocks in the outer loops, then create the unrolled loop.
+  HLoopInformation_X86* parent = loop_->GetParent();
+  if (parent != nullptr) {
+    parent->AddToAll(unrolled_exit);
+    for (HLoopInformation_X86* current = parent;
+         current != nullptr;
+         current = current->GetParent()) {
+      static_cast<HLoopInformation*>(current)->Add(unrolled_header);
+      static_cast<HLoopInformation*>(current)->Add(unrolled_body);
+    }
+  }
+
+  unrolled_header->AddBackEdge(unrolled_body);
+  graph_->RebuildDomination();
+
+  HLoopInformation_X86* unrolled_loop =
+      LOOPINFO_TO_LOOPINFO_X86(unrolled_header->GetLoopInformation());
+  bool is_natural = unrolled_loop->Populate();
+  DCHECK(is_natural);
+  UNUSED(is_natural);
+  unrolled_loop->SetSuspendCheck(unrolled_suspend_check);
+
+  return true;
+}
+
+bool HLoopUnrolling::GatePartial(uint64_t unrolling_factor,
+                                 uint64_t max_unrolled_instructions) const {
+  if (loop_ == nullptr) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim_, "Loop is nullptr");
+    return false;
+  }
+
+  if (unrolling_factor < 2u) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim_, "Unrolling factor must be at least 2.");
+    return false;
+  }
+
+  if (loop_->IsBottomTested()) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim_, "Loop must be top tested.");
+    return false;
+  }
+
+  if (!loop_->HasOneExitEdge()) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim_, "Loop must have one exit edge.");
+    return false;
+  }
+
+  if (loop_->GetBackEdges().Size() != 1u || loop_->NumberOfBlocks() != 2) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim_, "Loop must be made of a header and a body.");
+    return false;
+  }
+
+  if (loop_->HasSuspend() || loop_->HasTestSuspend()) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim_, "Loop must not have split suspend checks.");
+    return false;
+  }
+
+  HBasicBlock* header = loop_->GetHeader();
+  HBasicBlock* body = loop_->GetBackEdges().Get(0);
+  if (body == header ||
+      loop_->GetPreHeader() == nullptr ||
+      !header->GetLastInstruction()->IsIf() ||
+      !body->GetLastInstruction()->IsGoto()) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim_, "Loop must exit from its header.");
+    return false;
+  }
+
+  // The loop must count up to a loop invariant bound: for (i = start; i < n; i += inc).
+  const HLoopBoundInformation& bound_info = loop_->GetBoundInformation();
+  HInductionVariable* biv = bound_info.loop_biv_;
+  if (biv == nullptr ||
+      !bound_info.is_simple_count_up_ ||
+      bound_info.comparison_condition_ != kCondLT ||
+      biv->IsFP() ||
+      biv->GetPhiInsn()->GetType() != Primitive::kPrimInt ||
+      biv->GetLinearInsn()->GetBlock() != body ||
+      bound_info.loop_bound_ == nullptr ||
+      bound_info.loop_bound_->GetType() != Primitive::kPrimInt) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim_, "Loop must count up to an int bound.");
+    return false;
+  }
+
+  int64_t distance = static_cast<int64_t>(unrolling_factor - 1) * biv->GetIncrement();
+  if (distance > std::numeric_limits<int32_t>::max()) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim_, "Loop increment is too large.");
+    return false;
+  }
+
+  if (loop_->HasKnownNumIterations() &&
+      loop_->GetNumIterations(header) < static_cast<int64_t>(unrolling_factor)) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim_, "Loop has fewer iterations than the unrolling factor.");
+    return false;
+  }
+
+  // The header must only hold the phi nodes, the suspend check and the exit test, since
+  // the unrolled loop does not copy anything else from it.
+  HInstruction* condition = header->GetLastInstruction()->InputAt(0);
+  HInstruction* bound = bound_info.loop_bound_;
+  HInstruction* biv_phi = biv->GetPhiInsn();
+  if (!condition->IsCondition() ||
+      condition->GetBlock() != header ||
+      !condition->HasOnlyOneNonEnvironmentUse() ||
+      !((condition->InputAt(0) == biv_phi && condition->InputAt(1) == bound) ||
+        (condition->InputAt(0) == bound && condition->InputAt(1) == biv_phi))) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim_, "Loop condition must compare the IV with the bound.");
+    return false;
+  }
+
+  for (HInstructionIterator it(header->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* insn = it.Current();
+    if (!insn->IsSuspendCheck() && insn != condition && !insn->IsIf()) {
+      PRINT_PASS_OSTREAM_MESSAGE(optim_, "Loop header must only compute the exit condition.");
+      return false;
+    }
+  }
+
+  uint64_t nb_instructions = loop_->CountInstructionsInBody(true);
+  uint64_t nb_unrolled_instructions = unrolling_factor * nb_instructions;
+  if (nb_unrolled_instructions > max_unrolled_instructions) {
+    PRINT_PASS_OSTREAM_MESSAGE(optim_, "Number of unrolled instructions ("
+      << nb_unrolled_instructions << ") is too large (max: " << max_unrolled_instructions << ")");
+    return false;
+  }
+
+  // Verify that the instructions can be all cloned by the instruction cloner.
+  {
+    HInstructionCloner instruction_verifier(graph_, nullptr, false);
+    for (HInstructionIterator it(header->GetInstructions()); !it.Done(); it.Advance()) {
+      if (it.Current()->IsSuspendCheck()) {
+        it.Current()->Accept(&instruction_verifier);
+      }
+    }
+    for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+      if (!it.Current()->IsGoto()) {
+        it.Current()->Accept(&instruction_verifier);
+      }
+    }
+    if (!instruction_verifier.AllOkay()) {
+      PRINT_PASS_OSTREAM_MESSAGE(optim_, "The loop body cannot be copied entirely."
+        " because of instruction: " << instruction_verifier.GetDebugNameForFailedClone());
+      return false;
+    }
+  }
+
+  return true;
+}
 }  // namespace art
@@ -54,6 +54,28 @@ class HLoopUnrolling {
    */
   bool Gate(uint64_t max_unrolled_instructions) const;
 
+  /**
+   * @brief Unrolls the loop by the provided factor, keeping the loop as the remainder loop.
+   * @details A loop running unrolling_factor iterations per trip is inserted before the
+   * loop. It exits as soon as fewer than unrolling_factor iterations remain, and the
+   * original loop then runs the remaining ones. The user must check the feasability of
+   * the unrolling before with a call to GatePartial().
+   * @param unrolling_factor The number of copies of the loop body in the unrolled loop.
+   * @return Returns true if the unrolling was successful, or false otherwise.
+   * @sa GatePartial.
+   */
+  bool PartialUnroll(uint64_t unrolling_factor);
+
+  /**
+   * @brief Makes sure the provided loop complies with the restrictions of partial unrolling.
+   * @details The loop must be a top tested loop made of a header and a body, counting up
+   * to a loop invariant bound with a strict comparison. Its trip count may be unknown.
+   * @param unrolling_factor The number of copies of the loop body in the unrolled loop.
+   * @param max_unrolled_instructions The maximum amount of instructions tolerated for unrolling.
+   * @return Returns true if the loop complies with the unrolling restrictions, or false otherwise.
+   */
+  bool GatePartial(uint64_t unrolling_factor, uint64_t max_unrolled_instructions) const;
+
  private:
   /**
    * @brief Allocates copies of the loop basic blocks to their destination. This facility also
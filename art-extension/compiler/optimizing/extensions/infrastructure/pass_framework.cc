@@ -14,7 +14,9 @@
  * limitations under the License.
  */
 
+#include "allocation_sinking.h"
 #include "base/dumpable.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "code_generator.h"
 #include "constant_calculation_sinking.h"
@@ -26,9 +28,17 @@
 #include "generate_selects.h"
 #include "graph_visualizer.h"
 #include "gvn_after_fbl.h"
+#include "load_store_elimination.h"
 #include "loadhoist_storesink.h"
 #include "loop_formation.h"
 #include "loop_full_unrolling.h"
+#include "loop_fusion.h"
+#include "loop_interchange.h"
+#include "loop_partial_unrolling.h"
+#include "loop_strength_reduction.h"
+#include "loop_unswitching.h"
+#include "loop_vectorization.h"
+#include "loop_versioning.h"
 #ifndef SOFIA
 #include "non_temporal_move.h"
 #endif
@@ -83,11 +93,20 @@ static HCustomPassPlacement kPassCustomPlacement[] = {
   { "GVN_after_form_bottom_loops", "form_bottom_loops", kPassInsertAfter },
   { "value_propagation_through_heap", "GVN_after_form_bottom_loops", kPassInsertAfter },
   { "constant_folding_after_vph", "value_propagation_through_heap", kPassInsertAfter },
+  { "load_store_elimination", "constant_folding_after_vph", kPassInsertBefore },
+  { "allocation_sinking", "constant_folding_after_vph", kPassInsertBefore },
   { "loop_formation_before_bottom_loops", "form_bottom_loops", kPassInsertBefore },
   { "pure_invokes_analysis", "remove_loop_suspend_checks", kPassInsertAfter },
   { "non_temporal_move", "trivial_loop_evaluator", kPassInsertAfter},
   { "trivial_loop_evaluator", "find_ivs", kPassInsertAfter},
   { "loop_full_unrolling", "constant_calculation_sinking", kPassInsertAfter},
+  { "loop_fusion", "form_bottom_loops", kPassInsertBefore },
+  { "loop_interchange", "form_bottom_loops", kPassInsertBefore },
+  { "loop_unswitching", "form_bottom_loops", kPassInsertBefore },
+  { "loop_versioning", "form_bottom_loops", kPassInsertBefore },
+  { "loop_vectorization", "form_bottom_loops", kPassInsertBefore },
+  { "loop_partial_unrolling", "form_bottom_loops", kPassInsertBefore },
+  { "loop_strength_reduction", "form_bottom_loops", kPassInsertBefore },
 };
 
 /**
@@ -99,6 +118,25 @@ static const char* kPassRemoval[] = {
   nullptr,
 };
 
+/**
+ * @brief Static array holding names of passes that the code generator relies on.
+ * @details They run at every optimization tier, even when the compile-time
+ * budget of the method is exceeded.
+ */
+static const char* kPassRequired[] = {
+  "instruction_simplifier_before_codegen",
+  "backend_optimization",
+};
+
+static bool IsRequiredPass(HOptimization* optimization) {
+  for (size_t i = 0, len = arraysize(kPassRequired); i < len; i++) {
+    if (strcmp(optimization->GetPassName(), kPassRequired[i]) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 static void AddX86Optimization(HOptimization* optimization,
                                ArenaVector<HOptimization*>& list,
                                ArenaSafeMap<const char*, HCustomPassPlacement*> &placements) {
@@ -415,13 +453,15 @@ void FillVerbose(HOptimization_X86* optimizations[],
   }
 }
 
-void RunOptimizationsX86(HGraph* graph,
+bool RunOptimizationsX86(HGraph* graph,
                          CompilerDriver* driver,
                          OptimizingCompilerStats* stats,
                          HOptimization* optimizations[],
                          size_t length,
                          PassInfoPrinter* pass_info_printer,
-                         const DexCompilationUnit& c_unit) {
+                         const DexCompilationUnit& c_unit,
+                         OptimizationTier tier,
+                         uint64_t deadline_ns) {
   // We want our own list of passes with our own vector.
   ArenaAllocator* arena = graph->GetArena();
   ArenaVector<HOptimization*> opt_list(arena->Adapter(kArenaAllocMisc));
@@ -455,7 +495,18 @@ void RunOptimizationsX86(HGraph* graph,
   GVNAfterFormBottomLoops* gvn_after_fbl = new (arena) GVNAfterFormBottomLoops(graph);
   HGenerateSelects* generate_selects = new (arena) HGenerateSelects(graph, c_unit, stats);
   HConstantFolding_X86* constant_folding = new (arena) HConstantFolding_X86(graph, stats, "constant_folding_after_vph");
+  HLoadStoreElimination* load_store_elimination = new (arena) HLoadStoreElimination(graph, stats);
+  HAllocationSinking* allocation_sinking = new (arena) HAllocationSinking(graph, stats);
   HLoopFullUnrolling* loop_full_unrolling = new (arena) HLoopFullUnrolling(graph, stats);
+  HLoopFusion* loop_fusion = new (arena) HLoopFusion(graph, stats);
+  HLoopInterchange* loop_interchange = new (arena) HLoopInterchange(graph, stats);
+  HLoopUnswitching* loop_unswitching = new (arena) HLoopUnswitching(graph, stats);
+  HLoopVersioning* loop_versioning = new (arena) HLoopVersioning(graph, stats);
+  HLoopVectorization* loop_vectorization =
+      new (arena) HLoopVectorization(graph, driver->GetInstructionSetFeatures(), stats);
+  HLoopPartialUnrolling* loop_partial_unrolling = new (arena) HLoopPartialUnrolling(graph, stats);
+  HLoopStrengthReduction* loop_strength_reduction =
+      new (arena) HLoopStrengthReduction(graph, stats);
 
   HOptimization_X86* opt_array[] = {
     loop_formation,
@@ -475,8 +526,21 @@ void RunOptimizationsX86(HGraph* graph,
     form_bottom_loops,
     gvn_after_fbl,
     value_propagation_through_heap,
+    // allocation_sinking must follow load_store_elimination: they are both placed
+    // before constant_folding_after_vph.
+    load_store_elimination,
+    allocation_sinking,
     constant_folding,
     formation_before_bottom_loops,
+    // These must follow formation_before_bottom_loops, in this order: they are all
+    // placed before form_bottom_loops.
+    loop_fusion,
+    loop_interchange,
+    loop_unswitching,
+    loop_versioning,
+    loop_vectorization,
+    loop_partial_unrolling,
+    loop_strength_reduction,
     generate_selects,
     loop_full_unrolling
   };
@@ -485,9 +549,9 @@ void RunOptimizationsX86(HGraph* graph,
   FillVerbose(opt_array, arraysize(opt_array),
               driver);
 
-  // Create the vector for the optimizations.
+  // Create the vector for the optimizations. Below O2, only the common code passes run.
   FillOptimizationList(graph, opt_list, optimizations, length,
-                                  opt_array, arraysize(opt_array));
+                       opt_array, (tier == kOptimizationTierO2) ? arraysize(opt_array) : 0u);
 
   // Finish by removing the ones we do not want.
   RemoveOptimizations(opt_list, driver);
@@ -497,6 +561,7 @@ void RunOptimizationsX86(HGraph* graph,
 
   FillUserPassOptions(opt_list, driver);
 
+  bool budget_exceeded = false;
   {
 #ifdef PERF_ANALYSIS_INFRASTRUCTURE
     PerfAnalysisInfrastructure::ScopedAnalysis sa(method_name.c_str(), true, perf_analysis);
@@ -507,6 +572,16 @@ void RunOptimizationsX86(HGraph* graph,
     for (auto optimization : opt_list) {
       if (optimization != nullptr) {
         const char* name = optimization->GetPassName();
+        // Past the compile-time budget, fall back to the passes of O0.
+        if (deadline_ns != 0u && !budget_exceeded && NanoTime() > deadline_ns) {
+          VLOG(compiler) << "Compile-time budget exceeded before " << name << " in "
+                         << PrettyMethod(c_unit.GetDexMethodIndex(), *c_unit.GetDexFile());
+          budget_exceeded = true;
+        }
+        if (budget_exceeded && !IsRequiredPass(optimization)) {
+          phase_id++;
+          continue;
+        }
         // if debug option --stop-optimizing-after is passed
         // then check whether we need to stop optimization.
         if (driver->GetCompilerOptions().IsConditionalCompilation()) {
@@ -545,6 +620,7 @@ void RunOptimizationsX86(HGraph* graph,
       phase_id++;
     }
   }
+  return !budget_exceeded;
 }
 
 }  // namespace art
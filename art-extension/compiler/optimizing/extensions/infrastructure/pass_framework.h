@@ -19,6 +19,7 @@
 
 #include "driver/dex_compilation_unit.h"
 #include "nodes.h"
+#include "optimizing_compiler_stats.h"
 
 namespace art {
 
@@ -49,13 +50,22 @@ bool PrintPassesOnlyOnce(ArenaVector<HOptimization*>& opts,
                          ArenaVector<HOptimization*>& post_opts,
                          CompilerDriver* driver);
 
-void RunOptimizationsX86(HGraph* graph,
+/**
+ * @brief Run the optimizations of a method.
+ * @param tier the optimization tier of the method: the extension passes only run at O2.
+ * @param deadline_ns the NanoTime() after which only the passes the code generator relies
+ *        on are run, or 0 if the method has no compile-time budget.
+ * @return false if the method went over its compile-time budget.
+ */
+bool RunOptimizationsX86(HGraph* graph,
                          CompilerDriver* driver,
                          OptimizingCompilerStats* stats,
                          HOptimization* optimizations[],
                          size_t length,
                          PassInfoPrinter* pass_info_printer,
-                         const DexCompilationUnit& c_unit);
+                         const DexCompilationUnit& c_unit,
+                         OptimizationTier tier,
+                         uint64_t deadline_ns);
 
 }  // namespace art
 
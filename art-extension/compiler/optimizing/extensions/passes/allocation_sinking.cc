@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <vector>
+
+#include "allocation_sinking.h"
+#include "ext_escape.h"
+#include "ext_utility.h"
+#include "graph_x86.h"
+
+namespace art {
+
+/**
+ * @brief Are all the uses of the allocation stores to its fields?
+ * @param allocation The allocation.
+ * @return true if nothing reads the allocation.
+ */
+static bool IsWriteOnlyAllocation(HInstruction* allocation) {
+  for (HUseIterator<HInstruction*> it(allocation->GetUses()); !it.Done(); it.Advance()) {
+    HInstruction* user = it.Current()->GetUser();
+    if (!user->IsInstanceFieldSet() ||
+        user->AsInstanceFieldSet()->IsVolatile() ||
+        it.Current()->GetIndex() != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Can the method complete without going through a block?
+ * @param from The block to start from.
+ * @param avoided The block to avoid.
+ * @return true if a path goes from the block from to the exit block without going
+ * through the block avoided.
+ */
+static bool CanAvoidBlock(HBasicBlock* from, HBasicBlock* avoided) {
+  std::vector<bool> visited(from->GetGraph()->GetBlocks().Size(), false);
+  std::vector<HBasicBlock*> worklist;
+  visited[from->GetBlockId()] = true;
+  worklist.push_back(from);
+
+  while (!worklist.empty()) {
+    HBasicBlock* block = worklist.back();
+    worklist.pop_back();
+    if (block->IsExitBlock()) {
+      return true;
+    }
+
+    const GrowableArray<HBasicBlock*>& successors = block->GetSuccessors();
+    for (size_t succ_idx = 0u; succ_idx < successors.Size(); succ_idx++) {
+      HBasicBlock* successor = successors.Get(succ_idx);
+      if (successor != avoided && !visited[successor->GetBlockId()]) {
+        visited[successor->GetBlockId()] = true;
+        worklist.push_back(successor);
+      }
+    }
+  }
+  return false;
+}
+
+void HAllocationSinking::Run() {
+  HGraph_X86* graph = GRAPH_TO_GRAPH_X86(graph_);
+
+  if (GetOption("Enabled").AsInt() != 1) {
+    return;
+  }
+
+  if (graph->IsDebuggable()) {
+    // The debugger can look at all the objects.
+    return;
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "Begin " << GetMethodName(graph));
+
+  std::vector<HNewInstance*> allocations;
+  bool has_deoptimize = false;
+  bool has_catch = false;
+  for (HReversePostOrderIterator it(*graph); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    has_catch |= block->IsCatchBlock();
+    for (HInstructionIterator inst_it(block->GetInstructions()); !inst_it.Done(); inst_it.Advance()) {
+      HInstruction* insn = inst_it.Current();
+      has_deoptimize |= insn->IsDeoptimize();
+      if (insn->IsNewInstance()) {
+        HNewInstance* allocation = insn->AsNewInstance();
+        // The access checks are left to the runtime.
+        if (!allocation->IsFinalizable() &&
+            allocation->GetEntrypoint() == kQuickAllocObject) {
+          allocations.push_back(allocation);
+        }
+      }
+    }
+  }
+
+  if (has_deoptimize) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Method " << GetMethodName(graph)
+      << " can deoptimize, skipping it");
+    allocations.clear();
+  }
+
+  // The later allocations go first: removing or moving their stores may help the earlier ones.
+  for (auto it = allocations.rbegin(); it != allocations.rend(); it++) {
+    HNewInstance* allocation = *it;
+    HBasicBlock* block = allocation->GetBlock();
+    int allocation_id = allocation->GetId();
+
+    if (IsWriteOnlyAllocation(allocation)) {
+      Eliminate(allocation);
+      MaybeRecordStat(MethodCompilationStat::kIntelAllocationEliminated);
+      PRINT_PASS_OSTREAM_MESSAGE(this, "Allocation " << allocation_id
+        << " of method " << GetMethodName(graph) << " has been successfully eliminated");
+      continue;
+    }
+
+    if (has_catch) {
+      // Moving the allocation could change the handler of its exceptions.
+      continue;
+    }
+
+    // Only sink to a block that is not always executed, and without entering a loop.
+    HBasicBlock* escape_block = FindEscapeBlock(allocation);
+    DCHECK(escape_block != nullptr);
+    if (escape_block == block ||
+        escape_block->GetLoopInformation() != block->GetLoopInformation() ||
+        !CanAvoidBlock(block, escape_block)) {
+      continue;
+    }
+
+    Sink(allocation, escape_block);
+    MaybeRecordStat(MethodCompilationStat::kIntelAllocationSunk);
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Allocation " << allocation_id
+      << " of method " << GetMethodName(graph) << " has been successfully sunk to block #"
+      << escape_block->GetBlockId());
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "End " << GetMethodName(graph));
+}
+
+void HAllocationSinking::Eliminate(HNewInstance* allocation) {
+  InsertClassInitialization(allocation);
+
+  std::vector<HInstruction*> stores;
+  for (HUseIterator<HInstruction*> it(allocation->GetUses()); !it.Done(); it.Advance()) {
+    stores.push_back(it.Current()->GetUser());
+  }
+  for (HInstruction* store : stores) {
+    store->GetBlock()->RemoveInstruction(store);
+  }
+
+  allocation->RemoveEnvironmentUsers();
+  allocation->GetBlock()->RemoveInstruction(allocation);
+}
+
+void HAllocationSinking::Sink(HNewInstance* allocation, HBasicBlock* escape_block) {
+  InsertClassInitialization(allocation);
+
+  // Keep the order of the stores.
+  std::vector<HInstruction*> stores;
+  for (HInstruction* insn = allocation->GetNext(); insn != nullptr; insn = insn->GetNext()) {
+    if (IsInitializingStore(allocation, insn)) {
+      stores.push_back(insn);
+    }
+  }
+
+  HInstruction* cursor = escape_block->GetFirstInstruction();
+  allocation->MoveBefore(cursor);
+  for (HInstruction* store : stores) {
+    store->MoveBefore(cursor);
+  }
+
+  // The environments between the old and the new place cannot refer to the allocation.
+  allocation->RemoveEnvironmentUsers();
+}
+
+void HAllocationSinking::InsertClassInitialization(HNewInstance* allocation) {
+  ArenaAllocator* arena = graph_->GetArena();
+  uint32_t dex_pc = allocation->GetDexPc();
+  HBasicBlock* block = allocation->GetBlock();
+
+  HLoadClass* load_class = new (arena) HLoadClass(allocation->GetTypeIndex(), false, dex_pc);
+  HClinitCheck* clinit_check = new (arena) HClinitCheck(load_class, dex_pc);
+  block->InsertInstructionBefore(load_class, allocation);
+  block->InsertInstructionBefore(clinit_check, allocation);
+  load_class->CopyEnvironmentFrom(allocation->GetEnvironment());
+  clinit_check->CopyEnvironmentFrom(allocation->GetEnvironment());
+}
+
+}  // namespace art
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_ALLOCATION_SINKING_H_
+#define ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_ALLOCATION_SINKING_H_
+
+#include "nodes.h"
+#include "optimization_x86.h"
+
+namespace art {
+
+/**
+ * @brief Allocation Sinking removes the allocations that are only written, and moves
+ * the others to the cold paths where they escape.
+ * @details The pass runs after the inliner, pure_invokes_analysis and
+ * load_store_elimination: once the constructors are inlined, the pure invokes with
+ * unused results removed and the loads forwarded, short-lived objects often only
+ * have stores to their fields left. Such an allocation is removed with its stores.
+ * Otherwise, the allocation and the stores initializing it are moved down to the block
+ * dominating all its other uses, when the method can complete without going through
+ * this block, and the block is in the same loop.
+ * In both cases, the initialization of the class is kept where the allocation was.
+ * Allocations of finalizable classes, or needing an access check, are left alone,
+ * as well as the ones of the methods that can deoptimize or catch exceptions, since the
+ * interpreter or the handlers may look at the objects.
+ */
+class HAllocationSinking : public HOptimization_X86 {
+ public:
+  HAllocationSinking(HGraph* graph, OptimizingCompilerStats* stats = nullptr)
+    : HOptimization_X86(graph, true, kAllocationSinkingPassName, stats) {
+      DefineOption("Enabled", OptionContent(1));
+    }
+
+  void Run() OVERRIDE;
+
+ private:
+  /**
+   * @brief Remove an allocation whose only uses are stores to its fields.
+   * @param allocation The allocation.
+   */
+  void Eliminate(HNewInstance* allocation);
+
+  /**
+   * @brief Move an allocation and its initializing stores to the start of a block.
+   * @param allocation The allocation.
+   * @param escape_block The block returned by FindEscapeBlock for the allocation.
+   */
+  void Sink(HNewInstance* allocation, HBasicBlock* escape_block);
+
+  /**
+   * @brief Initialize the class of an allocation in place of the allocation.
+   * @param allocation The allocation that is removed or moved.
+   */
+  void InsertClassInitialization(HNewInstance* allocation);
+
+  static constexpr const char* kAllocationSinkingPassName = "allocation_sinking";
+
+  DISALLOW_COPY_AND_ASSIGN(HAllocationSinking);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_ALLOCATION_SINKING_H_
@@ -16,10 +16,113 @@
 
 #include "constant_folding_x86.h"
 
+#include "base/bit_utils.h"
+#include "ext_utility.h"
+
 namespace art {
 
 void HConstantFolding_X86::Run() {
   fold.Run();
+
+  // The generic folding leaves the intrinsics alone; fold those with constant
+  // arguments, in the same order so that their results can be folded further.
+  for (HReversePostOrderIterator it(*graph_); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    for (HInstructionIterator inst_it(block->GetInstructions());
+         !inst_it.Done(); inst_it.Advance()) {
+      HInstruction* inst = inst_it.Current();
+      if (!inst->IsInvokeStaticOrDirect() ||
+          inst->AsInvoke()->GetIntrinsic() == Intrinsics::kNone ||
+          inst->AsInvokeStaticOrDirect()->IsStaticWithExplicitClinitCheck()) {
+        continue;
+      }
+      HConstant* constant = TryStaticEvaluation(inst->AsInvoke());
+      if (constant != nullptr) {
+        PRINT_PASS_OSTREAM_MESSAGE(this, "Folded intrinsic " << inst->GetId()
+                                   << " into " << constant->GetId());
+        inst->ReplaceWith(constant);
+        inst->GetBlock()->RemoveInstruction(inst);
+        MaybeRecordStat(MethodCompilationStat::kIntelIntrinsicFolded);
+      }
+    }
+  }
+}
+
+HConstant* HConstantFolding_X86::TryStaticEvaluation(HInvoke* invoke) const {
+  for (size_t i = 0, e = invoke->GetNumberOfArguments(); i < e; i++) {
+    if (!invoke->InputAt(i)->IsConstant()) {
+      return nullptr;
+    }
+  }
+
+  HInstruction* first = invoke->InputAt(0);
+  switch (invoke->GetIntrinsic()) {
+    case Intrinsics::kIntegerBitCount: {
+      uint32_t value = first->AsIntConstant()->GetValue();
+      return graph_->GetIntConstant(POPCOUNT(value));
+    }
+    case Intrinsics::kLongBitCount: {
+      uint64_t value = first->AsLongConstant()->GetValue();
+      return graph_->GetIntConstant(POPCOUNT(value));
+    }
+    case Intrinsics::kIntegerNumberOfLeadingZeros: {
+      // CLZ and CTZ are undefined for zero.
+      uint32_t value = first->AsIntConstant()->GetValue();
+      return graph_->GetIntConstant(value == 0 ? 32 : CLZ(value));
+    }
+    case Intrinsics::kLongNumberOfLeadingZeros: {
+      uint64_t value = first->AsLongConstant()->GetValue();
+      return graph_->GetIntConstant(value == 0 ? 64 : CLZ(value));
+    }
+    case Intrinsics::kIntegerNumberOfTrailingZeros: {
+      uint32_t value = first->AsIntConstant()->GetValue();
+      return graph_->GetIntConstant(value == 0 ? 32 : CTZ(value));
+    }
+    case Intrinsics::kLongNumberOfTrailingZeros: {
+      uint64_t value = first->AsLongConstant()->GetValue();
+      return graph_->GetIntConstant(value == 0 ? 64 : CTZ(value));
+    }
+    case Intrinsics::kIntegerRotateLeft:
+    case Intrinsics::kIntegerRotateRight: {
+      uint32_t value = first->AsIntConstant()->GetValue();
+      int32_t distance = invoke->InputAt(1)->AsIntConstant()->GetValue() & 31;
+      if (invoke->GetIntrinsic() == Intrinsics::kIntegerRotateRight) {
+        distance = (32 - distance) & 31;
+      }
+      uint32_t result = (distance == 0) ? value : (value << distance) | (value >> (32 - distance));
+      return graph_->GetIntConstant(static_cast<int32_t>(result));
+    }
+    case Intrinsics::kLongRotateLeft:
+    case Intrinsics::kLongRotateRight: {
+      uint64_t value = first->AsLongConstant()->GetValue();
+      int32_t distance = invoke->InputAt(1)->AsIntConstant()->GetValue() & 63;
+      if (invoke->GetIntrinsic() == Intrinsics::kLongRotateRight) {
+        distance = (64 - distance) & 63;
+      }
+      uint64_t result = (distance == 0) ? value : (value << distance) | (value >> (64 - distance));
+      return graph_->GetLongConstant(static_cast<int64_t>(result));
+    }
+    case Intrinsics::kIntegerHighestOneBit: {
+      uint32_t value = first->AsIntConstant()->GetValue();
+      uint32_t result = (value == 0) ? 0 : (UINT32_C(1) << (31 - CLZ(value)));
+      return graph_->GetIntConstant(static_cast<int32_t>(result));
+    }
+    case Intrinsics::kLongHighestOneBit: {
+      uint64_t value = first->AsLongConstant()->GetValue();
+      uint64_t result = (value == 0) ? 0 : (UINT64_C(1) << (63 - CLZ(value)));
+      return graph_->GetLongConstant(static_cast<int64_t>(result));
+    }
+    case Intrinsics::kIntegerSignum: {
+      int32_t value = first->AsIntConstant()->GetValue();
+      return graph_->GetIntConstant((value > 0) - (value < 0));
+    }
+    case Intrinsics::kLongSignum: {
+      int64_t value = first->AsLongConstant()->GetValue();
+      return graph_->GetIntConstant((value > 0) - (value < 0));
+    }
+    default:
+      return nullptr;
+  }
 }
 
 }  // namespace art
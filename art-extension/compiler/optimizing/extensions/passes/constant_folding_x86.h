@@ -22,6 +22,10 @@
 
 namespace art {
 
+/**
+ * @brief Runs the generic constant folding, then folds the calls to the bit
+ * manipulation intrinsics of Integer and Long whose arguments are constants.
+ */
 class HConstantFolding_X86 : public HOptimization_X86 {
  public:
   explicit HConstantFolding_X86(HGraph* graph, OptimizingCompilerStats* stats = nullptr,
@@ -31,6 +35,13 @@ class HConstantFolding_X86 : public HOptimization_X86 {
   void Run() OVERRIDE;
 
  private:
+  /**
+   * @brief Evaluate an intrinsic invoke at compile time.
+   * @param invoke The invoke, recognized as an intrinsic.
+   * @return The constant result, or nullptr if the invoke cannot be folded.
+   */
+  HConstant* TryStaticEvaluation(HInvoke* invoke) const;
+
   static constexpr const char* kConstantFoldingPassName = "constant_folding_x86";
 
   HConstantFolding fold;
@@ -0,0 +1,330 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include "ext_escape.h"
+#include "ext_utility.h"
+#include "graph_x86.h"
+#include "load_store_elimination.h"
+#include "side_effects_analysis.h"
+
+namespace art {
+
+static bool IsVolatileAccess(HInstruction* insn) {
+  if (HInstanceFieldGet* ifg = insn->AsInstanceFieldGet()) {
+    return ifg->IsVolatile();
+  } else if (HInstanceFieldSet* ifs = insn->AsInstanceFieldSet()) {
+    return ifs->IsVolatile();
+  } else if (HStaticFieldGet* sfg = insn->AsStaticFieldGet()) {
+    return sfg->IsVolatile();
+  } else if (HStaticFieldSet* sfs = insn->AsStaticFieldSet()) {
+    return sfs->IsVolatile();
+  } else {
+    return false;
+  }
+}
+
+static bool IsLoad(HInstruction* insn) {
+  return insn->IsInstanceFieldGet() || insn->IsStaticFieldGet() || insn->IsArrayGet();
+}
+
+static bool IsStore(HInstruction* insn) {
+  return insn->IsInstanceFieldSet() || insn->IsStaticFieldSet() || insn->IsArraySet();
+}
+
+static HInstruction* GetStoredValue(HInstruction* store) {
+  return store->IsArraySet() ? store->AsArraySet()->GetValue() : store->InputAt(1);
+}
+
+/**
+ * @brief Get the type of the location accessed by a load or a store.
+ * @details AliasCheck considers the accesses to the same element of an array as the same
+ * location, even when aget and aput do not agree on its type.
+ */
+static Primitive::Type GetAccessType(HInstruction* access) {
+  if (access->IsInstanceFieldSet()) {
+    return access->AsInstanceFieldSet()->GetFieldType();
+  } else if (access->IsStaticFieldSet()) {
+    return access->AsStaticFieldSet()->GetFieldType();
+  } else if (access->IsArraySet()) {
+    return access->AsArraySet()->GetComponentType();
+  }
+  return access->GetType();
+}
+
+/**
+ * @brief Does the instruction order or clobber the heap accesses, without side effects
+ * telling so?
+ * @details Monitors and volatile accesses order the accesses of the other threads, and
+ * allocations may run the static initializer of their class.
+ */
+static bool IsHeapBarrier(HInstruction* insn) {
+  return insn->IsMonitorOperation() ||
+         IsVolatileAccess(insn) ||
+         insn->IsNewInstance() ||
+         insn->IsClinitCheck();
+}
+
+static bool HasHeapBarrier(HLoopInformation* loop) {
+  for (HBlocksInLoopIterator it_loop(*loop); !it_loop.Done(); it_loop.Advance()) {
+    HBasicBlock* block = it_loop.Current();
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      if (IsHeapBarrier(it.Current())) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void HLoadStoreElimination::Run() {
+  HGraph_X86* graph = GRAPH_TO_GRAPH_X86(graph_);
+
+  if (GetOption("Enabled").AsInt() != 1) {
+    return;
+  }
+
+  if (graph->GetBlocks().Size() > static_cast<size_t>(GetOption("MaxBlocks").AsInt())) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Method " << GetMethodName(graph)
+      << " has too many blocks");
+    return;
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "Begin " << GetMethodName(graph));
+
+  loads_forwarded_ = 0u;
+  stores_removed_ = 0u;
+  non_escaping_.clear();
+  bool has_deoptimize = false;
+  for (HReversePostOrderIterator it(*graph); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    for (HInstructionIterator inst_it(block->GetInstructions()); !inst_it.Done(); inst_it.Advance()) {
+      HInstruction* insn = inst_it.Current();
+      has_deoptimize |= insn->IsDeoptimize();
+      if (IsNonEscapingAllocation(insn)) {
+        non_escaping_.insert(insn);
+      }
+    }
+  }
+
+  if (has_deoptimize) {
+    // The interpreter reads the allocations from the environment after a deoptimization.
+    non_escaping_.clear();
+  }
+
+  SideEffectsAnalysis side_effects(graph);
+  side_effects.Run();
+
+  // The blocks are visited after their predecessors, except for the back edges.
+  std::vector<HeapValues> exit_values(graph->GetBlocks().Size());
+  for (HReversePostOrderIterator it(*graph); !it.Done(); it.Advance()) {
+    HBasicBlock* block = it.Current();
+    HeapValues values;
+    GetEntryValues(block, exit_values, side_effects, &values);
+    VisitBlock(block, &values);
+    exit_values[block->GetBlockId()].swap(values);
+  }
+
+  RemoveStoresToUnreadAllocations();
+
+  if (loads_forwarded_ != 0u || stores_removed_ != 0u) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Method " << GetMethodName(graph)
+      << " has been successfully optimized: " << loads_forwarded_ << " loads forwarded, "
+      << stores_removed_ << " stores removed");
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "End " << GetMethodName(graph));
+}
+
+void HLoadStoreElimination::GetEntryValues(HBasicBlock* block,
+                                           const std::vector<HeapValues>& exit_values,
+                                           const SideEffectsAnalysis& side_effects,
+                                           HeapValues* values) {
+  values->clear();
+
+  if (block->IsEntryBlock() || block->IsCatchBlock()) {
+    return;
+  }
+
+  if (block->IsLoopHeader()) {
+    // The back edges have not been visited: only keep the values that the loop cannot change.
+    HLoopInformation* loop = block->GetLoopInformation();
+    if (side_effects.GetLoopEffects(block).HasSideEffects() || HasHeapBarrier(loop)) {
+      return;
+    }
+    *values = exit_values[loop->GetPreHeader()->GetBlockId()];
+    return;
+  }
+
+  const GrowableArray<HBasicBlock*>& predecessors = block->GetPredecessors();
+  *values = exit_values[predecessors.Get(0)->GetBlockId()];
+
+  // Keep the values on which all the predecessors agree.
+  for (size_t pred_idx = 1u; pred_idx < predecessors.Size(); pred_idx++) {
+    const HeapValues& other = exit_values[predecessors.Get(pred_idx)->GetBlockId()];
+    values->erase(std::remove_if(values->begin(), values->end(),
+      [this, &other] (const HeapValue& heap_value) {
+        for (const HeapValue& other_value : other) {
+          if (other_value.value == heap_value.value &&
+              GetAccessType(other_value.access) == GetAccessType(heap_value.access) &&
+              alias_.Alias(other_value.access, heap_value.access) == AliasCheck::kMustAlias) {
+            return false;
+          }
+        }
+        return true;
+      }), values->end());
+  }
+}
+
+void HLoadStoreElimination::VisitBlock(HBasicBlock* block, HeapValues* values) {
+  // The stores of the block that nothing has observed yet.
+  std::vector<HInstruction*> pending_stores;
+
+  for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* insn = it.Current();
+
+    // The catch handlers may observe all the stores done before a throw.
+    if (insn->CanThrow()) {
+      pending_stores.clear();
+    }
+
+    if (IsLoad(insn) && !IsVolatileAccess(insn)) {
+      if (TryForwardLoad(insn, *values)) {
+        continue;
+      }
+
+      // The load observes the stores it may read.
+      pending_stores.erase(std::remove_if(pending_stores.begin(), pending_stores.end(),
+        [this, insn] (HInstruction* store) {
+          return alias_.Alias(store, insn) != AliasCheck::kNoAlias;
+        }), pending_stores.end());
+
+      values->push_back(HeapValue { insn, insn });
+    } else if (IsStore(insn) && !IsVolatileAccess(insn)) {
+      KillValues(insn, values);
+
+      // A store to the same location that nothing observed is dead.
+      for (auto store_it = pending_stores.begin(); store_it != pending_stores.end(); store_it++) {
+        HInstruction* store = *store_it;
+        if (GetAccessType(store) == GetAccessType(insn) &&
+            alias_.Alias(store, insn) == AliasCheck::kMustAlias) {
+          PRINT_PASS_OSTREAM_MESSAGE(this, "Removing dead store " << store);
+          pending_stores.erase(store_it);
+          store->GetBlock()->RemoveInstruction(store);
+          stores_removed_++;
+          MaybeRecordStat(MethodCompilationStat::kIntelDeadStoreRemoved);
+          break;
+        }
+      }
+
+      pending_stores.push_back(insn);
+      values->push_back(HeapValue { insn, GetStoredValue(insn) });
+    } else if (alias_.HasSideEffects(insn) || IsHeapBarrier(insn)) {
+      // Only the fields of the non escaping allocations are out of reach.
+      pending_stores.clear();
+      values->erase(std::remove_if(values->begin(), values->end(),
+        [this] (const HeapValue& heap_value) {
+          return !IsNonEscapingLocation(heap_value);
+        }), values->end());
+    }
+  }
+}
+
+bool HLoadStoreElimination::TryForwardLoad(HInstruction* load, const HeapValues& values) {
+  // Look at the most recent values first.
+  for (auto it = values.rbegin(); it != values.rend(); it++) {
+    if (alias_.Alias(it->access, load) != AliasCheck::kMustAlias) {
+      continue;
+    }
+
+    Primitive::Type load_type = load->GetType();
+    if (GetAccessType(it->access) != load_type) {
+      return false;
+    }
+
+    HInstruction* value = it->value;
+    if (value->GetType() != load_type) {
+      // The store of an int to a narrower location truncates it.
+      if (value->GetType() != Primitive::kPrimInt ||
+          (load_type != Primitive::kPrimByte &&
+           load_type != Primitive::kPrimShort &&
+           load_type != Primitive::kPrimChar)) {
+        return false;
+      }
+      HTypeConversion* conversion = new (graph_->GetArena())
+          HTypeConversion(load_type, value, load->GetDexPc());
+      load->GetBlock()->InsertInstructionBefore(conversion, load);
+      value = conversion;
+    }
+
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Replacing " << load << " by " << value);
+    load->ReplaceWith(value);
+    load->GetBlock()->RemoveInstruction(load);
+    loads_forwarded_++;
+    MaybeRecordStat(MethodCompilationStat::kIntelLoadForwarded);
+    return true;
+  }
+  return false;
+}
+
+void HLoadStoreElimination::KillValues(HInstruction* store, HeapValues* values) {
+  values->erase(std::remove_if(values->begin(), values->end(),
+    [this, store] (const HeapValue& heap_value) {
+      return alias_.Alias(heap_value.access, store) != AliasCheck::kNoAlias;
+    }), values->end());
+}
+
+bool HLoadStoreElimination::IsNonEscapingLocation(const HeapValue& heap_value) const {
+  HInstruction* access = heap_value.access;
+  if (!access->IsInstanceFieldGet() && !access->IsInstanceFieldSet()) {
+    return false;
+  }
+  HInstruction* base = access->InputAt(0);
+  if (base->IsNullCheck()) {
+    base = base->InputAt(0);
+  }
+  return non_escaping_.find(base) != non_escaping_.end();
+}
+
+void HLoadStoreElimination::RemoveStoresToUnreadAllocations() {
+  for (HInstruction* allocation : non_escaping_) {
+    std::vector<HInstruction*> stores;
+    bool has_loads = false;
+    for (HUseIterator<HInstruction*> it(allocation->GetUses()); !it.Done(); it.Advance()) {
+      HInstruction* user = it.Current()->GetUser();
+      if (user->IsInstanceFieldGet()) {
+        has_loads = true;
+        break;
+      }
+      stores.push_back(user);
+    }
+
+    if (has_loads) {
+      continue;
+    }
+
+    for (HInstruction* store : stores) {
+      PRINT_PASS_OSTREAM_MESSAGE(this, "Removing store " << store
+        << " to non escaping allocation " << allocation);
+      store->GetBlock()->RemoveInstruction(store);
+      stores_removed_++;
+      MaybeRecordStat(MethodCompilationStat::kIntelDeadStoreRemoved);
+    }
+  }
+}
+
+}  // namespace art
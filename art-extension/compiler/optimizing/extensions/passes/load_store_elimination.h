@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOAD_STORE_ELIMINATION_H_
+#define ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOAD_STORE_ELIMINATION_H_
+
+#include <set>
+#include <vector>
+
+#include "ext_alias.h"
+#include "nodes.h"
+#include "optimization_x86.h"
+
+namespace art {
+
+// Forward declarations.
+class SideEffectsAnalysis;
+
+/**
+ * @brief Load Store Elimination works on the whole method, unlike loadhoist_storesink
+ * and value_propagation_through_heap which only look at loops.
+ * @details The blocks are walked in reverse post order, and the values known to be in
+ * the heap are tracked with AliasCheck:
+ * - A load of a location with a known value is replaced by this value.
+ * - A store that is overwritten in the same block before anything can observe it is removed.
+ * - Allocations that do not escape the method are only accessed through their fields, so
+ * the calls do not clobber their values. Once all their loads have been forwarded, the
+ * stores to their fields are removed: the object is scalar replaced.
+ * The values known at the end of the predecessors of a block are merged when they agree.
+ * A loop header only keeps the values known before the loop if the loop does not write
+ * the heap, according to the SideEffectsAnalysis.
+ */
+class HLoadStoreElimination : public HOptimization_X86 {
+ public:
+  HLoadStoreElimination(HGraph* graph, OptimizingCompilerStats* stats = nullptr)
+    : HOptimization_X86(graph, true, kLoadStoreEliminationPassName, stats),
+      loads_forwarded_(0u),
+      stores_removed_(0u) {
+      DefineOption("MaxBlocks", OptionContent(500));
+      DefineOption("Enabled", OptionContent(1));
+    }
+
+  void Run() OVERRIDE;
+
+ private:
+  // A location of the heap, represented by an access to it, and its known value.
+  struct HeapValue {
+    HInstruction* access;
+    HInstruction* value;
+  };
+  typedef std::vector<HeapValue> HeapValues;
+
+  /**
+   * @brief Compute the values known at the entry of a block.
+   * @param block The block whose predecessors have been visited, except for back edges.
+   * @param exit_values The values known at the end of the visited blocks.
+   * @param side_effects The side effects of the blocks and loops.
+   * @param values Filled with the values known at the entry of the block.
+   */
+  void GetEntryValues(HBasicBlock* block,
+                      const std::vector<HeapValues>& exit_values,
+                      const SideEffectsAnalysis& side_effects,
+                      HeapValues* values);
+
+  /**
+   * @brief Forward the known values to the loads of a block, and remove its dead stores.
+   * @param block The block to visit.
+   * @param values The values known at the entry of the block, updated to its end.
+   */
+  void VisitBlock(HBasicBlock* block, HeapValues* values);
+
+  /**
+   * @brief Replace a load by the value known for its location.
+   * @param load The load.
+   * @param values The values known before the load.
+   * @return true if the load has been removed.
+   */
+  bool TryForwardLoad(HInstruction* load, const HeapValues& values);
+
+  /**
+   * @brief Forget the values that a store may overwrite.
+   * @param store The store.
+   * @param values The values to update.
+   */
+  void KillValues(HInstruction* store, HeapValues* values);
+
+  /**
+   * @brief Is the location of the value a field of a non escaping allocation?
+   * @param heap_value The value to check.
+   * @return true if no call can read or write the location.
+   */
+  bool IsNonEscapingLocation(const HeapValue& heap_value) const;
+
+  /**
+   * @brief Remove the stores to the allocations that have no loads left.
+   */
+  void RemoveStoresToUnreadAllocations();
+
+  AliasCheck alias_;
+
+  // The allocations that do not escape the method.
+  std::set<HInstruction*> non_escaping_;
+
+  size_t loads_forwarded_;
+  size_t stores_removed_;
+
+  static constexpr const char* kLoadStoreEliminationPassName = "load_store_elimination";
+
+  DISALLOW_COPY_AND_ASSIGN(HLoadStoreElimination);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOAD_STORE_ELIMINATION_H_
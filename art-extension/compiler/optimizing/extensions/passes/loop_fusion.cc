@@ -0,0 +1,340 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include "array_access_guards.h"
+#include "ext_alias.h"
+#include "ext_utility.h"
+#include "find_ivs.h"
+#include "graph_x86.h"
+#include "induction_variable.h"
+#include "loop_formation.h"
+#include "loop_fusion.h"
+#include "loop_iterators.h"
+
+namespace art {
+
+/**
+ * @brief Are two loop bounds the same value?
+ * @param first The bound of the first loop.
+ * @param second The bound of the second loop.
+ * @return true if the bounds are the same instruction or equal constants.
+ */
+static bool IsSameBound(HInstruction* first, HInstruction* second) {
+  if (first == second) {
+    return true;
+  }
+  return first->IsIntConstant() && second->IsIntConstant() &&
+         first->AsIntConstant()->GetValue() == second->AsIntConstant()->GetValue();
+}
+
+/**
+ * @brief Is the header of a loop entered from its pre-header through its first predecessor?
+ * @param loop The loop, which has a single back edge.
+ * @return true if the first input of the phis of the header comes from outside the loop.
+ */
+static bool HasPreHeaderFirst(HLoopInformation_X86* loop) {
+  const GrowableArray<HBasicBlock*>& predecessors = loop->GetHeader()->GetPredecessors();
+  return predecessors.Size() == 2u && predecessors.Get(1) == loop->GetBackEdges().Get(0);
+}
+
+void HLoopFusion::Run() {
+  HGraph_X86* graph = GRAPH_TO_GRAPH_X86(graph_);
+
+  if (GetOption("Enabled").AsInt() != 1) {
+    return;
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "Begin " << GetMethodName(graph));
+
+  // The environments in the fused loop no longer describe the original order
+  // of the iterations, which a debugger would observe.
+  if (graph->IsDebuggable()) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "End " << GetMethodName(graph));
+    return;
+  }
+
+  HFindInductionVariables find_ivs(graph, nullptr);
+  find_ivs.Run();
+
+  // Fuse one pair of loops at a time: the fused loop may be fused again with the
+  // loop following it once the loop hierarchy is rebuilt.
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    HLoopInformation_X86* loop_start = graph->GetLoopInformation();
+    for (HOutToInLoopIterator it(loop_start); !it.Done(); it.Advance()) {
+      HLoopInformation_X86* first = it.Current();
+      HLoopInformation_X86* second = GetFollowingLoop(first);
+      if (second == nullptr) {
+        continue;
+      }
+
+      HArrayAccessGuards guards(graph, this);
+      if (!Gate(first, second, &guards)) {
+        continue;
+      }
+
+      int first_id = first->GetHeader()->GetBlockId();
+      int second_id = second->GetHeader()->GetBlockId();
+      if (guards.NeedsGuards()) {
+        guards.InsertGuards(first);
+      }
+      Fuse(first, second);
+      MaybeRecordStat(MethodCompilationStat::kIntelLoopFused);
+      PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << second_id << " of method "
+        << GetMethodName(graph) << " has been fused into loop #" << first_id);
+
+      HLoopFormation form_loops(graph);
+      form_loops.Run();
+      find_ivs.Run();
+      changed = true;
+      break;
+    }
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "End " << GetMethodName(graph));
+}
+
+HLoopInformation_X86* HLoopFusion::GetFollowingLoop(HLoopInformation_X86* loop) const {
+  if (!loop->IsInner() || loop->GetBackEdges().Size() != 1u) {
+    return nullptr;
+  }
+
+  // The exit of the first loop must be the pre-header of the second one.
+  HBasicBlock* exit = loop->GetExitBlock();
+  if (exit == nullptr ||
+      exit->GetPredecessors().Size() != 1u ||
+      exit->GetSuccessors().Size() != 1u ||
+      !exit->GetPhis().IsEmpty()) {
+    return nullptr;
+  }
+  for (HInstructionIterator it(exit->GetInstructions()); !it.Done(); it.Advance()) {
+    if (!it.Current()->IsGoto()) {
+      return nullptr;
+    }
+  }
+
+  HBasicBlock* header = exit->GetSuccessors().Get(0);
+  if (!header->IsLoopHeader()) {
+    return nullptr;
+  }
+  HLoopInformation_X86* following = LOOPINFO_TO_LOOPINFO_X86(header->GetLoopInformation());
+  if (!following->IsInner() ||
+      following->GetBackEdges().Size() != 1u ||
+      following->GetPreHeader() != exit ||
+      following->GetParent() != loop->GetParent()) {
+    return nullptr;
+  }
+  return following;
+}
+
+bool HLoopFusion::Gate(HLoopInformation_X86* first,
+                       HLoopInformation_X86* second,
+                       HArrayAccessGuards* guards) {
+  int first_id = first->GetHeader()->GetBlockId();
+  int second_id = second->GetHeader()->GetBlockId();
+  if (first->HasCatchHandler() || second->HasCatchHandler()) {
+    return false;
+  }
+
+  if (!guards->AddLoop(first) || !guards->AddLoop(second)) {
+    return false;
+  }
+
+  // Both loops must run the same iterations.
+  HPhi* first_iv = first->GetBasicIV()->GetPhiInsn();
+  HPhi* second_iv = second->GetBasicIV()->GetPhiInsn();
+  HInstruction* first_start = first->PhiInput(first_iv, false);
+  HInstruction* second_start = second->PhiInput(second_iv, false);
+  if (first_start->AsIntConstant()->GetValue() != second_start->AsIntConstant()->GetValue() ||
+      !IsSameBound(first->GetBoundInformation().loop_bound_,
+                   second->GetBoundInformation().loop_bound_)) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loops #" << first_id << " and #" << second_id
+      << " do not run the same iterations");
+    return false;
+  }
+
+  // The body of the fused loop would exceed the budget.
+  uint64_t num_instructions =
+      first->CountInstructionsInBody() + second->CountInstructionsInBody();
+  if (num_instructions > static_cast<uint64_t>(GetOption("MaxInstructions").AsInt())) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loops #" << first_id << " and #" << second_id
+      << " have too many instructions (" << num_instructions << ")");
+    return false;
+  }
+
+  // The fused loop keeps the suspend check of the first loop.
+  if (first->GetSuspendCheck() == nullptr && second->GetSuspendCheck() != nullptr) {
+    return false;
+  }
+
+  // The blocks are rewired through the back edges and the body entry of the second loop.
+  HBasicBlock* second_header = second->GetHeader();
+  HBasicBlock* second_exit = second->GetExitBlock();
+  if (!HasPreHeaderFirst(first) ||
+      !HasPreHeaderFirst(second) ||
+      first->GetBackEdges().Get(0)->GetSuccessors().Size() != 1u ||
+      second->GetBackEdges().Get(0)->GetSuccessors().Size() != 1u ||
+      second_exit == nullptr ||
+      second_exit->GetPredecessors().Size() != 1u) {
+    return false;
+  }
+  for (size_t idx = 0u; idx != second_header->GetSuccessors().Size(); idx++) {
+    HBasicBlock* successor = second_header->GetSuccessors().Get(idx);
+    if (successor != second_exit && successor->GetPredecessors().Size() != 1u) {
+      return false;
+    }
+  }
+
+  // The values carried by the second loop must start from values defined before the loops.
+  for (HInstructionIterator it(second_header->GetPhis()); !it.Done(); it.Advance()) {
+    HPhi* phi = it.Current()->AsPhi();
+    if (phi != second_iv && !guards->IsDefinedBeforeLoops(phi->InputAt(0))) {
+      PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << second_id << " carries phi "
+        << phi->GetId() << " depending on loop #" << first_id);
+      return false;
+    }
+  }
+
+  for (HLoopInformation_X86* loop : { first, second }) {
+    for (HBlocksInLoopIterator it_loop(*loop); !it_loop.Done(); it_loop.Advance()) {
+      HBasicBlock* block = it_loop.Current();
+      if (block == loop->GetHeader()) {
+        continue;
+      }
+      for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+        HInstruction* instruction = it.Current();
+        if (!guards->AddInstruction(instruction)) {
+          PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << loop->GetHeader()->GetBlockId()
+            << " cannot guard " << instruction->DebugName() << " " << instruction->GetId());
+          return false;
+        }
+
+        // The second loop must not use the values computed by the first one.
+        if (loop == second) {
+          for (size_t input_idx = 0u; input_idx != instruction->InputCount(); input_idx++) {
+            if (first->Contains(*instruction->InputAt(input_idx)->GetBlock())) {
+              PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << second_id
+                << " uses a value of loop #" << first_id);
+              return false;
+            }
+          }
+        }
+      }
+      for (HInstructionIterator it(block->GetPhis()); !it.Done(); it.Advance()) {
+        HInstruction* phi = it.Current();
+        for (size_t input_idx = 0u; loop == second && input_idx != phi->InputCount(); input_idx++) {
+          if (first->Contains(*phi->InputAt(input_idx)->GetBlock())) {
+            return false;
+          }
+        }
+      }
+    }
+  }
+
+  // Two accesses of different loops that may touch the same element, one of them
+  // being a store, must index the element with the IV of their loop.
+  AliasCheck alias;
+  const std::vector<HInstruction*>& accesses = guards->GetAccesses();
+  for (HInstruction* first_access : accesses) {
+    if (!first->Contains(*first_access->GetBlock())) {
+      continue;
+    }
+    for (HInstruction* second_access : accesses) {
+      if (!second->Contains(*second_access->GetBlock())) {
+        continue;
+      }
+      if (!first_access->IsArraySet() && !second_access->IsArraySet()) {
+        continue;
+      }
+      if (alias.Alias(first_access, second_access) == AliasCheck::kNoAlias) {
+        continue;
+      }
+      if (guards->GetElementIndex(first_access) != first_iv ||
+          guards->GetElementIndex(second_access) != second_iv) {
+        PRINT_PASS_OSTREAM_MESSAGE(this, "Loops #" << first_id << " and #" << second_id
+          << " have a dependence between " << first_access->GetId() << " and "
+          << second_access->GetId() << " preventing the fusion");
+        return false;
+      }
+    }
+  }
+
+  if (guards->NeedsGuards() && first->GetSuspendCheck() == nullptr) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << first_id
+      << " has no suspend check to deoptimize from");
+    return false;
+  }
+
+  return true;
+}
+
+void HLoopFusion::Fuse(HLoopInformation_X86* first, HLoopInformation_X86* second) {
+  HGraph_X86* graph = GRAPH_TO_GRAPH_X86(graph_);
+  HBasicBlock* first_header = first->GetHeader();
+  HBasicBlock* first_back_edge = first->GetBackEdges().Get(0);
+  HBasicBlock* second_header = second->GetHeader();
+  HBasicBlock* second_pre_header = second->GetPreHeader();
+  HBasicBlock* second_back_edge = second->GetBackEdges().Get(0);
+  HBasicBlock* second_exit = second->GetExitBlock();
+  HBasicBlock* second_body = second_header->GetSuccessors().Get(0);
+  if (second_body == second_exit) {
+    second_body = second_header->GetSuccessors().Get(1);
+  }
+
+  // The values carried by the second loop are now carried by the first one, whose
+  // header has the same predecessors once rewired.
+  HPhi* first_iv = first->GetBasicIV()->GetPhiInsn();
+  HInstruction* first_update = first->GetBasicIV()->GetLinearInsn();
+  HPhi* second_iv = second->GetBasicIV()->GetPhiInsn();
+  HInstruction* second_update = second->GetBasicIV()->GetLinearInsn();
+  for (HInstructionIterator it(second_header->GetPhis()); !it.Done(); it.Advance()) {
+    HPhi* phi = it.Current()->AsPhi();
+    if (phi != second_iv) {
+      graph->MovePhi(phi, first_header);
+    }
+  }
+  second_iv->ReplaceWith(first_iv);
+  second_header->RemovePhi(second_iv);
+  second_update->ReplaceWith(first_update);
+  second_update->GetBlock()->RemoveInstruction(second_update);
+
+  // Run the body of the second loop after the body of the first one.
+  first_back_edge->ReplaceSuccessor(first_header, second_body);
+  second_back_edge->ReplaceSuccessor(second_header, first_header);
+  second_pre_header->ReplaceSuccessor(second_header, second_exit);
+  first->ReplaceBackEdge(first_back_edge, second_back_edge);
+
+  std::vector<HBasicBlock*> second_blocks;
+  for (HBlocksInLoopIterator it_loop(*second); !it_loop.Done(); it_loop.Advance()) {
+    if (it_loop.Current() != second_header) {
+      second_blocks.push_back(it_loop.Current());
+    }
+  }
+  for (HBasicBlock* block : second_blocks) {
+    first->AddToAll(block);
+  }
+  for (HLoopInformation_X86* loop = first->GetParent(); loop != nullptr; loop = loop->GetParent()) {
+    static_cast<HLoopInformation*>(loop)->Remove(second_header);
+  }
+
+  graph->DeleteBlock(second_header);
+  graph->RebuildDomination();
+}
+
+}  // namespace art
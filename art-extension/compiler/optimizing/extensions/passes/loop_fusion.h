@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_FUSION_H_
+#define ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_FUSION_H_
+
+#include "nodes.h"
+#include "optimization_x86.h"
+
+namespace art {
+
+// Forward declarations.
+class HArrayAccessGuards;
+class HLoopInformation_X86;
+
+/**
+ * @brief Loop Fusion merges two adjacent inner loops running the same iterations,
+ * so that the arrays they walk are only brought once in the cache.
+ * @details The second loop must directly follow the first one, and both must count
+ * up by one from the same constant to the same bound. The second loop must not use
+ * the values computed by the first one. Two accesses of the loops that may touch the
+ * same element, one of them being a store, must index the element with the IV of
+ * their loop: the dependence then stays within an iteration of the fused loop. The
+ * exceptions that the loops may throw are ruled out by HArrayAccessGuards.
+ */
+class HLoopFusion : public HOptimization_X86 {
+ public:
+  HLoopFusion(HGraph* graph, OptimizingCompilerStats* stats = nullptr)
+    : HOptimization_X86(graph, true, kLoopFusionPassName, stats) {
+      // The maximum number of instructions in the body of the fused loop.
+      DefineOption("MaxInstructions", OptionContent(100));
+      DefineOption("Enabled", OptionContent(1));
+    }
+
+  void Run() OVERRIDE;
+
+ private:
+  /**
+   * @brief Find the loop directly following a loop.
+   * @param loop The first loop.
+   * @return The following loop if both are inner loops, nullptr otherwise.
+   */
+  HLoopInformation_X86* GetFollowingLoop(HLoopInformation_X86* loop) const;
+
+  /**
+   * @brief Check that two loops can be fused.
+   * @param first The first loop.
+   * @param second The loop following the first one.
+   * @param guards Filled with the instructions of both loops.
+   * @return true if the loops can be fused once the guards are inserted.
+   */
+  bool Gate(HLoopInformation_X86* first,
+            HLoopInformation_X86* second,
+            HArrayAccessGuards* guards);
+
+  /**
+   * @brief Move the body of the second loop at the end of the body of the first one.
+   * @param first The first loop.
+   * @param second The loop following the first one, which is removed.
+   */
+  void Fuse(HLoopInformation_X86* first, HLoopInformation_X86* second);
+
+  static constexpr const char* kLoopFusionPassName = "loop_fusion";
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_FUSION_H_
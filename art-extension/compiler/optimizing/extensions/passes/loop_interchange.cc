@@ -0,0 +1,426 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include "array_access_guards.h"
+#include "ext_alias.h"
+#include "ext_utility.h"
+#include "find_ivs.h"
+#include "graph_x86.h"
+#include "induction_variable.h"
+#include "loop_formation.h"
+#include "loop_interchange.h"
+#include "loop_iterators.h"
+
+namespace art {
+
+/**
+ * @brief Replace the uses of an IV by another one in the inputs of an instruction.
+ * @param instruction The instruction to update.
+ * @param first The first IV.
+ * @param second The second IV.
+ */
+static void SwapInputs(HInstruction* instruction, HPhi* first, HPhi* second) {
+  for (size_t input_idx = 0u; input_idx != instruction->InputCount(); input_idx++) {
+    HInstruction* input = instruction->InputAt(input_idx);
+    if (input == first) {
+      instruction->ReplaceInput(second, input_idx);
+    } else if (input == second) {
+      instruction->ReplaceInput(first, input_idx);
+    }
+  }
+}
+
+/**
+ * @brief Replace the uses of an IV by another one in the environments of an instruction.
+ * @param instruction The instruction to update.
+ * @param first The first IV.
+ * @param second The second IV.
+ */
+static void SwapEnvironmentUses(HInstruction* instruction, HPhi* first, HPhi* second) {
+  for (HEnvironment* env = instruction->GetEnvironment();
+       env != nullptr;
+       env = env->GetParent()) {
+    for (size_t env_idx = 0u; env_idx != env->Size(); env_idx++) {
+      HInstruction* value = env->GetInstructionAt(env_idx);
+      HInstruction* replacement = (value == first) ? second : ((value == second) ? first : nullptr);
+      if (replacement != nullptr) {
+        env->RemoveAsUserOfInput(env_idx);
+        env->SetRawEnvAt(env_idx, replacement);
+        replacement->AddEnvUseAt(env, env_idx);
+      }
+    }
+  }
+}
+
+/**
+ * @brief Replace an input of an instruction.
+ * @param instruction The instruction to update.
+ * @param old_input The input to replace.
+ * @param new_input The replacement.
+ */
+static void ReplaceInputOf(HInstruction* instruction,
+                           HInstruction* old_input,
+                           HInstruction* new_input) {
+  for (size_t input_idx = 0u; input_idx != instruction->InputCount(); input_idx++) {
+    if (instruction->InputAt(input_idx) == old_input) {
+      instruction->ReplaceInput(new_input, input_idx);
+      return;
+    }
+  }
+}
+
+/**
+ * @brief Are all the non environment uses of an IV either its own update, its exit
+ * test, or in the body of the inner loop?
+ * @param phi The IV.
+ * @param update The update of the IV.
+ * @param inner The inner loop of the nest.
+ * @return true if swapping the uses in the body of the inner loop replaces all of them.
+ */
+static bool HasOnlyBodyUses(HPhi* phi, HInstruction* update, HLoopInformation_X86* inner) {
+  HBasicBlock* inner_header = inner->GetHeader();
+  for (HUseIterator<HInstruction*> it(phi->GetUses()); !it.Done(); it.Advance()) {
+    HInstruction* user = it.Current()->GetUser();
+    HBasicBlock* block = user->GetBlock();
+    bool is_exit_test = block->IsLoopHeader() && user->IsCondition() &&
+                        block->GetLoopInformation() == phi->GetBlock()->GetLoopInformation();
+    bool is_in_body = block != inner_header && inner->Contains(*block);
+    if (user != update && !is_exit_test && !is_in_body) {
+      return false;
+    }
+  }
+
+  for (HUseIterator<HInstruction*> it(update->GetUses()); !it.Done(); it.Advance()) {
+    if (it.Current()->GetUser() != phi) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HLoopInterchange::Run() {
+  HGraph_X86* graph = GRAPH_TO_GRAPH_X86(graph_);
+
+  if (GetOption("Enabled").AsInt() != 1) {
+    return;
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "Begin " << GetMethodName(graph));
+
+  // The environments in the interchanged loops no longer describe the original
+  // order of the iterations, which a debugger would observe.
+  if (graph->IsDebuggable()) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "End " << GetMethodName(graph));
+    return;
+  }
+
+  HFindInductionVariables find_ivs(graph, nullptr);
+  find_ivs.Run();
+
+  // Collect the nests of two loops first: the guards change the loop hierarchy.
+  std::vector<HLoopInformation_X86*> candidates;
+  HLoopInformation_X86* loop_start = graph->GetLoopInformation();
+  for (HOutToInLoopIterator it(loop_start); !it.Done(); it.Advance()) {
+    HLoopInformation_X86* loop = it.Current();
+    HLoopInformation_X86* inner = loop->GetInner();
+    if (inner != nullptr && inner->IsInner() && inner->GetNextSibling() == nullptr &&
+        inner->GetPrevSibling() == nullptr) {
+      candidates.push_back(loop);
+    }
+  }
+
+  bool changed = false;
+  for (HLoopInformation_X86* outer : candidates) {
+    HArrayAccessGuards guards(graph, this);
+    if (!Gate(outer, &guards)) {
+      continue;
+    }
+
+    if (guards.NeedsGuards()) {
+      guards.InsertGuards(outer);
+    }
+    Interchange(outer);
+    changed = true;
+    MaybeRecordStat(MethodCompilationStat::kIntelLoopInterchanged);
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << outer->GetHeader()->GetBlockId()
+      << " of method " << GetMethodName(graph)
+      << " has been interchanged with loop #" << outer->GetInner()->GetHeader()->GetBlockId());
+  }
+
+  if (changed) {
+    // Rebuild the loop hierarchy and the IVs to take the guards into account.
+    HLoopFormation form_loops(graph);
+    form_loops.Run();
+    find_ivs.Run();
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "End " << GetMethodName(graph));
+}
+
+bool HLoopInterchange::Gate(HLoopInformation_X86* outer, HArrayAccessGuards* guards) {
+  HLoopInformation_X86* inner = outer->GetInner();
+  if (outer->HasCatchHandler()) {
+    return false;
+  }
+
+  if (!guards->AddLoop(outer) || !guards->AddLoop(inner)) {
+    return false;
+  }
+
+  HPhi* outer_iv = outer->GetBasicIV()->GetPhiInsn();
+  HPhi* inner_iv = inner->GetBasicIV()->GetPhiInsn();
+  if (!HasOnlyBodyUses(outer_iv, outer->GetBasicIV()->GetLinearInsn(), inner) ||
+      !HasOnlyBodyUses(inner_iv, inner->GetBasicIV()->GetLinearInsn(), inner)) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << outer->GetHeader()->GetBlockId()
+      << " uses its IVs out of the inner loop");
+    return false;
+  }
+
+  if (!IsPerfectNest(outer, guards)) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << outer->GetHeader()->GetBlockId()
+      << " is not a perfect nest");
+    return false;
+  }
+
+  // Each value carried by the inner loop must be a reduction carried by both loops.
+  size_t num_reductions = 0u;
+  for (HInstructionIterator it(outer->GetHeader()->GetPhis()); !it.Done(); it.Advance()) {
+    HPhi* phi = it.Current()->AsPhi();
+    if (phi != outer_iv) {
+      if (!IsReduction(outer, phi)) {
+        PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << outer->GetHeader()->GetBlockId()
+          << " carries phi " << phi->GetId() << " which is not a reduction");
+        return false;
+      }
+      num_reductions++;
+    }
+  }
+  size_t num_inner_phis = 0u;
+  for (HInstructionIterator it(inner->GetHeader()->GetPhis()); !it.Done(); it.Advance()) {
+    num_inner_phis++;
+  }
+  if (num_inner_phis != num_reductions + 1u) {
+    return false;
+  }
+
+  // The values computed in the inner loop must not be used after it, except through
+  // the reductions.
+  for (HBlocksInLoopIterator it_loop(*inner); !it_loop.Done(); it_loop.Advance()) {
+    HBasicBlock* block = it_loop.Current();
+    if (block == inner->GetHeader()) {
+      continue;
+    }
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (!guards->AddInstruction(instruction)) {
+        PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << outer->GetHeader()->GetBlockId()
+          << " cannot guard " << instruction->DebugName() << " " << instruction->GetId());
+        return false;
+      }
+      for (HUseIterator<HInstruction*> use_it(instruction->GetUses());
+           !use_it.Done();
+           use_it.Advance()) {
+        if (!inner->Contains(*use_it.Current()->GetUser()->GetBlock())) {
+          return false;
+        }
+      }
+    }
+    for (HInstructionIterator it(block->GetPhis()); !it.Done(); it.Advance()) {
+      for (HUseIterator<HInstruction*> use_it(it.Current()->GetUses());
+           !use_it.Done();
+           use_it.Advance()) {
+        if (!inner->Contains(*use_it.Current()->GetUser()->GetBlock())) {
+          return false;
+        }
+      }
+    }
+  }
+
+  // Two accesses that may touch the same element, one of them being a store, must use
+  // the same IV as the index of the element.
+  AliasCheck alias;
+  const std::vector<HInstruction*>& accesses = guards->GetAccesses();
+  for (size_t first_idx = 0u; first_idx != accesses.size(); first_idx++) {
+    HInstruction* first = accesses[first_idx];
+    for (size_t second_idx = first_idx + 1u; second_idx != accesses.size(); second_idx++) {
+      HInstruction* second = accesses[second_idx];
+      if (!first->IsArraySet() && !second->IsArraySet()) {
+        continue;
+      }
+      if (alias.Alias(first, second) == AliasCheck::kNoAlias) {
+        continue;
+      }
+      HPhi* index = guards->GetElementIndex(first);
+      if (index == nullptr || index != guards->GetElementIndex(second)) {
+        PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << outer->GetHeader()->GetBlockId()
+          << " has a dependence between " << first->GetId() << " and " << second->GetId()
+          << " preventing the interchange");
+        return false;
+      }
+    }
+  }
+
+  // Interchange the loops if the inner loop walks more rows than the outer loop.
+  size_t num_row_walks = 0u;
+  size_t num_element_walks = 0u;
+  for (HInstruction* access : accesses) {
+    HPhi* row_index = guards->GetRowIndex(access);
+    if (row_index == inner_iv) {
+      num_row_walks++;
+    } else if (row_index == outer_iv) {
+      num_element_walks++;
+    }
+  }
+  if (num_row_walks <= num_element_walks) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << outer->GetHeader()->GetBlockId()
+      << " already walks the rows in its outer loop");
+    return false;
+  }
+
+  if (guards->NeedsGuards() && outer->GetSuspendCheck() == nullptr) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << outer->GetHeader()->GetBlockId()
+      << " has no suspend check to deoptimize from");
+    return false;
+  }
+
+  return true;
+}
+
+bool HLoopInterchange::IsPerfectNest(HLoopInformation_X86* outer, HArrayAccessGuards* guards) {
+  HLoopInformation_X86* inner = outer->GetInner();
+  HBasicBlock* outer_header = outer->GetHeader();
+  HInstruction* outer_update = outer->GetBasicIV()->GetLinearInsn();
+
+  for (HBlocksInLoopIterator it_loop(*outer); !it_loop.Done(); it_loop.Advance()) {
+    HBasicBlock* block = it_loop.Current();
+    if (block == outer_header || inner->Contains(*block)) {
+      continue;
+    }
+
+    // The inner loop runs in each iteration of the outer loop.
+    if (block->GetSuccessors().Size() != 1u || !block->GetPhis().IsEmpty()) {
+      return false;
+    }
+
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction->IsGoto() || instruction == outer_update) {
+        continue;
+      }
+
+      // The outer loop runs a different number of iterations once interchanged,
+      // so its other instructions must compute the same value in each of them.
+      if (instruction->GetSideEffects().HasDependencies() ||
+          !guards->AddInstruction(instruction)) {
+        return false;
+      }
+      for (size_t input_idx = 0u; input_idx != instruction->InputCount(); input_idx++) {
+        HInstruction* input = instruction->InputAt(input_idx);
+        HBasicBlock* input_block = input->GetBlock();
+        if (input == outer_update || input_block == outer_header || inner->Contains(*input_block)) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+bool HLoopInterchange::IsReduction(HLoopInformation_X86* outer, HPhi* phi) {
+  HLoopInformation_X86* inner = outer->GetInner();
+  HInstruction* inner_phi = outer->PhiInput(phi, true);
+  if (!inner_phi->IsPhi() ||
+      inner_phi->GetBlock() != inner->GetHeader() ||
+      inner->PhiInput(inner_phi->AsPhi(), false) != phi) {
+    return false;
+  }
+
+  // Integer sums, products and bitwise operations do not depend on the order
+  // of their operands.
+  HInstruction* update = inner->PhiInput(inner_phi->AsPhi(), true);
+  Primitive::Type type = phi->GetType();
+  if ((type != Primitive::kPrimInt && type != Primitive::kPrimLong) ||
+      inner_phi->GetType() != type ||
+      update->GetType() != type ||
+      !(update->IsAdd() || update->IsMul() || update->IsAnd() ||
+        update->IsOr() || update->IsXor()) ||
+      (update->InputAt(0) != inner_phi && update->InputAt(1) != inner_phi)) {
+    return false;
+  }
+
+  // Only the reduction itself may use the value in the nest.
+  for (HUseIterator<HInstruction*> it(inner_phi->GetUses()); !it.Done(); it.Advance()) {
+    HInstruction* user = it.Current()->GetUser();
+    if (user != update && user != phi) {
+      return false;
+    }
+  }
+  for (HUseIterator<HInstruction*> it(update->GetUses()); !it.Done(); it.Advance()) {
+    if (it.Current()->GetUser() != inner_phi) {
+      return false;
+    }
+  }
+  for (HUseIterator<HInstruction*> it(phi->GetUses()); !it.Done(); it.Advance()) {
+    HInstruction* user = it.Current()->GetUser();
+    if (user != inner_phi && outer->Contains(*user->GetBlock())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void HLoopInterchange::Interchange(HLoopInformation_X86* outer) {
+  HLoopInformation_X86* inner = outer->GetInner();
+  HBasicBlock* inner_header = inner->GetHeader();
+  HPhi* outer_iv = outer->GetBasicIV()->GetPhiInsn();
+  HPhi* inner_iv = inner->GetBasicIV()->GetPhiInsn();
+  HInstruction* inner_update = inner->GetBasicIV()->GetLinearInsn();
+
+  // The outer loop now runs the iterations of the inner loop, and conversely:
+  // the body of the inner loop uses each IV in place of the other one.
+  for (HBlocksInLoopIterator it_loop(*inner); !it_loop.Done(); it_loop.Advance()) {
+    HBasicBlock* block = it_loop.Current();
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (block != inner_header && instruction != inner_update) {
+        SwapInputs(instruction, outer_iv, inner_iv);
+      }
+      SwapEnvironmentUses(instruction, outer_iv, inner_iv);
+    }
+    if (block != inner_header) {
+      for (HInstructionIterator it(block->GetPhis()); !it.Done(); it.Advance()) {
+        SwapInputs(it.Current(), outer_iv, inner_iv);
+      }
+    }
+  }
+
+  // Swap the iteration spaces of the loops.
+  HInstruction* outer_start = outer->PhiInput(outer_iv, false);
+  HInstruction* inner_start = inner->PhiInput(inner_iv, false);
+  outer_iv->ReplaceInput(inner_start, 0u);
+  inner_iv->ReplaceInput(outer_start, 0u);
+
+  HInstruction* outer_end = outer->GetBoundInformation().loop_bound_;
+  HInstruction* inner_end = inner->GetBoundInformation().loop_bound_;
+  if (outer_end != inner_end) {
+    ReplaceInputOf(outer->GetHeader()->GetLastInstruction()->InputAt(0), outer_end, inner_end);
+    ReplaceInputOf(inner_header->GetLastInstruction()->InputAt(0), inner_end, outer_end);
+  }
+}
+
+}  // namespace art
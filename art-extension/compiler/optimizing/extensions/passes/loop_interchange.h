@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_INTERCHANGE_H_
+#define ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_INTERCHANGE_H_
+
+#include "nodes.h"
+#include "optimization_x86.h"
+
+namespace art {
+
+// Forward declarations.
+class HArrayAccessGuards;
+class HLoopInformation_X86;
+
+/**
+ * @brief Loop Interchange swaps the loops of a nest that walks the rows of an array
+ * of arrays in its inner loop, so that the inner loop walks the elements of a row.
+ * @details The nest must be perfect: the outer loop only runs the inner loop, and
+ * both count up by one to bounds defined before the nest. The values carried by
+ * both loops must be integer sums, products or bitwise operations, which do not
+ * depend on the order of the iterations. Two accesses that may touch the same
+ * element, one of them being a store, must index the element with the same IV:
+ * whatever the distance of the dependence for the other IV, it keeps its direction.
+ * The loops are interchanged by swapping the uses of their IVs in the body of the
+ * inner loop, along with their start values and bounds. The exceptions that the
+ * body may throw are ruled out by HArrayAccessGuards before the nest.
+ */
+class HLoopInterchange : public HOptimization_X86 {
+ public:
+  HLoopInterchange(HGraph* graph, OptimizingCompilerStats* stats = nullptr)
+    : HOptimization_X86(graph, true, kLoopInterchangePassName, stats) {
+      DefineOption("Enabled", OptionContent(1));
+    }
+
+  void Run() OVERRIDE;
+
+ private:
+  /**
+   * @brief Check that a nest can be interchanged and would benefit from it.
+   * @param outer The outer loop of the nest, which has a single inner loop.
+   * @param guards Filled with the instructions of the nest.
+   * @return true if the nest can be interchanged once the guards are inserted.
+   */
+  bool Gate(HLoopInformation_X86* outer, HArrayAccessGuards* guards);
+
+  /**
+   * @brief Check that the outer loop only runs the inner loop.
+   * @param outer The outer loop of the nest.
+   * @param guards Filled with the instructions of the outer loop.
+   * @return true if the blocks of the outer loop that are not part of the inner
+   * loop only compute values that do not change between its iterations.
+   */
+  bool IsPerfectNest(HLoopInformation_X86* outer, HArrayAccessGuards* guards);
+
+  /**
+   * @brief Is a phi of the outer loop a reduction carried by both loops?
+   * @param outer The outer loop of the nest.
+   * @param phi The phi of the header of the outer loop.
+   * @return true if the inner loop only updates the value with an integer sum,
+   * product or bitwise operation, and nothing else in the nest uses it.
+   */
+  bool IsReduction(HLoopInformation_X86* outer, HPhi* phi);
+
+  /**
+   * @brief Swap the loops of the nest.
+   * @param outer The outer loop of the nest that passed Gate.
+   */
+  void Interchange(HLoopInformation_X86* outer);
+
+  static constexpr const char* kLoopInterchangePassName = "loop_interchange";
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_INTERCHANGE_H_
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include "cloning.h"
+#include "ext_utility.h"
+#include "find_ivs.h"
+#include "graph_x86.h"
+#include "loop_formation.h"
+#include "loop_iterators.h"
+#include "loop_partial_unrolling.h"
+#include "loop_unrolling.h"
+
+namespace art {
+
+/**
+ * @brief Is the loop the remainder of a loop inserted in front of it?
+ * @details The unrolled and vectorized loops exit into the pre-header of the original
+ * loop, which starts from their last IV value. Such a loop only runs a few iterations.
+ * @param loop The loop to check, with a basic IV.
+ * @return true if the loop starts from the IV of the loop right before it.
+ */
+static bool IsRemainderLoop(HLoopInformation_X86* loop) {
+  HPhi* phi = loop->GetBoundInformation().loop_biv_->GetPhiInsn();
+  HInstruction* start = loop->PhiInput(phi, false);
+  if (!start->IsPhi() || !start->GetBlock()->IsLoopHeader()) {
+    return false;
+  }
+
+  HLoopInformation_X86* previous =
+      LOOPINFO_TO_LOOPINFO_X86(start->GetBlock()->GetLoopInformation());
+  return previous->GetExitBlock() == loop->GetPreHeader();
+}
+
+void HLoopPartialUnrolling::Run() {
+  HGraph_X86* graph = GRAPH_TO_GRAPH_X86(graph_);
+
+  if (GetOption("Enabled").AsInt() != 1) {
+    return;
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "Begin " << GetMethodName(graph));
+
+  // The IVs and bounds must be up to date: BCE and LICM ran since find_ivs.
+  HFindInductionVariables find_ivs(graph, nullptr);
+  find_ivs.Run();
+
+  // Collect the candidates first: unrolling changes the loop hierarchy.
+  std::vector<HLoopInformation_X86*> candidates;
+  HLoopInformation_X86* loop_start = graph->GetLoopInformation();
+  for (HOnlyInnerLoopIterator it(loop_start); !it.Done(); it.Advance()) {
+    HLoopInformation_X86* loop = it.Current();
+    HLoopUnrolling loop_unrolling(loop, this);
+    if (Gate(loop, &loop_unrolling)) {
+      candidates.push_back(loop);
+    }
+  }
+
+  uint64_t unrolling_factor = GetOption("UnrollingFactor").AsInt();
+  bool graph_updated = false;
+  for (HLoopInformation_X86* loop : candidates) {
+    HLoopUnrolling loop_unrolling(loop, this);
+    if (!loop_unrolling.PartialUnroll(unrolling_factor)) {
+      continue;
+    }
+
+    graph_updated = true;
+    MaybeRecordStat(MethodCompilationStat::kIntelLoopPartiallyUnrolled);
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << loop->GetHeader()->GetBlockId()
+      << " of method " << GetMethodName(graph)
+      << " has been successfully partially unrolled by factor "
+      << unrolling_factor);
+  }
+
+  if (graph_updated) {
+    // Rebuild the loop hierarchy and the IVs to take the unrolled loops into account.
+    HLoopFormation form_loops(graph);
+    form_loops.Run();
+    find_ivs.Run();
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "End " << GetMethodName(graph));
+}
+
+bool HLoopPartialUnrolling::Gate(HLoopInformation_X86* loop,
+                                 HLoopUnrolling* loop_unrolling) const {
+  DCHECK(loop_unrolling != nullptr);
+
+  uint64_t unrolling_factor = GetOption("UnrollingFactor").AsInt();
+  uint64_t max_unrolled_instructions = GetOption("MaxInstructionsUnrolled").AsInt();
+
+  if (!loop->IsInner()) {
+    return false;
+  }
+
+  if (!loop_unrolling->GatePartial(unrolling_factor, max_unrolled_instructions)) {
+    return false;
+  }
+
+  // Unrolling the remainder of a vectorized or unrolled loop is not worth the code size.
+  if (IsRemainderLoop(loop)) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << loop->GetHeader()->GetBlockId()
+      << " is a remainder loop");
+    return false;
+  }
+
+  return true;
+}
+
+}  // namespace art
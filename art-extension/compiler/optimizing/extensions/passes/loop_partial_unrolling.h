@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_PARTIAL_UNROLLING_H_
+#define ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_PARTIAL_UNROLLING_H_
+
+#include "nodes.h"
+#include "optimization_x86.h"
+
+namespace art {
+
+// Forward declarations.
+class HLoopInformation_X86;
+class HLoopUnrolling;
+
+/**
+ * @brief Partial Unrolling copies the body of loops whose trip count is only known at
+ * runtime a given amount of times, in order to reduce the cost of the loop test and IV
+ * update per iteration. The original loop is kept to run the remaining iterations.
+ */
+class HLoopPartialUnrolling : public HOptimization_X86 {
+ public:
+  HLoopPartialUnrolling(HGraph* graph, OptimizingCompilerStats* stats = nullptr)
+    : HOptimization_X86(graph, true, kLoopPartialUnrollingPassName, stats) {
+      DefineOption("UnrollingFactor", OptionContent(4));
+      DefineOption("MaxInstructionsUnrolled", OptionContent(60));
+      DefineOption("Enabled", OptionContent(1));
+    }
+
+  void Run() OVERRIDE;
+
+ private:
+  bool Gate(HLoopInformation_X86* loop, HLoopUnrolling* loop_unrolling) const;
+
+  static constexpr const char* kLoopPartialUnrollingPassName = "loop_partial_unrolling";
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_PARTIAL_UNROLLING_H_
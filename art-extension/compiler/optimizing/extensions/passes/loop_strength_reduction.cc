@@ -0,0 +1,391 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <algorithm>
+#include <limits>
+
+#include "ext_utility.h"
+#include "find_ivs.h"
+#include "graph_x86.h"
+#include "induction_variable.h"
+#include "loop_iterators.h"
+#include "loop_strength_reduction.h"
+
+namespace art {
+
+/**
+ * @brief Multiply two values with the wrap around of a type.
+ * @param left The first value.
+ * @param right The second value.
+ * @param type The type of the multiplication, int or long.
+ * @return The product as computed by the type.
+ */
+static int64_t MultiplyWrapped(int64_t left, int64_t right, Primitive::Type type) {
+  uint64_t product = static_cast<uint64_t>(left) * static_cast<uint64_t>(right);
+  if (type == Primitive::kPrimLong) {
+    return static_cast<int64_t>(product);
+  }
+  return static_cast<int32_t>(static_cast<uint32_t>(product));
+}
+
+/**
+ * @brief Get the constant of a value for a type.
+ * @param graph The graph owning the constants.
+ * @param type The type of the constant, int or long.
+ * @param value The value, which must fit in the type.
+ * @return The constant.
+ */
+static HConstant* GetConstant(HGraph* graph, Primitive::Type type, int64_t value) {
+  if (type == Primitive::kPrimLong) {
+    return graph->GetLongConstant(value);
+  }
+  DCHECK_EQ(value, static_cast<int32_t>(value));
+  return graph->GetIntConstant(static_cast<int32_t>(value));
+}
+
+/**
+ * @brief Create a condition.
+ * @param arena The arena to allocate the condition.
+ * @param cond The kind of condition, an ordering comparison.
+ * @param left The first input.
+ * @param right The second input.
+ * @return The condition.
+ */
+static HCondition* NewCondition(ArenaAllocator* arena,
+                                IfCondition cond,
+                                HInstruction* left,
+                                HInstruction* right) {
+  switch (cond) {
+    case kCondLT:
+      return new (arena) HLessThan(left, right);
+    case kCondLE:
+      return new (arena) HLessThanOrEqual(left, right);
+    case kCondGT:
+      return new (arena) HGreaterThan(left, right);
+    case kCondGE:
+      return new (arena) HGreaterThanOrEqual(left, right);
+    default:
+      LOG(FATAL) << "Unexpected condition " << cond;
+      UNREACHABLE();
+  }
+}
+
+void HLoopStrengthReduction::Run() {
+  HGraph_X86* graph = GRAPH_TO_GRAPH_X86(graph_);
+
+  if (GetOption("Enabled").AsInt() != 1) {
+    return;
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "Begin " << GetMethodName(graph));
+
+  // The IVs and bounds must be up to date: BCE and LICM ran since find_ivs.
+  HFindInductionVariables find_ivs(graph, nullptr);
+  find_ivs.Run();
+
+  // The interpreter reads the basic IVs from the environment after a deoptimization,
+  // and the debugger may read them, so they are only removed when neither can happen.
+  bool can_remove_biv = !graph->IsDebuggable();
+  for (HReversePostOrderIterator it(*graph); !it.Done() && can_remove_biv; it.Advance()) {
+    for (HInstructionIterator insn_it(it.Current()->GetInstructions());
+         !insn_it.Done();
+         insn_it.Advance()) {
+      if (insn_it.Current()->IsDeoptimize()) {
+        can_remove_biv = false;
+        break;
+      }
+    }
+  }
+
+  bool graph_updated = false;
+  HLoopInformation_X86* loop_start = graph->GetLoopInformation();
+  for (HOutToInLoopIterator it(loop_start); !it.Done(); it.Advance()) {
+    HLoopInformation_X86* loop = it.Current();
+    if (loop->GetPreHeader() == nullptr || loop->GetBackEdges().Size() != 1u) {
+      continue;
+    }
+
+    GrowableArray<HInductionVariable*>& ivs = loop->GetInductionVariables();
+    for (size_t iv_idx = 0u; iv_idx < ivs.Size(); iv_idx++) {
+      HInductionVariable* biv = ivs.Get(iv_idx);
+      if (biv->IsFP() || biv->GetIncrement() == 0) {
+        continue;
+      }
+
+      DerivedIVs derived_ivs;
+      ReduceStrength(loop, biv, &derived_ivs);
+      if (derived_ivs.empty()) {
+        continue;
+      }
+
+      graph_updated = true;
+      PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << loop->GetHeader()->GetBlockId()
+        << " of method " << GetMethodName(graph) << ": " << derived_ivs.size()
+        << " derived IVs created for phi " << biv->GetPhiInsn()->GetId());
+
+      if (can_remove_biv &&
+          biv == loop->GetBasicIV() &&
+          ReplaceLoopTest(loop, biv, derived_ivs)) {
+        MaybeRecordStat(MethodCompilationStat::kIntelLoopTestReplaced);
+        PRINT_PASS_OSTREAM_MESSAGE(this, "Exit test of loop #"
+          << loop->GetHeader()->GetBlockId() << " of method " << GetMethodName(graph)
+          << " has been successfully replaced");
+      }
+    }
+  }
+
+  if (graph_updated) {
+    // The derived IVs are basic IVs of their loops.
+    find_ivs.Run();
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "End " << GetMethodName(graph));
+}
+
+bool HLoopStrengthReduction::GetDerivedFactor(HLoopInformation_X86* loop,
+                                              HInductionVariable* biv,
+                                              HInstruction* insn,
+                                              int64_t* factor,
+                                              bool* after_update) const {
+  HInstruction* phi = biv->GetPhiInsn();
+  HInstruction* update = biv->GetLinearInsn();
+
+  if ((!insn->IsMul() && !insn->IsShl()) ||
+      insn->GetType() != phi->GetType() ||
+      !loop->Contains(*insn->GetBlock())) {
+    return false;
+  }
+
+  HInstruction* left = insn->InputAt(0);
+  HInstruction* right = insn->InputAt(1);
+  if (insn->IsMul() && left->IsConstant()) {
+    std::swap(left, right);
+  }
+  if ((left != phi && left != update) || !right->IsConstant()) {
+    return false;
+  }
+
+  int64_t value = 0;
+  if (!GetIntConstantValue(right->AsConstant(), value)) {
+    return false;
+  }
+
+  if (insn->IsShl()) {
+    // The distance is masked like the shift does.
+    bool is_long = insn->GetType() == Primitive::kPrimLong;
+    uint32_t distance = static_cast<uint32_t>(value) & (is_long ? 63u : 31u);
+    value = MultiplyWrapped(1, static_cast<int64_t>(UINT64_C(1) << distance), insn->GetType());
+  }
+
+  // Constant folding and the simplifier take care of the trivial factors.
+  if (value == 0 || value == 1) {
+    return false;
+  }
+
+  *factor = value;
+  *after_update = (left == update);
+  return true;
+}
+
+HLoopStrengthReduction::DerivedIV* HLoopStrengthReduction::GetOrCreateDerivedIV(
+    HLoopInformation_X86* loop,
+    HInductionVariable* biv,
+    int64_t factor,
+    DerivedIVs* derived_ivs) {
+  for (DerivedIV& derived_iv : *derived_ivs) {
+    if (derived_iv.factor == factor) {
+      return &derived_iv;
+    }
+  }
+
+  // Each derived IV is live in the whole loop.
+  if (derived_ivs->size() >= static_cast<size_t>(GetOption("MaxDerivedIVs").AsInt())) {
+    return nullptr;
+  }
+
+  ArenaAllocator* arena = graph_->GetArena();
+  HPhi* phi = biv->GetPhiInsn();
+  HInstruction* update = biv->GetLinearInsn();
+  Primitive::Type type = phi->GetType();
+  HBasicBlock* pre_header = loop->GetPreHeader();
+  DCHECK_EQ(loop->GetHeader()->GetPredecessors().Get(0), pre_header);
+
+  // The derived IV starts at "factor * start", computed in the pre-header.
+  HInstruction* start = loop->PhiInput(phi, false);
+  HInstruction* derived_start = nullptr;
+  int64_t start_value = 0;
+  if (start->IsConstant() && GetIntConstantValue(start->AsConstant(), start_value)) {
+    derived_start = GetConstant(graph_, type, MultiplyWrapped(start_value, factor, type));
+  } else {
+    derived_start = new (arena) HMul(type, start, GetConstant(graph_, type, factor));
+    pre_header->InsertInstructionBefore(derived_start, pre_header->GetLastInstruction());
+  }
+
+  // It is updated next to the basic IV, by "factor * increment".
+  HPhi* derived_phi = new (arena) HPhi(arena, phi->GetRegNumber(), 0, type);
+  loop->GetHeader()->AddPhi(derived_phi);
+  HConstant* increment =
+      GetConstant(graph_, type, MultiplyWrapped(biv->GetIncrement(), factor, type));
+  HInstruction* derived_update = new (arena) HAdd(type, derived_phi, increment);
+  update->GetBlock()->InsertInstructionAfter(derived_update, update);
+  derived_phi->AddInput(derived_start);
+  derived_phi->AddInput(derived_update);
+
+  derived_ivs->push_back(DerivedIV { factor, derived_phi, derived_update });
+  return &derived_ivs->back();
+}
+
+void HLoopStrengthReduction::ReduceStrength(HLoopInformation_X86* loop,
+                                            HInductionVariable* biv,
+                                            DerivedIVs* derived_ivs) {
+  HPhi* phi = biv->GetPhiInsn();
+  HInstruction* update = biv->GetLinearInsn();
+
+  // The phi must only be updated by the linear instruction.
+  if (phi->InputCount() != 2u || loop->PhiInput(phi, true) != update) {
+    return;
+  }
+
+  // Collect the multiplications first: replacing them changes the uses.
+  std::vector<HInstruction*> candidates;
+  for (HInstruction* insn : { static_cast<HInstruction*>(phi), update }) {
+    for (HUseIterator<HInstruction*> it(insn->GetUses()); !it.Done(); it.Advance()) {
+      HInstruction* user = it.Current()->GetUser();
+      int64_t factor = 0;
+      bool after_update = false;
+      if (GetDerivedFactor(loop, biv, user, &factor, &after_update) &&
+          std::find(candidates.begin(), candidates.end(), user) == candidates.end()) {
+        candidates.push_back(user);
+      }
+    }
+  }
+
+  for (HInstruction* candidate : candidates) {
+    int64_t factor = 0;
+    bool after_update = false;
+    bool is_derived = GetDerivedFactor(loop, biv, candidate, &factor, &after_update);
+    DCHECK(is_derived);
+    UNUSED(is_derived);
+
+    DerivedIV* derived_iv = GetOrCreateDerivedIV(loop, biv, factor, derived_ivs);
+    if (derived_iv == nullptr) {
+      continue;
+    }
+
+    candidate->ReplaceWith(after_update ? derived_iv->update : derived_iv->phi);
+    candidate->GetBlock()->RemoveInstruction(candidate);
+    MaybeRecordStat(MethodCompilationStat::kIntelIVStrengthReduced);
+  }
+}
+
+bool HLoopStrengthReduction::ReplaceLoopTest(HLoopInformation_X86* loop,
+                                             HInductionVariable* biv,
+                                             const DerivedIVs& derived_ivs) {
+  // Only int tests can be rewritten: long tests go through an HCompare.
+  if (!loop->HasKnownNumIterations() || !biv->IsInteger()) {
+    return false;
+  }
+
+  HPhi* phi = biv->GetPhiInsn();
+  HInstruction* update = biv->GetLinearInsn();
+  HBasicBlock* exit_block = loop->GetExitBlock();
+  DCHECK(exit_block != nullptr);
+  HIf* loop_if = exit_block->GetPredecessors().Get(0)->GetLastInstruction()->AsIf();
+  DCHECK(loop_if != nullptr);
+  HInstruction* condition = loop_if->InputAt(0);
+  if (!condition->IsCondition() || !condition->HasOnlyOneNonEnvironmentUse()) {
+    return false;
+  }
+
+  // The test must compare the basic IV itself to the bound.
+  HInstruction* compared = nullptr;
+  for (size_t input_idx = 0u; input_idx < 2u; input_idx++) {
+    HInstruction* input = condition->InputAt(input_idx);
+    if (input == phi || input == update) {
+      compared = input;
+    }
+  }
+  if (compared == nullptr) {
+    return false;
+  }
+
+  // The basic IV must only be used by the test and its own update, so that it is removed.
+  for (HUseIterator<HInstruction*> it(phi->GetUses()); !it.Done(); it.Advance()) {
+    HInstruction* user = it.Current()->GetUser();
+    if (user != update && user != condition) {
+      return false;
+    }
+  }
+  for (HUseIterator<HInstruction*> it(update->GetUses()); !it.Done(); it.Advance()) {
+    HInstruction* user = it.Current()->GetUser();
+    if (user != phi && user != condition) {
+      return false;
+    }
+  }
+
+  // The bound information is normalized to "biv < end" for count up loops, and to
+  // "biv > end" for count down loops, both staying in the loop. Find a derived IV
+  // whose values for all the tested values of the basic IV fit in an int.
+  const HLoopBoundInformation& bound_info = loop->GetBoundInformation();
+  int64_t start = bound_info.biv_start_value_;
+  int64_t end = bound_info.biv_end_value_;
+  int64_t increment = biv->GetIncrement();
+  int64_t abs_increment = increment < 0 ? -increment : increment;
+  int64_t lowest = std::min(start, end) - abs_increment;
+  int64_t highest = std::max(start, end) + abs_increment;
+  const DerivedIV* selected = nullptr;
+  for (const DerivedIV& derived_iv : derived_ivs) {
+    int64_t scaled_lowest = lowest * derived_iv.factor;
+    int64_t scaled_highest = highest * derived_iv.factor;
+    if (std::min(scaled_lowest, scaled_highest) >= std::numeric_limits<int32_t>::min() &&
+        std::max(scaled_lowest, scaled_highest) <= std::numeric_limits<int32_t>::max()) {
+      selected = &derived_iv;
+      break;
+    }
+  }
+  if (selected == nullptr) {
+    return false;
+  }
+
+  // A negative factor reverses the order of the values.
+  IfCondition stay_condition = static_cast<IfCondition>(bound_info.comparison_condition_);
+  DCHECK(stay_condition == kCondLT || stay_condition == kCondGT);
+  if (selected->factor < 0) {
+    stay_condition = FlipConditionForOperandSwap(stay_condition);
+  }
+  IfCondition new_condition = loop_if->IfTrueSuccessor() == exit_block
+      ? NegateCondition(stay_condition)
+      : stay_condition;
+
+  HInstruction* derived_compared = (compared == phi) ? selected->phi : selected->update;
+  HConstant* scaled_end = graph_->GetIntConstant(static_cast<int32_t>(end * selected->factor));
+  HCondition* derived_condition =
+      NewCondition(graph_->GetArena(), new_condition, derived_compared, scaled_end);
+  loop_if->GetBlock()->InsertInstructionBefore(derived_condition, loop_if);
+  loop_if->ReplaceInput(derived_condition, 0);
+  condition->GetBlock()->RemoveInstruction(condition);
+
+  // Remove the basic IV: break the cycle between the phi and its update first.
+  phi->RemoveEnvironmentUsers();
+  update->RemoveEnvironmentUsers();
+  phi->ReplaceInput(loop->PhiInput(phi, false), 1u);
+  update->GetBlock()->RemoveInstruction(update);
+  phi->GetBlock()->RemovePhi(phi);
+  return true;
+}
+
+}  // namespace art
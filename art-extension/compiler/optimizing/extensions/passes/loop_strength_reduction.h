@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_STRENGTH_REDUCTION_H_
+#define ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_STRENGTH_REDUCTION_H_
+
+#include <vector>
+
+#include "nodes.h"
+#include "optimization_x86.h"
+
+namespace art {
+
+// Forward declarations.
+class HInductionVariable;
+class HLoopInformation_X86;
+
+/**
+ * @brief Loop Strength Reduction rewrites the multiplications of a basic IV by a constant
+ * into derived IVs that are only updated by additions.
+ * @details For a basic IV "i = i + s" and a multiplication "k * i" in the loop, a new phi
+ * "j" starts at "k * start" in the pre-header and is updated by "j = j + k * s" next to the
+ * update of "i". The multiplications by "k" of "i" and of its update are replaced by "j"
+ * and its update. Shifts by a constant are handled as multiplications by a power of 2.
+ * The arithmetic wraps around like the multiplication does, so the rewrite is always exact.
+ * Linear function test replacement then compares a derived IV to the scaled bound in the
+ * loop exit test, when the bounds are constant and the scaled values cannot overflow. If
+ * the basic IV has no other use, it is removed.
+ */
+class HLoopStrengthReduction : public HOptimization_X86 {
+ public:
+  HLoopStrengthReduction(HGraph* graph, OptimizingCompilerStats* stats = nullptr)
+    : HOptimization_X86(graph, true, kLoopStrengthReductionPassName, stats) {
+      DefineOption("MaxDerivedIVs", OptionContent(2));
+      DefineOption("Enabled", OptionContent(1));
+    }
+
+  void Run() OVERRIDE;
+
+ private:
+  // A derived IV "factor * i", at the start of the iteration and after the update of i.
+  struct DerivedIV {
+    int64_t factor;
+    HPhi* phi;
+    HInstruction* update;
+  };
+  typedef std::vector<DerivedIV> DerivedIVs;
+
+  /**
+   * @brief Is the instruction a multiplication of the basic IV by a constant?
+   * @param loop The loop of the basic IV.
+   * @param biv The basic IV.
+   * @param insn The instruction to check.
+   * @param factor Set to the constant factor.
+   * @param after_update Set to whether the update of the basic IV is multiplied.
+   * @return true if the instruction can be replaced by a derived IV.
+   */
+  bool GetDerivedFactor(HLoopInformation_X86* loop,
+                        HInductionVariable* biv,
+                        HInstruction* insn,
+                        int64_t* factor,
+                        bool* after_update) const;
+
+  /**
+   * @brief Find the derived IV for a factor, or create it.
+   * @param loop The loop of the basic IV.
+   * @param biv The basic IV.
+   * @param factor The factor of the derived IV.
+   * @param derived_ivs The derived IVs of the basic IV.
+   * @return The derived IV, or nullptr if too many derived IVs have been created.
+   */
+  DerivedIV* GetOrCreateDerivedIV(HLoopInformation_X86* loop,
+                                  HInductionVariable* biv,
+                                  int64_t factor,
+                                  DerivedIVs* derived_ivs);
+
+  /**
+   * @brief Replace the multiplications of a basic IV by derived IVs.
+   * @param loop The loop of the basic IV.
+   * @param biv The basic IV.
+   * @param derived_ivs Filled with the derived IVs.
+   */
+  void ReduceStrength(HLoopInformation_X86* loop,
+                      HInductionVariable* biv,
+                      DerivedIVs* derived_ivs);
+
+  /**
+   * @brief Compare a derived IV in the loop exit test, and remove the basic IV.
+   * @param loop The loop of the basic IV.
+   * @param biv The basic IV, which must be the IV of the loop bound information.
+   * @param derived_ivs The derived IVs of the basic IV.
+   * @return true if the loop exit test has been replaced.
+   */
+  bool ReplaceLoopTest(HLoopInformation_X86* loop,
+                       HInductionVariable* biv,
+                       const DerivedIVs& derived_ivs);
+
+  static constexpr const char* kLoopStrengthReductionPassName = "loop_strength_reduction";
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_STRENGTH_REDUCTION_H_
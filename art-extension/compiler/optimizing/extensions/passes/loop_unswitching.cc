@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <vector>
+
+#include "dead_code_elimination.h"
+#include "ext_utility.h"
+#include "find_ivs.h"
+#include "graph_x86.h"
+#include "loop_formation.h"
+#include "loop_iterators.h"
+#include "loop_unswitching.h"
+
+namespace art {
+
+/**
+ * @brief Is the condition computed in the loop from loop invariant values only?
+ * @param loop The loop containing the condition.
+ * @param condition The condition to check.
+ * @return true if the condition can be moved to the pre-header of the loop.
+ */
+static bool IsHoistableCondition(HLoopInformation_X86* loop, HInstruction* condition) {
+  if (!condition->IsCondition() || condition->CanThrow() || condition->HasSideEffects()) {
+    return false;
+  }
+
+  for (size_t input_idx = 0u; input_idx != condition->InputCount(); input_idx++) {
+    if (loop->Contains(*condition->InputAt(input_idx)->GetBlock())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Replace the condition of the branches of a loop on a given condition.
+ * @param loop The loop whose branches are updated.
+ * @param condition The condition of the branches to update.
+ * @param constant The constant replacing the condition.
+ */
+static void SetConstantCondition(HLoopInformation_X86* loop,
+                                 HInstruction* condition,
+                                 HIntConstant* constant) {
+  for (HBlocksInLoopIterator it_loop(*loop); !it_loop.Done(); it_loop.Advance()) {
+    HInstruction* last = it_loop.Current()->GetLastInstruction();
+    if (last->IsIf() && last->InputAt(0) == condition) {
+      last->ReplaceInput(constant, 0);
+    }
+  }
+}
+
+void HLoopUnswitching::Run() {
+  HGraph_X86* graph = GRAPH_TO_GRAPH_X86(graph_);
+
+  if (GetOption("Enabled").AsInt() != 1) {
+    return;
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "Begin " << GetMethodName(graph));
+
+  // Collect the candidates first: unswitching changes the loop hierarchy.
+  std::vector<HLoopInformation_X86*> candidates;
+  HLoopInformation_X86* loop_start = graph->GetLoopInformation();
+  for (HOnlyInnerLoopIterator it(loop_start); !it.Done(); it.Advance()) {
+    HLoopInformation_X86* loop = it.Current();
+    if (Gate(loop) != nullptr) {
+      candidates.push_back(loop);
+    }
+  }
+
+  for (HLoopInformation_X86* loop : candidates) {
+    HInstruction* condition = Gate(loop);
+    DCHECK(condition != nullptr);
+    Unswitch(loop, condition);
+    MaybeRecordStat(MethodCompilationStat::kIntelLoopUnswitched);
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << loop->GetHeader()->GetBlockId()
+      << " of method " << GetMethodName(graph)
+      << " has been successfully unswitched on " << condition->DebugName()
+      << " " << condition->GetId());
+  }
+
+  if (!candidates.empty()) {
+    // Remove the arms that are dead in each version.
+    HDeadCodeElimination dce(graph, stats_);
+    dce.Run();
+
+    // Rebuild the loop hierarchy and the IVs to take the copies into account.
+    HLoopFormation form_loops(graph);
+    form_loops.Run();
+    HFindInductionVariables find_ivs(graph, nullptr);
+    find_ivs.Run();
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "End " << GetMethodName(graph));
+}
+
+HInstruction* HLoopUnswitching::Gate(HLoopInformation_X86* loop) {
+  DCHECK(loop != nullptr);
+
+  if (!loop->IsInner()) {
+    return nullptr;
+  }
+
+  // Both versions are kept, so the loop size is a code size budget.
+  if (static_cast<uint64_t>(GetOption("MaxInstructions").AsInt()) <
+      loop->CountInstructionsInBody()) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << loop->GetHeader()->GetBlockId()
+      << " is too big to be unswitched");
+    return nullptr;
+  }
+
+  // Look for the first branch that stays in the loop and whose condition is loop invariant.
+  HInstruction* condition = nullptr;
+  for (HBlocksInLoopReversePostOrderIterator it_loop(*loop);
+       !it_loop.Done() && condition == nullptr;
+       it_loop.Advance()) {
+    HBasicBlock* block = it_loop.Current();
+    HInstruction* last = block->GetLastInstruction();
+    if (!last->IsIf() ||
+        !loop->Contains(*block->GetSuccessors().Get(0)) ||
+        !loop->Contains(*block->GetSuccessors().Get(1))) {
+      continue;
+    }
+
+    HInstruction* input = last->InputAt(0);
+    if (input->IsConstant()) {
+      // Dead code elimination takes care of it.
+      continue;
+    }
+
+    if (!loop->Contains(*input->GetBlock()) || IsHoistableCondition(loop, input)) {
+      condition = input;
+    }
+  }
+
+  if (condition == nullptr || !loop->IsVersionable(this)) {
+    return nullptr;
+  }
+
+  return condition;
+}
+
+void HLoopUnswitching::Unswitch(HLoopInformation_X86* loop, HInstruction* condition) {
+  HGraph_X86* graph = GRAPH_TO_GRAPH_X86(graph_);
+
+  if (loop->Contains(*condition->GetBlock())) {
+    // The condition only depends on values defined before the loop.
+    HBasicBlock* pre_header = loop->GetPreHeader();
+    condition->MoveBefore(pre_header->GetLastInstruction());
+  }
+
+  // The original loop runs when the condition holds, and the copy otherwise.
+  GrowableArray<HInstruction*> guards(graph->GetArena(), 1u);
+  guards.Add(condition);
+  HLoopInformation_X86* copy = loop->Version(guards);
+
+  SetConstantCondition(loop, condition, graph->GetIntConstant(1));
+  SetConstantCondition(copy, condition, graph->GetIntConstant(0));
+}
+
+}  // namespace art
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_UNSWITCHING_H_
+#define ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_UNSWITCHING_H_
+
+#include "nodes.h"
+#include "optimization_x86.h"
+
+namespace art {
+
+// Forward declarations.
+class HLoopInformation_X86;
+
+/**
+ * @brief Loop Unswitching moves a branch on a loop invariant condition out of the loop.
+ * @details The loop is versioned on the condition: the original loop runs when it is
+ * true and the copy when it is false. The branch then has a constant condition in
+ * both versions, and dead code elimination leaves one arm in each of them. Since the
+ * loop is duplicated, its size is limited by a code size budget.
+ * The pass runs before loop_versioning and loop_vectorization, as well as before
+ * trivial_loop_evaluator, non_temporal_move and loop_full_unrolling, which are
+ * more likely to handle loops without control flow.
+ */
+class HLoopUnswitching : public HOptimization_X86 {
+ public:
+  HLoopUnswitching(HGraph* graph, OptimizingCompilerStats* stats = nullptr)
+    : HOptimization_X86(graph, true, kLoopUnswitchingPassName, stats) {
+      DefineOption("MaxInstructions", OptionContent(50));
+      DefineOption("Enabled", OptionContent(1));
+    }
+
+  void Run() OVERRIDE;
+
+ private:
+  /**
+   * @brief Find a branch of the loop on a loop invariant condition.
+   * @param loop The inner loop to check.
+   * @return The condition, or nullptr if the loop cannot be unswitched.
+   */
+  HInstruction* Gate(HLoopInformation_X86* loop);
+
+  /**
+   * @brief Version the loop on the condition, and make the condition
+   * constant in both versions.
+   * @param loop The loop that passed Gate.
+   * @param condition The condition returned by Gate.
+   */
+  void Unswitch(HLoopInformation_X86* loop, HInstruction* condition);
+
+  static constexpr const char* kLoopUnswitchingPassName = "loop_unswitching";
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_UNSWITCHING_H_
@@ -0,0 +1,601 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "arch/x86/instruction_set_features_x86.h"
+#include "cloning.h"
+#include "ext_utility.h"
+#include "find_ivs.h"
+#include "graph_x86.h"
+#include "loop_formation.h"
+#include "loop_iterators.h"
+#include "loop_vectorization.h"
+
+namespace art {
+
+// Packed values are confined to the vector loop body, and must never be spilled.
+static constexpr size_t kMaxLivePackedValues = 4;
+
+// The XMM registers of x86, shared by the packed values and the scalar floating point
+// values live across the vector loop.
+static constexpr size_t kMaxLiveFpValues = 8;
+
+/**
+ * @brief Count the scalar floating point values live across a loop.
+ * @details They are defined before the loop and used in it or after it, so they keep an
+ * XMM register busy during the whole vector loop, unless the register allocator spills them.
+ * A use in a block that does not dominate the pre-header is conservatively counted.
+ * @param graph The graph containing the loop.
+ * @param loop The loop being checked.
+ * @return the number of floating point values live across the loop.
+ */
+static size_t CountFpValuesLiveAcross(HGraph* graph, HLoopInformation_X86* loop) {
+  HBasicBlock* pre_header = loop->GetPreHeader();
+  size_t count = 0;
+  auto is_live_across = [pre_header](HInstruction* instruction) {
+    if (!Primitive::IsFloatingPointType(instruction->GetType())) {
+      return false;
+    }
+    for (HUseIterator<HInstruction*> it(instruction->GetUses()); !it.Done(); it.Advance()) {
+      if (!it.Current()->GetUser()->GetBlock()->Dominates(pre_header)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  const GrowableArray<HBasicBlock*>& blocks = graph->GetBlocks();
+  for (size_t i = 0, e = blocks.Size(); i < e; i++) {
+    HBasicBlock* block = blocks.Get(i);
+    if (block == nullptr || !block->Dominates(pre_header)) {
+      continue;
+    }
+    for (HInstructionIterator it(block->GetPhis()); !it.Done(); it.Advance()) {
+      count += is_live_across(it.Current()) ? 1 : 0;
+    }
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      count += is_live_across(it.Current()) ? 1 : 0;
+    }
+  }
+  return count;
+}
+
+/**
+ * @brief Get the type of the lanes used to handle elements of a given type.
+ * @details Loads, stores and the supported integer operations do not depend on the sign,
+ * so char and short elements share the same lanes.
+ * @param type The type of the element.
+ * @return the lane type, or kPrimVoid if the type cannot be vectorized.
+ */
+static Primitive::Type GetLaneType(Primitive::Type type) {
+  switch (type) {
+    case Primitive::kPrimByte:
+    case Primitive::kPrimInt:
+    case Primitive::kPrimFloat:
+      return type;
+    case Primitive::kPrimChar:
+    case Primitive::kPrimShort:
+      return Primitive::kPrimShort;
+    default:
+      return Primitive::kPrimVoid;
+  }
+}
+
+/**
+ * @brief Merge the lane type of an array access into the lane type of the loop.
+ * @param packed_type The lane type of the loop so far, kPrimVoid if unknown yet.
+ * @param type The element type of the array access.
+ * @return false if the access cannot share the lanes of the other accesses.
+ */
+static bool MergeLaneType(Primitive::Type* packed_type, Primitive::Type type) {
+  Primitive::Type lane_type = GetLaneType(type);
+  if (lane_type == Primitive::kPrimVoid) {
+    return false;
+  }
+  if (*packed_type == Primitive::kPrimVoid) {
+    *packed_type = lane_type;
+  }
+  return *packed_type == lane_type;
+}
+
+static bool GetPackedOperationKind(HInstruction* instruction,
+                                   HX86PackedBinaryOperation::OperationKind* kind) {
+  switch (instruction->GetKind()) {
+    case HInstruction::kAdd:
+      *kind = HX86PackedBinaryOperation::kAdd;
+      return true;
+    case HInstruction::kSub:
+      *kind = HX86PackedBinaryOperation::kSub;
+      return true;
+    case HInstruction::kMul:
+      *kind = HX86PackedBinaryOperation::kMul;
+      return true;
+    case HInstruction::kAnd:
+      *kind = HX86PackedBinaryOperation::kAnd;
+      return true;
+    case HInstruction::kOr:
+      *kind = HX86PackedBinaryOperation::kOr;
+      return true;
+    case HInstruction::kXor:
+      *kind = HX86PackedBinaryOperation::kXor;
+      return true;
+    default:
+      return false;
+  }
+}
+
+void HLoopVectorization::Run() {
+  HGraph_X86* graph = GRAPH_TO_GRAPH_X86(graph_);
+
+  if (GetOption("Enabled").AsInt() != 1) {
+    return;
+  }
+
+  InstructionSet isa = graph->GetInstructionSet();
+  if (isa != kX86 && isa != kX86_64) {
+    return;
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "Begin " << GetMethodName(graph));
+
+  // The IVs and bounds must be up to date: BCE and LICM ran since find_ivs.
+  HFindInductionVariables find_ivs(graph, nullptr);
+  find_ivs.Run();
+
+  // Collect the candidates first: vectorizing changes the loop hierarchy.
+  std::vector<std::pair<HLoopInformation_X86*, Primitive::Type>> candidates;
+  HLoopInformation_X86* loop_start = graph->GetLoopInformation();
+  for (HOnlyInnerLoopIterator it(loop_start); !it.Done(); it.Advance()) {
+    HLoopInformation_X86* loop = it.Current();
+    Primitive::Type packed_type = Primitive::kPrimVoid;
+    if (Gate(loop, &packed_type)) {
+      candidates.push_back(std::make_pair(loop, packed_type));
+    }
+  }
+
+  for (auto candidate : candidates) {
+    HLoopInformation_X86* loop = candidate.first;
+    Vectorize(loop, candidate.second);
+    MaybeRecordStat(MethodCompilationStat::kIntelLoopVectorized);
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << loop->GetHeader()->GetBlockId()
+      << " of method " << GetMethodName(graph)
+      << " has been vectorized with " << Primitive::PrettyDescriptor(candidate.second)
+      << " lanes");
+  }
+
+  if (!candidates.empty()) {
+    // Rebuild the loop hierarchy and the IVs to take the vector loops into account.
+    HLoopFormation form_loops(graph);
+    form_loops.Run();
+    find_ivs.Run();
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "End " << GetMethodName(graph));
+}
+
+bool HLoopVectorization::Gate(HLoopInformation_X86* loop, Primitive::Type* packed_type) const {
+  DCHECK(loop != nullptr);
+
+  // Only a top tested loop made of its header and a single body block is handled.
+  if (!loop->IsInner() ||
+      loop->NumberOfBlocks() != 2 ||
+      loop->NumberOfBackEdges() != 1 ||
+      !loop->HasOneExitEdge()) {
+    return false;
+  }
+
+  HBasicBlock* header = loop->GetHeader();
+  HBasicBlock* body = loop->GetBackEdges().Get(0);
+  HBasicBlock* pre_header = loop->GetPreHeader();
+  if (body == header ||
+      pre_header == nullptr ||
+      pre_header->GetSuccessors().Size() != 1 ||
+      !header->GetLastInstruction()->IsIf() ||
+      !body->GetLastInstruction()->IsGoto()) {
+    return false;
+  }
+
+  if (static_cast<uint64_t>(GetOption("MaxInstructions").AsInt()) <
+      loop->CountInstructionsInBody()) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << header->GetBlockId()
+      << " is too big to be vectorized");
+    return false;
+  }
+
+  // The loop must count up by one to a loop invariant bound: for (i = start; i < n; i++).
+  const HLoopBoundInformation& bound_info = loop->GetBoundInformation();
+  HInductionVariable* biv = bound_info.loop_biv_;
+  if (biv == nullptr ||
+      !bound_info.is_simple_count_up_ ||
+      bound_info.comparison_condition_ != kCondLT ||
+      !biv->IsBasicAndIncrementOf1() ||
+      biv->IsFP() ||
+      biv->GetPhiInsn()->GetType() != Primitive::kPrimInt ||
+      biv->GetLinearInsn()->GetBlock() != body ||
+      bound_info.loop_bound_ == nullptr ||
+      bound_info.loop_bound_->GetType() != Primitive::kPrimInt) {
+    return false;
+  }
+
+  // The header must only hold the IV, the suspend check and the loop test, since the
+  // vector loop does not copy anything else.
+  HPhi* phi = biv->GetPhiInsn();
+  HInstruction* bound = bound_info.loop_bound_;
+  if (header->GetFirstPhi() != phi || header->GetLastPhi() != phi) {
+    return false;
+  }
+
+  HInstruction* condition = header->GetLastInstruction()->InputAt(0);
+  if (!condition->IsCondition() ||
+      condition->GetBlock() != header ||
+      !condition->HasOnlyOneNonEnvironmentUse()) {
+    return false;
+  }
+
+  bool iv_first = condition->InputAt(0) == phi && condition->InputAt(1) == bound;
+  bool iv_second = condition->InputAt(0) == bound && condition->InputAt(1) == phi;
+  if (!iv_first && !iv_second) {
+    return false;
+  }
+
+  for (HInstructionIterator it(header->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (!instruction->IsSuspendCheck() &&
+        instruction != condition &&
+        !instruction->IsIf()) {
+      return false;
+    }
+  }
+
+  if (!GateBody(loop, packed_type)) {
+    return false;
+  }
+
+  // A loop known to run fewer iterations than the number of lanes gains nothing.
+  int32_t lanes = kX86PackedVectorSize / Primitive::ComponentSize(*packed_type);
+  if (loop->HasKnownNumIterations() && loop->GetNumIterations(header) < lanes) {
+    return false;
+  }
+
+  return GateRegisterPressure(loop);
+}
+
+bool HLoopVectorization::GateBody(HLoopInformation_X86* loop,
+                                  Primitive::Type* packed_type) const {
+  HBasicBlock* body = loop->GetBackEdges().Get(0);
+  HInductionVariable* biv = loop->GetBoundInformation().loop_biv_;
+  HPhi* phi = biv->GetPhiInsn();
+  HInstruction* increment = biv->GetLinearInsn();
+
+  // Values of the body which have a packed equivalent.
+  std::set<HInstruction*> packed_values;
+  bool has_store = false;
+  bool has_integer_operation = false;
+  bool has_float_operation = false;
+  bool has_mul = false;
+  size_t min_conversion_size = kX86PackedVectorSize;
+
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+
+    if (instruction == increment || instruction->IsGoto()) {
+      continue;
+    }
+
+    if (instruction->IsArrayGet()) {
+      HArrayGet* array_get = instruction->AsArrayGet();
+      if (array_get->GetIndex() != phi ||
+          loop->Contains(*array_get->GetArray()->GetBlock()) ||
+          !MergeLaneType(packed_type, array_get->GetType())) {
+        return false;
+      }
+      packed_values.insert(array_get);
+    } else if (instruction->IsArraySet()) {
+      HArraySet* array_set = instruction->AsArraySet();
+      HInstruction* value = array_set->GetValue();
+      if (array_set->GetIndex() != phi ||
+          array_set->NeedsTypeCheck() ||
+          loop->Contains(*array_set->GetArray()->GetBlock()) ||
+          !MergeLaneType(packed_type, array_set->GetComponentType())) {
+        return false;
+      }
+      if (packed_values.count(value) == 0 && loop->Contains(*value->GetBlock())) {
+        return false;
+      }
+      has_store = true;
+    } else if (instruction->IsTypeConversion()) {
+      // Narrowing an int is free as long as the result is not narrower than a lane.
+      HInstruction* input = instruction->InputAt(0);
+      Primitive::Type result_type = instruction->GetType();
+      if (input->GetType() != Primitive::kPrimInt ||
+          packed_values.count(input) == 0 ||
+          (result_type != Primitive::kPrimByte &&
+           result_type != Primitive::kPrimShort &&
+           result_type != Primitive::kPrimChar)) {
+        return false;
+      }
+      min_conversion_size = std::min(min_conversion_size,
+                                     Primitive::ComponentSize(result_type));
+      packed_values.insert(instruction);
+    } else {
+      HX86PackedBinaryOperation::OperationKind kind;
+      if (!GetPackedOperationKind(instruction, &kind)) {
+        return false;
+      }
+
+      Primitive::Type type = instruction->GetType();
+      if (type == Primitive::kPrimInt) {
+        has_integer_operation = true;
+      } else if (type == Primitive::kPrimFloat) {
+        has_float_operation = true;
+      } else {
+        return false;
+      }
+      has_mul = has_mul || (kind == HX86PackedBinaryOperation::kMul);
+
+      // Each operand is either packed already or replicated from a loop invariant.
+      bool has_packed_input = false;
+      for (size_t i = 0, e = instruction->InputCount(); i < e; ++i) {
+        HInstruction* input = instruction->InputAt(i);
+        if (packed_values.count(input) != 0) {
+          has_packed_input = true;
+        } else if (loop->Contains(*input->GetBlock())) {
+          return false;
+        }
+      }
+      if (!has_packed_input) {
+        return false;
+      }
+      packed_values.insert(instruction);
+    }
+  }
+
+  if (!has_store || *packed_type == Primitive::kPrimVoid) {
+    return false;
+  }
+
+  // Operations and accesses must agree on integer or float lanes.
+  bool float_lanes = (*packed_type == Primitive::kPrimFloat);
+  if ((float_lanes && has_integer_operation) || (!float_lanes && has_float_operation)) {
+    return false;
+  }
+
+  if (min_conversion_size < Primitive::ComponentSize(*packed_type)) {
+    return false;
+  }
+
+  if (has_mul) {
+    // There is no packed byte multiplication, and pmulld requires SSE4.1.
+    if (*packed_type == Primitive::kPrimByte) {
+      return false;
+    }
+    if (*packed_type == Primitive::kPrimInt &&
+        !isa_features_->AsX86InstructionSetFeatures()->HasSSE4_1()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool HLoopVectorization::GateRegisterPressure(HLoopInformation_X86* loop) const {
+  HBasicBlock* body = loop->GetBackEdges().Get(0);
+  HInstruction* increment = loop->GetBoundInformation().loop_biv_->GetLinearInsn();
+
+  // The scalar floating point values live across the loop compete for the same registers.
+  const size_t live_scalars = CountFpValuesLiveAcross(graph_, loop);
+  if (live_scalars + 1 > kMaxLiveFpValues) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << loop->GetHeader()->GetBlockId()
+      << " keeps " << live_scalars << " floating point values live across it");
+    return false;
+  }
+
+  // Number the body instructions: GateBody made sure they all have a packed equivalent.
+  std::map<HInstruction*, size_t> positions;
+  size_t nb_positions = 0;
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    positions[it.Current()] = nb_positions++;
+  }
+
+  // For each position, record whether it defines a packed value, the last use of that
+  // value, and the number of loop invariants replicated for it.
+  std::vector<bool> defines_packed(nb_positions, false);
+  std::vector<size_t> last_use(nb_positions, 0);
+  std::vector<size_t> replicates(nb_positions, 0);
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    size_t position = positions[instruction];
+
+    // Conversions are free and the array and index of accesses are not packed.
+    if (instruction == increment ||
+        instruction->IsGoto() ||
+        instruction->IsTypeConversion() ||
+        instruction->IsArrayGet()) {
+      defines_packed[position] = instruction->IsArrayGet();
+      continue;
+    }
+
+    defines_packed[position] = !instruction->IsArraySet();
+    size_t first_input = instruction->IsArraySet() ? 2 : 0;
+    for (size_t i = first_input, e = instruction->InputCount(); i < e; ++i) {
+      HInstruction* input = instruction->InputAt(i);
+      while (input->IsTypeConversion() && input->GetBlock() == body) {
+        input = input->InputAt(0);
+      }
+      if (input->GetBlock() == body) {
+        size_t input_position = positions[input];
+        last_use[input_position] = std::max(last_use[input_position], position);
+      } else {
+        replicates[position]++;
+      }
+    }
+  }
+
+  // At each position, the packed inputs still needed, the replicates and the result
+  // must all fit in registers.
+  for (size_t position = 0; position < nb_positions; position++) {
+    size_t live = replicates[position] + (defines_packed[position] ? 1 : 0);
+    for (size_t def = 0; def < position; def++) {
+      if (defines_packed[def] && last_use[def] >= position) {
+        live++;
+      }
+    }
+    if (live > kMaxLivePackedValues || live + live_scalars > kMaxLiveFpValues) {
+      PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << loop->GetHeader()->GetBlockId()
+        << " needs too many packed registers to be vectorized");
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void HLoopVectorization::Vectorize(HLoopInformation_X86* loop, Primitive::Type packed_type) {
+  HGraph_X86* graph = GRAPH_TO_GRAPH_X86(graph_);
+  ArenaAllocator* arena = graph->GetArena();
+  const int32_t lanes = kX86PackedVectorSize / Primitive::ComponentSize(packed_type);
+
+  HBasicBlock* header = loop->GetHeader();
+  HBasicBlock* body = loop->GetBackEdges().Get(0);
+  HBasicBlock* pre_header = loop->GetPreHeader();
+  HInductionVariable* biv = loop->GetBoundInformation().loop_biv_;
+  HPhi* phi = biv->GetPhiInsn();
+  HInstruction* increment = biv->GetLinearInsn();
+  uint32_t dex_pc = header->GetDexPc();
+
+  HInstruction* vector_bound = loop->BuildReducedBound(lanes - 1);
+
+  // The new control flow is: pre_header -> vector_header -> vector_exit -> header,
+  // with the vector_body going back to the vector_header.
+  HBasicBlock* vector_header = graph->CreateNewBasicBlock(dex_pc);
+  HBasicBlock* vector_body = graph->CreateNewBasicBlock(dex_pc);
+  HBasicBlock* vector_exit = graph->CreateNewBasicBlock(dex_pc);
+  vector_exit->InsertBetween(pre_header, header);
+  vector_header->InsertBetween(pre_header, vector_exit);
+  vector_header->AddSuccessor(vector_body);
+  vector_body->AddSuccessor(vector_header);
+  vector_exit->AddInstruction(new (arena) HGoto());
+
+  // The vector IV starts where the original loop used to start.
+  DCHECK_EQ(header->GetPredecessors().Get(0), vector_exit);
+  HPhi* vector_phi = new (arena) HPhi(arena, phi->GetRegNumber(), 0, Primitive::kPrimInt);
+  vector_header->AddPhi(vector_phi);
+  vector_phi->AddInput(phi->InputAt(0));
+
+  // Copy the suspend check so that the vector loop can still be interrupted.
+  HInstructionCloner cloner(graph, nullptr);
+  cloner.AddCloneManually(phi, vector_phi);
+  HSuspendCheck* vector_suspend_check = nullptr;
+  for (HInstructionIterator it(header->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+    if (instruction->IsSuspendCheck()) {
+      instruction->Accept(&cloner);
+      vector_suspend_check = cloner.GetClone(instruction)->AsSuspendCheck();
+      vector_header->AddInstruction(vector_suspend_check);
+    }
+  }
+
+  HInstruction* vector_condition = new (arena) HGreaterThanOrEqual(vector_phi, vector_bound);
+  vector_header->AddInstruction(vector_condition);
+  vector_header->AddInstruction(new (arena) HIf(vector_condition));
+
+  // Fill the vector body, in the order of the original body.
+  std::map<HInstruction*, HInstruction*> packed_values;
+  auto get_packed_input = [&](HInstruction* input) -> HInstruction* {
+    auto it = packed_values.find(input);
+    if (it != packed_values.end()) {
+      return it->second;
+    }
+    HInstruction* replicate = new (arena) HX86PackedReplicate(input, packed_type);
+    vector_body->AddInstruction(replicate);
+    return replicate;
+  };
+
+  for (HInstructionIterator it(body->GetInstructions()); !it.Done(); it.Advance()) {
+    HInstruction* instruction = it.Current();
+
+    if (instruction == increment || instruction->IsGoto()) {
+      continue;
+    }
+
+    if (instruction->IsArrayGet()) {
+      HArrayGet* array_get = instruction->AsArrayGet();
+      HInstruction* packed = new (arena) HX86PackedArrayGet(array_get->GetArray(),
+                                                            vector_phi,
+                                                            packed_type,
+                                                            array_get->GetDexPc());
+      vector_body->AddInstruction(packed);
+      packed_values[instruction] = packed;
+    } else if (instruction->IsArraySet()) {
+      HArraySet* array_set = instruction->AsArraySet();
+      HInstruction* value = get_packed_input(array_set->GetValue());
+      vector_body->AddInstruction(new (arena) HX86PackedArraySet(array_set->GetArray(),
+                                                                 vector_phi,
+                                                                 value,
+                                                                 packed_type,
+                                                                 array_set->GetDexPc()));
+    } else if (instruction->IsTypeConversion()) {
+      packed_values[instruction] = packed_values[instruction->InputAt(0)];
+    } else {
+      HX86PackedBinaryOperation::OperationKind kind;
+      bool is_packed_operation = GetPackedOperationKind(instruction, &kind);
+      DCHECK(is_packed_operation);
+      UNUSED(is_packed_operation);
+      HInstruction* left = get_packed_input(instruction->InputAt(0));
+      HInstruction* right = get_packed_input(instruction->InputAt(1));
+      HInstruction* packed =
+          new (arena) HX86PackedBinaryOperation(kind, packed_type, left, right);
+      vector_body->AddInstruction(packed);
+      packed_values[instruction] = packed;
+    }
+  }
+
+  HInstruction* vector_increment =
+      new (arena) HAdd(Primitive::kPrimInt, vector_phi, graph->GetIntConstant(lanes));
+  vector_body->AddInstruction(vector_increment);
+  vector_body->AddInstruction(new (arena) HGoto());
+  vector_phi->AddInput(vector_increment);
+
+  // The original loop is now the remainder loop: it starts where the vector loop ended.
+  phi->ReplaceInput(vector_phi, 0);
+
+  // Register the new blocks in the outer loops, then create the vector loop.
+  HLoopInformation_X86* outer = loop->GetParent();
+  if (outer != nullptr) {
+    outer->AddToAll(vector_exit);
+    for (HLoopInformation_X86* current = outer;
+         current != nullptr;
+         current = current->GetParent()) {
+      static_cast<HLoopInformation*>(current)->Add(vector_header);
+      static_cast<HLoopInformation*>(current)->Add(vector_body);
+    }
+  }
+
+  vector_header->AddBackEdge(vector_body);
+  graph->RebuildDomination();
+
+  HLoopInformation_X86* vector_loop =
+      LOOPINFO_TO_LOOPINFO_X86(vector_header->GetLoopInformation());
+  bool is_natural = vector_loop->Populate();
+  DCHECK(is_natural);
+  UNUSED(is_natural);
+  vector_loop->SetSuspendCheck(vector_suspend_check);
+}
+
+}  // namespace art
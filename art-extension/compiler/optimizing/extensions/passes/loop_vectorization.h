@@ -0,0 +1,95 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_VECTORIZATION_H_
+#define ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_VECTORIZATION_H_
+
+#include "nodes.h"
+#include "optimization_x86.h"
+
+namespace art {
+
+// Forward declarations.
+class HLoopInformation_X86;
+class InstructionSetFeatures;
+
+/**
+ * @brief Loop Vectorization rewrites simple inner loops over arrays with SSE packed
+ * instructions.
+ * @details The candidate is a top tested loop made of a header and a single body block,
+ * counting up by one to a loop invariant bound, where every array access is indexed by
+ * the basic IV and no bounds or null checks remain. A vector copy of the loop, which
+ * handles 4, 8 or 16 elements per iteration, is inserted before the original loop. The
+ * original loop then becomes the remainder loop: it starts where the vector loop stopped.
+ * Since every iteration only touches the element at its own index, iterations are
+ * independent and no alias analysis is needed.
+ * The pass runs before form_bottom_loops so that the remainder loop keeps its
+ * entry test.
+ */
+class HLoopVectorization : public HOptimization_X86 {
+ public:
+  HLoopVectorization(HGraph* graph,
+                     const InstructionSetFeatures* isa_features,
+                     OptimizingCompilerStats* stats = nullptr)
+    : HOptimization_X86(graph, true, kLoopVectorizationPassName, stats),
+      isa_features_(isa_features) {
+      DefineOption("MaxInstructions", OptionContent(50));
+      DefineOption("Enabled", OptionContent(1));
+    }
+
+  void Run() OVERRIDE;
+
+ private:
+  /**
+   * @brief Check whether the loop can be vectorized.
+   * @param loop The inner loop to check.
+   * @param packed_type Set to the type of a lane on success.
+   * @return true if Vectorize can be applied to the loop.
+   */
+  bool Gate(HLoopInformation_X86* loop, Primitive::Type* packed_type) const;
+
+  /**
+   * @brief Check the body instructions of a loop that passed the shape checks of Gate.
+   * @param loop The loop being checked.
+   * @param packed_type Set to the type of a lane on success.
+   * @return true if every body instruction has a packed equivalent.
+   */
+  bool GateBody(HLoopInformation_X86* loop, Primitive::Type* packed_type) const;
+
+  /**
+   * @brief Check that the packed body does not keep too many XMM registers busy.
+   * @details Packed values must never be spilled, since spill slots only hold 64 bits.
+   * The scalar floating point values live across the loop use the same registers.
+   * @param loop The loop being checked.
+   * @return true if the number of simultaneously live XMM values is small enough.
+   */
+  bool GateRegisterPressure(HLoopInformation_X86* loop) const;
+
+  /**
+   * @brief Insert the vector loop in front of the loop.
+   * @param loop The loop that passed Gate.
+   * @param packed_type The type of a lane.
+   */
+  void Vectorize(HLoopInformation_X86* loop, Primitive::Type packed_type);
+
+  const InstructionSetFeatures* isa_features_;
+
+  static constexpr const char* kLoopVectorizationPassName = "loop_vectorization";
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_VECTORIZATION_H_
@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <set>
+
+#include "ext_utility.h"
+#include "find_ivs.h"
+#include "graph_x86.h"
+#include "induction_variable.h"
+#include "loop_formation.h"
+#include "loop_iterators.h"
+#include "loop_versioning.h"
+
+namespace art {
+
+/**
+ * @brief Get the array whose length a bounds check compares against.
+ * @param loop The loop containing the bounds check.
+ * @param bounds_check The bounds check.
+ * @return The array, or nullptr if it is not a loop invariant array. A null
+ * check of the array inside the loop is skipped.
+ */
+static HInstruction* GetCheckedArray(HLoopInformation_X86* loop, HBoundsCheck* bounds_check) {
+  HInstruction* length = bounds_check->InputAt(1);
+  if (!length->IsArrayLength()) {
+    return nullptr;
+  }
+
+  HInstruction* array = length->InputAt(0);
+  if (array->IsNullCheck() && loop->Contains(*array->GetBlock())) {
+    array = array->InputAt(0);
+  }
+  return loop->Contains(*array->GetBlock()) ? nullptr : array;
+}
+
+/**
+ * @brief Get the offset of an index from the basic IV.
+ * @param index The index of a bounds check.
+ * @param phi The phi of the basic IV.
+ * @param offset Set to c when the index is phi + c.
+ * @return true if the index is the basic IV plus a constant.
+ */
+static bool GetIndexOffset(HInstruction* index, HPhi* phi, int32_t* offset) {
+  if (index == phi) {
+    *offset = 0;
+    return true;
+  }
+
+  if (!index->IsAdd() && !index->IsSub()) {
+    return false;
+  }
+
+  HBinaryOperation* operation = index->AsBinaryOperation();
+  HConstant* constant = operation->GetConstantRight();
+  if (constant == nullptr ||
+      !constant->IsIntConstant() ||
+      operation->GetLeastConstantLeft() != phi) {
+    return false;
+  }
+
+  // Keep the offset away from the extremes, so that it can be negated.
+  int32_t value = constant->AsIntConstant()->GetValue();
+  if (value == std::numeric_limits<int32_t>::min()) {
+    return false;
+  }
+  *offset = index->IsAdd() ? value : -value;
+  return true;
+}
+
+void HLoopVersioning::Run() {
+  HGraph_X86* graph = GRAPH_TO_GRAPH_X86(graph_);
+
+  if (GetOption("Enabled").AsInt() != 1) {
+    return;
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "Begin " << GetMethodName(graph));
+
+  // The IVs and bounds must be up to date: BCE and LICM ran since find_ivs.
+  HFindInductionVariables find_ivs(graph, nullptr);
+  find_ivs.Run();
+
+  // Collect the candidates first: versioning changes the loop hierarchy.
+  std::vector<HLoopInformation_X86*> candidates;
+  HLoopInformation_X86* loop_start = graph->GetLoopInformation();
+  for (HOnlyInnerLoopIterator it(loop_start); !it.Done(); it.Advance()) {
+    HLoopInformation_X86* loop = it.Current();
+    std::vector<HBoundsCheck*> bounds_checks;
+    std::vector<HNullCheck*> null_checks;
+    if (Gate(loop, &bounds_checks, &null_checks)) {
+      candidates.push_back(loop);
+    }
+  }
+
+  for (HLoopInformation_X86* loop : candidates) {
+    std::vector<HBoundsCheck*> bounds_checks;
+    std::vector<HNullCheck*> null_checks;
+    bool gated = Gate(loop, &bounds_checks, &null_checks);
+    DCHECK(gated);
+    UNUSED(gated);
+
+    HLoopInformation_X86* checked_loop = Version(loop, bounds_checks, null_checks);
+    MaybeRecordStat(MethodCompilationStat::kIntelLoopVersioned);
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << loop->GetHeader()->GetBlockId()
+      << " of method " << GetMethodName(graph)
+      << " has been successfully versioned: " << bounds_checks.size()
+      << " bounds checks removed, checked copy is loop #"
+      << checked_loop->GetHeader()->GetBlockId());
+  }
+
+  if (!candidates.empty()) {
+    // Rebuild the loop hierarchy and the IVs to take the copies into account.
+    HLoopFormation form_loops(graph);
+    form_loops.Run();
+    find_ivs.Run();
+  }
+
+  PRINT_PASS_OSTREAM_MESSAGE(this, "End " << GetMethodName(graph));
+}
+
+bool HLoopVersioning::Gate(HLoopInformation_X86* loop,
+                           std::vector<HBoundsCheck*>* bounds_checks,
+                           std::vector<HNullCheck*>* null_checks) {
+  DCHECK(loop != nullptr);
+  DCHECK(bounds_checks != nullptr);
+  DCHECK(null_checks != nullptr);
+
+  if (!loop->IsInner() || loop->NumberOfBackEdges() != 1 || !loop->HasOneExitEdge()) {
+    return false;
+  }
+
+  // The loop must count up by one to a loop invariant bound: for (i = start; i < n; i++).
+  const HLoopBoundInformation& bound_info = loop->GetBoundInformation();
+  HInductionVariable* biv = bound_info.loop_biv_;
+  if (biv == nullptr ||
+      !bound_info.is_simple_count_up_ ||
+      bound_info.comparison_condition_ != kCondLT ||
+      !biv->IsBasicAndIncrementOf1() ||
+      biv->IsFP() ||
+      biv->GetPhiInsn()->GetType() != Primitive::kPrimInt ||
+      bound_info.loop_bound_ == nullptr ||
+      bound_info.loop_bound_->GetType() != Primitive::kPrimInt) {
+    return false;
+  }
+
+  // The loop must exit from its header, on the comparison of the IV with the bound.
+  // Then, start <= i < n holds in every other block of the loop.
+  HBasicBlock* header = loop->GetHeader();
+  HPhi* phi = biv->GetPhiInsn();
+  HInstruction* bound = bound_info.loop_bound_;
+  HInstruction* last = header->GetLastInstruction();
+  if (!last->IsIf() ||
+      (loop->Contains(*header->GetSuccessors().Get(0)) &&
+       loop->Contains(*header->GetSuccessors().Get(1)))) {
+    return false;
+  }
+
+  HInstruction* condition = last->InputAt(0);
+  if (!condition->IsCondition()) {
+    return false;
+  }
+
+  bool iv_first = condition->InputAt(0) == phi && condition->InputAt(1) == bound;
+  bool iv_second = condition->InputAt(0) == bound && condition->InputAt(1) == phi;
+  if (!iv_first && !iv_second) {
+    return false;
+  }
+
+  // Both versions are kept, so the loop size is a code size budget.
+  if (static_cast<uint64_t>(GetOption("MaxInstructions").AsInt()) <
+      loop->CountInstructionsInBody()) {
+    PRINT_PASS_OSTREAM_MESSAGE(this, "Loop #" << header->GetBlockId()
+      << " is too big to be versioned");
+    return false;
+  }
+
+  // A constant start value that makes some index negative would always fail the guard.
+  HInstruction* start = loop->PhiInput(phi, false);
+  bool is_start_constant = start->IsIntConstant();
+  int64_t start_value = is_start_constant ? start->AsIntConstant()->GetValue() : 0;
+
+  std::set<HInstruction*> arrays;
+  for (HBlocksInLoopIterator it_loop(*loop); !it_loop.Done(); it_loop.Advance()) {
+    HBasicBlock* block = it_loop.Current();
+    if (block == header) {
+      // The header also runs for i == n.
+      continue;
+    }
+
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      if (!it.Current()->IsBoundsCheck()) {
+        continue;
+      }
+
+      HBoundsCheck* bounds_check = it.Current()->AsBoundsCheck();
+      HInstruction* array = GetCheckedArray(loop, bounds_check);
+      int32_t offset = 0;
+      if (array != nullptr &&
+          GetIndexOffset(bounds_check->InputAt(0), phi, &offset) &&
+          (!is_start_constant || start_value + offset >= 0)) {
+        bounds_checks->push_back(bounds_check);
+        arrays.insert(array);
+      }
+    }
+  }
+
+  if (bounds_checks->empty()) {
+    return false;
+  }
+
+  // The guard also makes sure that these arrays are not null.
+  for (HBlocksInLoopIterator it_loop(*loop); !it_loop.Done(); it_loop.Advance()) {
+    HBasicBlock* block = it_loop.Current();
+    for (HInstructionIterator it(block->GetInstructions()); !it.Done(); it.Advance()) {
+      HInstruction* instruction = it.Current();
+      if (instruction->IsNullCheck() && arrays.count(instruction->InputAt(0)) != 0) {
+        null_checks->push_back(instruction->AsNullCheck());
+      }
+    }
+  }
+
+  return loop->IsVersionable(this);
+}
+
+HLoopInformation_X86* HLoopVersioning::Version(HLoopInformation_X86* loop,
+                                               const std::vector<HBoundsCheck*>& bounds_checks,
+                                               const std::vector<HNullCheck*>& null_checks) {
+  HGraph_X86* graph = GRAPH_TO_GRAPH_X86(graph_);
+  ArenaAllocator* arena = graph->GetArena();
+  const HLoopBoundInformation& bound_info = loop->GetBoundInformation();
+  HPhi* phi = bound_info.loop_biv_->GetPhiInsn();
+  HInstruction* start = loop->PhiInput(phi, false);
+  HInstruction* bound = bound_info.loop_bound_;
+
+  // The index i + c ranges over [start + c, n - 1 + c]: only the lowest
+  // offset matters for the lower bound, and the highest one per array for the
+  // upper bound. The arrays are kept in order of appearance for stable code.
+  std::vector<HInstruction*> arrays;
+  std::map<HInstruction*, int32_t> highest_offsets;
+  int32_t lowest_offset = std::numeric_limits<int32_t>::max();
+  for (HBoundsCheck* bounds_check : bounds_checks) {
+    HInstruction* array = GetCheckedArray(loop, bounds_check);
+    int32_t offset = 0;
+    bool is_offset = GetIndexOffset(bounds_check->InputAt(0), phi, &offset);
+    DCHECK(is_offset);
+    UNUSED(is_offset);
+
+    auto highest = highest_offsets.find(array);
+    if (highest == highest_offsets.end()) {
+      arrays.push_back(array);
+      highest_offsets[array] = offset;
+    } else {
+      highest->second = std::max(highest->second, offset);
+    }
+    lowest_offset = std::min(lowest_offset, offset);
+  }
+
+  GrowableArray<HInstruction*> guards(arena, 2u * arrays.size() + 1u);
+
+  // The lengths are only loaded once the arrays are known not to be null.
+  for (HInstruction* array : arrays) {
+    if (array->CanBeNull()) {
+      guards.Add(new (arena) HNotEqual(array, graph->GetNullConstant()));
+    }
+  }
+
+  // start + lowest_offset >= 0, written so that it cannot overflow.
+  if (!start->IsIntConstant()) {
+    guards.Add(new (arena) HGreaterThanOrEqual(start, graph->GetIntConstant(-lowest_offset)));
+  }
+
+  // n - 1 + highest_offset < length, written so that a wrap around fails the guard.
+  for (HInstruction* array : arrays) {
+    int32_t highest_offset = highest_offsets[array];
+    HInstruction* length = new (arena) HArrayLength(array);
+    if (highest_offset >= 0) {
+      HInstruction* limit = length;
+      if (highest_offset != 0) {
+        limit = new (arena) HSub(Primitive::kPrimInt, length,
+                                 graph->GetIntConstant(highest_offset));
+      }
+      guards.Add(new (arena) HLessThanOrEqual(bound, limit));
+    } else {
+      HInstruction* highest_index = new (arena) HAdd(Primitive::kPrimInt, bound,
+                                                     graph->GetIntConstant(highest_offset));
+      guards.Add(new (arena) HLessThanOrEqual(highest_index, length));
+    }
+  }
+
+  // The original loop runs when the guards hold, and the copy keeps all checks.
+  HLoopInformation_X86* checked_loop = loop->Version(guards);
+
+  for (HBoundsCheck* bounds_check : bounds_checks) {
+    bounds_check->ReplaceWith(bounds_check->InputAt(0));
+    bounds_check->GetBlock()->RemoveInstruction(bounds_check);
+  }
+
+  for (HNullCheck* null_check : null_checks) {
+    null_check->ReplaceWith(null_check->InputAt(0));
+    null_check->GetBlock()->RemoveInstruction(null_check);
+  }
+
+  return checked_loop;
+}
+
+}  // namespace art
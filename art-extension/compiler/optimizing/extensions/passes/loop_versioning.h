@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_VERSIONING_H_
+#define ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_VERSIONING_H_
+
+#include <vector>
+
+#include "nodes.h"
+#include "optimization_x86.h"
+
+namespace art {
+
+// Forward declarations.
+class HLoopInformation_X86;
+
+/**
+ * @brief Loop Versioning removes the bounds checks that BCE could not prove redundant,
+ * because the loop bound is only known at runtime.
+ * @details The candidate counts up by one to a loop invariant bound:
+ * for (i = start; i < n; i++), and accesses loop invariant arrays at the index i + c.
+ * A guard in front of the loop checks once that start + c >= 0 and n + c <= length for
+ * each of these arrays, which are also checked not to be null. When the guard holds,
+ * the loop runs without these bounds and null checks. Otherwise, a copy of the loop
+ * that keeps all its checks runs instead and throws at the right iteration.
+ * The pass runs before loop_vectorization, which can then handle the fast loop.
+ */
+class HLoopVersioning : public HOptimization_X86 {
+ public:
+  HLoopVersioning(HGraph* graph, OptimizingCompilerStats* stats = nullptr)
+    : HOptimization_X86(graph, true, kLoopVersioningPassName, stats) {
+      DefineOption("MaxInstructions", OptionContent(80));
+      DefineOption("Enabled", OptionContent(1));
+    }
+
+  void Run() OVERRIDE;
+
+ private:
+  /**
+   * @brief Check whether versioning the loop removes any check.
+   * @param loop The inner loop to check.
+   * @param bounds_checks Filled with the bounds checks the guard makes redundant.
+   * @param null_checks Filled with the null checks the guard makes redundant.
+   * @return true if the loop can be versioned and has bounds checks to remove.
+   */
+  bool Gate(HLoopInformation_X86* loop,
+            std::vector<HBoundsCheck*>* bounds_checks,
+            std::vector<HNullCheck*>* null_checks);
+
+  /**
+   * @brief Version the loop, then remove the checks from the version that runs
+   * when the guard holds.
+   * @param loop The loop that passed Gate.
+   * @param bounds_checks The bounds checks found by Gate.
+   * @param null_checks The null checks found by Gate.
+   * @return The loop information of the version that keeps its checks.
+   */
+  HLoopInformation_X86* Version(HLoopInformation_X86* loop,
+                                const std::vector<HBoundsCheck*>& bounds_checks,
+                                const std::vector<HNullCheck*>& null_checks);
+
+  static constexpr const char* kLoopVersioningPassName = "loop_versioning";
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_OPTIMIZING_EXTENSIONS_PASSES_LOOP_VERSIONING_H_
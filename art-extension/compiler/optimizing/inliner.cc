@@ -28,11 +28,14 @@
 #include "driver/compiler_options.h"
 #include "driver/dex_compilation_unit.h"
 #include "instruction_simplifier.h"
+#include "jit/jit.h"
+#include "jit/jit_instrumentation.h"
 #include "mirror/class_loader.h"
 #include "mirror/dex_cache.h"
 #include "nodes.h"
 #include "optimizing_compiler.h"
 #include "register_allocator.h"
+#include "runtime.h"
 #include "ssa_phi_elimination.h"
 #include "scoped_thread_state_change.h"
 #include "thread.h"
@@ -43,6 +46,53 @@
 
 namespace art {
 
+// Multiplier of the inlining budget of the call sites that are hot according to the profile.
+static constexpr size_t kHotInlineMaxCodeUnitsFactor = 2;
+
+// Returns the hotness of a call site according to the profile: the call site is as hot as the
+// outer method. A warm outer method calling a hot callee makes a hot call site, but a cold one
+// stays cold: the profile says its code is not executed, whatever the callee. Small callees are
+// rarely sampled themselves since their samples land in their callers, so an unsampled callee
+// does not make the call site cold.
+static CompilerDriver::ProfileHotness GetCallSiteHotness(
+    CompilerDriver* compiler_driver,
+    const DexCompilationUnit& outer_compilation_unit,
+    ArtMethod* callee) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+  if (!compiler_driver->ProfilePresent()) {
+    return CompilerDriver::kProfileHotnessUnknown;
+  }
+  CompilerDriver::ProfileHotness caller_hotness = compiler_driver->GetProfileHotness(
+      PrettyMethod(outer_compilation_unit.GetDexMethodIndex(),
+                   *outer_compilation_unit.GetDexFile()));
+  if (caller_hotness == CompilerDriver::kProfileHotnessWarm &&
+      compiler_driver->GetProfileHotness(PrettyMethod(callee)) ==
+          CompilerDriver::kProfileHotnessHot) {
+    return CompilerDriver::kProfileHotnessHot;
+  }
+  return caller_hotness;
+}
+
+// Find the type index of the receiver class of an inline cache in a given dex file.
+static bool FindReceiverTypeIndex(const jit::InlineCacheEntry& receiver,
+                                  const DexFile& dex_file,
+                                  uint16_t* type_index) {
+  if (receiver.dex_file == &dex_file) {
+    *type_index = receiver.type_idx;
+    return true;
+  }
+  const char* descriptor = receiver.dex_file->StringByTypeIdx(receiver.type_idx);
+  const DexFile::StringId* string_id = dex_file.FindStringId(descriptor);
+  if (string_id == nullptr) {
+    return false;
+  }
+  const DexFile::TypeId* type_id = dex_file.FindTypeId(dex_file.GetIndexForStringId(*string_id));
+  if (type_id == nullptr) {
+    return false;
+  }
+  *type_index = dex_file.GetIndexForTypeId(*type_id);
+  return true;
+}
+
 void HInliner::Run() {
   const CompilerOptions& compiler_options = compiler_driver_->GetCompilerOptions();
   if ((compiler_options.GetInlineDepthLimit() == 0)
@@ -72,6 +122,9 @@ void HInliner::Run() {
             CHECK(!should_inline) << "Could not inline " << callee_name;
           }
         }
+      } else if ((instruction->IsInvokeVirtual() || instruction->IsInvokeInterface()) &&
+                 instruction->AsInvoke()->GetIntrinsic() == Intrinsics::kNone) {
+        TryInlineMonomorphicCall(instruction->AsInvoke());
       }
       instruction = next;
     }
@@ -101,6 +154,15 @@ bool HInliner::TryInline(HInvoke* invoke_instruction, uint32_t method_index) con
     return false;
   }
 
+  return TryInlineResolvedMethod(invoke_instruction, method_index, resolved_method);
+}
+
+bool HInliner::TryInlineResolvedMethod(HInvoke* invoke_instruction,
+                                       uint32_t method_index,
+                                       ArtMethod* resolved_method) const {
+  ScopedObjectAccess soa(Thread::Current());
+  const DexFile& caller_dex_file = *caller_compilation_unit_.GetDexFile();
+
   if (resolved_method->ShouldNotInline()) {
     VLOG(compiler) << "Method " << PrettyMethod(method_index, caller_dex_file)
                    << " was already flagged as non inlineable";
@@ -128,11 +190,34 @@ bool HInliner::TryInline(HInvoke* invoke_instruction, uint32_t method_index) con
     }
   }
 
+  CompilerDriver::ProfileHotness hotness =
+      GetCallSiteHotness(compiler_driver_, outer_compilation_unit_, resolved_method);
+  // A callee no bigger than the invoke itself does not grow the code, inline it even when cold.
+  const Instruction* invoke_dex_instruction = Instruction::At(
+      caller_compilation_unit_.GetCodeItem()->insns_ + invoke_instruction->GetDexPc());
+  if (hotness == CompilerDriver::kProfileHotnessCold &&
+      code_item->insns_size_in_code_units_ > invoke_dex_instruction->SizeInCodeUnits()) {
+    VLOG(compiler) << "Method " << PrettyMethod(method_index, caller_dex_file)
+                   << " is not inlined because the call site is cold";
+    MaybeRecordStat(kIntelProfileColdInvokeNotInlined);
+    return false;
+  }
+
+  // Hot call sites get a larger budget. It depends on the outer method, so the callee is only
+  // flagged as non inlineable when it is too big for any call site.
   size_t inline_max_code_units = compiler_driver_->GetCompilerOptions().GetInlineMaxCodeUnits();
-  if (code_item->insns_size_in_code_units_ > inline_max_code_units) {
+  size_t hot_inline_max_code_units = compiler_driver_->ProfilePresent()
+      ? inline_max_code_units * kHotInlineMaxCodeUnitsFactor
+      : inline_max_code_units;
+  bool needs_hot_budget = code_item->insns_size_in_code_units_ > inline_max_code_units;
+  if (needs_hot_budget &&
+      (hotness != CompilerDriver::kProfileHotnessHot ||
+       code_item->insns_size_in_code_units_ > hot_inline_max_code_units)) {
     VLOG(compiler) << "Method " << PrettyMethod(method_index, caller_dex_file)
                    << " is too big to inline";
-    resolved_method->SetShouldNotInline();
+    if (code_item->insns_size_in_code_units_ > hot_inline_max_code_units) {
+      resolved_method->SetShouldNotInline();
+    }
     return false;
   }
 
@@ -172,6 +257,87 @@ bool HInliner::TryInline(HInvoke* invoke_instruction, uint32_t method_index) con
 
   VLOG(compiler) << "Successfully inlined " << PrettyMethod(method_index, caller_dex_file);
   MaybeRecordStat(kInlinedInvoke);
+  if (needs_hot_budget) {
+    MaybeRecordStat(kIntelProfileHotInvokeInlined);
+  }
+  return true;
+}
+
+bool HInliner::TryInlineMonomorphicCall(HInvoke* invoke_instruction) const {
+  DCHECK(invoke_instruction->IsInvokeVirtual() || invoke_instruction->IsInvokeInterface());
+  jit::Jit* jit = Runtime::Current()->GetJit();
+  // The receivers are only recorded when the Jit is running. The class check refers to
+  // a type of the outer dex file, so only the calls of the outer method are handled.
+  if (jit == nullptr || jit->GetInstrumentationCache() == nullptr || depth_ != 0) {
+    return false;
+  }
+
+  ScopedObjectAccess soa(Thread::Current());
+  const DexFile& caller_dex_file = *caller_compilation_unit_.GetDexFile();
+  uint32_t method_index = invoke_instruction->GetDexMethodIndex();
+  uint32_t dex_pc = invoke_instruction->GetDexPc();
+  ClassLinker* class_linker = caller_compilation_unit_.GetClassLinker();
+  size_t pointer_size = class_linker->GetImagePointerSize();
+  mirror::DexCache* dex_cache = class_linker->FindDexCache(caller_dex_file);
+  ArtMethod* caller =
+      dex_cache->GetResolvedMethod(caller_compilation_unit_.GetDexMethodIndex(), pointer_size);
+  ArtMethod* called_method = dex_cache->GetResolvedMethod(method_index, pointer_size);
+  if (caller == nullptr || called_method == nullptr) {
+    return false;
+  }
+
+  jit::InlineCacheEntry receiver;
+  if (!jit->GetInstrumentationCache()->GetMonomorphicReceiver(caller, dex_pc, &receiver)) {
+    VLOG(compiler) << "Call to " << PrettyMethod(method_index, caller_dex_file)
+                   << " is not monomorphic";
+    return false;
+  }
+
+  // The receiver class must be resolved in the caller's dex cache, and dispatch to the
+  // method the interpreter called.
+  uint16_t type_index;
+  if (!FindReceiverTypeIndex(receiver, caller_dex_file, &type_index)) {
+    return false;
+  }
+  mirror::Class* receiver_class = dex_cache->GetResolvedType(type_index);
+  if (receiver_class == nullptr ||
+      receiver_class->FindVirtualMethodForVirtualOrInterface(called_method, pointer_size) !=
+          receiver.target) {
+    VLOG(compiler) << "Receiver class of the call to "
+                   << PrettyMethod(method_index, caller_dex_file) << " cannot be checked";
+    return false;
+  }
+
+  // Deoptimize when the class of the receiver is not the one seen by the interpreter.
+  // The environment of the invoke is used, so the interpreter executes the call again.
+  ArenaAllocator* arena = graph_->GetArena();
+  HInstruction* receiver_value = invoke_instruction->InputAt(0);
+  HInstanceFieldGet* receiver_class_get = new (arena) HInstanceFieldGet(
+      receiver_value, Primitive::kPrimNot, mirror::Object::ClassOffset(), false, dex_pc);
+  HLoadClass* load_class = new (arena) HLoadClass(
+      type_index, receiver_class == caller->GetDeclaringClass(), dex_pc);
+  HNotEqual* compare = new (arena) HNotEqual(load_class, receiver_class_get);
+  HDeoptimize* deoptimize = new (arena) HDeoptimize(compare, dex_pc);
+  HBasicBlock* block = invoke_instruction->GetBlock();
+  block->InsertInstructionBefore(receiver_class_get, invoke_instruction);
+  block->InsertInstructionBefore(load_class, invoke_instruction);
+  block->InsertInstructionBefore(compare, invoke_instruction);
+  block->InsertInstructionBefore(deoptimize, invoke_instruction);
+  load_class->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+  deoptimize->CopyEnvironmentFrom(invoke_instruction->GetEnvironment());
+
+  if (!TryInlineResolvedMethod(invoke_instruction, method_index, receiver.target)) {
+    // The virtual call is kept, so the check is useless.
+    block->RemoveInstruction(deoptimize);
+    block->RemoveInstruction(compare);
+    block->RemoveInstruction(load_class);
+    block->RemoveInstruction(receiver_class_get);
+    return false;
+  }
+
+  VLOG(compiler) << "Successfully inlined monomorphic call to "
+                 << PrettyMethod(method_index, caller_dex_file);
+  MaybeRecordStat(kIntelMonomorphicInvokeInlined);
   return true;
 }
 
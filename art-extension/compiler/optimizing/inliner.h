@@ -51,6 +51,12 @@ class HInliner : public HOptimization {
 
  private:
   bool TryInline(HInvoke* invoke_instruction, uint32_t method_index) const;
+  bool TryInlineResolvedMethod(HInvoke* invoke_instruction,
+                               uint32_t method_index,
+                               ArtMethod* resolved_method) const;
+  // Inline the only target seen by the interpreter at a virtual or interface call site,
+  // behind a check of the receiver class that deoptimizes on a different class.
+  bool TryInlineMonomorphicCall(HInvoke* invoke_instruction) const;
   bool TryBuildAndInline(ArtMethod* resolved_method,
                          HInvoke* invoke_instruction,
                          uint32_t method_index,
@@ -54,6 +54,8 @@ static Primitive::Type GetType(uint64_t data, bool is_op_size) {
         return Primitive::kPrimByte;
       case kSignedHalf:
         return Primitive::kPrimShort;
+      case kUnsignedHalf:
+        return Primitive::kPrimChar;
       case k32:
         return Primitive::kPrimInt;
       case k64:
@@ -106,6 +108,76 @@ static Intrinsics GetIntrinsic(InlineMethod method) {
           LOG(FATAL) << "Unknown/unsupported op size " << method.d.data;
           UNREACHABLE();
       }
+    case kIntrinsicBitCount:
+      switch (GetType(method.d.data, true)) {
+        case Primitive::kPrimInt:
+          return Intrinsics::kIntegerBitCount;
+        case Primitive::kPrimLong:
+          return Intrinsics::kLongBitCount;
+        default:
+          LOG(FATAL) << "Unknown/unsupported op size " << method.d.data;
+          UNREACHABLE();
+      }
+    case kIntrinsicNumberOfLeadingZeros:
+      switch (GetType(method.d.data, true)) {
+        case Primitive::kPrimInt:
+          return Intrinsics::kIntegerNumberOfLeadingZeros;
+        case Primitive::kPrimLong:
+          return Intrinsics::kLongNumberOfLeadingZeros;
+        default:
+          LOG(FATAL) << "Unknown/unsupported op size " << method.d.data;
+          UNREACHABLE();
+      }
+    case kIntrinsicNumberOfTrailingZeros:
+      switch (GetType(method.d.data, true)) {
+        case Primitive::kPrimInt:
+          return Intrinsics::kIntegerNumberOfTrailingZeros;
+        case Primitive::kPrimLong:
+          return Intrinsics::kLongNumberOfTrailingZeros;
+        default:
+          LOG(FATAL) << "Unknown/unsupported op size " << method.d.data;
+          UNREACHABLE();
+      }
+    case kIntrinsicRotateRight:
+      switch (GetType(method.d.data, true)) {
+        case Primitive::kPrimInt:
+          return Intrinsics::kIntegerRotateRight;
+        case Primitive::kPrimLong:
+          return Intrinsics::kLongRotateRight;
+        default:
+          LOG(FATAL) << "Unknown/unsupported op size " << method.d.data;
+          UNREACHABLE();
+      }
+    case kIntrinsicRotateLeft:
+      switch (GetType(method.d.data, true)) {
+        case Primitive::kPrimInt:
+          return Intrinsics::kIntegerRotateLeft;
+        case Primitive::kPrimLong:
+          return Intrinsics::kLongRotateLeft;
+        default:
+          LOG(FATAL) << "Unknown/unsupported op size " << method.d.data;
+          UNREACHABLE();
+      }
+    case kIntrinsicHighestOneBit:
+      switch (GetType(method.d.data, true)) {
+        case Primitive::kPrimInt:
+          return Intrinsics::kIntegerHighestOneBit;
+        case Primitive::kPrimLong:
+          return Intrinsics::kLongHighestOneBit;
+        default:
+          LOG(FATAL) << "Unknown/unsupported op size " << method.d.data;
+          UNREACHABLE();
+      }
+    case kIntrinsicSignum:
+      switch (GetType(method.d.data, true)) {
+        case Primitive::kPrimInt:
+          return Intrinsics::kIntegerSignum;
+        case Primitive::kPrimLong:
+          return Intrinsics::kLongSignum;
+        default:
+          LOG(FATAL) << "Unknown/unsupported op size " << method.d.data;
+          UNREACHABLE();
+      }
 
     // Abs.
     case kIntrinsicAbsDouble:
@@ -184,6 +256,38 @@ static Intrinsics GetIntrinsic(InlineMethod method) {
     // System.arraycopy.
     case kIntrinsicSystemArrayCopyCharArray:
       return Intrinsics::kSystemArrayCopyChar;
+    case kIntrinsicSystemArrayCopy:
+      switch (GetType(method.d.data, true)) {
+        case Primitive::kPrimByte:
+          return Intrinsics::kSystemArrayCopyByte;
+        case Primitive::kPrimInt:
+          return Intrinsics::kSystemArrayCopyInt;
+        default:
+          LOG(FATAL) << "Unknown/unsupported op size " << method.d.data;
+          UNREACHABLE();
+      }
+
+    // Arrays.equals and Arrays.fill.
+    case kIntrinsicArraysEquals:
+      switch (GetType(method.d.data, true)) {
+        case Primitive::kPrimByte:
+          return Intrinsics::kArraysEqualsByte;
+        case Primitive::kPrimChar:
+          return Intrinsics::kArraysEqualsChar;
+        case Primitive::kPrimInt:
+          return Intrinsics::kArraysEqualsInt;
+        default:
+          LOG(FATAL) << "Unknown/unsupported op size " << method.d.data;
+          UNREACHABLE();
+      }
+    case kIntrinsicArraysFill:
+      switch (GetType(method.d.data, true)) {
+        case Primitive::kPrimInt:
+          return Intrinsics::kArraysFillInt;
+        default:
+          LOG(FATAL) << "Unknown/unsupported op size " << method.d.data;
+          UNREACHABLE();
+      }
 
     // Thread.currentThread.
     case kIntrinsicCurrentThread:
@@ -317,6 +421,10 @@ static Intrinsics GetIntrinsic(InlineMethod method) {
 
     case kIntrinsicReferenceGetReferent:
       return Intrinsics::kReferenceGetReferent;
+    case kIntrinsicEquals:
+      return Intrinsics::kStringEquals;
+    case kIntrinsicHashCode:
+      return Intrinsics::kStringHashCode;
 
     // Quick inliner cases. Remove after refactoring. They are here so that we can use the
     // compiler to warn on missing cases.
@@ -33,6 +33,20 @@
   V(LongReverse, kStatic) \
   V(LongReverseBytes, kStatic) \
   V(ShortReverseBytes, kStatic) \
+  V(IntegerBitCount, kStatic) \
+  V(IntegerNumberOfLeadingZeros, kStatic) \
+  V(IntegerNumberOfTrailingZeros, kStatic) \
+  V(IntegerRotateRight, kStatic) \
+  V(IntegerRotateLeft, kStatic) \
+  V(IntegerHighestOneBit, kStatic) \
+  V(IntegerSignum, kStatic) \
+  V(LongBitCount, kStatic) \
+  V(LongNumberOfLeadingZeros, kStatic) \
+  V(LongNumberOfTrailingZeros, kStatic) \
+  V(LongRotateRight, kStatic) \
+  V(LongRotateLeft, kStatic) \
+  V(LongHighestOneBit, kStatic) \
+  V(LongSignum, kStatic) \
   V(MathAbsDouble, kStatic) \
   V(MathAbsFloat, kStatic) \
   V(MathAbsLong, kStatic) \
@@ -69,6 +83,12 @@
   V(MathRoundDouble, kStatic) \
   V(MathRoundFloat, kStatic) \
   V(SystemArrayCopyChar, kStatic) \
+  V(SystemArrayCopyByte, kStatic) \
+  V(SystemArrayCopyInt, kStatic) \
+  V(ArraysEqualsByte, kStatic) \
+  V(ArraysEqualsChar, kStatic) \
+  V(ArraysEqualsInt, kStatic) \
+  V(ArraysFillInt, kStatic) \
   V(ThreadCurrentThread, kStatic) \
   V(MemoryPeekByte, kStatic) \
   V(MemoryPeekIntNative, kStatic) \
@@ -80,7 +100,9 @@
   V(MemoryPokeShortNative, kStatic) \
   V(StringCharAt, kDirect) \
   V(StringCompareTo, kDirect) \
+  V(StringEquals, kVirtual) \
   V(StringGetCharsNoCheck, kDirect) \
+  V(StringHashCode, kVirtual) \
   V(StringIndexOf, kDirect) \
   V(StringIndexOfAfter, kDirect) \
   V(StringNewStringFromBytes, kStatic) \
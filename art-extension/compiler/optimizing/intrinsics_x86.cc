@@ -1132,7 +1132,7 @@ void IntrinsicCodeGeneratorX86::VisitStringCharAt(HInvoke* invoke) {
   __ Bind(slow_path->GetExitLabel());
 }
 
-void IntrinsicLocationsBuilderX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
+static void CreateSystemArrayCopyLocations(ArenaAllocator* arena, HInvoke* invoke) {
   // We need at least two of the positions or length to be an integer constant,
   // or else we won't have enough free registers.
   HIntConstant* src_pos = invoke->InputAt(1)->AsIntConstant();
@@ -1174,7 +1174,7 @@ void IntrinsicLocationsBuilderX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
 
   // Okay, it is safe to generate inline code.
   LocationSummary* locations =
-    new (arena_) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
+    new (arena) LocationSummary(invoke, LocationSummary::kCallOnSlowPath, kIntrinsified);
   // arraycopy(Object src, int srcPos, Object dest, int destPos, int length).
   locations->SetInAt(0, Location::RequiresRegister());
   locations->SetInAt(1, Location::RegisterOrConstant(invoke->InputAt(1)));
@@ -1182,12 +1182,24 @@ void IntrinsicLocationsBuilderX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
   locations->SetInAt(3, Location::RegisterOrConstant(invoke->InputAt(3)));
   locations->SetInAt(4, Location::RegisterOrConstant(invoke->InputAt(4)));
 
-  // And we need some temporaries.  We will use REP STOSW, so we need fixed registers.
+  // And we need some temporaries.  We will use REP MOVS, so we need fixed registers.
   locations->AddTemp(Location::RegisterLocation(ESI));
   locations->AddTemp(Location::RegisterLocation(EDI));
   locations->AddTemp(Location::RegisterLocation(ECX));
 }
 
+void IntrinsicLocationsBuilderX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
+  CreateSystemArrayCopyLocations(arena_, invoke);
+}
+
+void IntrinsicLocationsBuilderX86::VisitSystemArrayCopyByte(HInvoke* invoke) {
+  CreateSystemArrayCopyLocations(arena_, invoke);
+}
+
+void IntrinsicLocationsBuilderX86::VisitSystemArrayCopyInt(HInvoke* invoke) {
+  CreateSystemArrayCopyLocations(arena_, invoke);
+}
+
 static void CheckPosition(X86Assembler* assembler,
                           Location pos,
                           Register input,
@@ -1235,8 +1247,11 @@ static void CheckPosition(X86Assembler* assembler,
   }
 }
 
-void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
-  X86Assembler* assembler = GetAssembler();
+static void GenSystemArrayCopy(HInvoke* invoke,
+                               Primitive::Type type,
+                               X86Assembler* assembler,
+                               CodeGeneratorX86* codegen,
+                               ArenaAllocator* allocator) {
   LocationSummary* locations = invoke->GetLocations();
 
   Register src = locations->InAt(0).AsRegister<Register>();
@@ -1250,8 +1265,8 @@ void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
   int32_t destPos_const =
     destPos.IsConstant() ? destPos.GetConstant()->AsIntConstant()->GetValue() : 0;
 
-  SlowPathCodeX86* slow_path = new (GetAllocator()) IntrinsicSlowPathX86(invoke);
-  codegen_->AddSlowPath(slow_path);
+  SlowPathCodeX86* slow_path = new (allocator) IntrinsicSlowPathX86(invoke);
+  codegen->AddSlowPath(slow_path);
 
   // Bail if the source and destination are the same (to handle overlap).
   __ cmpl(src, dest);
@@ -1265,7 +1280,7 @@ void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
   __ testl(dest, dest);
   __ j(kEqual, slow_path->GetEntryLabel());
 
-  // If the length is > 128 elements (256 bytes) or negative, bail.
+  // If the length is > 128 elements or negative, bail.
   // We have already checked in the LocationsBuilder for the constant case.
   if (!length.IsConstant()) {
     // Runtime test to check the length.
@@ -1293,31 +1308,290 @@ void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
   CheckPosition(assembler, destPos, dest, count, slow_path, src_base, dest_base);
 
   // Okay, everything checks out.  Finally time to do the copy.
-  int32_t data_offset = mirror::Array::DataOffset(2).Int32Value();
+  const size_t element_size = Primitive::ComponentSize(type);
+  const ScaleFactor scale = static_cast<ScaleFactor>(Primitive::ComponentSizeShift(type));
+  int32_t data_offset = mirror::Array::DataOffset(element_size).Int32Value();
 
   DCHECK_EQ(src_base, ESI);
   DCHECK_EQ(dest_base, EDI);
 
   if (srcPos.IsConstant()) {
-    __ leal(src_base, Address(src, 2 * srcPos_const + data_offset));
+    __ leal(src_base, Address(src, element_size * srcPos_const + data_offset));
   } else {
-    __ leal(src_base, Address(src, srcPos.AsRegister<Register>(),
-                              ScaleFactor::TIMES_2, data_offset));
+    __ leal(src_base, Address(src, srcPos.AsRegister<Register>(), scale, data_offset));
   }
   if (destPos.IsConstant()) {
-    __ leal(dest_base, Address(dest, 2 * destPos_const + data_offset));
+    __ leal(dest_base, Address(dest, element_size * destPos_const + data_offset));
   } else {
-    __ leal(dest_base, Address(dest, destPos.AsRegister<Register>(),
-                               ScaleFactor::TIMES_2, data_offset));
+    __ leal(dest_base, Address(dest, destPos.AsRegister<Register>(), scale, data_offset));
   }
 
   // Do the move.
-  __ rep_movsw();
+  switch (type) {
+    case Primitive::kPrimByte:
+      __ rep_movsb();
+      break;
+    case Primitive::kPrimChar:
+      __ rep_movsw();
+      break;
+    case Primitive::kPrimInt:
+      __ rep_movsl();
+      break;
+    default:
+      LOG(FATAL) << "Unexpected type for System.arraycopy " << type;
+      UNREACHABLE();
+  }
 
   // Finished!
   __ Bind(slow_path->GetExitLabel());
 }
 
+void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyChar(HInvoke* invoke) {
+  GenSystemArrayCopy(invoke, Primitive::kPrimChar, GetAssembler(), codegen_, GetAllocator());
+}
+
+void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyByte(HInvoke* invoke) {
+  GenSystemArrayCopy(invoke, Primitive::kPrimByte, GetAssembler(), codegen_, GetAllocator());
+}
+
+void IntrinsicCodeGeneratorX86::VisitSystemArrayCopyInt(HInvoke* invoke) {
+  GenSystemArrayCopy(invoke, Primitive::kPrimInt, GetAssembler(), codegen_, GetAllocator());
+}
+
+// Compare `count` bytes of data of two objects, starting at `data_offset`. With SSE4.1,
+// the data is compared 16 bytes at a time with PTEST. The blocks are loaded unaligned,
+// and the last block overlaps the previous one rather than reading past the objects.
+// Jumps to `equal` or `not_equal`. `count` and the temporaries are clobbered.
+static void GenerateVectorCompare(X86Assembler* assembler,
+                                  Register left,
+                                  Register right,
+                                  Register count,
+                                  Register temp1,
+                                  Register temp2,
+                                  XmmRegister xmm1,
+                                  XmmRegister xmm2,
+                                  int32_t data_offset,
+                                  Label* equal,
+                                  Label* not_equal) {
+  Label less_than_16, less_than_8, vector_loop, byte_loop;
+
+  __ cmpl(count, Immediate(16));
+  __ j(kLess, &less_than_16);
+
+  // Compare the last 16 bytes first, so that the loop only deals with whole blocks.
+  __ movdqu(xmm1, Address(left, count, ScaleFactor::TIMES_1, data_offset - 16));
+  __ movdqu(xmm2, Address(right, count, ScaleFactor::TIMES_1, data_offset - 16));
+  __ pxor(xmm1, xmm2);
+  __ ptest(xmm1, xmm1);
+  __ j(kNotEqual, not_equal);
+  __ subl(count, Immediate(16));
+  __ xorl(temp1, temp1);
+  __ Bind(&vector_loop);
+  __ cmpl(temp1, count);
+  __ j(kGreaterEqual, equal);
+  __ movdqu(xmm1, Address(left, temp1, ScaleFactor::TIMES_1, data_offset));
+  __ movdqu(xmm2, Address(right, temp1, ScaleFactor::TIMES_1, data_offset));
+  __ pxor(xmm1, xmm2);
+  __ ptest(xmm1, xmm1);
+  __ j(kNotEqual, not_equal);
+  __ addl(temp1, Immediate(16));
+  __ jmp(&vector_loop);
+
+  // 8 to 15 bytes: compare the first and the last 8 bytes.
+  __ Bind(&less_than_16);
+  __ cmpl(count, Immediate(8));
+  __ j(kLess, &less_than_8);
+  __ movsd(xmm1, Address(left, data_offset));
+  __ movsd(xmm2, Address(right, data_offset));
+  __ pxor(xmm1, xmm2);
+  __ ptest(xmm1, xmm1);
+  __ j(kNotEqual, not_equal);
+  __ movsd(xmm1, Address(left, count, ScaleFactor::TIMES_1, data_offset - 8));
+  __ movsd(xmm2, Address(right, count, ScaleFactor::TIMES_1, data_offset - 8));
+  __ pxor(xmm1, xmm2);
+  __ ptest(xmm1, xmm1);
+  __ j(kNotEqual, not_equal);
+  __ jmp(equal);
+
+  // 4 to 7 bytes: compare the first and the last 4 bytes.
+  __ Bind(&less_than_8);
+  __ cmpl(count, Immediate(4));
+  __ j(kLess, &byte_loop);
+  __ movl(temp1, Address(left, data_offset));
+  __ cmpl(temp1, Address(right, data_offset));
+  __ j(kNotEqual, not_equal);
+  __ movl(temp1, Address(left, count, ScaleFactor::TIMES_1, data_offset - 4));
+  __ cmpl(temp1, Address(right, count, ScaleFactor::TIMES_1, data_offset - 4));
+  __ j(kNotEqual, not_equal);
+  __ jmp(equal);
+
+  // Less than 4 bytes: compare them one at a time.
+  __ Bind(&byte_loop);
+  __ testl(count, count);
+  __ j(kEqual, equal);
+  __ movzxb(temp1, Address(left, count, ScaleFactor::TIMES_1, data_offset - 1));
+  __ movzxb(temp2, Address(right, count, ScaleFactor::TIMES_1, data_offset - 1));
+  __ cmpl(temp1, temp2);
+  __ j(kNotEqual, not_equal);
+  __ subl(count, Immediate(1));
+  __ jmp(&byte_loop);
+}
+
+static void CreateVectorCompareLocations(ArenaAllocator* arena,
+                                         HInvoke* invoke,
+                                         CodeGeneratorX86* codegen) {
+  // PTEST is part of SSE4.1.
+  if (!codegen->GetInstructionSetFeatures().HasSSE4_1()) {
+    return;
+  }
+
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  // The result is only written once the inputs are no longer needed.
+  locations->SetOut(Location::SameAsFirstInput());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+static void GenArraysEquals(HInvoke* invoke, Primitive::Type type, X86Assembler* assembler) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register left = locations->InAt(0).AsRegister<Register>();
+  Register right = locations->InAt(1).AsRegister<Register>();
+  Register out = locations->Out().AsRegister<Register>();
+  Register count = locations->GetTemp(0).AsRegister<Register>();
+  Register temp1 = locations->GetTemp(1).AsRegister<Register>();
+  Register temp2 = locations->GetTemp(2).AsRegister<Register>();
+  XmmRegister xmm1 = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister xmm2 = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+
+  const int32_t length_offset = mirror::Array::LengthOffset().Int32Value();
+  const int32_t data_offset =
+      mirror::Array::DataOffset(Primitive::ComponentSize(type)).Int32Value();
+
+  Label equal, not_equal, done;
+
+  // The same array, including two null arrays, is equal to itself.
+  __ cmpl(left, right);
+  __ j(kEqual, &equal);
+  __ testl(left, left);
+  __ j(kEqual, &not_equal);
+  __ testl(right, right);
+  __ j(kEqual, &not_equal);
+
+  // The arrays must have the same length.
+  __ movl(count, Address(left, length_offset));
+  __ cmpl(count, Address(right, length_offset));
+  __ j(kNotEqual, &not_equal);
+
+  // Compare the elements as bytes.
+  size_t shift = Primitive::ComponentSizeShift(type);
+  if (shift != 0) {
+    __ shll(count, Immediate(shift));
+  }
+  GenerateVectorCompare(assembler, left, right, count, temp1, temp2, xmm1, xmm2,
+                        data_offset, &equal, &not_equal);
+
+  __ Bind(&equal);
+  __ movl(out, Immediate(1));
+  __ jmp(&done);
+
+  __ Bind(&not_equal);
+  __ xorl(out, out);
+
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderX86::VisitArraysEqualsByte(HInvoke* invoke) {
+  CreateVectorCompareLocations(arena_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86::VisitArraysEqualsByte(HInvoke* invoke) {
+  GenArraysEquals(invoke, Primitive::kPrimByte, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderX86::VisitArraysEqualsChar(HInvoke* invoke) {
+  CreateVectorCompareLocations(arena_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86::VisitArraysEqualsChar(HInvoke* invoke) {
+  GenArraysEquals(invoke, Primitive::kPrimChar, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderX86::VisitArraysEqualsInt(HInvoke* invoke) {
+  CreateVectorCompareLocations(arena_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86::VisitArraysEqualsInt(HInvoke* invoke) {
+  GenArraysEquals(invoke, Primitive::kPrimInt, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderX86::VisitArraysFillInt(HInvoke* invoke) {
+  LocationSummary* locations = new (arena_) LocationSummary(invoke,
+                                                            LocationSummary::kCallOnSlowPath,
+                                                            kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+void IntrinsicCodeGeneratorX86::VisitArraysFillInt(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  Register array = locations->InAt(0).AsRegister<Register>();
+  Register value = locations->InAt(1).AsRegister<Register>();
+  Register count = locations->GetTemp(0).AsRegister<Register>();
+  Register index = locations->GetTemp(1).AsRegister<Register>();
+  XmmRegister values = locations->GetTemp(2).AsFpuRegister<XmmRegister>();
+
+  const int32_t length_offset = mirror::Array::LengthOffset().Int32Value();
+  const int32_t data_offset = mirror::Array::DataOffset(sizeof(int32_t)).Int32Value();
+
+  // The call throws the NullPointerException.
+  SlowPathCodeX86* slow_path = new (GetAllocator()) IntrinsicSlowPathX86(invoke);
+  codegen_->AddSlowPath(slow_path);
+  __ testl(array, array);
+  __ j(kEqual, slow_path->GetEntryLabel());
+
+  Label vector_loop, scalar_loop;
+  __ movl(count, Address(array, length_offset));
+  __ cmpl(count, Immediate(4));
+  __ j(kLess, &scalar_loop);
+
+  // Store 4 elements at a time. The last block is stored first, and may overlap the
+  // previous one.
+  __ movd(values, value);
+  __ pshufd(values, values, Immediate(0));
+  __ movdqu(Address(array, count, ScaleFactor::TIMES_4, data_offset - 16), values);
+  __ subl(count, Immediate(4));
+  __ xorl(index, index);
+  __ Bind(&vector_loop);
+  __ cmpl(index, count);
+  __ j(kGreaterEqual, slow_path->GetExitLabel());
+  __ movdqu(Address(array, index, ScaleFactor::TIMES_4, data_offset), values);
+  __ addl(index, Immediate(4));
+  __ jmp(&vector_loop);
+
+  // Less than 4 elements: store them one at a time.
+  __ Bind(&scalar_loop);
+  __ testl(count, count);
+  __ j(kEqual, slow_path->GetExitLabel());
+  __ movl(Address(array, count, ScaleFactor::TIMES_4, data_offset - 4), value);
+  __ subl(count, Immediate(1));
+  __ jmp(&scalar_loop);
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
 void IntrinsicLocationsBuilderX86::VisitStringCompareTo(HInvoke* invoke) {
   // The inputs plus one temp.
   LocationSummary* locations = new (arena_) LocationSummary(invoke,
@@ -1346,6 +1620,162 @@ void IntrinsicCodeGeneratorX86::VisitStringCompareTo(HInvoke* invoke) {
   __ Bind(slow_path->GetExitLabel());
 }
 
+void IntrinsicLocationsBuilderX86::VisitStringEquals(HInvoke* invoke) {
+  CreateVectorCompareLocations(arena_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86::VisitStringEquals(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  Register str = locations->InAt(0).AsRegister<Register>();
+  Register arg = locations->InAt(1).AsRegister<Register>();
+  Register out = locations->Out().AsRegister<Register>();
+  Register count = locations->GetTemp(0).AsRegister<Register>();
+  Register temp1 = locations->GetTemp(1).AsRegister<Register>();
+  Register temp2 = locations->GetTemp(2).AsRegister<Register>();
+  XmmRegister xmm1 = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister xmm2 = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+
+  const int32_t class_offset = mirror::Object::ClassOffset().Int32Value();
+  const int32_t count_offset = mirror::String::CountOffset().Int32Value();
+  const int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+
+  Label equal, not_equal, done;
+
+  __ cmpl(str, arg);
+  __ j(kEqual, &equal);
+  __ testl(arg, arg);
+  __ j(kEqual, &not_equal);
+
+  // String is final: the argument is a string if it has the same class as the receiver.
+  __ movl(temp1, Address(str, class_offset));
+  __ cmpl(temp1, Address(arg, class_offset));
+  __ j(kNotEqual, &not_equal);
+
+  // The strings must have the same length.
+  __ movl(count, Address(str, count_offset));
+  __ cmpl(count, Address(arg, count_offset));
+  __ j(kNotEqual, &not_equal);
+
+  // Compare the characters as bytes.
+  __ shll(count, Immediate(1));
+  GenerateVectorCompare(assembler, str, arg, count, temp1, temp2, xmm1, xmm2,
+                        value_offset, &equal, &not_equal);
+
+  __ Bind(&equal);
+  __ movl(out, Immediate(1));
+  __ jmp(&done);
+
+  __ Bind(&not_equal);
+  __ xorl(out, out);
+
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderX86::VisitStringHashCode(HInvoke* invoke) {
+  // PMULLD is part of SSE4.1.
+  if (!codegen_->GetInstructionSetFeatures().HasSSE4_1()) {
+    return;
+  }
+
+  LocationSummary* locations = new (arena_) LocationSummary(invoke,
+                                                            LocationSummary::kNoCall,
+                                                            kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+void IntrinsicCodeGeneratorX86::VisitStringHashCode(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  Register str = locations->InAt(0).AsRegister<Register>();
+  Register out = locations->Out().AsRegister<Register>();
+  Register count = locations->GetTemp(0).AsRegister<Register>();
+  Register index = locations->GetTemp(1).AsRegister<Register>();
+  Register temp = locations->GetTemp(2).AsRegister<Register>();
+  XmmRegister hashes = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister chars = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+  XmmRegister factor = locations->GetTemp(5).AsFpuRegister<XmmRegister>();
+  XmmRegister zero = locations->GetTemp(6).AsFpuRegister<XmmRegister>();
+
+  const int32_t hash_code_offset = mirror::String::HashCodeOffset().Int32Value();
+  const int32_t count_offset = mirror::String::CountOffset().Int32Value();
+  const int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+
+  Label vector_loop, scalar_loop, store, done;
+
+  // The hash code is cached in the string once computed.
+  __ movl(out, Address(str, hash_code_offset));
+  __ testl(out, out);
+  __ j(kNotEqual, &done);
+
+  __ movl(count, Address(str, count_offset));
+  __ xorl(index, index);
+  __ cmpl(count, Immediate(4));
+  __ j(kLess, &scalar_loop);
+
+  // Lane i of `hashes` hashes the characters 4 * k + i: hash = hash * 31^4 + c.
+  __ pxor(hashes, hashes);
+  __ pxor(zero, zero);
+  __ movl(temp, Immediate(31 * 31 * 31 * 31));
+  __ movd(factor, temp);
+  __ pshufd(factor, factor, Immediate(0));
+  __ Bind(&vector_loop);
+  __ movsd(chars, Address(str, index, ScaleFactor::TIMES_2, value_offset));
+  __ punpcklwd(chars, zero);
+  __ pmulld(hashes, factor);
+  __ paddd(hashes, chars);
+  __ addl(index, Immediate(4));
+  __ leal(temp, Address(index, 4));
+  __ cmpl(temp, count);
+  __ j(kLessEqual, &vector_loop);
+
+  // Combine the lanes: hash = lane0 * 31^3 + lane1 * 31^2 + lane2 * 31 + lane3.
+  __ movd(out, hashes);
+  __ imull(out, out, Immediate(31 * 31 * 31));
+  __ pshufd(chars, hashes, Immediate(0x55));
+  __ movd(temp, chars);
+  __ imull(temp, temp, Immediate(31 * 31));
+  __ addl(out, temp);
+  __ pshufd(chars, hashes, Immediate(0xAA));
+  __ movd(temp, chars);
+  __ imull(temp, temp, Immediate(31));
+  __ addl(out, temp);
+  __ pshufd(chars, hashes, Immediate(0xFF));
+  __ movd(temp, chars);
+  __ addl(out, temp);
+
+  // The remaining characters.
+  __ Bind(&scalar_loop);
+  __ cmpl(index, count);
+  __ j(kGreaterEqual, &store);
+  __ imull(out, out, Immediate(31));
+  __ movzxw(temp, Address(str, index, ScaleFactor::TIMES_2, value_offset));
+  __ addl(out, temp);
+  __ addl(index, Immediate(1));
+  __ jmp(&scalar_loop);
+
+  __ Bind(&store);
+  __ movl(Address(str, hash_code_offset), out);
+
+  __ Bind(&done);
+}
+
 static void CreateStringIndexOfLocations(HInvoke* invoke,
                                          ArenaAllocator* allocator,
                                          bool start_at_zero) {
@@ -2193,6 +2623,443 @@ void IntrinsicCodeGeneratorX86::VisitLongReverse(HInvoke* invoke) {
   SwapBits(reg_high, temp, 4, 0x0f0f0f0f, assembler);
 }
 
+static void CreateBitCountLocations(ArenaAllocator* arena,
+                                    CodeGeneratorX86* codegen,
+                                    HInvoke* invoke,
+                                    bool is_long) {
+  if (!codegen->GetInstructionSetFeatures().HasPopCnt()) {
+    // Without POPCNT, the library implementation is as good as we can do inline.
+    return;
+  }
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  if (is_long) {
+    // The high half of the input is read after the output is written.
+    locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+    locations->AddTemp(Location::RequiresRegister());
+  } else {
+    locations->SetOut(Location::RequiresRegister());
+  }
+}
+
+void IntrinsicLocationsBuilderX86::VisitIntegerBitCount(HInvoke* invoke) {
+  CreateBitCountLocations(arena_, codegen_, invoke, false);
+}
+
+void IntrinsicCodeGeneratorX86::VisitIntegerBitCount(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  __ popcntl(locations->Out().AsRegister<Register>(), locations->InAt(0).AsRegister<Register>());
+}
+
+void IntrinsicLocationsBuilderX86::VisitLongBitCount(HInvoke* invoke) {
+  CreateBitCountLocations(arena_, codegen_, invoke, true);
+}
+
+void IntrinsicCodeGeneratorX86::VisitLongBitCount(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Register out = locations->Out().AsRegister<Register>();
+  Register temp = locations->GetTemp(0).AsRegister<Register>();
+
+  __ popcntl(out, locations->InAt(0).AsRegisterPairLow<Register>());
+  __ popcntl(temp, locations->InAt(0).AsRegisterPairHigh<Register>());
+  __ addl(out, temp);
+}
+
+static void CreateBitScanLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister());
+}
+
+// Count the leading zeros of `in` into `out`, adding `extra` to the result.
+// BSR leaves its destination undefined for a zero input, so the caller must
+// have checked that `in` is not zero when LZCNT is not available.
+static void GenLeadingZerosOfNonZero(X86Assembler* assembler,
+                                     bool has_lzcnt,
+                                     Register out,
+                                     Register in,
+                                     int32_t extra) {
+  if (has_lzcnt) {
+    __ lzcntl(out, in);
+  } else {
+    // BSR gives the index of the highest set bit, so the count is 31 - index.
+    __ bsrl(out, in);
+    __ xorl(out, Immediate(31));
+  }
+  if (extra != 0) {
+    __ addl(out, Immediate(extra));
+  }
+}
+
+void IntrinsicLocationsBuilderX86::VisitIntegerNumberOfLeadingZeros(HInvoke* invoke) {
+  CreateBitScanLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86::VisitIntegerNumberOfLeadingZeros(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Register in = locations->InAt(0).AsRegister<Register>();
+  Register out = locations->Out().AsRegister<Register>();
+
+  if (codegen_->GetInstructionSetFeatures().HasLzCnt()) {
+    __ lzcntl(out, in);
+    return;
+  }
+
+  Label zero, done;
+  __ bsrl(out, in);
+  __ j(kEqual, &zero);
+  __ xorl(out, Immediate(31));
+  __ jmp(&done);
+  __ Bind(&zero);
+  __ movl(out, Immediate(32));
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderX86::VisitLongNumberOfLeadingZeros(HInvoke* invoke) {
+  CreateBitScanLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86::VisitLongNumberOfLeadingZeros(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Register in_lo = locations->InAt(0).AsRegisterPairLow<Register>();
+  Register in_hi = locations->InAt(0).AsRegisterPairHigh<Register>();
+  Register out = locations->Out().AsRegister<Register>();
+  bool has_lzcnt = codegen_->GetInstructionSetFeatures().HasLzCnt();
+
+  Label high_zero, done;
+  __ testl(in_hi, in_hi);
+  __ j(kEqual, &high_zero);
+  GenLeadingZerosOfNonZero(assembler, has_lzcnt, out, in_hi, 0);
+  __ jmp(&done);
+
+  // The high half is zero: count in the low half and add 32.
+  __ Bind(&high_zero);
+  if (has_lzcnt) {
+    // LZCNT returns 32 for zero, which gives the expected 64.
+    GenLeadingZerosOfNonZero(assembler, has_lzcnt, out, in_lo, 32);
+  } else {
+    Label all_zero;
+    __ testl(in_lo, in_lo);
+    __ j(kEqual, &all_zero);
+    GenLeadingZerosOfNonZero(assembler, has_lzcnt, out, in_lo, 32);
+    __ jmp(&done);
+    __ Bind(&all_zero);
+    __ movl(out, Immediate(64));
+  }
+  __ Bind(&done);
+}
+
+// Count the trailing zeros of `in` into `out`, adding `extra` to the result.
+// As with BSR, the caller must have checked that `in` is not zero when TZCNT
+// is not available.
+static void GenTrailingZerosOfNonZero(X86Assembler* assembler,
+                                      bool has_tzcnt,
+                                      Register out,
+                                      Register in,
+                                      int32_t extra) {
+  if (has_tzcnt) {
+    __ tzcntl(out, in);
+  } else {
+    // BSF gives the index of the lowest set bit, which is the count.
+    __ bsfl(out, in);
+  }
+  if (extra != 0) {
+    __ addl(out, Immediate(extra));
+  }
+}
+
+void IntrinsicLocationsBuilderX86::VisitIntegerNumberOfTrailingZeros(HInvoke* invoke) {
+  CreateBitScanLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86::VisitIntegerNumberOfTrailingZeros(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Register in = locations->InAt(0).AsRegister<Register>();
+  Register out = locations->Out().AsRegister<Register>();
+
+  if (codegen_->GetInstructionSetFeatures().HasTzCnt()) {
+    __ tzcntl(out, in);
+    return;
+  }
+
+  Label done;
+  __ bsfl(out, in);
+  __ j(kNotEqual, &done);
+  __ movl(out, Immediate(32));
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderX86::VisitLongNumberOfTrailingZeros(HInvoke* invoke) {
+  CreateBitScanLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86::VisitLongNumberOfTrailingZeros(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Register in_lo = locations->InAt(0).AsRegisterPairLow<Register>();
+  Register in_hi = locations->InAt(0).AsRegisterPairHigh<Register>();
+  Register out = locations->Out().AsRegister<Register>();
+  bool has_tzcnt = codegen_->GetInstructionSetFeatures().HasTzCnt();
+
+  Label low_zero, done;
+  __ testl(in_lo, in_lo);
+  __ j(kEqual, &low_zero);
+  GenTrailingZerosOfNonZero(assembler, has_tzcnt, out, in_lo, 0);
+  __ jmp(&done);
+
+  // The low half is zero: count in the high half and add 32.
+  __ Bind(&low_zero);
+  if (has_tzcnt) {
+    // TZCNT returns 32 for zero, which gives the expected 64.
+    GenTrailingZerosOfNonZero(assembler, has_tzcnt, out, in_hi, 32);
+  } else {
+    Label all_zero;
+    __ testl(in_hi, in_hi);
+    __ j(kEqual, &all_zero);
+    GenTrailingZerosOfNonZero(assembler, has_tzcnt, out, in_hi, 32);
+    __ jmp(&done);
+    __ Bind(&all_zero);
+    __ movl(out, Immediate(64));
+  }
+  __ Bind(&done);
+}
+
+static void CreateRotateLocations(ArenaAllocator* arena, HInvoke* invoke, bool is_long) {
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  // The distance needs to be in CL or a constant.
+  locations->SetInAt(1, Location::ByteRegisterOrConstant(ECX, invoke->InputAt(1)));
+  locations->SetOut(Location::SameAsFirstInput());
+  if (is_long) {
+    locations->AddTemp(Location::RequiresRegister());
+  }
+}
+
+static void GenIntegerRotate(LocationSummary* locations, bool is_left, X86Assembler* assembler) {
+  Register reg = locations->Out().AsRegister<Register>();
+  Location distance = locations->InAt(1);
+
+  if (distance.IsRegister()) {
+    DCHECK_EQ(ECX, distance.AsRegister<Register>());
+    if (is_left) {
+      __ roll(reg, ECX);
+    } else {
+      __ rorl(reg, ECX);
+    }
+  } else {
+    int32_t value = distance.GetConstant()->AsIntConstant()->GetValue() & 31;
+    if (value == 0) {
+      return;
+    }
+    if (is_left) {
+      __ roll(reg, Immediate(value));
+    } else {
+      __ rorl(reg, Immediate(value));
+    }
+  }
+}
+
+static void GenLongRotate(LocationSummary* locations, bool is_left, X86Assembler* assembler) {
+  Register lo = locations->Out().AsRegisterPairLow<Register>();
+  Register hi = locations->Out().AsRegisterPairHigh<Register>();
+  Register temp = locations->GetTemp(0).AsRegister<Register>();
+  Location distance = locations->InAt(1);
+
+  // A rotation by 32 exchanges the halves, and the rest of the distance is done
+  // with a pair of double precision shifts.
+  if (distance.IsRegister()) {
+    DCHECK_EQ(ECX, distance.AsRegister<Register>());
+    // The double precision shifts only use the low 5 bits of CL.
+    if (is_left) {
+      __ movl(temp, hi);
+      __ shld(hi, lo, ECX);
+      __ shld(lo, temp, ECX);
+    } else {
+      __ movl(temp, lo);
+      __ shrd(lo, hi, ECX);
+      __ shrd(hi, temp, ECX);
+    }
+    Label done;
+    __ testl(ECX, Immediate(32));
+    __ j(kEqual, &done);
+    __ xchgl(lo, hi);
+    __ Bind(&done);
+  } else {
+    int32_t value = distance.GetConstant()->AsIntConstant()->GetValue() & 63;
+    if (value >= 32) {
+      __ xchgl(lo, hi);
+      value -= 32;
+    }
+    if (value == 0) {
+      return;
+    }
+    Immediate imm(value);
+    if (is_left) {
+      __ movl(temp, hi);
+      __ shld(hi, lo, imm);
+      __ shld(lo, temp, imm);
+    } else {
+      __ movl(temp, lo);
+      __ shrd(lo, hi, imm);
+      __ shrd(hi, temp, imm);
+    }
+  }
+}
+
+void IntrinsicLocationsBuilderX86::VisitIntegerRotateRight(HInvoke* invoke) {
+  CreateRotateLocations(arena_, invoke, false);
+}
+
+void IntrinsicCodeGeneratorX86::VisitIntegerRotateRight(HInvoke* invoke) {
+  GenIntegerRotate(invoke->GetLocations(), false, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderX86::VisitLongRotateRight(HInvoke* invoke) {
+  CreateRotateLocations(arena_, invoke, true);
+}
+
+void IntrinsicCodeGeneratorX86::VisitLongRotateRight(HInvoke* invoke) {
+  GenLongRotate(invoke->GetLocations(), false, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderX86::VisitIntegerRotateLeft(HInvoke* invoke) {
+  CreateRotateLocations(arena_, invoke, false);
+}
+
+void IntrinsicCodeGeneratorX86::VisitIntegerRotateLeft(HInvoke* invoke) {
+  GenIntegerRotate(invoke->GetLocations(), true, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderX86::VisitLongRotateLeft(HInvoke* invoke) {
+  CreateRotateLocations(arena_, invoke, true);
+}
+
+void IntrinsicCodeGeneratorX86::VisitLongRotateLeft(HInvoke* invoke) {
+  GenLongRotate(invoke->GetLocations(), true, GetAssembler());
+}
+
+static void CreateHighestOneBitLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  // The output must not share ECX, which is written before it.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+  // The index of the bit is used as a shift count.
+  locations->AddTemp(Location::RegisterLocation(ECX));
+}
+
+// Set `out` to the highest set bit of `in`, or to zero if `in` is zero.
+static void GenHighestOneBit(X86Assembler* assembler, Register out, Register in) {
+  Label done;
+  __ bsrl(ECX, in);
+  // MOV does not change the flags set by BSR.
+  __ movl(out, Immediate(0));
+  __ j(kEqual, &done);
+  __ movl(out, Immediate(1));
+  __ shll(out, ECX);
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderX86::VisitIntegerHighestOneBit(HInvoke* invoke) {
+  CreateHighestOneBitLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86::VisitIntegerHighestOneBit(HInvoke* invoke) {
+  LocationSummary* locations = invoke->GetLocations();
+  GenHighestOneBit(GetAssembler(),
+                   locations->Out().AsRegister<Register>(),
+                   locations->InAt(0).AsRegister<Register>());
+}
+
+void IntrinsicLocationsBuilderX86::VisitLongHighestOneBit(HInvoke* invoke) {
+  CreateHighestOneBitLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86::VisitLongHighestOneBit(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Register in_lo = locations->InAt(0).AsRegisterPairLow<Register>();
+  Register in_hi = locations->InAt(0).AsRegisterPairHigh<Register>();
+  Register out_lo = locations->Out().AsRegisterPairLow<Register>();
+  Register out_hi = locations->Out().AsRegisterPairHigh<Register>();
+
+  Label high_zero, done;
+  __ testl(in_hi, in_hi);
+  __ j(kEqual, &high_zero);
+  GenHighestOneBit(assembler, out_hi, in_hi);
+  __ movl(out_lo, Immediate(0));
+  __ jmp(&done);
+  __ Bind(&high_zero);
+  GenHighestOneBit(assembler, out_lo, in_lo);
+  __ movl(out_hi, Immediate(0));
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderX86::VisitIntegerSignum(HInvoke* invoke) {
+  LocationSummary* locations = new (arena_) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetOut(Location::SameAsFirstInput());
+  locations->AddTemp(Location::RequiresRegister());
+}
+
+void IntrinsicCodeGeneratorX86::VisitIntegerSignum(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Register out = locations->Out().AsRegister<Register>();
+  Register temp = locations->GetTemp(0).AsRegister<Register>();
+
+  // signum(x) = (x >> 31) | (-x >>> 31).
+  __ movl(temp, out);
+  __ negl(temp);
+  __ shrl(temp, Immediate(31));
+  __ sarl(out, Immediate(31));
+  __ orl(out, temp);
+}
+
+void IntrinsicLocationsBuilderX86::VisitLongSignum(HInvoke* invoke) {
+  LocationSummary* locations = new (arena_) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  // The output is written after the temporary is computed.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+  locations->AddTemp(Location::RequiresRegister());
+}
+
+void IntrinsicCodeGeneratorX86::VisitLongSignum(HInvoke* invoke) {
+  X86Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  Register in_lo = locations->InAt(0).AsRegisterPairLow<Register>();
+  Register in_hi = locations->InAt(0).AsRegisterPairHigh<Register>();
+  Register out = locations->Out().AsRegister<Register>();
+  Register temp = locations->GetTemp(0).AsRegister<Register>();
+
+  // temp = (x != 0) ? 1 : 0, using the carry set by NEG for a non zero value.
+  __ movl(temp, in_lo);
+  __ orl(temp, in_hi);
+  __ negl(temp);
+  __ sbbl(temp, temp);
+  __ negl(temp);
+  // out = (x >> 63) | temp.
+  __ movl(out, in_hi);
+  __ sarl(out, Immediate(31));
+  __ orl(out, temp);
+}
+
 // Unimplemented intrinsics.
 
 #define UNIMPLEMENTED_INTRINSIC(Name)                                                   \
@@ -1032,7 +1032,7 @@ void IntrinsicCodeGeneratorX86_64::VisitStringCharAt(HInvoke* invoke) {
   __ Bind(slow_path->GetExitLabel());
 }
 
-void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
+static void CreateSystemArrayCopyLocations(ArenaAllocator* arena, HInvoke* invoke) {
   // Check to see if we have known failures that will cause us to have to bail
   // to the usual runtime, and just generate the runtime call directly.
   HIntConstant* src_pos = invoke->InputAt(1)->AsIntConstant();
@@ -1055,9 +1055,9 @@ void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyChar(HInvoke* invoke)
     }
   }
 
-  LocationSummary* locations = new (arena_) LocationSummary(invoke,
-                                                            LocationSummary::kCallOnSlowPath,
-                                                            kIntrinsified);
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kCallOnSlowPath,
+                                                           kIntrinsified);
   // arraycopy(Object src, int srcPos, Object dest, int destPos, int length).
   locations->SetInAt(0, Location::RequiresRegister());
   locations->SetInAt(1, Location::RegisterOrConstant(invoke->InputAt(1)));
@@ -1065,12 +1065,24 @@ void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyChar(HInvoke* invoke)
   locations->SetInAt(3, Location::RegisterOrConstant(invoke->InputAt(3)));
   locations->SetInAt(4, Location::RegisterOrConstant(invoke->InputAt(4)));
 
-  // And we need some temporaries.  We will use REP STOSW, so we need fixed registers.
+  // And we need some temporaries.  We will use REP MOVS, so we need fixed registers.
   locations->AddTemp(Location::RegisterLocation(RSI));
   locations->AddTemp(Location::RegisterLocation(RDI));
   locations->AddTemp(Location::RegisterLocation(RCX));
 }
 
+void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
+  CreateSystemArrayCopyLocations(arena_, invoke);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyByte(HInvoke* invoke) {
+  CreateSystemArrayCopyLocations(arena_, invoke);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitSystemArrayCopyInt(HInvoke* invoke) {
+  CreateSystemArrayCopyLocations(arena_, invoke);
+}
+
 static void CheckPosition(X86_64Assembler* assembler,
                           Location pos,
                           CpuRegister input,
@@ -1118,8 +1130,11 @@ static void CheckPosition(X86_64Assembler* assembler,
   }
 }
 
-void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
-  X86_64Assembler* assembler = GetAssembler();
+static void GenSystemArrayCopy(HInvoke* invoke,
+                               Primitive::Type type,
+                               X86_64Assembler* assembler,
+                               CodeGeneratorX86_64* codegen,
+                               ArenaAllocator* allocator) {
   LocationSummary* locations = invoke->GetLocations();
 
   CpuRegister src = locations->InAt(0).AsRegister<CpuRegister>();
@@ -1133,8 +1148,8 @@ void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
   int32_t destPos_const =
     destPos.IsConstant() ? destPos.GetConstant()->AsIntConstant()->GetValue() : 0;
 
-  SlowPathCodeX86_64* slow_path = new (GetAllocator()) IntrinsicSlowPathX86_64(invoke);
-  codegen_->AddSlowPath(slow_path);
+  SlowPathCodeX86_64* slow_path = new (allocator) IntrinsicSlowPathX86_64(invoke);
+  codegen->AddSlowPath(slow_path);
 
   // Bail if the source and destination are the same.
   __ cmpl(src, dest);
@@ -1148,7 +1163,7 @@ void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
   __ testl(dest, dest);
   __ j(kEqual, slow_path->GetEntryLabel());
 
-  // If the length is > 128 elements (256 bytes) or negative, bail.
+  // If the length is > 128 elements or negative, bail.
   if (!length.IsConstant()) {
     // Runtime test to check the length.
     __ cmpl(length.AsRegister<CpuRegister>(), Immediate(128));
@@ -1175,31 +1190,290 @@ void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
   CheckPosition(assembler, destPos, dest, count, slow_path, src_base, dest_base);
 
   // Okay, everything checks out.  Finally time to do the copy.
-  int32_t data_offset = mirror::Array::DataOffset(2).Int32Value();
+  const size_t element_size = Primitive::ComponentSize(type);
+  const ScaleFactor scale = static_cast<ScaleFactor>(Primitive::ComponentSizeShift(type));
+  int32_t data_offset = mirror::Array::DataOffset(element_size).Int32Value();
 
   DCHECK_EQ(src_base.AsRegister(), RSI);
   DCHECK_EQ(dest_base.AsRegister(), RDI);
 
   if (srcPos.IsConstant()) {
-    __ leal(src_base, Address(src, 2 * srcPos_const + data_offset));
+    __ leal(src_base, Address(src, element_size * srcPos_const + data_offset));
   } else {
-    __ leal(src_base, Address(src, srcPos.AsRegister<CpuRegister>(),
-                              ScaleFactor::TIMES_2, data_offset));
+    __ leal(src_base, Address(src, srcPos.AsRegister<CpuRegister>(), scale, data_offset));
   }
   if (destPos.IsConstant()) {
-    __ leal(dest_base, Address(dest, 2 * destPos_const + data_offset));
+    __ leal(dest_base, Address(dest, element_size * destPos_const + data_offset));
   } else {
-    __ leal(dest_base, Address(dest, destPos.AsRegister<CpuRegister>(),
-                               ScaleFactor::TIMES_2, data_offset));
+    __ leal(dest_base, Address(dest, destPos.AsRegister<CpuRegister>(), scale, data_offset));
   }
 
   // Do the move.
-  __ rep_movsw();
+  switch (type) {
+    case Primitive::kPrimByte:
+      __ rep_movsb();
+      break;
+    case Primitive::kPrimChar:
+      __ rep_movsw();
+      break;
+    case Primitive::kPrimInt:
+      __ rep_movsl();
+      break;
+    default:
+      LOG(FATAL) << "Unexpected type for System.arraycopy " << type;
+      UNREACHABLE();
+  }
 
   // Finished!
   __ Bind(slow_path->GetExitLabel());
 }
 
+void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyChar(HInvoke* invoke) {
+  GenSystemArrayCopy(invoke, Primitive::kPrimChar, GetAssembler(), codegen_, GetAllocator());
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyByte(HInvoke* invoke) {
+  GenSystemArrayCopy(invoke, Primitive::kPrimByte, GetAssembler(), codegen_, GetAllocator());
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitSystemArrayCopyInt(HInvoke* invoke) {
+  GenSystemArrayCopy(invoke, Primitive::kPrimInt, GetAssembler(), codegen_, GetAllocator());
+}
+
+// Compare `count` bytes of data of two objects, starting at `data_offset`. With SSE4.1,
+// the data is compared 16 bytes at a time with PTEST. The blocks are loaded unaligned,
+// and the last block overlaps the previous one rather than reading past the objects.
+// Jumps to `equal` or `not_equal`. `count` and the temporaries are clobbered.
+static void GenerateVectorCompare(X86_64Assembler* assembler,
+                                  CpuRegister left,
+                                  CpuRegister right,
+                                  CpuRegister count,
+                                  CpuRegister temp1,
+                                  CpuRegister temp2,
+                                  XmmRegister xmm1,
+                                  XmmRegister xmm2,
+                                  int32_t data_offset,
+                                  Label* equal,
+                                  Label* not_equal) {
+  Label less_than_16, less_than_8, vector_loop, byte_loop;
+
+  __ cmpl(count, Immediate(16));
+  __ j(kLess, &less_than_16);
+
+  // Compare the last 16 bytes first, so that the loop only deals with whole blocks.
+  __ movdqu(xmm1, Address(left, count, ScaleFactor::TIMES_1, data_offset - 16));
+  __ movdqu(xmm2, Address(right, count, ScaleFactor::TIMES_1, data_offset - 16));
+  __ pxor(xmm1, xmm2);
+  __ ptest(xmm1, xmm1);
+  __ j(kNotEqual, not_equal);
+  __ subl(count, Immediate(16));
+  __ xorl(temp1, temp1);
+  __ Bind(&vector_loop);
+  __ cmpl(temp1, count);
+  __ j(kGreaterEqual, equal);
+  __ movdqu(xmm1, Address(left, temp1, ScaleFactor::TIMES_1, data_offset));
+  __ movdqu(xmm2, Address(right, temp1, ScaleFactor::TIMES_1, data_offset));
+  __ pxor(xmm1, xmm2);
+  __ ptest(xmm1, xmm1);
+  __ j(kNotEqual, not_equal);
+  __ addl(temp1, Immediate(16));
+  __ jmp(&vector_loop);
+
+  // 8 to 15 bytes: compare the first and the last 8 bytes.
+  __ Bind(&less_than_16);
+  __ cmpl(count, Immediate(8));
+  __ j(kLess, &less_than_8);
+  __ movsd(xmm1, Address(left, data_offset));
+  __ movsd(xmm2, Address(right, data_offset));
+  __ pxor(xmm1, xmm2);
+  __ ptest(xmm1, xmm1);
+  __ j(kNotEqual, not_equal);
+  __ movsd(xmm1, Address(left, count, ScaleFactor::TIMES_1, data_offset - 8));
+  __ movsd(xmm2, Address(right, count, ScaleFactor::TIMES_1, data_offset - 8));
+  __ pxor(xmm1, xmm2);
+  __ ptest(xmm1, xmm1);
+  __ j(kNotEqual, not_equal);
+  __ jmp(equal);
+
+  // 4 to 7 bytes: compare the first and the last 4 bytes.
+  __ Bind(&less_than_8);
+  __ cmpl(count, Immediate(4));
+  __ j(kLess, &byte_loop);
+  __ movl(temp1, Address(left, data_offset));
+  __ cmpl(temp1, Address(right, data_offset));
+  __ j(kNotEqual, not_equal);
+  __ movl(temp1, Address(left, count, ScaleFactor::TIMES_1, data_offset - 4));
+  __ cmpl(temp1, Address(right, count, ScaleFactor::TIMES_1, data_offset - 4));
+  __ j(kNotEqual, not_equal);
+  __ jmp(equal);
+
+  // Less than 4 bytes: compare them one at a time.
+  __ Bind(&byte_loop);
+  __ testl(count, count);
+  __ j(kEqual, equal);
+  __ movzxb(temp1, Address(left, count, ScaleFactor::TIMES_1, data_offset - 1));
+  __ movzxb(temp2, Address(right, count, ScaleFactor::TIMES_1, data_offset - 1));
+  __ cmpl(temp1, temp2);
+  __ j(kNotEqual, not_equal);
+  __ subl(count, Immediate(1));
+  __ jmp(&byte_loop);
+}
+
+static void CreateVectorCompareLocations(ArenaAllocator* arena,
+                                         HInvoke* invoke,
+                                         CodeGeneratorX86_64* codegen) {
+  // PTEST is part of SSE4.1.
+  if (!codegen->GetInstructionSetFeatures().HasSSE4_1()) {
+    return;
+  }
+
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  // The result is only written once the inputs are no longer needed.
+  locations->SetOut(Location::SameAsFirstInput());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+static void GenArraysEquals(HInvoke* invoke, Primitive::Type type, X86_64Assembler* assembler) {
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister left = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister right = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister count = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister temp1 = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister temp2 = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister xmm1 = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister xmm2 = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+
+  const int32_t length_offset = mirror::Array::LengthOffset().Int32Value();
+  const int32_t data_offset =
+      mirror::Array::DataOffset(Primitive::ComponentSize(type)).Int32Value();
+
+  Label equal, not_equal, done;
+
+  // The same array, including two null arrays, is equal to itself.
+  __ cmpl(left, right);
+  __ j(kEqual, &equal);
+  __ testl(left, left);
+  __ j(kEqual, &not_equal);
+  __ testl(right, right);
+  __ j(kEqual, &not_equal);
+
+  // The arrays must have the same length.
+  __ movl(count, Address(left, length_offset));
+  __ cmpl(count, Address(right, length_offset));
+  __ j(kNotEqual, &not_equal);
+
+  // Compare the elements as bytes.
+  size_t shift = Primitive::ComponentSizeShift(type);
+  if (shift != 0) {
+    __ shll(count, Immediate(shift));
+  }
+  GenerateVectorCompare(assembler, left, right, count, temp1, temp2, xmm1, xmm2,
+                        data_offset, &equal, &not_equal);
+
+  __ Bind(&equal);
+  __ movl(out, Immediate(1));
+  __ jmp(&done);
+
+  __ Bind(&not_equal);
+  __ xorl(out, out);
+
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysEqualsByte(HInvoke* invoke) {
+  CreateVectorCompareLocations(arena_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysEqualsByte(HInvoke* invoke) {
+  GenArraysEquals(invoke, Primitive::kPrimByte, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysEqualsChar(HInvoke* invoke) {
+  CreateVectorCompareLocations(arena_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysEqualsChar(HInvoke* invoke) {
+  GenArraysEquals(invoke, Primitive::kPrimChar, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysEqualsInt(HInvoke* invoke) {
+  CreateVectorCompareLocations(arena_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysEqualsInt(HInvoke* invoke) {
+  GenArraysEquals(invoke, Primitive::kPrimInt, GetAssembler());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitArraysFillInt(HInvoke* invoke) {
+  LocationSummary* locations = new (arena_) LocationSummary(invoke,
+                                                            LocationSummary::kCallOnSlowPath,
+                                                            kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetInAt(1, Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitArraysFillInt(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  CpuRegister array = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister value = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister count = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister index = locations->GetTemp(1).AsRegister<CpuRegister>();
+  XmmRegister values = locations->GetTemp(2).AsFpuRegister<XmmRegister>();
+
+  const int32_t length_offset = mirror::Array::LengthOffset().Int32Value();
+  const int32_t data_offset = mirror::Array::DataOffset(sizeof(int32_t)).Int32Value();
+
+  // The call throws the NullPointerException.
+  SlowPathCodeX86_64* slow_path = new (GetAllocator()) IntrinsicSlowPathX86_64(invoke);
+  codegen_->AddSlowPath(slow_path);
+  __ testl(array, array);
+  __ j(kEqual, slow_path->GetEntryLabel());
+
+  Label vector_loop, scalar_loop;
+  __ movl(count, Address(array, length_offset));
+  __ cmpl(count, Immediate(4));
+  __ j(kLess, &scalar_loop);
+
+  // Store 4 elements at a time. The last block is stored first, and may overlap the
+  // previous one.
+  __ movd(values, value, false);
+  __ pshufd(values, values, Immediate(0));
+  __ movdqu(Address(array, count, ScaleFactor::TIMES_4, data_offset - 16), values);
+  __ subl(count, Immediate(4));
+  __ xorl(index, index);
+  __ Bind(&vector_loop);
+  __ cmpl(index, count);
+  __ j(kGreaterEqual, slow_path->GetExitLabel());
+  __ movdqu(Address(array, index, ScaleFactor::TIMES_4, data_offset), values);
+  __ addl(index, Immediate(4));
+  __ jmp(&vector_loop);
+
+  // Less than 4 elements: store them one at a time.
+  __ Bind(&scalar_loop);
+  __ testl(count, count);
+  __ j(kEqual, slow_path->GetExitLabel());
+  __ movl(Address(array, count, ScaleFactor::TIMES_4, data_offset - 4), value);
+  __ subl(count, Immediate(1));
+  __ jmp(&scalar_loop);
+
+  __ Bind(slow_path->GetExitLabel());
+}
+
 void IntrinsicLocationsBuilderX86_64::VisitStringCompareTo(HInvoke* invoke) {
   LocationSummary* locations = new (arena_) LocationSummary(invoke,
                                                             LocationSummary::kCall,
@@ -1228,6 +1502,162 @@ void IntrinsicCodeGeneratorX86_64::VisitStringCompareTo(HInvoke* invoke) {
   __ Bind(slow_path->GetExitLabel());
 }
 
+void IntrinsicLocationsBuilderX86_64::VisitStringEquals(HInvoke* invoke) {
+  CreateVectorCompareLocations(arena_, invoke, codegen_);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitStringEquals(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  CpuRegister str = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister arg = locations->InAt(1).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister count = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister temp1 = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister temp2 = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister xmm1 = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister xmm2 = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+
+  const int32_t class_offset = mirror::Object::ClassOffset().Int32Value();
+  const int32_t count_offset = mirror::String::CountOffset().Int32Value();
+  const int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+
+  Label equal, not_equal, done;
+
+  __ cmpl(str, arg);
+  __ j(kEqual, &equal);
+  __ testl(arg, arg);
+  __ j(kEqual, &not_equal);
+
+  // String is final: the argument is a string if it has the same class as the receiver.
+  __ movl(temp1, Address(str, class_offset));
+  __ cmpl(temp1, Address(arg, class_offset));
+  __ j(kNotEqual, &not_equal);
+
+  // The strings must have the same length.
+  __ movl(count, Address(str, count_offset));
+  __ cmpl(count, Address(arg, count_offset));
+  __ j(kNotEqual, &not_equal);
+
+  // Compare the characters as bytes.
+  __ shll(count, Immediate(1));
+  GenerateVectorCompare(assembler, str, arg, count, temp1, temp2, xmm1, xmm2,
+                        value_offset, &equal, &not_equal);
+
+  __ Bind(&equal);
+  __ movl(out, Immediate(1));
+  __ jmp(&done);
+
+  __ Bind(&not_equal);
+  __ xorl(out, out);
+
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitStringHashCode(HInvoke* invoke) {
+  // PMULLD is part of SSE4.1.
+  if (!codegen_->GetInstructionSetFeatures().HasSSE4_1()) {
+    return;
+  }
+
+  LocationSummary* locations = new (arena_) LocationSummary(invoke,
+                                                            LocationSummary::kNoCall,
+                                                            kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+  locations->AddTemp(Location::RequiresFpuRegister());
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitStringHashCode(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+
+  // Note that the null check must have been done earlier.
+  DCHECK(!invoke->CanDoImplicitNullCheckOn(invoke->InputAt(0)));
+
+  CpuRegister str = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister count = locations->GetTemp(0).AsRegister<CpuRegister>();
+  CpuRegister index = locations->GetTemp(1).AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(2).AsRegister<CpuRegister>();
+  XmmRegister hashes = locations->GetTemp(3).AsFpuRegister<XmmRegister>();
+  XmmRegister chars = locations->GetTemp(4).AsFpuRegister<XmmRegister>();
+  XmmRegister factor = locations->GetTemp(5).AsFpuRegister<XmmRegister>();
+  XmmRegister zero = locations->GetTemp(6).AsFpuRegister<XmmRegister>();
+
+  const int32_t hash_code_offset = mirror::String::HashCodeOffset().Int32Value();
+  const int32_t count_offset = mirror::String::CountOffset().Int32Value();
+  const int32_t value_offset = mirror::String::ValueOffset().Int32Value();
+
+  Label vector_loop, scalar_loop, store, done;
+
+  // The hash code is cached in the string once computed.
+  __ movl(out, Address(str, hash_code_offset));
+  __ testl(out, out);
+  __ j(kNotEqual, &done);
+
+  __ movl(count, Address(str, count_offset));
+  __ xorl(index, index);
+  __ cmpl(count, Immediate(4));
+  __ j(kLess, &scalar_loop);
+
+  // Lane i of `hashes` hashes the characters 4 * k + i: hash = hash * 31^4 + c.
+  __ pxor(hashes, hashes);
+  __ pxor(zero, zero);
+  __ movl(temp, Immediate(31 * 31 * 31 * 31));
+  __ movd(factor, temp, false);
+  __ pshufd(factor, factor, Immediate(0));
+  __ Bind(&vector_loop);
+  __ movsd(chars, Address(str, index, ScaleFactor::TIMES_2, value_offset));
+  __ punpcklwd(chars, zero);
+  __ pmulld(hashes, factor);
+  __ paddd(hashes, chars);
+  __ addl(index, Immediate(4));
+  __ leal(temp, Address(index, 4));
+  __ cmpl(temp, count);
+  __ j(kLessEqual, &vector_loop);
+
+  // Combine the lanes: hash = lane0 * 31^3 + lane1 * 31^2 + lane2 * 31 + lane3.
+  __ movd(out, hashes, false);
+  __ imull(out, out, Immediate(31 * 31 * 31));
+  __ pshufd(chars, hashes, Immediate(0x55));
+  __ movd(temp, chars, false);
+  __ imull(temp, temp, Immediate(31 * 31));
+  __ addl(out, temp);
+  __ pshufd(chars, hashes, Immediate(0xAA));
+  __ movd(temp, chars, false);
+  __ imull(temp, temp, Immediate(31));
+  __ addl(out, temp);
+  __ pshufd(chars, hashes, Immediate(0xFF));
+  __ movd(temp, chars, false);
+  __ addl(out, temp);
+
+  // The remaining characters.
+  __ Bind(&scalar_loop);
+  __ cmpl(index, count);
+  __ j(kGreaterEqual, &store);
+  __ imull(out, out, Immediate(31));
+  __ movzxw(temp, Address(str, index, ScaleFactor::TIMES_2, value_offset));
+  __ addl(out, temp);
+  __ addl(index, Immediate(1));
+  __ jmp(&scalar_loop);
+
+  __ Bind(&store);
+  __ movl(Address(str, hash_code_offset), out);
+
+  __ Bind(&done);
+}
+
 static void CreateStringIndexOfLocations(HInvoke* invoke,
                                          ArenaAllocator* allocator,
                                          bool start_at_zero) {
@@ -2012,6 +2442,340 @@ void IntrinsicCodeGeneratorX86_64::VisitLongReverse(HInvoke* invoke) {
   SwapBits64(reg, temp1, temp2, 4, INT64_C(0x0f0f0f0f0f0f0f0f), assembler);
 }
 
+static void CreateBitCountLocations(ArenaAllocator* arena,
+                                    CodeGeneratorX86_64* codegen,
+                                    HInvoke* invoke) {
+  if (!codegen->GetInstructionSetFeatures().HasPopCnt()) {
+    // Without POPCNT, the library implementation is as good as we can do inline.
+    return;
+  }
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitIntegerBitCount(HInvoke* invoke) {
+  CreateBitCountLocations(arena_, codegen_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitIntegerBitCount(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  __ popcntl(locations->Out().AsRegister<CpuRegister>(),
+             locations->InAt(0).AsRegister<CpuRegister>());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitLongBitCount(HInvoke* invoke) {
+  CreateBitCountLocations(arena_, codegen_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitLongBitCount(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  __ popcntq(locations->Out().AsRegister<CpuRegister>(),
+             locations->InAt(0).AsRegister<CpuRegister>());
+}
+
+static void CreateBitScanLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetOut(Location::RequiresRegister());
+}
+
+static void GenLeadingZeros(X86_64Assembler* assembler,
+                            bool has_lzcnt,
+                            LocationSummary* locations,
+                            bool is_long) {
+  CpuRegister in = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  int32_t bits = is_long ? 64 : 32;
+
+  if (has_lzcnt) {
+    if (is_long) {
+      __ lzcntq(out, in);
+    } else {
+      __ lzcntl(out, in);
+    }
+    return;
+  }
+
+  // BSR gives the index of the highest set bit, so the count is (bits - 1) - index,
+  // and it leaves its destination undefined for a zero input.
+  Label zero, done;
+  if (is_long) {
+    __ bsrq(out, in);
+  } else {
+    __ bsrl(out, in);
+  }
+  __ j(kEqual, &zero);
+  __ xorl(out, Immediate(bits - 1));
+  __ jmp(&done);
+  __ Bind(&zero);
+  __ movl(out, Immediate(bits));
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitIntegerNumberOfLeadingZeros(HInvoke* invoke) {
+  CreateBitScanLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitIntegerNumberOfLeadingZeros(HInvoke* invoke) {
+  GenLeadingZeros(GetAssembler(),
+                  codegen_->GetInstructionSetFeatures().HasLzCnt(),
+                  invoke->GetLocations(),
+                  false);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitLongNumberOfLeadingZeros(HInvoke* invoke) {
+  CreateBitScanLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitLongNumberOfLeadingZeros(HInvoke* invoke) {
+  GenLeadingZeros(GetAssembler(),
+                  codegen_->GetInstructionSetFeatures().HasLzCnt(),
+                  invoke->GetLocations(),
+                  true);
+}
+
+static void GenTrailingZeros(X86_64Assembler* assembler,
+                             bool has_tzcnt,
+                             LocationSummary* locations,
+                             bool is_long) {
+  CpuRegister in = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+
+  if (has_tzcnt) {
+    if (is_long) {
+      __ tzcntq(out, in);
+    } else {
+      __ tzcntl(out, in);
+    }
+    return;
+  }
+
+  // BSF gives the index of the lowest set bit, which is the count, and it leaves
+  // its destination undefined for a zero input.
+  Label done;
+  if (is_long) {
+    __ bsfq(out, in);
+  } else {
+    __ bsfl(out, in);
+  }
+  __ j(kNotEqual, &done);
+  __ movl(out, Immediate(is_long ? 64 : 32));
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitIntegerNumberOfTrailingZeros(HInvoke* invoke) {
+  CreateBitScanLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitIntegerNumberOfTrailingZeros(HInvoke* invoke) {
+  GenTrailingZeros(GetAssembler(),
+                   codegen_->GetInstructionSetFeatures().HasTzCnt(),
+                   invoke->GetLocations(),
+                   false);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitLongNumberOfTrailingZeros(HInvoke* invoke) {
+  CreateBitScanLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitLongNumberOfTrailingZeros(HInvoke* invoke) {
+  GenTrailingZeros(GetAssembler(),
+                   codegen_->GetInstructionSetFeatures().HasTzCnt(),
+                   invoke->GetLocations(),
+                   true);
+}
+
+static void CreateRotateLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  // The distance needs to be in CL or a constant.
+  locations->SetInAt(1, Location::ByteRegisterOrConstant(RCX, invoke->InputAt(1)));
+  locations->SetOut(Location::SameAsFirstInput());
+}
+
+static void GenRotate(X86_64Assembler* assembler,
+                      LocationSummary* locations,
+                      bool is_left,
+                      bool is_long) {
+  CpuRegister reg = locations->Out().AsRegister<CpuRegister>();
+  Location distance = locations->InAt(1);
+
+  if (distance.IsRegister()) {
+    CpuRegister shifter = distance.AsRegister<CpuRegister>();
+    DCHECK_EQ(RCX, shifter.AsRegister());
+    if (is_long) {
+      if (is_left) {
+        __ rolq(reg, shifter);
+      } else {
+        __ rorq(reg, shifter);
+      }
+    } else {
+      if (is_left) {
+        __ roll(reg, shifter);
+      } else {
+        __ rorl(reg, shifter);
+      }
+    }
+  } else {
+    int32_t value = distance.GetConstant()->AsIntConstant()->GetValue() & (is_long ? 63 : 31);
+    if (value == 0) {
+      return;
+    }
+    Immediate imm(value);
+    if (is_long) {
+      if (is_left) {
+        __ rolq(reg, imm);
+      } else {
+        __ rorq(reg, imm);
+      }
+    } else {
+      if (is_left) {
+        __ roll(reg, imm);
+      } else {
+        __ rorl(reg, imm);
+      }
+    }
+  }
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitIntegerRotateRight(HInvoke* invoke) {
+  CreateRotateLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitIntegerRotateRight(HInvoke* invoke) {
+  GenRotate(GetAssembler(), invoke->GetLocations(), false, false);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitLongRotateRight(HInvoke* invoke) {
+  CreateRotateLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitLongRotateRight(HInvoke* invoke) {
+  GenRotate(GetAssembler(), invoke->GetLocations(), false, true);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitIntegerRotateLeft(HInvoke* invoke) {
+  CreateRotateLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitIntegerRotateLeft(HInvoke* invoke) {
+  GenRotate(GetAssembler(), invoke->GetLocations(), true, false);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitLongRotateLeft(HInvoke* invoke) {
+  CreateRotateLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitLongRotateLeft(HInvoke* invoke) {
+  GenRotate(GetAssembler(), invoke->GetLocations(), true, true);
+}
+
+static void CreateHighestOneBitLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  // The output must not share RCX, which is written before it.
+  locations->SetOut(Location::RequiresRegister(), Location::kOutputOverlap);
+  // The index of the bit is used as a shift count.
+  locations->AddTemp(Location::RegisterLocation(RCX));
+}
+
+static void GenHighestOneBit(X86_64Assembler* assembler,
+                             LocationSummary* locations,
+                             bool is_long) {
+  CpuRegister in = locations->InAt(0).AsRegister<CpuRegister>();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister shifter = locations->GetTemp(0).AsRegister<CpuRegister>();
+
+  Label done;
+  if (is_long) {
+    __ bsrq(shifter, in);
+  } else {
+    __ bsrl(shifter, in);
+  }
+  // MOV does not change the flags set by BSR.
+  __ movl(out, Immediate(0));
+  __ j(kEqual, &done);
+  __ movl(out, Immediate(1));
+  if (is_long) {
+    __ shlq(out, shifter);
+  } else {
+    __ shll(out, shifter);
+  }
+  __ Bind(&done);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitIntegerHighestOneBit(HInvoke* invoke) {
+  CreateHighestOneBitLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitIntegerHighestOneBit(HInvoke* invoke) {
+  GenHighestOneBit(GetAssembler(), invoke->GetLocations(), false);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitLongHighestOneBit(HInvoke* invoke) {
+  CreateHighestOneBitLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitLongHighestOneBit(HInvoke* invoke) {
+  GenHighestOneBit(GetAssembler(), invoke->GetLocations(), true);
+}
+
+static void CreateSignumLocations(ArenaAllocator* arena, HInvoke* invoke) {
+  LocationSummary* locations = new (arena) LocationSummary(invoke,
+                                                           LocationSummary::kNoCall,
+                                                           kIntrinsified);
+  locations->SetInAt(0, Location::RequiresRegister());
+  locations->SetOut(Location::SameAsFirstInput());
+  locations->AddTemp(Location::RequiresRegister());
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitIntegerSignum(HInvoke* invoke) {
+  CreateSignumLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitIntegerSignum(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(0).AsRegister<CpuRegister>();
+
+  // signum(x) = (x >> 31) | (-x >>> 31).
+  __ movl(temp, out);
+  __ negl(temp);
+  __ shrl(temp, Immediate(31));
+  __ sarl(out, Immediate(31));
+  __ orl(out, temp);
+}
+
+void IntrinsicLocationsBuilderX86_64::VisitLongSignum(HInvoke* invoke) {
+  CreateSignumLocations(arena_, invoke);
+}
+
+void IntrinsicCodeGeneratorX86_64::VisitLongSignum(HInvoke* invoke) {
+  X86_64Assembler* assembler = GetAssembler();
+  LocationSummary* locations = invoke->GetLocations();
+  CpuRegister out = locations->Out().AsRegister<CpuRegister>();
+  CpuRegister temp = locations->GetTemp(0).AsRegister<CpuRegister>();
+
+  // signum(x) = (x >> 63) | (-x >>> 63), of which only the low half is kept.
+  __ movq(temp, out);
+  __ negq(temp);
+  __ shrq(temp, Immediate(63));
+  __ sarq(out, Immediate(63));
+  __ orl(out, temp);
+}
+
 // Unimplemented intrinsics.
 
 #define UNIMPLEMENTED_INTRINSIC(Name)                                                   \
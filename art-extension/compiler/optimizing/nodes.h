@@ -935,6 +935,10 @@ class HLoopInformationOutwardIterator : public ValueObject {
   M(SubRHSMemory, InstructionRHSMemory)                                 \
   M(Suspend, Instruction)                                               \
   M(TestSuspend, Instruction)                                           \
+  M(X86PackedArrayGet, Instruction)                                     \
+  M(X86PackedArraySet, Instruction)                                     \
+  M(X86PackedBinaryOperation, Instruction)                              \
+  M(X86PackedReplicate, Instruction)                                    \
   M(X86SelectValue, Instruction)
 
 #define FOR_EACH_CONCRETE_INSTRUCTION_X86(M)                            \
@@ -3101,13 +3105,20 @@ class HInvokeInterface : public HInvoke {
 
 class HNewInstance : public HExpression<0> {
  public:
-  HNewInstance(uint32_t dex_pc, uint16_t type_index, QuickEntrypointEnum entrypoint)
+  HNewInstance(uint32_t dex_pc,
+               uint16_t type_index,
+               QuickEntrypointEnum entrypoint,
+               bool finalizable)
       : HExpression(Primitive::kPrimNot, SideEffects::None(), dex_pc),
         type_index_(type_index),
-        entrypoint_(entrypoint) {}
+        entrypoint_(entrypoint),
+        finalizable_(finalizable) {}
 
   uint16_t GetTypeIndex() const { return type_index_; }
 
+  // The finalizer of the object may read its fields once it is unreachable.
+  bool IsFinalizable() const { return finalizable_; }
+
   // Calls runtime so needs an environment.
   bool NeedsEnvironment() const OVERRIDE { return true; }
   // It may throw when called on:
@@ -3125,6 +3136,7 @@ class HNewInstance : public HExpression<0> {
  private:
   const uint16_t type_index_;
   const QuickEntrypointEnum entrypoint_;
+  const bool finalizable_;
 
   DISALLOW_COPY_AND_ASSIGN(HNewInstance);
 };
@@ -4577,6 +4589,140 @@ class HX86SelectValue : public HExpression<4> {
   DISALLOW_COPY_AND_ASSIGN(HX86SelectValue);
 };
 
+// Size in bytes of a packed (SIMD) value on x86.
+static constexpr size_t kX86PackedVectorSize = 16;
+
+// The packed instructions below are created by the loop vectorizer. A packed value
+// lives in one XMM register: it is typed as kPrimDouble so that the register allocator
+// gives it a floating point register, and its lanes have the type GetPackedType().
+// Spill slots and slow path saves only preserve the low 64 bits of an XMM register,
+// so a packed value must never be live across a call or a suspend check. The register
+// allocator aborts rather than split or spill one.
+class HX86PackedArrayGet : public HExpression<2> {
+ public:
+  HX86PackedArrayGet(HInstruction* array,
+                     HInstruction* index,
+                     Primitive::Type packed_type,
+                     uint32_t dex_pc = kNoDexPc)
+      : HExpression(Primitive::kPrimDouble, SideEffects::DependsOnSomething(), dex_pc),
+        packed_type_(packed_type) {
+    SetRawInputAt(0, array);
+    SetRawInputAt(1, index);
+  }
+
+  bool CanBeMoved() const OVERRIDE { return true; }
+  bool InstructionDataEquals(HInstruction* other) const OVERRIDE {
+    return packed_type_ == other->AsX86PackedArrayGet()->GetPackedType();
+  }
+
+  HInstruction* GetArray() const { return InputAt(0); }
+  HInstruction* GetIndex() const { return InputAt(1); }
+  Primitive::Type GetPackedType() const { return packed_type_; }
+
+  DECLARE_INSTRUCTION(X86PackedArrayGet);
+
+ private:
+  const Primitive::Type packed_type_;
+
+  DISALLOW_COPY_AND_ASSIGN(HX86PackedArrayGet);
+};
+
+// Store a packed value to consecutive array elements, starting at the given index.
+class HX86PackedArraySet : public HTemplateInstruction<3> {
+ public:
+  HX86PackedArraySet(HInstruction* array,
+                     HInstruction* index,
+                     HInstruction* value,
+                     Primitive::Type packed_type,
+                     uint32_t dex_pc = kNoDexPc)
+      : HTemplateInstruction(SideEffects::ChangesSomething(), dex_pc),
+        packed_type_(packed_type) {
+    SetRawInputAt(0, array);
+    SetRawInputAt(1, index);
+    SetRawInputAt(2, value);
+  }
+
+  HInstruction* GetArray() const { return InputAt(0); }
+  HInstruction* GetIndex() const { return InputAt(1); }
+  HInstruction* GetValue() const { return InputAt(2); }
+  Primitive::Type GetPackedType() const { return packed_type_; }
+
+  DECLARE_INSTRUCTION(X86PackedArraySet);
+
+ private:
+  const Primitive::Type packed_type_;
+
+  DISALLOW_COPY_AND_ASSIGN(HX86PackedArraySet);
+};
+
+// Lane-wise arithmetic on two packed values.
+class HX86PackedBinaryOperation : public HExpression<2> {
+ public:
+  enum OperationKind {
+    kAdd,
+    kSub,
+    kMul,
+    kAnd,
+    kOr,
+    kXor,
+  };
+
+  HX86PackedBinaryOperation(OperationKind kind,
+                            Primitive::Type packed_type,
+                            HInstruction* left,
+                            HInstruction* right)
+      : HExpression(Primitive::kPrimDouble, SideEffects::None()),
+        kind_(kind),
+        packed_type_(packed_type) {
+    SetRawInputAt(0, left);
+    SetRawInputAt(1, right);
+  }
+
+  bool CanBeMoved() const OVERRIDE { return true; }
+  bool InstructionDataEquals(HInstruction* other) const OVERRIDE {
+    HX86PackedBinaryOperation* other_op = other->AsX86PackedBinaryOperation();
+    return kind_ == other_op->GetOperationKind() && packed_type_ == other_op->GetPackedType();
+  }
+
+  HInstruction* GetLeft() const { return InputAt(0); }
+  HInstruction* GetRight() const { return InputAt(1); }
+  OperationKind GetOperationKind() const { return kind_; }
+  Primitive::Type GetPackedType() const { return packed_type_; }
+
+  DECLARE_INSTRUCTION(X86PackedBinaryOperation);
+
+ private:
+  const OperationKind kind_;
+  const Primitive::Type packed_type_;
+
+  DISALLOW_COPY_AND_ASSIGN(HX86PackedBinaryOperation);
+};
+
+// Broadcast a scalar value to every lane of a packed value.
+class HX86PackedReplicate : public HExpression<1> {
+ public:
+  HX86PackedReplicate(HInstruction* value, Primitive::Type packed_type)
+      : HExpression(Primitive::kPrimDouble, SideEffects::None()),
+        packed_type_(packed_type) {
+    SetRawInputAt(0, value);
+  }
+
+  bool CanBeMoved() const OVERRIDE { return true; }
+  bool InstructionDataEquals(HInstruction* other) const OVERRIDE {
+    return packed_type_ == other->AsX86PackedReplicate()->GetPackedType();
+  }
+
+  HInstruction* GetValue() const { return InputAt(0); }
+  Primitive::Type GetPackedType() const { return packed_type_; }
+
+  DECLARE_INSTRUCTION(X86PackedReplicate);
+
+ private:
+  const Primitive::Type packed_type_;
+
+  DISALLOW_COPY_AND_ASSIGN(HX86PackedReplicate);
+};
+
 class MoveOperands : public ArenaObject<kArenaAllocMisc> {
  public:
   MoveOperands(Location source,
@@ -25,6 +25,7 @@
 #include "art_method-inl.h"
 #include "base/arena_allocator.h"
 #include "base/dumpable.h"
+#include "base/time_utils.h"
 #include "base/timing_logger.h"
 #include "boolean_simplifier.h"
 #include "bounds_check_elimination.h"
@@ -226,13 +227,16 @@ class OptimizingCompiler FINAL : public Compiler {
   // just run the code generation after the graph was built.
   const bool run_optimizations_;
 
-  // Optimize and compile `graph`.
+  // Optimize and compile `graph` with the passes of `tier`. Past `deadline_ns`, if it is not 0,
+  // only the passes the code generator relies on are run.
   CompiledMethod* CompileOptimized(HGraph* graph,
                                    CodeGenerator* codegen,
                                    CompilerDriver* driver,
                                    const DexFile& dex_file,
                                    const DexCompilationUnit& dex_compilation_unit,
-                                   PassInfoPrinter* pass_info) const;
+                                   PassInfoPrinter* pass_info,
+                                   OptimizationTier tier,
+                                   uint64_t deadline_ns) const;
 
   // Just compile without doing optimizations.
   CompiledMethod* CompileBaseline(CodeGenerator* codegen,
@@ -341,13 +345,15 @@ class BackendOptimizer : public HOptimization {
   }
 };
 
-static void RunOptimizations(HGraph* graph,
+static bool RunOptimizations(HGraph* graph,
                              CompilerDriver* driver,
                              OptimizingCompilerStats* stats,
                              const DexFile& dex_file,
                              const DexCompilationUnit& dex_compilation_unit,
                              PassInfoPrinter* pass_info_printer,
-                             StackHandleScopeCollection* handles) {
+                             StackHandleScopeCollection* handles,
+                             OptimizationTier tier,
+                             uint64_t deadline_ns) {
   ArenaAllocator* arena = graph->GetArena();
   HDeadCodeElimination* dce1 = new (arena) HDeadCodeElimination(graph, stats,
                             HDeadCodeElimination::kInitialDeadCodeEliminationPassName);
@@ -403,8 +409,64 @@ static void RunOptimizations(HGraph* graph,
     backend
   };
 
-  RunOptimizationsX86(graph, driver, stats, optimizations,
-          arraysize(optimizations), pass_info_printer, dex_compilation_unit);
+  // The passes run at O0.
+  HOptimization* required_optimizations[] = {
+    simplify3,
+    backend
+  };
+
+  if (tier == kOptimizationTierO0) {
+    return RunOptimizationsX86(graph, driver, stats, required_optimizations,
+            arraysize(required_optimizations), pass_info_printer, dex_compilation_unit,
+            tier, deadline_ns);
+  }
+  return RunOptimizationsX86(graph, driver, stats, optimizations,
+          arraysize(optimizations), pass_info_printer, dex_compilation_unit,
+          tier, deadline_ns);
+}
+
+// Methods bigger than this, in code units, are compiled at O1 at most, and at O0 unless they
+// are hot.
+static constexpr size_t kOptimizationTierO1MaxCodeUnits = 8000;
+// Methods bigger than this, in code units, or with more loops, are compiled at O2 only if the
+// profile says they are hot.
+static constexpr size_t kOptimizationTierO2MaxCodeUnits = 2000;
+static constexpr size_t kOptimizationTierO2MaxLoops = 32;
+
+// Select the passes run for a method, according to its size, its loops and the profile.
+// The expensive extension loop passes are kept for the methods where they pay off.
+static OptimizationTier SelectOptimizationTier(HGraph* graph,
+                                               const DexFile::CodeItem& code_item,
+                                               CompilerDriver* compiler_driver,
+                                               const std::string& method_name) {
+  if (!compiler_driver->GetCompilerOptions().GetOptimizationTiers()) {
+    return kOptimizationTierO2;
+  }
+  CompilerDriver::ProfileHotness hotness = compiler_driver->GetProfileHotness(method_name);
+  bool is_hot = (hotness == CompilerDriver::kProfileHotnessHot);
+  if (code_item.insns_size_in_code_units_ > kOptimizationTierO1MaxCodeUnits) {
+    return is_hot ? kOptimizationTierO1 : kOptimizationTierO0;
+  }
+  if (is_hot) {
+    return kOptimizationTierO2;
+  }
+  if (hotness == CompilerDriver::kProfileHotnessCold) {
+    return kOptimizationTierO1;
+  }
+  if (code_item.insns_size_in_code_units_ > kOptimizationTierO2MaxCodeUnits) {
+    return kOptimizationTierO1;
+  }
+  size_t number_of_loops = 0;
+  const GrowableArray<HBasicBlock*>& blocks = graph->GetBlocks();
+  for (size_t i = 0, e = blocks.Size(); i < e; ++i) {
+    HBasicBlock* block = blocks.Get(i);
+    if (block != nullptr && block->IsLoopHeader()) {
+      ++number_of_loops;
+    }
+  }
+  return (number_of_loops > kOptimizationTierO2MaxLoops)
+      ? kOptimizationTierO1
+      : kOptimizationTierO2;
 }
 
 // The stack map we generate must be 4-byte aligned on ARM. Since existing
@@ -423,6 +485,8 @@ static ArrayRef<const uint8_t> AlignVectorSize(std::vector<uint8_t>& vector) {
 // stack frame size set by option -Wframe-larger-than=1728.
 static void __attribute__((noinline)) AllocateRegisters(HGraph* graph,
                               CodeGenerator* codegen,
+                              RegisterAllocator::Strategy strategy,
+                              OptimizingCompilerStats* stats,
                               PassInfoPrinter* pass_info_printer) {
   PrepareForRegisterAllocation(graph).Run();
   SsaLivenessAnalysis liveness(graph, codegen);
@@ -432,10 +496,32 @@ static void __attribute__((noinline)) AllocateRegisters(HGraph* graph,
   }
   {
     PassInfo pass_info(RegisterAllocator::kRegisterAllocatorPassName, pass_info_printer);
-    RegisterAllocator(graph->GetArena(), codegen, liveness).AllocateRegisters();
+    RegisterAllocator(graph->GetArena(), codegen, liveness, strategy, stats).AllocateRegisters();
   }
 }
 
+// Select the register allocator of a method, according to the compiler options
+// and to the profile.
+static RegisterAllocator::Strategy GetRegisterAllocatorStrategy(
+    CompilerDriver* compiler_driver,
+    const DexCompilationUnit& dex_compilation_unit) {
+  switch (compiler_driver->GetCompilerOptions().GetRegisterAllocation()) {
+    case CompilerOptions::kRegisterAllocationLinearScan:
+      return RegisterAllocator::kStrategyLinearScan;
+    case CompilerOptions::kRegisterAllocationLoopAware:
+      return RegisterAllocator::kStrategyLoopAware;
+    case CompilerOptions::kRegisterAllocationLoopAwareHot: {
+      CompilerDriver::ProfileHotness hotness = compiler_driver->GetProfileHotness(
+          PrettyMethod(dex_compilation_unit.GetDexMethodIndex(),
+                       *dex_compilation_unit.GetDexFile()));
+      return (hotness == CompilerDriver::kProfileHotnessHot)
+          ? RegisterAllocator::kStrategyLoopAware
+          : RegisterAllocator::kStrategyLinearScan;
+    }
+  }
+  UNREACHABLE();
+}
+
 static ArenaVector<LinkerPatch> EmitAndSortLinkerPatches(CodeGenerator* codegen) {
   ArenaVector<LinkerPatch> linker_patches(codegen->GetGraph()->GetArena()->Adapter());
   codegen->EmitLinkerPatches(&linker_patches);
@@ -454,12 +540,24 @@ CompiledMethod* OptimizingCompiler::CompileOptimized(HGraph* graph,
                                                      CompilerDriver* compiler_driver,
                                                      const DexFile& dex_file,
                                                      const DexCompilationUnit& dex_compilation_unit,
-                                                     PassInfoPrinter* pass_info_printer) const {
+                                                     PassInfoPrinter* pass_info_printer,
+                                                     OptimizationTier tier,
+                                                     uint64_t deadline_ns) const {
   StackHandleScopeCollection handles(Thread::Current());
-  RunOptimizations(graph, compiler_driver, compilation_stats_.get(),
-                   dex_file, dex_compilation_unit, pass_info_printer, &handles);
+  bool within_budget = RunOptimizations(graph, compiler_driver, compilation_stats_.get(),
+                                        dex_file, dex_compilation_unit, pass_info_printer,
+                                        &handles, tier, deadline_ns);
+  if (!within_budget) {
+    MaybeRecordStat(MethodCompilationStat::kIntelOptimizationBudgetExceeded);
+  }
 
-  AllocateRegisters(graph, codegen, pass_info_printer);
+  AllocateRegisters(graph,
+                    codegen,
+                    (tier == kOptimizationTierO0 || !within_budget)
+                        ? RegisterAllocator::kStrategyLinearScan
+                        : GetRegisterAllocatorStrategy(compiler_driver, dex_compilation_unit),
+                    compilation_stats_.get(),
+                    pass_info_printer);
 
   CodeVectorAllocator allocator;
   DefaultSrcMap src_mapping_table;
@@ -540,6 +638,7 @@ CompiledMethod* OptimizingCompiler::TryCompile(const DexFile::CodeItem* code_ite
                                                jobject class_loader,
                                                const DexFile& dex_file) const {
   UNUSED(invoke_type);
+  uint64_t start_ns = NanoTime();
   std::string method_name = PrettyMethod(method_idx, dex_file);
   MaybeRecordStat(MethodCompilationStat::kAttemptCompilation);
   CompilerDriver* compiler_driver = GetCompilerDriver();
@@ -650,12 +749,23 @@ CompiledMethod* OptimizingCompiler::TryCompile(const DexFile::CodeItem* code_ite
       }
     }
 
-    return CompileOptimized(graph,
-                            codegen.get(),
-                            compiler_driver,
-                            dex_file,
-                            dex_compilation_unit,
-                            &pass_info_printer);
+    OptimizationTier tier =
+        SelectOptimizationTier(graph, *code_item, compiler_driver, method_name);
+    size_t budget_ms = compiler_options.GetOptimizationTimeBudgetMs();
+    uint64_t deadline_ns = (budget_ms != 0u) ? start_ns + MsToNs(budget_ms) : 0u;
+    VLOG(compiler) << "Optimization tier of " << method_name << ": O" << static_cast<int>(tier);
+    CompiledMethod* compiled_method = CompileOptimized(graph,
+                                                       codegen.get(),
+                                                       compiler_driver,
+                                                       dex_file,
+                                                       dex_compilation_unit,
+                                                       &pass_info_printer,
+                                                       tier,
+                                                       deadline_ns);
+    if (compilation_stats_.get() != nullptr) {
+      compilation_stats_->RecordCompileTime(tier, NanoTime() - start_ns);
+    }
+    return compiled_method;
   } else if (shouldOptimize && can_allocate_registers) {
     LOG(FATAL) << "Could not allocate registers in optimizing compiler";
     UNREACHABLE();
@@ -20,13 +20,23 @@
 #ifndef ART_COMPILER_OPTIMIZING_OPTIMIZING_COMPILER_STATS_H_
 #define ART_COMPILER_OPTIMIZING_OPTIMIZING_COMPILER_STATS_H_
 
+#include <algorithm>
 #include <sstream>
 #include <string>
 
 #include "atomic.h"
+#include "base/bit_utils.h"
 
 namespace art {
 
+// The sets of passes the optimizing compiler selects from for a method.
+enum OptimizationTier {
+  kOptimizationTierO0,  // Only the passes the code generator relies on.
+  kOptimizationTierO1,  // The AOSP passes.
+  kOptimizationTierO2,  // The AOSP passes and the extension passes.
+  kNumberOfOptimizationTiers
+};
+
 enum MethodCompilationStat {
   kAttemptCompilation = 0,
   kCompiledBaseline,
@@ -77,6 +87,26 @@ enum MethodCompilationStat {
   kIntelPureStaticCallDeleted,
   kIntelUselessNullCheckDeleted,
   kIntelLoopFullyUnrolled,
+  kIntelLoopVectorized,
+  kIntelLoopPartiallyUnrolled,
+  kIntelLoopVersioned,
+  kIntelLoopUnswitched,
+  kIntelLoadForwarded,
+  kIntelDeadStoreRemoved,
+  kIntelAllocationEliminated,
+  kIntelAllocationSunk,
+  kIntelProfileColdInvokeNotInlined,
+  kIntelProfileHotInvokeInlined,
+  kIntelMonomorphicInvokeInlined,
+  kIntelIVStrengthReduced,
+  kIntelLoopTestReplaced,
+  kIntelLoopInterchanged,
+  kIntelLoopFused,
+  kIntelLoopAwareRegisterAllocation,
+  kIntelRegisterSpills,
+  kIntelRegisterReloads,
+  kIntelIntrinsicFolded,
+  kIntelOptimizationBudgetExceeded,
   kLastStat
 };
 
@@ -88,6 +118,17 @@ class OptimizingCompilerStats {
     compile_stats_[stat] += count;
   }
 
+  // Records the time taken to compile a method at `tier`, in a histogram of power of two
+  // buckets of microseconds.
+  void RecordCompileTime(OptimizationTier tier, uint64_t time_ns) {
+    DCHECK_LT(tier, kNumberOfOptimizationTiers);
+    uint64_t time_us = time_ns / 1000u;
+    size_t bucket = std::min(static_cast<size_t>(MostSignificantBit(time_us) + 1),
+                             kNumberOfCompileTimeBuckets - 1u);
+    compile_time_histograms_[tier][bucket] += 1;
+    compile_times_us_[tier].FetchAndAddSequentiallyConsistent(time_us);
+  }
+
   void Log() const {
     if (compile_stats_[kAttemptCompilation] == 0) {
       LOG(INFO) << "Did not compile any method.";
@@ -112,6 +153,10 @@ class OptimizingCompilerStats {
           LOG(INFO) << PrintMethodCompilationStat(i) << ": " << compile_stats_[i];
         }
       }
+
+      for (size_t tier = 0; tier != kNumberOfOptimizationTiers; ++tier) {
+        LogCompileTimeHistogram(tier);
+      }
     }
   }
 
@@ -121,6 +166,34 @@ class OptimizingCompilerStats {
   }
 
  private:
+  // Bucket 0 counts the methods compiled in less than 1us, bucket i > 0 the methods compiled in
+  // [2^(i-1), 2^i) us, and the last bucket the slower ones.
+  static constexpr size_t kNumberOfCompileTimeBuckets = 24;
+
+  void LogCompileTimeHistogram(size_t tier) const {
+    int32_t methods = 0;
+    for (size_t bucket = 0; bucket != kNumberOfCompileTimeBuckets; ++bucket) {
+      methods += compile_time_histograms_[tier][bucket].LoadRelaxed();
+    }
+    if (methods == 0) {
+      return;
+    }
+    LOG(INFO) << "Compile time at O" << tier << ": " << methods << " methods in "
+              << compile_times_us_[tier].LoadRelaxed() / 1000u << "ms";
+    for (size_t bucket = 0; bucket != kNumberOfCompileTimeBuckets; ++bucket) {
+      int32_t count = compile_time_histograms_[tier][bucket].LoadRelaxed();
+      if (count != 0) {
+        uint64_t lower_us = (bucket == 0u) ? 0u : (UINT64_C(1) << (bucket - 1u));
+        std::ostringstream oss;
+        oss << "  >= " << lower_us << "us";
+        if (bucket + 1u != kNumberOfCompileTimeBuckets) {
+          oss << " and < " << (UINT64_C(1) << bucket) << "us";
+        }
+        LOG(INFO) << oss.str() << ": " << count;
+      }
+    }
+  }
+
   std::string PrintMethodCompilationStat(int stat) const {
     switch (stat) {
       case kAttemptCompilation : return "kAttemptCompilation";
@@ -172,6 +245,26 @@ class OptimizingCompilerStats {
       case kIntelPureStaticCallDeleted: return "kIntelPureStaticCallDeleted";
       case kIntelUselessNullCheckDeleted: return "kIntelUselessNullCheckDeleted";
       case kIntelLoopFullyUnrolled: return "kIntelLoopFullyUnrolled";
+      case kIntelLoopVectorized: return "kIntelLoopVectorized";
+      case kIntelLoopPartiallyUnrolled: return "kIntelLoopPartiallyUnrolled";
+      case kIntelLoopVersioned: return "kIntelLoopVersioned";
+      case kIntelLoopUnswitched: return "kIntelLoopUnswitched";
+      case kIntelLoadForwarded: return "kIntelLoadForwarded";
+      case kIntelDeadStoreRemoved: return "kIntelDeadStoreRemoved";
+      case kIntelAllocationEliminated: return "kIntelAllocationEliminated";
+      case kIntelAllocationSunk: return "kIntelAllocationSunk";
+      case kIntelProfileColdInvokeNotInlined: return "kIntelProfileColdInvokeNotInlined";
+      case kIntelProfileHotInvokeInlined: return "kIntelProfileHotInvokeInlined";
+      case kIntelMonomorphicInvokeInlined: return "kIntelMonomorphicInvokeInlined";
+      case kIntelIVStrengthReduced: return "kIntelIVStrengthReduced";
+      case kIntelLoopTestReplaced: return "kIntelLoopTestReplaced";
+      case kIntelLoopInterchanged: return "kIntelLoopInterchanged";
+      case kIntelLoopFused: return "kIntelLoopFused";
+      case kIntelLoopAwareRegisterAllocation: return "kIntelLoopAwareRegisterAllocation";
+      case kIntelRegisterSpills: return "kIntelRegisterSpills";
+      case kIntelRegisterReloads: return "kIntelRegisterReloads";
+      case kIntelIntrinsicFolded: return "kIntelIntrinsicFolded";
+      case kIntelOptimizationBudgetExceeded: return "kIntelOptimizationBudgetExceeded";
       default: LOG(FATAL) << "invalid stat";
     }
     return "";
@@ -179,6 +272,9 @@ class OptimizingCompilerStats {
 
   AtomicInteger compile_stats_[kLastStat];
 
+  AtomicInteger compile_time_histograms_[kNumberOfOptimizationTiers][kNumberOfCompileTimeBuckets];
+  Atomic<uint64_t> compile_times_us_[kNumberOfOptimizationTiers];
+
   DISALLOW_COPY_AND_ASSIGN(OptimizingCompilerStats);
 };
 
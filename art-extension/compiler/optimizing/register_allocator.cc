@@ -24,6 +24,7 @@
 
 #include "base/bit_vector-inl.h"
 #include "code_generator.h"
+#include "optimizing_compiler_stats.h"
 #include "ssa_liveness_analysis.h"
 
 namespace art {
@@ -31,6 +32,11 @@ namespace art {
 static constexpr size_t kMaxLifetimePosition = -1;
 static constexpr size_t kDefaultNumberOfSpillSlots = 4;
 
+// A use in a loop weighs 2^kLoopDepthWeightShift times more than a use in the
+// enclosing code, up to kMaxWeightedLoopDepth nested loops.
+static constexpr size_t kLoopDepthWeightShift = 3;
+static constexpr size_t kMaxWeightedLoopDepth = 6;
+
 // For simplicity, we implement register pairs as (reg, reg + 1).
 // Note that this is a requirement for double registers on ARM, since we
 // allocate SRegister.
@@ -42,10 +48,14 @@ static bool IsLowOfUnalignedPairInterval(LiveInterval* low) {
 
 RegisterAllocator::RegisterAllocator(ArenaAllocator* allocator,
                                      CodeGenerator* codegen,
-                                     const SsaLivenessAnalysis& liveness)
+                                     const SsaLivenessAnalysis& liveness,
+                                     Strategy strategy,
+                                     OptimizingCompilerStats* stats)
       : allocator_(allocator),
         codegen_(codegen),
         liveness_(liveness),
+        strategy_(strategy),
+        stats_(stats),
         unhandled_core_intervals_(allocator, 0),
         unhandled_fp_intervals_(allocator, 0),
         unhandled_(nullptr),
@@ -63,6 +73,7 @@ RegisterAllocator::RegisterAllocator(ArenaAllocator* allocator,
         processing_core_registers_(false),
         number_of_registers_(-1),
         registers_array_(nullptr),
+        spill_weights_array_(nullptr),
         blocked_core_registers_(codegen->GetBlockedCoreRegisters()),
         blocked_fp_registers_(codegen->GetBlockedFloatingPointRegisters()),
         reserved_out_slots_(0),
@@ -99,6 +110,9 @@ static bool ShouldProcess(bool processing_core_registers, LiveInterval* interval
 void RegisterAllocator::AllocateRegisters() {
   AllocateRegistersInternal();
   Resolve();
+  if (stats_ != nullptr) {
+    RecordSpillStats();
+  }
 
   if (kIsDebugBuild) {
     processing_core_registers_ = true;
@@ -166,6 +180,7 @@ void RegisterAllocator::AllocateRegistersInternal() {
 
   number_of_registers_ = codegen_->GetNumberOfCoreRegisters();
   registers_array_ = allocator_->AllocArray<size_t>(number_of_registers_);
+  spill_weights_array_ = allocator_->AllocArray<size_t>(number_of_registers_);
   processing_core_registers_ = true;
   unhandled_ = &unhandled_core_intervals_;
   for (size_t i = 0, e = physical_core_register_intervals_.Size(); i < e; ++i) {
@@ -186,6 +201,7 @@ void RegisterAllocator::AllocateRegistersInternal() {
 
   number_of_registers_ = codegen_->GetNumberOfFloatingPointRegisters();
   registers_array_ = allocator_->AllocArray<size_t>(number_of_registers_);
+  spill_weights_array_ = allocator_->AllocArray<size_t>(number_of_registers_);
   processing_core_registers_ = false;
   unhandled_ = &unhandled_fp_intervals_;
   for (size_t i = 0, e = physical_fp_register_intervals_.Size(); i < e; ++i) {
@@ -855,6 +871,43 @@ int RegisterAllocator::FindAvailableRegisterPair(size_t* next_use, size_t starti
   return reg;
 }
 
+int RegisterAllocator::FindCheapestRegister(size_t* next_use,
+                                            size_t* spill_weights,
+                                            size_t first_use) const {
+  int reg = kNoRegister;
+  // Among the registers that are free until the first use of the interval, pick the
+  // one whose intervals are the cheapest to spill, then the one that is used the last.
+  for (size_t i = 0; i < number_of_registers_; ++i) {
+    if (IsBlocked(i) || next_use[i] <= first_use) continue;
+    if (reg == kNoRegister
+        || spill_weights[i] < spill_weights[reg]
+        || (spill_weights[i] == spill_weights[reg] && next_use[i] > next_use[reg])) {
+      reg = i;
+    }
+  }
+  return reg;
+}
+
+size_t RegisterAllocator::GetSpillWeight(LiveInterval* interval, size_t position) const {
+  size_t weight = 0;
+  for (UsePosition* use = interval->GetFirstUse(); use != nullptr; use = use->GetNext()) {
+    if (use->GetPosition() < position) {
+      continue;
+    }
+    // Synthesized uses keep values alive until the end of the back edges of loops.
+    HBasicBlock* block = use->IsSynthesized()
+        ? liveness_.GetBlockFromPosition((use->GetPosition() - 1) / 2)
+        : use->GetUser()->GetBlock();
+    size_t depth = 0;
+    for (HLoopInformationOutwardIterator it(*block); !it.Done(); it.Advance()) {
+      ++depth;
+    }
+    depth = std::min(depth, kMaxWeightedLoopDepth);
+    weight += static_cast<size_t>(1) << (kLoopDepthWeightShift * depth);
+  }
+  return weight;
+}
+
 int RegisterAllocator::FindAvailableRegister(size_t* next_use) const {
   int reg = kNoRegister;
   // Pick the register that is used the last.
@@ -925,8 +978,11 @@ bool RegisterAllocator::AllocateBlockedReg(LiveInterval* current) {
 
   // First set all registers as not being used.
   size_t* next_use = registers_array_;
+  size_t* spill_weights = spill_weights_array_;
+  bool is_loop_aware = (strategy_ == kStrategyLoopAware);
   for (size_t i = 0; i < number_of_registers_; ++i) {
     next_use[i] = kMaxLifetimePosition;
+    spill_weights[i] = 0;
   }
 
   // For each active interval, find the next use of its register after the
@@ -941,6 +997,9 @@ bool RegisterAllocator::AllocateBlockedReg(LiveInterval* current) {
       if (use != kNoLifetime) {
         next_use[active->GetRegister()] = use;
       }
+      if (is_loop_aware) {
+        spill_weights[active->GetRegister()] += GetSpillWeight(active, current->GetStart());
+      }
     }
   }
 
@@ -969,6 +1028,9 @@ bool RegisterAllocator::AllocateBlockedReg(LiveInterval* current) {
         if (use != kNoLifetime) {
           next_use[inactive->GetRegister()] = std::min(use, next_use[inactive->GetRegister()]);
         }
+        if (is_loop_aware) {
+          spill_weights[inactive->GetRegister()] += GetSpillWeight(inactive, current->GetStart());
+        }
       }
     }
   }
@@ -987,7 +1049,10 @@ bool RegisterAllocator::AllocateBlockedReg(LiveInterval* current) {
       || (first_use >= next_use[GetHighForLowRegister(reg)]);
   } else {
     DCHECK(!current->IsHighInterval());
-    reg = FindAvailableRegister(next_use);
+    reg = is_loop_aware ? FindCheapestRegister(next_use, spill_weights, first_use) : kNoRegister;
+    if (reg == kNoRegister) {
+      reg = FindAvailableRegister(next_use);
+    }
     should_spill = (first_use >= next_use[reg]);
   }
 
@@ -1235,35 +1300,16 @@ void RegisterAllocator::AllocateSpillSlotFor(LiveInterval* interval) {
   }
   size_t end = last_sibling->GetEnd();
 
-  GrowableArray<size_t>* spill_slots = nullptr;
-  switch (interval->GetType()) {
-    case Primitive::kPrimDouble:
-      spill_slots = &double_spill_slots_;
-      break;
-    case Primitive::kPrimLong:
-      spill_slots = &long_spill_slots_;
-      break;
-    case Primitive::kPrimFloat:
-      spill_slots = &float_spill_slots_;
-      break;
-    case Primitive::kPrimNot:
-    case Primitive::kPrimInt:
-    case Primitive::kPrimChar:
-    case Primitive::kPrimByte:
-    case Primitive::kPrimBoolean:
-    case Primitive::kPrimShort:
-      spill_slots = &int_spill_slots_;
-      break;
-    case Primitive::kPrimVoid:
-      LOG(FATAL) << "Unexpected type for interval " << interval->GetType();
-  }
+  GrowableArray<size_t>* spill_slots = GetSpillSlotsFor(interval->GetType());
 
   // Find an available spill slot.
   size_t slot = 0;
-  for (size_t e = spill_slots->Size(); slot < e; ++slot) {
-    if (spill_slots->Get(slot) <= parent->GetStart()
-        && (slot == (e - 1) || spill_slots->Get(slot + 1) <= parent->GetStart())) {
-      break;
+  if (strategy_ != kStrategyLoopAware || !FindCoalescedSpillSlot(parent, *spill_slots, &slot)) {
+    for (size_t e = spill_slots->Size(); slot < e; ++slot) {
+      if (spill_slots->Get(slot) <= parent->GetStart()
+          && (slot == (e - 1) || spill_slots->Get(slot + 1) <= parent->GetStart())) {
+        break;
+      }
     }
   }
 
@@ -1293,6 +1339,100 @@ void RegisterAllocator::AllocateSpillSlotFor(LiveInterval* interval) {
   parent->SetSpillSlot(slot);
 }
 
+GrowableArray<size_t>* RegisterAllocator::GetSpillSlotsFor(Primitive::Type type) {
+  switch (type) {
+    case Primitive::kPrimDouble:
+      return &double_spill_slots_;
+    case Primitive::kPrimLong:
+      return &long_spill_slots_;
+    case Primitive::kPrimFloat:
+      return &float_spill_slots_;
+    case Primitive::kPrimNot:
+    case Primitive::kPrimInt:
+    case Primitive::kPrimChar:
+    case Primitive::kPrimByte:
+    case Primitive::kPrimBoolean:
+    case Primitive::kPrimShort:
+      return &int_spill_slots_;
+    case Primitive::kPrimVoid:
+      LOG(FATAL) << "Unexpected type for interval " << type;
+  }
+  UNREACHABLE();
+}
+
+bool RegisterAllocator::FindCoalescedSpillSlot(LiveInterval* parent,
+                                               const GrowableArray<size_t>& spill_slots,
+                                               size_t* slot) const {
+  // Sharing the spill slot of a phi with one of its inputs turns the move between
+  // them into a no-op when both are spilled, typically at the back edge of a loop.
+  HInstruction* defined_by = parent->GetDefinedBy();
+  GrowableArray<HInstruction*> partners(allocator_, 0);
+  if (defined_by->IsPhi()) {
+    for (size_t i = 0, e = defined_by->InputCount(); i < e; ++i) {
+      partners.Add(defined_by->InputAt(i));
+    }
+  }
+  for (HUseIterator<HInstruction*> it(defined_by->GetUses()); !it.Done(); it.Advance()) {
+    HInstruction* user = it.Current()->GetUser();
+    if (user->IsPhi()) {
+      partners.Add(user);
+    }
+  }
+
+  for (size_t i = 0, e = partners.Size(); i < e; ++i) {
+    HInstruction* partner = partners.Get(i);
+    LiveInterval* partner_interval = partner->GetLiveInterval();
+    // Parameters have their own stack slot.
+    if (partner_interval == nullptr
+        || partner->IsParameterValue()
+        || !partner_interval->HasSpillSlot()
+        || partner->GetType() != defined_by->GetType()) {
+      continue;
+    }
+    size_t partner_slot = partner_interval->GetSpillSlot();
+    // The slot must not be used by another interval during the lifetime of `parent`.
+    if (spill_slots.Get(partner_slot) <= parent->GetStart()
+        && (!parent->NeedsTwoSpillSlots()
+            || (partner_slot + 1 < spill_slots.Size()
+                && spill_slots.Get(partner_slot + 1) <= parent->GetStart()))) {
+      *slot = partner_slot;
+      return true;
+    }
+  }
+  return false;
+}
+
+void RegisterAllocator::RecordSpillStats() const {
+  size_t spills = 0;
+  size_t reloads = 0;
+  for (HLinearOrderIterator it(*codegen_->GetGraph()); !it.Done(); it.Advance()) {
+    for (HInstructionIterator inst_it(it.Current()->GetInstructions());
+         !inst_it.Done();
+         inst_it.Advance()) {
+      if (!inst_it.Current()->IsParallelMove()) {
+        continue;
+      }
+      HParallelMove* move = inst_it.Current()->AsParallelMove();
+      for (size_t i = 0, e = move->NumMoves(); i < e; ++i) {
+        Location source = move->MoveOperandsAt(i)->GetSource();
+        Location destination = move->MoveOperandsAt(i)->GetDestination();
+        bool is_source_stack = source.IsStackSlot() || source.IsDoubleStackSlot();
+        bool is_destination_stack = destination.IsStackSlot() || destination.IsDoubleStackSlot();
+        if (source.IsRegisterKind() && is_destination_stack) {
+          ++spills;
+        } else if (is_source_stack && destination.IsRegisterKind()) {
+          ++reloads;
+        }
+      }
+    }
+  }
+  if (strategy_ == kStrategyLoopAware) {
+    stats_->RecordStat(MethodCompilationStat::kIntelLoopAwareRegisterAllocation);
+  }
+  stats_->RecordStat(MethodCompilationStat::kIntelRegisterSpills, spills);
+  stats_->RecordStat(MethodCompilationStat::kIntelRegisterReloads, reloads);
+}
+
 static bool IsValidDestination(Location destination) {
   return destination.IsRegister()
       || destination.IsRegisterPair()
@@ -1732,6 +1872,16 @@ void RegisterAllocator::Resolve() {
     LiveInterval* current = instruction->GetLiveInterval();
     LocationSummary* locations = instruction->GetLocations();
     Location location = locations->Out();
+    // A packed value fills a whole XMM register, but spill slots and the moves between
+    // locations only preserve the low 64 bits. The loop vectorizer keeps the register
+    // pressure low enough for packed values to stay in one register.
+    if ((instruction->IsX86PackedArrayGet() ||
+         instruction->IsX86PackedBinaryOperation() ||
+         instruction->IsX86PackedReplicate()) &&
+        (current->HasSpillSlot() || current->GetNextSibling() != nullptr)) {
+      LOG(FATAL) << "Packed value " << instruction->DebugName() << " " << instruction->GetId()
+                 << " was split or spilled";
+    }
     if (instruction->IsParameterValue()) {
       // Now that we know the frame size, adjust the parameter's location.
       if (location.IsStackSlot()) {
@@ -31,6 +31,7 @@ class HInstruction;
 class HParallelMove;
 class LiveInterval;
 class Location;
+class OptimizingCompilerStats;
 class SsaLivenessAnalysis;
 
 /**
@@ -38,9 +39,21 @@ class SsaLivenessAnalysis;
  */
 class RegisterAllocator {
  public:
+  // How the allocator picks the interval to spill when no register is free.
+  enum Strategy {
+    // Spill the interval whose next use is the furthest.
+    kStrategyLinearScan,
+    // Spill the interval whose remaining uses are the cheapest, weighting each use
+    // by the depth of the loop it is in, and share the spill slots of phis and
+    // their inputs when their lifetimes do not overlap.
+    kStrategyLoopAware,
+  };
+
   RegisterAllocator(ArenaAllocator* allocator,
                     CodeGenerator* codegen,
-                    const SsaLivenessAnalysis& analysis);
+                    const SsaLivenessAnalysis& analysis,
+                    Strategy strategy = kStrategyLinearScan,
+                    OptimizingCompilerStats* stats = nullptr);
 
   // Main entry point for the register allocator. Given the liveness analysis,
   // allocates registers to live intervals.
@@ -103,6 +116,22 @@ class RegisterAllocator {
   // Allocate a spill slot for the given interval.
   void AllocateSpillSlotFor(LiveInterval* interval);
 
+  // Return the spill slots for values of the given type.
+  GrowableArray<size_t>* GetSpillSlotsFor(Primitive::Type type);
+
+  // Find the spill slot of a phi, or of an input of a phi, that `parent` can share
+  // because their lifetimes do not overlap. Returns whether such a slot was found.
+  bool FindCoalescedSpillSlot(LiveInterval* parent,
+                              const GrowableArray<size_t>& spill_slots,
+                              size_t* slot) const;
+
+  // Return the cost of spilling `interval` at `position`: the sum of its uses after
+  // `position`, each weighted by the depth of the loop it is in.
+  size_t GetSpillWeight(LiveInterval* interval, size_t position) const;
+
+  // Record the number of spills and reloads inserted by the allocator.
+  void RecordSpillStats() const;
+
   // Connect adjacent siblings within blocks.
   void ConnectSiblings(LiveInterval* interval);
 
@@ -143,6 +172,10 @@ class RegisterAllocator {
   int FindAvailableRegisterPair(size_t* next_use, size_t starting_at) const;
   int FindAvailableRegister(size_t* next_use) const;
 
+  // Find the register whose intervals are the cheapest to spill among the ones that
+  // are not used before `first_use`. Returns kNoRegister if there is none.
+  int FindCheapestRegister(size_t* next_use, size_t* spill_weights, size_t first_use) const;
+
   // Try splitting an active non-pair or unaligned pair interval at the given `position`.
   // Returns whether it was successful at finding such an interval.
   bool TrySplitNonPairOrUnalignedPairIntervalAt(size_t position,
@@ -159,6 +192,8 @@ class RegisterAllocator {
   ArenaAllocator* const allocator_;
   CodeGenerator* const codegen_;
   const SsaLivenessAnalysis& liveness_;
+  const Strategy strategy_;
+  OptimizingCompilerStats* const stats_;
 
   // List of intervals for core registers that must be processed, ordered by start
   // position. Last entry is the interval that has the lowest start position.
@@ -214,6 +249,9 @@ class RegisterAllocator {
   // Temporary array, allocated ahead of time for simplicity.
   size_t* registers_array_;
 
+  // Temporary array for the spill weights of the registers, used by kStrategyLoopAware.
+  size_t* spill_weights_array_;
+
   // Blocked registers, as decided by the code generator.
   bool* const blocked_core_registers_;
   bool* const blocked_fp_registers_;
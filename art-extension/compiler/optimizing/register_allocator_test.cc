@@ -35,7 +35,8 @@ namespace art {
 // Note: the register allocator tests rely on the fact that constants have live
 // intervals and registers get allocated to them.
 
-static bool Check(const uint16_t* data) {
+static bool Check(const uint16_t* data,
+                  RegisterAllocator::Strategy strategy = RegisterAllocator::kStrategyLinearScan) {
   ArenaPool pool;
   ArenaAllocator allocator(&pool);
   HGraph* graph = CreateGraph(&allocator);
@@ -48,7 +49,7 @@ static bool Check(const uint16_t* data) {
   x86::CodeGeneratorX86 codegen(graph, *features_x86.get(), CompilerOptions());
   SsaLivenessAnalysis liveness(graph, &codegen);
   liveness.Analyze();
-  RegisterAllocator register_allocator(&allocator, &codegen, liveness);
+  RegisterAllocator register_allocator(&allocator, &codegen, liveness, strategy);
   register_allocator.AllocateRegisters();
   return register_allocator.Validate(false);
 }
@@ -203,6 +204,7 @@ TEST(RegisterAllocatorTest, Loop1) {
     Instruction::RETURN | 1 << 8);
 
   ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(Check(data, RegisterAllocator::kStrategyLoopAware));
 }
 
 TEST(RegisterAllocatorTest, Loop2) {
@@ -252,6 +254,7 @@ TEST(RegisterAllocatorTest, Loop2) {
     Instruction::RETURN | 1 << 8);
 
   ASSERT_TRUE(Check(data));
+  ASSERT_TRUE(Check(data, RegisterAllocator::kStrategyLoopAware));
 }
 
 static HGraph* BuildSSAGraph(const uint16_t* data, ArenaAllocator* allocator) {
@@ -38,6 +38,8 @@ void StackMapStream::BeginStackMapEntry(uint32_t dex_pc,
   current_entry_.inline_infos_start_index = inline_infos_.Size();
   current_entry_.dex_register_map_hash = 0;
   current_entry_.same_dex_register_map_as_ = kNoSameDexMapFound;
+  current_entry_.inline_info_hash = inlining_depth;
+  current_entry_.same_inline_info_as_ = kNoSameInlineInfoFound;
   if (num_dex_registers != 0) {
     current_entry_.live_dex_registers_mask =
         new (allocator_) ArenaBitVector(allocator_, num_dex_registers, true);
@@ -48,10 +50,6 @@ void StackMapStream::BeginStackMapEntry(uint32_t dex_pc,
   if (sp_mask != nullptr) {
     stack_mask_max_ = std::max(stack_mask_max_, sp_mask->GetHighestBitSet());
   }
-  if (inlining_depth > 0) {
-    number_of_stack_maps_with_inline_info_++;
-  }
-
   dex_pc_max_ = std::max(dex_pc_max_, dex_pc);
   native_pc_offset_max_ = std::max(native_pc_offset_max_, native_pc_offset);
   register_mask_max_ = std::max(register_mask_max_, register_mask);
@@ -59,6 +57,7 @@ void StackMapStream::BeginStackMapEntry(uint32_t dex_pc,
 
 void StackMapStream::EndStackMapEntry() {
   current_entry_.same_dex_register_map_as_ = FindEntryWithTheSameDexMap();
+  current_entry_.same_inline_info_as_ = FindEntryWithTheSameInlineInfo();
   stack_maps_.Add(current_entry_);
   current_entry_ = StackMapEntry();
 }
@@ -103,6 +102,9 @@ void StackMapStream::AddInlineInfoEntry(uint32_t method_index, uint32_t dex_pc)
   entry.method_index = method_index;
   entry.dex_pc = dex_pc;
   inline_infos_.Add(entry);
+
+  current_entry_.inline_info_hash = current_entry_.inline_info_hash * 31 + method_index;
+  current_entry_.inline_info_hash = current_entry_.inline_info_hash * 31 + dex_pc;
 }
 
 size_t StackMapStream::PrepareForFillIn() {
@@ -182,9 +184,15 @@ size_t StackMapStream::ComputeDexRegisterMapsSize() const {
 }
 
 size_t StackMapStream::ComputeInlineInfoSize() const {
-  return inline_infos_.Size() * InlineInfo::SingleEntrySize()
-    // For encoding the depth.
-    + (number_of_stack_maps_with_inline_info_ * InlineInfo::kFixedSize);
+  size_t size = 0;
+  for (size_t i = 0; i < stack_maps_.Size(); ++i) {
+    StackMapEntry entry = stack_maps_.Get(i);
+    if (entry.inlining_depth != 0 && entry.same_inline_info_as_ == kNoSameInlineInfoFound) {
+      // Entries with the same inline info will have the same offset.
+      size += InlineInfo::kFixedSize + entry.inlining_depth * InlineInfo::SingleEntrySize();
+    }
+  }
+  return size;
 }
 
 void StackMapStream::FillIn(MemoryRegion region) {
@@ -283,7 +291,12 @@ void StackMapStream::FillIn(MemoryRegion region) {
     }
 
     // Set the inlining info.
-    if (entry.inlining_depth != 0) {
+    if (entry.same_inline_info_as_ != kNoSameInlineInfoFound) {
+      // If we have a hit reuse the offset.
+      stack_map.SetInlineDescriptorOffset(code_info,
+          code_info.GetStackMapAt(entry.same_inline_info_as_)
+                   .GetInlineDescriptorOffset(code_info));
+    } else if (entry.inlining_depth != 0) {
       MemoryRegion inline_region = inline_infos_region.Subregion(
           next_inline_info_offset,
           InlineInfo::kFixedSize + entry.inlining_depth * InlineInfo::SingleEntrySize());
@@ -361,4 +374,43 @@ bool StackMapStream::HaveTheSameDexMaps(const StackMapEntry& a, const StackMapEn
   return true;
 }
 
+size_t StackMapStream::FindEntryWithTheSameInlineInfo() {
+  if (current_entry_.inlining_depth == 0) {
+    return kNoSameInlineInfoFound;
+  }
+  size_t current_entry_index = stack_maps_.Size();
+  auto entries_it = inline_info_hash_to_stack_map_indices_.find(current_entry_.inline_info_hash);
+  if (entries_it == inline_info_hash_to_stack_map_indices_.end()) {
+    GrowableArray<uint32_t> stack_map_indices(allocator_, 1);
+    stack_map_indices.Add(current_entry_index);
+    inline_info_hash_to_stack_map_indices_.Put(current_entry_.inline_info_hash, stack_map_indices);
+    return kNoSameInlineInfoFound;
+  }
+
+  // We might have collisions, so we need to check whether or not we really have a match.
+  for (size_t i = 0; i < entries_it->second.Size(); i++) {
+    size_t test_entry_index = entries_it->second.Get(i);
+    if (HaveTheSameInlineInfos(stack_maps_.Get(test_entry_index), current_entry_)) {
+      return test_entry_index;
+    }
+  }
+  entries_it->second.Add(current_entry_index);
+  return kNoSameInlineInfoFound;
+}
+
+bool StackMapStream::HaveTheSameInlineInfos(const StackMapEntry& a,
+                                            const StackMapEntry& b) const {
+  if (a.inlining_depth != b.inlining_depth) {
+    return false;
+  }
+  for (size_t i = 0; i < a.inlining_depth; i++) {
+    InlineInfoEntry a_entry = inline_infos_.Get(a.inline_infos_start_index + i);
+    InlineInfoEntry b_entry = inline_infos_.Get(b.inline_infos_start_index + i);
+    if (a_entry.method_index != b_entry.method_index || a_entry.dex_pc != b_entry.dex_pc) {
+      return false;
+    }
+  }
+  return true;
+}
+
 }  // namespace art
@@ -72,8 +72,8 @@ class StackMapStream : public ValueObject {
         dex_pc_max_(0),
         native_pc_offset_max_(0),
         register_mask_max_(0),
-        number_of_stack_maps_with_inline_info_(0),
         dex_map_hash_to_stack_map_indices_(std::less<uint32_t>(), allocator->Adapter()),
+        inline_info_hash_to_stack_map_indices_(std::less<uint32_t>(), allocator->Adapter()),
         current_entry_(),
         stack_mask_size_(0),
         inline_info_size_(0),
@@ -99,6 +99,8 @@ class StackMapStream : public ValueObject {
     BitVector* live_dex_registers_mask;
     uint32_t dex_register_map_hash;
     size_t same_dex_register_map_as_;
+    uint32_t inline_info_hash;
+    size_t same_inline_info_as_;
   };
 
   struct InlineInfoEntry {
@@ -136,6 +138,11 @@ class StackMapStream : public ValueObject {
   size_t FindEntryWithTheSameDexMap();
   bool HaveTheSameDexMaps(const StackMapEntry& a, const StackMapEntry& b) const;
 
+  // Returns the index of an entry with the same inline info as the current_entry,
+  // or kNoSameInlineInfoFound if no such entry exists.
+  size_t FindEntryWithTheSameInlineInfo();
+  bool HaveTheSameInlineInfos(const StackMapEntry& a, const StackMapEntry& b) const;
+
   ArenaAllocator* allocator_;
   GrowableArray<StackMapEntry> stack_maps_;
 
@@ -154,9 +161,9 @@ class StackMapStream : public ValueObject {
   uint32_t dex_pc_max_;
   uint32_t native_pc_offset_max_;
   uint32_t register_mask_max_;
-  size_t number_of_stack_maps_with_inline_info_;
 
   ArenaSafeMap<uint32_t, GrowableArray<uint32_t>> dex_map_hash_to_stack_map_indices_;
+  ArenaSafeMap<uint32_t, GrowableArray<uint32_t>> inline_info_hash_to_stack_map_indices_;
 
   StackMapEntry current_entry_;
   size_t stack_mask_size_;
@@ -171,6 +178,7 @@ class StackMapStream : public ValueObject {
   size_t needed_size_;
 
   static constexpr uint32_t kNoSameDexMapFound = -1;
+  static constexpr uint32_t kNoSameInlineInfoFound = -1;
 
   DISALLOW_COPY_AND_ASSIGN(StackMapStream);
 };
@@ -408,8 +408,9 @@ TEST(StackMapTest, DexRegisterMapOffsetOverflow) {
   StackMap stack_map1 = code_info.GetStackMapAt(1);
   ASSERT_TRUE(stack_map1.HasDexRegisterMap(code_info));
   // ...the offset of the second Dex register map (relative to the
-  // beginning of the Dex register maps region) is 255 (i.e.,
-  // kNoDexRegisterMapSmallEncoding).
+  // beginning of the Dex register maps region) is 255 (i.e., the
+  // all-ones value of an 8-bit field, which must not be read as
+  // kNoDexRegisterMap).
   ASSERT_NE(stack_map1.GetDexRegisterMapOffset(code_info), StackMap::kNoDexRegisterMap);
   ASSERT_EQ(stack_map1.GetDexRegisterMapOffset(code_info), 0xFFu);
 }
@@ -503,4 +504,101 @@ TEST(StackMapTest, TestNoDexRegisterMap) {
   ASSERT_FALSE(stack_map.HasInlineInfo(code_info));
 }
 
+TEST(StackMapTest, TestShareInlineInfo) {
+  ArenaPool pool;
+  ArenaAllocator arena(&pool);
+  StackMapStream stream(&arena);
+
+  ArenaBitVector sp_mask(&arena, 0, false);
+  // First stack map.
+  stream.BeginStackMapEntry(0, 64, 0x3, &sp_mask, 0, 2);
+  stream.AddInlineInfoEntry(42, 2);
+  stream.AddInlineInfoEntry(82, 3);
+  stream.EndStackMapEntry();
+  // Second stack map, which should share the same inline info.
+  stream.BeginStackMapEntry(1, 128, 0x3, &sp_mask, 0, 2);
+  stream.AddInlineInfoEntry(42, 2);
+  stream.AddInlineInfoEntry(82, 3);
+  stream.EndStackMapEntry();
+  // Third stack map (doesn't share the inline info).
+  stream.BeginStackMapEntry(2, 192, 0x3, &sp_mask, 0, 2);
+  stream.AddInlineInfoEntry(42, 2);
+  stream.AddInlineInfoEntry(82, 4);
+  stream.EndStackMapEntry();
+  // Fourth stack map, without inline info.
+  stream.BeginStackMapEntry(3, 256, 0x3, &sp_mask, 0, 0);
+  stream.EndStackMapEntry();
+
+  size_t size = stream.PrepareForFillIn();
+  void* memory = arena.Alloc(size, kArenaAllocMisc);
+  MemoryRegion region(memory, size);
+  stream.FillIn(region);
+
+  CodeInfo ci(region);
+  ASSERT_TRUE(ci.HasInlineInfo());
+  StackMap sm0 = ci.GetStackMapAt(0);
+  StackMap sm1 = ci.GetStackMapAt(1);
+  StackMap sm2 = ci.GetStackMapAt(2);
+  StackMap sm3 = ci.GetStackMapAt(3);
+
+  ASSERT_TRUE(sm0.HasInlineInfo(ci));
+  ASSERT_TRUE(sm1.HasInlineInfo(ci));
+  ASSERT_TRUE(sm2.HasInlineInfo(ci));
+  ASSERT_FALSE(sm3.HasInlineInfo(ci));
+  ASSERT_EQ(sm0.GetInlineDescriptorOffset(ci), sm1.GetInlineDescriptorOffset(ci));
+  ASSERT_NE(sm0.GetInlineDescriptorOffset(ci), sm2.GetInlineDescriptorOffset(ci));
+
+  InlineInfo inline_info1 = ci.GetInlineInfoOf(sm1);
+  ASSERT_EQ(2u, inline_info1.GetDepth());
+  ASSERT_EQ(42u, inline_info1.GetMethodReferenceIndexAtDepth(0));
+  ASSERT_EQ(2u, inline_info1.GetDexPcAtDepth(0));
+  ASSERT_EQ(82u, inline_info1.GetMethodReferenceIndexAtDepth(1));
+  ASSERT_EQ(3u, inline_info1.GetDexPcAtDepth(1));
+
+  InlineInfo inline_info2 = ci.GetInlineInfoOf(sm2);
+  ASSERT_EQ(2u, inline_info2.GetDepth());
+  ASSERT_EQ(82u, inline_info2.GetMethodReferenceIndexAtDepth(1));
+  ASSERT_EQ(4u, inline_info2.GetDexPcAtDepth(1));
+}
+
+TEST(StackMapTest, TestBitPackedEncoding) {
+  ArenaPool pool;
+  ArenaAllocator arena(&pool);
+  StackMapStream stream(&arena);
+
+  ArenaBitVector sp_mask(&arena, 0, false);
+  stream.BeginStackMapEntry(5, 300, 0x9, &sp_mask, 0, 0);
+  stream.EndStackMapEntry();
+  stream.BeginStackMapEntry(0, 0x1ffff, 0x1, &sp_mask, 0, 0);
+  stream.EndStackMapEntry();
+
+  size_t size = stream.PrepareForFillIn();
+  void* memory = arena.Alloc(size, kArenaAllocMisc);
+  MemoryRegion region(memory, size);
+  stream.FillIn(region);
+
+  CodeInfo ci(region);
+  // Each field takes the bits needed by its largest value in the method.
+  ASSERT_EQ(3u, ci.NumberOfBitsForDexPc());
+  ASSERT_EQ(17u, ci.NumberOfBitsForNativePc());
+  ASSERT_EQ(4u, ci.NumberOfBitsForRegisterMask());
+  ASSERT_EQ(0u, ci.NumberOfBitsForDexRegisterMap());
+  ASSERT_EQ(0u, ci.NumberOfBitsForInlineInfo());
+  // 24 bits of packed fields and an empty stack mask.
+  ASSERT_EQ(3u, ci.StackMapSize());
+
+  StackMap sm0 = ci.GetStackMapAt(0);
+  ASSERT_EQ(5u, sm0.GetDexPc(ci));
+  ASSERT_EQ(300u, sm0.GetNativePcOffset(ci));
+  ASSERT_EQ(0x9u, sm0.GetRegisterMask(ci));
+  ASSERT_FALSE(sm0.HasDexRegisterMap(ci));
+  ASSERT_FALSE(sm0.HasInlineInfo(ci));
+
+  StackMap sm1 = ci.GetStackMapAt(1);
+  ASSERT_EQ(0u, sm1.GetDexPc(ci));
+  ASSERT_EQ(0x1ffffu, sm1.GetNativePcOffset(ci));
+  ASSERT_EQ(0x1u, sm1.GetRegisterMask(ci));
+  ASSERT_TRUE(sm1.Equals(ci.GetStackMapForNativePcOffset(0x1ffff)));
+}
+
 }  // namespace art
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "code_stream.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "base/logging.h"
+#include "thread-inl.h"
+
+namespace art {
+
+static size_t HashCode(const ArrayRef<const uint8_t>& code) {
+  // FNV-1a.
+  size_t hash = 0x811c9dc5u;
+  for (uint8_t b : code) {
+    hash = (hash ^ b) * 16777619u;
+  }
+  return hash;
+}
+
+CodeStream::CodeStream(int fd)
+    : file_(fd, false),
+      lock_("CodeStream lock"),
+      size_(0u),
+      num_deduplicated_appends_(0u) {
+}
+
+uint32_t CodeStream::Append(const ArrayRef<const uint8_t>& code) {
+  DCHECK(!code.empty());
+  size_t hash = HashCode(code);
+  MutexLock mu(Thread::Current(), lock_);
+  auto range = entries_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (ContentEquals(it->second, code)) {
+      ++num_deduplicated_appends_;
+      return it->second.offset;
+    }
+  }
+  // The offsets are recorded in 32 bits, like the offsets in the oat file.
+  CHECK_LE(size_ + code.size(), static_cast<size_t>(std::numeric_limits<uint32_t>::max()));
+  if (!file_.WriteFully(code.data(), code.size())) {
+    PLOG(FATAL) << "Unable to append to the code stream.";
+  }
+  Entry entry = { static_cast<uint32_t>(size_), static_cast<uint32_t>(code.size()) };
+  entries_.emplace(hash, entry);
+  size_ += code.size();
+  return entry.offset;
+}
+
+bool CodeStream::Read(uint32_t offset, size_t size, std::vector<uint8_t>* code) const {
+  code->resize(size);
+  return file_.PreadFully(code->data(), size, offset);
+}
+
+size_t CodeStream::GetSize() const {
+  MutexLock mu(Thread::Current(), lock_);
+  return size_;
+}
+
+size_t CodeStream::GetNumberOfDeduplicatedAppends() const {
+  MutexLock mu(Thread::Current(), lock_);
+  return num_deduplicated_appends_;
+}
+
+bool CodeStream::ContentEquals(const Entry& entry, const ArrayRef<const uint8_t>& code) {
+  if (entry.size != code.size()) {
+    return false;
+  }
+  if (!Read(entry.offset, entry.size, &compare_buffer_)) {
+    PLOG(FATAL) << "Unable to read from the code stream.";
+  }
+  return std::equal(code.begin(), code.end(), compare_buffer_.begin());
+}
+
+}  // namespace art
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ART_COMPILER_UTILS_CODE_STREAM_H_
+#define ART_COMPILER_UTILS_CODE_STREAM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <unordered_map>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/mutex.h"
+#include "base/unix_file/fd_file.h"
+#include "os.h"
+#include "utils/array_ref.h"
+
+namespace art {
+
+// The code of the compiled methods, appended to a file in the order the methods are compiled
+// instead of being kept in memory until the oat file is written. Identical code is only written
+// once, so that code deduplicated in memory stays deduplicated in the stream.
+class CodeStream {
+ public:
+  // The file descriptor is expected to refer to an open but unlinked file, like the one of the
+  // swap space. The stream closes it.
+  explicit CodeStream(int fd);
+
+  // Appends the code to the stream unless identical code was appended before, and returns the
+  // offset of the code in the stream.
+  uint32_t Append(const ArrayRef<const uint8_t>& code) LOCKS_EXCLUDED(lock_);
+
+  // Reads the code at the offset returned by Append().
+  bool Read(uint32_t offset, size_t size, std::vector<uint8_t>* code) const;
+
+  size_t GetSize() const LOCKS_EXCLUDED(lock_);
+  size_t GetNumberOfDeduplicatedAppends() const LOCKS_EXCLUDED(lock_);
+
+ private:
+  struct Entry {
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  bool ContentEquals(const Entry& entry, const ArrayRef<const uint8_t>& code)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  mutable File file_;
+
+  mutable Mutex lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  size_t size_ GUARDED_BY(lock_);
+  size_t num_deduplicated_appends_ GUARDED_BY(lock_);
+  // The code appended so far, by hash.
+  std::unordered_multimap<size_t, Entry> entries_ GUARDED_BY(lock_);
+  // Buffer to compare the code appended with the code already in the stream.
+  std::vector<uint8_t> compare_buffer_ GUARDED_BY(lock_);
+
+  DISALLOW_COPY_AND_ASSIGN(CodeStream);
+};
+
+}  // namespace art
+
+#endif  // ART_COMPILER_UTILS_CODE_STREAM_H_
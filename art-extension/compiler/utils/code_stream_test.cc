@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "utils/code_stream.h"
+
+#include <unistd.h>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "common_runtime_test.h"
+
+namespace art {
+
+class CodeStreamTest : public CommonRuntimeTest {
+};
+
+TEST_F(CodeStreamTest, AppendAndRead) {
+  ScratchFile scratch;
+  CodeStream stream(dup(scratch.GetFd()));
+  unlink(scratch.GetFilename().c_str());
+
+  static const uint8_t kCode1[] = { 0x55, 0x89, 0xe5, 0xc3 };
+  static const uint8_t kCode2[] = { 0x90, 0xc3 };
+  uint32_t offset1 = stream.Append(ArrayRef<const uint8_t>(kCode1));
+  uint32_t offset2 = stream.Append(ArrayRef<const uint8_t>(kCode2));
+  EXPECT_EQ(0u, offset1);
+  EXPECT_EQ(sizeof(kCode1), offset2);
+
+  // Identical code is not appended again.
+  std::vector<uint8_t> copy(kCode1, kCode1 + sizeof(kCode1));
+  EXPECT_EQ(offset1, stream.Append(ArrayRef<const uint8_t>(copy)));
+  EXPECT_EQ(sizeof(kCode1) + sizeof(kCode2), stream.GetSize());
+  EXPECT_EQ(1u, stream.GetNumberOfDeduplicatedAppends());
+
+  std::vector<uint8_t> code;
+  ASSERT_TRUE(stream.Read(offset1, sizeof(kCode1), &code));
+  EXPECT_EQ(copy, code);
+  ASSERT_TRUE(stream.Read(offset2, sizeof(kCode2), &code));
+  EXPECT_EQ(std::vector<uint8_t>(kCode2, kCode2 + sizeof(kCode2)), code);
+
+  scratch.Close();
+}
+
+}  // namespace art
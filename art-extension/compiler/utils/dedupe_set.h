@@ -18,11 +18,15 @@
 #define ART_COMPILER_UTILS_DEDUPE_SET_H_
 
 #include <algorithm>
+#include <atomic>
 #include <inttypes.h>
 #include <memory>
 #include <set>
 #include <string>
+#include <vector>
 
+#include "atomic.h"
+#include "base/bit_utils.h"
 #include "base/mutex.h"
 #include "base/stl_util.h"
 #include "base/stringprintf.h"
@@ -167,6 +171,211 @@ class DedupeSet {
   DISALLOW_COPY_AND_ASSIGN(DedupeSet);
 };
 
+// A DedupeSet with the same interface, backed by insert-only open-addressing hash tables.
+// Lookups do not take any lock: a slot is published with a release store of its key
+// pointer once its hash is written, and a table is never modified after it has been
+// replaced by a larger one. Inserts take the lock of their shard, only to probe the
+// current table again and store a pointer; the key is copied before taking the lock.
+// Replaced tables are kept until the set is destroyed, as lookups may still walk them.
+template <typename InKey, typename StoreKey, typename HashType, typename HashFunc,
+          HashType kShard = 1>
+class ConcurrentDedupeSet {
+  struct Slot {
+    Slot() : store_ptr(nullptr), hash(0) {}
+
+    std::atomic<StoreKey*> store_ptr;
+    HashType hash;  // Valid once store_ptr is non-null.
+  };
+
+  struct Table {
+    explicit Table(size_t capacity_in) : capacity(capacity_in), slots(new Slot[capacity_in]) {
+      DCHECK(IsPowerOfTwo(capacity));
+    }
+
+    const size_t capacity;
+    std::unique_ptr<Slot[]> slots;
+  };
+
+  struct Shard {
+    Shard() : table(nullptr), size(0) {}
+
+    std::atomic<Table*> table;
+    std::unique_ptr<Mutex> lock;
+    // Number of keys in `table`, guarded by `lock`.
+    size_t size;
+    // All the tables of the shard, guarded by `lock`.
+    std::vector<std::unique_ptr<Table>> tables;
+  };
+
+ public:
+  StoreKey* Add(Thread* self, const InKey& key) {
+    uint64_t hash_start;
+    if (kIsDebugBuild) {
+      hash_start = NanoTime();
+    }
+    HashType raw_hash = HashFunc()(key);
+    if (kIsDebugBuild) {
+      uint64_t hash_end = NanoTime();
+      hash_time_.FetchAndAddSequentiallyConsistent(hash_end - hash_start);
+    }
+    HashType shard_hash = raw_hash / kShard;
+    Shard& shard = shards_[raw_hash % kShard];
+
+    // Fast path: the key is already in the set.
+    size_t index;
+    StoreKey* found = Find(shard.table.load(std::memory_order_acquire), shard_hash, key, &index);
+    if (found != nullptr) {
+      return found;
+    }
+
+    StoreKey* store_key = CreateStoreKey(key);
+    {
+      MutexLock lock(self, *shard.lock);
+      // Only this lock changes the table, the key may have been added since we looked.
+      Table* table = shard.table.load(std::memory_order_relaxed);
+      found = Find(table, shard_hash, key, &index);
+      if (found == nullptr) {
+        // Keep the load factor under 3/4 so that probe sequences stay short.
+        if ((shard.size + 1) * 4 > table->capacity * 3) {
+          table = Grow(&shard);
+          found = Find(table, shard_hash, key, &index);
+          DCHECK(found == nullptr);
+        }
+        Slot& slot = table->slots[index];
+        slot.hash = shard_hash;
+        slot.store_ptr.store(store_key, std::memory_order_release);
+        ++shard.size;
+        return store_key;
+      }
+    }
+    // Another thread added the same key while we were copying it.
+    DeleteStoreKey(store_key);
+    return found;
+  }
+
+  explicit ConcurrentDedupeSet(const char* set_name, SwapAllocator<void>& alloc)
+      : allocator_(alloc), hash_time_(0) {
+    for (HashType i = 0; i < kShard; ++i) {
+      std::ostringstream oss;
+      oss << set_name << " lock " << i;
+      lock_name_[i] = oss.str();
+      shards_[i].lock.reset(new Mutex(lock_name_[i].c_str()));
+      shards_[i].tables.emplace_back(new Table(kInitialCapacity));
+      shards_[i].table.store(shards_[i].tables.back().get(), std::memory_order_relaxed);
+    }
+  }
+
+  ~ConcurrentDedupeSet() {
+    // Have to manually free all pointers. Every key is in the current table of its shard.
+    for (Shard& shard : shards_) {
+      Table* table = shard.table.load(std::memory_order_relaxed);
+      for (size_t i = 0; i < table->capacity; ++i) {
+        StoreKey* store_ptr = table->slots[i].store_ptr.load(std::memory_order_relaxed);
+        if (store_ptr != nullptr) {
+          DeleteStoreKey(store_ptr);
+        }
+      }
+    }
+  }
+
+  std::string DumpStats() const {
+    // Keys which are not in their home slot, and the longest probe sequence.
+    size_t collision_sum = 0;
+    size_t collision_max = 0;
+    size_t size = 0;
+    for (const Shard& shard : shards_) {
+      const Table* table = shard.table.load(std::memory_order_acquire);
+      size_t mask = table->capacity - 1;
+      for (size_t i = 0; i < table->capacity; ++i) {
+        const Slot& slot = table->slots[i];
+        if (slot.store_ptr.load(std::memory_order_acquire) == nullptr) {
+          continue;
+        }
+        ++size;
+        size_t distance = (i - slot.hash) & mask;
+        if (distance != 0) {
+          collision_sum++;
+          collision_max = std::max(collision_max, distance + 1);
+        }
+      }
+    }
+    return StringPrintf("%zu keys, %zu collisions, %zu max probe length, %" PRIu64
+                        " ns hash time",
+                        size, collision_sum, collision_max, hash_time_.LoadRelaxed());
+  }
+
+ private:
+  static constexpr size_t kInitialCapacity = 1024;
+
+  static bool KeysEqual(const InKey& in_key, const StoreKey& store_key) {
+    typedef typename StoreKey::value_type ValueType;
+    return in_key.size() == store_key.size() &&
+        std::equal(in_key.begin(), in_key.end(), store_key.begin(),
+                   [](const ValueType& a, const ValueType& b) { return !(a < b) && !(b < a); });
+  }
+
+  // Look for `key` in `table`. Returns its stored copy if present, otherwise null, with
+  // `*index` set to the free slot which ended the probe sequence.
+  static StoreKey* Find(const Table* table, HashType hash, const InKey& key, size_t* index) {
+    size_t mask = table->capacity - 1;
+    for (size_t i = hash & mask; ; i = (i + 1) & mask) {
+      const Slot& slot = table->slots[i];
+      StoreKey* store_ptr = slot.store_ptr.load(std::memory_order_acquire);
+      if (store_ptr == nullptr) {
+        *index = i;
+        return nullptr;
+      }
+      if (slot.hash == hash && KeysEqual(key, *store_ptr)) {
+        return store_ptr;
+      }
+    }
+  }
+
+  // Replace the table of `shard` with one twice as large. Called with the shard lock held.
+  Table* Grow(Shard* shard) {
+    Table* old_table = shard->table.load(std::memory_order_relaxed);
+    std::unique_ptr<Table> new_table(new Table(old_table->capacity * 2));
+    size_t mask = new_table->capacity - 1;
+    for (size_t i = 0; i < old_table->capacity; ++i) {
+      const Slot& old_slot = old_table->slots[i];
+      StoreKey* store_ptr = old_slot.store_ptr.load(std::memory_order_relaxed);
+      if (store_ptr == nullptr) {
+        continue;
+      }
+      size_t j = old_slot.hash & mask;
+      while (new_table->slots[j].store_ptr.load(std::memory_order_relaxed) != nullptr) {
+        j = (j + 1) & mask;
+      }
+      new_table->slots[j].hash = old_slot.hash;
+      new_table->slots[j].store_ptr.store(store_ptr, std::memory_order_relaxed);
+    }
+    Table* result = new_table.get();
+    shard->tables.push_back(std::move(new_table));
+    // Publish the filled table.
+    shard->table.store(result, std::memory_order_release);
+    return result;
+  }
+
+  StoreKey* CreateStoreKey(const InKey& key) {
+    StoreKey* ret = allocator_.allocate(1);
+    allocator_.construct(ret, key.begin(), key.end(), allocator_);
+    return ret;
+  }
+
+  void DeleteStoreKey(StoreKey* key) {
+    SwapAllocator<StoreKey> alloc(allocator_);
+    alloc.destroy(key);
+    alloc.deallocate(key, 1);
+  }
+
+  std::string lock_name_[kShard];
+  Shard shards_[kShard];
+  SwapAllocator<StoreKey> allocator_;
+  Atomic<uint64_t> hash_time_;
+
+  DISALLOW_COPY_AND_ASSIGN(ConcurrentDedupeSet);
+};
+
 }  // namespace art
 
 #endif  // ART_COMPILER_UTILS_DEDUPE_SET_H_
@@ -341,6 +341,12 @@ class X86Assembler FINAL : public Assembler {
 
   void bswapl(Register dst);
 
+  void bsfl(Register dst, Register src);
+  void bsrl(Register dst, Register src);
+  void popcntl(Register dst, Register src);
+  void lzcntl(Register dst, Register src);
+  void tzcntl(Register dst, Register src);
+
   void movzxb(Register dst, ByteRegister src);
   void movzxb(Register dst, const Address& src);
   void movsxb(Register dst, ByteRegister src);
@@ -441,6 +447,32 @@ class X86Assembler FINAL : public Assembler {
   void orpd(XmmRegister dst, XmmRegister src);
   void orps(XmmRegister dst, XmmRegister src);
 
+  void movups(XmmRegister dst, const Address& src);
+  void movups(const Address& dst, XmmRegister src);
+  void movdqu(XmmRegister dst, const Address& src);
+  void movdqu(const Address& dst, XmmRegister src);
+
+  void addps(XmmRegister dst, XmmRegister src);
+  void subps(XmmRegister dst, XmmRegister src);
+  void mulps(XmmRegister dst, XmmRegister src);
+
+  void paddb(XmmRegister dst, XmmRegister src);
+  void paddw(XmmRegister dst, XmmRegister src);
+  void paddd(XmmRegister dst, XmmRegister src);
+  void psubb(XmmRegister dst, XmmRegister src);
+  void psubw(XmmRegister dst, XmmRegister src);
+  void psubd(XmmRegister dst, XmmRegister src);
+  void pmullw(XmmRegister dst, XmmRegister src);
+  void pmulld(XmmRegister dst, XmmRegister src);  // SSE4.1.
+  void pand(XmmRegister dst, XmmRegister src);
+  void por(XmmRegister dst, XmmRegister src);
+  void pxor(XmmRegister dst, XmmRegister src);
+  void ptest(XmmRegister dst, XmmRegister src);  // SSE4.1.
+
+  void punpcklbw(XmmRegister dst, XmmRegister src);
+  void punpcklwd(XmmRegister dst, XmmRegister src);
+  void pshufd(XmmRegister dst, XmmRegister src, const Immediate& imm);
+
   void flds(const Address& src);
   void fstps(const Address& dst);
   void fsts(const Address& dst);
@@ -559,6 +591,10 @@ class X86Assembler FINAL : public Assembler {
   void shld(Register dst, Register src, const Immediate& imm);
   void shrd(Register dst, Register src, Register shifter);
   void shrd(Register dst, Register src, const Immediate& imm);
+  void roll(Register reg, const Immediate& imm);
+  void roll(Register operand, Register shifter);
+  void rorl(Register reg, const Immediate& imm);
+  void rorl(Register operand, Register shifter);
 
   void negl(Register reg);
   void notl(Register reg);
@@ -583,7 +619,9 @@ class X86Assembler FINAL : public Assembler {
   void jmp(NearLabel* label);
 
   void repne_scasw();
+  void rep_movsb();
   void rep_movsw();
+  void rep_movsl();
 
   X86Assembler* lock();
   void cmpxchgl(const Address& address, Register reg);
@@ -120,6 +120,86 @@ TEST_F(AssemblerX86Test, punpckldq) {
   DriverStr(expected, "punpckldq");
 }
 
+TEST_F(AssemblerX86Test, Movdqu) {
+  GetAssembler()->movdqu(x86::XMM0, x86::Address(
+      x86::Register(x86::EAX), x86::Register(x86::ECX), x86::TIMES_4, 12));
+  GetAssembler()->movdqu(x86::Address(
+      x86::Register(x86::EAX), x86::Register(x86::ECX), x86::TIMES_4, 12), x86::XMM1);
+  const char* expected =
+    "movdqu 0xc(%EAX,%ECX,4), %xmm0\n"
+    "movdqu %xmm1, 0xc(%EAX,%ECX,4)\n";
+  DriverStr(expected, "movdqu");
+}
+
+TEST_F(AssemblerX86Test, Paddd) {
+  GetAssembler()->paddd(x86::XMM0, x86::XMM1);
+  const char* expected = "paddd %xmm1, %xmm0\n";
+  DriverStr(expected, "paddd");
+}
+
+TEST_F(AssemblerX86Test, Pmulld) {
+  GetAssembler()->pmulld(x86::XMM2, x86::XMM3);
+  const char* expected = "pmulld %xmm3, %xmm2\n";
+  DriverStr(expected, "pmulld");
+}
+
+TEST_F(AssemblerX86Test, Ptest) {
+  GetAssembler()->ptest(x86::XMM2, x86::XMM3);
+  const char* expected = "ptest %xmm3, %xmm2\n";
+  DriverStr(expected, "ptest");
+}
+
+TEST_F(AssemblerX86Test, RepMovsb) {
+  GetAssembler()->rep_movsb();
+  const char* expected = "rep movsb\n";
+  DriverStr(expected, "rep_movsb");
+}
+
+TEST_F(AssemblerX86Test, RepMovsl) {
+  GetAssembler()->rep_movsl();
+  const char* expected = "rep movsl\n";
+  DriverStr(expected, "rep_movsl");
+}
+
+TEST_F(AssemblerX86Test, BitScan) {
+  GetAssembler()->bsfl(x86::EAX, x86::EBX);
+  GetAssembler()->bsrl(x86::ECX, x86::EDX);
+  const char* expected =
+    "bsfl %ebx, %eax\n"
+    "bsrl %edx, %ecx\n";
+  DriverStr(expected, "bitscan");
+}
+
+TEST_F(AssemblerX86Test, BitCount) {
+  GetAssembler()->popcntl(x86::EAX, x86::EBX);
+  GetAssembler()->lzcntl(x86::ECX, x86::EDX);
+  GetAssembler()->tzcntl(x86::ESI, x86::EDI);
+  const char* expected =
+    "popcntl %ebx, %eax\n"
+    "lzcntl %edx, %ecx\n"
+    "tzcntl %edi, %esi\n";
+  DriverStr(expected, "bitcount");
+}
+
+TEST_F(AssemblerX86Test, Rotate) {
+  GetAssembler()->roll(x86::EAX, x86::Immediate(3));
+  GetAssembler()->rorl(x86::EBX, x86::Immediate(5));
+  GetAssembler()->roll(x86::EDX, x86::ECX);
+  GetAssembler()->rorl(x86::ESI, x86::ECX);
+  const char* expected =
+    "roll $3, %eax\n"
+    "rorl $5, %ebx\n"
+    "roll %cl, %edx\n"
+    "rorl %cl, %esi\n";
+  DriverStr(expected, "rotate");
+}
+
+TEST_F(AssemblerX86Test, Pshufd) {
+  GetAssembler()->pshufd(x86::XMM0, x86::XMM1, CreateImmediate(0));
+  const char* expected = "pshufd $0x0, %xmm1, %xmm0\n";
+  DriverStr(expected, "pshufd");
+}
+
 TEST_F(AssemblerX86Test, LoadLongConstant) {
   GetAssembler()->LoadLongConstant(x86::XMM0, 51);
   const char* expected =
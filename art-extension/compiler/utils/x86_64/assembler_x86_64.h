@@ -494,6 +494,32 @@ class X86_64Assembler FINAL : public Assembler {
   void orpd(XmmRegister dst, XmmRegister src);
   void orps(XmmRegister dst, XmmRegister src);
 
+  void movups(XmmRegister dst, const Address& src);
+  void movups(const Address& dst, XmmRegister src);
+  void movdqu(XmmRegister dst, const Address& src);
+  void movdqu(const Address& dst, XmmRegister src);
+
+  void addps(XmmRegister dst, XmmRegister src);
+  void subps(XmmRegister dst, XmmRegister src);
+  void mulps(XmmRegister dst, XmmRegister src);
+
+  void paddb(XmmRegister dst, XmmRegister src);
+  void paddw(XmmRegister dst, XmmRegister src);
+  void paddd(XmmRegister dst, XmmRegister src);
+  void psubb(XmmRegister dst, XmmRegister src);
+  void psubw(XmmRegister dst, XmmRegister src);
+  void psubd(XmmRegister dst, XmmRegister src);
+  void pmullw(XmmRegister dst, XmmRegister src);
+  void pmulld(XmmRegister dst, XmmRegister src);  // SSE4.1.
+  void pand(XmmRegister dst, XmmRegister src);
+  void por(XmmRegister dst, XmmRegister src);
+  void pxor(XmmRegister dst, XmmRegister src);
+  void ptest(XmmRegister dst, XmmRegister src);  // SSE4.1.
+
+  void punpcklbw(XmmRegister dst, XmmRegister src);
+  void punpcklwd(XmmRegister dst, XmmRegister src);
+  void pshufd(XmmRegister dst, XmmRegister src, const Immediate& imm);
+
   void flds(const Address& src);
   void fstps(const Address& dst);
   void fsts(const Address& dst);
@@ -628,6 +654,16 @@ class X86_64Assembler FINAL : public Assembler {
   void sarq(CpuRegister reg, const Immediate& imm);
   void sarq(CpuRegister operand, CpuRegister shifter);
 
+  void roll(CpuRegister reg, const Immediate& imm);
+  void roll(CpuRegister operand, CpuRegister shifter);
+  void rorl(CpuRegister reg, const Immediate& imm);
+  void rorl(CpuRegister operand, CpuRegister shifter);
+
+  void rolq(CpuRegister reg, const Immediate& imm);
+  void rolq(CpuRegister operand, CpuRegister shifter);
+  void rorq(CpuRegister reg, const Immediate& imm);
+  void rorq(CpuRegister operand, CpuRegister shifter);
+
   void negl(CpuRegister reg);
   void negq(CpuRegister reg);
 
@@ -666,8 +702,21 @@ class X86_64Assembler FINAL : public Assembler {
   void bswapl(CpuRegister dst);
   void bswapq(CpuRegister dst);
 
+  void bsfl(CpuRegister dst, CpuRegister src);
+  void bsfq(CpuRegister dst, CpuRegister src);
+  void bsrl(CpuRegister dst, CpuRegister src);
+  void bsrq(CpuRegister dst, CpuRegister src);
+  void popcntl(CpuRegister dst, CpuRegister src);
+  void popcntq(CpuRegister dst, CpuRegister src);
+  void lzcntl(CpuRegister dst, CpuRegister src);
+  void lzcntq(CpuRegister dst, CpuRegister src);
+  void tzcntl(CpuRegister dst, CpuRegister src);
+  void tzcntq(CpuRegister dst, CpuRegister src);
+
   void repne_scasw();
+  void rep_movsb();
   void rep_movsw();
+  void rep_movsl();
 
   //
   // Macros for High-level operations.
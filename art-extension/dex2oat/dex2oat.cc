@@ -39,6 +39,7 @@
 #include <cutils/trace.h>
 
 #include "art_method-inl.h"
+#include "arch/arm64/instruction_set_features_arm64.h"
 #include "arch/instruction_set_features.h"
 #include "arch/mips/instruction_set_features_mips.h"
 #include "base/dumpable.h"
@@ -57,8 +58,10 @@
 #include "dex/verification_results.h"
 #include "dex/quick_compiler_callbacks.h"
 #include "dex/quick/dex_file_to_method_inliner_map.h"
+#include "driver/compilation_cache.h"
 #include "driver/compiler_driver.h"
 #include "driver/compiler_options.h"
+#include "driver/incremental_compilation.h"
 #include "elf_file.h"
 #include "elf_writer.h"
 #include "gc/space/image_space.h"
@@ -76,6 +79,7 @@
 #include "ScopedLocalRef.h"
 #include "scoped_thread_state_change.h"
 #include "utils.h"
+#include "utils/code_stream.h"
 #include "vector_output_stream.h"
 #include "well_known_classes.h"
 #include "zip_archive.h"
@@ -153,6 +157,33 @@ static std::string StrippedCommandLine() {
   return Join(command, ' ');
 }
 
+// The options of the compilation which the generated code depends on: the command line without
+// the inputs, outputs and the options only affecting how dex2oat runs or what it reports.
+static std::string IncrementalFingerprint() {
+  static const char* const kIgnoredOptionPrefixes[] = {
+      "--dex-file=", "--dex-location=", "--zip-fd=", "--zip-location=", "--oat-file=",
+      "--oat-symbols=", "--oat-fd=", "--oat-location=", "--reuse-oat-file=",
+      "--compilation-cache=", "--swap-file=", "--swap-fd=", "--stream-code-file=", "--watch-dog",
+      "--no-watch-dog", "-j", "--metric-type=", "--dump-timing",
+      "--dump-passes", "--dump-cfg", "--dump-stats", "--dump-init-failures=", "--print-pass",
+      "--print-all-passes", "--verbose-methods=",
+  };
+  std::vector<std::string> command;
+  for (int i = 0; i < original_argc; ++i) {
+    bool ignored = false;
+    for (const char* prefix : kIgnoredOptionPrefixes) {
+      if (StartsWith(original_argv[i], prefix)) {
+        ignored = true;
+        break;
+      }
+    }
+    if (!ignored) {
+      command.push_back(original_argv[i]);
+    }
+  }
+  return Join(command, ' ');
+}
+
 static constexpr size_t kDefaultAllDexFileMax = 0x7FFFFFFF;
 
 static void UsageErrorV(const char* fmt, va_list ap) {
@@ -339,6 +370,24 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("");
   UsageError("  --profile-file=<filename>: specify profiler output file to use for compilation.");
   UsageError("");
+  UsageError("  --register-allocation=(linear-scan|loop-aware|loop-aware-hot): select the register");
+  UsageError("      allocator of the optimizing compiler. loop-aware spills the values that are");
+  UsageError("      the least used in loops and shares the spill slots of phis and their inputs.");
+  UsageError("      loop-aware-hot only uses it for the hot methods of the profile file.");
+  UsageError("      Example: --register-allocation=loop-aware");
+  UsageError("      Default: loop-aware-hot");
+  UsageError("");
+  UsageError("  --optimization-tiers: let the optimizing compiler skip the extension passes, or all");
+  UsageError("      the optional passes, for the big methods, the methods with many loops and the");
+  UsageError("      cold methods of the profile file.");
+  UsageError("");
+  UsageError("  --no-optimization-tiers: run all the passes for every method.");
+  UsageError("");
+  UsageError("  --optimization-time-budget=<ms>: time after which the optimizing compiler only");
+  UsageError("      runs the passes that the code generator relies on for a method.");
+  UsageError("      Example: --optimization-time-budget=500");
+  UsageError("      Default: 0 (no budget)");
+  UsageError("");
   UsageError("  --print-pass-names: print a list of pass names");
   UsageError("");
   UsageError("  --disable-passes=<pass-names>:  disable one or more passes separated by comma.");
@@ -353,12 +402,27 @@ NO_RETURN static void Usage(const char* fmt, ...) {
   UsageError("      Used to specify a pass specific option. The setting itself must be integer.");
   UsageError("      Separator used between options is a comma.");
   UsageError("");
+  UsageError("  --reuse-oat-file=<file.oat>: specifies the oat file of a previous compilation of");
+  UsageError("      the dex files, compiled with the same options, whose code is reused for the");
+  UsageError("      classes which did not change since.");
+  UsageError("      Example: --reuse-oat-file=/data/tmp/previous.oat");
+  UsageError("");
+  UsageError("  --compilation-cache=<file>: specifies a file caching compiled methods across");
+  UsageError("      dex2oat invocations. Methods found there are not compiled again, the others");
+  UsageError("      are added to it.");
+  UsageError("      Example: --compilation-cache=/data/tmp/dex2oat.cache");
+  UsageError("");
   UsageError("  --swap-file=<file-name>:  specifies a file to use for swap.");
   UsageError("      Example: --swap-file=/data/tmp/swap.001");
   UsageError("");
   UsageError("  --swap-fd=<file-descriptor>:  specifies a file to use for swap (by descriptor).");
   UsageError("      Example: --swap-fd=10");
   UsageError("");
+  UsageError("  --stream-code-file=<file-name>: specifies a file the code of the methods is");
+  UsageError("      written to as they are compiled, instead of keeping it in memory until the oat");
+  UsageError("      file is written.");
+  UsageError("      Example: --stream-code-file=/data/tmp/code.001");
+  UsageError("");
   UsageError("  --stop-compiling-after=<method-idx>:  stops compilation after a specified method.");
   UsageError("      <method-idx> can be either hex or decimal value.");
   UsageError("      Example: --stop-compiling-after=17 compiles first 17 methods");
@@ -589,6 +653,7 @@ class Dex2Oat FINAL {
       dump_timing_(false),
       dump_slow_timing_(kIsDebugBuild),
       swap_fd_(-1),
+      code_stream_fd_(-1),
       all_dex_file_max_(kDefaultAllDexFileMax),
       timings_(timings)
 #ifdef PERF_ANALYSIS_INFRASTRUCTURE
@@ -648,6 +713,9 @@ class Dex2Oat FINAL {
     double top_k_profile_threshold = CompilerOptions::kDefaultTopKProfileThreshold;
 
     bool aggressive_non_dubuggable = false;
+    const char* register_allocation_string = nullptr;
+    bool optimization_tiers = CompilerOptions::kDefaultOptimizationTiers;
+    unsigned int optimization_time_budget_ms = CompilerOptions::kDefaultOptimizationTimeBudgetMs;
     bool debuggable = false;
     bool include_patch_information = CompilerOptions::kDefaultIncludePatchInformation;
     bool generate_debug_info = kIsDebugBuild;
@@ -872,6 +940,17 @@ class Dex2Oat FINAL {
         // No profile
       } else if (option.starts_with("--top-k-profile-threshold=")) {
         ParseDouble(option.data(), '=', 0.0, 100.0, &top_k_profile_threshold);
+      } else if (option.starts_with("--register-allocation=")) {
+        register_allocation_string = option.substr(strlen("--register-allocation=")).data();
+      } else if (option == "--optimization-tiers") {
+        optimization_tiers = true;
+      } else if (option == "--no-optimization-tiers") {
+        optimization_tiers = false;
+      } else if (option.starts_with("--optimization-time-budget=")) {
+        const char* budget = option.substr(strlen("--optimization-time-budget=")).data();
+        if (!ParseUint(budget, &optimization_time_budget_ms)) {
+          Usage("Failed to parse --optimization-time-budget '%s' as an integer", budget);
+        }
       } else if (option == "--print-pass-names") {
         pass_manager_options.SetPrintPassNames(true);
       } else if (option.starts_with("--disable-passes=")) {
@@ -921,6 +1000,10 @@ class Dex2Oat FINAL {
                      << "failures.";
           init_failure_output_.reset();
         }
+      } else if (option.starts_with("--reuse-oat-file=")) {
+        reuse_oat_filename_ = option.substr(strlen("--reuse-oat-file=")).data();
+      } else if (option.starts_with("--compilation-cache=")) {
+        compilation_cache_filename_ = option.substr(strlen("--compilation-cache=")).data();
       } else if (option.starts_with("--swap-file=")) {
         swap_file_name_ = option.substr(strlen("--swap-file=")).data();
       } else if (option.starts_with("--swap-fd=")) {
@@ -931,6 +1014,8 @@ class Dex2Oat FINAL {
         if (swap_fd_ < 0) {
           Usage("--swap-fd passed a negative value %d", swap_fd_);
         }
+      } else if (option.starts_with("--stream-code-file=")) {
+        code_stream_file_name_ = option.substr(strlen("--stream-code-file=")).data();
       } else if (option == "--abort-on-hard-verifier-error") {
         abort_on_hard_verifier_error = true;
       } else if (option.starts_with("--stop-compiling-after=")) {
@@ -1027,6 +1112,14 @@ class Dex2Oat FINAL {
       Usage("--compiled-classes should only be used with --image");
     }
 
+    if (!reuse_oat_filename_.empty() && image_) {
+      Usage("--reuse-oat-file should not be used with --image");
+    }
+
+    if (!code_stream_file_name_.empty() && image_) {
+      Usage("--stream-code-file should not be used with --image");
+    }
+
     if (compiled_classes_filename_ != nullptr && !boot_image_option_.empty()) {
       Usage("--compiled-classes should not be used with --boot-image");
     }
@@ -1083,6 +1176,13 @@ class Dex2Oat FINAL {
       }
     }
 
+    // The Cortex-A53 erratum 843419 thunks are placed by looking at the code of the methods,
+    // which is not kept in memory when it is streamed to a file.
+    if (!code_stream_file_name_.empty() && instruction_set_ == kArm64 &&
+        instruction_set_features_->AsArm64InstructionSetFeatures()->NeedFixCortexA53_843419()) {
+      Usage("--stream-code-file should not be used with the Cortex-A53 erratum 843419 fix");
+    }
+
     if (instruction_set_ == kRuntimeISA) {
       std::unique_ptr<const InstructionSetFeatures> runtime_features(
           InstructionSetFeatures::FromCppDefines());
@@ -1120,6 +1220,20 @@ class Dex2Oat FINAL {
       Usage("Unknown --compiler-filter value %s", compiler_filter_string);
     }
 
+    CompilerOptions::RegisterAllocation register_allocation =
+        CompilerOptions::kDefaultRegisterAllocation;
+    if (register_allocation_string != nullptr) {
+      if (strcmp(register_allocation_string, "linear-scan") == 0) {
+        register_allocation = CompilerOptions::kRegisterAllocationLinearScan;
+      } else if (strcmp(register_allocation_string, "loop-aware") == 0) {
+        register_allocation = CompilerOptions::kRegisterAllocationLoopAware;
+      } else if (strcmp(register_allocation_string, "loop-aware-hot") == 0) {
+        register_allocation = CompilerOptions::kRegisterAllocationLoopAwareHot;
+      } else {
+        Usage("Unknown --register-allocation value %s", register_allocation_string);
+      }
+    }
+
     // It they are not set, use default values for inlining settings.
     // TODO: We should rethink the compiler filter. We mostly save
     // time here, which is orthogonal to space.
@@ -1185,6 +1299,9 @@ class Dex2Oat FINAL {
                                                 init_failure_output_.get(),
                                                 abort_on_hard_verifier_error,
                                                 aggressive_non_dubuggable));
+    compiler_options_->SetRegisterAllocation(register_allocation);
+    compiler_options_->SetOptimizationTiers(optimization_tiers);
+    compiler_options_->SetOptimizationTimeBudgetMs(optimization_time_budget_ms);
 
     // Done with usage checks, enable watchdog if requested
     if (watch_dog_enabled) {
@@ -1267,6 +1384,19 @@ class Dex2Oat FINAL {
       unlink(swap_file_name_.c_str());
     }
 
+    // The code stream is unlinked immediately as well.
+    if (!code_stream_file_name_.empty()) {
+      std::unique_ptr<File> code_stream_file(OS::CreateEmptyFile(code_stream_file_name_.c_str()));
+      if (code_stream_file.get() == nullptr) {
+        PLOG(ERROR) << "Failed to create code stream file: " << code_stream_file_name_;
+        return false;
+      }
+      code_stream_fd_ = code_stream_file->Fd();
+      code_stream_file->MarkUnchecked();
+      code_stream_file->DisableAutoClose();  // The compiler driver's code stream closes it.
+      unlink(code_stream_file_name_.c_str());
+    }
+
     return true;
   }
 
@@ -1519,6 +1649,7 @@ class Dex2Oat FINAL {
 
     // Handle and ClassLoader creation needs to come after Runtime::Create
     jobject class_loader = nullptr;
+    std::string class_path;
     Thread* self = Thread::Current();
     if (!boot_image_option_.empty()) {
       ClassLinker* class_linker = Runtime::Current()->GetClassLinker();
@@ -1532,8 +1663,8 @@ class Dex2Oat FINAL {
       }
 
       // Store the classpath we have right now.
-      key_value_store_->Put(OatHeader::kClassPathKey,
-                            OatFile::EncodeDexFileDependencies(class_path_files));
+      class_path = OatFile::EncodeDexFileDependencies(class_path_files);
+      key_value_store_->Put(OatHeader::kClassPathKey, class_path);
 
       // Then the dex files we'll compile. Thus we'll resolve the class-path first.
       class_path_files.insert(class_path_files.end(), dex_files_.begin(), dex_files_.end());
@@ -1561,7 +1692,80 @@ class Dex2Oat FINAL {
                                  dump_cfg_filter_,
                                  metric_type_);
 
+    if (code_stream_fd_ != -1) {
+      driver_->SetCodeStream(new CodeStream(code_stream_fd_));
+      code_stream_fd_ = -1;
+    }
+
+    if (!reuse_oat_filename_.empty()) {
+      TimingLogger::ScopedTiming t2("dex2oat Find reusable classes", timings_);
+      gc::space::ImageSpace* image_space = Runtime::Current()->GetHeap()->GetImageSpace();
+      const ImageHeader& image_header = image_space->GetImageHeader();
+      std::string error_msg;
+      IncrementalCompilation* incremental_compilation = IncrementalCompilation::Create(
+          reuse_oat_filename_,
+          IncrementalFingerprint(),
+          instruction_set_,
+          instruction_set_features_.get(),
+          image_header.GetOatChecksum(),
+          reinterpret_cast<uintptr_t>(image_header.GetOatDataBegin()),
+          image_header.GetPatchDelta(),
+          class_path,
+          dex_files_,
+          &error_msg);
+      if (incremental_compilation == nullptr) {
+        LOG(WARNING) << "Compiling all classes: " << error_msg;
+      } else {
+        LOG(INFO) << "Reusing the code of " << incremental_compilation->GetNumberOfReusableClasses()
+                  << " out of " << incremental_compilation->GetNumberOfClasses()
+                  << " classes from " << reuse_oat_filename_;
+        driver_->SetIncrementalCompilation(incremental_compilation);
+      }
+    }
+
+    if (!compilation_cache_filename_.empty()) {
+      OpenCompilationCache(class_path);
+    }
+
     driver_->CompileAll(class_loader, dex_files_, timings_);
+
+    CompilationCache* compilation_cache = driver_->GetCompilationCache();
+    if (compilation_cache != nullptr) {
+      TimingLogger::ScopedTiming t2("dex2oat Write compilation cache", timings_);
+      std::string error_msg;
+      if (!compilation_cache->Write(&error_msg)) {
+        LOG(WARNING) << error_msg;
+      }
+    }
+  }
+
+  void OpenCompilationCache(const std::string& class_path) {
+    TimingLogger::ScopedTiming t("dex2oat Open compilation cache", timings_);
+    // The methods compiled for an image or against another boot image may differ.
+    std::ostringstream context;
+    context << IncrementalFingerprint() << '\n'
+            << instruction_set_ << ' ' << instruction_set_features_->GetFeatureString() << '\n'
+            << class_path;
+    if (!image_) {
+      const ImageHeader& image_header =
+          Runtime::Current()->GetHeap()->GetImageSpace()->GetImageHeader();
+      context << '\n' << image_header.GetOatChecksum() << ' '
+              << reinterpret_cast<uintptr_t>(image_header.GetOatDataBegin()) << ' '
+              << image_header.GetPatchDelta();
+    }
+    std::string error_msg;
+    CompilationCache* compilation_cache = CompilationCache::Open(
+        compilation_cache_filename_,
+        context.str(),
+        instruction_set_,
+        dex_files_,
+        compiler_options_->GetInlineDepthLimit(),
+        &error_msg);
+    if (compilation_cache == nullptr) {
+      LOG(WARNING) << "Not using the compilation cache: " << error_msg;
+    } else {
+      driver_->SetCompilationCache(compilation_cache);
+    }
   }
 
   // Notes on the interleaving of creating the image and oat file to
@@ -1667,6 +1871,13 @@ class Dex2Oat FINAL {
         key_value_store_->Put(OatHeader::kImageLocationKey, image_file_location);
       }
 
+      // The code can only be copied by a later compilation if it does not need to be patched
+      // and there is no CFI to go with it.
+      if (!image_ && driver_->GetLinkerPatchCount() == 0u &&
+          !compiler_options_->GetGenerateDebugInfo()) {
+        key_value_store_->Put(OatHeader::kIncrementalFingerprintKey, IncrementalFingerprint());
+      }
+
       oat_writer.reset(new OatWriter(dex_files_, image_file_location_oat_checksum,
                                      image_file_location_oat_data_begin,
                                      image_patch_delta,
@@ -1789,6 +2000,14 @@ class Dex2Oat FINAL {
   void DumpTiming() {
     if (dump_timing_ || (dump_slow_timing_ && timings_->GetTotalNs() > MsToNs(1000))) {
       LOG(INFO) << Dumpable<TimingLogger>(*timings_);
+      if (driver_->GetCompilationCache() != nullptr) {
+        LOG(INFO) << "Compilation cache: " << driver_->GetCompilationCache()->DumpStats();
+      }
+      if (driver_->GetCodeStream() != nullptr) {
+        LOG(INFO) << "Code stream: " << PrettySize(driver_->GetCodeStream()->GetSize()) << ", "
+                  << driver_->GetCodeStream()->GetNumberOfDeduplicatedAppends()
+                  << " deduplicated methods";
+      }
     }
     if (dump_passes_) {
       LOG(INFO) << Dumpable<CumulativeLogger>(*driver_->GetTimingsLogger());
@@ -2098,8 +2317,12 @@ class Dex2Oat FINAL {
   bool dump_slow_timing_;
   std::string dump_cfg_file_name_;
   std::string dump_cfg_filter_;
+  std::string reuse_oat_filename_;
+  std::string compilation_cache_filename_;
   std::string swap_file_name_;
   int swap_fd_;
+  std::string code_stream_file_name_;
+  int code_stream_fd_;
   std::string profile_file_;  // Profile file to use
   size_t all_dex_file_max_;
   TimingLogger* timings_;
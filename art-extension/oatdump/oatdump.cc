@@ -348,6 +348,8 @@ class OatDumper {
       oat_dex_files_(oat_file.GetOatDexFiles()),
       options_(options),
       resolved_addr2instr_(0),
+      stack_maps_bytes_(0),
+      byte_aligned_stack_maps_bytes_(0),
       instruction_set_(oat_file_.GetOatHeader().GetInstructionSet()),
       disassembler_(Disassembler::Create(instruction_set_,
                                          new DisassemblerOptions(options_.absolute_addresses_,
@@ -475,6 +477,13 @@ class OatDumper {
         }
       }
     }
+
+    if (stack_maps_bytes_ != 0) {
+      os << "OPTIMIZED STACK MAPS:\n";
+      os << StringPrintf("bit-packed = %zd bytes, byte-aligned = %zd bytes (saved %zd bytes)\n\n",
+                         stack_maps_bytes_, byte_aligned_stack_maps_bytes_,
+                         byte_aligned_stack_maps_bytes_ - stack_maps_bytes_);
+    }
     os << std::flush;
     return success;
   }
@@ -1038,6 +1047,22 @@ class OatDumper {
                     const CodeInfo& code_info,
                     const DexFile::CodeItem& code_item) {
     code_info.Dump(os, code_item.registers_size_);
+
+    // Compare the bit-packed stack maps with what they would take if each of
+    // their fields was rounded up to a whole number of bytes.
+    size_t byte_aligned_stack_map_size = code_info.GetStackMaskSize()
+        + RoundUp(code_info.NumberOfBitsForInlineInfo(), kBitsPerByte) / kBitsPerByte
+        + RoundUp(code_info.NumberOfBitsForDexRegisterMap(), kBitsPerByte) / kBitsPerByte
+        + RoundUp(code_info.NumberOfBitsForDexPc(), kBitsPerByte) / kBitsPerByte
+        + RoundUp(code_info.NumberOfBitsForNativePc(), kBitsPerByte) / kBitsPerByte
+        + RoundUp(code_info.NumberOfBitsForRegisterMask(), kBitsPerByte) / kBitsPerByte;
+    size_t stack_maps_size = code_info.GetStackMapsSize();
+    size_t byte_aligned_stack_maps_size =
+        byte_aligned_stack_map_size * code_info.GetNumberOfStackMaps();
+    os << StringPrintf("  StackMaps size: %zd bytes (byte-aligned: %zd bytes)\n",
+                       stack_maps_size, byte_aligned_stack_maps_size);
+    stack_maps_bytes_ += stack_maps_size;
+    byte_aligned_stack_maps_bytes_ += byte_aligned_stack_maps_size;
   }
 
   // Display a vmap table.
@@ -1357,6 +1382,9 @@ class OatDumper {
   const std::vector<const OatFile::OatDexFile*> oat_dex_files_;
   const OatDumperOptions& options_;
   uint32_t resolved_addr2instr_;
+  // Sizes of the dumped optimized stack maps, bit-packed and byte-aligned.
+  size_t stack_maps_bytes_;
+  size_t byte_aligned_stack_maps_bytes_;
   InstructionSet instruction_set_;
   std::set<uintptr_t> offsets_;
   Disassembler* disassembler_;
@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+package OptimizationTests.AllocationSinking.Eliminated;
+
+public class Main {
+    static class Point {
+        int x;
+        int y;
+
+        Point(int x, int y) {
+            this.x = x;
+            this.y = y;
+        }
+    }
+
+    public int testLoop(int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            Point p = new Point(i, i + 1);
+            sum += p.x * p.y;
+        }
+        return sum;
+    }
+
+    public static void test() {
+        Main m = new Main();
+        System.out.println(m.testLoop(10));
+        System.out.println(m.testLoop(100));
+    }
+
+    public static void main(String[] args) {
+        test();
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+package OptimizationTests.AllocationSinking.Sunk;
+
+public class Main {
+    static class Range {
+        int low;
+        int high;
+
+        Range(int low, int high) {
+            this.low = low;
+            this.high = high;
+        }
+    }
+
+    static Range lastRejected;
+
+    public int testLoop(int[] a) {
+        int sum = 0;
+        for (int i = 0; i < a.length; i++) {
+            Range r = new Range(a[i], a[i] * 2);
+            if (r.high > 100) {
+                lastRejected = r;
+            } else {
+                sum += r.high - r.low;
+            }
+        }
+        return sum;
+    }
+
+    public static void test() {
+        int[] a = new int[20];
+        for (int i = 0; i < a.length; i++) {
+            a[i] = i * 7;
+        }
+        System.out.println(new Main().testLoop(a));
+        System.out.println(lastRejected.low);
+    }
+
+    public static void main(String[] args) {
+        test();
+    }
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+package OptimizationTests.LoadStoreElimination.Holder;
+
+public class Main {
+    static class Holder {
+        int value;
+        int scale;
+    }
+
+    public int testLoop(int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            Holder h = new Holder();
+            h.value = i;
+            h.scale = 3;
+            sum += h.value * h.scale;
+        }
+        return sum;
+    }
+
+    public static void test() {
+        Main m = new Main();
+        System.out.println(m.testLoop(10));
+        System.out.println(m.testLoop(1000));
+    }
+
+    public static void main(String[] args) {
+        test();
+    }
+}
@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+package OptimizationTests.LoadStoreElimination.StoreForward;
+
+public class Main {
+    private int value;
+    private long total;
+
+    public long testLoop(int[] a) {
+        for (int i = 0; i < a.length; i++) {
+            value = a[i];
+            value = value + 1;
+            total += value;
+        }
+        return total;
+    }
+
+    public static void test() {
+        int[] a = new int[20];
+        for (int i = 0; i < a.length; i++) {
+            a[i] = i;
+        }
+        System.out.println(new Main().testLoop(a));
+        System.out.println(new Main().testLoop(new int[0]));
+    }
+
+    public static void main(String[] args) {
+        test();
+    }
+}
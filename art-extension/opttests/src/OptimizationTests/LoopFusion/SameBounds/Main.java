@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+package OptimizationTests.LoopFusion.SameBounds;
+
+public class Main {
+    public int testLoop(int[] a, int[] b, int[] c, int n) {
+        for (int i = 0; i < n; i++) {
+            a[i] = b[i] + c[i];
+        }
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += a[i] * c[i];
+        }
+        return sum;
+    }
+
+    public static void test() {
+        int[] a = new int[100];
+        int[] b = new int[100];
+        int[] c = new int[100];
+        for (int i = 0; i < a.length; i++) {
+            b[i] = i * 2 - 50;
+            c[i] = i % 7;
+        }
+        System.out.println(new Main().testLoop(a, b, c, 100));
+    }
+
+    public static void main(String[] args) {
+        test();
+    }
+}
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+package OptimizationTests.LoopInterchange.ColumnScale;
+
+public class Main {
+    public void testLoop(int[][] a, int[][] b, int rows, int columns) {
+        for (int j = 0; j < columns; j++) {
+            for (int i = 0; i < rows; i++) {
+                a[i][j] = b[i][j] * 5 + a[i][j];
+            }
+        }
+    }
+
+    public static void test() {
+        int[][] a = new int[30][20];
+        int[][] b = new int[30][20];
+        for (int i = 0; i < a.length; i++) {
+            for (int j = 0; j < a[i].length; j++) {
+                a[i][j] = i + j;
+                b[i][j] = i - j;
+            }
+        }
+        new Main().testLoop(a, b, 30, 20);
+        long checksum = 0;
+        for (int i = 0; i < a.length; i++) {
+            for (int j = 0; j < a[i].length; j++) {
+                checksum = checksum * 31 + a[i][j];
+            }
+        }
+        System.out.println(checksum);
+    }
+
+    public static void main(String[] args) {
+        test();
+    }
+}
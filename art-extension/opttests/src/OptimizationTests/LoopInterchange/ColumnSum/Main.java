@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+package OptimizationTests.LoopInterchange.ColumnSum;
+
+public class Main {
+    public int testLoop(int[][] a, int rows, int columns) {
+        int sum = 0;
+        for (int j = 0; j < columns; j++) {
+            for (int i = 0; i < rows; i++) {
+                sum += a[i][j];
+            }
+        }
+        return sum;
+    }
+
+    public static void test() {
+        int[][] a = new int[40][25];
+        for (int i = 0; i < a.length; i++) {
+            for (int j = 0; j < a[i].length; j++) {
+                a[i][j] = i * 3 - j;
+            }
+        }
+        System.out.println(new Main().testLoop(a, 40, 25));
+    }
+
+    public static void main(String[] args) {
+        test();
+    }
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package OptimizationTests.LoopPartialUnrolling.SumInvariantBound;
+
+public class Main {
+    // The trip count is only known at runtime.
+    public static int testLoop(int n, int x) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += i * x;
+        }
+        return sum;
+    }
+
+    public void test() {
+        // Exercise the remainder loop with every possible number of leftover iterations.
+        for (int n = -1; n < 11; n++) {
+            System.out.println(testLoop(n, 3));
+        }
+        System.out.println(testLoop(1000, 7));
+    }
+
+    public static void main(String[] args) {
+        new Main().test();
+    }
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+package OptimizationTests.LoopStrengthReduction.ExitTest;
+
+public class Main {
+    public int testLoop(int[] a) {
+        int sum = 0;
+        // The IV is only used scaled, so the exit test is rewritten on the scaled IV.
+        for (int i = 0; i < 500; i++) {
+            sum += a[i * 2] + a[(i << 1) + 1];
+        }
+        return sum;
+    }
+
+    public static void test() {
+        int[] a = new int[1000];
+        for (int i = 0; i < a.length; i++) {
+            a[i] = i % 13;
+        }
+        System.out.println(new Main().testLoop(a));
+    }
+
+    public static void main(String[] args) {
+        test();
+    }
+}
@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+package OptimizationTests.LoopStrengthReduction.Strided;
+
+public class Main {
+    public int testLoop(int[] a, int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += a[i * 3];
+        }
+        return sum;
+    }
+
+    public static void test() {
+        int[] a = new int[90];
+        for (int i = 0; i < a.length; i++) {
+            a[i] = i - 7;
+        }
+        System.out.println(new Main().testLoop(a, 30));
+    }
+
+    public static void main(String[] args) {
+        test();
+    }
+}
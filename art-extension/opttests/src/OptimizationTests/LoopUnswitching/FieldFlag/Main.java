@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package OptimizationTests.LoopUnswitching.FieldFlag;
+
+public class Main {
+    private final boolean squares;
+
+    public Main(boolean squares) {
+        this.squares = squares;
+    }
+
+    public int testLoop(int[] a) {
+        int sum = 0;
+        for (int i = 0; i < a.length; i++) {
+            int value = a[i];
+            if (squares) {
+                value *= value;
+            }
+            sum += value;
+        }
+        return sum;
+    }
+
+    public static void test() {
+        int[] a = new int[30];
+        for (int i = 0; i < a.length; i++) {
+            a[i] = i - 10;
+        }
+        System.out.println(new Main(false).testLoop(a));
+        System.out.println(new Main(true).testLoop(a));
+    }
+
+    public static void main(String[] args) {
+        test();
+    }
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package OptimizationTests.LoopUnswitching.ParamFlag;
+
+public class Main {
+    public static int testLoop(int[] a, boolean negate) {
+        int sum = 0;
+        for (int i = 0; i < a.length; i++) {
+            if (negate) {
+                sum -= a[i];
+            } else {
+                sum += a[i];
+            }
+        }
+        return sum;
+    }
+
+    public void test() {
+        int[] a = new int[50];
+        for (int i = 0; i < a.length; i++) {
+            a[i] = i * 3 - 7;
+        }
+        System.out.println(testLoop(a, false));
+        System.out.println(testLoop(a, true));
+    }
+
+    public static void main(String[] args) {
+        new Main().test();
+    }
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package OptimizationTests.LoopVectorization.FloatMul;
+
+public class Main {
+    // 4 float lanes, with a loop invariant replicated in the vector body.
+    public static void testLoop(float[] a, float k) {
+        for (int i = 0; i < a.length; i++) {
+            a[i] = a[i] * k - 2.0f;
+        }
+    }
+
+    public void test() {
+        float[] a = new float[23];
+        for (int i = 0; i < a.length; i++) {
+            a[i] = i;
+        }
+        testLoop(a, 1.5f);
+        float sum = 0.0f;
+        for (int i = 0; i < a.length; i++) {
+            sum += a[i];
+        }
+        System.out.println(sum);
+    }
+
+    public static void main(String[] args) {
+        new Main().test();
+    }
+}
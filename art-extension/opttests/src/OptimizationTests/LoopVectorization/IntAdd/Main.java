@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package OptimizationTests.LoopVectorization.IntAdd;
+
+public class Main {
+    // 4 int lanes: 37 elements leave a remainder of 1 for the scalar loop.
+    public static void testLoop(int[] a) {
+        for (int i = 0; i < a.length; i++) {
+            a[i] = (a[i] + 7) ^ 5;
+        }
+    }
+
+    public void test() {
+        int[] a = new int[37];
+        for (int i = 0; i < a.length; i++) {
+            a[i] = -3 * i;
+        }
+        testLoop(a);
+        int sum = 0;
+        for (int i = 0; i < a.length; i++) {
+            sum += a[i] * (i + 1);
+        }
+        System.out.println(sum);
+    }
+
+    public static void main(String[] args) {
+        new Main().test();
+    }
+}
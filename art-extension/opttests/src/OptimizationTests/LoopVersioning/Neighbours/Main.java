@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package OptimizationTests.LoopVersioning.Neighbours;
+
+public class Main {
+    public static int testLoop(int[] a, int[] b, int n) {
+        for (int i = 1; i < n; i++) {
+            b[i] = a[i - 1] + a[i];
+        }
+        return b[n - 1];
+    }
+
+    public void test() {
+        int[] a = new int[64];
+        int[] b = new int[64];
+        for (int i = 0; i < a.length; i++) {
+            a[i] = i * i % 17;
+        }
+        System.out.println(testLoop(a, b, 60));
+
+        int sum = 0;
+        for (int i = 0; i < b.length; i++) {
+            sum += b[i];
+        }
+        System.out.println(sum);
+
+        // The loop does not run: a null array must not throw.
+        System.out.println(testLoop(null, b, 1));
+    }
+
+    public static void main(String[] args) {
+        new Main().test();
+    }
+}
@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package OptimizationTests.LoopVersioning.ParamBound;
+
+public class Main {
+    public static int testLoop(int[] a, int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            sum += a[i] * 3;
+        }
+        return sum;
+    }
+
+    public void test() {
+        int[] a = new int[100];
+        for (int i = 0; i < a.length; i++) {
+            a[i] = i - 20;
+        }
+        System.out.println(testLoop(a, 90));
+
+        // The bound is too big: the checked copy of the loop must throw.
+        try {
+            testLoop(a, 101);
+        } catch (ArrayIndexOutOfBoundsException e) {
+            System.out.println("ArrayIndexOutOfBoundsException");
+        }
+    }
+
+    public static void main(String[] args) {
+        new Main().test();
+    }
+}
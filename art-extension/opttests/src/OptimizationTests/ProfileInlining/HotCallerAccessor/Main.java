@@ -0,0 +1,50 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+package OptimizationTests.ProfileInlining.HotCallerAccessor;
+
+// The profile only samples testLoop, the accessors are not sampled at all.
+public class Main {
+    private int value;
+    private int scale = 3;
+    private int offset = 1;
+
+    public final void setValue(int value) {
+        this.value = value;
+    }
+
+    public final int getScaledValue() {
+        return value * scale + offset;
+    }
+
+    public int testLoop(int n) {
+        int sum = 0;
+        for (int i = 0; i < n; i++) {
+            setValue(i);
+            sum += getScaledValue();
+        }
+        return sum;
+    }
+
+    public static void test() {
+        System.out.println(new Main().testLoop(10));
+    }
+
+    public static void main(String[] args) {
+        test();
+    }
+}
@@ -45,6 +45,10 @@ static constexpr const char* x86_variants_with_sse4_2[] = {
     "silvermont",
 };
 
+static constexpr const char* x86_variants_with_popcnt[] = {
+    "silvermont",
+};
+
 const X86InstructionSetFeatures* X86InstructionSetFeatures::FromVariant(
     const std::string& variant, std::string* error_msg ATTRIBUTE_UNUSED,
     bool x86_64) {
@@ -59,6 +63,12 @@ const X86InstructionSetFeatures* X86InstructionSetFeatures::FromVariant(
                                        variant);
   bool has_AVX = false;
   bool has_AVX2 = false;
+  bool has_POPCNT = FindVariantInArray(x86_variants_with_popcnt,
+                                       arraysize(x86_variants_with_popcnt),
+                                       variant);
+  // None of the known variants implement LZCNT and TZCNT.
+  bool has_LZCNT = false;
+  bool has_TZCNT = false;
 
   bool known_variant = FindVariantInArray(x86_known_variants, arraysize(x86_known_variants),
                                           variant);
@@ -68,10 +78,10 @@ const X86InstructionSetFeatures* X86InstructionSetFeatures::FromVariant(
 
   if (x86_64) {
     return new X86_64InstructionSetFeatures(smp, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX,
-                                            has_AVX2);
+                                            has_AVX2, has_POPCNT, has_LZCNT, has_TZCNT);
   } else {
     return new X86InstructionSetFeatures(smp, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX,
-                                            has_AVX2);
+                                         has_AVX2, has_POPCNT, has_LZCNT, has_TZCNT);
   }
 }
 
@@ -83,11 +93,15 @@ const X86InstructionSetFeatures* X86InstructionSetFeatures::FromBitmap(uint32_t
   bool has_SSE4_2 = (bitmap & kSse4_2Bitfield) != 0;
   bool has_AVX = (bitmap & kAvxBitfield) != 0;
   bool has_AVX2 = (bitmap & kAvxBitfield) != 0;
+  bool has_POPCNT = (bitmap & kPopcntBitfield) != 0;
+  bool has_LZCNT = (bitmap & kLzcntBitfield) != 0;
+  bool has_TZCNT = (bitmap & kTzcntBitfield) != 0;
   if (x86_64) {
-    return new X86_64InstructionSetFeatures(smp, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX, has_AVX2);
+    return new X86_64InstructionSetFeatures(smp, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX,
+                                            has_AVX2, has_POPCNT, has_LZCNT, has_TZCNT);
   } else {
     return new X86InstructionSetFeatures(smp, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX,
-                                            has_AVX2);
+                                         has_AVX2, has_POPCNT, has_LZCNT, has_TZCNT);
   }
 }
 
@@ -124,11 +138,30 @@ const X86InstructionSetFeatures* X86InstructionSetFeatures::FromCppDefines(bool
   const bool has_AVX2 = true;
 #endif
 
+#ifndef __POPCNT__
+  const bool has_POPCNT = false;
+#else
+  const bool has_POPCNT = true;
+#endif
+
+#ifndef __LZCNT__
+  const bool has_LZCNT = false;
+#else
+  const bool has_LZCNT = true;
+#endif
+
+#ifndef __BMI__
+  const bool has_TZCNT = false;
+#else
+  const bool has_TZCNT = true;
+#endif
+
   if (x86_64) {
-    return new X86_64InstructionSetFeatures(smp, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX, has_AVX2);
+    return new X86_64InstructionSetFeatures(smp, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX,
+                                            has_AVX2, has_POPCNT, has_LZCNT, has_TZCNT);
   } else {
     return new X86InstructionSetFeatures(smp, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX,
-                                            has_AVX2);
+                                         has_AVX2, has_POPCNT, has_LZCNT, has_TZCNT);
   }
 }
 
@@ -141,6 +174,9 @@ const X86InstructionSetFeatures* X86InstructionSetFeatures::FromCpuInfo(bool x86
   bool has_SSE4_2 = false;
   bool has_AVX = false;
   bool has_AVX2 = false;
+  bool has_POPCNT = false;
+  bool has_LZCNT = false;
+  bool has_TZCNT = false;
 
   std::ifstream in("/proc/cpuinfo");
   if (!in.fail()) {
@@ -166,6 +202,17 @@ const X86InstructionSetFeatures* X86InstructionSetFeatures::FromCpuInfo(bool x86
           if (line.find("avx2") != std::string::npos) {
             has_AVX2 = true;
           }
+          if (line.find("popcnt") != std::string::npos) {
+            has_POPCNT = true;
+          }
+          // LZCNT is reported as part of the advanced bit manipulation extension.
+          if (line.find("abm") != std::string::npos) {
+            has_LZCNT = true;
+          }
+          // TZCNT is part of the first bit manipulation instruction set.
+          if (line.find("bmi1") != std::string::npos) {
+            has_TZCNT = true;
+          }
         } else if (line.find("processor") != std::string::npos &&
             line.find(": 1") != std::string::npos) {
           smp = true;
@@ -177,10 +224,11 @@ const X86InstructionSetFeatures* X86InstructionSetFeatures::FromCpuInfo(bool x86
     LOG(ERROR) << "Failed to open /proc/cpuinfo";
   }
   if (x86_64) {
-    return new X86_64InstructionSetFeatures(smp, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX, has_AVX2);
+    return new X86_64InstructionSetFeatures(smp, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX,
+                                            has_AVX2, has_POPCNT, has_LZCNT, has_TZCNT);
   } else {
     return new X86InstructionSetFeatures(smp, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX,
-                                            has_AVX2);
+                                         has_AVX2, has_POPCNT, has_LZCNT, has_TZCNT);
   }
 }
 
@@ -204,7 +252,10 @@ bool X86InstructionSetFeatures::Equals(const InstructionSetFeatures* other) cons
       (has_SSE4_1_ == other_as_x86->has_SSE4_1_) &&
       (has_SSE4_2_ == other_as_x86->has_SSE4_2_) &&
       (has_AVX_ == other_as_x86->has_AVX_) &&
-      (has_AVX2_ == other_as_x86->has_AVX2_);
+      (has_AVX2_ == other_as_x86->has_AVX2_) &&
+      (has_POPCNT_ == other_as_x86->has_POPCNT_) &&
+      (has_LZCNT_ == other_as_x86->has_LZCNT_) &&
+      (has_TZCNT_ == other_as_x86->has_TZCNT_);
 }
 
 uint32_t X86InstructionSetFeatures::AsBitmap() const {
@@ -213,7 +264,10 @@ uint32_t X86InstructionSetFeatures::AsBitmap() const {
       (has_SSE4_1_ ? kSse4_1Bitfield : 0) |
       (has_SSE4_2_ ? kSse4_2Bitfield : 0) |
       (has_AVX_ ? kAvxBitfield : 0) |
-      (has_AVX2_ ? kAvx2Bitfield : 0);
+      (has_AVX2_ ? kAvx2Bitfield : 0) |
+      (has_POPCNT_ ? kPopcntBitfield : 0) |
+      (has_LZCNT_ ? kLzcntBitfield : 0) |
+      (has_TZCNT_ ? kTzcntBitfield : 0);
 }
 
 std::string X86InstructionSetFeatures::GetFeatureString() const {
@@ -248,6 +302,21 @@ std::string X86InstructionSetFeatures::GetFeatureString() const {
   } else {
     result += ",-avx2";
   }
+  if (has_POPCNT_) {
+    result += ",popcnt";
+  } else {
+    result += ",-popcnt";
+  }
+  if (has_LZCNT_) {
+    result += ",lzcnt";
+  } else {
+    result += ",-lzcnt";
+  }
+  if (has_TZCNT_) {
+    result += ",tzcnt";
+  } else {
+    result += ",-tzcnt";
+  }
   return result;
 }
 
@@ -259,6 +328,9 @@ const InstructionSetFeatures* X86InstructionSetFeatures::AddFeaturesFromSplitStr
   bool has_SSE4_2 = has_SSE4_2_;
   bool has_AVX = has_AVX_;
   bool has_AVX2 = has_AVX2_;
+  bool has_POPCNT = has_POPCNT_;
+  bool has_LZCNT = has_LZCNT_;
+  bool has_TZCNT = has_TZCNT_;
   for (auto i = features.begin(); i != features.end(); i++) {
     std::string feature = Trim(*i);
     if (feature == "ssse3") {
@@ -281,6 +353,18 @@ const InstructionSetFeatures* X86InstructionSetFeatures::AddFeaturesFromSplitStr
       has_AVX2 = true;
     } else if (feature == "-avx2") {
       has_AVX2 = false;
+    } else if (feature == "popcnt") {
+      has_POPCNT = true;
+    } else if (feature == "-popcnt") {
+      has_POPCNT = false;
+    } else if (feature == "lzcnt") {
+      has_LZCNT = true;
+    } else if (feature == "-lzcnt") {
+      has_LZCNT = false;
+    } else if (feature == "tzcnt") {
+      has_TZCNT = true;
+    } else if (feature == "-tzcnt") {
+      has_TZCNT = false;
     } else {
       *error_msg = StringPrintf("Unknown instruction set feature: '%s'", feature.c_str());
       return nullptr;
@@ -288,10 +372,10 @@ const InstructionSetFeatures* X86InstructionSetFeatures::AddFeaturesFromSplitStr
   }
   if (x86_64) {
     return new X86_64InstructionSetFeatures(smp, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX,
-                                            has_AVX2);
+                                            has_AVX2, has_POPCNT, has_LZCNT, has_TZCNT);
   } else {
     return new X86InstructionSetFeatures(smp, has_SSSE3, has_SSE4_1, has_SSE4_2, has_AVX,
-                                            has_AVX2);
+                                         has_AVX2, has_POPCNT, has_LZCNT, has_TZCNT);
   }
 }
 
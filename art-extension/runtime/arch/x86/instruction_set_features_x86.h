@@ -60,6 +60,12 @@ class X86InstructionSetFeatures : public InstructionSetFeatures {
 
   bool HasSSE4_1() const { return has_SSE4_1_; }
 
+  bool HasPopCnt() const { return has_POPCNT_; }
+
+  bool HasLzCnt() const { return has_LZCNT_; }
+
+  bool HasTzCnt() const { return has_TZCNT_; }
+
  protected:
   // Parse a string of the form "ssse3" adding these to a new InstructionSetFeatures.
   virtual const InstructionSetFeatures*
@@ -73,9 +79,11 @@ class X86InstructionSetFeatures : public InstructionSetFeatures {
                                  bool x86_64, std::string* error_msg) const;
 
   X86InstructionSetFeatures(bool smp, bool has_SSSE3, bool has_SSE4_1, bool has_SSE4_2,
-                            bool has_AVX, bool has_AVX2)
+                            bool has_AVX, bool has_AVX2, bool has_POPCNT, bool has_LZCNT,
+                            bool has_TZCNT)
       : InstructionSetFeatures(smp), has_SSSE3_(has_SSSE3), has_SSE4_1_(has_SSE4_1),
-        has_SSE4_2_(has_SSE4_2), has_AVX_(has_AVX), has_AVX2_(has_AVX2) {
+        has_SSE4_2_(has_SSE4_2), has_AVX_(has_AVX), has_AVX2_(has_AVX2),
+        has_POPCNT_(has_POPCNT), has_LZCNT_(has_LZCNT), has_TZCNT_(has_TZCNT) {
   }
 
  private:
@@ -87,6 +95,9 @@ class X86InstructionSetFeatures : public InstructionSetFeatures {
     kSse4_2Bitfield = 8,
     kAvxBitfield = 16,
     kAvx2Bitfield = 32,
+    kPopcntBitfield = 64,
+    kLzcntBitfield = 128,
+    kTzcntBitfield = 256,
   };
 
   const bool has_SSSE3_;   // x86 128bit SIMD - Supplemental SSE.
@@ -94,6 +105,9 @@ class X86InstructionSetFeatures : public InstructionSetFeatures {
   const bool has_SSE4_2_;  // x86 128bit SIMD SSE4.2.
   const bool has_AVX_;     // x86 256bit SIMD AVX.
   const bool has_AVX2_;    // x86 256bit SIMD AVX 2.0.
+  const bool has_POPCNT_;  // x86 population count.
+  const bool has_LZCNT_;   // x86 leading zero count (ABM).
+  const bool has_TZCNT_;   // x86 trailing zero count (BMI1).
 
   DISALLOW_COPY_AND_ASSIGN(X86InstructionSetFeatures);
 };
@@ -20,6 +20,7 @@
 #ifndef ART_RUNTIME_ART_METHOD_H_
 #define ART_RUNTIME_ART_METHOD_H_
 
+#include "atomic.h"
 #include "dex_file.h"
 #include "gc_root.h"
 #include "invoke_type.h"
@@ -46,6 +47,10 @@ class Class;
 class PointerArray;
 }  // namespace mirror
 
+namespace jit {
+class MethodInlineCaches;
+}  // namespace jit
+
 typedef void (EntryPointFromInterpreter)(Thread* self, const DexFile::CodeItem* code_item,
                                          ShadowFrame* shadow_frame, JValue* result);
 
@@ -434,6 +439,20 @@ class ArtMethod FINAL {
     SetEntryPoint(EntryPointFromJniOffset(pointer_size), entrypoint, pointer_size);
   }
 
+  // The JNI entrypoint of a method that is not native holds the inline caches the JIT records
+  // for its call sites. They are installed once and read without locking.
+  jit::MethodInlineCaches* GetInlineCaches() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    DCHECK(!IsNative());
+    return InlineCachesField()->LoadSequentiallyConsistent();
+  }
+
+  // Installs the inline caches of the method. Returns false if another thread did it first.
+  bool CasInlineCaches(jit::MethodInlineCaches* caches)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    DCHECK(!IsNative());
+    return InlineCachesField()->CompareExchangeStrongSequentiallyConsistent(nullptr, caches);
+  }
+
   // Is this a CalleSaveMethod or ResolutionMethod and therefore doesn't adhere to normal
   // conventions for a method of managed code. Returns false for Proxy methods.
   ALWAYS_INLINE bool IsRuntimeMethod();
@@ -598,6 +617,11 @@ class ArtMethod FINAL {
     return RoundUp(OFFSETOF_MEMBER(ArtMethod, ptr_sized_fields_), pointer_size);
   }
 
+  Atomic<jit::MethodInlineCaches*>* InlineCachesField() {
+    return reinterpret_cast<Atomic<jit::MethodInlineCaches*>*>(
+        &ptr_sized_fields_.entry_point_from_jni_);
+  }
+
   template<typename T>
   ALWAYS_INLINE T GetEntryPoint(MemberOffset offset, size_t pointer_size) const {
     DCHECK(ValidPointerSize(pointer_size)) << pointer_size;
@@ -142,6 +142,13 @@ void TimingLogger::StartTiming(const char* label) {
   ATRACE_BEGIN(label);
 }
 
+void TimingLogger::StartTimingAt(const char* label, uint64_t start_ns) {
+  DCHECK(label != nullptr);
+  DCHECK(timings_.empty() || timings_.back().GetTime() <= start_ns);
+  timings_.push_back(Timing(start_ns, label));
+  ATRACE_BEGIN(label);
+}
+
 void TimingLogger::EndTiming() {
   timings_.push_back(Timing(NanoTime(), nullptr));
   ATRACE_END();
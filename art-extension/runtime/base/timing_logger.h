@@ -139,6 +139,9 @@ class TimingLogger {
   void Reset();
   // Starts a timing.
   void StartTiming(const char* new_split_label);
+  // Starts a timing which began at `start_ns` (as given by NanoTime()), for instance when
+  // another thread saw it start. It must not be earlier than the last recorded timing.
+  void StartTimingAt(const char* new_split_label, uint64_t start_ns);
   // Ends the current timing.
   void EndTiming();
   // End the current timing and start a new timing. Usage not recommended.
@@ -16,6 +16,7 @@
 
 #include "timing_logger.h"
 
+#include "base/time_utils.h"
 #include "common_runtime_test.h"
 
 namespace art {
@@ -158,4 +159,22 @@ TEST_F(TimingLoggerTest, ScopedAndExplicit) {
   EXPECT_LE(timings[idx_innerinnersplit1].GetTime(), timings[idx_innerinnersplit2].GetTime());
 }
 
+TEST_F(TimingLoggerTest, StartAt) {
+  const char* outersplit = "Outer Split";
+  const char* innersplit = "Inner Split";
+  TimingLogger logger("StartAt", true, false);
+  logger.StartTiming(outersplit);
+  const uint64_t inner_start = NanoTime();
+  logger.StartTimingAt(innersplit, inner_start);
+  logger.EndTiming();  // Ends innersplit.
+  logger.EndTiming();  // Ends outersplit.
+  const size_t idx_outersplit = logger.FindTimingIndex(outersplit, 0);
+  const size_t idx_innersplit = logger.FindTimingIndex(innersplit, 0);
+  const auto& timings = logger.GetTimings();
+  EXPECT_EQ(4U, timings.size());
+  EXPECT_EQ(inner_start, timings[idx_innersplit].GetTime());
+  TimingLogger::TimingData data(logger.CalculateTimingData());
+  EXPECT_GE(data.GetTotalTime(idx_outersplit), data.GetTotalTime(idx_innersplit));
+}
+
 }  // namespace art
@@ -136,8 +136,11 @@ class EntrypointsOrderTest : public CommonRuntimeTest {
                         sizeof(void*) * kLockLevelCount);
     EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, nested_signal_state, flip_function, sizeof(void*));
     EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, flip_function, method_verifier, sizeof(void*));
-    EXPECT_OFFSET_DIFF(Thread, tlsPtr_.method_verifier, Thread, wait_mutex_, sizeof(void*),
-                       thread_tlsptr_end);
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, method_verifier, gc_profile_buffer, sizeof(void*));
+    EXPECT_OFFSET_DIFFP(Thread, tlsPtr_, gc_profile_buffer, concurrent_copying_thread_state,
+                        sizeof(void*));
+    EXPECT_OFFSET_DIFF(Thread, tlsPtr_.concurrent_copying_thread_state, Thread, wait_mutex_,
+                       sizeof(void*), thread_tlsptr_end);
   }
 
   void CheckInterpreterEntryPoints() {
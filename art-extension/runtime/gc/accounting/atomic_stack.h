@@ -146,6 +146,57 @@ class AtomicStack {
     return begin_[index];
   }
 
+  // Work-stealing operations: the owner thread pushes and pops at the back with OwnerPushBack()
+  // and OwnerPopBack() while other threads take from the front with StealFront(). The stack
+  // does not wrap around, so it may only be reset once no thread can steal from it.
+
+  // Returns false if we overflowed the stack.
+  bool OwnerPushBack(T* value) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    const int32_t index = back_index_.LoadRelaxed();
+    if (UNLIKELY(static_cast<size_t>(index) >= growth_limit_)) {
+      return false;
+    }
+    begin_[index].Assign(value);
+    // Publish the element to the stealing threads.
+    back_index_.StoreSequentiallyConsistent(index + 1);
+    return true;
+  }
+
+  // Returns null if the stack is empty or a stealing thread took the last element.
+  T* OwnerPopBack() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    const int32_t index = back_index_.LoadRelaxed() - 1;
+    back_index_.StoreSequentiallyConsistent(index);
+    int32_t front_index = front_index_.LoadSequentiallyConsistent();
+    if (front_index > index) {
+      // Empty.
+      back_index_.StoreRelaxed(index + 1);
+      return nullptr;
+    }
+    T* value = begin_[index].AsMirrorPtr();
+    if (front_index == index) {
+      // Last element, race with the stealing threads for it.
+      if (!front_index_.CompareExchangeStrongSequentiallyConsistent(front_index, index + 1)) {
+        value = nullptr;
+      }
+      back_index_.StoreRelaxed(index + 1);
+    }
+    return value;
+  }
+
+  // Returns null if the stack is empty or we lost the race for the front element.
+  T* StealFront() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    int32_t front_index = front_index_.LoadSequentiallyConsistent();
+    int32_t back_index = back_index_.LoadSequentiallyConsistent();
+    if (front_index >= back_index) {
+      return nullptr;
+    }
+    T* value = begin_[front_index].AsMirrorPtr();
+    if (!front_index_.CompareExchangeStrongSequentiallyConsistent(front_index, front_index + 1)) {
+      return nullptr;
+    }
+    return value;
+  }
+
   // Pop a number of elements.
   void PopBackCount(int32_t n) {
     DCHECK_GE(Size(), static_cast<size_t>(n));
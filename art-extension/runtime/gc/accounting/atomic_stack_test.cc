@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "atomic_stack.h"
+
+#include <memory>
+
+#include "atomic.h"
+#include "common_runtime_test.h"
+#include "scoped_thread_state_change.h"
+#include "thread_pool.h"
+
+namespace art {
+namespace gc {
+namespace accounting {
+
+class AtomicStackTest : public CommonRuntimeTest {};
+
+// Fake, never dereferenced, objects.
+static mirror::Object* FakeObject(size_t i) {
+  return reinterpret_cast<mirror::Object*>((i + 1) * kObjectAlignment);
+}
+
+static size_t FakeObjectIndex(mirror::Object* obj) {
+  return reinterpret_cast<uintptr_t>(obj) / kObjectAlignment - 1;
+}
+
+TEST_F(AtomicStackTest, OwnerPushPopSteal) {
+  ScopedObjectAccess soa(Thread::Current());
+  std::unique_ptr<ObjectStack> stack(ObjectStack::Create("test stack", 4, 4));
+  EXPECT_TRUE(stack->OwnerPopBack() == nullptr);
+  EXPECT_TRUE(stack->StealFront() == nullptr);
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_TRUE(stack->OwnerPushBack(FakeObject(i)));
+  }
+  EXPECT_FALSE(stack->OwnerPushBack(FakeObject(4)));
+  // The owner pops the newest element, the others steal the oldest one.
+  EXPECT_EQ(FakeObject(3), stack->OwnerPopBack());
+  EXPECT_EQ(FakeObject(0), stack->StealFront());
+  EXPECT_EQ(FakeObject(1), stack->StealFront());
+  EXPECT_EQ(FakeObject(2), stack->OwnerPopBack());
+  EXPECT_TRUE(stack->OwnerPopBack() == nullptr);
+  EXPECT_TRUE(stack->StealFront() == nullptr);
+  EXPECT_TRUE(stack->IsEmpty());
+}
+
+class StealTask : public Task {
+ public:
+  StealTask(ObjectStack* stack, Atomic<bool>* owner_done, Atomic<size_t>* counts)
+      : stack_(stack), owner_done_(owner_done), counts_(counts) {}
+
+  virtual void Run(Thread* self) {
+    ScopedObjectAccess soa(self);
+    while (true) {
+      // Read the flag first so that nothing is pushed after the last steal attempt.
+      bool owner_done = owner_done_->LoadSequentiallyConsistent();
+      mirror::Object* obj = stack_->StealFront();
+      if (obj != nullptr) {
+        counts_[FakeObjectIndex(obj)].FetchAndAddSequentiallyConsistent(1);
+      } else if (owner_done && stack_->IsEmpty()) {
+        break;
+      }
+    }
+  }
+
+  virtual void Finalize() {
+    delete this;
+  }
+
+ private:
+  ObjectStack* const stack_;
+  Atomic<bool>* const owner_done_;
+  Atomic<size_t>* const counts_;
+};
+
+TEST_F(AtomicStackTest, ConcurrentSteal) {
+  static constexpr size_t kNumObjects = 100000;
+  static constexpr size_t kNumThieves = 4;
+  Thread* self = Thread::Current();
+  std::unique_ptr<ObjectStack> stack(
+      ObjectStack::Create("test stack", kNumObjects, kNumObjects));
+  std::unique_ptr<Atomic<size_t>[]> counts(new Atomic<size_t>[kNumObjects]);
+  for (size_t i = 0; i < kNumObjects; ++i) {
+    counts[i].StoreRelaxed(0);
+  }
+  Atomic<bool> owner_done(false);
+  ThreadPool thread_pool("Atomic stack test thread pool", kNumThieves);
+  for (size_t i = 0; i < kNumThieves; ++i) {
+    thread_pool.AddTask(self, new StealTask(stack.get(), &owner_done, counts.get()));
+  }
+  thread_pool.StartWorkers(self);
+  {
+    ScopedObjectAccess soa(self);
+    // Pop every other push, so that the owner and the thieves race for the last elements.
+    for (size_t i = 0; i < kNumObjects; ++i) {
+      CHECK(stack->OwnerPushBack(FakeObject(i)));
+      if ((i & 1) != 0) {
+        mirror::Object* obj = stack->OwnerPopBack();
+        if (obj != nullptr) {
+          counts[FakeObjectIndex(obj)].FetchAndAddSequentiallyConsistent(1);
+        }
+      }
+    }
+    mirror::Object* obj;
+    while ((obj = stack->OwnerPopBack()) != nullptr) {
+      counts[FakeObjectIndex(obj)].FetchAndAddSequentiallyConsistent(1);
+    }
+    owner_done.StoreSequentiallyConsistent(true);
+  }
+  thread_pool.Wait(self, false, false);
+  // Every object was taken exactly once.
+  for (size_t i = 0; i < kNumObjects; ++i) {
+    EXPECT_EQ(1U, counts[i].LoadRelaxed()) << i;
+  }
+}
+
+}  // namespace accounting
+}  // namespace gc
+}  // namespace art
@@ -20,6 +20,7 @@
 #include "rosalloc.h"
 
 #include "base/mutex-inl.h"
+#include "base/time_utils.h"
 #include "gc/accounting/space_bitmap-inl.h"
 #include "gc/space/valgrind_settings.h"
 #include "mem_map.h"
@@ -58,6 +59,7 @@ RosAlloc::RosAlloc(void* base, size_t capacity, size_t max_capacity,
                    size_t page_release_size_threshold)
     : base_(reinterpret_cast<uint8_t*>(base)), footprint_(capacity),
       capacity_(capacity), max_capacity_(max_capacity),
+      lazy_sweep_live_(nullptr), lazy_sweep_mark_(nullptr), lazy_sweep_heap_begin_(0),
       lock_("rosalloc global lock", kRosAllocGlobalLock),
       bulk_free_lock_("rosalloc bulk free lock", kRosAllocBulkFreeLock),
       page_release_mode_(page_release_mode),
@@ -559,6 +561,7 @@ RosAlloc::Run* RosAlloc::AllocRun(Thread* self, size_t idx) {
     new_run->size_bracket_idx_ = idx;
     DCHECK(!new_run->IsThreadLocal());
     DCHECK(!new_run->to_be_bulk_freed_);
+    DCHECK(!new_run->needs_sweep_);
     new_run->InitFreeList();
     if (kUsePrefetchDuringAllocRun && idx < kNumThreadLocalSizeBrackets) {
       // Take ownership of the cache lines if we are likely to be thread local run.
@@ -580,9 +583,20 @@ RosAlloc::Run* RosAlloc::AllocRun(Thread* self, size_t idx) {
   return new_run;
 }
 
-RosAlloc::Run* RosAlloc::RefillRun(size_t idx) {
+RosAlloc::Run* RosAlloc::RefillRun(Thread* self, size_t idx) {
   // Get the lowest address non-full run from the binary tree.
   auto* const bt = &non_full_runs_[idx];
+  auto* const runs_to_sweep = &runs_to_sweep_[idx];
+  // If there's none, sweep the runs the lazy sweep left until one gets
+  // non-full rather than allocating a new run.
+  while (bt->empty() && !runs_to_sweep->empty()) {
+    Run* run = *runs_to_sweep->begin();
+    SweepRunSlots(run);
+    if (UpdateRunMetadataLocked(run)) {
+      MutexLock mu(self, lock_);
+      FreePages(self, run, true);
+    }
+  }
   if (!bt->empty()) {
     // If there's one, use it as the current run.
     auto it = bt->begin();
@@ -590,6 +604,11 @@ RosAlloc::Run* RosAlloc::RefillRun(size_t idx) {
     DCHECK(non_full_run != nullptr);
     DCHECK(!non_full_run->IsThreadLocal());
     bt->erase(it);
+    if (non_full_run->needs_sweep_) {
+      // Free the dead slots before handing out the run.
+      SweepRunSlots(non_full_run);
+      non_full_run->MergeBulkFreeListToFreeList();
+    }
     return non_full_run;
   }
   return nullptr;
@@ -599,6 +618,13 @@ inline void* RosAlloc::AllocFromCurrentRunUnlocked(Thread* self, size_t idx) {
   Run* current_run = current_runs_[idx];
   DCHECK(current_run != nullptr);
   void* slot_addr = current_run->AllocSlot();
+  if (UNLIKELY(slot_addr == nullptr && current_run->needs_sweep_)) {
+    // The current run got full, but the lazy sweep left dead slots in it.
+    SweepRunSlots(current_run);
+    current_run->MergeBulkFreeListToFreeList();
+    slot_addr = current_run->AllocSlot();
+    DCHECK(slot_addr != nullptr);
+  }
   if (UNLIKELY(slot_addr == nullptr)) {
     // The current run got full. Try to refill it.
     DCHECK(current_run->IsFull());
@@ -612,7 +638,7 @@ inline void* RosAlloc::AllocFromCurrentRunUnlocked(Thread* self, size_t idx) {
       DCHECK(non_full_runs_[idx].find(current_run) == non_full_runs_[idx].end());
       DCHECK(full_runs_[idx].find(current_run) != full_runs_[idx].end());
     }
-    current_run = RefillRun(idx);
+    current_run = RefillRun(self, idx);
     if (current_run == nullptr) {
       // If there's none, allocate a new run and use it as the current run.
       current_run = AllocRun(self, idx);
@@ -698,6 +724,11 @@ void* RosAlloc::AllocFromRun(Thread* self, size_t size, size_t* bytes_allocated,
       DCHECK(thread_local_run->IsFull());
       {
         MutexLock mu(self, *size_bracket_locks_[idx]);
+        if (thread_local_run->needs_sweep_) {
+          // Free the dead slots the lazy sweep left in the run first.
+          SweepRunSlots(thread_local_run);
+          thread_local_run->MergeBulkFreeListToThreadLocalFreeList();
+        }
         bool is_all_free_after_merge;
         // This is safe to do for the dedicated_full_run_ since the free list are empty.
         if (thread_local_run->MergeThreadLocalFreeListToFreeList(&is_all_free_after_merge)) {
@@ -726,7 +757,7 @@ void* RosAlloc::AllocFromRun(Thread* self, size_t size, size_t* bytes_allocated,
             DCHECK(full_runs_[idx].find(thread_local_run) != full_runs_[idx].end());
           }
 
-          thread_local_run = RefillRun(idx);
+          thread_local_run = RefillRun(self, idx);
           if (UNLIKELY(thread_local_run == nullptr)) {
             need_alloc_run = true;
           } else {
@@ -907,6 +938,7 @@ std::string RosAlloc::Run::Dump() {
          << " size_bracket_idx=" << idx
          << " is_thread_local=" << static_cast<int>(is_thread_local_)
          << " to_be_bulk_freed=" << static_cast<int>(to_be_bulk_freed_)
+         << " needs_sweep=" << static_cast<int>(needs_sweep_)
          << " free_list=" << FreeListToStr(&free_list_)
          << " bulk_free_list=" << FreeListToStr(&bulk_free_list_)
          << " thread_local_list=" << FreeListToStr(&thread_local_free_list_)
@@ -1099,6 +1131,58 @@ ObjectBytePair RosAlloc::SweepRun(Thread* self, Run* run, size_t bracket_idx, ui
   return freed_pair;
 }
 
+/* MarkRunForLazySweep counts the garbages of a run the same way as SweepRun, but leaves them
+ * allocated and queues the run instead. The garbages are freed by SweepRunSlots when a thread
+ * acquires the run for allocation or by SweepPendingRuns.
+ */
+ObjectBytePair RosAlloc::MarkRunForLazySweep(Thread* self, Run* run, size_t bracket_idx,
+                                             uintptr_t* live, uintptr_t* mark,
+                                             uintptr_t heap_begin) {
+  size_t run_header_size = headerSizes[bracket_idx];
+  size_t run_size = numOfPages[bracket_idx];
+  uintptr_t ptr = reinterpret_cast<uintptr_t>(run);
+  size_t start = reinterpret_cast<size_t>((ptr + run_header_size - heap_begin) /
+      kObjectAlignment / kBitsPerIntPtrT);
+  size_t end = reinterpret_cast<size_t>((ptr + run_size * kPageSize - heap_begin - 1) /
+      kObjectAlignment / kBitsPerIntPtrT);
+  size_t num_garbages = 0;
+  for (size_t i = start; i <= end; i++) {
+    num_garbages += POPCOUNT(live[i] & ~mark[i]);
+  }
+  if (num_garbages != 0) {
+    MutexLock mu(self, *size_bracket_locks_[bracket_idx]);
+    DCHECK(!run->needs_sweep_);
+    run->needs_sweep_ = 1;
+    runs_to_sweep_[bracket_idx].insert(run);
+  }
+  return ObjectBytePair(num_garbages, num_garbages * bracketSizes[bracket_idx]);
+}
+
+void RosAlloc::SweepRunSlots(Run* run) {
+  DCHECK(run->needs_sweep_);
+  DCHECK(HasLazySweep());
+  const size_t idx = run->size_bracket_idx_;
+  uintptr_t ptr = reinterpret_cast<uintptr_t>(run);
+  size_t start = reinterpret_cast<size_t>((ptr + headerSizes[idx] - lazy_sweep_heap_begin_) /
+      kObjectAlignment / kBitsPerIntPtrT);
+  size_t end = reinterpret_cast<size_t>(
+      (ptr + numOfPages[idx] * kPageSize - lazy_sweep_heap_begin_ - 1) /
+      kObjectAlignment / kBitsPerIntPtrT);
+  for (size_t i = start; i <= end; i++) {
+    uintptr_t garbage = lazy_sweep_live_[i] & ~lazy_sweep_mark_[i];
+    if (UNLIKELY(garbage != 0)) {
+      uintptr_t ptr_base = i * kObjectAlignment * kBitsPerIntPtrT + lazy_sweep_heap_begin_;
+      do {
+        const size_t shift = CTZ(garbage);
+        garbage ^= (static_cast<uintptr_t>(1)) << shift;
+        run->AddToBulkFreeList(reinterpret_cast<void*>(ptr_base + shift * kObjectAlignment));
+      } while (garbage != 0);
+    }
+  }
+  run->needs_sweep_ = 0;
+  runs_to_sweep_[idx].erase(run);
+}
+
 /* SweepWalkPagemapRange is to walk the page map from beginning page index to end page index
  * and then sweep the garbages among them.
  */
@@ -1106,7 +1190,8 @@ void RosAlloc::SweepWalkPagemapRange(Thread* self, size_t begin_page_idx, size_t
                                      uintptr_t* live, uintptr_t* mark,
                                      accounting::ContinuousSpaceBitmap* live_bitmap,
                                      uintptr_t heap_begin, uintptr_t space_begin,
-                                     bool swap_bitmaps, ObjectBytePair* freed_pair_ptr) {
+                                     bool swap_bitmaps, bool lazy,
+                                     ObjectBytePair* freed_pair_ptr) {
   size_t page_idx = begin_page_idx;
   size_t freed_bytes = 0;
   size_t multiplier = 1;
@@ -1155,8 +1240,12 @@ void RosAlloc::SweepWalkPagemapRange(Thread* self, size_t begin_page_idx, size_t
           break;
         }
         ObjectBytePair run_freed_pair(0, 0);
-        run_freed_pair = SweepRun(self, run, bracket_idx, live, mark, live_bitmap, heap_begin,
-                                  swap_bitmaps);
+        if (lazy) {
+          run_freed_pair = MarkRunForLazySweep(self, run, bracket_idx, live, mark, heap_begin);
+        } else {
+          run_freed_pair = SweepRun(self, run, bracket_idx, live, mark, live_bitmap, heap_begin,
+                                    swap_bitmaps);
+        }
         freed_pair.objects += run_freed_pair.objects;
         freed_pair.bytes += run_freed_pair.bytes;
         multiplier = run_size;
@@ -1195,10 +1284,11 @@ class SweepWalkPagemapTask : public Task {
   SweepWalkPagemapTask(RosAlloc* rosalloc, size_t begin_page_idx, size_t end_page_idx,
                        uintptr_t* live, uintptr_t* mark, accounting::ContinuousSpaceBitmap* live_bitmap,
                        uintptr_t heap_begin, uintptr_t space_begin, bool swap_bitmaps,
-                       ObjectBytePair* freed_pair_ptr)
+                       bool lazy, ObjectBytePair* freed_pair_ptr, uint64_t* sweep_time_ptr)
       : rosalloc_(rosalloc), begin_page_idx_(begin_page_idx), end_page_idx_(end_page_idx),
         live_(live), mark_(mark), live_bitmap_(live_bitmap), heap_begin_(heap_begin),
-        ros_begin_(space_begin), swap_bitmaps_(swap_bitmaps), freed_pair_ptr_(freed_pair_ptr) {
+        ros_begin_(space_begin), swap_bitmaps_(swap_bitmaps), lazy_(lazy),
+        freed_pair_ptr_(freed_pair_ptr), sweep_time_ptr_(sweep_time_ptr) {
   }
 
   virtual void Finalize() {
@@ -1206,9 +1296,11 @@ class SweepWalkPagemapTask : public Task {
   }
 
   virtual void Run(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
+    const uint64_t start_time = NanoTime();
     rosalloc_->SweepWalkPagemapRange(self, begin_page_idx_, end_page_idx_, live_, mark_,
                                      live_bitmap_, heap_begin_, ros_begin_, swap_bitmaps_,
-                                     freed_pair_ptr_);
+                                     lazy_, freed_pair_ptr_);
+    *sweep_time_ptr_ = NanoTime() - start_time;
   }
 
  private:
@@ -1221,7 +1313,9 @@ class SweepWalkPagemapTask : public Task {
   uintptr_t heap_begin_;
   uintptr_t ros_begin_;
   bool swap_bitmaps_;
+  bool lazy_;
   ObjectBytePair* freed_pair_ptr_;
+  uint64_t* sweep_time_ptr_;
 };
 
 /* Applying the characteristics of ros space, below is an alternative approach to sweep the ros
@@ -1236,7 +1330,8 @@ class SweepWalkPagemapTask : public Task {
  *            For bracket size >= 256B, the stride can be the slot size.
  * 4) Otherwise, the stride is one page size.
  */
-ObjectBytePair RosAlloc::SweepWalkPagemap(bool swap_bitmaps) {
+ObjectBytePair RosAlloc::SweepWalkPagemap(bool swap_bitmaps, size_t thread_count,
+                                          std::vector<uint64_t>* worker_times, bool lazy) {
   ObjectBytePair freed_pair(0, 0);
   Heap* heap = Runtime::Current()->GetHeap();
   Thread* self = Thread::Current();
@@ -1254,16 +1349,23 @@ ObjectBytePair RosAlloc::SweepWalkPagemap(bool swap_bitmaps) {
   if (swap_bitmaps) {
     std::swap(live_bitmap, mark_bitmap);
   }
-  // Considering the existing mobile IA platforms have 4 CPU cores, default is two GC threads
-  // for parallel sweep.
-  size_t thread_count = heap->GetThreadCount(false);
-  if (kParallelRosSweep && thread_count > 1) {
+  if (lazy) {
+    // The runs only get queued below, remember where to find their dead slots. This is published
+    // to the allocating threads by the bracket lock taken when a run is queued.
+    DCHECK(!swap_bitmaps);
+    DCHECK(!HasLazySweep());
+    lazy_sweep_live_ = live;
+    lazy_sweep_mark_ = mark;
+    lazy_sweep_heap_begin_ = heap_begin;
+  }
+  if (kParallelRosSweep && thread_count > 1 && heap->GetThreadPool() != nullptr) {
     ThreadPool* thread_pool = heap->GetThreadPool();
     const size_t page_range = cur_page_map_size_snapshot_ - 0;
     const size_t page_delta = page_range / thread_count + 1;
     size_t ros_begin_page_idx = 0;
     size_t i = 0;
     std::vector<ObjectBytePair> freed_pair_vector(thread_count, freed_pair);
+    std::vector<uint64_t> sweep_time_vector(thread_count, 0);
     // Creating sweep tasks according to page amount.
     // TODO: Using work stealing parallel module to achieve the best load balance among
     // all the sweep tasks. This work is more desirable on enough multicore platforms.
@@ -1272,8 +1374,10 @@ ObjectBytePair RosAlloc::SweepWalkPagemap(bool swap_bitmaps) {
       size_t page_increment = std::min(page_delta, page_remaining);
       auto* task = new SweepWalkPagemapTask(this, ros_begin_page_idx,
                                             ros_begin_page_idx + page_increment, live, mark,
-                                            live_bitmap, heap_begin, ptr, swap_bitmaps,
-                                            &freed_pair_vector.at(i++));
+                                            live_bitmap, heap_begin, ptr, swap_bitmaps, lazy,
+                                            &freed_pair_vector.at(i),
+                                            &sweep_time_vector.at(i));
+      ++i;
       thread_pool->AddTask(self, task);
       ros_begin_page_idx += page_increment;
       ptr += page_increment * kPageSize;
@@ -1285,9 +1389,16 @@ ObjectBytePair RosAlloc::SweepWalkPagemap(bool swap_bitmaps) {
     for (i = 0; i < freed_pair_vector.size(); i++) {
       freed_pair.Add(freed_pair_vector.at(i));
     }
+    if (worker_times != nullptr) {
+      worker_times->swap(sweep_time_vector);
+    }
   } else {
+    const uint64_t start_time = NanoTime();
     SweepWalkPagemapRange(self, 0, cur_page_map_size_snapshot_, live, mark,
-                          live_bitmap, heap_begin, ptr, swap_bitmaps, &freed_pair);
+                          live_bitmap, heap_begin, ptr, swap_bitmaps, lazy, &freed_pair);
+    if (worker_times != nullptr) {
+      worker_times->assign(1, NanoTime() - start_time);
+    }
   }
   return freed_pair;
 }
@@ -1297,105 +1408,150 @@ void RosAlloc::UpdateRunMetadata(Thread* self, Run* run) {
   bool to_free_run = false;
   {
     MutexLock brackets_mu(self, *size_bracket_locks_[idx]);
-    if (run->IsThreadLocal()) {
-      DCHECK_LT(run->size_bracket_idx_, kNumThreadLocalSizeBrackets);
-      DCHECK(non_full_runs_[idx].find(run) == non_full_runs_[idx].end());
-      DCHECK(full_runs_[idx].find(run) == full_runs_[idx].end());
-      run->MergeBulkFreeListToThreadLocalFreeList();
-      if (kTraceRosAlloc) {
-        LOG(INFO) << "RosAlloc::UpdateRunMetadata() : Freed slot(s) in a thread local run 0x"
-                  << std::hex << reinterpret_cast<intptr_t>(run);
-      }
-      DCHECK(run->IsThreadLocal());
-      // A thread local run will be kept as a thread local even if
-      // it's become all free.
-    } else {
-      bool run_was_full = run->IsFull();
-      run->MergeBulkFreeListToFreeList();
-      if (kTraceRosAlloc) {
-        LOG(INFO) << "RosAlloc::UpdateRunMetadata() : Freed slot(s) in a run 0x" << std::hex
-                  << reinterpret_cast<intptr_t>(run);
-      }
-      // Check if the run should be moved to non_full_runs_ or
-      // free_page_runs_.
-      auto* non_full_runs = &non_full_runs_[idx];
-      auto* full_runs = kIsDebugBuild ? &full_runs_[idx] : nullptr;
-      if (run->IsAllFree()) {
-        // It has just become completely free. Free the pages of the run.
-        bool run_was_current = run == current_runs_[idx];
-        if (run_was_current) {
-          DCHECK(full_runs->find(run) == full_runs->end());
-          DCHECK(non_full_runs->find(run) == non_full_runs->end());
-          // If it was a current run, reuse it.
-        } else if (run_was_full) {
-          // If it was full, remove it from the full run set (debug only.)
-          if (kIsDebugBuild) {
-            std::unordered_set<Run*, hash_run, eq_run>::iterator pos = full_runs->find(run);
-            DCHECK(pos != full_runs->end());
-            full_runs->erase(pos);
-             if (kTraceRosAlloc) {
-              LOG(INFO) << "RosAlloc::UpdateRunMetadata() : Erased run 0x" << std::hex
-                        << reinterpret_cast<intptr_t>(run)
-                        << " from full_runs_";
-             }
-            DCHECK(full_runs->find(run) == full_runs->end());
+    to_free_run = UpdateRunMetadataLocked(run);
+  }
+  if (to_free_run) {
+    DCHECK(run != nullptr);
+    MutexLock lock_mu(self, lock_);
+    FreePages(self, run, true);
+  }
+}
+
+bool RosAlloc::UpdateRunMetadataLocked(Run* run) {
+  size_t idx = run->size_bracket_idx_;
+  bool to_free_run = false;
+  if (run->IsThreadLocal()) {
+    DCHECK_LT(run->size_bracket_idx_, kNumThreadLocalSizeBrackets);
+    DCHECK(non_full_runs_[idx].find(run) == non_full_runs_[idx].end());
+    DCHECK(full_runs_[idx].find(run) == full_runs_[idx].end());
+    run->MergeBulkFreeListToThreadLocalFreeList();
+    if (kTraceRosAlloc) {
+      LOG(INFO) << "RosAlloc::UpdateRunMetadata() : Freed slot(s) in a thread local run 0x"
+                << std::hex << reinterpret_cast<intptr_t>(run);
+    }
+    DCHECK(run->IsThreadLocal());
+    // A thread local run will be kept as a thread local even if
+    // it's become all free.
+  } else {
+    bool run_was_full = run->IsFull();
+    run->MergeBulkFreeListToFreeList();
+    if (kTraceRosAlloc) {
+      LOG(INFO) << "RosAlloc::UpdateRunMetadata() : Freed slot(s) in a run 0x" << std::hex
+                << reinterpret_cast<intptr_t>(run);
+    }
+    // Check if the run should be moved to non_full_runs_ or
+    // free_page_runs_.
+    auto* non_full_runs = &non_full_runs_[idx];
+    auto* full_runs = kIsDebugBuild ? &full_runs_[idx] : nullptr;
+    if (run->IsAllFree()) {
+      // It has just become completely free. Free the pages of the run.
+      bool run_was_current = run == current_runs_[idx];
+      if (run_was_current) {
+        DCHECK(full_runs->find(run) == full_runs->end());
+        DCHECK(non_full_runs->find(run) == non_full_runs->end());
+        // If it was a current run, reuse it.
+      } else if (run_was_full) {
+        // If it was full, remove it from the full run set (debug only.)
+        if (kIsDebugBuild) {
+          std::unordered_set<Run*, hash_run, eq_run>::iterator pos = full_runs->find(run);
+          DCHECK(pos != full_runs->end());
+          full_runs->erase(pos);
+           if (kTraceRosAlloc) {
+            LOG(INFO) << "RosAlloc::UpdateRunMetadata() : Erased run 0x" << std::hex
+                      << reinterpret_cast<intptr_t>(run)
+                      << " from full_runs_";
            }
-         } else {
-          // If it was in a non full run set, remove it from the set.
           DCHECK(full_runs->find(run) == full_runs->end());
-          DCHECK(non_full_runs->find(run) != non_full_runs->end());
-          non_full_runs->erase(run);
-          if (kTraceRosAlloc) {
+         }
+       } else {
+        // If it was in a non full run set, remove it from the set.
+        DCHECK(full_runs->find(run) == full_runs->end());
+        DCHECK(non_full_runs->find(run) != non_full_runs->end());
+        non_full_runs->erase(run);
+        if (kTraceRosAlloc) {
+          LOG(INFO) << "RosAlloc::UpdateRunMetadata() : Erased run 0x" << std::hex
+                    << reinterpret_cast<intptr_t>(run)
+                    << " from non_full_runs_";
+        }
+        DCHECK(non_full_runs->find(run) == non_full_runs->end());
+      }
+      if (!run_was_current) {
+        run->ZeroHeaderAndSlotHeaders();
+        to_free_run = true;
+      }
+    } else {
+      // It is not completely free. If it wasn't the current run or
+      // already in the non-full run set (i.e., it was full) insert
+      // it into the non-full run set.
+      if (run == current_runs_[idx]) {
+        DCHECK(non_full_runs->find(run) == non_full_runs->end());
+        DCHECK(full_runs->find(run) == full_runs->end());
+        // If it was a current run, keep it.
+      } else if (run_was_full) {
+        // If it was full, remove it from the full run set (debug
+        // only) and insert into the non-full run set.
+        DCHECK(full_runs->find(run) != full_runs->end());
+        DCHECK(non_full_runs->find(run) == non_full_runs->end());
+        if (kIsDebugBuild) {
+          full_runs->erase(run);
+           if (kTraceRosAlloc) {
             LOG(INFO) << "RosAlloc::UpdateRunMetadata() : Erased run 0x" << std::hex
                       << reinterpret_cast<intptr_t>(run)
-                      << " from non_full_runs_";
-          }
-          DCHECK(non_full_runs->find(run) == non_full_runs->end());
-        }
-        if (!run_was_current) {
-          run->ZeroHeaderAndSlotHeaders();
-          to_free_run = true;
+                      << " from full_runs_";
+           }
+         }
+        non_full_runs->insert(run);
+        if (kTraceRosAlloc) {
+          LOG(INFO) << "RosAlloc::UpdateRunMetadata() : Inserted run 0x" << std::hex
+                    << reinterpret_cast<intptr_t>(run)
+                    << " into non_full_runs_[" << std::dec << idx;
         }
       } else {
-        // It is not completely free. If it wasn't the current run or
-        // already in the non-full run set (i.e., it was full) insert
-        // it into the non-full run set.
-        if (run == current_runs_[idx]) {
-          DCHECK(non_full_runs->find(run) == non_full_runs->end());
-          DCHECK(full_runs->find(run) == full_runs->end());
-          // If it was a current run, keep it.
-        } else if (run_was_full) {
-          // If it was full, remove it from the full run set (debug
-          // only) and insert into the non-full run set.
-          DCHECK(full_runs->find(run) != full_runs->end());
-          DCHECK(non_full_runs->find(run) == non_full_runs->end());
-          if (kIsDebugBuild) {
-            full_runs->erase(run);
-             if (kTraceRosAlloc) {
-              LOG(INFO) << "RosAlloc::UpdateRunMetadata() : Erased run 0x" << std::hex
-                        << reinterpret_cast<intptr_t>(run)
-                        << " from full_runs_";
-             }
-           }
-          non_full_runs->insert(run);
-          if (kTraceRosAlloc) {
-            LOG(INFO) << "RosAlloc::UpdateRunMetadata() : Inserted run 0x" << std::hex
-                      << reinterpret_cast<intptr_t>(run)
-                      << " into non_full_runs_[" << std::dec << idx;
-          }
-        } else {
-          // If it was not full, so leave it in the non full run set.
-          DCHECK(full_runs->find(run) == full_runs->end());
-          DCHECK(non_full_runs->find(run) != non_full_runs->end());
+        // If it was not full, so leave it in the non full run set.
+        DCHECK(full_runs->find(run) == full_runs->end());
+        DCHECK(non_full_runs->find(run) != non_full_runs->end());
+      }
+    }
+  }
+  return to_free_run;
+}
+
+size_t RosAlloc::SweepPendingRuns(Thread* self) {
+  size_t num_runs = 0;
+  for (size_t idx = 0; idx < kNumOfSizeBrackets; ++idx) {
+    while (true) {
+      Run* run_to_free = nullptr;
+      {
+        MutexLock mu(self, *size_bracket_locks_[idx]);
+        auto* const runs_to_sweep = &runs_to_sweep_[idx];
+        if (runs_to_sweep->empty()) {
+          break;
+        }
+        Run* run = *runs_to_sweep->begin();
+        SweepRunSlots(run);
+        if (UpdateRunMetadataLocked(run)) {
+          run_to_free = run;
         }
+        ++num_runs;
+      }
+      if (run_to_free != nullptr) {
+        MutexLock mu(self, lock_);
+        FreePages(self, run_to_free, true);
       }
     }
   }
-  if (to_free_run) {
-    DCHECK(run != nullptr);
-    MutexLock lock_mu(self, lock_);
-    FreePages(self, run, true);
+  return num_runs;
+}
+
+bool RosAlloc::FinishLazySweep(Thread* self) {
+  if (!HasLazySweep()) {
+    return false;
   }
+  SweepPendingRuns(self);
+  lazy_sweep_live_ = nullptr;
+  lazy_sweep_mark_ = nullptr;
+  lazy_sweep_heap_begin_ = 0;
+  return true;
 }
 
 // If true, read the page map entries in BulkFree() without using the
@@ -1810,6 +1966,8 @@ void RosAlloc::InspectAll(void (*handler)(void* start, void* end, size_t used_by
   if (handler == nullptr) {
     return;
   }
+  // The garbages left by a lazy sweep must not be reported as allocated.
+  SweepPendingRuns(Thread::Current());
   MutexLock mu(Thread::Current(), lock_);
   size_t pm_end = page_map_size_;
   size_t i = 0;
@@ -2151,6 +2309,9 @@ void RosAlloc::Verify() {
   Thread* self = Thread::Current();
   CHECK(Locks::mutator_lock_->IsExclusiveHeld(self))
       << "The mutator locks isn't exclusively locked at " << __PRETTY_FUNCTION__;
+  // The garbages left by a lazy sweep may refer to freed classes, free them before checking the
+  // allocated slots.
+  SweepPendingRuns(self);
   MutexLock thread_list_mu(self, *Locks::thread_list_lock_);
   ReaderMutexLock wmu(self, bulk_free_lock_);
   std::vector<Run*> runs;
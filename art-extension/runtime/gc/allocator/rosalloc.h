@@ -324,6 +324,8 @@ class RosAlloc {
   // +-------------------+
   // | to_be_bulk_freed  |
   // +-------------------+
+  // | needs_sweep       |
+  // +-------------------+
   // | top_bitmap_idx    |
   // +-------------------+
   // |                   |
@@ -359,7 +361,8 @@ class RosAlloc {
     uint8_t size_bracket_idx_;          // The index of the size bracket of this run.
     uint8_t is_thread_local_;           // True if this run is used as a thread-local run.
     uint8_t to_be_bulk_freed_;          // Used within BulkFree() to flag a run that's involved with a bulk free.
-    uint32_t padding_ ATTRIBUTE_UNUSED;
+    uint8_t needs_sweep_;               // True if a lazy sweep left dead slots in this run.
+    uint8_t padding_[3] ATTRIBUTE_UNUSED;
     // Use a tailess free list for free_list_ so that the alloc fast path does not manage the tail
     SlotFreeList<false> free_list_;
     SlotFreeList<true> bulk_free_list_;
@@ -672,6 +675,16 @@ class RosAlloc {
   // debug only. full_runs_[i] is guarded by size_bracket_locks_[i].
   std::unordered_set<Run*, hash_run, eq_run, TrackingAllocator<Run*, kAllocatorTagRosAlloc>>
       full_runs_[kNumOfSizeBrackets];
+  // The run sets that hold the runs a lazy sweep found dead slots in
+  // and that were not swept yet. runs_to_sweep_[i] is guarded by
+  // size_bracket_locks_[i].
+  AllocationTrackingSet<Run*, kAllocatorTagRosAlloc> runs_to_sweep_[kNumOfSizeBrackets];
+  // The live and mark bitmap words the dead slots of the runs to sweep are computed from, set by
+  // a lazy SweepWalkPagemap() and reset by FinishLazySweep(). The bitmaps must not change until
+  // then. Read under the bracket lock of a run that needs sweeping.
+  uintptr_t* lazy_sweep_live_;
+  uintptr_t* lazy_sweep_mark_;
+  uintptr_t lazy_sweep_heap_begin_;
   // The set of free pages.
   AllocationTrackingSet<FreePageRun*, kAllocatorTagRosAlloc> free_page_runs_ GUARDED_BY(lock_);
   // The dedicated full run, it is always full and shared by all threads when revoking happens.
@@ -756,8 +769,20 @@ class RosAlloc {
   Run* AllocRun(Thread* self, size_t idx) LOCKS_EXCLUDED(lock_);
 
   // Used to acquire a new/reused run for a size bracket. Used when a
-  // thread-local or current run gets full.
-  Run* RefillRun(size_t idx);
+  // thread-local or current run gets full. If there is no non-full run,
+  // sweeps the runs a lazy sweep left in the bracket to get one.
+  Run* RefillRun(Thread* self, size_t idx);
+
+  // Moves the dead slots of a run that needs sweeping to its bulk free list and removes the
+  // run from runs_to_sweep_. Requires the bracket lock of the run.
+  void SweepRunSlots(Run* run);
+  // Counts the dead slots of a run found by a lazy sweep and queues the run to be swept on
+  // allocation or by SweepPendingRuns().
+  ObjectBytePair MarkRunForLazySweep(Thread* self, Run* run, size_t bracket_idx,
+                                     uintptr_t* live, uintptr_t* mark, uintptr_t heap_begin);
+  // The part of UpdateRunMetadata() done under the bracket lock. Returns true if the run became
+  // all free and its pages must be freed by the caller.
+  bool UpdateRunMetadataLocked(Run* run);
 
   // The internal of non-bulk Free().
   size_t FreeInternal(Thread* self, void* ptr) LOCKS_EXCLUDED(lock_);
@@ -818,13 +843,40 @@ class RosAlloc {
   // The table is guarded by lock_. No need lock_ for SweepWalkPagemap, because it's
   // OK to bypass fewer pages if this table is modified by new allocation during walking,
   // since there is no record in the live and mark bitmap for new allocated pages.
-  ObjectBytePair SweepWalkPagemap(bool swap_bitmaps) NO_THREAD_SAFETY_ANALYSIS;
+  // The page map is split across thread_count workers of the heap thread pool. If worker_times
+  // is not null, it receives the time each worker spent sweeping.
+  // If lazy is true, the dead slots of the runs are only counted and the runs are swept later,
+  // when an allocating thread acquires them or by SweepPendingRuns(). The caller must keep both
+  // bitmaps as they are until FinishLazySweep().
+  ObjectBytePair SweepWalkPagemap(bool swap_bitmaps, size_t thread_count,
+                                  std::vector<uint64_t>* worker_times, bool lazy = false)
+      NO_THREAD_SAFETY_ANALYSIS;
   void SweepWalkPagemapRange(Thread* self, size_t begin_page_idx, size_t end_page_idx,
                              uintptr_t* live, uintptr_t* mark,
                              accounting::ContinuousSpaceBitmap* live_bitmap,
                              uintptr_t heap_begin, uintptr_t space_begin, bool swap_bitmaps,
-                             ObjectBytePair* freed_pair_ptr)
+                             bool lazy, ObjectBytePair* freed_pair_ptr)
       NO_THREAD_SAFETY_ANALYSIS;
+  // Sweeps the runs a lazy sweep left. Safe to run concurrently with the mutators. Returns the
+  // number of runs swept.
+  size_t SweepPendingRuns(Thread* self) LOCKS_EXCLUDED(lock_);
+  // Sweeps the remaining runs of the lazy sweep and forgets its bitmaps. Returns false if there
+  // was no lazy sweep.
+  bool FinishLazySweep(Thread* self) LOCKS_EXCLUDED(lock_);
+  bool HasLazySweep() const {
+    return lazy_sweep_live_ != nullptr;
+  }
+  // Returns the page map index of the first page of the run or large object that contains the
+  // allocated slot ptr. BulkFree() may run on several threads at once as long as each run is
+  // freed by a single thread, which callers can ensure by keying the slots on this index.
+  size_t GetRunPageMapIndex(const void* ptr) const NO_THREAD_SAFETY_ANALYSIS {
+    size_t pm_idx = RoundDownToPageMapIndex(ptr);
+    while (page_map_[pm_idx] == kPageMapRunPart) {
+      DCHECK_GT(pm_idx, 0U);
+      --pm_idx;
+    }
+    return pm_idx;
+  }
   void SetPageMapSizeSnapshot();
   size_t BulkFree(Thread* self, void** ptrs, size_t num_ptrs)
       LOCKS_EXCLUDED(bulk_free_lock_);
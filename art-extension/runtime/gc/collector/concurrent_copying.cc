@@ -16,10 +16,14 @@
 
 #include "concurrent_copying.h"
 
+#include <sched.h>
+
 #include "art_field-inl.h"
+#include "gc/accounting/card_table-inl.h"
 #include "gc/accounting/heap_bitmap-inl.h"
 #include "gc/accounting/space_bitmap-inl.h"
 #include "gc/space/image_space.h"
+#include "gc/space/region_space-inl.h"
 #include "gc/space/space.h"
 #include "intern_table.h"
 #include "mirror/class-inl.h"
@@ -27,22 +31,32 @@
 #include "scoped_thread_state_change.h"
 #include "thread-inl.h"
 #include "thread_list.h"
+#include "thread_pool.h"
 #include "well_known_classes.h"
 
 namespace art {
 namespace gc {
 namespace collector {
 
+// Process the mark queue in parallel only if it holds at least this many objects.
+static constexpr size_t kMinimumParallelMarkStackSize = 128;
+// The capacity of the mark stack of a parallel GC thread. It spills into the mark queue.
+static constexpr size_t kGcThreadMarkStackSize = 16 * KB;
+// How many objects a parallel GC thread takes from the mark queue at once.
+static constexpr size_t kMarkQueueStealBatchSize = 32;
+
 ConcurrentCopying::ConcurrentCopying(Heap* heap, const std::string& name_prefix)
     : GarbageCollector(heap,
                        name_prefix + (name_prefix.empty() ? "" : " ") +
                        "concurrent copying + mark sweep"),
       region_space_(nullptr), gc_barrier_(new Barrier(0)), mark_queue_(2 * MB),
+      mark_queue_lock_("concurrent copying mark queue lock", kMarkSweepMarkStackLock),
+      num_gc_threads_(0), num_active_gc_threads_(0),
       is_marking_(false), is_active_(false), is_asserting_to_space_invariant_(false),
       heap_mark_bitmap_(nullptr), live_stack_freeze_size_(0),
       skipped_blocks_lock_("concurrent copying bytes blocks lock", kMarkSweepMarkStackLock),
       rb_table_(heap_->GetReadBarrierTable()),
-      force_evacuate_all_(false) {
+      force_evacuate_all_(false), young_gen_(false) {
   static_assert(space::RegionSpace::kRegionSize == accounting::ReadBarrierTable::kRegionSize,
                 "The region space size and the read barrier table region size must match");
   cc_heap_bitmap_.reset(new accounting::HeapBitmap(heap));
@@ -69,6 +83,11 @@ void ConcurrentCopying::RunPhases() {
   {
     ReaderMutexLock mu(self, *Locks::mutator_lock_);
     InitializePhase();
+    if (young_gen_) {
+      // Find the old objects that may refer to young objects before the pause, which then only
+      // handles the cards dirtied in the meantime.
+      FindOldObjectsOnCards(self);
+    }
   }
   FlipThreadRoots();
   {
@@ -140,12 +159,16 @@ void ConcurrentCopying::InitializePhase() {
       GetCurrentIteration()->GetGcCause() == kGcCauseForNativeAlloc ||
       GetCurrentIteration()->GetClearSoftReferences()) {
     force_evacuate_all_ = true;
+    young_gen_ = false;
   } else {
-    force_evacuate_all_ = false;
+    // In the generational mode, a full collection evacuates all the regions so that the old
+    // regions never hold a dead object whose references may dangle.
+    force_evacuate_all_ = kEnableGenerationalMode && !young_gen_;
   }
   BindBitmaps();
   if (kVerboseMode) {
     LOG(INFO) << "force_evacuate_all=" << force_evacuate_all_;
+    LOG(INFO) << "young_gen=" << young_gen_;
     LOG(INFO) << "Immune region: " << immune_region_.Begin() << "-" << immune_region_.End();
     LOG(INFO) << "GC end of InitializePhase";
   }
@@ -201,12 +224,25 @@ class FlipCallback : public Closure {
     Thread* self = Thread::Current();
     CHECK(thread == self);
     Locks::mutator_lock_->AssertExclusiveHeld(self);
-    cc->region_space_->SetFromSpace(cc->rb_table_, cc->force_evacuate_all_);
+    cc->region_space_->SetFromSpace(cc->rb_table_, cc->force_evacuate_all_, cc->young_gen_);
+    if (ConcurrentCopying::kEnableParallelMarking) {
+      // Enough GC-local regions for the most GC threads that may process the mark stack.
+      cc->region_space_->SetNumGcLocalRegions(cc->heap_->GetConcGCThreadCount() + 1);
+    }
     cc->SwapStacks(self);
     if (ConcurrentCopying::kEnableFromSpaceAccountingCheck) {
       cc->RecordLiveStackFreezeSize(self);
-      cc->from_space_num_objects_at_first_pause_ = cc->region_space_->GetObjectsAllocated();
-      cc->from_space_num_bytes_at_first_pause_ = cc->region_space_->GetBytesAllocated();
+      // The old regions that a young-generation collection keeps in the to-space are not
+      // accounted for.
+      cc->from_space_num_objects_at_first_pause_ =
+          cc->region_space_->GetObjectsAllocatedInFromSpace() +
+          cc->region_space_->GetObjectsAllocatedInUnevacFromSpace();
+      cc->from_space_num_bytes_at_first_pause_ =
+          cc->region_space_->GetBytesAllocatedInFromSpace() +
+          cc->region_space_->GetBytesAllocatedInUnevacFromSpace();
+    }
+    if (cc->young_gen_) {
+      cc->GrayOldObjectsOnCards(self);
     }
     cc->is_marking_ = true;
     if (UNLIKELY(Runtime::Current()->IsActiveTransaction())) {
@@ -291,6 +327,132 @@ class ConcurrentCopyingImmuneSpaceObjVisitor {
   ConcurrentCopying* collector_;
 };
 
+// Used to visit the old objects on the cards dirtied since the previous collection. Such an
+// object may refer to young objects, so it is grayed and pushed onto the mark stack.
+class ConcurrentCopyingOldObjVisitor {
+ public:
+  explicit ConcurrentCopyingOldObjVisitor(ConcurrentCopying* cc)
+      : collector_(cc) {}
+
+  void operator()(mirror::Object* obj) const SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    DCHECK(obj != nullptr);
+    DCHECK(!collector_->immune_region_.ContainsObject(obj));
+    if (collector_->region_space_->HasAddress(obj)) {
+      // The old regions are in the to-space and have no bitmap. An object found before the
+      // pause may be found again through a card dirtied since, the gray bit tells.
+      DCHECK(collector_->region_space_->IsInToSpace(obj));
+      if (kUseBakerReadBarrier &&
+          !obj->AtomicSetReadBarrierPointer(ReadBarrier::WhitePtr(), ReadBarrier::GrayPtr())) {
+        return;
+      }
+      collector_->PushOntoMarkStack<true>(obj);
+    } else {
+      // A non-moving space object. Set the mark bit so that the black ptr gets cleared.
+      accounting::ContinuousSpaceBitmap* mark_bitmap =
+          collector_->heap_mark_bitmap_->GetContinuousSpaceBitmap(obj);
+      DCHECK(mark_bitmap != nullptr) << obj;
+      // This may or may not succeed, which is ok.
+      if (kUseBakerReadBarrier) {
+        obj->AtomicSetReadBarrierPointer(ReadBarrier::WhitePtr(), ReadBarrier::GrayPtr());
+      }
+      if (!mark_bitmap->AtomicTestAndSet(obj)) {
+        // Newly marked.
+        collector_->PushOntoMarkStack<true>(obj);
+      }
+    }
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+};
+
+// Used to record the old objects on aged cards before the pause.
+class ConcurrentCopyingRecordOldObjVisitor {
+ public:
+  explicit ConcurrentCopyingRecordOldObjVisitor(std::vector<mirror::Object*>* objects)
+      : objects_(objects) {}
+
+  void operator()(mirror::Object* obj) const {
+    objects_->push_back(obj);
+  }
+
+ private:
+  std::vector<mirror::Object*>* const objects_;
+};
+
+// Age the cards of the collected spaces, so that a young-generation collection tells the cards
+// dirtied since the previous collection, which it scans, from the ones dirtied after it, which
+// the next collection scans. Runs concurrently with the mutators, the cards are updated
+// atomically.
+void ConcurrentCopying::AgeCards() {
+  TimingLogger::ScopedTiming split("AgeCards", GetTimings());
+  accounting::CardTable* card_table = heap_->GetCardTable();
+  for (const auto& space : heap_->GetContinuousSpaces()) {
+    if (immune_region_.ContainsSpace(space)) {
+      continue;
+    }
+    card_table->ModifyCardsAtomic(space->Begin(), space->End(), AgeCardVisitor(),
+                                  VoidFunctor());
+  }
+}
+
+// Record the old objects that may refer to young objects, found through the cards aged by
+// AgeCards(). This runs before the pause: nothing is moved yet, and the objects are only
+// grayed in the pause, so that the mutators read their references through the read barrier
+// as soon as they run again.
+void ConcurrentCopying::FindOldObjectsOnCards(Thread* self) {
+  TimingLogger::ScopedTiming split("FindOldObjectsOnCards", GetTimings());
+  DCHECK(young_gen_);
+  AgeCards();
+  accounting::CardTable* card_table = heap_->GetCardTable();
+  const uint8_t minimum_age = accounting::CardTable::kCardDirty - 1;
+  old_objects_on_cards_.clear();
+  ConcurrentCopyingRecordOldObjVisitor visitor(&old_objects_on_cards_);
+  region_space_->VisitOldObjectsOnCards(card_table, minimum_age, visitor);
+  WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
+  for (const auto& space : heap_->GetContinuousSpaces()) {
+    if (space == region_space_ || immune_region_.ContainsSpace(space)) {
+      continue;
+    }
+    card_table->Scan<false>(space->GetLiveBitmap(), space->Begin(), space->End(), visitor,
+                            minimum_age);
+  }
+}
+
+// Mark the old objects that may refer to young objects, so that the mutators only read such
+// references through the read barrier. The objects were mostly found before the pause, only
+// the cards dirtied since then are scanned here.
+void ConcurrentCopying::GrayOldObjectsOnCards(Thread* self) {
+  TimingLogger::ScopedTiming split("(Paused)GrayOldObjectsOnCards", GetTimings());
+  DCHECK(young_gen_);
+  accounting::CardTable* card_table = heap_->GetCardTable();
+  ConcurrentCopyingOldObjVisitor visitor(this);
+  region_space_->VisitOldObjectsOnCards(card_table, accounting::CardTable::kCardDirty, visitor);
+  WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
+  for (mirror::Object* obj : old_objects_on_cards_) {
+    visitor(obj);
+  }
+  old_objects_on_cards_.clear();
+  for (const auto& space : heap_->GetContinuousSpaces()) {
+    if (space == region_space_ || immune_region_.ContainsSpace(space)) {
+      continue;
+    }
+    card_table->Scan<false>(space->GetLiveBitmap(), space->Begin(), space->End(), visitor,
+                            accounting::CardTable::kCardDirty);
+  }
+  // The non-moving objects allocated since the previous collection are not in the live
+  // bitmaps yet.
+  const uint8_t minimum_age = accounting::CardTable::kCardDirty - 1;
+  accounting::ObjectStack* live_stack = heap_->GetLiveStack();
+  for (auto* it = live_stack->Begin(), *end = live_stack->End(); it < end; ++it) {
+    mirror::Object* obj = it->AsMirrorPtr();
+    if (obj != nullptr && heap_->non_moving_space_->HasAddress(obj) &&
+        card_table->GetCard(obj) >= minimum_age) {
+      visitor(obj);
+    }
+  }
+}
+
 class EmptyCheckpoint : public Closure {
  public:
   explicit EmptyCheckpoint(ConcurrentCopying* concurrent_copying)
@@ -460,6 +622,13 @@ void ConcurrentCopying::PushOntoMarkStack(mirror::Object* to_ref) {
   CHECK_EQ(is_mark_queue_push_disallowed_.LoadRelaxed(), 0)
       << " " << to_ref << " " << PrettyTypeOf(to_ref);
   if (kThreadSafe) {
+    if (kEnableParallelMarking) {
+      // A parallel GC thread pushes onto its own mark stack unless it overflows.
+      ConcurrentCopyingThreadState* state = Thread::Current()->GetConcurrentCopyingThreadState();
+      if (state != nullptr && state->mark_stack->OwnerPushBack(to_ref)) {
+        return;
+      }
+    }
     CHECK(mark_queue_.Enqueue(to_ref)) << "Mark queue overflow";
   } else {
     CHECK(mark_queue_.EnqueueThreadUnsafe(to_ref)) << "Mark queue overflow";
@@ -508,7 +677,7 @@ class ConcurrentCopyingVerifyNoFromSpaceRefsVisitor : public SingleRootVisitor {
       } else {
         CHECK(ref->GetReadBarrierPointer() == ReadBarrier::BlackPtr() ||
               (ref->GetReadBarrierPointer() == ReadBarrier::WhitePtr() &&
-               collector_->IsOnAllocStack(ref)))
+               (collector_->IsOnAllocStack(ref) || collector_->IsUncollected(ref))))
             << "Non-moving/unevac from space ref " << ref << " " << PrettyTypeOf(ref)
             << " has non-black rb_ptr " << ref->GetReadBarrierPointer()
             << " but isn't on the alloc stack (and has white rb_ptr)."
@@ -573,7 +742,7 @@ class ConcurrentCopyingVerifyNoFromSpaceRefsObjectVisitor {
       } else {
         CHECK(obj->GetReadBarrierPointer() == ReadBarrier::BlackPtr() ||
               (obj->GetReadBarrierPointer() == ReadBarrier::WhitePtr() &&
-               collector->IsOnAllocStack(obj)))
+               (collector->IsOnAllocStack(obj) || collector->IsUncollected(obj))))
             << "Non-moving space/unevac from space ref " << obj << " " << PrettyTypeOf(obj)
             << " has non-black rb_ptr " << obj->GetReadBarrierPointer()
             << " but isn't on the alloc stack (and has white rb_ptr). Is it in the non-moving space="
@@ -695,63 +864,184 @@ bool ConcurrentCopying::ProcessMarkStack() {
   if (kVerboseMode) {
     LOG(INFO) << "ProcessMarkStack. ";
   }
+  size_t thread_count = GetHeap()->GetThreadCount(false);
+  if (kEnableParallelMarking && thread_count > 1 &&
+      mark_queue_.Size() >= kMinimumParallelMarkStackSize) {
+    ProcessMarkStackParallel(thread_count);
+    return false;
+  }
   size_t count = 0;
   mirror::Object* to_ref;
   while ((to_ref = PopOffMarkStack()) != nullptr) {
     ++count;
-    DCHECK(!region_space_->IsInFromSpace(to_ref));
-    if (kUseBakerReadBarrier) {
-      DCHECK(to_ref->GetReadBarrierPointer() == ReadBarrier::GrayPtr())
-          << " " << to_ref << " " << to_ref->GetReadBarrierPointer()
-          << " is_marked=" << IsMarked(to_ref);
-    }
-    // Scan ref fields.
-    Scan(to_ref);
-    // Mark the gray ref as white or black.
-    if (kUseBakerReadBarrier) {
-      DCHECK(to_ref->GetReadBarrierPointer() == ReadBarrier::GrayPtr())
-          << " " << to_ref << " " << to_ref->GetReadBarrierPointer()
-          << " is_marked=" << IsMarked(to_ref);
-    }
-    if (to_ref->GetClass<kVerifyNone, kWithoutReadBarrier>()->IsTypeOfReferenceClass() &&
-        to_ref->AsReference()->GetReferent<kWithoutReadBarrier>() != nullptr &&
-        !IsInToSpace(to_ref->AsReference()->GetReferent<kWithoutReadBarrier>())) {
-      // Leave References gray so that GetReferent() will trigger RB.
-      CHECK(to_ref->AsReference()->IsEnqueued()) << "Left unenqueued ref gray " << to_ref;
-    } else {
+    ProcessMarkStackRef(to_ref);
+  }
+  // Return true if the stack was empty.
+  return count == 0;
+}
+
+inline void ConcurrentCopying::ProcessMarkStackRef(mirror::Object* to_ref) {
+  DCHECK(!region_space_->IsInFromSpace(to_ref));
+  if (kUseBakerReadBarrier) {
+    DCHECK(to_ref->GetReadBarrierPointer() == ReadBarrier::GrayPtr())
+        << " " << to_ref << " " << to_ref->GetReadBarrierPointer()
+        << " is_marked=" << IsMarked(to_ref);
+  }
+  // Scan ref fields.
+  Scan(to_ref);
+  // Mark the gray ref as white or black.
+  if (kUseBakerReadBarrier) {
+    DCHECK(to_ref->GetReadBarrierPointer() == ReadBarrier::GrayPtr())
+        << " " << to_ref << " " << to_ref->GetReadBarrierPointer()
+        << " is_marked=" << IsMarked(to_ref);
+  }
+  if (to_ref->GetClass<kVerifyNone, kWithoutReadBarrier>()->IsTypeOfReferenceClass() &&
+      to_ref->AsReference()->GetReferent<kWithoutReadBarrier>() != nullptr &&
+      !IsInToSpace(to_ref->AsReference()->GetReferent<kWithoutReadBarrier>())) {
+    // Leave References gray so that GetReferent() will trigger RB.
+    CHECK(to_ref->AsReference()->IsEnqueued()) << "Left unenqueued ref gray " << to_ref;
+  } else {
 #ifdef USE_BAKER_OR_BROOKS_READ_BARRIER
-      if (kUseBakerReadBarrier) {
-        if (region_space_->IsInToSpace(to_ref)) {
-          // If to-space, change from gray to white.
-          bool success = to_ref->AtomicSetReadBarrierPointer(ReadBarrier::GrayPtr(),
-                                                             ReadBarrier::WhitePtr());
-          CHECK(success) << "Must succeed as we won the race.";
-          CHECK(to_ref->GetReadBarrierPointer() == ReadBarrier::WhitePtr());
-        } else {
-          // If non-moving space/unevac from space, change from gray
-          // to black. We can't change gray to white because it's not
-          // safe to use CAS if two threads change values in opposite
-          // directions (A->B and B->A). So, we change it to black to
-          // indicate non-moving objects that have been marked
-          // through. Note we'd need to change from black to white
-          // later (concurrently).
-          bool success = to_ref->AtomicSetReadBarrierPointer(ReadBarrier::GrayPtr(),
-                                                             ReadBarrier::BlackPtr());
-          CHECK(success) << "Must succeed as we won the race.";
-          CHECK(to_ref->GetReadBarrierPointer() == ReadBarrier::BlackPtr());
-        }
+    if (kUseBakerReadBarrier) {
+      if (region_space_->IsInToSpace(to_ref)) {
+        // If to-space, change from gray to white.
+        bool success = to_ref->AtomicSetReadBarrierPointer(ReadBarrier::GrayPtr(),
+                                                           ReadBarrier::WhitePtr());
+        CHECK(success) << "Must succeed as we won the race.";
+        CHECK(to_ref->GetReadBarrierPointer() == ReadBarrier::WhitePtr());
+      } else {
+        // If non-moving space/unevac from space, change from gray
+        // to black. We can't change gray to white because it's not
+        // safe to use CAS if two threads change values in opposite
+        // directions (A->B and B->A). So, we change it to black to
+        // indicate non-moving objects that have been marked
+        // through. Note we'd need to change from black to white
+        // later (concurrently).
+        bool success = to_ref->AtomicSetReadBarrierPointer(ReadBarrier::GrayPtr(),
+                                                           ReadBarrier::BlackPtr());
+        CHECK(success) << "Must succeed as we won the race.";
+        CHECK(to_ref->GetReadBarrierPointer() == ReadBarrier::BlackPtr());
       }
+    }
 #else
-      DCHECK(!kUseBakerReadBarrier);
+    DCHECK(!kUseBakerReadBarrier);
 #endif
+  }
+  if (ReadBarrier::kEnableToSpaceInvariantChecks || kIsDebugBuild) {
+    ConcurrentCopyingAssertToSpaceInvariantObjectVisitor visitor(this);
+    visitor(to_ref);
+  }
+}
+
+// Runs the mark stack processing of one parallel GC thread.
+class ConcurrentCopyingMarkStackTask : public Task {
+ public:
+  ConcurrentCopyingMarkStackTask(ConcurrentCopying* collector,
+                                 ConcurrentCopyingThreadState* state)
+      : collector_(collector), state_(state) {}
+
+  virtual void Run(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
+    collector_->ProcessMarkStackOnGcThread(self, state_);
+  }
+
+  virtual void Finalize() {
+    delete this;
+  }
+
+ private:
+  ConcurrentCopying* const collector_;
+  ConcurrentCopyingThreadState* const state_;
+};
+
+void ConcurrentCopying::ProcessMarkStackParallel(size_t thread_count) {
+  Thread* self = Thread::Current();
+  ThreadPool* thread_pool = GetHeap()->GetThreadPool();
+  DCHECK_LE(thread_count, GetHeap()->GetConcGCThreadCount() + 1);
+  while (gc_thread_states_.size() < thread_count) {
+    ConcurrentCopyingThreadState* state = new ConcurrentCopyingThreadState;
+    state->index = gc_thread_states_.size();
+    state->mark_stack.reset(accounting::ObjectStack::Create(
+        "concurrent copying gc thread mark stack", kGcThreadMarkStackSize,
+        kGcThreadMarkStackSize));
+    gc_thread_states_.emplace_back(state);
+  }
+  num_gc_threads_ = thread_count;
+  num_active_gc_threads_.StoreSequentiallyConsistent(thread_count);
+  // The GC threads start by stealing from the mark queue.
+  for (size_t i = 0; i < thread_count; ++i) {
+    thread_pool->AddTask(self,
+                         new ConcurrentCopyingMarkStackTask(this, gc_thread_states_[i].get()));
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, true, true);
+  thread_pool->StopWorkers(self);
+  for (size_t i = 0; i < thread_count; ++i) {
+    accounting::ObjectStack* mark_stack = gc_thread_states_[i]->mark_stack.get();
+    CHECK(mark_stack->IsEmpty());
+    // Nobody steals from it any more.
+    mark_stack->Reset();
+  }
+}
+
+void ConcurrentCopying::ProcessMarkStackOnGcThread(Thread* self,
+                                                   ConcurrentCopyingThreadState* state) {
+  DCHECK(self->GetConcurrentCopyingThreadState() == nullptr);
+  self->SetConcurrentCopyingThreadState(state);
+  accounting::ObjectStack* mark_stack = state->mark_stack.get();
+  bool active = true;
+  while (true) {
+    mirror::Object* to_ref = mark_stack->OwnerPopBack();
+    if (to_ref == nullptr) {
+      to_ref = StealMarkStackWork(self, state);
     }
-    if (ReadBarrier::kEnableToSpaceInvariantChecks || kIsDebugBuild) {
-      ConcurrentCopyingAssertToSpaceInvariantObjectVisitor visitor(this);
-      visitor(to_ref);
+    if (to_ref != nullptr) {
+      if (!active) {
+        num_active_gc_threads_.FetchAndAddSequentiallyConsistent(1);
+        active = true;
+      }
+      ProcessMarkStackRef(to_ref);
+      continue;
+    }
+    // Our mark stack stays empty while we are inactive since only we push onto it. So all of
+    // the mark stacks are empty once no GC thread is active.
+    if (active) {
+      num_active_gc_threads_.FetchAndSubSequentiallyConsistent(1);
+      active = false;
     }
+    if (num_active_gc_threads_.LoadSequentiallyConsistent() == 0) {
+      break;
+    }
+    sched_yield();
   }
-  // Return true if the stack was empty.
-  return count == 0;
+  self->SetConcurrentCopyingThreadState(nullptr);
+}
+
+mirror::Object* ConcurrentCopying::StealMarkStackWork(Thread* self,
+                                                      ConcurrentCopyingThreadState* state) {
+  for (size_t i = 1; i < num_gc_threads_; ++i) {
+    ConcurrentCopyingThreadState* victim =
+        gc_thread_states_[(state->index + i) % num_gc_threads_].get();
+    mirror::Object* to_ref = victim->mark_stack->StealFront();
+    if (to_ref != nullptr) {
+      return to_ref;
+    }
+  }
+  // Take a batch of the objects that the mutators and the single-threaded phases pushed onto
+  // the mark queue.
+  MutexLock mu(self, mark_queue_lock_);
+  mirror::Object* to_ref = mark_queue_.Dequeue();
+  if (to_ref != nullptr) {
+    for (size_t i = 1; i < kMarkQueueStealBatchSize; ++i) {
+      mirror::Object* obj = mark_queue_.Dequeue();
+      if (obj == nullptr) {
+        break;
+      }
+      // Our mark stack is empty, so this does not overflow.
+      CHECK(state->mark_stack->OwnerPushBack(obj));
+    }
+  }
+  return to_ref;
 }
 
 void ConcurrentCopying::CheckEmptyMarkQueue() {
@@ -788,6 +1078,10 @@ void ConcurrentCopying::Sweep(bool swap_bitmaps) {
     live_stack->Reset();
   }
   CHECK(mark_queue_.IsEmpty());
+  if (young_gen_) {
+    // The non-moving spaces and the large objects are left to the full collections.
+    return;
+  }
   TimingLogger::ScopedTiming split("Sweep", GetTimings());
   for (const auto& space : GetHeap()->GetContinuousSpaces()) {
     if (space->IsContinuousMemMapAllocSpace()) {
@@ -938,7 +1232,9 @@ void ConcurrentCopying::ReclaimPhase() {
       ClearBlackPtrs();
     }
     Sweep(false);
-    SwapBitmaps();
+    if (!young_gen_) {
+      SwapBitmaps();
+    }
     heap_->UnBindBitmaps();
 
     // Remove bitmaps for the immune spaces.
@@ -1073,6 +1369,8 @@ void ConcurrentCopying::AssertToSpaceInvariant(mirror::Object* obj, MemberOffset
           CHECK(cc_bitmap->Test(ref))
               << "Unmarked immune space ref. obj=" << obj << " ref=" << ref;
         }
+      } else if (IsUncollected(ref)) {
+        // OK.
       } else {
         accounting::ContinuousSpaceBitmap* mark_bitmap =
             heap_mark_bitmap_->GetContinuousSpaceBitmap(ref);
@@ -1292,8 +1590,17 @@ mirror::Object* ConcurrentCopying::Copy(mirror::Object* from_ref) {
   size_t non_moving_space_bytes_allocated = 0U;
   size_t bytes_allocated = 0U;
   size_t dummy;
-  mirror::Object* to_ref = region_space_->AllocNonvirtual<true>(
-      region_space_alloc_size, &region_space_bytes_allocated, nullptr, &dummy);
+  mirror::Object* to_ref;
+  ConcurrentCopyingThreadState* gc_thread_state =
+      kEnableParallelMarking ? Thread::Current()->GetConcurrentCopyingThreadState() : nullptr;
+  if (gc_thread_state != nullptr) {
+    // A parallel GC thread copies into its own GC-local region.
+    to_ref = region_space_->AllocEvacGcLocal(gc_thread_state->index, region_space_alloc_size,
+                                             &region_space_bytes_allocated, nullptr, &dummy);
+  } else {
+    to_ref = region_space_->AllocNonvirtual<true>(
+        region_space_alloc_size, &region_space_bytes_allocated, nullptr, &dummy);
+  }
   bytes_allocated = region_space_bytes_allocated;
   if (to_ref != nullptr) {
     DCHECK_EQ(region_space_alloc_size, region_space_bytes_allocated);
@@ -1398,6 +1705,10 @@ mirror::Object* ConcurrentCopying::Copy(mirror::Object* from_ref) {
       } else {
         DCHECK(heap_->non_moving_space_->HasAddress(to_ref));
         DCHECK_EQ(bytes_allocated, non_moving_space_bytes_allocated);
+        if (young_gen_) {
+          // A young-generation collection does not swap the bitmaps. Make it live directly.
+          heap_->non_moving_space_->GetLiveBitmap()->AtomicTestAndSet(to_ref);
+        }
       }
       if (kUseBakerReadBarrier) {
         DCHECK(to_ref->GetReadBarrierPointer() == ReadBarrier::GrayPtr());
@@ -1450,6 +1761,9 @@ mirror::Object* ConcurrentCopying::IsMarked(mirror::Object* from_ref) {
         // Newly marked.
         to_ref = nullptr;
       }
+    } else if (IsUncollected(from_ref)) {
+      // Not collected, considered marked.
+      to_ref = from_ref;
     } else {
       // Non-immune non-moving space. Use the mark bitmap.
       accounting::ContinuousSpaceBitmap* mark_bitmap =
@@ -1479,6 +1793,10 @@ mirror::Object* ConcurrentCopying::IsMarked(mirror::Object* from_ref) {
   return to_ref;
 }
 
+bool ConcurrentCopying::IsUncollected(mirror::Object* ref) {
+  return young_gen_ && !region_space_->HasAddress(ref) && !immune_region_.ContainsObject(ref);
+}
+
 bool ConcurrentCopying::IsOnAllocStack(mirror::Object* ref) {
   QuasiAtomic::ThreadFenceAcquire();
   accounting::ObjectStack* alloc_stack = GetAllocationStack();
@@ -1566,6 +1884,9 @@ mirror::Object* ConcurrentCopying::Mark(mirror::Object* from_ref) {
         }
         PushOntoMarkStack<true>(to_ref);
       }
+    } else if (IsUncollected(from_ref)) {
+      // Not collected. The objects that may refer to young objects were marked at the pause.
+      to_ref = from_ref;
     } else {
       // Use the mark bitmap.
       accounting::ContinuousSpaceBitmap* mark_bitmap =
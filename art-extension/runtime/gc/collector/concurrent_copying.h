@@ -118,6 +118,13 @@ class MarkQueue {
     return h == t;
   }
 
+  // Approximate if there are concurrent enqueues.
+  size_t Size() {
+    size_t h = head_.LoadSequentiallyConsistent();
+    size_t t = tail_.LoadSequentiallyConsistent();
+    return t - h;
+  }
+
   void Clear() {
     head_.StoreRelaxed(0);
     tail_.StoreRelaxed(0);
@@ -132,6 +139,15 @@ class MarkQueue {
   std::unique_ptr<Atomic<mirror::Object*>[]> buf_;
 };
 
+// The state of a parallel GC thread of ConcurrentCopying, set on its Thread while it processes
+// the mark stack.
+struct ConcurrentCopyingThreadState {
+  // The index of the thread, also the index of its GC-local region in the region space.
+  size_t index;
+  // The work-stealing mark stack that the thread pushes the objects it grays onto.
+  std::unique_ptr<accounting::ObjectStack> mark_stack;
+};
+
 class ConcurrentCopying : public GarbageCollector {
  public:
   // TODO: disable thse flags for production use.
@@ -141,6 +157,13 @@ class ConcurrentCopying : public GarbageCollector {
   static constexpr bool kEnableFromSpaceAccountingCheck = true;
   // Enable verbose mode.
   static constexpr bool kVerboseMode = true;
+  // Enable the generational mode. A young-generation (sticky) collection only evacuates the
+  // regions allocated since the previous collection and finds the references from the old
+  // objects to the young ones through the card table.
+  static constexpr bool kEnableGenerationalMode = true;
+  // Process the mark stack on the ConcGCThreads GC threads of the heap thread pool. Each thread
+  // copies into its own GC-local region and steals from the mark stacks of the others.
+  static constexpr bool kEnableParallelMarking = true;
 
   ConcurrentCopying(Heap* heap, const std::string& name_prefix = "");
   ~ConcurrentCopying();
@@ -154,7 +177,15 @@ class ConcurrentCopying : public GarbageCollector {
   void BindBitmaps() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_)
       LOCKS_EXCLUDED(Locks::heap_bitmap_lock_);
   virtual GcType GetGcType() const OVERRIDE {
-    return kGcTypePartial;
+    return young_gen_ ? kGcTypeSticky : kGcTypePartial;
+  }
+  // Select whether the next collection only collects the young generation. Has no effect
+  // unless the generational mode is enabled.
+  void SetYoungGen(bool young_gen) {
+    young_gen_ = kEnableGenerationalMode && young_gen;
+  }
+  bool IsYoungGen() const {
+    return young_gen_;
   }
   virtual CollectorType GetCollectorType() const OVERRIDE {
     return kCollectorTypeCC;
@@ -201,6 +232,12 @@ class ConcurrentCopying : public GarbageCollector {
   accounting::ObjectStack* GetAllocationStack();
   accounting::ObjectStack* GetLiveStack();
   bool ProcessMarkStack() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  void ProcessMarkStackRef(mirror::Object* to_ref) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  void ProcessMarkStackParallel(size_t thread_count) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  void ProcessMarkStackOnGcThread(Thread* self, ConcurrentCopyingThreadState* state)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  mirror::Object* StealMarkStackWork(Thread* self, ConcurrentCopyingThreadState* state)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) LOCKS_EXCLUDED(mark_queue_lock_);
   void DelayReferenceReferent(mirror::Class* klass, mirror::Reference* reference)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
   void ProcessReferences(Thread* self, bool concurrent)
@@ -236,10 +273,23 @@ class ConcurrentCopying : public GarbageCollector {
   void SwapStacks(Thread* self) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
   void RecordLiveStackFreezeSize(Thread* self);
   void ComputeUnevacFromSpaceLiveRatio();
+  void AgeCards() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+  void FindOldObjectsOnCards(Thread* self) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_)
+      LOCKS_EXCLUDED(Locks::heap_bitmap_lock_);
+  void GrayOldObjectsOnCards(Thread* self) EXCLUSIVE_LOCKS_REQUIRED(Locks::mutator_lock_)
+      LOCKS_EXCLUDED(Locks::heap_bitmap_lock_);
+  // True if ref is in a space that the current collection leaves alone, i.e. a non-moving
+  // space during a young-generation collection.
+  bool IsUncollected(mirror::Object* ref) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
   space::RegionSpace* region_space_;      // The underlying region space.
   std::unique_ptr<Barrier> gc_barrier_;
   MarkQueue mark_queue_;
+  // Serializes the parallel GC threads dequeuing from the single-consumer mark_queue_.
+  Mutex mark_queue_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
+  std::vector<std::unique_ptr<ConcurrentCopyingThreadState>> gc_thread_states_;
+  size_t num_gc_threads_;                 // The number of GC threads processing the mark stack.
+  Atomic<size_t> num_active_gc_threads_;  // The number of them that have not run out of work.
   bool is_marking_;                       // True while marking is ongoing.
   bool is_active_;                        // True while the collection is ongoing.
   bool is_asserting_to_space_invariant_;  // True while asserting the to-space invariant.
@@ -268,6 +318,9 @@ class ConcurrentCopying : public GarbageCollector {
 
   accounting::ReadBarrierTable* rb_table_;
   bool force_evacuate_all_;  // True if all regions are evacuated.
+  bool young_gen_;           // True if only the young generation is collected.
+  // The old objects found on aged cards before the pause of a young-generation collection.
+  std::vector<mirror::Object*> old_objects_on_cards_;
 
   friend class ConcurrentCopyingRefFieldsVisitor;
   friend class ConcurrentCopyingImmuneSpaceObjVisitor;
@@ -278,6 +331,8 @@ class ConcurrentCopying : public GarbageCollector {
   friend class ThreadFlipVisitor;
   friend class FlipCallback;
   friend class ConcurrentCopyingComputeUnevacFromSpaceLiveRatioVisitor;
+  friend class ConcurrentCopyingOldObjVisitor;
+  friend class ConcurrentCopyingMarkStackTask;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(ConcurrentCopying);
 };
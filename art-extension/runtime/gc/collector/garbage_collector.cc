@@ -48,6 +48,7 @@ void Iteration::Reset(GcCause gc_cause, bool clear_soft_references) {
   pause_times_.clear();
   mark_time_ = 0;
   sweep_time_ = 0;
+  sweep_worker_times_.clear();
   duration_ns_ = 0;
   clear_soft_references_ = clear_soft_references;
   gc_cause_ = gc_cause;
@@ -82,6 +83,16 @@ void GarbageCollector::RegisterSweep(uint64_t nano_length) {
   GetCurrentIteration()->sweep_time_ = nano_length;
 }
 
+void GarbageCollector::RegisterSweepWorkerTimes(const std::vector<uint64_t>& nano_lengths) {
+  std::vector<uint64_t>* worker_times = &GetCurrentIteration()->sweep_worker_times_;
+  if (worker_times->size() < nano_lengths.size()) {
+    worker_times->resize(nano_lengths.size(), 0);
+  }
+  for (size_t i = 0; i < nano_lengths.size(); ++i) {
+    (*worker_times)[i] += nano_lengths[i];
+  }
+}
+
 void GarbageCollector::ResetCumulativeStatistics() {
   cumulative_timings_.Reset();
   total_time_ns_ = 0;
@@ -97,6 +108,11 @@ void GarbageCollector::Run(GcCause gc_cause, bool clear_soft_references) {
   uint64_t start_time = NanoTime();
   Iteration* current_iteration = GetCurrentIteration();
   current_iteration->Reset(gc_cause, clear_soft_references);
+  {
+    // Sweep what the previous GC left to the lazy sweep before its bitmaps get reused.
+    TimingLogger::ScopedTiming t("FinishLazySweep", GetTimings());
+    heap_->FinishLazySweep(self);
+  }
   RunPhases();  // Run all the GC phases.
   // Add the current timings to the cumulative timings.
   cumulative_timings_.AddLogger(*GetTimings());
@@ -127,7 +143,15 @@ void GarbageCollector::Run(GcCause gc_cause, bool clear_soft_references) {
     for (uint64_t pause_time : current_iteration->GetPauseTimes()) {
       pause_max = std::max(pause_max, pause_time);
     }
-    gcProfiler->SetGCTimes(pause_max, current_iteration->GetMarkTime(), current_iteration->GetSweepTime());
+    // Report the sweep time of the busiest worker if the sweep was split across workers.
+    uint64_t sweep_max = 0;
+    for (uint64_t sweep_time : current_iteration->GetSweepWorkerTimes()) {
+      sweep_max = std::max(sweep_max, sweep_time);
+    }
+    if (sweep_max == 0) {
+      sweep_max = current_iteration->GetSweepTime();
+    }
+    gcProfiler->SetGCTimes(pause_max, current_iteration->GetMarkTime(), sweep_max);
   }
 }
 
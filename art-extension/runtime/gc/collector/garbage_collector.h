@@ -55,6 +55,11 @@ class Iteration {
   uint64_t GetSweepTime() const {
     return sweep_time_;
   }
+  // Returns how long each sweeping worker spent sweeping, worker 0 being the GC thread. Empty if
+  // the collector did not record any.
+  const std::vector<uint64_t>& GetSweepWorkerTimes() const {
+    return sweep_worker_times_;
+  }
   TimingLogger* GetTimings() {
     return &timings_;
   }
@@ -109,6 +114,7 @@ class Iteration {
   // Mark/sweep times for gc profiling.
   uint64_t mark_time_;
   uint64_t sweep_time_;
+  std::vector<uint64_t> sweep_worker_times_;
 
   friend class GarbageCollector;
   DISALLOW_COPY_AND_ASSIGN(Iteration);
@@ -142,6 +148,8 @@ class GarbageCollector : public RootVisitor {
   // Register times for gc profiling.
   void RegisterMark(uint64_t nano_length);
   void RegisterSweep(uint64_t nano_length);
+  // Add the times spent by each sweeping worker in a parallel sweep stage.
+  void RegisterSweepWorkerTimes(const std::vector<uint64_t>& nano_lengths);
   const CumulativeLogger& GetCumulativeTimings() const {
     return cumulative_timings_;
   }
@@ -61,6 +61,9 @@ static constexpr bool kUseRecursiveMark = false;
 static constexpr bool kUseMarkStackPrefetch = true;
 static constexpr size_t kSweepArrayChunkFreeSize = 1024;
 static constexpr bool kPreCleanCards = true;
+// If true, the runs of the RosAlloc spaces are swept lazily: the sweep only counts their garbage
+// and the allocating threads or a heap task free it later.
+static constexpr bool kLazyRosAllocSweep = true;
 
 // Parallelism options.
 static constexpr bool kParallelCardScan = true;
@@ -71,6 +74,9 @@ static constexpr bool kParallelRecursiveMark = true;
 // ProcessMarkStack with very small mark stacks.
 static constexpr size_t kMinimumParallelMarkStackSize = 128;
 static constexpr bool kParallelProcessMarkStack = true;
+// Don't attempt to sweep the allocation stack in parallel unless it has at least n elements.
+static constexpr size_t kMinimumParallelSweepArraySize = 4 * KB;
+static constexpr bool kParallelSweepArray = true;
 
 // Profiling and information flags.
 static constexpr bool kProfileLargeObjects = false;
@@ -1141,6 +1147,149 @@ void MarkSweep::MarkRootsCheckpoint(Thread* self,
   Locks::heap_bitmap_lock_->ExclusiveLock(self);
 }
 
+// Shared by the tasks of a parallel SweepArray. The allocation stack is split into one slice per
+// worker. The scanning workers sort the dead objects into free lists keyed by the worker which
+// frees them, so that the slots of a RosAlloc run are always freed by the same worker.
+struct SweepArrayState {
+  SweepArrayState(const std::vector<space::ContinuousSpace*>& sweep_spaces,
+                  StackReference<Object>* objects_in, size_t count, bool swap_bitmaps,
+                  size_t thread_count_in)
+      : spaces(sweep_spaces), objects(objects_in), thread_count(thread_count_in),
+        slice_size(count / thread_count_in + 1), slice_ends(thread_count_in),
+        free_lists(thread_count_in * sweep_spaces.size() * thread_count_in),
+        freed(thread_count_in), sweep_times(thread_count_in, 0) {
+    for (space::ContinuousSpace* space : spaces) {
+      mark_bitmaps.push_back(swap_bitmaps ? space->GetLiveBitmap() : space->GetMarkBitmap());
+      rosallocs.push_back(space->IsRosAllocSpace() ? space->AsRosAllocSpace()->GetRosAlloc()
+                                                   : nullptr);
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+      slice_ends[i] = std::min((i + 1) * slice_size, count);
+    }
+  }
+
+  std::vector<Object*>* GetFreeList(size_t scanning_worker, size_t space_index,
+                                    size_t freeing_worker) {
+    return &free_lists[(scanning_worker * spaces.size() + space_index) * thread_count +
+                       freeing_worker];
+  }
+
+  const std::vector<space::ContinuousSpace*>& spaces;
+  std::vector<accounting::ContinuousSpaceBitmap*> mark_bitmaps;
+  std::vector<allocator::RosAlloc*> rosallocs;
+  StackReference<Object>* const objects;
+  const size_t thread_count;
+  const size_t slice_size;
+  // End of each slice, which becomes the end of the objects left in it once it is scanned.
+  std::vector<size_t> slice_ends;
+  std::vector<std::vector<Object*>> free_lists;
+  std::vector<ObjectBytePair> freed;
+  std::vector<uint64_t> sweep_times;
+};
+
+class SweepArrayTask : public Task {
+ public:
+  SweepArrayTask(SweepArrayState* state, size_t worker, bool free_phase)
+      : state_(state), worker_(worker), free_phase_(free_phase) {
+  }
+
+  virtual void Finalize() {
+    delete this;
+  }
+
+  virtual void Run(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
+    const uint64_t start_time = NanoTime();
+    if (free_phase_) {
+      FreeObjects(self);
+    } else {
+      ScanSlice();
+    }
+    state_->sweep_times[worker_] += NanoTime() - start_time;
+  }
+
+ private:
+  // Move the dead objects of the slice to the free lists and compact the objects which are not
+  // in the swept spaces at the beginning of the slice.
+  void ScanSlice() NO_THREAD_SAFETY_ANALYSIS {
+    const size_t num_spaces = state_->spaces.size();
+    StackReference<Object>* const begin = state_->objects + worker_ * state_->slice_size;
+    StackReference<Object>* const end = state_->objects + state_->slice_ends[worker_];
+    StackReference<Object>* out = begin;
+    for (StackReference<Object>* it = begin; it < end; ++it) {
+      Object* const obj = it->AsMirrorPtr();
+      if (kUseThreadLocalAllocationStack && obj == nullptr) {
+        continue;
+      }
+      size_t space_index = 0;
+      while (space_index < num_spaces && !state_->spaces[space_index]->HasAddress(obj)) {
+        ++space_index;
+      }
+      if (space_index == num_spaces) {
+        (out++)->Assign(obj);
+      } else if (!state_->mark_bitmaps[space_index]->Test(obj)) {
+        allocator::RosAlloc* rosalloc = state_->rosallocs[space_index];
+        const size_t freeing_worker = rosalloc != nullptr ?
+            rosalloc->GetRunPageMapIndex(obj) % state_->thread_count : worker_;
+        state_->GetFreeList(worker_, space_index, freeing_worker)->push_back(obj);
+      }
+    }
+    state_->slice_ends[worker_] = out - state_->objects;
+  }
+
+  void FreeObjects(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
+    ObjectBytePair* freed = &state_->freed[worker_];
+    for (size_t space_index = 0; space_index < state_->spaces.size(); ++space_index) {
+      space::AllocSpace* alloc_space = state_->spaces[space_index]->AsAllocSpace();
+      for (size_t scanning_worker = 0; scanning_worker < state_->thread_count; ++scanning_worker) {
+        std::vector<Object*>* free_list =
+            state_->GetFreeList(scanning_worker, space_index, worker_);
+        if (!free_list->empty()) {
+          freed->objects += free_list->size();
+          freed->bytes += alloc_space->FreeList(self, free_list->size(), free_list->data());
+        }
+      }
+    }
+  }
+
+  SweepArrayState* const state_;
+  const size_t worker_;
+  const bool free_phase_;
+};
+
+size_t MarkSweep::SweepArrayParallel(const std::vector<space::ContinuousSpace*>& sweep_spaces,
+                                     StackReference<Object>* objects, size_t count,
+                                     bool swap_bitmaps, size_t thread_count,
+                                     ObjectBytePair* freed) {
+  TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
+  Thread* self = Thread::Current();
+  ThreadPool* thread_pool = GetHeap()->GetThreadPool();
+  SweepArrayState state(sweep_spaces, objects, count, swap_bitmaps, thread_count);
+  // Scan the slices first, then free the dead objects once all of them are sorted by run.
+  for (bool free_phase : { false, true }) {
+    for (size_t i = 0; i < thread_count; ++i) {
+      thread_pool->AddTask(self, new SweepArrayTask(&state, i, free_phase));
+    }
+    thread_pool->SetMaxActiveWorkers(thread_count - 1);
+    thread_pool->StartWorkers(self);
+    thread_pool->Wait(self, true, true);
+    thread_pool->StopWorkers(self);
+  }
+  for (const ObjectBytePair& worker_freed : state.freed) {
+    freed->Add(worker_freed);
+  }
+  RegisterSweepWorkerTimes(state.sweep_times);
+  // Gather the objects left in the slices, the first slice is already in place.
+  StackReference<Object>* out = objects + state.slice_ends[0];
+  for (size_t i = 1; i < thread_count; ++i) {
+    StackReference<Object>* const begin = objects + i * state.slice_size;
+    StackReference<Object>* const end = objects + state.slice_ends[i];
+    for (StackReference<Object>* it = begin; it < end; ++it) {
+      (out++)->Assign(it->AsMirrorPtr());
+    }
+  }
+  return out - objects;
+}
+
 void MarkSweep::SweepArray(accounting::ObjectStack* allocations, bool swap_bitmaps) {
   TimingLogger::ScopedTiming t(__FUNCTION__, GetTimings());
   Thread* self = Thread::Current();
@@ -1170,47 +1319,55 @@ void MarkSweep::SweepArray(accounting::ObjectStack* allocations, bool swap_bitma
   if (non_moving_space != nullptr) {
     sweep_spaces.push_back(non_moving_space);
   }
-  // Start by sweeping the continuous spaces.
-  for (space::ContinuousSpace* space : sweep_spaces) {
-    space::AllocSpace* alloc_space = space->AsAllocSpace();
-    accounting::ContinuousSpaceBitmap* live_bitmap = space->GetLiveBitmap();
-    accounting::ContinuousSpaceBitmap* mark_bitmap = space->GetMarkBitmap();
-    if (swap_bitmaps) {
-      std::swap(live_bitmap, mark_bitmap);
-    }
-    StackReference<Object>* out = objects;
-    for (size_t i = 0; i < count; ++i) {
-      Object* const obj = objects[i].AsMirrorPtr();
-      if (kUseThreadLocalAllocationStack && obj == nullptr) {
-        continue;
+  const size_t thread_count = heap_->GetSweepThreadCount();
+  if (kParallelSweepArray && thread_count > 1 && count >= kMinimumParallelSweepArraySize) {
+    count = SweepArrayParallel(sweep_spaces, objects, count, swap_bitmaps, thread_count, &freed);
+  } else {
+    const uint64_t start_time = NanoTime();
+    // Start by sweeping the continuous spaces.
+    for (space::ContinuousSpace* space : sweep_spaces) {
+      space::AllocSpace* alloc_space = space->AsAllocSpace();
+      accounting::ContinuousSpaceBitmap* live_bitmap = space->GetLiveBitmap();
+      accounting::ContinuousSpaceBitmap* mark_bitmap = space->GetMarkBitmap();
+      if (swap_bitmaps) {
+        std::swap(live_bitmap, mark_bitmap);
       }
-      if (space->HasAddress(obj)) {
-        // This object is in the space, remove it from the array and add it to the sweep buffer
-        // if needed.
-        if (!mark_bitmap->Test(obj)) {
-          if (chunk_free_pos >= kSweepArrayChunkFreeSize) {
-            TimingLogger::ScopedTiming t2("FreeList", GetTimings());
-            freed.objects += chunk_free_pos;
-            freed.bytes += alloc_space->FreeList(self, chunk_free_pos, chunk_free_buffer);
-            chunk_free_pos = 0;
+      StackReference<Object>* out = objects;
+      for (size_t i = 0; i < count; ++i) {
+        Object* const obj = objects[i].AsMirrorPtr();
+        if (kUseThreadLocalAllocationStack && obj == nullptr) {
+          continue;
+        }
+        if (space->HasAddress(obj)) {
+          // This object is in the space, remove it from the array and add it to the sweep buffer
+          // if needed.
+          if (!mark_bitmap->Test(obj)) {
+            if (chunk_free_pos >= kSweepArrayChunkFreeSize) {
+              TimingLogger::ScopedTiming t2("FreeList", GetTimings());
+              freed.objects += chunk_free_pos;
+              freed.bytes += alloc_space->FreeList(self, chunk_free_pos, chunk_free_buffer);
+              chunk_free_pos = 0;
+            }
+            chunk_free_buffer[chunk_free_pos++] = obj;
           }
-          chunk_free_buffer[chunk_free_pos++] = obj;
+        } else {
+          (out++)->Assign(obj);
         }
-      } else {
-        (out++)->Assign(obj);
       }
+      if (chunk_free_pos > 0) {
+        TimingLogger::ScopedTiming t2("FreeList", GetTimings());
+        freed.objects += chunk_free_pos;
+        freed.bytes += alloc_space->FreeList(self, chunk_free_pos, chunk_free_buffer);
+        chunk_free_pos = 0;
+      }
+      // All of the references which space contained are no longer in the allocation stack, update
+      // the count.
+      count = out - objects;
     }
-    if (chunk_free_pos > 0) {
-      TimingLogger::ScopedTiming t2("FreeList", GetTimings());
-      freed.objects += chunk_free_pos;
-      freed.bytes += alloc_space->FreeList(self, chunk_free_pos, chunk_free_buffer);
-      chunk_free_pos = 0;
-    }
-    // All of the references which space contained are no longer in the allocation stack, update
-    // the count.
-    count = out - objects;
+    RegisterSweepWorkerTimes(std::vector<uint64_t>(1, NanoTime() - start_time));
   }
   // Handle the large object space.
+  const uint64_t los_start_time = NanoTime();
   space::LargeObjectSpace* large_object_space = GetHeap()->GetLargeObjectsSpace();
   if (large_object_space != nullptr) {
     accounting::LargeObjectBitmap* large_live_objects = large_object_space->GetLiveBitmap();
@@ -1230,6 +1387,8 @@ void MarkSweep::SweepArray(accounting::ObjectStack* allocations, bool swap_bitma
       }
     }
   }
+  // The large objects are swept by the GC thread, which is the sweeping worker 0.
+  RegisterSweepWorkerTimes(std::vector<uint64_t>(1, NanoTime() - los_start_time));
   {
     TimingLogger::ScopedTiming t2("RecordFree", GetTimings());
     RecordFree(freed);
@@ -1253,16 +1412,25 @@ void MarkSweep::Sweep(bool swap_bitmaps) {
     live_stack->Reset();
     DCHECK(mark_stack_->IsEmpty());
   }
+  const size_t thread_count = heap_->GetSweepThreadCount();
+  std::vector<uint64_t> worker_times;
   for (const auto& space : GetHeap()->GetContinuousSpaces()) {
     if (space->IsContinuousMemMapAllocSpace()) {
       space::ContinuousMemMapAllocSpace* alloc_space = space->AsContinuousMemMapAllocSpace();
       TimingLogger::ScopedTiming split(
           alloc_space->IsZygoteSpace() ? "SweepZygoteSpace" : "SweepMallocSpace", GetTimings());
+      worker_times.clear();
       if (space->IsRosAllocSpace()) {
-        RecordFree(space->AsRosAllocSpace()->GetRosAlloc()->SweepWalkPagemap(swap_bitmaps));
+        // The lazy sweep relies on the live bitmap staying as it is until the next GC, which only
+        // holds if it becomes the mark bitmap once the bitmaps get swapped.
+        const bool lazy = kLazyRosAllocSweep && !swap_bitmaps &&
+            space->GetGcRetentionPolicy() == space::kGcRetentionPolicyAlwaysCollect;
+        RecordFree(space->AsRosAllocSpace()->GetRosAlloc()->SweepWalkPagemap(
+            swap_bitmaps, thread_count, &worker_times, lazy));
       } else {
-        RecordFree(alloc_space->Sweep(swap_bitmaps));
+        RecordFree(alloc_space->Sweep(swap_bitmaps, thread_count, &worker_times));
       }
+      RegisterSweepWorkerTimes(worker_times);
     }
   }
   SweepLargeObjects(swap_bitmaps);
@@ -1272,7 +1440,9 @@ void MarkSweep::SweepLargeObjects(bool swap_bitmaps) {
   space::LargeObjectSpace* los = heap_->GetLargeObjectsSpace();
   if (los != nullptr) {
     TimingLogger::ScopedTiming split(__FUNCTION__, GetTimings());
+    const uint64_t start_time = NanoTime();
     RecordFreeLOS(los->Sweep(swap_bitmaps));
+    RegisterSweepWorkerTimes(std::vector<uint64_t>(1, NanoTime() - start_time));
   }
 }
 
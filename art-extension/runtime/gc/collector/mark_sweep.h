@@ -21,6 +21,7 @@
 #define ART_RUNTIME_GC_COLLECTOR_MARK_SWEEP_H_
 
 #include <memory>
+#include <vector>
 
 #include "atomic.h"
 #include "barrier.h"
@@ -41,6 +42,7 @@ namespace mirror {
   class Reference;
 }  // namespace mirror
 
+template<class MirrorType> class StackReference;
 class Thread;
 enum VisitRootFlags : uint8_t;
 
@@ -53,6 +55,10 @@ namespace accounting {
   typedef AtomicStack<mirror::Object> ObjectStack;
 }  // namespace accounting
 
+namespace space {
+  class ContinuousSpace;
+}  // namespace space
+
 namespace collector {
 
 class MarkSweep : public GarbageCollector {
@@ -151,6 +157,14 @@ class MarkSweep : public GarbageCollector {
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_)
       EXCLUSIVE_LOCKS_REQUIRED(Locks::heap_bitmap_lock_);
 
+  // Sweep the objects of the array which are in sweep_spaces on the sweeping workers, and leave
+  // the other objects at the beginning of the array. Returns how many objects are left.
+  size_t SweepArrayParallel(const std::vector<space::ContinuousSpace*>& sweep_spaces,
+                            StackReference<mirror::Object>* objects, size_t count,
+                            bool swap_bitmaps, size_t thread_count, ObjectBytePair* freed)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_)
+      EXCLUSIVE_LOCKS_REQUIRED(Locks::heap_bitmap_lock_);
+
   // Blackens an object.
   void ScanObject(mirror::Object* obj)
       EXCLUSIVE_LOCKS_REQUIRED(Locks::heap_bitmap_lock_)
@@ -38,6 +38,8 @@ enum CollectorType {
   kCollectorTypeMC,
   // Heap trimming collector, doesn't do any actual collecting.
   kCollectorTypeHeapTrim,
+  // Sweeping of the RosAlloc runs a GC left to the lazy sweep, doesn't do any marking.
+  kCollectorTypeLazySweep,
   // A (mostly) concurrent copying collector.
   kCollectorTypeCC,
   // A homogeneous space compaction collector used in background transition
@@ -17,9 +17,11 @@
 #include <fcntl.h>
 #include <fstream>
 #include <limits>
+#include <sstream>
 #include <stdlib.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <vector>
 #include "base/histogram-inl.h"
 #include "base/stl_util.h"
@@ -46,6 +48,7 @@
 #include "gc/space/rosalloc_space-inl.h"
 #include "gc/space/space-inl.h"
 #include "gc/space/zygote_space.h"
+#include "gc/task_processor.h"
 #include "entrypoints/quick/quick_alloc_entrypoints.h"
 #include "heap-inl.h"
 #include "image.h"
@@ -68,76 +71,16 @@
 namespace art {
 
 namespace gc {
-// Number of regions divided for size distribution.
-static constexpr size_t kNumSizeDistRegions = 11;
 static constexpr size_t kConstToFragmentPhase = 4;
-// Dump Record Header based on record type.
-void RecordList::DumpHeader(std::ofstream& os) {
-  switch (record_type_) {
-    case kRecordTypeGC: {
-      os << "GC Message, ID, Timestamp, reason, max pausetime, mark time, sweep time, "
-         << "GC duration, number objects freed, freed bytes, number large obj freed, large obj freed bytes, "
-         << "max wait time, GC type, max allowed footprint, concurrent start bytes, blocking time, "
-         << "allocated size before gc, allocated size after gc, alloc stack size after gc, GC throughput, "
-         << "GC throughput, footprint before gc, footprint after gc, main space size before gc, "
-         << "main space size after gc, los space size before gc, los space size after gc" << std::endl;
-      break;
-    }
-    case kRecordTypeSucc: {
-      os << "Succeeded Allocation Messages,GC_Id, total_size, [1-16], [17-32],"
-         << " [33-64], [65-128], [129-256], [257-512], [513-1024], [1025-2048], [2049-4096],"
-         << " [4097-8192], [8193-12288], [12288-]" << std::endl;
-     break;
-    }
-    case kRecordTypeFail: {
-      os << "Failed Allocation Messages, GC_Id, size, phase, last_gc_type, type" << std::endl;
-      break;
-    }
-    case kRecordTypeLarge: {
-      os << "Large Object Messages, GC_Id, size, type" << std::endl;
-      break;
-    }
-    case kRecordTypeAlloc: {
-      os << "Allocation Info, duration(ms), total_bytes_allocated, "
-         << "total_objects_allocated, Alloc_ThroughPut, Alloc_ThroughPut" << std::endl;
-      break;
-    }
-    default: {
-      os << "Not Supported Info!!" << record_type_ << std::endl;
-      break;
-    }
-  }
-}
-
-// Dump Records in RecordList.
-void RecordList::DumpRecords(std::ofstream& os) {
-  for (auto iter = record_list_.begin();
-       iter != record_list_.end(); iter++) {
-    // Dump Record Data.
-    (*iter)->DumpRecord(os);
-  }
-}
-
-// Release Records in list and clear the list.
-void RecordList::ReleaseRecordsAndClear() {
-  for (auto iter = record_list_.begin();
-        iter != record_list_.end(); iter++) {
-    delete (*iter);
-  }
-  record_list_.clear();
-}
-
-// Create new record and insert to list.
-void RecordList::InsertRecord(ProfileRecord* record) {
-  record_list_.push_back(record);
-}
+// Period of the heap task writing the buffered records to the profile file.
+static constexpr uint64_t kFlushPeriodNs = MsToNs(100);
 
-// Get the last Record in list, it should be the currently using one.
-ProfileRecord* RecordList::GetLastRecord() {
-  if (record_list_.size() == 0) {
-    return nullptr;
-  }
-  return record_list_.back();
+// Copy the descriptor of a class into a record, truncating it if needed.
+static void CopyClassDescriptor(mirror::Class* klass, char* type, size_t type_size) {
+  std::string class_desc = Runtime::Current()->GetHeap()->SafeGetClassDescriptor(klass);
+  size_t length = std::min(class_desc.size(), type_size - 1);
+  memcpy(type, class_desc.c_str(), length);
+  memset(type + length, 0, type_size - length);
 }
 
 // Fill basic info, used when creating new record.
@@ -149,6 +92,8 @@ void GCRecord::FillBasicInfo(uint32_t id,
                              uint32_t bytes_allocated,
                              uint32_t main_space_size,
                              uint32_t los_space_size) {
+  // Start from a clean record, it is written raw to the profile file.
+  memset(this, 0, sizeof(*this));
   id_ = id;
   reason_ = gc_cause;
   type_ = gc_type;
@@ -180,129 +125,35 @@ void GCRecord::FillFields(collector::GarbageCollector* collector,
     total_object_count_in_alloc_stack_during_gc_ = alloc_stack_size;
     main_space_size_after_gc_ = main_space_size;
     los_space_size_after_gc_ = los_size;
-
-    if (gc_time_ != 0) {
-      gc_throughput_bpns_ = static_cast<double>(free_bytes_ + free_large_object_bytes_) / static_cast<double>(gc_time_);
-      gc_throughput_npns_ = static_cast<double>(free_object_count_ + free_large_object_count_) / static_cast<double>(gc_time_);
-    } else {
-      gc_throughput_bpns_ = 0.0;
-      gc_throughput_npns_ = 0.0;
-    }
 }
 
-void GCRecord::ConvertDataUnits() {
-  // Only convert in inaccurate mode.
-  if (GcProfiler::InaccurateMode()) {
-    // Convert time.
-    ConvertTimeToMs(timestamp_);
-    ConvertTimeToMs(pause_time_max_);
-    ConvertTimeToMs(mark_time_);
-    ConvertTimeToMs(sweep_time_);
-    ConvertTimeToMs(gc_time_);
-    ConvertTimeToMs(max_wait_time_);
-    ConvertTimeToMs(blocking_time_);
-    // Convert size.
-    ConvertSizeToMb(free_bytes_);
-    ConvertSizeToMb(free_large_object_bytes_);
-    ConvertSizeToMb(max_allowed_footprint_);
-    ConvertSizeToMb(concurrent_start_bytes_);
-    ConvertSizeToMb(allocated_size_before_gc_);
-    ConvertSizeToMb(allocated_size_after_gc_);
-    ConvertSizeToMb(footprint_size_before_gc_);
-    ConvertSizeToMb(footprint_size_after_gc_);
-    ConvertSizeToMb(main_space_size_before_gc_);
-    ConvertSizeToMb(main_space_size_after_gc_);
-    ConvertSizeToMb(los_space_size_before_gc_);
-    ConvertSizeToMb(los_space_size_after_gc_);
-    // Convert throughput bpns/npns to bpms/npms.
-    ConvertThroughputToMs(gc_throughput_bpns_);
-    ConvertThroughputToMs(gc_throughput_npns_);
-  }
-}
-
-// Dump GC records.
-void GCRecord::DumpRecord(std::ofstream& os) {
-  if (GcProfiler::DumpBinary()) {
-    // Dump binary raw data.
-    os.write(reinterpret_cast<char*>(this), sizeof(GCRecord));
-  } else {
-    ConvertDataUnits();
-    // Dump .csv format data.
-    os << "," << id_ << "," << timestamp_ << "," << reason_ << "," << pause_time_max_ << "," << mark_time_
-       << "," << sweep_time_ << "," << gc_time_ << "," << free_object_count_ << "," << free_bytes_
-       << "," << free_large_object_count_ << "," << free_large_object_bytes_ << "," << max_wait_time_
-       << "," << type_ << "," << max_allowed_footprint_ << "," << concurrent_start_bytes_
-       << "," << blocking_time_ << "," << allocated_size_before_gc_ << "," << allocated_size_after_gc_
-       << "," << total_object_count_in_alloc_stack_during_gc_ << "," << gc_throughput_bpns_
-       << "," << gc_throughput_npns_ << "," << footprint_size_before_gc_ << "," << footprint_size_after_gc_
-       << "," << main_space_size_before_gc_ << "," << main_space_size_after_gc_
-       << "," << los_space_size_before_gc_ << "," << los_space_size_after_gc_ << std::endl;
-  }
-  os.flush();
-}
-
-// Convert the data unit for inaccurate mode.
-void SuccAllocRecord::ConvertDataUnits() {
-  if (GcProfiler::InaccurateMode()) {
-    // Convert bytes to Mb.
-    ConvertSizeToMb(total_size_);
-  }
+// Start a new histogram.
+void SuccAllocRecord::Reset(uint32_t gc_id, uint32_t interval) {
+  memset(this, 0, sizeof(*this));
+  gc_id_ = gc_id;
+  interval_ = interval;
 }
 
-// Dump succeed allocation info.
-void SuccAllocRecord::DumpRecord(std::ofstream& os) {
-  if (GcProfiler::DumpBinary()) {
-    os.write(reinterpret_cast<char*>(this), sizeof(SuccAllocRecord));
-  } else {
-    ConvertDataUnits();
-    os << " ," << gc_id_ << " ," << total_size_;
-    for (int i = 0; i < 12; i++) {
-      os << " ," << size_dist_[i];
-    }
-    os << std::endl;
-  }
-  os.flush();
-}
-// Insert the size to distribution in allocation info record.
-// The size_dist_[] divided the object size into kNumSizeDistRegions.
+// The size_dist_[] divided the object size into kNumSizeDistRegions and large objects.
 // It records the count of objects whose size is in coressponding region.
-void SuccAllocRecord::InsertSizeDist(uint32_t size) {
+size_t SuccAllocRecord::GetSizeDistRegion(uint32_t size) {
   if (size >= Heap::kDefaultLargeObjectThreshold) {
-    size_dist_[kNumSizeDistRegions]++;
-  } else {
-    uint32_t t = (size - 1) >> 4;
-    uint32_t i = 0;
-    while (t > 0) {
-      i++;
-      t = t >> 1;
-    }
-    size_dist_[i]++;
+    return kNumSizeDistRegions;
   }
-}
-
-// Fill success allocation info fields.
-void SuccAllocRecord::FillFields(uint32_t byte_count) {
-  total_size_ += byte_count;
-  InsertSizeDist(byte_count);
-}
-
-// Convert the data unit for inaccurate mode.
-void FailAllocRecord::ConvertDataUnits() {
-  if (GcProfiler::InaccurateMode()) {
-    // Convert bytes to Mb.
-    ConvertSizeToMb(size_);
+  uint32_t t = (size - 1) >> 4;
+  size_t i = 0;
+  while (t > 0) {
+    i++;
+    t = t >> 1;
   }
+  return i;
 }
 
-// Dump Record of fail allocation info.
-void FailAllocRecord::DumpRecord(std::ofstream& os) {
-  if (GcProfiler::DumpBinary()) {
-    os.write(reinterpret_cast<char*>(this), sizeof(FailAllocRecord));
-  } else {
-    ConvertDataUnits();
-    os << ", " << gc_id_ << ", " << size_ << ", " << phase_ << ", " << last_gc_type_ << ", " << type_ << std::endl;
+void SuccAllocRecord::CopyCounts(uint32_t total_size, const Atomic<uint32_t>* size_dist) {
+  total_size_ = total_size;
+  for (size_t i = 0; i <= kNumSizeDistRegions; i++) {
+    size_dist_[i] = size_dist[i].LoadRelaxed();
   }
-  os.flush();
 }
 
 // Fill fail allocation info fields.
@@ -317,94 +168,121 @@ void FailAllocRecord::FillFields(mirror::Class* klass,
   gc_id_ = gc_id;
   size_ = alloc_size;
   last_gc_type_ = gc_type;
-  std::string class_desc = Runtime::Current()->GetHeap()->SafeGetClassDescriptor(klass);
-  int length = class_desc.size() + 1;
-  length = length <= 255 ? length : 255;
-  strncpy(type_, class_desc.c_str(), length);
+  CopyClassDescriptor(klass, type_, sizeof(type_));
   // If there is segmentation, set corresponding phase.
   if (free_size > alloc_size && fail_phase <= kFailUntilGCForAllocClearRef) {
-    phase_ = (AllocFailPhase)(fail_phase + kConstToFragmentPhase);
+    phase_ = fail_phase + kConstToFragmentPhase;
   } else {
     phase_ = fail_phase;
   }
 }
 
-// Convert the data unit for inaccurate mode.
-void LargeObjAllocRecord::ConvertDataUnits() {
-  if (GcProfiler::InaccurateMode()) {
-    // Convert bytes to Mb.
-    ConvertSizeToMb(size_);
-  }
-}
-
-// Dump large object allocation info.
-void LargeObjAllocRecord::DumpRecord(std::ofstream& os) {
-  if (GcProfiler::DumpBinary()) {
-    os.write(reinterpret_cast<char*>(this), sizeof(LargeObjAllocRecord));
-  } else {
-    ConvertDataUnits();
-    os << " ," << gc_id_ << " ," << size_ << " ," << type_ << std::endl;
-  }
-  os.flush();
-}
-
 // Fill large object allocation info.
 void LargeObjAllocRecord::FillFields(uint32_t gc_id, uint32_t byte_count, mirror::Class* klass) {
   gc_id_ = gc_id;
   size_ = byte_count;
-  std::string class_desc = Runtime::Current()->GetHeap()->SafeGetClassDescriptor(klass);
-  int length = class_desc.size() + 1;
-  length = length <= 255 ? length : 255;
-  strncpy(type_, class_desc.c_str(), length);
+  CopyClassDescriptor(klass, type_, sizeof(type_));
 }
 
-// Sum up the number of bytes and counts of allocted objects.
-void AllocInfoRecord::AddAllocInfo(uint32_t bytes) {
-  number_bytes_alloc_atomic_.FetchAndAddSequentiallyConsistent(bytes);
-  number_objects_alloc_++;
+// Fill allocation info, the converter calculates the allocation throughput.
+void AllocInfoRecord::FillFields(uint64_t duration,
+                                 uint32_t bytes_allocated,
+                                 uint32_t objects_allocated,
+                                 uint64_t dropped_records) {
+  duration_ = duration;
+  dropped_records_ = dropped_records;
+  number_bytes_alloc_ = bytes_allocated;
+  number_objects_alloc_ = objects_allocated;
 }
 
-// Calculate allocation throughput.
-void AllocInfoRecord::CalculateAllocThroughput(uint64_t duration) {
-  if (duration != 0) {
-    throughput_bpns_ = static_cast<double>(number_bytes_alloc_atomic_.LoadSequentiallyConsistent())
-        / static_cast<double>(duration);
-    throughput_npns_ = static_cast<double>(number_objects_alloc_.LoadSequentiallyConsistent())
-        / static_cast<double>(duration);
-  } else {
-    // If profile_duration is too small, throughputs are set to 0.
-    throughput_bpns_ = 0.0;
-    throughput_npns_ = 0.0;
+void NameRecord::FillFields(NameKind kind, uint32_t value, const std::string& name) {
+  kind_ = kind;
+  value_ = value;
+  size_t length = std::min(name.size(), sizeof(name_) - 1);
+  memcpy(name_, name.c_str(), length);
+  memset(name_ + length, 0, sizeof(name_) - length);
+}
+
+GcProfileThreadBuffer::GcProfileThreadBuffer() {
+  for (size_t i = 0; i <= kNumSizeDistRegions; i++) {
+    succ_size_dist_[i].StoreRelaxed(0);
   }
-  duration_ = duration;
 }
 
-// Convert the data unit for inaccurate mode.
-void AllocInfoRecord::ConvertDataUnits() {
-  if (GcProfiler::InaccurateMode()) {
-    // Convert bytes to MB.
-    number_bytes_alloc_ = RoundUp(number_bytes_alloc_atomic_.LoadSequentiallyConsistent() / MB, MB);
-    // Convert throughput.
-    ConvertThroughputToMs(throughput_bpns_);
-    ConvertThroughputToMs(throughput_npns_);
-  } else {
-    // For accurate mode, load the value for output.
-    number_bytes_alloc_ = number_bytes_alloc_atomic_.LoadSequentiallyConsistent();
+// Reset the counters the first time the thread allocates in a profiling.
+void GcProfileThreadBuffer::StartSession(uint32_t session) {
+  if (LIKELY(session_.LoadRelaxed() == session)) {
+    return;
+  }
+  bytes_allocated_.StoreRelaxed(0);
+  objects_allocated_.StoreRelaxed(0);
+  succ_gc_id_.StoreRelaxed(0);
+  succ_interval_.StoreRelaxed(0);
+  succ_total_size_.StoreRelaxed(0);
+  for (size_t i = 0; i <= kNumSizeDistRegions; i++) {
+    succ_size_dist_[i].StoreRelaxed(0);
   }
+  session_.StoreRelaxed(session);
 }
 
-// Dump allocation record.
-void AllocInfoRecord::DumpRecord(std::ofstream& os) {
-  if (GcProfiler::DumpBinary()) {
-    os.write(reinterpret_cast<char*>(this), sizeof(AllocInfoRecord));
-  } else {
-    ConvertDataUnits();
-    os << ", " << duration_ << ", " << number_bytes_alloc_ << ", " << number_objects_alloc_
-       << ", " << throughput_bpns_ << ", " << throughput_npns_ << std::endl;
+// Only the owner thread updates the counters, no read-modify-write is needed.
+void GcProfileThreadBuffer::AddAllocInfo(uint32_t bytes_allocated) {
+  bytes_allocated_.StoreRelaxed(bytes_allocated_.LoadRelaxed() + bytes_allocated);
+  objects_allocated_.StoreRelaxed(objects_allocated_.LoadRelaxed() + 1);
+}
+
+void GcProfileThreadBuffer::AddSuccAlloc(uint32_t gc_id, uint32_t interval, uint32_t byte_count) {
+  if (UNLIKELY(succ_interval_.LoadRelaxed() != interval)) {
+    // A GC started, the histogram of the previous interval is complete.
+    AllocEvent event;
+    event.type_ = kRecordTypeSucc;
+    event.succ_ = GetSuccAllocRecord();
+    if (!event.succ_.IsEmpty()) {
+      PushEvent(event);
+    }
+    succ_gc_id_.StoreRelaxed(gc_id);
+    succ_interval_.StoreRelaxed(interval);
+    succ_total_size_.StoreRelaxed(0);
+    for (size_t i = 0; i <= kNumSizeDistRegions; i++) {
+      succ_size_dist_[i].StoreRelaxed(0);
+    }
   }
-  os.flush();
+  size_t region = SuccAllocRecord::GetSizeDistRegion(byte_count);
+  succ_total_size_.StoreRelaxed(succ_total_size_.LoadRelaxed() + byte_count);
+  succ_size_dist_[region].StoreRelaxed(succ_size_dist_[region].LoadRelaxed() + 1);
 }
 
+SuccAllocRecord GcProfileThreadBuffer::GetSuccAllocRecord() const {
+  SuccAllocRecord record;
+  record.Reset(succ_gc_id_.LoadRelaxed(), succ_interval_.LoadRelaxed());
+  record.CopyCounts(succ_total_size_.LoadRelaxed(), succ_size_dist_);
+  return record;
+}
+
+// Write the buffered records to the profile file periodically, until the profiling stops.
+class GcProfileFlushTask : public HeapTask {
+ public:
+  GcProfileFlushTask(uint64_t target_time, uint32_t session)
+    : HeapTask(target_time), session_(session) { }
+
+  virtual void Run(Thread* self) OVERRIDE {
+    GcProfiler* gc_profiler = GcProfiler::GetInstance();
+    {
+      MutexLock mu(self, *gc_profiler->gc_profiler_lock_);
+      // A task of a previous profiling ends here, the current one has its own task.
+      if (!gc_profiler->gc_prof_running_ || gc_profiler->session_.LoadRelaxed() != session_) {
+        return;
+      }
+      gc_profiler->FlushLocked();
+      gc_profiler->flush_scheduled_ = false;
+    }
+    gc_profiler->ScheduleFlush(self);
+  }
+
+ private:
+  const uint32_t session_;
+};
+
 GcProfiler GcProfiler::s_instance;
 
 GcProfiler::GcProfiler()
@@ -412,45 +290,52 @@ GcProfiler::GcProfiler()
             gc_id_(0),
             gc_prof_running_(false),
             prof_succ_allocation_(false),
-            data_dir_("data/local/tmp/gcprofile/") {
+            data_dir_("data/local/tmp/gcprofile/"),
+            session_(0),
+            interval_(0),
+            has_current_gc_record_(false),
+            flush_scheduled_(false),
+            revoked_bytes_allocated_(0),
+            revoked_objects_allocated_(0),
+            revoked_dropped_records_(0) {
   gc_profiler_lock_ = new Mutex("Gcprofiling lock");
-  succ_record_lock_ = new Mutex("Successfull allocation record lock");
-  fail_record_lock_ = new Mutex("Fail allocation record lock");
-  // Build up the record lists for dump iteration.
-  record_lists_.push_back(&gc_record_list_);
-  record_lists_.push_back(&succ_record_list_);
-  record_lists_.push_back(&fail_record_list_);
-  record_lists_.push_back(&large_object_alloc_record_list_);
-  record_lists_.push_back(&alloc_info_record_list_);
-  // Set the record list type.
-  gc_record_list_.SetRecordType(kRecordTypeGC);
-  succ_record_list_.SetRecordType(kRecordTypeSucc);
-  fail_record_list_.SetRecordType(kRecordTypeFail);
-  large_object_alloc_record_list_.SetRecordType(kRecordTypeLarge);
-  alloc_info_record_list_.SetRecordType(kRecordTypeAlloc);
 }
 
+// Thread buffers are not released, threads can still allocate while the process exits.
 GcProfiler::~GcProfiler() {
-  delete succ_record_lock_;
-  delete fail_record_lock_;
 }
 
 // Start GC Profiler, init related variables.
 void GcProfiler::Start() {
   LOG(INFO) << "GCProfile: Start";
   Thread* self = Thread::Current();
-  // In case there are multi-starts.
-  MutexLock mu(self, *gc_profiler_lock_);
-  // If profile already start, return.
-  if (gc_prof_running_) {
-    return;
+  {
+    // In case there are multi-starts.
+    MutexLock mu(self, *gc_profiler_lock_);
+    // If profile already start, return.
+    if (gc_prof_running_) {
+      return;
+    }
+    if (!OpenProfileFile()) {
+      return;
+    }
+    profile_duration_ = NsToMs(NanoTime());
+    gc_id_ = 0;
+    has_current_gc_record_ = false;
+    revoked_bytes_allocated_ = 0;
+    revoked_objects_allocated_ = 0;
+    revoked_dropped_records_ = 0;
+    // Drop what threads pushed after the previous profiling stopped.
+    gc_records_.Clear();
+    for (GcProfileThreadBuffer* buffer : thread_buffers_) {
+      buffer->GetRing()->Clear();
+    }
+    interval_.StoreRelaxed(0);
+    // Threads reset their counters when they see the new session.
+    session_.FetchAndAddSequentiallyConsistent(1);
+    gc_prof_running_ = true;
   }
-  profile_duration_ = NsToMs(NanoTime());
-  gc_prof_running_ = true;
-
-  // Create allocation info record.
-  CreateAllocInfoRecord();
-  CreateSuccAllocRecord(0);
+  ScheduleFlush(self);
 }
 
 // Stop GC profiling.
@@ -461,63 +346,37 @@ void GcProfiler::Stop(bool drop_result) {
   if (!gc_prof_running_) {
     return;
   }
+  gc_prof_running_ = false;
+  flush_scheduled_ = false;
   // Don't need the result.
   if (drop_result) {
-    ClearAndReleaseAllRecords();
-    gc_prof_running_ = false;
+    out_->close();
+    out_.reset();
+    unlink(file_name_.c_str());
     return;
   }
   // Profile duration is used for calculating allocation throughput.
   profile_duration_ = NsToMs(NanoTime()) - profile_duration_;
-  // Calculate throughput.
-  CalculateAllocThroughput(profile_duration_);
-  DumpRecordLists();
-  ClearAndReleaseAllRecords();
+  FlushLocked();
+  WriteFinalRecords();
+  out_->close();
+  out_.reset();
   LOG(INFO) << "GCProfile: Finish!";
-  gc_prof_running_ = false;
-}
-
-// Dump title line that contains data unit.
-void GcProfiler::DumpTitleLine(std::ofstream& out) {
-  std::string time_unit = "nanoseconds";
-  std::string size_unit = "bytes";
-  std::string throughput_b_unit = "bytes/nanosecond";
-  std::string throughput_n_unit = "count/nanosecond";
-  // Only need title in csv file
-  if (DumpBinary()) {
-    return;
-  }
-  // Change data unit for inaccurate mode.
-  if (InaccurateMode()) {
-    time_unit = "milliseconds";
-    size_unit = "mega-bytes";
-    throughput_b_unit = "bytes/milliseconds";
-    throughput_n_unit = "count/milliseconds";
-  }
-
-  out << "GcProfile Data, Unit: Time(" << time_unit <<") Size (" << size_unit << ") Throughput ("
-      << throughput_b_unit << " ; " << throughput_n_unit << ")" << std::endl;
-  out.flush();
 }
 
-// Iterate all list in record_lists and dump.
-void GcProfiler::DumpRecordLists() {
+// Open the profile file, the records are streamed to it until the profiling stops.
+bool GcProfiler::OpenProfileFile() {
   // Create the dump file.
   char file_name[256];
-  std::string suffix = "csv";
   int tail = 0;
   int err = 0;
   bool tried_data_path = false;
   struct stat buf;
-  // Using different suffix for different format.
-  if (DumpBinary()) {
-    suffix = "b";
-  }
   // Find the file path to save profile data. if data_dir not work, using app's private data path.
   do {
     // Try create output files.
     for (tail = 0; ; tail++) {
-      snprintf(file_name, sizeof(file_name), "%s/alloc_free_log_%d_%d.%s", data_dir_.c_str(), getpid(), tail, suffix.c_str());
+      snprintf(file_name, sizeof(file_name), "%s/alloc_free_log_%d_%d.b", data_dir_.c_str(), getpid(), tail);
       err = stat(file_name, &buf);
       if (err != 0) {
         LOG(INFO) << file_name << " will be used.";
@@ -536,7 +395,8 @@ void GcProfiler::DumpRecordLists() {
         std::string app_data_dir = "/data/data/";
         if (!in.is_open()) {
           LOG(ERROR) << "GCProfile: cannot dump data!";
-          return;
+          out_.reset();
+          return false;
         }
         getline(in, proc_name);
         data_dir_ = app_data_dir + proc_name + "/";
@@ -544,108 +404,231 @@ void GcProfiler::DumpRecordLists() {
         tried_data_path = true;
       } else {
         LOG(ERROR) << "GCProfile: cannot dump data!";
-        return;
+        out_.reset();
+        return false;
       }
     } else {
       break;
     }
   } while (true);
+  file_name_ = file_name;
+
+  GcProfileFileHeader header;
+  header.magic_ = kGcProfileMagic;
+  header.version_ = kGcProfileVersion;
+  header.flags_ = InaccurateMode() ? kGcProfileFlagInaccurateMode : 0;
+  header.pid_ = getpid();
+  out_->write(reinterpret_cast<const char*>(&header), sizeof(header));
+  WriteNameRecords();
+  return true;
+}
+
+void GcProfiler::WriteRecord(RecordType type, const void* record, size_t size) {
+  GcProfileRecordHeader header;
+  header.type_ = type;
+  header.size_ = size;
+  out_->write(reinterpret_cast<const char*>(&header), sizeof(header));
+  out_->write(reinterpret_cast<const char*>(record), size);
+}
+
+// The converter prints the enums the way the runtime does.
+void GcProfiler::WriteNameRecords() {
+  NameRecord record;
+  for (uint32_t i = kGcCauseForAlloc; i <= kGcCauseHomogeneousSpaceCompact; i++) {
+    std::ostringstream name;
+    name << static_cast<GcCause>(i);
+    record.FillFields(kNameKindGcCause, i, name.str());
+    WriteRecord(kRecordTypeName, &record, sizeof(record));
+  }
+  for (uint32_t i = collector::kGcTypeNone; i < collector::kGcTypeMax; i++) {
+    std::ostringstream name;
+    name << static_cast<collector::GcType>(i);
+    record.FillFields(kNameKindGcType, i, name.str());
+    WriteRecord(kRecordTypeName, &record, sizeof(record));
+  }
+  for (uint32_t i = kFailUntilGCConcurrent; i <= kFailNull; i++) {
+    std::ostringstream name;
+    name << static_cast<AllocFailPhase>(i);
+    record.FillFields(kNameKindAllocFailPhase, i, name.str());
+    WriteRecord(kRecordTypeName, &record, sizeof(record));
+  }
+}
+
+// Drain the ring buffers into the profile file.
+void GcProfiler::FlushLocked() {
+  GCRecord gc_record;
+  while (gc_records_.Pop(&gc_record)) {
+    WriteRecord(kRecordTypeGC, &gc_record, sizeof(gc_record));
+  }
+  for (GcProfileThreadBuffer* buffer : thread_buffers_) {
+    FlushThreadBuffer(buffer);
+  }
+  out_->flush();
+}
+
+void GcProfiler::FlushThreadBuffer(GcProfileThreadBuffer* buffer) {
+  AllocEvent event;
+  while (buffer->GetRing()->Pop(&event)) {
+    switch (event.type_) {
+      case kRecordTypeSucc:
+        WriteRecord(kRecordTypeSucc, &event.succ_, sizeof(event.succ_));
+        break;
+      case kRecordTypeFail:
+        WriteRecord(kRecordTypeFail, &event.fail_, sizeof(event.fail_));
+        break;
+      case kRecordTypeLarge:
+        WriteRecord(kRecordTypeLarge, &event.large_, sizeof(event.large_));
+        break;
+      default:
+        LOG(FATAL) << "Unexpected record type " << event.type_;
+    }
+  }
+}
 
-  // Dump title which contains data unit.
-  DumpTitleLine(*out_);
+void GcProfiler::Flush() {
+  MutexLock mu(Thread::Current(), *gc_profiler_lock_);
+  if (gc_prof_running_) {
+    FlushLocked();
+  }
+}
 
-  for (auto it = record_lists_.begin();
-       it != record_lists_.end(); it++) {
-    if (DumpBinary()) {
-      // Dump record type and list size when dump binary format.
-      uint32_t count = (*it)->Size();
-      if (count <= 0) {
-        continue;
-      }
-      RecordType record_type = (*it)->GetRecordType();
-      out_->write(reinterpret_cast<char*>(&count), sizeof(uint32_t));
-      out_->write(reinterpret_cast<char*>(&record_type), sizeof(uint32_t));
-      out_->flush();
-    } else {
-      // Dump Headers for record.
-      (*it)->DumpHeader(*out_);
+// Write the last GC record, the histograms of the current interval and the allocation info.
+void GcProfiler::WriteFinalRecords() {
+  if (has_current_gc_record_) {
+    WriteRecord(kRecordTypeGC, &current_gc_record_, sizeof(current_gc_record_));
+    has_current_gc_record_ = false;
+  }
+  uint32_t session = session_.LoadRelaxed();
+  uint32_t bytes_allocated = revoked_bytes_allocated_;
+  uint32_t objects_allocated = revoked_objects_allocated_;
+  uint64_t dropped_records = revoked_dropped_records_ + gc_records_.GetDropped();
+  for (GcProfileThreadBuffer* buffer : thread_buffers_) {
+    dropped_records += buffer->GetRing()->GetDropped();
+    // The thread did not allocate during this profiling.
+    if (buffer->GetSession() != session) {
+      continue;
+    }
+    bytes_allocated += buffer->GetBytesAllocated();
+    objects_allocated += buffer->GetObjectsAllocated();
+    SuccAllocRecord succ_record = buffer->GetSuccAllocRecord();
+    if (!succ_record.IsEmpty()) {
+      WriteRecord(kRecordTypeSucc, &succ_record, sizeof(succ_record));
     }
-    // Dump Records.
-    (*it)->DumpRecords(*out_);
   }
-  out_->close();
+  if (dropped_records != 0) {
+    LOG(WARNING) << "GCProfile: " << dropped_records << " records dropped, ring buffers were full";
+  }
+  AllocInfoRecord alloc_info_record;
+  alloc_info_record.FillFields(profile_duration_, bytes_allocated, objects_allocated,
+                               dropped_records);
+  WriteRecord(kRecordTypeAlloc, &alloc_info_record, sizeof(alloc_info_record));
+}
+
+// Schedule the flush task if it is not already pending.
+void GcProfiler::ScheduleFlush(Thread* self) {
+  Runtime* runtime = Runtime::Current();
+  if (runtime == nullptr || !runtime->IsFinishedStarting() || runtime->IsShuttingDown(self)) {
+    return;
+  }
+  TaskProcessor* task_processor = runtime->GetHeap()->GetTaskProcessor();
+  uint32_t session;
+  {
+    MutexLock mu(self, *gc_profiler_lock_);
+    // The task processor runs the remaining tasks right away when it stops.
+    if (!gc_prof_running_ || flush_scheduled_ || !task_processor->IsRunning()) {
+      return;
+    }
+    flush_scheduled_ = true;
+    session = session_.LoadRelaxed();
+  }
+  task_processor->AddTask(self, new GcProfileFlushTask(NanoTime() + kFlushPeriodNs, session));
 }
 
-// Clear and release all records.
-void GcProfiler::ClearAndReleaseAllRecords() {
-  for (auto it = record_lists_.begin();
-       it != record_lists_.end(); it++) {
-    (*it)->ReleaseRecordsAndClear();
+// Get the buffer of the thread, creating it the first time the thread allocates.
+GcProfileThreadBuffer* GcProfiler::GetThreadBuffer(Thread* self) {
+  GcProfileThreadBuffer* buffer = self->GetGcProfileBuffer();
+  if (UNLIKELY(buffer == nullptr)) {
+    buffer = new GcProfileThreadBuffer();
+    MutexLock mu(self, *gc_profiler_lock_);
+    thread_buffers_.push_back(buffer);
+    self->SetGcProfileBuffer(buffer);
+  }
+  buffer->StartSession(session_.LoadRelaxed());
+  return buffer;
+}
+
+// Flush the records of an exiting thread and keep its counters.
+void GcProfiler::RevokeThreadBuffer(Thread* thread) {
+  GcProfileThreadBuffer* buffer = thread->GetGcProfileBuffer();
+  if (buffer == nullptr) {
+    return;
   }
-  // Clear all counters.
-  gc_id_ = 0;
-  profile_duration_ = 0;
+  {
+    MutexLock mu(Thread::Current(), *gc_profiler_lock_);
+    if (gc_prof_running_ && buffer->GetSession() == session_.LoadRelaxed()) {
+      FlushThreadBuffer(buffer);
+      SuccAllocRecord succ_record = buffer->GetSuccAllocRecord();
+      if (!succ_record.IsEmpty()) {
+        WriteRecord(kRecordTypeSucc, &succ_record, sizeof(succ_record));
+      }
+      revoked_bytes_allocated_ += buffer->GetBytesAllocated();
+      revoked_objects_allocated_ += buffer->GetObjectsAllocated();
+      revoked_dropped_records_ += buffer->GetRing()->GetDropped();
+    }
+    auto it = std::find(thread_buffers_.begin(), thread_buffers_.end(), buffer);
+    DCHECK(it != thread_buffers_.end());
+    thread_buffers_.erase(it);
+  }
+  thread->SetGcProfileBuffer(nullptr);
+  delete buffer;
 }
 
 // Update max wait time and blocking time in GC record.
 void GcProfiler::UpdateMaxWaitForGcTimeAndBlockingTime(uint64_t wait_time,
                                                        bool update_wait_time,
                                                        bool update_block_time) {
-  if (gc_prof_running_) {
-    GCRecord* record = reinterpret_cast<GCRecord*>(gc_record_list_.GetLastRecord());
-    if (record != nullptr) {
-      record->UpdateWaitAndBlockTime(wait_time, update_wait_time, update_block_time);
-    }
+  if (gc_prof_running_ && has_current_gc_record_) {
+    current_gc_record_.UpdateWaitAndBlockTime(wait_time, update_wait_time, update_block_time);
   }
 }
 
 // Sum up the time wasted in WaitForGcComplete duration two GCs.
 void GcProfiler::UpdateWastedWaitTime(uint64_t wait_time) {
-  if (gc_prof_running_) {
-    GCRecord* record = reinterpret_cast<GCRecord*>(gc_record_list_.GetLastRecord());
-    if (record != nullptr) {
-      record->UpdateWastedWaitTime(wait_time);
-    }
-  }
-}
-
-// Create allocation info record.
-void GcProfiler::CreateAllocInfoRecord() {
-  if (gc_prof_running_) {
-    AllocInfoRecord *record = new AllocInfoRecord();
-    if (record != nullptr) {
-      alloc_info_record_list_.InsertRecord(reinterpret_cast<ProfileRecord*>(record));
-    }
+  if (gc_prof_running_ && has_current_gc_record_) {
+    current_gc_record_.UpdateWastedWaitTime(wait_time);
   }
 }
 
-// Insert new GC record into record list.
+// Start a new GC record, the record of the previous GC is complete and goes to the ring.
 void GcProfiler::InsertNewGcRecord(const GcCause gc_cause, const collector::GcType gc_type,
                                    uint64_t gc_start_time_ns, uint32_t bytes_allocated, uint32_t footprint,
                                    uint32_t main_space_size, uint32_t los_space_size) {
   if (gc_prof_running_) {
-    GCRecord* record = new GCRecord();
-    if (record != nullptr) {
-      record->FillBasicInfo(gc_id_++, gc_cause, gc_type, gc_start_time_ns, footprint,
-                            bytes_allocated, main_space_size, los_space_size);
-      gc_record_list_.InsertRecord(reinterpret_cast<ProfileRecord*>(record));
-      // Create success allocation record if necessory.
-      if (prof_succ_allocation_) {
-        CreateSuccAllocRecord(record->GetGcId());
+    Thread* self = Thread::Current();
+    {
+      MutexLock mu(self, *gc_profiler_lock_);
+      if (!gc_prof_running_) {
+        return;
+      }
+      if (has_current_gc_record_) {
+        gc_records_.Push(current_gc_record_);
       }
+      current_gc_record_.FillBasicInfo(gc_id_++, gc_cause, gc_type, gc_start_time_ns, footprint,
+                                       bytes_allocated, main_space_size, los_space_size);
+      has_current_gc_record_ = true;
+      // Allocations from now on are counted in the histogram of this GC.
+      interval_.FetchAndAddSequentiallyConsistent(1);
     }
+    // The flush task could not be scheduled before the runtime finished starting.
+    ScheduleFlush(self);
   }
 }
 
 // Get gc id of current gc record.
 uint32_t GcProfiler::GetCurrentGcId() {
-  if (gc_prof_running_) {
-    GCRecord* record = reinterpret_cast<GCRecord*>(gc_record_list_.GetLastRecord());
-    if (record != nullptr) {
-      return record->GetGcId();
-    }
-  }
-  return 0;
+  // Interval i > 0 follows the start of the GC of id i - 1.
+  uint32_t interval = interval_.LoadRelaxed();
+  return interval == 0 ? 0 : interval - 1;
 }
 
 // Fill record info for the GC.
@@ -657,66 +640,32 @@ void GcProfiler::FillGcRecordInfo(collector::GarbageCollector* collector,
                                   uint32_t bytes_allocated,
                                   uint32_t main_space_size,
                                   uint32_t los_space_size) {
-  if (gc_prof_running_) {
-    GCRecord* record = reinterpret_cast<GCRecord*>(gc_record_list_.GetLastRecord());
-    if (record != nullptr) {
-      record->FillFields(collector, max_allowed_footprint, concurrent_start_bytes,
-                           alloc_stack_size, total_memory, bytes_allocated, main_space_size, los_space_size);
-    }
+  if (gc_prof_running_ && has_current_gc_record_) {
+    current_gc_record_.FillFields(collector, max_allowed_footprint, concurrent_start_bytes,
+                                  alloc_stack_size, total_memory, bytes_allocated, main_space_size,
+                                  los_space_size);
   }
 }
 
-// Create success allocation record.
-void GcProfiler::CreateSuccAllocRecord(uint32_t gc_id) {
-  if (gc_prof_running_) {
-    SuccAllocRecord* record = new SuccAllocRecord();
-    if (record != nullptr) {
-      record->SetGcId(gc_id);
-      succ_record_list_.InsertRecord(reinterpret_cast<ProfileRecord*>(record));
-    }
-  }
-}
-
-// Insert succ alloc record info in to current record.
-void GcProfiler::InsertSuccAllocRecord(uint32_t byte_count, mirror::Class* klass) {
+// Count the allocation in the histogram of the thread, without locking.
+void GcProfiler::InsertSuccAllocRecord(Thread* self, uint32_t byte_count, mirror::Class* klass) {
   if (gc_prof_running_) {
     if (prof_succ_allocation_ == false) {
       return;
     }
-    MutexLock mu(Thread::Current(), *succ_record_lock_);
-    // If no record in list, create one with gc id set to zero.
-    if (succ_record_list_.Size() == 0) {
-      CreateSuccAllocRecord(0);
-    }
-    SuccAllocRecord* record = reinterpret_cast<SuccAllocRecord*>(succ_record_list_.GetLastRecord());
-    if (record != nullptr) {
-      record->FillFields(byte_count);
-      if (byte_count >= Heap::kDefaultLargeObjectThreshold && klass->IsPrimitiveArray()) {
-        InsertLargeObjAllocRecord(record->GetGcId(), byte_count, klass);
-      }
-    }
-  }
-}
-
-// Insert large object alloction info.
-void GcProfiler::InsertLargeObjAllocRecord(uint32_t gc_id, uint32_t byte_count, mirror::Class* klass) {
-  if (gc_prof_running_) {
-    LargeObjAllocRecord *record = new LargeObjAllocRecord();
-    if (record != nullptr) {
-      record->FillFields(gc_id, byte_count, klass);
-      large_object_alloc_record_list_.InsertRecord(reinterpret_cast<ProfileRecord*>(record));
+    GcProfileThreadBuffer* buffer = GetThreadBuffer(self);
+    uint32_t interval = interval_.LoadRelaxed();
+    uint32_t gc_id = interval == 0 ? 0 : interval - 1;
+    buffer->AddSuccAlloc(gc_id, interval, byte_count);
+    if (byte_count >= Heap::kDefaultLargeObjectThreshold && klass->IsPrimitiveArray()) {
+      AllocEvent event;
+      event.type_ = kRecordTypeLarge;
+      event.large_.FillFields(gc_id, byte_count, klass);
+      buffer->PushEvent(event);
     }
   }
 }
 
-// Calaculate alloc throughput with duration.
-void GcProfiler::CalculateAllocThroughput(uint64_t duration) {
-  AllocInfoRecord* record = reinterpret_cast<AllocInfoRecord*>(alloc_info_record_list_.GetLastRecord());
-  if (record != nullptr) {
-    record->CalculateAllocThroughput(duration);
-  }
-}
-
 // Create fail allocation result.
 void GcProfiler::CreateFailRecord(mirror::Class* klass,
                                   uint32_t bytes_allocated,
@@ -724,34 +673,25 @@ void GcProfiler::CreateFailRecord(mirror::Class* klass,
                                   uint32_t alloc_size, collector::GcType gc_type,
                                   AllocFailPhase fail_phase) {
   if (gc_prof_running_) {
-    Thread* self = Thread::Current();
-    MutexLock mu(self, *fail_record_lock_);
-    uint32_t gc_id = GetCurrentGcId();
-    FailAllocRecord* record = new FailAllocRecord();
-    if (record != nullptr) {
-      record->FillFields(klass, bytes_allocated, max_allowed_footprint, alloc_size, gc_id, gc_type, fail_phase);
-      fail_record_list_.InsertRecord(reinterpret_cast<ProfileRecord*>(record));
-    }
+    AllocEvent event;
+    event.type_ = kRecordTypeFail;
+    event.fail_.FillFields(klass, bytes_allocated, max_allowed_footprint, alloc_size,
+                           GetCurrentGcId(), gc_type, fail_phase);
+    GetThreadBuffer(Thread::Current())->PushEvent(event);
   }
 }
 
 // Set max pause time, mark time and sweep time.
 void GcProfiler::SetGCTimes(uint64_t pause, uint64_t mark, uint64_t sweep) {
-  if (gc_prof_running_) {
-    GCRecord* record = reinterpret_cast<GCRecord*>(gc_record_list_.GetLastRecord());
-    if (record != nullptr) {
-      record->UpdateGCTimes(pause, mark, sweep);
-    }
+  if (gc_prof_running_ && has_current_gc_record_) {
+    current_gc_record_.UpdateGCTimes(pause, mark, sweep);
   }
 }
 
 // Add alloc info.
-void GcProfiler::AddAllocInfo(uint32_t bytes_allocated) {
+void GcProfiler::AddAllocInfo(Thread* self, uint32_t bytes_allocated) {
   if (gc_prof_running_) {
-    AllocInfoRecord* record = reinterpret_cast<AllocInfoRecord*>(alloc_info_record_list_.GetLastRecord());
-    if (record != nullptr) {
-      record->AddAllocInfo(bytes_allocated);
-    }
+    GetThreadBuffer(self)->AddAllocInfo(bytes_allocated);
   }
 }
 
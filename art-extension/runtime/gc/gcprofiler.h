@@ -17,6 +17,10 @@
 #ifndef ART_RUNTIME_GC_GCPROFILER_H_
 #define ART_RUNTIME_GC_GCPROFILER_H_
 
+#include <fstream>
+#include <vector>
+
+#include "atomic.h"
 #include "gc/heap.h"
 
 namespace art {
@@ -46,34 +50,49 @@ enum RecordType {
   kRecordTypeFail,
   kRecordTypeLarge,
   kRecordTypeAlloc,
+  kRecordTypeName,                            // Name of an enum value, see NameRecord.
+};
+
+// Enums whose values are named in the .csv file.
+enum NameKind {
+  kNameKindGcCause,
+  kNameKindGcType,
+  kNameKindAllocFailPhase,
 };
 
 std::ostream& operator<<(std::ostream& os, const AllocFailPhase& alloc_fail_phase);
 std::ostream& operator<<(std::ostream& os, const RecordType& record_type);
+std::ostream& operator<<(std::ostream& os, const NameKind& name_kind);
 
-// Base class of all records that GC Profiler dump.
-class ProfileRecord {
- public:
-  virtual void DumpRecord(std::ofstream& os) { UNUSED(os); }
-  virtual ~ProfileRecord() {}
-  // Convert time from ns to ms.
-  void ConvertTimeToMs(uint64_t& time) {
-    time = NsToMs(time);
-  }
-  // Convert size from bytes to Mb.
-  void ConvertSizeToMb(uint32_t& size) {
-    size = size / (1024 * 1024);
-  }
-  // Convert throughput from npns/bpns to npms/bpms.
-  void ConvertThroughputToMs(double& throughput_ns) {
-    throughput_ns *= 1000 * 1000;
-  }
-  // Used for InaccuratyMode.
-  virtual void ConvertDataUnits() { }
+/* The profile is streamed to a binary file, tools/gcprofile-converter.py turns it into
+* the .csv layout. The file is a GcProfileFileHeader followed by records, each one being a
+* GcProfileRecordHeader followed by one of the record classes below, stored raw. The
+* record classes are therefore plain data laid out without padding.
+*/
+static constexpr uint32_t kGcProfileMagic = 0x42504347;  // "GCPB".
+static constexpr uint32_t kGcProfileVersion = 1;
+// Set in GcProfileFileHeader::flags_ when the converter should dump size as MB, time as ms.
+static constexpr uint32_t kGcProfileFlagInaccurateMode = 1;
+
+struct GcProfileFileHeader {
+  uint32_t magic_;
+  uint32_t version_;
+  uint32_t flags_;
+  uint32_t pid_;
+};
+
+struct GcProfileRecordHeader {
+  uint32_t type_;  // RecordType.
+  uint32_t size_;  // Size of the record following the header.
 };
 
+// Number of regions divided for size distribution.
+static constexpr size_t kNumSizeDistRegions = 11;
+// Class descriptors longer than that are truncated in records.
+static constexpr size_t kRecordDescriptorLength = 128;
+
 // Record for GC info.
-class GCRecord : public ProfileRecord {
+class GCRecord {
  public:
   // File Basic info, used when generating record.
   void FillBasicInfo(uint32_t id,
@@ -119,33 +138,29 @@ class GCRecord : public ProfileRecord {
        sweep_time_ = sweep;
   }
 
-  void DumpRecord(std::ofstream& os);
-  void ConvertDataUnits();
   uint32_t GetGcId() { return id_; }
 
  private:
-  uint32_t id_;  // GC id.
-  GcCause reason_;  // Gc Cause.
+  uint64_t timestamp_;
   uint64_t pause_time_max_;  // Max pause time.
   uint64_t mark_time_;  // Max mark time.
-  uint64_t sweep_time_;  // Max sweep time.
+  uint64_t sweep_time_;  // Sweep time of the busiest sweeping worker.
   uint64_t gc_time_;  // GC duration.
+  uint64_t max_wait_time_;  // Max time wait for this GC.
+  uint64_t blocking_time_;  // Max blocking time caused by this GC.
+  uint64_t wasted_wait_time_after_gc_;  // Time exhausted in WaitForGcComplete after this GC and before next GC.
+  uint32_t id_;  // GC id.
+  uint32_t reason_;  // Gc Cause.
+  uint32_t type_;  // Type of GC.
   uint32_t free_bytes_;
   uint32_t free_object_count_;
   uint32_t free_large_object_count_;
   uint32_t free_large_object_bytes_;
-  uint64_t max_wait_time_;  // Max time wait for this GC.
-  uint64_t timestamp_;
-  collector::GcType type_;  // Type of GC.
   uint32_t max_allowed_footprint_;
   uint32_t concurrent_start_bytes_;
   uint32_t allocated_size_before_gc_;
   uint32_t allocated_size_after_gc_;  // Total bytes allocated.
   uint32_t total_object_count_in_alloc_stack_during_gc_;
-  double gc_throughput_bpns_;
-  double gc_throughput_npns_;
-  uint64_t blocking_time_;  // Max blocking time caused by this GC.
-  uint64_t wasted_wait_time_after_gc_;  // Time exhausted in WaitForGcComplete after this GC and before next GC.
   uint32_t main_space_size_before_gc_;
   uint32_t main_space_size_after_gc_;
   uint32_t los_space_size_before_gc_;
@@ -154,35 +169,29 @@ class GCRecord : public ProfileRecord {
   uint32_t footprint_size_after_gc_;  // Footprint.
 };
 
-// Successfully allocation record.
-class SuccAllocRecord : public ProfileRecord {
- private:
-  uint32_t gc_id_;
-  uint32_t total_size_;
-  uint32_t size_dist_[12];
-
+// Successfully allocation record, covering the allocations of one thread during
+// one interval between GCs. The converter sums up the records of an interval.
+class SuccAllocRecord {
  public:
-  // Insert the size distribution to allocinfo.
-  void InsertSizeDist(uint32_t size);
-  void DumpRecord(std::ofstream& os);
-  void FillFields(uint32_t byte_count);
-  void SetGcId(uint32_t id) { gc_id_ = id; }
+  void Reset(uint32_t gc_id, uint32_t interval);
+  // Region of the size distribution that the size falls in.
+  static size_t GetSizeDistRegion(uint32_t size);
+  // Copy the counts of a histogram updated concurrently.
+  void CopyCounts(uint32_t total_size, const Atomic<uint32_t>* size_dist);
   uint32_t GetGcId() { return gc_id_; }
-  void ConvertDataUnits();
-};
+  uint32_t GetInterval() { return interval_; }
+  bool IsEmpty() { return total_size_ == 0; }
 
-// Fail allocation record.
-class FailAllocRecord : public ProfileRecord {
  private:
   uint32_t gc_id_;
-  uint32_t size_;
-  AllocFailPhase phase_;
-  collector::GcType last_gc_type_;
-  char type_[256];
+  uint32_t interval_;  // Number of GCs started in the profiling before the allocations.
+  uint32_t total_size_;
+  uint32_t size_dist_[kNumSizeDistRegions + 1];
+};
 
+// Fail allocation record.
+class FailAllocRecord {
  public:
-  void DumpRecord(std::ofstream& os);
-  void ConvertDataUnits();
   void FillFields(mirror::Class* klass,
                   uint32_t bytes_allocated,
                   uint32_t max_allowed_footprint,
@@ -190,67 +199,165 @@ class FailAllocRecord : public ProfileRecord {
                   uint32_t gc_id,
                   collector::GcType gc_type,
                   AllocFailPhase fail_phase);
-};
 
-// Large object record.
-class LargeObjAllocRecord : public ProfileRecord {
  private:
   uint32_t gc_id_;
   uint32_t size_;
-  char type_[256];
+  uint32_t phase_;  // AllocFailPhase.
+  uint32_t last_gc_type_;
+  char type_[kRecordDescriptorLength];
+};
 
+// Large object record.
+class LargeObjAllocRecord {
  public:
-  void DumpRecord(std::ofstream& os);
-  void ConvertDataUnits();
   void FillFields(uint32_t gc_id, uint32_t byte_count, mirror::Class* klass);
+
+ private:
+  uint32_t gc_id_;
+  uint32_t size_;
+  char type_[kRecordDescriptorLength];
 };
 
-// Allocation info.
-class AllocInfoRecord : public ProfileRecord {
+// Allocation info, written once when the profiling stops.
+class AllocInfoRecord {
+ public:
+  void FillFields(uint64_t duration,
+                  uint32_t bytes_allocated,
+                  uint32_t objects_allocated,
+                  uint64_t dropped_records);
+
  private:
-  Atomic<uint32_t> number_bytes_alloc_atomic_;
-  // Used for data output and unit conversion.
-  uint32_t number_bytes_alloc_;
-  Atomic<uint32_t> number_objects_alloc_;
-  double throughput_npns_;
-  double throughput_bpns_;
   uint64_t duration_;
+  // Records lost because a ring buffer was full.
+  uint64_t dropped_records_;
+  uint32_t number_bytes_alloc_;
+  uint32_t number_objects_alloc_;
+};
 
+// Names the value of an enum printed in the .csv file.
+class NameRecord {
  public:
-  // Add allocation info.
-  void AddAllocInfo(uint32_t bytes_allocated);
-  void DumpRecord(std::ofstream& os);
-  void ConvertDataUnits();
-  void CalculateAllocThroughput(uint64_t duration);
-  AllocInfoRecord() : number_bytes_alloc_atomic_(0),
-                      number_bytes_alloc_(0),
-                      number_objects_alloc_(0),
-                      throughput_npns_(0.0),
-                      throughput_bpns_(0.0),
-                      duration_(0) { }
+  void FillFields(NameKind kind, uint32_t value, const std::string& name);
+
+ private:
+  uint32_t kind_;  // NameKind.
+  uint32_t value_;
+  char name_[56];
 };
 
-// Class of record list.
-class RecordList {
+static_assert(sizeof(GCRecord) == 136, "GCRecord must not be padded");
+static_assert(sizeof(SuccAllocRecord) == 60, "SuccAllocRecord must not be padded");
+static_assert(sizeof(FailAllocRecord) == 16 + kRecordDescriptorLength,
+              "FailAllocRecord must not be padded");
+static_assert(sizeof(LargeObjAllocRecord) == 8 + kRecordDescriptorLength,
+              "LargeObjAllocRecord must not be padded");
+static_assert(sizeof(AllocInfoRecord) == 24, "AllocInfoRecord must not be padded");
+static_assert(sizeof(NameRecord) == 64, "NameRecord must not be padded");
+
+// Fixed-size ring of records with one producer and one consumer, neither of which blocks.
+// When the ring is full, Push() drops the record and counts it.
+template <typename T, size_t kCapacity>
+class RecordRingBuffer {
  public:
-  void DumpRecords(std::ofstream& os);
-  void InsertRecord(ProfileRecord* record);
-  ProfileRecord* GetLastRecord();
-  void ReleaseRecordsAndClear();
-  uint32_t Size() { return record_list_.size(); }
-  void SetRecordType(RecordType record_type) {
-    record_type_ = record_type;
+  RecordRingBuffer() : head_(0), tail_(0), dropped_(0) { }
+
+  // Only called by the producer.
+  bool Push(const T& record) {
+    size_t head = head_.LoadRelaxed();
+    if (head - tail_.LoadSequentiallyConsistent() == kCapacity) {
+      dropped_.StoreRelaxed(dropped_.LoadRelaxed() + 1);
+      return false;
+    }
+    records_[head % kCapacity] = record;
+    head_.StoreRelease(head + 1);
+    return true;
   }
 
-  RecordType GetRecordType() const {
-    return record_type_;
+  // Only called by the consumer.
+  bool Pop(T* record) {
+    size_t tail = tail_.LoadRelaxed();
+    if (tail == head_.LoadSequentiallyConsistent()) {
+      return false;
+    }
+    *record = records_[tail % kCapacity];
+    tail_.StoreRelease(tail + 1);
+    return true;
+  }
+
+  // Discard the records not popped yet. Only called by the consumer.
+  void Clear() {
+    tail_.StoreRelease(head_.LoadSequentiallyConsistent());
+  }
+
+  size_t GetDropped() const {
+    return dropped_.LoadRelaxed();
+  }
+
+ private:
+  Atomic<size_t> head_;
+  Atomic<size_t> tail_;
+  Atomic<size_t> dropped_;
+  T records_[kCapacity];
+
+  DISALLOW_COPY_AND_ASSIGN(RecordRingBuffer);
+};
+
+// Record produced on the allocation path.
+struct AllocEvent {
+  uint32_t type_;  // RecordType.
+  union {
+    SuccAllocRecord succ_;
+    FailAllocRecord fail_;
+    LargeObjAllocRecord large_;
+  };
+};
+
+// GC profiling state of a thread, only written by the thread itself. The profiler
+// drains the ring and reads the counters from the thread flushing the profile.
+class GcProfileThreadBuffer {
+ public:
+  static constexpr size_t kRingCapacity = 32;
+
+  GcProfileThreadBuffer();
+
+  // Start counting for a new profiling, if it is not the one counted so far.
+  void StartSession(uint32_t session);
+  void AddAllocInfo(uint32_t bytes_allocated);
+  // Count a successful allocation in the histogram of the interval, pushing the
+  // histogram of the previous interval to the ring.
+  void AddSuccAlloc(uint32_t gc_id, uint32_t interval, uint32_t byte_count);
+  void PushEvent(const AllocEvent& event) {
+    ring_.Push(event);
   }
 
-  void DumpHeader(std::ofstream& os);
+  RecordRingBuffer<AllocEvent, kRingCapacity>* GetRing() {
+    return &ring_;
+  }
+  uint32_t GetSession() const {
+    return session_.LoadRelaxed();
+  }
+  uint32_t GetBytesAllocated() const {
+    return bytes_allocated_.LoadRelaxed();
+  }
+  uint32_t GetObjectsAllocated() const {
+    return objects_allocated_.LoadRelaxed();
+  }
+  // Snapshot of the histogram of the current interval.
+  SuccAllocRecord GetSuccAllocRecord() const;
 
  private:
-  std::vector<ProfileRecord*> record_list_;
-  RecordType record_type_;
+  RecordRingBuffer<AllocEvent, kRingCapacity> ring_;
+  Atomic<uint32_t> session_;
+  Atomic<uint32_t> bytes_allocated_;
+  Atomic<uint32_t> objects_allocated_;
+  // Histogram of the current interval. Fields are atomic for the snapshot only.
+  Atomic<uint32_t> succ_gc_id_;
+  Atomic<uint32_t> succ_interval_;
+  Atomic<uint32_t> succ_total_size_;
+  Atomic<uint32_t> succ_size_dist_[kNumSizeDistRegions + 1];
+
+  DISALLOW_COPY_AND_ASSIGN(GcProfileThreadBuffer);
 };
 
 class GcProfiler {
@@ -264,7 +371,7 @@ class GcProfiler {
                                              bool update_block_time = true);
   // Sumup the time exhausted in unnecessary WaitForGcComplete.
   void UpdateWastedWaitTime(uint64_t wait_time);
-  // Create new GCRecord and add to list.
+  // Create new GCRecord, the previous one is complete.
   void InsertNewGcRecord(const GcCause gc_cause,
                          const collector::GcType gc_type,
                          uint64_t gc_start_time_ns,
@@ -296,7 +403,7 @@ class GcProfiler {
     return &s_instance;
   }
   // Add allocation info.
-  void AddAllocInfo(uint32_t bytes_allocated);
+  void AddAllocInfo(Thread* self, uint32_t bytes_allocated);
   // Update GcProfiler's GC times.
   void SetGCTimes(uint64_t pause, uint64_t mark, uint64_t sweep);
   // Update GcProfiler's data dump dir path.
@@ -304,9 +411,14 @@ class GcProfiler {
     data_dir_ = dir;
   }
   ~GcProfiler();
-  void InsertSuccAllocRecord(uint32_t byte_count, mirror::Class* klass)
+  void InsertSuccAllocRecord(Thread* self, uint32_t byte_count, mirror::Class* klass)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
+  // Write the records buffered so far to the profile file.
+  void Flush() LOCKS_EXCLUDED(gc_profiler_lock_);
+  // Flush and release the buffer of an exiting thread.
+  void RevokeThreadBuffer(Thread* thread) LOCKS_EXCLUDED(gc_profiler_lock_);
+
   void EnableSuccAllocProfile(bool enable) {
     prof_succ_allocation_ = enable;
   }
@@ -319,11 +431,6 @@ class GcProfiler {
     return gc_prof_running_;
   }
 
-  // By default dump .csv file, leave binary options here for extension.
-  static bool DumpBinary() {
-    return dump_binary_format_;
-  }
-
   // By default, inaccurate mode dump size as MB, time as ms.
   // This can lose accuracy, leave options here for extension.
   static bool InaccurateMode() {
@@ -342,35 +449,44 @@ class GcProfiler {
   GcProfiler();
   GcProfiler(const GcProfiler&);
   GcProfiler& operator=(const GcProfiler&);
-  // Lock for start/stop gc profiling.
+  // Lock for start/stop gc profiling, flushing and the thread buffer list.
   Mutex* gc_profiler_lock_;
-  // Lock for record success allocation.
-  Mutex* succ_record_lock_;
-  // Lock for record fail allocation.
-  Mutex* fail_record_lock_;
-  // List of GCRecord.
-  std::vector<GCRecord*> GCRecordList;
-
-  RecordList gc_record_list_;
-  RecordList succ_record_list_;
-  RecordList fail_record_list_;
-  RecordList large_object_alloc_record_list_;
-  RecordList alloc_info_record_list_;
-  std::vector<RecordList*> record_lists_;
-  // Dump result as .csv file.
-  static constexpr bool dump_binary_format_ = false;
+  // Incremented by every Start(), tells the thread buffers to reset their counters.
+  Atomic<uint32_t> session_;
+  // Number of GCs started in the profiling.
+  Atomic<uint32_t> interval_;
+  // The record of the last GC, pushed to gc_records_ once the next GC starts.
+  GCRecord current_gc_record_;
+  bool has_current_gc_record_;
+  // Whether a GcProfileFlushTask of the current profiling is pending.
+  bool flush_scheduled_ GUARDED_BY(gc_profiler_lock_);
+  // Path of the profile file, removed if the result is dropped.
+  std::string file_name_;
+  // Complete GC records, pushed from the GC thread with gc_profiler_lock_ held.
+  RecordRingBuffer<GCRecord, 16> gc_records_;
+  // Buffers of the threads that allocated during a profiling.
+  std::vector<GcProfileThreadBuffer*> thread_buffers_ GUARDED_BY(gc_profiler_lock_);
+  // Counters of exited threads.
+  uint32_t revoked_bytes_allocated_ GUARDED_BY(gc_profiler_lock_);
+  uint32_t revoked_objects_allocated_ GUARDED_BY(gc_profiler_lock_);
+  uint64_t revoked_dropped_records_ GUARDED_BY(gc_profiler_lock_);
   // Dump time in ms and size in MB.
   static constexpr bool inaccurate_mode_ = true;
-  // Dump title line for csv file.
-  void DumpTitleLine(std::ofstream& out);
-  // Dump all Record info.
-  void DumpRecordLists();
-  void ClearAndReleaseAllRecords();
-  void CalculateAllocThroughput(uint64_t profile_duration);
-  void CreateSuccAllocRecord(uint32_t gc_id);
-  void InsertLargeObjAllocRecord(uint32_t gc_id, uint32_t byte_count, mirror::Class* klass);
-  void CreateAllocInfoRecord();
+
+  GcProfileThreadBuffer* GetThreadBuffer(Thread* self) LOCKS_EXCLUDED(gc_profiler_lock_);
+  // Open the profile file and write the file header and the name records.
+  bool OpenProfileFile() EXCLUSIVE_LOCKS_REQUIRED(gc_profiler_lock_);
+  void WriteRecord(RecordType type, const void* record, size_t size)
+      EXCLUSIVE_LOCKS_REQUIRED(gc_profiler_lock_);
+  void WriteNameRecords() EXCLUSIVE_LOCKS_REQUIRED(gc_profiler_lock_);
+  void FlushLocked() EXCLUSIVE_LOCKS_REQUIRED(gc_profiler_lock_);
+  void FlushThreadBuffer(GcProfileThreadBuffer* buffer) EXCLUSIVE_LOCKS_REQUIRED(gc_profiler_lock_);
+  // Write the records still held by the profiler and the threads when the profiling stops.
+  void WriteFinalRecords() EXCLUSIVE_LOCKS_REQUIRED(gc_profiler_lock_);
+  void ScheduleFlush(Thread* self);
   uint32_t GetCurrentGcId();
+
+  friend class GcProfileFlushTask;
 };
 }   // namespace gc
 }   // namespace art
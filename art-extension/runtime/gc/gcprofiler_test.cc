@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "gc/gcprofiler.h"
+
+#include "gtest/gtest.h"
+
+namespace art {
+namespace gc {
+
+TEST(GcProfilerTest, RingBufferPushPop) {
+  RecordRingBuffer<uint32_t, 4> ring;
+  uint32_t value = 0;
+  EXPECT_FALSE(ring.Pop(&value));
+  for (uint32_t i = 0; i < 4; i++) {
+    EXPECT_TRUE(ring.Push(i));
+  }
+  // The ring is full, the record is dropped.
+  EXPECT_FALSE(ring.Push(4));
+  EXPECT_EQ(1u, ring.GetDropped());
+  EXPECT_TRUE(ring.Pop(&value));
+  EXPECT_EQ(0u, value);
+  // Wrap around.
+  EXPECT_TRUE(ring.Push(5));
+  for (uint32_t expected : {1u, 2u, 3u, 5u}) {
+    EXPECT_TRUE(ring.Pop(&value));
+    EXPECT_EQ(expected, value);
+  }
+  EXPECT_FALSE(ring.Pop(&value));
+}
+
+TEST(GcProfilerTest, RingBufferClear) {
+  RecordRingBuffer<uint32_t, 4> ring;
+  EXPECT_TRUE(ring.Push(1));
+  EXPECT_TRUE(ring.Push(2));
+  ring.Clear();
+  uint32_t value = 0;
+  EXPECT_FALSE(ring.Pop(&value));
+  EXPECT_TRUE(ring.Push(3));
+  EXPECT_TRUE(ring.Pop(&value));
+  EXPECT_EQ(3u, value);
+  EXPECT_EQ(0u, ring.GetDropped());
+}
+
+TEST(GcProfilerTest, SizeDistRegion) {
+  EXPECT_EQ(0u, SuccAllocRecord::GetSizeDistRegion(1));
+  EXPECT_EQ(0u, SuccAllocRecord::GetSizeDistRegion(16));
+  EXPECT_EQ(1u, SuccAllocRecord::GetSizeDistRegion(17));
+  EXPECT_EQ(2u, SuccAllocRecord::GetSizeDistRegion(64));
+  EXPECT_EQ(9u, SuccAllocRecord::GetSizeDistRegion(8192));
+  EXPECT_EQ(kNumSizeDistRegions,
+            SuccAllocRecord::GetSizeDistRegion(Heap::kDefaultLargeObjectThreshold));
+}
+
+}  // namespace gc
+}  // namespace art
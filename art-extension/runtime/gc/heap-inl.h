@@ -127,7 +127,7 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self, mirror::Clas
     if (Runtime::Current()->EnabledGcProfile()) {
       GcProfiler* gcProfiler = GcProfiler::GetInstance();
       if (obj != nullptr && gcProfiler->ProfileSuccAllocInfo()) {
-        gcProfiler->InsertSuccAllocRecord(byte_count, klass);
+        gcProfiler->InsertSuccAllocRecord(self, byte_count, klass);
       }
     }
 
@@ -163,7 +163,7 @@ inline mirror::Object* Heap::AllocObjectWithAllocator(Thread* self, mirror::Clas
 
   if (Runtime::Current()->EnabledGcProfile()) {
     GcProfiler* gcProfiler = GcProfiler::GetInstance();
-    gcProfiler->AddAllocInfo(bytes_allocated);
+    gcProfiler->AddAllocInfo(self, bytes_allocated);
   }
 
   // TODO: Deprecate.
@@ -215,6 +215,7 @@ Heap::Heap(size_t initial_size, size_t growth_limit, size_t min_free, size_t max
       last_time_homogeneous_space_compaction_by_oom_(NanoTime()),
       pending_collector_transition_(nullptr),
       pending_heap_trim_(nullptr),
+      pending_lazy_sweep_(nullptr),
       use_homogeneous_space_compaction_for_oom_(use_homogeneous_space_compaction_for_oom),
       running_collection_is_blocking_(false),
       blocking_gc_count_(0U),
@@ -2075,6 +2076,9 @@ void Heap::ChangeCollector(CollectorType collector_type) {
     gc_plan_.clear();
     switch (collector_type_) {
       case kCollectorTypeCC: {
+        if (collector::ConcurrentCopying::kEnableGenerationalMode) {
+          gc_plan_.push_back(collector::kGcTypeSticky);
+        }
         gc_plan_.push_back(collector::kGcTypeFull);
         if (use_tlab_) {
           ChangeAllocator(kAllocatorTypeRegionTLAB);
@@ -2247,6 +2251,8 @@ void Heap::PreZygoteFork() {
   if (HasZygoteSpace()) {
     return;
   }
+  // Creating the zygote space below hands the bitmaps of the non moving space over.
+  FinishLazySweep(self);
   Runtime::Current()->GetInternTable()->SwapPostZygoteWithPreZygote();
   Runtime::Current()->GetClassLinker()->MoveClassTableToPreZygote();
   VLOG(heap) << "Starting PreZygoteFork";
@@ -2513,6 +2519,11 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type, GcCaus
         break;
       case kCollectorTypeCC:
         concurrent_copying_collector_->SetRegionSpace(region_space_);
+        // The explicit, native allocation and soft reference clearing collections evacuate the
+        // whole region space.
+        concurrent_copying_collector_->SetYoungGen(
+            gc_type == collector::kGcTypeSticky && gc_cause != kGcCauseExplicit &&
+            gc_cause != kGcCauseForNativeAlloc && !clear_soft_references && !runtime->IsZygote());
         collector = concurrent_copying_collector_;
         break;
       case kCollectorTypeMC:
@@ -2526,7 +2537,9 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type, GcCaus
       temp_space_->GetMemMap()->Protect(PROT_READ | PROT_WRITE);
       CHECK(temp_space_->IsEmpty());
     }
-    gc_type = collector::kGcTypeFull;  // TODO: Not hard code this in.
+    // TODO: Not hard code this in.
+    gc_type = collector->GetGcType() == collector::kGcTypeSticky ? collector::kGcTypeSticky :
+        collector::kGcTypeFull;
   } else if (current_allocator_ == kAllocatorTypeRosAlloc ||
       current_allocator_ == kAllocatorTypeDlMalloc) {
     collector = FindCollectorByGcType(gc_type);
@@ -2554,6 +2567,7 @@ collector::GcType Heap::CollectGarbageInternal(collector::GcType gc_type, GcCaus
   collector->Run(gc_cause, clear_soft_references || runtime->IsZygote());
   total_objects_freed_ever_ += GetCurrentGcIteration()->GetFreedObjects();
   total_bytes_freed_ever_ += GetCurrentGcIteration()->GetFreedBytes();
+  RequestLazySweep(self);
   RequestTrim(self);
   // Enqueue cleared references.
   reference_processor_.EnqueueClearedReferences(self);
@@ -3421,8 +3435,15 @@ void Heap::GrowForUtilization(collector::GarbageCollector* collector_ran,
   } else {
     collector::GcType non_sticky_gc_type =
         HasZygoteSpace() ? collector::kGcTypePartial : collector::kGcTypeFull;
-    // Find what the next non sticky collector will be.
-    collector::GarbageCollector* non_sticky_collector = FindCollectorByGcType(non_sticky_gc_type);
+    // Find what the next non sticky collector will be. The concurrent copying collector does
+    // both the young-generation and the full collections.
+    collector::GarbageCollector* non_sticky_collector;
+    if (collector_ran == concurrent_copying_collector_) {
+      non_sticky_gc_type = collector::kGcTypeFull;
+      non_sticky_collector = concurrent_copying_collector_;
+    } else {
+      non_sticky_collector = FindCollectorByGcType(non_sticky_gc_type);
+    }
     // If the throughput of the current sticky GC >= throughput of the non sticky collector, then
     // do another sticky collection next.
     // We also check that the bytes allocated aren't over the footprint limit in order to prevent a
@@ -3682,6 +3703,60 @@ void Heap::RequestTrim(Thread* self) {
   task_processor_->AddTask(self, added_task);
 }
 
+class Heap::LazySweepTask : public HeapTask {
+ public:
+  explicit LazySweepTask(uint64_t delta_time) : HeapTask(NanoTime() + delta_time) { }
+  virtual void Run(Thread* self) OVERRIDE {
+    gc::Heap* heap = Runtime::Current()->GetHeap();
+    heap->SweepPendingRuns(self);
+    heap->ClearPendingLazySweep(self);
+  }
+};
+
+void Heap::ClearPendingLazySweep(Thread* self) {
+  MutexLock mu(self, *pending_task_lock_);
+  pending_lazy_sweep_ = nullptr;
+}
+
+void Heap::RequestLazySweep(Thread* self) {
+  if (rosalloc_space_ == nullptr || !rosalloc_space_->GetRosAlloc()->HasLazySweep() ||
+      !CanAddHeapTask(self)) {
+    return;
+  }
+  LazySweepTask* added_task = nullptr;
+  {
+    MutexLock mu(self, *pending_task_lock_);
+    if (pending_lazy_sweep_ != nullptr) {
+      // Already have a lazy sweep request in task processor, ignore this request.
+      return;
+    }
+    added_task = new LazySweepTask(kLazySweepWait);
+    pending_lazy_sweep_ = added_task;
+  }
+  task_processor_->AddTask(self, added_task);
+}
+
+void Heap::SweepPendingRuns(Thread* self) {
+  {
+    ScopedThreadStateChange tsc(self, kWaitingForGcToComplete);
+    // Pretend we are doing a GC to prevent background compaction from deleting the space we are
+    // sweeping. A GC that runs first finishes the lazy sweep itself.
+    MutexLock mu(self, *gc_complete_lock_);
+    WaitForGcToCompleteLocked(kGcCauseLazySweep, self);
+    SetCollectorTypeRunning(kCollectorTypeLazySweep);
+  }
+  ATRACE_BEGIN(__FUNCTION__);
+  size_t num_runs = 0;
+  for (const auto& space : continuous_spaces_) {
+    if (space->IsRosAllocSpace()) {
+      num_runs += space->AsRosAllocSpace()->GetRosAlloc()->SweepPendingRuns(self);
+    }
+  }
+  ATRACE_END();
+  VLOG(heap) << "Lazily swept " << num_runs << " runs";
+  FinishGC(self, collector::kGcTypeNone);
+}
+
 void Heap::RevokeThreadLocalBuffers(Thread* thread, bool record_free) {
   if (rosalloc_space_ != nullptr) {
     size_t freed_bytes_revoke = rosalloc_space_->RevokeThreadLocalBuffers(thread);
@@ -3831,6 +3906,10 @@ void Heap::ClearMarkedObjects() {
   for (const auto& space : GetContinuousSpaces()) {
     accounting::ContinuousSpaceBitmap* mark_bitmap = space->GetMarkBitmap();
     if (space->GetLiveBitmap() != mark_bitmap) {
+      if (space->IsRosAllocSpace() && space->AsRosAllocSpace()->GetRosAlloc()->HasLazySweep()) {
+        // The lazy sweep still reads the dead objects from it.
+        continue;
+      }
       mark_bitmap->Clear();
     }
   }
@@ -3840,6 +3919,17 @@ void Heap::ClearMarkedObjects() {
   }
 }
 
+void Heap::FinishLazySweep(Thread* self) {
+  for (const auto& space : continuous_spaces_) {
+    if (space->IsRosAllocSpace() &&
+        space->AsRosAllocSpace()->GetRosAlloc()->FinishLazySweep(self)) {
+      // ClearMarkedObjects() left the mark bitmap to the lazy sweep.
+      WriterMutexLock mu(self, *Locks::heap_bitmap_lock_);
+      space->GetMarkBitmap()->Clear();
+    }
+  }
+}
+
 // Based on debug malloc logic from libc/bionic/debug_stacktrace.cpp.
 class StackCrawlState {
  public:
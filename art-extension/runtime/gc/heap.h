@@ -165,6 +165,9 @@ class Heap {
 
   // How often we allow heap trimming to happen (nanoseconds).
   static constexpr uint64_t kHeapTrimWait = MsToNs(5000);
+  // How long after a GC we sweep the runs it left to the lazy sweep in the background
+  // (nanoseconds).
+  static constexpr uint64_t kLazySweepWait = MsToNs(100);
   // How long we wait after a transition request to perform a collector transition (nanoseconds).
   static constexpr uint64_t kCollectorTransitionWait = MsToNs(5000);
 
@@ -293,8 +296,13 @@ class Heap {
   void DecrementDisableMovingGC(Thread* self);
 
   // Clear all of the mark bits, doesn't clear bitmaps which have the same live bits as mark bits.
+  // The mark bitmaps a lazy sweep still reads are cleared by FinishLazySweep().
   void ClearMarkedObjects() EXCLUSIVE_LOCKS_REQUIRED(Locks::heap_bitmap_lock_);
 
+  // Sweep the RosAlloc runs the last GC left to the lazy sweep and clear the mark bitmaps it kept.
+  // Must be called before the bitmaps of the RosAlloc spaces are used again.
+  void FinishLazySweep(Thread* self) LOCKS_EXCLUDED(Locks::heap_bitmap_lock_);
+
   // Initiates an explicit garbage collection.
   void CollectGarbage(bool clear_soft_references);
 
@@ -636,6 +644,11 @@ class Heap {
   // Returns how many threads we should use for the current GC phase based on if we are paused,
   // whether or not we care about pauses.
   size_t GetThreadCount(bool paused) const;
+  // Returns how many threads we should use for sweeping, which runs on the ParallelGCThreads
+  // workers even though it is concurrent with the mutators.
+  size_t GetSweepThreadCount() const {
+    return GetThreadCount(true);
+  }
   accounting::ModUnionTable* FindModUnionTableFromSpace(space::Space* space);
   void AddModUnionTable(accounting::ModUnionTable* mod_union_table);
 
@@ -689,6 +702,12 @@ class Heap {
   // Request an asynchronous trim.
   void RequestTrim(Thread* self) LOCKS_EXCLUDED(pending_task_lock_);
 
+  // Sweep the RosAlloc runs the last GC left to the lazy sweep, used by the background task.
+  void SweepPendingRuns(Thread* self) LOCKS_EXCLUDED(gc_complete_lock_);
+
+  // Request an asynchronous sweep of the runs left to the lazy sweep.
+  void RequestLazySweep(Thread* self) LOCKS_EXCLUDED(pending_task_lock_);
+
   // Request asynchronous GC.
   void RequestConcurrentGC(Thread* self, bool force_full) LOCKS_EXCLUDED(pending_task_lock_);
 
@@ -718,6 +737,7 @@ class Heap {
   class ConcurrentGCTask;
   class CollectorTransitionTask;
   class HeapTrimTask;
+  class LazySweepTask;
 
   // Compact source space to target space. Returns the collector used.
   collector::GarbageCollector* Compact(space::ContinuousMemMapAllocSpace* target_space,
@@ -904,6 +924,7 @@ class Heap {
 
   void ClearConcurrentGCRequest();
   void ClearPendingTrim(Thread* self) LOCKS_EXCLUDED(pending_task_lock_);
+  void ClearPendingLazySweep(Thread* self) LOCKS_EXCLUDED(pending_task_lock_);
   void ClearPendingCollectorTransition(Thread* self) LOCKS_EXCLUDED(pending_task_lock_);
 
   // What kind of concurrency behavior is the runtime after? Currently true for concurrent mark
@@ -1226,6 +1247,7 @@ class Heap {
   // Active tasks which we can modify (change target time, desired collector type, etc..).
   CollectorTransitionTask* pending_collector_transition_ GUARDED_BY(pending_task_lock_);
   HeapTrimTask* pending_heap_trim_ GUARDED_BY(pending_task_lock_);
+  LazySweepTask* pending_lazy_sweep_ GUARDED_BY(pending_task_lock_);
 
   // Whether or not we use homogeneous space compaction to avoid OOM errors.
   bool use_homogeneous_space_compaction_for_oom_;
@@ -19,6 +19,8 @@
 
 #include "region_space.h"
 
+#include "gc/accounting/card_table-inl.h"
+
 namespace art {
 namespace gc {
 namespace space {
@@ -88,16 +90,12 @@ inline mirror::Object* RegionSpace::AllocNonvirtual(size_t num_bytes, size_t* by
         }
       }
     } else {
-      for (size_t i = 0; i < num_regions_; ++i) {
-        Region* r = &regions_[i];
-        if (r->IsFree()) {
-          r->Unfree(time_);
-          ++num_non_free_regions_;
-          obj = r->Alloc(num_bytes, bytes_allocated, usable_size, bytes_tl_bulk_allocated);
-          CHECK(obj != nullptr);
-          evac_region_ = r;
-          return obj;
-        }
+      Region* r = AllocEvacRegionLocked();
+      if (r != nullptr) {
+        obj = r->Alloc(num_bytes, bytes_allocated, usable_size, bytes_tl_bulk_allocated);
+        CHECK(obj != nullptr);
+        evac_region_ = r;
+        return obj;
       }
     }
   } else {
@@ -111,6 +109,32 @@ inline mirror::Object* RegionSpace::AllocNonvirtual(size_t num_bytes, size_t* by
   return nullptr;
 }
 
+inline mirror::Object* RegionSpace::AllocEvacGcLocal(size_t gc_thread_index, size_t num_bytes,
+                                                     size_t* bytes_allocated,
+                                                     size_t* usable_size,
+                                                     size_t* bytes_tl_bulk_allocated) {
+  DCHECK(IsAligned<kAlignment>(num_bytes));
+  if (UNLIKELY(num_bytes > kRegionSize)) {
+    return AllocLarge<true>(num_bytes, bytes_allocated, usable_size, bytes_tl_bulk_allocated);
+  }
+  DCHECK_LT(gc_thread_index, gc_local_regions_.size());
+  // Only the owning GC thread allocates in or replaces its GC-local region.
+  mirror::Object* obj = gc_local_regions_[gc_thread_index]->Alloc(
+      num_bytes, bytes_allocated, usable_size, bytes_tl_bulk_allocated);
+  if (LIKELY(obj != nullptr)) {
+    return obj;
+  }
+  MutexLock mu(Thread::Current(), region_lock_);
+  Region* r = AllocEvacRegionLocked();
+  if (r == nullptr) {
+    return nullptr;
+  }
+  gc_local_regions_[gc_thread_index] = r;
+  obj = r->Alloc(num_bytes, bytes_allocated, usable_size, bytes_tl_bulk_allocated);
+  CHECK(obj != nullptr);
+  return obj;
+}
+
 inline mirror::Object* RegionSpace::Region::Alloc(size_t num_bytes, size_t* bytes_allocated,
                                                   size_t* usable_size,
                                                   size_t* bytes_tl_bulk_allocated) {
@@ -257,6 +281,65 @@ void RegionSpace::WalkInternal(ObjectCallback* callback, void* arg) {
   }
 }
 
+template <typename Visitor>
+void RegionSpace::VisitOldObjectsOnCards(accounting::CardTable* card_table, uint8_t minimum_age,
+                                         const Visitor& visitor) {
+  // Find the old regions with a card old enough under the lock, then walk them without it so
+  // that the mutators can still get new regions. Only the collector frees regions, and nothing
+  // is allocated in the old regions outside of an evacuation.
+  std::vector<Region*> regions;
+  {
+    MutexLock mu(Thread::Current(), region_lock_);
+    for (size_t i = 0; i < num_regions_; ++i) {
+      Region* r = &regions_[i];
+      if (!r->IsOld() || !r->IsInToSpace() || r->IsLargeTail()) {
+        continue;
+      }
+      if (r->IsLarge()) {
+        if (card_table->GetCard(reinterpret_cast<mirror::Object*>(r->Begin())) >= minimum_age) {
+          regions.push_back(r);
+        }
+        continue;
+      }
+      const uint8_t* card = card_table->CardFromAddr(r->Begin());
+      const uint8_t* card_end =
+          card_table->CardFromAddr(AlignUp(r->Top(), accounting::CardTable::kCardSize));
+      while (card < card_end && *card < minimum_age) {
+        ++card;
+      }
+      if (card != card_end) {
+        regions.push_back(r);
+      }
+    }
+  }
+  for (Region* r : regions) {
+    if (r->IsLarge()) {
+      visitor(reinterpret_cast<mirror::Object*>(r->Begin()));
+      continue;
+    }
+    // The objects are only found by walking the region from its beginning, but the walk stops
+    // at the end of the last card old enough.
+    const uint8_t* card_begin = card_table->CardFromAddr(r->Begin());
+    const uint8_t* card = card_table->CardFromAddr(AlignUp(r->Top(),
+                                                           accounting::CardTable::kCardSize));
+    while (card > card_begin && *(card - 1) < minimum_age) {
+      --card;
+    }
+    uint8_t* pos = r->Begin();
+    uint8_t* end = std::min(r->Top(), reinterpret_cast<uint8_t*>(card_table->AddrFromCard(card)));
+    while (pos < end) {
+      mirror::Object* obj = reinterpret_cast<mirror::Object*>(pos);
+      if (obj->GetClass<kDefaultVerifyFlags, kWithoutReadBarrier>() == nullptr) {
+        break;
+      }
+      if (card_table->GetCard(obj) >= minimum_age) {
+        visitor(obj);
+      }
+      pos = reinterpret_cast<uint8_t*>(GetNextObject(obj));
+    }
+  }
+}
+
 inline mirror::Object* RegionSpace::GetNextObject(mirror::Object* obj) {
   const uintptr_t position = reinterpret_cast<uintptr_t>(obj) + obj->SizeOf();
   return reinterpret_cast<mirror::Object*>(RoundUp(position, kAlignment));
@@ -300,12 +383,18 @@ mirror::Object* RegionSpace::AllocLarge(size_t num_bytes, size_t* bytes_allocate
       Region* first_reg = &regions_[left];
       DCHECK(first_reg->IsFree());
       first_reg->UnfreeLarge(time_);
+      if (kForEvac) {
+        first_reg->SetOld();
+      }
       ++num_non_free_regions_;
       first_reg->SetTop(first_reg->Begin() + num_bytes);
       for (size_t p = left + 1; p < right; ++p) {
         DCHECK_LT(p, num_regions_);
         DCHECK(regions_[p].IsFree());
         regions_[p].UnfreeLargeTail(time_);
+        if (kForEvac) {
+          regions_[p].SetOld();
+        }
         ++num_non_free_regions_;
       }
       *bytes_allocated = num_bytes;
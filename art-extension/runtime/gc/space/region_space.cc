@@ -144,8 +144,11 @@ inline bool RegionSpace::Region::ShouldBeEvacuated() {
 }
 
 // Determine which regions to evacuate and mark them as
-// from-space. Mark the rest as unevacuated from-space.
-void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all) {
+// from-space. Mark the rest as unevacuated from-space. In a
+// young-generation collection, the old regions stay in the to-space
+// and the young large regions are not evacuated.
+void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all,
+                               bool young_gen) {
   ++time_;
   if (kUseTableLookupReadBarrier) {
     DCHECK(rb_table->IsAllCleared());
@@ -153,7 +156,7 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool forc
   }
   MutexLock mu(Thread::Current(), region_lock_);
   size_t num_expected_large_tails = 0;
-  bool prev_large_evacuated = false;
+  RegionType prev_large_type = RegionType::kRegionTypeNone;
   for (size_t i = 0; i < num_regions_; ++i) {
     Region* r = &regions_[i];
     RegionState state = r->State();
@@ -164,29 +167,49 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool forc
         DCHECK((state == RegionState::kRegionStateAllocated ||
                 state == RegionState::kRegionStateLarge) &&
                type == RegionType::kRegionTypeToSpace);
-        bool should_evacuate = force_evacuate_all || r->ShouldBeEvacuated();
-        if (should_evacuate) {
-          r->SetAsFromSpace();
-          DCHECK(r->IsInFromSpace());
+        if (young_gen && r->IsOld()) {
+          r->SetAsOldToSpace();
+          DCHECK(r->IsInToSpace());
+          if (kUseTableLookupReadBarrier) {
+            // Clear the rb table for to-space regions.
+            rb_table->Clear(r->Begin(), r->End());
+          }
         } else {
-          r->SetAsUnevacFromSpace();
-          DCHECK(r->IsInUnevacFromSpace());
+          bool should_evacuate;
+          if (young_gen) {
+            should_evacuate = state == RegionState::kRegionStateAllocated;
+          } else {
+            should_evacuate = force_evacuate_all || r->ShouldBeEvacuated();
+          }
+          if (should_evacuate) {
+            r->SetAsFromSpace();
+            DCHECK(r->IsInFromSpace());
+          } else {
+            r->SetAsUnevacFromSpace();
+            DCHECK(r->IsInUnevacFromSpace());
+          }
         }
         if (UNLIKELY(state == RegionState::kRegionStateLarge &&
                      type == RegionType::kRegionTypeToSpace)) {
-          prev_large_evacuated = should_evacuate;
+          prev_large_type = r->Type();
           num_expected_large_tails = RoundUp(r->BytesAllocated(), kRegionSize) / kRegionSize - 1;
           DCHECK_GT(num_expected_large_tails, 0U);
         }
       } else {
         DCHECK(state == RegionState::kRegionStateLargeTail &&
                type == RegionType::kRegionTypeToSpace);
-        if (prev_large_evacuated) {
+        if (prev_large_type == RegionType::kRegionTypeFromSpace) {
           r->SetAsFromSpace();
           DCHECK(r->IsInFromSpace());
-        } else {
+        } else if (prev_large_type == RegionType::kRegionTypeUnevacFromSpace) {
           r->SetAsUnevacFromSpace();
           DCHECK(r->IsInUnevacFromSpace());
+        } else {
+          DCHECK(prev_large_type == RegionType::kRegionTypeToSpace);
+          r->SetAsOldToSpace();
+          if (kUseTableLookupReadBarrier) {
+            rb_table->Clear(r->Begin(), r->End());
+          }
         }
         --num_expected_large_tails;
       }
@@ -200,6 +223,26 @@ void RegionSpace::SetFromSpace(accounting::ReadBarrierTable* rb_table, bool forc
   }
   current_region_ = &full_region_;
   evac_region_ = &full_region_;
+  std::fill(gc_local_regions_.begin(), gc_local_regions_.end(), &full_region_);
+}
+
+void RegionSpace::SetNumGcLocalRegions(size_t num_gc_threads) {
+  MutexLock mu(Thread::Current(), region_lock_);
+  gc_local_regions_.assign(num_gc_threads, &full_region_);
+}
+
+RegionSpace::Region* RegionSpace::AllocEvacRegionLocked() {
+  for (size_t i = 0; i < num_regions_; ++i) {
+    Region* r = &regions_[i];
+    if (r->IsFree()) {
+      r->Unfree(time_);
+      // Evacuated objects survived the collection.
+      r->SetOld();
+      ++num_non_free_regions_;
+      return r;
+    }
+  }
+  return nullptr;
 }
 
 void RegionSpace::ClearFromSpace() {
@@ -211,9 +254,11 @@ void RegionSpace::ClearFromSpace() {
       --num_non_free_regions_;
     } else if (r->IsInUnevacFromSpace()) {
       r->SetUnevacFromSpaceAsToSpace();
+      r->SetOld();
     }
   }
   evac_region_ = nullptr;
+  gc_local_regions_.clear();
 }
 
 void RegionSpace::AssertAllRegionLiveBytesZeroOrCleared() {
@@ -278,6 +323,7 @@ void RegionSpace::Clear() {
   }
   current_region_ = &full_region_;
   evac_region_ = &full_region_;
+  std::fill(gc_local_regions_.begin(), gc_local_regions_.end(), &full_region_);
 }
 
 void RegionSpace::Dump(std::ostream& os) const {
@@ -413,7 +459,8 @@ void RegionSpace::Region::Dump(std::ostream& os) const {
      << " state=" << static_cast<uint>(state_) << " type=" << static_cast<uint>(type_)
      << " objects_allocated=" << objects_allocated_
      << " alloc_time=" << alloc_time_ << " live_bytes=" << live_bytes_
-     << " is_newly_allocated=" << is_newly_allocated_ << " is_a_tlab=" << is_a_tlab_ << " thread=" << thread_ << "\n";
+     << " is_newly_allocated=" << is_newly_allocated_ << " is_old=" << is_old_
+     << " is_a_tlab=" << is_a_tlab_ << " thread=" << thread_ << "\n";
 }
 
 }  // namespace space
@@ -17,6 +17,7 @@
 #ifndef ART_RUNTIME_GC_SPACE_REGION_SPACE_H_
 #define ART_RUNTIME_GC_SPACE_REGION_SPACE_H_
 
+#include "gc/accounting/card_table.h"
 #include "gc/accounting/read_barrier_table.h"
 #include "object_callbacks.h"
 #include "space.h"
@@ -57,6 +58,15 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
   mirror::Object* AllocLarge(size_t num_bytes, size_t* bytes_allocated, size_t* usable_size,
                              size_t* bytes_tl_bulk_allocated);
   void FreeLarge(mirror::Object* large_obj, size_t bytes_allocated);
+  // Evacuation by a parallel GC thread, into its own GC-local region rather than the shared
+  // evacuation region. Returns null if there is no free region left.
+  ALWAYS_INLINE mirror::Object* AllocEvacGcLocal(size_t gc_thread_index, size_t num_bytes,
+                                                 size_t* bytes_allocated, size_t* usable_size,
+                                                 size_t* bytes_tl_bulk_allocated)
+      LOCKS_EXCLUDED(region_lock_);
+  // Set up the GC-local regions of up to num_gc_threads parallel GC threads for the current
+  // collection. They are retired by ClearFromSpace().
+  void SetNumGcLocalRegions(size_t num_gc_threads) LOCKS_EXCLUDED(region_lock_);
 
   // Return the storage space required by obj.
   size_t AllocationSize(mirror::Object* obj, size_t* usable_size) OVERRIDE
@@ -200,7 +210,11 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     return RegionType::kRegionTypeNone;
   }
 
-  void SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all)
+  // Determine the regions to evacuate. A young-generation collection (young_gen) only
+  // collects the regions allocated since the previous collection and keeps the old regions in
+  // the to-space.
+  void SetFromSpace(accounting::ReadBarrierTable* rb_table, bool force_evacuate_all,
+                    bool young_gen)
       LOCKS_EXCLUDED(region_lock_);
 
   size_t FromSpaceSize();
@@ -215,6 +229,14 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
 
   void AssertAllRegionLiveBytesZeroOrCleared();
 
+  // Visit the objects of the old regions whose cards are at least minimum_age. Objects that
+  // survived a collection only refer to a young object through such cards. May run
+  // concurrently with the mutators, outside of an evacuation.
+  template <typename Visitor>
+  void VisitOldObjectsOnCards(accounting::CardTable* card_table, uint8_t minimum_age,
+                              const Visitor& visitor)
+      LOCKS_EXCLUDED(region_lock_) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
   void RecordAlloc(mirror::Object* ref);
   bool AllocNewTlab(Thread* self);
 
@@ -235,13 +257,13 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
           begin_(nullptr), top_(nullptr), end_(nullptr),
           state_(RegionState::kRegionStateAllocated), type_(RegionType::kRegionTypeToSpace),
           objects_allocated_(0), alloc_time_(0), live_bytes_(static_cast<size_t>(-1)),
-          is_newly_allocated_(false), is_a_tlab_(false), thread_(nullptr) {}
+          is_newly_allocated_(false), is_old_(false), is_a_tlab_(false), thread_(nullptr) {}
 
     Region(size_t idx, uint8_t* begin, uint8_t* end)
         : idx_(idx), begin_(begin), top_(begin), end_(end),
           state_(RegionState::kRegionStateFree), type_(RegionType::kRegionTypeNone),
           objects_allocated_(0), alloc_time_(0), live_bytes_(static_cast<size_t>(-1)),
-          is_newly_allocated_(false), is_a_tlab_(false), thread_(nullptr) {
+          is_newly_allocated_(false), is_old_(false), is_a_tlab_(false), thread_(nullptr) {
       DCHECK_LT(begin, end);
       DCHECK_EQ(static_cast<size_t>(end - begin), kRegionSize);
     }
@@ -266,6 +288,7 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
       }
       madvise(begin_, end_ - begin_, MADV_DONTNEED);
       is_newly_allocated_ = false;
+      is_old_ = false;
       is_a_tlab_ = false;
       thread_ = nullptr;
     }
@@ -310,6 +333,15 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
       is_newly_allocated_ = true;
     }
 
+    // Declare that the region holds objects that survived a collection.
+    void SetOld() {
+      is_old_ = true;
+    }
+
+    bool IsOld() const {
+      return is_old_;
+    }
+
     // Non-large, non-large-tail allocated.
     bool IsAllocated() const {
       return state_ == RegionState::kRegionStateAllocated;
@@ -370,6 +402,13 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
       type_ = RegionType::kRegionTypeToSpace;
     }
 
+    // Leave an old region in the to-space for a young-generation collection. Its live bytes
+    // are not computed.
+    void SetAsOldToSpace() {
+      DCHECK(!IsFree() && IsInToSpace() && IsOld());
+      live_bytes_ = static_cast<size_t>(-1);
+    }
+
     ALWAYS_INLINE bool ShouldBeEvacuated();
 
     void AddLiveBytes(size_t live_bytes) {
@@ -470,6 +509,7 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
     uint32_t alloc_time_;          // The allocation time of the region.
     size_t live_bytes_;            // The live bytes. Used to compute the live percent.
     bool is_newly_allocated_;      // True if it's allocated after the last collection.
+    bool is_old_;                  // True if it holds objects that survived a collection.
     bool is_a_tlab_;               // True if it's a tlab.
     Thread* thread_;               // The owning thread if it's a tlab.
 
@@ -506,6 +546,9 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
   mirror::Object* GetNextObject(mirror::Object* obj)
       SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
 
+  // Take a free region to evacuate objects to. Returns null if there is none.
+  Region* AllocEvacRegionLocked() EXCLUSIVE_LOCKS_REQUIRED(region_lock_);
+
   Mutex region_lock_ DEFAULT_MUTEX_ACQUIRED_AFTER;
 
   uint32_t time_;                  // The time as the number of collections since the startup.
@@ -515,6 +558,8 @@ class RegionSpace FINAL : public ContinuousMemMapAllocSpace {
                                    // The pointer to the region array.
   Region* current_region_;         // The region that's being allocated currently.
   Region* evac_region_;            // The region that's being evacuated to currently.
+  std::vector<Region*> gc_local_regions_;
+                                   // The regions that the parallel GC threads evacuate to.
   Region full_region_;             // The dummy/sentinel region that looks full.
 
   DISALLOW_COPY_AND_ASSIGN(RegionSpace);
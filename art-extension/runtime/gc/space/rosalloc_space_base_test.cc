@@ -16,6 +16,14 @@
 
 #include "space_test.h"
 
+#include <set>
+#include <vector>
+
+#include "gc/allocator/rosalloc.h"
+#include "gc/collector/garbage_collector.h"
+#include "gc/heap.h"
+#include "gc/object_byte_pair.h"
+
 namespace art {
 namespace gc {
 namespace space {
@@ -28,6 +36,145 @@ MallocSpace* CreateRosAllocSpace(const std::string& name, size_t initial_size, s
 
 TEST_SPACE_CREATE_FN_BASE(RosAllocSpace, CreateRosAllocSpace)
 
+class RosAllocSpaceLazySweepTest : public SpaceTest {
+ protected:
+  // A size of the thread-local brackets.
+  static constexpr size_t kObjectSize = 64;
+
+  // Creates the heap's RosAlloc space and fills one run of it, of which every other object is
+  // dead.
+  RosAllocSpace* FillRun(Thread* self) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    MallocSpace* space = CreateRosAllocSpace("test", 4 * MB, 16 * MB, 16 * MB, nullptr);
+    CHECK(space != nullptr);
+    // Make space findable to the heap, will also delete space when runtime is cleaned up
+    AddSpace(space);
+    size_t dummy;
+    std::vector<mirror::Object*> run_objects;
+    mirror::Object* obj = Alloc(space, self, kObjectSize, &dummy, nullptr, &dummy);
+    while (true) {
+      CHECK(obj != nullptr);
+      run_objects.push_back(obj);
+      mirror::Object* next = Alloc(space, self, kObjectSize, &dummy, nullptr, &dummy);
+      if (reinterpret_cast<uintptr_t>(next) != reinterpret_cast<uintptr_t>(obj) + kObjectSize) {
+        // The slots of a new run are handed out in address order: `next` is in another run and
+        // the run of `run_objects` is full.
+        space->Free(self, next);
+        break;
+      }
+      obj = next;
+    }
+    // Only the run of `run_objects` is left, and not as a thread-local run.
+    space->RevokeAllThreadLocalBuffers();
+    for (size_t i = 0; i != run_objects.size(); ++i) {
+      space->GetLiveBitmap()->Set(run_objects[i]);
+      if (i % 2 == 0) {
+        space->GetMarkBitmap()->Set(run_objects[i]);
+        live_objects_.push_back(run_objects[i]);
+      } else {
+        dead_objects_.push_back(run_objects[i]);
+      }
+    }
+    CHECK(!dead_objects_.empty());
+    return space->AsRosAllocSpace();
+  }
+
+  // Sweeps the space the way a full mark sweep does after marking the live objects.
+  ObjectBytePair SweepLazily(RosAllocSpace* space) SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    Heap* heap = Runtime::Current()->GetHeap();
+    allocator::RosAlloc* rosalloc = space->GetRosAlloc();
+    rosalloc->SetPageMapSizeSnapshot();
+    ObjectBytePair freed = rosalloc->SweepWalkPagemap(false, 1u, nullptr, true);
+    WriterMutexLock mu(Thread::Current(), *Locks::heap_bitmap_lock_);
+    accounting::ContinuousSpaceBitmap* live_bitmap = space->GetLiveBitmap();
+    accounting::ContinuousSpaceBitmap* mark_bitmap = space->GetMarkBitmap();
+    heap->GetLiveBitmap()->ReplaceBitmap(live_bitmap, mark_bitmap);
+    heap->GetMarkBitmap()->ReplaceBitmap(mark_bitmap, live_bitmap);
+    space->SwapBitmaps();
+    heap->ClearMarkedObjects();
+    return freed;
+  }
+
+  std::vector<mirror::Object*> live_objects_;
+  std::vector<mirror::Object*> dead_objects_;
+};
+
+TEST_F(RosAllocSpaceLazySweepTest, AllocFromPendingRun) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  RosAllocSpace* space = FillRun(self);
+  ObjectBytePair freed = SweepLazily(space);
+  EXPECT_EQ(dead_objects_.size(), freed.objects);
+  EXPECT_EQ(dead_objects_.size() * kObjectSize, static_cast<size_t>(freed.bytes));
+  EXPECT_TRUE(space->GetRosAlloc()->HasLazySweep());
+
+  // No other run has free slots of this size: the allocations sweep the pending run and get
+  // its dead slots.
+  std::set<mirror::Object*> dead_objects(dead_objects_.begin(), dead_objects_.end());
+  for (size_t i = 0; i != dead_objects_.size(); ++i) {
+    size_t dummy;
+    mirror::Object* obj = Alloc(space, self, kObjectSize, &dummy, nullptr, &dummy);
+    EXPECT_EQ(1u, dead_objects.erase(obj)) << obj;
+  }
+  EXPECT_TRUE(dead_objects.empty());
+  mirror::Class* byte_array_class = GetByteArrayClass(self);
+  for (mirror::Object* obj : live_objects_) {
+    EXPECT_EQ(byte_array_class, obj->GetClass());
+  }
+  EXPECT_EQ(0u, space->GetRosAlloc()->SweepPendingRuns(self));
+}
+
+TEST_F(RosAllocSpaceLazySweepTest, FinishLazySweep) {
+  Thread* self = Thread::Current();
+  ScopedObjectAccess soa(self);
+  RosAllocSpace* space = FillRun(self);
+  uint64_t objects_allocated = space->GetObjectsAllocated();
+  uint64_t bytes_allocated = space->GetBytesAllocated();
+  ObjectBytePair freed = SweepLazily(space);
+  EXPECT_EQ(dead_objects_.size(), freed.objects);
+  EXPECT_EQ(dead_objects_.size() * kObjectSize, static_cast<size_t>(freed.bytes));
+
+  // ClearMarkedObjects() left the bitmap the lazy sweep reads the dead objects from.
+  allocator::RosAlloc* rosalloc = space->GetRosAlloc();
+  EXPECT_TRUE(rosalloc->HasLazySweep());
+  for (mirror::Object* obj : dead_objects_) {
+    EXPECT_TRUE(space->GetMarkBitmap()->Test(obj));
+    EXPECT_FALSE(space->GetLiveBitmap()->Test(obj));
+  }
+
+  // What the next GC does first.
+  Runtime::Current()->GetHeap()->FinishLazySweep(self);
+  EXPECT_FALSE(rosalloc->HasLazySweep());
+  EXPECT_FALSE(rosalloc->FinishLazySweep(self));
+  EXPECT_EQ(0u, rosalloc->SweepPendingRuns(self));
+  for (mirror::Object* obj : dead_objects_) {
+    EXPECT_FALSE(space->GetMarkBitmap()->Test(obj));
+  }
+  for (mirror::Object* obj : live_objects_) {
+    EXPECT_FALSE(space->GetMarkBitmap()->Test(obj));
+    EXPECT_TRUE(space->GetLiveBitmap()->Test(obj));
+  }
+  EXPECT_EQ(objects_allocated - freed.objects, space->GetObjectsAllocated());
+  EXPECT_EQ(bytes_allocated - freed.bytes, space->GetBytesAllocated());
+}
+
+TEST_F(RosAllocSpaceLazySweepTest, NextGcFinishesLazySweep) {
+  RosAllocSpace* space;
+  {
+    Thread* self = Thread::Current();
+    ScopedObjectAccess soa(self);
+    space = FillRun(self);
+    SweepLazily(space);
+    EXPECT_TRUE(space->GetRosAlloc()->HasLazySweep());
+  }
+
+  // Nothing references the objects left: the GC frees them, once the dead slots of the previous
+  // sweep are freed and its bitmap cleared.
+  Heap* heap = Runtime::Current()->GetHeap();
+  heap->CollectGarbage(false);
+  EXPECT_GE(heap->GetCurrentGcIteration()->GetFreedObjects(), live_objects_.size());
+  EXPECT_EQ(0u, space->GetObjectsAllocated());
+  EXPECT_EQ(0u, space->GetBytesAllocated());
+}
 
 }  // namespace space
 }  // namespace gc
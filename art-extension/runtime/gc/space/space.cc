@@ -20,10 +20,13 @@
 #include "space.h"
 
 #include "base/logging.h"
+#include "base/time_utils.h"
 #include "gc/accounting/heap_bitmap.h"
 #include "gc/accounting/space_bitmap-inl.h"
+#include "gc/heap.h"
 #include "runtime.h"
 #include "thread-inl.h"
+#include "thread_pool.h"
 
 namespace art {
 namespace gc {
@@ -89,21 +92,106 @@ DiscontinuousSpace::DiscontinuousSpace(const std::string& name,
   CHECK(mark_bitmap_.get() != nullptr);
 }
 
-ObjectBytePair ContinuousMemMapAllocSpace::Sweep(bool swap_bitmaps) {
+// Spaces smaller than this are swept by the GC thread alone.
+static constexpr size_t kMinParallelSweepSize = 1 * MB;
+
+class SweepSpaceRangeTask : public Task {
+ public:
+  SweepSpaceRangeTask(ContinuousMemMapAllocSpace* space, Thread* gc_thread, bool swap_bitmaps,
+                      accounting::ContinuousSpaceBitmap* live_bitmap,
+                      accounting::ContinuousSpaceBitmap* mark_bitmap, uintptr_t sweep_begin,
+                      uintptr_t sweep_end, ObjectBytePair* freed, uint64_t* sweep_time)
+      : space_(space), gc_thread_(gc_thread), swap_bitmaps_(swap_bitmaps),
+        live_bitmap_(live_bitmap), mark_bitmap_(mark_bitmap), sweep_begin_(sweep_begin),
+        sweep_end_(sweep_end), freed_(freed), sweep_time_(sweep_time) {
+  }
+
+  virtual void Finalize() {
+    delete this;
+  }
+
+  virtual void Run(Thread* self) NO_THREAD_SAFETY_ANALYSIS {
+    const uint64_t start_time = NanoTime();
+    *freed_ = space_->SweepRange(self, gc_thread_, swap_bitmaps_, live_bitmap_, mark_bitmap_,
+                                 sweep_begin_, sweep_end_);
+    *sweep_time_ = NanoTime() - start_time;
+  }
+
+ private:
+  ContinuousMemMapAllocSpace* const space_;
+  Thread* const gc_thread_;
+  const bool swap_bitmaps_;
+  accounting::ContinuousSpaceBitmap* const live_bitmap_;
+  accounting::ContinuousSpaceBitmap* const mark_bitmap_;
+  const uintptr_t sweep_begin_;
+  const uintptr_t sweep_end_;
+  ObjectBytePair* const freed_;
+  uint64_t* const sweep_time_;
+};
+
+ObjectBytePair ContinuousMemMapAllocSpace::Sweep(bool swap_bitmaps, size_t thread_count,
+                                                 std::vector<uint64_t>* worker_times) {
   accounting::ContinuousSpaceBitmap* live_bitmap = GetLiveBitmap();
   accounting::ContinuousSpaceBitmap* mark_bitmap = GetMarkBitmap();
   // If the bitmaps are bound then sweeping this space clearly won't do anything.
   if (live_bitmap == mark_bitmap) {
     return ObjectBytePair(0, 0);
   }
-  SweepCallbackContext scc(swap_bitmaps, this);
   if (swap_bitmaps) {
     std::swap(live_bitmap, mark_bitmap);
   }
+  Thread* self = Thread::Current();
+  const uintptr_t sweep_begin = reinterpret_cast<uintptr_t>(Begin());
+  const uintptr_t sweep_end = reinterpret_cast<uintptr_t>(End());
+  ThreadPool* thread_pool = Runtime::Current()->GetHeap()->GetThreadPool();
+  if (thread_count <= 1 || thread_pool == nullptr ||
+      sweep_end - sweep_begin < kMinParallelSweepSize) {
+    const uint64_t start_time = NanoTime();
+    ObjectBytePair freed = SweepRange(self, self, swap_bitmaps, live_bitmap, mark_bitmap,
+                                      sweep_begin, sweep_end);
+    if (worker_times != nullptr) {
+      worker_times->assign(1, NanoTime() - start_time);
+    }
+    return freed;
+  }
+  // Each range covers whole words of the bitmaps, which start at Begin(), so that two workers
+  // never clear bits of the same word.
+  constexpr size_t kBitmapWordSize = kObjectAlignment * kBitsPerIntPtrT;
+  const size_t range_size = RoundUp((sweep_end - sweep_begin) / thread_count + 1,
+                                    kBitmapWordSize);
+  std::vector<ObjectBytePair> freed_vector(thread_count);
+  std::vector<uint64_t> time_vector(thread_count, 0);
+  size_t i = 0;
+  for (uintptr_t range_begin = sweep_begin; range_begin < sweep_end; range_begin += range_size) {
+    const uintptr_t range_end = std::min(range_begin + range_size, sweep_end);
+    thread_pool->AddTask(self, new SweepSpaceRangeTask(this, self, swap_bitmaps, live_bitmap,
+                                                       mark_bitmap, range_begin, range_end,
+                                                       &freed_vector.at(i), &time_vector.at(i)));
+    ++i;
+  }
+  thread_pool->SetMaxActiveWorkers(thread_count - 1);
+  thread_pool->StartWorkers(self);
+  thread_pool->Wait(self, true, true);
+  thread_pool->StopWorkers(self);
+  ObjectBytePair freed(0, 0);
+  for (const ObjectBytePair& range_freed : freed_vector) {
+    freed.Add(range_freed);
+  }
+  if (worker_times != nullptr) {
+    worker_times->swap(time_vector);
+  }
+  return freed;
+}
+
+ObjectBytePair ContinuousMemMapAllocSpace::SweepRange(
+    Thread* self, Thread* gc_thread, bool swap_bitmaps,
+    accounting::ContinuousSpaceBitmap* live_bitmap,
+    accounting::ContinuousSpaceBitmap* mark_bitmap, uintptr_t sweep_begin, uintptr_t sweep_end) {
+  SweepCallbackContext scc(swap_bitmaps, this, self, gc_thread);
   // Bitmaps are pre-swapped for optimization which enables sweeping with the heap unlocked.
   accounting::ContinuousSpaceBitmap::SweepWalk(
-      *live_bitmap, *mark_bitmap, reinterpret_cast<uintptr_t>(Begin()),
-      reinterpret_cast<uintptr_t>(End()), GetSweepCallback(), reinterpret_cast<void*>(&scc));
+      *live_bitmap, *mark_bitmap, sweep_begin, sweep_end, GetSweepCallback(),
+      reinterpret_cast<void*>(&scc));
   return scc.freed;
 }
 
@@ -142,7 +230,12 @@ void ContinuousMemMapAllocSpace::SwapBitmaps() {
 }
 
 AllocSpace::SweepCallbackContext::SweepCallbackContext(bool swap_bitmaps_in, space::Space* space_in)
-    : swap_bitmaps(swap_bitmaps_in), space(space_in), self(Thread::Current()) {
+    : swap_bitmaps(swap_bitmaps_in), space(space_in), self(Thread::Current()), gc_thread(self) {
+}
+
+AllocSpace::SweepCallbackContext::SweepCallbackContext(bool swap_bitmaps_in, space::Space* space_in,
+                                                       Thread* self_in, Thread* gc_thread_in)
+    : swap_bitmaps(swap_bitmaps_in), space(space_in), self(self_in), gc_thread(gc_thread_in) {
 }
 
 }  // namespace space
@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "atomic.h"
 #include "base/macros.h"
@@ -252,9 +253,13 @@ class AllocSpace {
  protected:
   struct SweepCallbackContext {
     SweepCallbackContext(bool swap_bitmaps, space::Space* space);
+    SweepCallbackContext(bool swap_bitmaps, space::Space* space, Thread* self, Thread* gc_thread);
     const bool swap_bitmaps;
     space::Space* const space;
     Thread* const self;
+    // The thread holding the heap bitmap lock for the sweep, differs from self when sweeping on a
+    // GC worker thread.
+    Thread* const gc_thread;
     ObjectBytePair freed;
   };
 
@@ -441,7 +446,10 @@ class ContinuousMemMapAllocSpace : public MemMapSpace, public AllocSpace {
     return mark_bitmap_.get();
   }
 
-  ObjectBytePair Sweep(bool swap_bitmaps);
+  // Sweep the space, splitting the bitmap across thread_count workers of the heap thread pool.
+  // If worker_times is not null, it receives the time each worker spent sweeping.
+  ObjectBytePair Sweep(bool swap_bitmaps, size_t thread_count = 1,
+                       std::vector<uint64_t>* worker_times = nullptr);
   virtual accounting::ContinuousSpaceBitmap::SweepCallback* GetSweepCallback() = 0;
 
  protected:
@@ -455,7 +463,14 @@ class ContinuousMemMapAllocSpace : public MemMapSpace, public AllocSpace {
   }
 
  private:
+  // Sweep the objects in [sweep_begin, sweep_end) on the thread self.
+  ObjectBytePair SweepRange(Thread* self, Thread* gc_thread, bool swap_bitmaps,
+                            accounting::ContinuousSpaceBitmap* live_bitmap,
+                            accounting::ContinuousSpaceBitmap* mark_bitmap,
+                            uintptr_t sweep_begin, uintptr_t sweep_end);
+
   friend class gc::Heap;
+  friend class SweepSpaceRangeTask;
   DISALLOW_IMPLICIT_CONSTRUCTORS(ContinuousMemMapAllocSpace);
 };
 
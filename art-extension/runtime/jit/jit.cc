@@ -56,13 +56,26 @@ void Jit::AddTimingLogger(const TimingLogger& logger) {
 
 Jit::Jit()
     : jit_library_handle_(nullptr), jit_compiler_handle_(nullptr), jit_load_(nullptr),
-      jit_compile_method_(nullptr), dump_info_on_shutdown_(false),
+      jit_compile_method_(nullptr), records_receivers_(false), dump_info_on_shutdown_(false),
       cumulative_timings_("JIT timings") {
 }
 
+// Only the optimizing backend inlines from the receiver types recorded by the interpreter.
+// The JIT compiler picks its backend from the same options, the last one wins.
+static bool UsesOptimizingBackend() {
+  bool optimizing = false;
+  for (const std::string& option : Runtime::Current()->GetCompilerOptions()) {
+    if (StartsWith(option, "--compiler-backend=")) {
+      optimizing = (option == "--compiler-backend=Optimizing");
+    }
+  }
+  return optimizing;
+}
+
 Jit* Jit::Create(JitOptions* options, std::string* error_msg) {
   std::unique_ptr<Jit> jit(new Jit);
   jit->dump_info_on_shutdown_ = options->DumpJitInfoOnShutdown();
+  jit->records_receivers_ = UsesOptimizingBackend();
   if (!jit->LoadCompiler(error_msg)) {
     return nullptr;
   }
@@ -162,6 +175,15 @@ Jit::~Jit() {
   }
 }
 
+uint32_t Jit::GetInstrumentationEvents() const {
+  uint32_t events = instrumentation::Instrumentation::kMethodEntered |
+                    instrumentation::Instrumentation::kBackwardBranch;
+  if (records_receivers_) {
+    events |= instrumentation::Instrumentation::kInvokeVirtualOrInterface;
+  }
+  return events;
+}
+
 void Jit::CreateInstrumentationCache(size_t compile_threshold) {
   CHECK_GT(compile_threshold, 0U);
   Runtime* const runtime = Runtime::Current();
@@ -170,10 +192,8 @@ void Jit::CreateInstrumentationCache(size_t compile_threshold) {
   // something.
   instrumentation_cache_.reset(new jit::JitInstrumentationCache(compile_threshold));
   jit_instrumentation_listener_.reset(new jit::JitInstrumentationListener(instrumentation_cache_.get()));
-  runtime->GetInstrumentation()->AddListener(
-      jit_instrumentation_listener_.get(),
-      instrumentation::Instrumentation::kMethodEntered |
-      instrumentation::Instrumentation::kBackwardBranch);
+  runtime->GetInstrumentation()->AddListener(jit_instrumentation_listener_.get(),
+                                             GetInstrumentationEvents());
   runtime->GetThreadList()->ResumeAll();
 }
 
@@ -181,8 +201,7 @@ void Jit:: DisableInstrumentation() {
   Runtime* const runtime = Runtime::Current();
   runtime->GetThreadList()->SuspendAll(__FUNCTION__);
   runtime->GetInstrumentation()->RemoveListener(jit_instrumentation_listener_.get(),
-      instrumentation::Instrumentation::kMethodEntered |
-      instrumentation::Instrumentation::kBackwardBranch);
+                                                GetInstrumentationEvents());
   runtime->GetThreadList()->ResumeAll();
 }
 
@@ -58,6 +58,9 @@ class Jit {
   JitCodeCache* GetCodeCache() {
     return code_cache_.get();
   }
+  JitInstrumentationCache* GetInstrumentationCache() {
+    return instrumentation_cache_.get();
+  }
   void DeleteThreadPool();
   // Dump interesting info: #methods compiled, code vs data size, compile / verify cumulative
   // loggers.
@@ -70,6 +73,8 @@ class Jit {
  private:
   Jit();
   bool LoadCompiler(std::string* error_msg);
+  // The interpreter events the JIT listens to.
+  uint32_t GetInstrumentationEvents() const;
 
   // JIT compiler
   void* jit_library_handle_;
@@ -77,6 +82,8 @@ class Jit {
   void* (*jit_load_)(CompilerCallbacks**);
   void (*jit_unload_)(void*);
   bool (*jit_compile_method_)(void*, ArtMethod*, Thread*);
+  // Whether the interpreter records the receiver types of the virtual calls for the compiler.
+  bool records_receivers_;
 
   // Performance monitoring.
   bool dump_info_on_shutdown_;
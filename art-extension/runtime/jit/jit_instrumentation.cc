@@ -16,9 +16,15 @@
 
 #include "jit_instrumentation.h"
 
+#include <algorithm>
+
 #include "art_method-inl.h"
+#include "dex_instruction-inl.h"
 #include "jit.h"
 #include "jit_code_cache.h"
+#include "mirror/class-inl.h"
+#include "mirror/dex_cache.h"
+#include "mirror/object-inl.h"
 #include "scoped_thread_state_change.h"
 
 namespace art {
@@ -51,6 +57,80 @@ class JitCompileTask : public Task {
   DISALLOW_IMPLICIT_CONSTRUCTORS(JitCompileTask);
 };
 
+void InlineCache::AddReceiver(const DexFile* dex_file, uint16_t type_idx, ArtMethod* target) {
+  if (megamorphic_.LoadRelaxed()) {
+    return;
+  }
+  const size_t num_claimed = num_claimed_.LoadSequentiallyConsistent();
+  for (size_t i = 0; i < num_claimed && i < kMaxEntries; ++i) {
+    // Two threads racing on a new receiver type may both record it.
+    if (published_[i].LoadSequentiallyConsistent() && entries_[i].dex_file == dex_file &&
+        entries_[i].type_idx == type_idx) {
+      return;
+    }
+  }
+  const size_t index = num_claimed_.FetchAndAddSequentiallyConsistent(1);
+  if (index >= kMaxEntries) {
+    megamorphic_.StoreRelaxed(true);
+    return;
+  }
+  entries_[index].dex_file = dex_file;
+  entries_[index].type_idx = type_idx;
+  entries_[index].target = target;
+  published_[index].StoreRelease(true);
+}
+
+bool InlineCache::GetMonomorphicReceiver(InlineCacheEntry* entry) const {
+  const size_t num_claimed = num_claimed_.LoadSequentiallyConsistent();
+  if (megamorphic_.LoadSequentiallyConsistent() || num_claimed == 0 || num_claimed > kMaxEntries) {
+    return false;
+  }
+  for (size_t i = 0; i < num_claimed; ++i) {
+    // An entry still being filled is an unknown receiver type.
+    if (!published_[i].LoadSequentiallyConsistent() ||
+        entries_[i].dex_file != entries_[0].dex_file ||
+        entries_[i].type_idx != entries_[0].type_idx) {
+      return false;
+    }
+  }
+  *entry = entries_[0];
+  return true;
+}
+
+MethodInlineCaches::MethodInlineCaches(std::vector<uint32_t>&& dex_pcs)
+    : dex_pcs_(std::move(dex_pcs)), caches_(new InlineCache[dex_pcs_.size()]) {
+}
+
+MethodInlineCaches* MethodInlineCaches::Create(ArtMethod* method) {
+  const DexFile::CodeItem* code_item = method->GetCodeItem();
+  std::vector<uint32_t> dex_pcs;
+  for (uint32_t dex_pc = 0; dex_pc < code_item->insns_size_in_code_units_;) {
+    const Instruction* inst = Instruction::At(code_item->insns_ + dex_pc);
+    switch (inst->Opcode()) {
+      case Instruction::INVOKE_VIRTUAL:
+      case Instruction::INVOKE_VIRTUAL_RANGE:
+      case Instruction::INVOKE_VIRTUAL_QUICK:
+      case Instruction::INVOKE_VIRTUAL_RANGE_QUICK:
+      case Instruction::INVOKE_INTERFACE:
+      case Instruction::INVOKE_INTERFACE_RANGE:
+        dex_pcs.push_back(dex_pc);
+        break;
+      default:
+        break;
+    }
+    dex_pc += inst->SizeInCodeUnits();
+  }
+  return new MethodInlineCaches(std::move(dex_pcs));
+}
+
+InlineCache* MethodInlineCaches::Find(uint32_t dex_pc) const {
+  auto it = std::lower_bound(dex_pcs_.begin(), dex_pcs_.end(), dex_pc);
+  if (it == dex_pcs_.end() || *it != dex_pc) {
+    return nullptr;
+  }
+  return &caches_[it - dex_pcs_.begin()];
+}
+
 JitInstrumentationCache::JitInstrumentationCache(size_t hot_method_threshold)
     : lock_("jit instrumentation lock"), hot_method_threshold_(hot_method_threshold) {
 }
@@ -73,6 +153,54 @@ void JitInstrumentationCache::SignalCompiled(Thread* self, ArtMethod* method) {
   }
 }
 
+MethodInlineCaches* JitInstrumentationCache::CreateInlineCaches(Thread* self, ArtMethod* method) {
+  std::unique_ptr<MethodInlineCaches> caches(MethodInlineCaches::Create(method));
+  if (!method->CasInlineCaches(caches.get())) {
+    // Another thread installed the inline caches of the method first.
+    return method->GetInlineCaches();
+  }
+  MethodInlineCaches* const result = caches.get();
+  MutexLock mu(self, lock_);
+  inline_caches_.push_back(std::move(caches));
+  return result;
+}
+
+void JitInstrumentationCache::AddReceiver(Thread* self, mirror::Object* receiver,
+                                          ArtMethod* caller, uint32_t dex_pc,
+                                          ArtMethod* callee) {
+  // The receivers of the compiled methods are not needed anymore.
+  if (receiver == nullptr || caller->IsNative() ||
+      Runtime::Current()->GetJit()->GetCodeCache()->ContainsMethod(caller)) {
+    return;
+  }
+  MethodInlineCaches* caches = caller->GetInlineCaches();
+  if (caches == nullptr) {
+    caches = CreateInlineCaches(self, caller);
+  }
+  InlineCache* cache = caches->Find(dex_pc);
+  if (cache == nullptr) {
+    return;
+  }
+  mirror::Class* klass = receiver->GetClass();
+  mirror::DexCache* dex_cache = klass->IsProxyClass() ? nullptr : klass->GetDexCache();
+  if (dex_cache == nullptr) {
+    // Arrays and proxies have no dex type to record.
+    cache->SetMegamorphic();
+  } else {
+    cache->AddReceiver(dex_cache->GetDexFile(), klass->GetDexTypeIndex(), callee);
+  }
+}
+
+bool JitInstrumentationCache::GetMonomorphicReceiver(ArtMethod* caller, uint32_t dex_pc,
+                                                     InlineCacheEntry* entry) {
+  MethodInlineCaches* caches = caller->GetInlineCaches();
+  if (caches == nullptr) {
+    return false;
+  }
+  InlineCache* cache = caches->Find(dex_pc);
+  return cache != nullptr && cache->GetMonomorphicReceiver(entry);
+}
+
 void JitInstrumentationCache::AddSamples(Thread* self, ArtMethod* method, size_t count) {
   ScopedObjectAccessUnchecked soa(self);
   // Since we don't have on-stack replacement, some methods can remain in the interpreter longer
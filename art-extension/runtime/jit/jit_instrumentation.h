@@ -18,6 +18,7 @@
 #define ART_RUNTIME_JIT_JIT_INSTRUMENTATION_H_
 
 #include <unordered_map>
+#include <vector>
 
 #include "instrumentation.h"
 
@@ -37,12 +38,72 @@ namespace mirror {
 }  // namespace mirror
 class ArtField;
 class ArtMethod;
+class DexFile;
 union JValue;
 class Thread;
 
 namespace jit {
 
-// Keeps track of which methods are hot.
+// A receiver type seen at a virtual or interface call site, and the method it dispatched to.
+// The class is recorded by its dex type rather than by pointer, since a moving collector may
+// move it.
+struct InlineCacheEntry {
+  const DexFile* dex_file;
+  uint16_t type_idx;
+  ArtMethod* target;
+};
+
+// The receiver types seen by the interpreter at a virtual or interface call site. The interpreter
+// threads update it without locking: a thread claims an entry, fills it, then publishes it.
+class InlineCache {
+ public:
+  // Past this number of receiver types, the call site is megamorphic.
+  static constexpr size_t kMaxEntries = 4;
+
+  InlineCache() {}
+
+  void AddReceiver(const DexFile* dex_file, uint16_t type_idx, ArtMethod* target);
+
+  // A receiver type that cannot be recorded, e.g. an array or a proxy class.
+  void SetMegamorphic() {
+    megamorphic_.StoreRelaxed(true);
+  }
+
+  // Get the only receiver type seen at the call site. Returns false if the call site has seen
+  // no receiver yet, or several receiver types.
+  bool GetMonomorphicReceiver(InlineCacheEntry* entry) const;
+
+ private:
+  InlineCacheEntry entries_[kMaxEntries];
+  // Whether the entry has been filled by the thread that claimed it.
+  Atomic<bool> published_[kMaxEntries];
+  // The number of entries claimed, may grow past kMaxEntries when threads race.
+  AtomicInteger num_claimed_;
+  Atomic<bool> megamorphic_;
+
+  DISALLOW_COPY_AND_ASSIGN(InlineCache);
+};
+
+// The inline caches of the virtual and interface call sites of a method, sorted by dex pc. They
+// are allocated the first time the interpreter makes such a call in the method and never resized.
+class MethodInlineCaches {
+ public:
+  static MethodInlineCaches* Create(ArtMethod* method)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Returns null if there is no virtual or interface call at dex_pc.
+  InlineCache* Find(uint32_t dex_pc) const;
+
+ private:
+  explicit MethodInlineCaches(std::vector<uint32_t>&& dex_pcs);
+
+  const std::vector<uint32_t> dex_pcs_;
+  const std::unique_ptr<InlineCache[]> caches_;
+
+  DISALLOW_COPY_AND_ASSIGN(MethodInlineCaches);
+};
+
+// Keeps track of which methods are hot, and of the receivers of their virtual calls.
 class JitInstrumentationCache {
  public:
   explicit JitInstrumentationCache(size_t hot_method_threshold);
@@ -53,9 +114,24 @@ class JitInstrumentationCache {
   void CreateThreadPool();
   void DeleteThreadPool();
 
+  // Record the class of the receiver of a virtual or interface call made by the interpreter.
+  void AddReceiver(Thread* self, mirror::Object* receiver, ArtMethod* caller, uint32_t dex_pc,
+                   ArtMethod* callee)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
+  // Get the only receiver type seen at a call site. Returns false if the call site has not been
+  // executed by the interpreter, or if it has seen several receiver types.
+  bool GetMonomorphicReceiver(ArtMethod* caller, uint32_t dex_pc, InlineCacheEntry* entry)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
  private:
+  MethodInlineCaches* CreateInlineCaches(Thread* self, ArtMethod* method)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_);
+
   Mutex lock_;
   std::unordered_map<jmethodID, size_t> samples_;
+  // Owns the inline caches installed in the methods, only locked to add a method.
+  std::vector<std::unique_ptr<MethodInlineCaches>> inline_caches_;
   size_t hot_method_threshold_;
   std::unique_ptr<ThreadPool> thread_pool_;
 
@@ -97,6 +173,13 @@ class JitInstrumentationListener : public instrumentation::InstrumentationListen
     instrumentation_cache_->AddSamples(thread, method, 1);
   }
 
+  // The receiver classes are used to devirtualize the calls in the Jit.
+  virtual void InvokeVirtualOrInterface(Thread* thread, mirror::Object* this_object,
+                                        ArtMethod* caller, uint32_t dex_pc, ArtMethod* callee)
+      OVERRIDE SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+    instrumentation_cache_->AddReceiver(thread, this_object, caller, dex_pc, callee);
+  }
+
  private:
   JitInstrumentationCache* const instrumentation_cache_;
 
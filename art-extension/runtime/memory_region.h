@@ -124,49 +124,46 @@ class MemoryRegion FINAL : public ValueObject {
   // The bit at the smallest offset is the least significant bit in the
   // loaded value.  `length` must not be larger than the number of bits
   // contained in the return value (32).
-  uint32_t LoadBits(uintptr_t bit_offset, size_t length) const {
-    CHECK_LE(length, sizeof(uint32_t) * kBitsPerByte);
-    uint32_t value = 0u;
-    for (size_t i = 0; i < length; ++i) {
-      value |= LoadBit(bit_offset + i) << i;
+  ALWAYS_INLINE uint32_t LoadBits(uintptr_t bit_offset, size_t length) const {
+    DCHECK_LE(length, sizeof(uint32_t) * kBitsPerByte);
+    if (length == 0) {
+      return 0u;
     }
-    return value;
-  }
-
-  // Load 3 bits from the region starting at bit offset 'bit_offset'.
-  uint32_t Load3Bits(uintptr_t bit_offset) const {
+    // The `length` bits span at most five bytes: gather them in a 64-bit
+    // word rather than loading the bits one at a time.
     uintptr_t bit_remainder = (bit_offset & (kBitsPerByte - 1));
     uintptr_t byte_offset = (bit_offset >> kBitsPerByteLog2);
-
-    // Load the byte for the low/all bits.
-    uint8_t byte = *(ComputeInternalPointer<uint8_t>(byte_offset));
-
-    DCHECK_EQ(kBitsPerByte, 8U);
-    if (bit_remainder == 6) {
-      // 3 bits cross byte boundary: 2 bits from this byte and 1 from the next.
-      uint8_t byte2 = *ComputeInternalPointer<uint8_t>(byte_offset + 1);
-      return (byte & 0xC0) >> 6 | (byte2 & 0x01) << 2;
-    }
-
-    if (bit_remainder == 7) {
-      // 3 bits cross byte boundary: 1 bit from this byte and 2 from the next.
-      uint8_t byte2 = *ComputeInternalPointer<uint8_t>(byte_offset + 1);
-      return (byte & 0x80) >> 7 | (byte2 & 0x03) << 1;
+    size_t number_of_bytes = RoundUp(bit_remainder + length, kBitsPerByte) / kBitsPerByte;
+    DCHECK_LE(byte_offset + number_of_bytes, size());
+    const uint8_t* bytes = ComputeInternalPointer<uint8_t>(byte_offset);
+    uint64_t word = 0u;
+    for (size_t i = 0; i < number_of_bytes; ++i) {
+      word |= static_cast<uint64_t>(bytes[i]) << (i * kBitsPerByte);
     }
-
-    // 3 bits within one byte.
-    return (byte >> bit_remainder) & 0x07;
+    return static_cast<uint32_t>((word >> bit_remainder) & ((UINT64_C(1) << length) - 1));
   }
 
   // Store `value` on `length` bits in the region starting at bit offset
   // `bit_offset`.  The bit at the smallest offset is the least significant
   // bit of the stored `value`.  `value` must not be larger than `length`
   // bits.
-  void StoreBits(uintptr_t bit_offset, uint32_t value, size_t length) {
-    CHECK_LT(value, 2u << length);
-    for (size_t i = 0; i < length; ++i) {
-      bool ith_bit = value & (1 << i);
-      StoreBit(bit_offset + i, ith_bit);
+  ALWAYS_INLINE void StoreBits(uintptr_t bit_offset, uint32_t value, size_t length) {
+    DCHECK_LE(length, sizeof(uint32_t) * kBitsPerByte);
+    DCHECK_LE(static_cast<uint64_t>(value), (UINT64_C(1) << length) - 1);
+    if (length == 0) {
+      return;
+    }
+    uintptr_t bit_remainder = (bit_offset & (kBitsPerByte - 1));
+    uintptr_t byte_offset = (bit_offset >> kBitsPerByteLog2);
+    size_t number_of_bytes = RoundUp(bit_remainder + length, kBitsPerByte) / kBitsPerByte;
+    DCHECK_LE(byte_offset + number_of_bytes, size());
+    uint8_t* bytes = ComputeInternalPointer<uint8_t>(byte_offset);
+    uint64_t mask = ((UINT64_C(1) << length) - 1) << bit_remainder;
+    uint64_t bits = static_cast<uint64_t>(value) << bit_remainder;
+    for (size_t i = 0; i < number_of_bytes; ++i) {
+      uint8_t byte_mask = static_cast<uint8_t>(mask >> (i * kBitsPerByte));
+      uint8_t byte_bits = static_cast<uint8_t>(bits >> (i * kBitsPerByte));
+      bytes[i] = (bytes[i] & ~byte_mask) | byte_bits;
     }
   }
 
@@ -55,4 +55,33 @@ TEST(MemoryRegion, StoreUnaligned) {
   }
 }
 
+TEST(MemoryRegion, LoadStoreBits) {
+  const size_t n = 8;
+  uint8_t data[n] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+  MemoryRegion region(&data, n);
+
+  // Fields of various widths, crossing byte boundaries.
+  region.StoreBits(0, 5u, 3);
+  region.StoreBits(3, 0x1ffu, 9);
+  region.StoreBits(12, 0u, 0);
+  region.StoreBits(12, 0xdeadbeefu, 32);
+  region.StoreBits(44, 0x2au, 6);
+
+  ASSERT_EQ(5u, region.LoadBits(0, 3));
+  ASSERT_EQ(0x1ffu, region.LoadBits(3, 9));
+  ASSERT_EQ(0u, region.LoadBits(12, 0));
+  ASSERT_EQ(0xdeadbeefu, region.LoadBits(12, 32));
+  ASSERT_EQ(0x2au, region.LoadBits(44, 6));
+  ASSERT_EQ(0u, region.LoadBits(50, 14));
+
+  // Overwriting a field leaves its neighbours untouched.
+  region.StoreBits(3, 0u, 9);
+  ASSERT_EQ(5u, region.LoadBits(0, 3));
+  ASSERT_EQ(0u, region.LoadBits(3, 9));
+  ASSERT_EQ(0xdeadbeefu, region.LoadBits(12, 32));
+  for (size_t i = 0; i < 32; ++i) {
+    ASSERT_EQ(((0xdeadbeefu >> i) & 1u) != 0u, region.LoadBit(12 + i));
+  }
+}
+
 }  // namespace art
@@ -49,6 +49,10 @@ class MANAGED String FINAL : public Object {
     return OFFSET_OF_OBJECT_MEMBER(String, value_);
   }
 
+  static MemberOffset HashCodeOffset() {
+    return OFFSET_OF_OBJECT_MEMBER(String, hash_code_);
+  }
+
   uint16_t* GetValue() SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
     return &value_[0];
   }
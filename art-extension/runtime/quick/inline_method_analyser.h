@@ -42,6 +42,13 @@ enum InlineMethodOpcode : uint16_t {
   kIntrinsicFloatCvt,
   kIntrinsicReverseBits,
   kIntrinsicReverseBytes,
+  kIntrinsicBitCount,
+  kIntrinsicNumberOfLeadingZeros,
+  kIntrinsicNumberOfTrailingZeros,
+  kIntrinsicRotateRight,
+  kIntrinsicRotateLeft,
+  kIntrinsicHighestOneBit,
+  kIntrinsicSignum,
   kIntrinsicAbsInt,
   kIntrinsicAbsLong,
   kIntrinsicAbsFloat,
@@ -79,6 +86,8 @@ enum InlineMethodOpcode : uint16_t {
   kIntrinsicGetCharsNoCheck,
   kIntrinsicIsEmptyOrLength,
   kIntrinsicIndexOf,
+  kIntrinsicEquals,
+  kIntrinsicHashCode,
   kIntrinsicNewStringFromBytes,
   kIntrinsicNewStringFromChars,
   kIntrinsicNewStringFromString,
@@ -89,6 +98,9 @@ enum InlineMethodOpcode : uint16_t {
   kIntrinsicUnsafeGet,
   kIntrinsicUnsafePut,
   kIntrinsicSystemArrayCopyCharArray,
+  kIntrinsicSystemArrayCopy,
+  kIntrinsicArraysEquals,
+  kIntrinsicArraysFill,
 
   kInlineOpNop,
   kInlineOpReturnArg,
@@ -51,131 +51,121 @@ DexRegisterLocation DexRegisterMap::GetDexRegisterLocation(uint16_t dex_register
   return dex_register_location_catalog.GetDexRegisterLocation(location_catalog_entry_index);
 }
 
-// Loads `number_of_bytes` at the given `offset` and assemble a uint32_t. If `check_max` is true,
-// this method converts a maximum value of size `number_of_bytes` into a uint32_t 0xFFFFFFFF.
-static uint32_t LoadAt(MemoryRegion region,
-                       size_t number_of_bytes,
-                       size_t offset,
-                       bool check_max = false) {
-  if (number_of_bytes == 0u) {
-    DCHECK(!check_max);
-    return 0;
-  } else if (number_of_bytes == 1u) {
-    uint8_t value = region.LoadUnaligned<uint8_t>(offset);
-    if (check_max && value == 0xFF) {
-      return -1;
-    } else {
-      return value;
-    }
-  } else if (number_of_bytes == 2u) {
-    uint16_t value = region.LoadUnaligned<uint16_t>(offset);
-    if (check_max && value == 0xFFFF) {
-      return -1;
-    } else {
-      return value;
-    }
-  } else if (number_of_bytes == 3u) {
-    uint16_t low = region.LoadUnaligned<uint16_t>(offset);
-    uint16_t high = region.LoadUnaligned<uint8_t>(offset + sizeof(uint16_t));
-    uint32_t value = (high << 16) + low;
-    if (check_max && value == 0xFFFFFF) {
-      return -1;
-    } else {
-      return value;
-    }
-  } else {
-    DCHECK_EQ(number_of_bytes, 4u);
-    return region.LoadUnaligned<uint32_t>(offset);
+// Loads `number_of_bits` at the given `bit_offset`. If `check_max` is true, this method
+// converts a maximum value of size `number_of_bits` into a uint32_t 0xFFFFFFFF. A zero-bit
+// field reads as that maximum value.
+static ALWAYS_INLINE uint32_t LoadAt(MemoryRegion region,
+                                     size_t number_of_bits,
+                                     size_t bit_offset,
+                                     bool check_max = false) {
+  if (number_of_bits == 0u) {
+    return check_max ? -1 : 0;
   }
+  uint32_t value = region.LoadBits(bit_offset, number_of_bits);
+  if (check_max && value == (static_cast<uint32_t>(-1) >> (32u - number_of_bits))) {
+    return -1;
+  }
+  return value;
 }
 
-static void StoreAt(MemoryRegion region, size_t number_of_bytes, size_t offset, uint32_t value) {
-  if (number_of_bytes == 0u) {
-    DCHECK_EQ(value, 0u);
-  } else if (number_of_bytes == 1u) {
-    region.StoreUnaligned<uint8_t>(offset, value);
-  } else if (number_of_bytes == 2u) {
-    region.StoreUnaligned<uint16_t>(offset, value);
-  } else if (number_of_bytes == 3u) {
-    region.StoreUnaligned<uint16_t>(offset, Low16Bits(value));
-    region.StoreUnaligned<uint8_t>(offset + sizeof(uint16_t), High16Bits(value));
-  } else {
-    region.StoreUnaligned<uint32_t>(offset, value);
-    DCHECK_EQ(number_of_bytes, 4u);
+// Stores `value` on `number_of_bits` at the given `bit_offset`. If `check_max` is true,
+// 0xFFFFFFFF is stored as the maximum value of size `number_of_bits`.
+static void StoreAt(MemoryRegion region,
+                    size_t number_of_bits,
+                    size_t bit_offset,
+                    uint32_t value,
+                    bool check_max = false) {
+  if (number_of_bits == 0u) {
+    DCHECK(value == 0u || (check_max && value == static_cast<uint32_t>(-1))) << value;
+    return;
   }
+  uint32_t max = static_cast<uint32_t>(-1) >> (32u - number_of_bits);
+  if (check_max) {
+    if (value == static_cast<uint32_t>(-1)) {
+      value = max;
+    } else {
+      DCHECK_LT(value, max);
+    }
+  }
+  region.StoreBits(bit_offset, value, number_of_bits);
 }
 
 uint32_t StackMap::GetDexPc(const CodeInfo& info) const {
-  return LoadAt(region_, info.NumberOfBytesForDexPc(), info.ComputeStackMapDexPcOffset());
+  return LoadAt(region_, info.NumberOfBitsForDexPc(), info.ComputeStackMapDexPcBitOffset());
 }
 
 void StackMap::SetDexPc(const CodeInfo& info, uint32_t dex_pc) {
-  StoreAt(region_, info.NumberOfBytesForDexPc(), info.ComputeStackMapDexPcOffset(), dex_pc);
+  StoreAt(region_, info.NumberOfBitsForDexPc(), info.ComputeStackMapDexPcBitOffset(), dex_pc);
 }
 
 uint32_t StackMap::GetNativePcOffset(const CodeInfo& info) const {
-  return LoadAt(region_, info.NumberOfBytesForNativePc(), info.ComputeStackMapNativePcOffset());
+  return LoadAt(region_, info.NumberOfBitsForNativePc(), info.ComputeStackMapNativePcBitOffset());
 }
 
 void StackMap::SetNativePcOffset(const CodeInfo& info, uint32_t native_pc_offset) {
-  StoreAt(region_, info.NumberOfBytesForNativePc(), info.ComputeStackMapNativePcOffset(), native_pc_offset);
+  StoreAt(region_,
+          info.NumberOfBitsForNativePc(),
+          info.ComputeStackMapNativePcBitOffset(),
+          native_pc_offset);
 }
 
 uint32_t StackMap::GetDexRegisterMapOffset(const CodeInfo& info) const {
   return LoadAt(region_,
-                info.NumberOfBytesForDexRegisterMap(),
-                info.ComputeStackMapDexRegisterMapOffset(),
+                info.NumberOfBitsForDexRegisterMap(),
+                info.ComputeStackMapDexRegisterMapBitOffset(),
                 /* check_max */ true);
 }
 
 void StackMap::SetDexRegisterMapOffset(const CodeInfo& info, uint32_t offset) {
   StoreAt(region_,
-          info.NumberOfBytesForDexRegisterMap(),
-          info.ComputeStackMapDexRegisterMapOffset(),
-          offset);
+          info.NumberOfBitsForDexRegisterMap(),
+          info.ComputeStackMapDexRegisterMapBitOffset(),
+          offset,
+          /* check_max */ true);
 }
 
 uint32_t StackMap::GetInlineDescriptorOffset(const CodeInfo& info) const {
   if (!info.HasInlineInfo()) return kNoInlineInfo;
   return LoadAt(region_,
-                info.NumberOfBytesForInlineInfo(),
-                info.ComputeStackMapInlineInfoOffset(),
+                info.NumberOfBitsForInlineInfo(),
+                info.ComputeStackMapInlineInfoBitOffset(),
                 /* check_max */ true);
 }
 
 void StackMap::SetInlineDescriptorOffset(const CodeInfo& info, uint32_t offset) {
   DCHECK(info.HasInlineInfo());
   StoreAt(region_,
-          info.NumberOfBytesForInlineInfo(),
-          info.ComputeStackMapInlineInfoOffset(),
-          offset);
+          info.NumberOfBitsForInlineInfo(),
+          info.ComputeStackMapInlineInfoBitOffset(),
+          offset,
+          /* check_max */ true);
 }
 
 uint32_t StackMap::GetRegisterMask(const CodeInfo& info) const {
   return LoadAt(region_,
-                info.NumberOfBytesForRegisterMask(),
-                info.ComputeStackMapRegisterMaskOffset());
+                info.NumberOfBitsForRegisterMask(),
+                info.ComputeStackMapRegisterMaskBitOffset());
 }
 
 void StackMap::SetRegisterMask(const CodeInfo& info, uint32_t mask) {
   StoreAt(region_,
-          info.NumberOfBytesForRegisterMask(),
-          info.ComputeStackMapRegisterMaskOffset(),
+          info.NumberOfBitsForRegisterMask(),
+          info.ComputeStackMapRegisterMaskBitOffset(),
           mask);
 }
 
 size_t StackMap::ComputeStackMapSizeInternal(size_t stack_mask_size,
-                                             size_t number_of_bytes_for_inline_info,
-                                             size_t number_of_bytes_for_dex_map,
-                                             size_t number_of_bytes_for_dex_pc,
-                                             size_t number_of_bytes_for_native_pc,
-                                             size_t number_of_bytes_for_register_mask) {
-  return stack_mask_size
-      + number_of_bytes_for_inline_info
-      + number_of_bytes_for_dex_map
-      + number_of_bytes_for_dex_pc
-      + number_of_bytes_for_native_pc
-      + number_of_bytes_for_register_mask;
+                                             size_t number_of_bits_for_inline_info,
+                                             size_t number_of_bits_for_dex_map,
+                                             size_t number_of_bits_for_dex_pc,
+                                             size_t number_of_bits_for_native_pc,
+                                             size_t number_of_bits_for_register_mask) {
+  size_t packed_size_in_bits = number_of_bits_for_inline_info
+      + number_of_bits_for_dex_map
+      + number_of_bits_for_dex_pc
+      + number_of_bits_for_native_pc
+      + number_of_bits_for_register_mask;
+  return RoundUp(packed_size_in_bits, kBitsPerByte) / kBitsPerByte + stack_mask_size;
 }
 
 size_t StackMap::ComputeStackMapSize(size_t stack_mask_size,
@@ -188,13 +178,11 @@ size_t StackMap::ComputeStackMapSize(size_t stack_mask_size,
       stack_mask_size,
       inline_info_size == 0
           ? 0
-            // + 1 to also encode kNoInlineInfo.
-          :  CodeInfo::EncodingSizeInBytes(inline_info_size + dex_register_map_size + 1),
-      // + 1 to also encode kNoDexRegisterMap.
-      CodeInfo::EncodingSizeInBytes(dex_register_map_size + 1),
-      CodeInfo::EncodingSizeInBytes(dex_pc_max),
-      CodeInfo::EncodingSizeInBytes(native_pc_max),
-      CodeInfo::EncodingSizeInBytes(register_mask_max));
+          : CodeInfo::EncodingSizeInBits(inline_info_size + dex_register_map_size),
+      CodeInfo::EncodingSizeInBits(dex_register_map_size),
+      CodeInfo::EncodingSizeInBits(dex_pc_max),
+      CodeInfo::EncodingSizeInBits(native_pc_max),
+      CodeInfo::EncodingSizeInBits(register_mask_max));
 }
 
 MemoryRegion StackMap::GetStackMask(const CodeInfo& info) const {
@@ -236,11 +224,12 @@ void CodeInfo::Dump(std::ostream& os, uint16_t number_of_dex_registers) const {
      << ", number_of_dex_registers=" << number_of_dex_registers
      << ", number_of_stack_maps=" << number_of_stack_maps
      << ", has_inline_info=" << HasInlineInfo()
-     << ", number_of_bytes_for_inline_info=" << NumberOfBytesForInlineInfo()
-     << ", number_of_bytes_for_dex_register_map=" << NumberOfBytesForDexRegisterMap()
-     << ", number_of_bytes_for_dex_pc=" << NumberOfBytesForDexPc()
-     << ", number_of_bytes_for_native_pc=" << NumberOfBytesForNativePc()
-     << ", number_of_bytes_for_register_mask=" << NumberOfBytesForRegisterMask()
+     << ", number_of_bits_for_inline_info=" << NumberOfBitsForInlineInfo()
+     << ", number_of_bits_for_dex_register_map=" << NumberOfBitsForDexRegisterMap()
+     << ", number_of_bits_for_dex_pc=" << NumberOfBitsForDexPc()
+     << ", number_of_bits_for_native_pc=" << NumberOfBitsForNativePc()
+     << ", number_of_bits_for_register_mask=" << NumberOfBitsForRegisterMask()
+     << ", stack_map_size=" << StackMapSize()
      << ")\n";
 
   // Display the Dex register location catalog.
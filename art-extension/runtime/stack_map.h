@@ -688,11 +688,12 @@ class DexRegisterMap {
  * - Knowing the values of dex registers.
  *
  * The information is of the form:
- * [dex_pc, native_pc_offset, dex_register_map_offset, inlining_info_offset, register_mask,
+ * [register_mask, dex_pc, native_pc_offset, dex_register_map_offset, inlining_info_offset,
  * stack_mask].
  *
- * Note that register_mask is fixed size, but stack_mask is variable size, depending on the
- * stack size of a method.
+ * The first five fields are bit-packed, each on the number of bits its largest value
+ * needs in the method (see CodeInfo::SetEncoding), and the packed fields are rounded up
+ * to a byte. The stack_mask is variable size, depending on the stack size of a method.
  */
 class StackMap {
  public:
@@ -761,15 +762,15 @@ class StackMap {
 
  private:
   static size_t ComputeStackMapSizeInternal(size_t stack_mask_size,
-                                            size_t number_of_bytes_for_inline_info,
-                                            size_t number_of_bytes_for_dex_map,
-                                            size_t number_of_bytes_for_dex_pc,
-                                            size_t number_of_bytes_for_native_pc,
-                                            size_t number_of_bytes_for_register_mask);
+                                            size_t number_of_bits_for_inline_info,
+                                            size_t number_of_bits_for_dex_map,
+                                            size_t number_of_bits_for_dex_pc,
+                                            size_t number_of_bits_for_native_pc,
+                                            size_t number_of_bits_for_register_mask);
 
   // TODO: Instead of plain types such as "uint32_t", introduce
   // typedefs (and document the memory layout of StackMap).
-  static constexpr int kRegisterMaskOffset = 0;
+  static constexpr int kRegisterMaskBitOffset = 0;
   static constexpr int kFixedSize = 0;
 
   MemoryRegion region_;
@@ -782,8 +783,10 @@ class StackMap {
 /**
  * Wrapper around all compiler information collected for a method.
  * The information is of the form:
- * [overall_size, number_of_location_catalog_entries, number_of_stack_maps, stack_mask_size,
- * DexRegisterLocationCatalog+, StackMap+, DexRegisterMap+, InlineInfo*].
+ * [overall_size, encoding, number_of_location_catalog_entries, number_of_stack_maps,
+ * stack_mask_size, DexRegisterLocationCatalog+, StackMap+, DexRegisterMap+, InlineInfo*].
+ *
+ * Stack maps with identical Dex register maps or inline infos share a single copy of them.
  */
 class CodeInfo {
  public:
@@ -794,13 +797,9 @@ class CodeInfo {
     region_ = MemoryRegion(const_cast<void*>(data), size);
   }
 
-  static size_t EncodingSizeInBytes(size_t max_element) {
+  static size_t EncodingSizeInBits(size_t max_element) {
     DCHECK(IsUint<32>(max_element));
-    return (max_element == 0) ? 0
-         : IsUint<8>(max_element) ? 1
-         : IsUint<16>(max_element) ? 2
-         : IsUint<24>(max_element) ? 3
-         : 4;
+    return MinimumBitsToStore(max_element);
   }
 
   void SetEncoding(size_t inline_info_size,
@@ -808,90 +807,82 @@ class CodeInfo {
                    size_t dex_pc_max,
                    size_t native_pc_max,
                    size_t register_mask_max) {
+    uint32_t encoding = 0u;
     if (inline_info_size != 0) {
-      region_.StoreBit(kHasInlineInfoBitOffset, 1);
-      // + 1 to also encode kNoInlineInfo: if an inline info offset
-      // is at 0xFF, we want to overflow to a larger encoding, because it will
-      // conflict with kNoInlineInfo.
+      encoding |= 1u << kHasInlineInfoBitOffset;
+      // Offsets are strictly smaller than the size of the area they index, so a
+      // field of MinimumBitsToStore(size) bits always leaves its all-ones value
+      // free to encode kNoInlineInfo.
       // The offset is relative to the dex register map. TODO: Change this.
-      SetEncodingAt(kInlineInfoBitOffset,
-                    EncodingSizeInBytes(dex_register_map_size + inline_info_size + 1));
-    } else {
-      region_.StoreBit(kHasInlineInfoBitOffset, 0);
-      SetEncodingAt(kInlineInfoBitOffset, 0);
+      encoding |= EncodingSizeInBits(dex_register_map_size + inline_info_size)
+          << kInlineInfoBitOffset;
     }
-    // + 1 to also encode kNoDexRegisterMap: if a dex register map offset
-    // is at 0xFF, we want to overflow to a larger encoding, because it will
-    // conflict with kNoDexRegisterMap.
-    SetEncodingAt(kDexRegisterMapBitOffset, EncodingSizeInBytes(dex_register_map_size + 1));
-    SetEncodingAt(kDexPcBitOffset, EncodingSizeInBytes(dex_pc_max));
-    SetEncodingAt(kNativePcBitOffset, EncodingSizeInBytes(native_pc_max));
-    SetEncodingAt(kRegisterMaskBitOffset, EncodingSizeInBytes(register_mask_max));
-  }
-
-  void SetEncodingAt(size_t bit_offset, size_t number_of_bytes) {
-    // We encode the number of bytes needed for writing a value on 3 bits,
-    // for values that we know are maximum 32bits.
-    region_.StoreBit(bit_offset, (number_of_bytes & 1));
-    region_.StoreBit(bit_offset + 1, (number_of_bytes & 2));
-    region_.StoreBit(bit_offset + 2, (number_of_bytes & 4));
+    // Same for kNoDexRegisterMap. A method without any Dex register map gets a
+    // zero-bit field, which always reads as kNoDexRegisterMap.
+    encoding |= EncodingSizeInBits(dex_register_map_size) << kDexRegisterMapBitOffset;
+    encoding |= EncodingSizeInBits(dex_pc_max) << kDexPcBitOffset;
+    encoding |= EncodingSizeInBits(native_pc_max) << kNativePcBitOffset;
+    encoding |= EncodingSizeInBits(register_mask_max) << kRegisterMaskBitOffset;
+    region_.StoreUnaligned<uint32_t>(kEncodingInfoOffset, encoding);
   }
 
-  size_t GetNumberOfBytesForEncoding(size_t bit_offset) const {
-    return region_.Load3Bits(bit_offset);
+  size_t GetNumberOfBitsForEncoding(size_t bit_offset) const {
+    uint32_t encoding = region_.LoadUnaligned<uint32_t>(kEncodingInfoOffset);
+    return (encoding >> bit_offset) & ((1u << kEncodingFieldSizeInBits) - 1);
   }
 
   bool HasInlineInfo() const {
-    return region_.LoadBit(kHasInlineInfoBitOffset);
+    return (region_.LoadUnaligned<uint32_t>(kEncodingInfoOffset) >> kHasInlineInfoBitOffset) & 1u;
   }
 
-  size_t NumberOfBytesForInlineInfo() const {
-    return GetNumberOfBytesForEncoding(kInlineInfoBitOffset);
+  size_t NumberOfBitsForInlineInfo() const {
+    return GetNumberOfBitsForEncoding(kInlineInfoBitOffset);
   }
 
-  size_t NumberOfBytesForDexRegisterMap() const {
-    return GetNumberOfBytesForEncoding(kDexRegisterMapBitOffset);
+  size_t NumberOfBitsForDexRegisterMap() const {
+    return GetNumberOfBitsForEncoding(kDexRegisterMapBitOffset);
   }
 
-  size_t NumberOfBytesForRegisterMask() const {
-    return GetNumberOfBytesForEncoding(kRegisterMaskBitOffset);
+  size_t NumberOfBitsForRegisterMask() const {
+    return GetNumberOfBitsForEncoding(kRegisterMaskBitOffset);
   }
 
-  size_t NumberOfBytesForNativePc() const {
-    return GetNumberOfBytesForEncoding(kNativePcBitOffset);
+  size_t NumberOfBitsForNativePc() const {
+    return GetNumberOfBitsForEncoding(kNativePcBitOffset);
   }
 
-  size_t NumberOfBytesForDexPc() const {
-    return GetNumberOfBytesForEncoding(kDexPcBitOffset);
+  size_t NumberOfBitsForDexPc() const {
+    return GetNumberOfBitsForEncoding(kDexPcBitOffset);
   }
 
-  size_t ComputeStackMapRegisterMaskOffset() const {
-    return StackMap::kRegisterMaskOffset;
+  // Bit offsets of the packed fields within a stack map.
+  size_t ComputeStackMapRegisterMaskBitOffset() const {
+    return StackMap::kRegisterMaskBitOffset;
   }
 
-  size_t ComputeStackMapStackMaskOffset() const {
-    return ComputeStackMapRegisterMaskOffset()
-        + (NumberOfBytesForRegisterMask() * sizeof(uint8_t));
+  size_t ComputeStackMapDexPcBitOffset() const {
+    return ComputeStackMapRegisterMaskBitOffset() + NumberOfBitsForRegisterMask();
   }
 
-  size_t ComputeStackMapDexPcOffset() const {
-    return ComputeStackMapStackMaskOffset() + GetStackMaskSize();
+  size_t ComputeStackMapNativePcBitOffset() const {
+    return ComputeStackMapDexPcBitOffset() + NumberOfBitsForDexPc();
   }
 
-  size_t ComputeStackMapNativePcOffset() const {
-    return ComputeStackMapDexPcOffset()
-        + (NumberOfBytesForDexPc() * sizeof(uint8_t));
+  size_t ComputeStackMapDexRegisterMapBitOffset() const {
+    return ComputeStackMapNativePcBitOffset() + NumberOfBitsForNativePc();
   }
 
-  size_t ComputeStackMapDexRegisterMapOffset() const {
-    return ComputeStackMapNativePcOffset()
-        + (NumberOfBytesForNativePc() * sizeof(uint8_t));
+  size_t ComputeStackMapInlineInfoBitOffset() const {
+    CHECK(HasInlineInfo());
+    return ComputeStackMapDexRegisterMapBitOffset() + NumberOfBitsForDexRegisterMap();
   }
 
-  size_t ComputeStackMapInlineInfoOffset() const {
-    CHECK(HasInlineInfo());
-    return ComputeStackMapDexRegisterMapOffset()
-        + (NumberOfBytesForDexRegisterMap() * sizeof(uint8_t));
+  // The stack mask follows the packed fields, at the next byte boundary.
+  size_t ComputeStackMapStackMaskOffset() const {
+    size_t packed_size_in_bits = ComputeStackMapDexRegisterMapBitOffset()
+        + NumberOfBitsForDexRegisterMap()
+        + NumberOfBitsForInlineInfo();
+    return RoundUp(packed_size_in_bits, kBitsPerByte) / kBitsPerByte;
   }
 
   uint32_t GetDexRegisterLocationCatalogOffset() const {
@@ -950,11 +941,11 @@ class CodeInfo {
   // All stack maps of a CodeInfo have the same size.
   size_t StackMapSize() const {
     return StackMap::ComputeStackMapSizeInternal(GetStackMaskSize(),
-                                                 NumberOfBytesForInlineInfo(),
-                                                 NumberOfBytesForDexRegisterMap(),
-                                                 NumberOfBytesForDexPc(),
-                                                 NumberOfBytesForNativePc(),
-                                                 NumberOfBytesForRegisterMask());
+                                                 NumberOfBitsForInlineInfo(),
+                                                 NumberOfBitsForDexRegisterMap(),
+                                                 NumberOfBitsForDexPc(),
+                                                 NumberOfBitsForNativePc(),
+                                                 NumberOfBitsForRegisterMask());
   }
 
   // Get the size all the stack maps of this CodeInfo object, in bytes.
@@ -1015,18 +1006,23 @@ class CodeInfo {
   static constexpr int kOverallSizeOffset = 0;
   static constexpr int kEncodingInfoOffset = kOverallSizeOffset + sizeof(uint32_t);
   static constexpr int kNumberOfDexRegisterLocationCatalogEntriesOffset =
-      kEncodingInfoOffset + sizeof(uint16_t);
+      kEncodingInfoOffset + sizeof(uint32_t);
   static constexpr int kNumberOfStackMapsOffset =
       kNumberOfDexRegisterLocationCatalogEntriesOffset + sizeof(uint32_t);
   static constexpr int kStackMaskSizeOffset = kNumberOfStackMapsOffset + sizeof(uint32_t);
   static constexpr int kFixedSize = kStackMaskSizeOffset + sizeof(uint32_t);
 
-  static constexpr int kHasInlineInfoBitOffset = (kEncodingInfoOffset * kBitsPerByte);
+  // The encoding word holds the has_inline_info flag followed by the number of
+  // bits (0 to 32) of each packed stack map field.
+  static constexpr int kEncodingFieldSizeInBits = 6;
+  static constexpr int kHasInlineInfoBitOffset = 0;
   static constexpr int kInlineInfoBitOffset = kHasInlineInfoBitOffset + 1;
-  static constexpr int kDexRegisterMapBitOffset = kInlineInfoBitOffset + 3;
-  static constexpr int kDexPcBitOffset = kDexRegisterMapBitOffset + 3;
-  static constexpr int kNativePcBitOffset = kDexPcBitOffset + 3;
-  static constexpr int kRegisterMaskBitOffset = kNativePcBitOffset + 3;
+  static constexpr int kDexRegisterMapBitOffset = kInlineInfoBitOffset + kEncodingFieldSizeInBits;
+  static constexpr int kDexPcBitOffset = kDexRegisterMapBitOffset + kEncodingFieldSizeInBits;
+  static constexpr int kNativePcBitOffset = kDexPcBitOffset + kEncodingFieldSizeInBits;
+  static constexpr int kRegisterMaskBitOffset = kNativePcBitOffset + kEncodingFieldSizeInBits;
+  static_assert(kRegisterMaskBitOffset + kEncodingFieldSizeInBits <= 32,
+                "CodeInfo encoding does not fit in 32 bits");
 
   MemoryRegion GetStackMaps() const {
     return region_.size() == 0
@@ -49,6 +49,7 @@
 #include "gc_map.h"
 #include "gc/accounting/card_table-inl.h"
 #include "gc/allocator/rosalloc.h"
+#include "gc/gcprofiler.h"
 #include "gc/heap.h"
 #include "gc/space/space.h"
 #include "handle_scope-inl.h"
@@ -1522,6 +1523,7 @@ void Thread::Destroy() {
     ScopedObjectAccess soa(self);
     Runtime::Current()->GetHeap()->RevokeThreadLocalBuffers(this);
   }
+  gc::GcProfiler::GetInstance()->RevokeThreadBuffer(this);
 }
 
 Thread::~Thread() {
@@ -50,8 +50,10 @@ namespace art {
 
 namespace gc {
 namespace collector {
+  struct ConcurrentCopyingThreadState;
   class SemiSpace;
 }  // namespace collector
+  class GcProfileThreadBuffer;
 }  // namespace gc
 
 namespace mirror {
@@ -966,6 +968,22 @@ class Thread {
     return tlsPtr_.nested_signal_state;
   }
 
+  gc::GcProfileThreadBuffer* GetGcProfileBuffer() const {
+    return tlsPtr_.gc_profile_buffer;
+  }
+
+  void SetGcProfileBuffer(gc::GcProfileThreadBuffer* buffer) {
+    tlsPtr_.gc_profile_buffer = buffer;
+  }
+
+  gc::collector::ConcurrentCopyingThreadState* GetConcurrentCopyingThreadState() const {
+    return tlsPtr_.concurrent_copying_thread_state;
+  }
+
+  void SetConcurrentCopyingThreadState(gc::collector::ConcurrentCopyingThreadState* state) {
+    tlsPtr_.concurrent_copying_thread_state = state;
+  }
+
   bool IsSuspendedAtSuspendCheck() const {
     return tls32_.suspended_at_suspend_check;
   }
@@ -1181,7 +1199,8 @@ class Thread {
       last_no_thread_suspension_cause(nullptr), thread_local_start(nullptr),
       thread_local_pos(nullptr), thread_local_end(nullptr), thread_local_objects(0),
       thread_local_alloc_stack_top(nullptr), thread_local_alloc_stack_end(nullptr),
-      nested_signal_state(nullptr), flip_function(nullptr), method_verifier(nullptr) {
+      nested_signal_state(nullptr), flip_function(nullptr), method_verifier(nullptr),
+      gc_profile_buffer(nullptr), concurrent_copying_thread_state(nullptr) {
       std::fill(held_mutexes, held_mutexes + kLockLevelCount, nullptr);
     }
 
@@ -1311,6 +1330,12 @@ class Thread {
 
     // Current method verifier, used for root marking.
     verifier::MethodVerifier* method_verifier;
+
+    // Records of the GC profiler not yet flushed to the profile file.
+    gc::GcProfileThreadBuffer* gc_profile_buffer;
+
+    // The state of a parallel GC thread of the concurrent copying collector while it marks.
+    gc::collector::ConcurrentCopyingThreadState* concurrent_copying_thread_state;
   } tlsPtr_;
 
   // Guards the 'interrupted_' and 'wait_monitor_' members.
@@ -804,6 +804,13 @@ void Trace::BackwardBranch(Thread* /*thread*/, ArtMethod* method,
   LOG(ERROR) << "Unexpected backward branch event in tracing" << PrettyMethod(method);
 }
 
+void Trace::InvokeVirtualOrInterface(Thread* /*thread*/, mirror::Object* /*this_object*/,
+                                     ArtMethod* caller, uint32_t /*dex_pc*/,
+                                     ArtMethod* /*callee*/)
+      SHARED_LOCKS_REQUIRED(Locks::mutator_lock_) {
+  LOG(ERROR) << "Unexpected invoke event in tracing" << PrettyMethod(caller);
+}
+
 void Trace::ReadClocks(Thread* thread, uint32_t* thread_clock_diff, uint32_t* wall_clock_diff) {
   if (UseThreadCpuClock()) {
     uint64_t clock_base = thread->GetTraceClockBase();
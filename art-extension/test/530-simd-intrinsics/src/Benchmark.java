@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * Compares the intrinsics against Java loops doing the same work. Run with
+ * "dalvikvm -cp <dex> Benchmark [iterations]" on x86.
+ */
+public class Benchmark {
+  static final int[] LENGTHS = { 8, 64, 1024 };
+
+  static boolean loopEquals(char[] a, char[] b) {
+    if (a.length != b.length) {
+      return false;
+    }
+    for (int i = 0; i < a.length; i++) {
+      if (a[i] != b[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static int loopHashCode(char[] chars) {
+    int hash = 0;
+    for (int i = 0; i < chars.length; i++) {
+      hash = hash * 31 + chars[i];
+    }
+    return hash;
+  }
+
+  static void loopFill(int[] array, int value) {
+    for (int i = 0; i < array.length; i++) {
+      array[i] = value;
+    }
+  }
+
+  static void loopCopy(int[] src, int[] dest, int length) {
+    for (int i = 0; i < length; i++) {
+      dest[i] = src[i];
+    }
+  }
+
+  static void report(String name, int length, long start, int iterations, int sink) {
+    long ns = (System.nanoTime() - start) / iterations;
+    System.out.println(name + "[" + length + "]: " + ns + " ns" + (sink == 42 ? " " : ""));
+  }
+
+  public static void main(String[] args) {
+    int iterations = args.length > 0 ? Integer.parseInt(args[0]) : 100000;
+    for (int length : LENGTHS) {
+      char[] chars = new char[length];
+      for (int i = 0; i < length; i++) {
+        chars[i] = (char) ('a' + i % 26);
+      }
+      String s1 = new String(chars);
+      String s2 = new String(chars);
+      char[] chars2 = chars.clone();
+      int[] ints = new int[length];
+      int[] ints2 = new int[length];
+      int sink = 0;
+
+      long start = System.nanoTime();
+      for (int i = 0; i < iterations; i++) {
+        sink += s1.equals(s2) ? 1 : 0;
+      }
+      report("String.equals", length, start, iterations, sink);
+      start = System.nanoTime();
+      for (int i = 0; i < iterations; i++) {
+        sink += java.util.Arrays.equals(chars, chars2) ? 1 : 0;
+      }
+      report("Arrays.equals", length, start, iterations, sink);
+      start = System.nanoTime();
+      for (int i = 0; i < iterations; i++) {
+        sink += loopEquals(chars, chars2) ? 1 : 0;
+      }
+      report("loop equals", length, start, iterations, sink);
+
+      start = System.nanoTime();
+      for (int i = 0; i < iterations; i++) {
+        // A new string each time, otherwise the cached hash code is returned.
+        sink += new String(chars).hashCode();
+      }
+      report("String.hashCode", length, start, iterations, sink);
+      start = System.nanoTime();
+      for (int i = 0; i < iterations; i++) {
+        sink += loopHashCode(chars);
+      }
+      report("loop hash code", length, start, iterations, sink);
+
+      start = System.nanoTime();
+      for (int i = 0; i < iterations; i++) {
+        java.util.Arrays.fill(ints, i);
+      }
+      report("Arrays.fill", length, start, iterations, ints[0]);
+      start = System.nanoTime();
+      for (int i = 0; i < iterations; i++) {
+        loopFill(ints, i);
+      }
+      report("loop fill", length, start, iterations, ints[0]);
+
+      start = System.nanoTime();
+      for (int i = 0; i < iterations; i++) {
+        System.arraycopy(ints, 0, ints2, 0, length);
+      }
+      report("System.arraycopy", length, start, iterations, ints2[0]);
+      start = System.nanoTime();
+      for (int i = 0; i < iterations; i++) {
+        loopCopy(ints, ints2, length);
+      }
+      report("loop copy", length, start, iterations, ints2[0]);
+    }
+  }
+}
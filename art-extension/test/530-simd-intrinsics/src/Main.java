@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+public class Main {
+  // Covers the empty case, the scalar tails and several vector blocks.
+  static final int MAX_LENGTH = 70;
+
+  public static void assertTrue(boolean condition, String message) {
+    if (!condition) {
+      throw new Error(message);
+    }
+  }
+
+  public static void assertEquals(int expected, int result, String message) {
+    if (expected != result) {
+      throw new Error(message + ": expected " + expected + ", got " + result);
+    }
+  }
+
+  static char[] makeChars(int length) {
+    char[] chars = new char[length];
+    for (int i = 0; i < length; i++) {
+      // Use characters above 0xff so that both bytes of each character are compared.
+      chars[i] = (char) (0x61 + (i % 26) + ((i % 3) << 8));
+    }
+    return chars;
+  }
+
+  static int referenceHashCode(char[] chars) {
+    int hash = 0;
+    for (char c : chars) {
+      hash = hash * 31 + c;
+    }
+    return hash;
+  }
+
+  static void testStringEquals() {
+    for (int length = 0; length <= MAX_LENGTH; length++) {
+      char[] chars = makeChars(length);
+      String s1 = new String(chars);
+      String s2 = new String(chars);
+      assertTrue(s1.equals(s1), "same string " + length);
+      assertTrue(s1.equals(s2), "equal strings " + length);
+      assertTrue(!s1.equals(null), "null " + length);
+      assertTrue(!s1.equals(chars), "not a string " + length);
+      assertTrue(!s1.equals(s1 + "x"), "longer string " + length);
+      for (int i = 0; i < length; i++) {
+        char[] other = makeChars(length);
+        other[i] ^= 0x100;
+        assertTrue(!s1.equals(new String(other)), "high byte " + length + " " + i);
+        other[i] ^= 0x101;
+        assertTrue(!s1.equals(new String(other)), "low byte " + length + " " + i);
+      }
+    }
+    System.out.println("String.equals passed");
+  }
+
+  static void testStringHashCode() {
+    for (int length = 0; length <= MAX_LENGTH; length++) {
+      char[] chars = makeChars(length);
+      String s = new String(chars);
+      int expected = referenceHashCode(chars);
+      assertEquals(expected, s.hashCode(), "hash code " + length);
+      // The second call reads the cached hash code.
+      assertEquals(expected, s.hashCode(), "cached hash code " + length);
+    }
+    char[] chars = makeChars(MAX_LENGTH);
+    for (int i = 0; i < MAX_LENGTH; i++) {
+      chars[i] = (char) 0xffff;
+    }
+    assertEquals(referenceHashCode(chars), new String(chars).hashCode(), "overflowing hash code");
+    System.out.println("String.hashCode passed");
+  }
+
+  static void testArraysEquals() {
+    assertTrue(java.util.Arrays.equals((int[]) null, (int[]) null), "null arrays");
+    assertTrue(!java.util.Arrays.equals(new int[0], null), "null second array");
+    assertTrue(!java.util.Arrays.equals(null, new byte[0]), "null first array");
+    for (int length = 0; length <= MAX_LENGTH; length++) {
+      byte[] b1 = new byte[length];
+      char[] c1 = makeChars(length);
+      int[] i1 = new int[length];
+      for (int i = 0; i < length; i++) {
+        b1[i] = (byte) (i * 7);
+        i1[i] = i * 0x01010101;
+      }
+      byte[] b2 = b1.clone();
+      char[] c2 = c1.clone();
+      int[] i2 = i1.clone();
+      assertTrue(java.util.Arrays.equals(b1, b1), "same byte array " + length);
+      assertTrue(java.util.Arrays.equals(b1, b2), "equal byte arrays " + length);
+      assertTrue(java.util.Arrays.equals(c1, c2), "equal char arrays " + length);
+      assertTrue(java.util.Arrays.equals(i1, i2), "equal int arrays " + length);
+      assertTrue(!java.util.Arrays.equals(b1, new byte[length + 1]), "byte lengths " + length);
+      assertTrue(!java.util.Arrays.equals(c1, new char[length + 1]), "char lengths " + length);
+      assertTrue(!java.util.Arrays.equals(i1, new int[length + 1]), "int lengths " + length);
+      for (int i = 0; i < length; i++) {
+        b2[i]++;
+        c2[i] ^= 0x100;
+        i2[i] ^= 0x10000000;
+        assertTrue(!java.util.Arrays.equals(b1, b2), "byte arrays " + length + " " + i);
+        assertTrue(!java.util.Arrays.equals(c1, c2), "char arrays " + length + " " + i);
+        assertTrue(!java.util.Arrays.equals(i1, i2), "int arrays " + length + " " + i);
+        b2[i]--;
+        c2[i] ^= 0x100;
+        i2[i] ^= 0x10000000;
+      }
+    }
+    System.out.println("Arrays.equals passed");
+  }
+
+  static void testArraysFill() {
+    for (int length = 0; length <= MAX_LENGTH; length++) {
+      int[] array = new int[length];
+      java.util.Arrays.fill(array, length + 1);
+      for (int i = 0; i < length; i++) {
+        assertEquals(length + 1, array[i], "fill " + length + " " + i);
+      }
+      java.util.Arrays.fill(array, -1);
+      for (int i = 0; i < length; i++) {
+        assertEquals(-1, array[i], "refill " + length + " " + i);
+      }
+    }
+    try {
+      java.util.Arrays.fill((int[]) null, 1);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+    System.out.println("Arrays.fill passed");
+  }
+
+  static void testArrayCopy() {
+    final int size = 140;
+    byte[] bytes = new byte[size];
+    int[] ints = new int[size];
+    for (int i = 0; i < size; i++) {
+      bytes[i] = (byte) i;
+      ints[i] = i * 0x00010001;
+    }
+    for (int length = 0; length <= 130; length += 13) {
+      for (int src_pos = 0; src_pos + length <= size; src_pos += 5) {
+        int dest_pos = (src_pos * 3) % (size - length + 1);
+        byte[] byte_dest = new byte[size];
+        int[] int_dest = new int[size];
+        System.arraycopy(bytes, src_pos, byte_dest, dest_pos, length);
+        System.arraycopy(ints, src_pos, int_dest, dest_pos, length);
+        for (int i = 0; i < size; i++) {
+          boolean copied = i >= dest_pos && i < dest_pos + length;
+          int expected = copied ? i - dest_pos + src_pos : -1;
+          assertEquals(copied ? (byte) expected : 0, byte_dest[i], "byte copy " + length);
+          assertEquals(copied ? expected * 0x00010001 : 0, int_dest[i], "int copy " + length);
+        }
+      }
+    }
+    try {
+      System.arraycopy(ints, 0, new int[8], 1, 8);
+      throw new Error("Expected ArrayIndexOutOfBoundsException");
+    } catch (ArrayIndexOutOfBoundsException expected) {
+    }
+    try {
+      System.arraycopy(bytes, 0, (byte[]) null, 0, 1);
+      throw new Error("Expected NullPointerException");
+    } catch (NullPointerException expected) {
+    }
+    System.out.println("System.arraycopy passed");
+  }
+
+  public static void main(String[] args) {
+    testStringEquals();
+    testStringHashCode();
+    testArraysEquals();
+    testArraysFill();
+    testArrayCopy();
+  }
+}
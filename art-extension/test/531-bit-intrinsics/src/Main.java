@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2015 Intel Corporation
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+public class Main {
+  static final int[] INT_VALUES = {
+    0, 1, -1, 2, 3, 7, 8, 0x80, 0x7fff, 0x10000, 0x12345678, 0x40000000,
+    Integer.MAX_VALUE, Integer.MIN_VALUE, Integer.MIN_VALUE + 1, 0xf0f0f0f0, -256
+  };
+
+  static final long[] LONG_VALUES = {
+    0L, 1L, -1L, 2L, 3L, 0xffL, 0x100000000L, 0xffffffffL, 0x80000000L, 0x123456789abcdefL,
+    0x4000000000000000L, Long.MAX_VALUE, Long.MIN_VALUE, Long.MIN_VALUE + 1, 0xf0f0f0f0f0f0f0f0L,
+    -0x100000000L
+  };
+
+  public static void assertEquals(int expected, int result, String message) {
+    if (expected != result) {
+      throw new Error(message + ": expected " + expected + ", got " + result);
+    }
+  }
+
+  public static void assertEquals(long expected, long result, String message) {
+    if (expected != result) {
+      throw new Error(message + ": expected " + expected + ", got " + result);
+    }
+  }
+
+  // Reference implementations that do not call the intrinsics.
+
+  static int bitCount(long value) {
+    int count = 0;
+    for (int i = 0; i < 64; i++) {
+      count += (int) ((value >>> i) & 1);
+    }
+    return count;
+  }
+
+  static int leadingZeros(long value, int bits) {
+    int count = 0;
+    for (int i = bits - 1; i >= 0 && ((value >>> i) & 1) == 0; i--) {
+      count++;
+    }
+    return count;
+  }
+
+  static int trailingZeros(long value, int bits) {
+    int count = 0;
+    for (int i = 0; i < bits && ((value >>> i) & 1) == 0; i++) {
+      count++;
+    }
+    return count;
+  }
+
+  static long highestOneBit(long value, int bits) {
+    int zeros = leadingZeros(value, bits);
+    return zeros == bits ? 0 : 1L << (bits - 1 - zeros);
+  }
+
+  static void testInteger() {
+    for (int value : INT_VALUES) {
+      String name = Integer.toHexString(value);
+      long unsigned = value & 0xffffffffL;
+      assertEquals(bitCount(unsigned), Integer.bitCount(value), "bitCount " + name);
+      assertEquals(leadingZeros(unsigned, 32), Integer.numberOfLeadingZeros(value),
+                   "numberOfLeadingZeros " + name);
+      assertEquals(trailingZeros(unsigned, 32), Integer.numberOfTrailingZeros(value),
+                   "numberOfTrailingZeros " + name);
+      assertEquals((int) highestOneBit(unsigned, 32), Integer.highestOneBit(value),
+                   "highestOneBit " + name);
+      assertEquals(value > 0 ? 1 : (value < 0 ? -1 : 0), Integer.signum(value), "signum " + name);
+      for (int distance = -33; distance <= 65; distance++) {
+        int d = distance & 31;
+        int left = d == 0 ? value : (value << d) | (value >>> (32 - d));
+        int right = d == 0 ? value : (value >>> d) | (value << (32 - d));
+        assertEquals(left, Integer.rotateLeft(value, distance), "rotateLeft " + name + " " + distance);
+        assertEquals(right, Integer.rotateRight(value, distance),
+                     "rotateRight " + name + " " + distance);
+      }
+    }
+    System.out.println("Integer passed");
+  }
+
+  static void testLong() {
+    for (long value : LONG_VALUES) {
+      String name = Long.toHexString(value);
+      assertEquals(bitCount(value), Long.bitCount(value), "bitCount " + name);
+      assertEquals(leadingZeros(value, 64), Long.numberOfLeadingZeros(value),
+                   "numberOfLeadingZeros " + name);
+      assertEquals(trailingZeros(value, 64), Long.numberOfTrailingZeros(value),
+                   "numberOfTrailingZeros " + name);
+      assertEquals(highestOneBit(value, 64), Long.highestOneBit(value), "highestOneBit " + name);
+      assertEquals(value > 0 ? 1 : (value < 0 ? -1 : 0), Long.signum(value), "signum " + name);
+      for (int distance = -65; distance <= 129; distance++) {
+        int d = distance & 63;
+        long left = d == 0 ? value : (value << d) | (value >>> (64 - d));
+        long right = d == 0 ? value : (value >>> d) | (value << (64 - d));
+        assertEquals(left, Long.rotateLeft(value, distance), "rotateLeft " + name + " " + distance);
+        assertEquals(right, Long.rotateRight(value, distance),
+                     "rotateRight " + name + " " + distance);
+      }
+    }
+    System.out.println("Long passed");
+  }
+
+  static void testConstants() {
+    assertEquals(0, Integer.bitCount(0), "constant bitCount");
+    assertEquals(32, Integer.bitCount(-1), "constant bitCount");
+    assertEquals(64, Long.bitCount(-1L), "constant bitCount");
+    assertEquals(32, Integer.numberOfLeadingZeros(0), "constant numberOfLeadingZeros");
+    assertEquals(3, Integer.numberOfLeadingZeros(0x10000000), "constant numberOfLeadingZeros");
+    assertEquals(64, Long.numberOfLeadingZeros(0L), "constant numberOfLeadingZeros");
+    assertEquals(31, Long.numberOfLeadingZeros(0x100000000L), "constant numberOfLeadingZeros");
+    assertEquals(32, Integer.numberOfTrailingZeros(0), "constant numberOfTrailingZeros");
+    assertEquals(64, Long.numberOfTrailingZeros(0L), "constant numberOfTrailingZeros");
+    assertEquals(32, Long.numberOfTrailingZeros(0x100000000L), "constant numberOfTrailingZeros");
+    assertEquals(0x23456781, Integer.rotateLeft(0x12345678, 4), "constant rotateLeft");
+    assertEquals(0x81234567, Integer.rotateRight(0x12345678, 4), "constant rotateRight");
+    assertEquals(0x0123456789abcdefL, Long.rotateLeft(0x89abcdef01234567L, 32),
+                 "constant rotateLeft");
+    assertEquals(0xf0123456789abcdeL, Long.rotateRight(0x0123456789abcdefL, -60),
+                 "constant rotateRight");
+    assertEquals(Integer.MIN_VALUE, Integer.highestOneBit(-1), "constant highestOneBit");
+    assertEquals(0, Integer.highestOneBit(0), "constant highestOneBit");
+    assertEquals(0x100000000L, Long.highestOneBit(0x1ffffffffL), "constant highestOneBit");
+    assertEquals(-1, Integer.signum(Integer.MIN_VALUE), "constant signum");
+    assertEquals(1, Long.signum(0x100000000L), "constant signum");
+    assertEquals(0, Long.signum(0L), "constant signum");
+    System.out.println("Constants passed");
+  }
+
+  public static void main(String[] args) {
+    testInteger();
+    testLong();
+    testConstants();
+  }
+}
@@ -0,0 +1,260 @@
+#!/usr/bin/env python
+#
+# Copyright (C) 2015 Intel Corporation
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+"""Script that converts a binary GC profile (alloc_free_log_<pid>_<n>.b), as streamed by the
+   runtime GcProfiler, to the .csv layout. The record layouts mirror runtime/gc/gcprofiler.h."""
+
+from __future__ import print_function
+
+import struct
+import sys
+
+kGcProfileMagic = 0x42504347
+kGcProfileVersion = 1
+kGcProfileFlagInaccurateMode = 1
+
+# RecordType.
+kRecordTypeGC = 0
+kRecordTypeSucc = 1
+kRecordTypeFail = 2
+kRecordTypeLarge = 3
+kRecordTypeAlloc = 4
+kRecordTypeName = 5
+
+# NameKind.
+kNameKindGcCause = 0
+kNameKindGcType = 1
+kNameKindAllocFailPhase = 2
+
+kNumSizeDistRegions = 11
+kRecordDescriptorLength = 128
+
+FILE_HEADER = struct.Struct('<IIII')
+RECORD_HEADER = struct.Struct('<II')
+GC_RECORD = struct.Struct('<8Q18I')
+SUCC_RECORD = struct.Struct('<3I%dI' % (kNumSizeDistRegions + 1))
+FAIL_RECORD = struct.Struct('<4I%ds' % kRecordDescriptorLength)
+LARGE_RECORD = struct.Struct('<2I%ds' % kRecordDescriptorLength)
+ALLOC_RECORD = struct.Struct('<QQII')
+NAME_RECORD = struct.Struct('<II56s')
+
+MB = 1024 * 1024
+
+class MyException(Exception):
+  pass
+
+def CString(raw):
+  return raw.split(b'\0', 1)[0].decode('utf-8', 'replace')
+
+def FormatDouble(value):
+  # Same as the default formatting of a double by an std::ostream.
+  return '%g' % value
+
+class Converter:
+
+  def __init__(self):
+    self._names = {kNameKindGcCause: {}, kNameKindGcType: {}, kNameKindAllocFailPhase: {}}
+    self._gc_records = []
+    # Histograms of allocations, summed up over the threads, by interval between GCs.
+    self._succ_records = {}
+    self._fail_records = []
+    self._large_records = []
+    self._alloc_records = []
+    self._inaccurate = True
+
+  def Name(self, kind, value):
+    return self._names[kind].get(value, str(value))
+
+  def ConvertTime(self, time):
+    return time // (1000 * 1000) if self._inaccurate else time
+
+  def ConvertSize(self, size):
+    return size // MB if self._inaccurate else size
+
+  def ConvertThroughput(self, throughput):
+    return throughput * 1000 * 1000 if self._inaccurate else throughput
+
+  def ReadRecords(self, input):
+    header = input.read(FILE_HEADER.size)
+    if len(header) != FILE_HEADER.size:
+      raise MyException("File too short")
+    magic, version, flags, pid = FILE_HEADER.unpack(header)
+    if magic != kGcProfileMagic:
+      raise MyException("Magic wrong")
+    if version != kGcProfileVersion:
+      raise MyException("Only support version %d" % kGcProfileVersion)
+    self._inaccurate = (flags & kGcProfileFlagInaccurateMode) != 0
+    while True:
+      header = input.read(RECORD_HEADER.size)
+      if not header:
+        break
+      data = b''
+      if len(header) == RECORD_HEADER.size:
+        type, size = RECORD_HEADER.unpack(header)
+        data = input.read(size)
+      if len(header) != RECORD_HEADER.size or len(data) != size:
+        print('Record truncated, the profile was probably not stopped.', file=sys.stderr)
+        break
+      self.ProcessRecord(type, data)
+
+  def ProcessRecord(self, type, data):
+    if type == kRecordTypeName:
+      kind, value, name = NAME_RECORD.unpack(data)
+      self._names[kind][value] = CString(name)
+    elif type == kRecordTypeGC:
+      self._gc_records.append(GC_RECORD.unpack(data))
+    elif type == kRecordTypeSucc:
+      fields = SUCC_RECORD.unpack(data)
+      gc_id, interval, total_size = fields[0:3]
+      if interval not in self._succ_records:
+        self._succ_records[interval] = [gc_id, 0, [0] * (kNumSizeDistRegions + 1)]
+      record = self._succ_records[interval]
+      record[1] += total_size
+      for i, count in enumerate(fields[3:]):
+        record[2][i] += count
+    elif type == kRecordTypeFail:
+      self._fail_records.append(FAIL_RECORD.unpack(data))
+    elif type == kRecordTypeLarge:
+      self._large_records.append(LARGE_RECORD.unpack(data))
+    elif type == kRecordTypeAlloc:
+      self._alloc_records.append(ALLOC_RECORD.unpack(data))
+    else:
+      raise MyException("Unknown record type %d" % type)
+
+  def WriteTitleLine(self, out):
+    if self._inaccurate:
+      units = ('milliseconds', 'mega-bytes', 'bytes/milliseconds', 'count/milliseconds')
+    else:
+      units = ('nanoseconds', 'bytes', 'bytes/nanosecond', 'count/nanosecond')
+    out.write('GcProfile Data, Unit: Time(%s) Size (%s) Throughput (%s ; %s)\n' % units)
+
+  def WriteGcRecords(self, out):
+    out.write('GC Message, ID, Timestamp, reason, max pausetime, mark time, sweep time, '
+              'GC duration, number objects freed, freed bytes, number large obj freed, '
+              'large obj freed bytes, max wait time, GC type, max allowed footprint, '
+              'concurrent start bytes, blocking time, allocated size before gc, '
+              'allocated size after gc, alloc stack size after gc, GC throughput, '
+              'GC throughput, footprint before gc, footprint after gc, '
+              'main space size before gc, main space size after gc, los space size before gc, '
+              'los space size after gc\n')
+    for fields in self._gc_records:
+      (timestamp, pause_time_max, mark_time, sweep_time, gc_time, max_wait_time, blocking_time,
+       wasted_wait_time_after_gc, id, reason, type, free_bytes, free_object_count,
+       free_large_object_count, free_large_object_bytes, max_allowed_footprint,
+       concurrent_start_bytes, allocated_size_before_gc, allocated_size_after_gc,
+       total_object_count_in_alloc_stack_during_gc, main_space_size_before_gc,
+       main_space_size_after_gc, los_space_size_before_gc, los_space_size_after_gc,
+       footprint_size_before_gc, footprint_size_after_gc) = fields
+      if gc_time != 0:
+        gc_throughput_bpns = float(free_bytes + free_large_object_bytes) / gc_time
+        gc_throughput_npns = float(free_object_count + free_large_object_count) / gc_time
+      else:
+        gc_throughput_bpns = 0.0
+        gc_throughput_npns = 0.0
+      values = [id, self.ConvertTime(timestamp), self.Name(kNameKindGcCause, reason),
+                self.ConvertTime(pause_time_max), self.ConvertTime(mark_time),
+                self.ConvertTime(sweep_time), self.ConvertTime(gc_time), free_object_count,
+                self.ConvertSize(free_bytes), free_large_object_count,
+                self.ConvertSize(free_large_object_bytes), self.ConvertTime(max_wait_time),
+                self.Name(kNameKindGcType, type), self.ConvertSize(max_allowed_footprint),
+                self.ConvertSize(concurrent_start_bytes), self.ConvertTime(blocking_time),
+                self.ConvertSize(allocated_size_before_gc),
+                self.ConvertSize(allocated_size_after_gc),
+                total_object_count_in_alloc_stack_during_gc,
+                FormatDouble(self.ConvertThroughput(gc_throughput_bpns)),
+                FormatDouble(self.ConvertThroughput(gc_throughput_npns)),
+                self.ConvertSize(footprint_size_before_gc),
+                self.ConvertSize(footprint_size_after_gc),
+                self.ConvertSize(main_space_size_before_gc),
+                self.ConvertSize(main_space_size_after_gc),
+                self.ConvertSize(los_space_size_before_gc),
+                self.ConvertSize(los_space_size_after_gc)]
+      out.write(''.join(',%s' % value for value in values) + '\n')
+
+  def WriteSuccRecords(self, out):
+    out.write('Succeeded Allocation Messages,GC_Id, total_size, [1-16], [17-32],'
+              ' [33-64], [65-128], [129-256], [257-512], [513-1024], [1025-2048], [2049-4096],'
+              ' [4097-8192], [8193-12288], [12288-]\n')
+    for interval in sorted(self._succ_records):
+      gc_id, total_size, size_dist = self._succ_records[interval]
+      values = [gc_id, self.ConvertSize(total_size)] + size_dist
+      out.write(''.join(' ,%s' % value for value in values) + '\n')
+
+  def WriteFailRecords(self, out):
+    out.write('Failed Allocation Messages, GC_Id, size, phase, last_gc_type, type\n')
+    for gc_id, size, phase, last_gc_type, type in self._fail_records:
+      values = [gc_id, self.ConvertSize(size), self.Name(kNameKindAllocFailPhase, phase),
+                self.Name(kNameKindGcType, last_gc_type), CString(type)]
+      out.write(''.join(', %s' % value for value in values) + '\n')
+
+  def WriteLargeRecords(self, out):
+    out.write('Large Object Messages, GC_Id, size, type\n')
+    for gc_id, size, type in self._large_records:
+      values = [gc_id, self.ConvertSize(size), CString(type)]
+      out.write(''.join(' ,%s' % value for value in values) + '\n')
+
+  def WriteAllocRecords(self, out):
+    out.write('Allocation Info, duration(ms), total_bytes_allocated, '
+              'total_objects_allocated, Alloc_ThroughPut, Alloc_ThroughPut\n')
+    for duration, dropped_records, bytes_allocated, objects_allocated in self._alloc_records:
+      if dropped_records != 0:
+        print('%d records were dropped by the runtime, its ring buffers were full.'
+              % dropped_records, file=sys.stderr)
+      if duration != 0:
+        throughput_bpns = float(bytes_allocated) / duration
+        throughput_npns = float(objects_allocated) / duration
+      else:
+        throughput_bpns = 0.0
+        throughput_npns = 0.0
+      if self._inaccurate:
+        # Same rounding as the runtime used to do.
+        bytes_allocated = (bytes_allocated // MB + MB - 1) // MB * MB
+      values = [duration, bytes_allocated, objects_allocated,
+                FormatDouble(self.ConvertThroughput(throughput_bpns)),
+                FormatDouble(self.ConvertThroughput(throughput_npns))]
+      out.write(''.join(', %s' % value for value in values) + '\n')
+
+  def ProcessFile(self, filename, out_filename):
+    input = open(filename, 'rb')
+    self.ReadRecords(input)
+    input.close()
+
+    out = open(out_filename, 'w')
+    self.WriteTitleLine(out)
+    self.WriteGcRecords(out)
+    self.WriteSuccRecords(out)
+    self.WriteFailRecords(out)
+    self.WriteLargeRecords(out)
+    self.WriteAllocRecords(out)
+    out.close()
+
+def main():
+  if len(sys.argv) < 2:
+    print('Usage: %s <profile.b> [<profile.csv>]' % sys.argv[0], file=sys.stderr)
+    sys.exit(1)
+  filename = sys.argv[1]
+  if len(sys.argv) > 2:
+    out_filename = sys.argv[2]
+  elif filename.endswith('.b'):
+    out_filename = filename[:-2] + '.csv'
+  else:
+    out_filename = filename + '.csv'
+  Converter().ProcessFile(filename, out_filename)
+  print('Results have been written to %s.' % out_filename)
+  sys.exit(0)
+
+if __name__ == '__main__':
+  main()